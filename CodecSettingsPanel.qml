@@ -172,6 +172,14 @@ Item {
                 } else {
                     lines.push("H.264 (hardware): not available")
                 }
+                if (typeof r.storageSafeFeeds === "number" && r.storageSafeFeeds >= 0) {
+                    var mbps = (typeof r.storageWriteMBps === "number" && r.storageWriteMBps > 0)
+                               ? " (" + Math.round(r.storageWriteMBps) + " MB/s)" : ""
+                    lines.push("Recording volume: " + r.storageSafeFeeds + " safe feeds" + mbps)
+                }
+                if (typeof r.threadPlacement === "string" && r.threadPlacement !== "") {
+                    lines.push("Pinned threads: " + r.threadPlacement)
+                }
                 if (rec === "h264") {
                     lines.push("Recommended: H.264 — " + h264Feeds + " feeds")
                 } else if (rec === "mpeg2") {
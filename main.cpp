@@ -7,14 +7,20 @@
 Q_IMPORT_PLUGIN(OlrStylePlugin)
 #endif
 #include "recorder_engine/replaymanager.h"
+#include "recorder_engine/threadplacement.h"
 #include "uimanager.h"
 #include "playback/frameprovider.h"
+#include "playback/playbackchannel.h"
 #include "playback/playlistentriesmodel.h"
+#include "playback/thumbnailimageprovider.h"
 #include "streamdeck/streamdeckmanager.h"
-#include "websocket/controlstate.h"
+#include "websocket/controltransportpublisher.h"
 #include "websocket/controlwebsocketserver.h"
+#include "websocket/metricshttpserver.h"
+#include "websocket/pipelinemetrics.h"
 #include "websocket/uimanagercontroladapter.h"
 #include <QHostAddress>
+#include <QTimer>
 #include <QDebug>
 
 #include <QString>
@@ -30,6 +36,14 @@ int main(int argc, char *argv[])
     QQuickStyle::setStyle(u"OlrStyle"_s);
     QQuickStyle::setFallbackStyle(u"Basic"_s);
 
+    // Before any pipeline thread starts: each one places itself from this plan.
+    ThreadPlacementPolicy placementPolicy = ThreadPlacementPolicy::fromEnvironment();
+    placementPolicy.outputChannels = PlaybackChannel::countFromEnvironment();
+    const ThreadPlacementPlan placement =
+        ThreadPlacementPlan::build(CpuTopology::detect(), placementPolicy);
+    ThreadPlacement::configure(placement);
+    if (placement.isActive()) qInfo() << "Thread placement:" << placement.describe();
+
     ReplayManager replayManager;
     UIManager uiManager(&replayManager);
 
@@ -47,6 +61,22 @@ int main(int argc, char *argv[])
                    << controlServer.lastError();
     }
 
+    // Prometheus-style scrape endpoint. Sampled once a second on this thread; a scrape
+    // only copies the last rendered body.
+    MetricsHttpServer metricsServer;
+    if (!metricsServer.listen(QHostAddress::Any, 8116)) {
+        qWarning() << "Metrics endpoint failed to listen on port 8116:"
+                   << metricsServer.lastError();
+    }
+    QTimer metricsTimer;
+    metricsTimer.setInterval(1000);
+    QObject::connect(&metricsTimer, &QTimer::timeout, &metricsServer,
+                     [&metricsServer, &uiManager]() {
+                         metricsServer.setMetricsText(
+                             pipelineMetricsText(uiManager.pipelineMetrics()));
+                     });
+    metricsTimer.start();
+
     auto publishRecording = [&controlServer]() {
         controlServer.publishPatch(QStringLiteral("recording"));
     };
@@ -61,11 +91,9 @@ int main(int argc, char *argv[])
         controlServer.publishPatch(QStringLiteral("telemetry"));
     };
 
-    auto publishFullSnapshot = [&controlServer, &controlAdapter]() {
-        controlServer.publishPatchObject(QStringLiteral("snapshot"),
-                                         ControlState::snapshotMessage(controlAdapter)
-                                             .value(QStringLiteral("state"))
-                                             .toObject());
+    // Built once per event-loop turn however many of these signals fire in it.
+    auto publishFullSnapshot = [&controlServer]() {
+        controlServer.publishPatch(QStringLiteral("snapshot"));
     };
     auto publishSources = publishFullSnapshot;
     auto publishViews = publishFullSnapshot;
@@ -92,6 +120,31 @@ int main(int argc, char *argv[])
                              QStringLiteral("recording.failed"),
                              QJsonObject{{QStringLiteral("reason"), reason}});
                      });
+    QObject::connect(&uiManager, &UIManager::pipelineTraceDumped, &controlServer,
+                     [&controlServer](const QString& path, int events) {
+                         controlServer.publishEvent(
+                             QStringLiteral("diagnostics.traceDumped"),
+                             QJsonObject{{QStringLiteral("path"), path},
+                                         {QStringLiteral("events"), events}});
+                     });
+    QObject::connect(&uiManager, &UIManager::exportProgressChanged, &controlServer,
+                     [&controlServer](double fraction) {
+                         controlServer.publishEvent(
+                             QStringLiteral("export.progress"),
+                             QJsonObject{{QStringLiteral("fraction"), fraction}});
+                     });
+    QObject::connect(&uiManager, &UIManager::exportFinished, &controlServer,
+                     [&controlServer](bool ok, const QString& path, const QString& error) {
+                         controlServer.publishEvent(
+                             QStringLiteral("export.finished"),
+                             QJsonObject{{QStringLiteral("ok"), ok},
+                                         {QStringLiteral("path"), path},
+                                         {QStringLiteral("error"), error}});
+                     });
+    QObject::connect(&uiManager, &UIManager::frameLatencyReported, &controlServer,
+                     [&controlServer](const QJsonObject& report) {
+                         controlServer.publishEvent(QStringLiteral("diagnostics.latency"), report);
+                     });
     QObject::connect(&uiManager, &UIManager::playbackTimecodeChanged, &controlServer,
                      [&controlServer]() { controlServer.scheduleTimecode(); });
     QObject::connect(&uiManager, &UIManager::followLiveChanged, &controlServer, publishTransport);
@@ -137,16 +190,10 @@ int main(int argc, char *argv[])
                      publishStreamDeck);
     QObject::connect(&uiManager, &UIManager::screensChanged, &controlServer, publishScreens);
 
-    if (const auto transport = uiManager.transport()) {
-        QObject::connect(transport, &PlaybackTransport::posChanged, &controlServer,
-                         [&controlServer]() { controlServer.scheduleTimecode(); });
-        QObject::connect(transport, &PlaybackTransport::playingChanged, &controlServer,
-                         publishTransport);
-        QObject::connect(transport, &PlaybackTransport::speedChanged, &controlServer,
-                         publishTransport);
-        QObject::connect(transport, &PlaybackTransport::fpsChanged, &controlServer,
-                         publishTransport);
-    }
+    ControlTransportPublisher transportPublisher(&controlServer);
+    transportPublisher.watch(uiManager.transport(), 0);
+    for (int channel = 1; channel < uiManager.playbackChannelCount(); ++channel)
+        transportPublisher.watch(uiManager.playbackChannel(channel)->transport(), channel);
 
     qmlRegisterType<FrameProvider>("Recorder.Types", 1, 0, "FrameProvider");
     qmlRegisterType<PlaybackTransport>("Recorder.Types", 1, 0, "PlaybackTransport");
@@ -161,6 +208,9 @@ int main(int argc, char *argv[])
 
     // This makes the 'uiManager' object globally available in QML
     qmlEngine.rootContext()->setContextProperty("uiManager", &uiManager);
+    // Filmstrip thumbnails for the scrub bar and rundown rows (engine takes ownership).
+    qmlEngine.addImageProvider(u"thumbs"_s,
+                               new ThumbnailImageProvider(uiManager.thumbnailSlot()));
 
     QObject::connect(
         &qmlEngine,
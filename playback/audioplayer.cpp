@@ -5,119 +5,222 @@
 
 // ─── AudioRingBuffer ───────────────────────────────────────────────────
 
+namespace {
+// Room beyond the safety cap: fadeOutAndClear queues the ramped tail behind
+// the data it replaces, so both fit at once.
+constexpr qint64 kRingHeadroomBytes = 64 * 1024;
+constexpr int kFadeOutFrames = 240; // ~5 ms @ 48 kHz
+} // namespace
+
 AudioRingBuffer::AudioRingBuffer(QObject *parent)
     : QIODevice(parent)
 {
+    setMaxBufBytes(m_maxBufBytes.load(std::memory_order_relaxed));
     open(QIODevice::ReadOnly);
 }
 
+void AudioRingBuffer::setMaxBufBytes(int bytes) {
+    const int maxBytes = qMax(1, bytes);
+    quint64 capacity = 1;
+    while (capacity < quint64(maxBytes + kRingHeadroomBytes)) capacity <<= 1;
+    m_maxBufBytes.store(maxBytes, std::memory_order_relaxed);
+    if (capacity != m_capacity) {
+        m_ring = std::make_unique<char[]>(capacity);
+        m_capacity = capacity;
+    }
+    m_readPos.store(0, std::memory_order_relaxed);
+    m_writePos.store(0, std::memory_order_release);
+}
+
+void AudioRingBuffer::copyOut(quint64 pos, char *dst, qint64 len) const {
+    const quint64 offset = pos & (m_capacity - 1);
+    const qint64 first = qMin<qint64>(len, qint64(m_capacity - offset));
+    memcpy(dst, m_ring.get() + offset, size_t(first));
+    if (len > first) memcpy(dst + first, m_ring.get(), size_t(len - first));
+}
+
+void AudioRingBuffer::copyIn(quint64 pos, const char *src, qint64 len) {
+    const quint64 offset = pos & (m_capacity - 1);
+    const qint64 first = qMin<qint64>(len, qint64(m_capacity - offset));
+    memcpy(m_ring.get() + offset, src, size_t(first));
+    if (len > first) memcpy(m_ring.get(), src + first, size_t(len - first));
+}
+
+void AudioRingBuffer::discardUpTo(quint64 target) {
+    quint64 readPos = m_readPos.load(std::memory_order_acquire);
+    while (readPos < target &&
+           !m_readPos.compare_exchange_weak(readPos, target, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+    }
+}
+
+void AudioRingBuffer::addDebtBounded(qint64 bytes, quint64 expectedEpoch, bool checkEpoch) {
+    quint64 state = m_debtState.load(std::memory_order_relaxed);
+    while (true) {
+        if (checkEpoch && (state >> kDebtBits) != expectedEpoch) return;
+        // Cap the debt at one ring's worth so a long stall (e.g. a pause
+        // with a stray late push leaving m_streamActive true) can swallow
+        // at most ~500 ms of real audio on resume, not the whole pause.
+        const qint64 cap = m_maxBufBytes.load(std::memory_order_relaxed);
+        const qint64 debt = qMin<qint64>(qint64(state & kDebtMask) + bytes, cap);
+        const quint64 next = (state & ~kDebtMask) | quint64(debt);
+        if (m_debtState.compare_exchange_weak(state, next, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed))
+            return;
+    }
+}
+
+void AudioRingBuffer::resetStreamAccounting() {
+    m_streamActive.store(false);
+    m_overflowed.store(false, std::memory_order_relaxed);
+    // A new epoch with zero debt: silence a concurrent readData() is about to
+    // account belongs to the cleared stream and is dropped.
+    quint64 state = m_debtState.load(std::memory_order_relaxed);
+    while (!m_debtState.compare_exchange_weak(
+        state, ((state >> kDebtBits) + 1) << kDebtBits, std::memory_order_acq_rel,
+        std::memory_order_relaxed)) {
+    }
+}
+
 void AudioRingBuffer::push(const char *data, qint64 len) {
     if (len <= 0) return;
-    QMutexLocker locker(&m_mutex);
 
     // Plain append + safety cap-trim.  Underrun-debt repayment now lives in
     // AudioPlayer::pushSamples (so the splice can be faded); this method does
-    // not touch m_underrunDebt.
-    m_buf.append(data, len);
-    m_streamActive = true;
+    // not touch the underrun debt.
+    const qint64 maxBytes = m_maxBufBytes.load(std::memory_order_relaxed);
+    bool trimmed = false;
+    if (len > maxBytes) {
+        // Only the newest maxBytes could survive the cap anyway.
+        data += len - maxBytes;
+        len = maxBytes;
+        trimmed = true;
+    }
 
     // Safety cap to avoid unbounded growth.  Should not trigger in normal
     // operation: the producer paces itself against the master clock.  Trimming
     // the OLDEST (due-next) bytes shifts the stream early with no alignment
     // adjustment, so flag it: AudioPlayer will force a re-align on the next
     // push instead of compounding a permanent desync.
-    if (m_buf.size() > m_maxBufBytes) {
-        m_buf.remove(0, m_buf.size() - m_maxBufBytes);
-        m_overflowed = true;
+    const quint64 writePos = m_writePos.load(std::memory_order_relaxed);
+    quint64 readPos = m_readPos.load(std::memory_order_acquire);
+    while (true) {
+        const qint64 excess = qint64(writePos - readPos) + len - maxBytes;
+        if (excess <= 0) break;
+        if (m_readPos.compare_exchange_weak(readPos, readPos + quint64(excess),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+            trimmed = true;
+            break;
+        }
     }
+
+    copyIn(writePos, data, len);
+    m_streamActive.store(true);
+    m_writePos.store(writePos + quint64(len), std::memory_order_release);
+    if (trimmed) m_overflowed.store(true, std::memory_order_relaxed);
 }
 
 void AudioRingBuffer::clear() {
-    QMutexLocker locker(&m_mutex);
-    m_buf.clear();
-    m_underrunDebt = 0;
-    m_streamActive = false;
-    m_overflowed = false;
+    resetStreamAccounting();
+    discardUpTo(m_writePos.load(std::memory_order_relaxed));
 }
 
 void AudioRingBuffer::fadeOutAndClear(int channels) {
-    QMutexLocker locker(&m_mutex);
-    m_underrunDebt = 0;
-    m_streamActive = false;
-    m_overflowed = false;
-    if (m_buf.isEmpty()) return;
+    resetStreamAccounting();
 
     // Keep at most ~5 ms of audio for the fade-out tail (240 samples @ 48 kHz)
-    const int kFadeSamples = 240 * channels;  // per-channel pairs
-    const int kFadeBytes   = kFadeSamples * int(sizeof(int16_t));
-
-    if (m_buf.size() > kFadeBytes)
-        m_buf = m_buf.left(kFadeBytes);  // trim to just what's next to play
-
-    int16_t* samples = reinterpret_cast<int16_t*>(m_buf.data());
-    int nSamples = static_cast<int>(m_buf.size() / static_cast<int>(sizeof(int16_t)));
-    // Ramp per channel-FRAME so both channels of a stereo frame get the same
-    // gain (otherwise L and R diverge by 1/nFrames across the tail).
     const int ch = qMax(1, channels);
-    const int nFrames = nSamples / ch;
-    for (int i = 0; i < nSamples; ++i) {
-        const int frame = i / ch;
-        const double gain = (nFrames > 0) ? 1.0 - double(frame) / double(nFrames) : 0.0;
-        samples[i] = int16_t(samples[i] * gain);
+    const qint64 kFadeBytes = qint64(kFadeOutFrames) * ch * qint64(sizeof(int16_t));
+    const quint64 writePos = m_writePos.load(std::memory_order_relaxed);
+    QByteArray tail;
+    while (true) {
+        quint64 readPos = m_readPos.load(std::memory_order_acquire);
+        const qint64 queued = qint64(writePos - readPos);
+        // Trim to just what's next to play.
+        const qint64 keep = qMin(queued, qMin(kFadeBytes, qint64(m_capacity) - queued));
+        if (keep <= 0) {
+            discardUpTo(writePos);
+            return;
+        }
+        tail.resize(int(keep));
+        copyOut(readPos, tail.data(), keep);
+
+        int16_t* samples = reinterpret_cast<int16_t*>(tail.data());
+        const int nSamples = static_cast<int>(keep / qint64(sizeof(int16_t)));
+        // Ramp per channel-FRAME so both channels of a stereo frame get the same
+        // gain (otherwise L and R diverge by 1/nFrames across the tail).
+        const int nFrames = nSamples / ch;
+        for (int i = 0; i < nSamples; ++i) {
+            const int frame = i / ch;
+            const double gain = (nFrames > 0) ? 1.0 - double(frame) / double(nFrames) : 0.0;
+            samples[i] = int16_t(samples[i] * gain);
+        }
+
+        // Queue the ramped tail behind the current data, then drop everything
+        // before it in one step.  If the device consumed part of the old head
+        // meanwhile, the tail starts too early: redo it from the new position.
+        copyIn(writePos, tail.constData(), keep);
+        if (m_readPos.compare_exchange_strong(readPos, writePos, std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+            m_writePos.store(writePos + quint64(keep), std::memory_order_release);
+            return;
+        }
     }
 }
 
 qint64 AudioRingBuffer::takeUnderrunDebt() {
-    QMutexLocker locker(&m_mutex);
-    const qint64 debt = m_underrunDebt;
-    m_underrunDebt = 0;
-    return debt;
+    quint64 state = m_debtState.load(std::memory_order_relaxed);
+    while (!m_debtState.compare_exchange_weak(state, state & ~kDebtMask,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+    }
+    return qint64(state & kDebtMask);
 }
 
 void AudioRingBuffer::addUnderrunDebt(qint64 bytes) {
     if (bytes <= 0) return;
-    QMutexLocker locker(&m_mutex);
-    m_underrunDebt += bytes;
     // Cap to one ring's worth (consistent with readData's cap) so a large stall
     // cannot grow the carried-forward debt beyond ~500 ms of audio.
-    if (m_underrunDebt > m_maxBufBytes) {
-        m_underrunDebt = m_maxBufBytes;
-    }
+    addDebtBounded(bytes, 0, false);
 }
 
 bool AudioRingBuffer::takeOverflowed() {
-    QMutexLocker locker(&m_mutex);
-    const bool f = m_overflowed;
-    m_overflowed = false;
-    return f;
+    return m_overflowed.exchange(false, std::memory_order_relaxed);
 }
 
 qint64 AudioRingBuffer::bytesAvailable() const {
-    QMutexLocker locker(&m_mutex);
-    return m_buf.size() + QIODevice::bytesAvailable();
+    const quint64 readPos = m_readPos.load(std::memory_order_acquire);
+    const quint64 writePos = m_writePos.load(std::memory_order_acquire);
+    return qint64(writePos - readPos) + QIODevice::bytesAvailable();
 }
 
 qint64 AudioRingBuffer::readData(char *data, qint64 maxSize) {
-    QMutexLocker locker(&m_mutex);
-    const qint64 toRead = qMin(maxSize, (qint64)m_buf.size());
-    if (toRead > 0) {
-        memcpy(data, m_buf.constData(), toRead);
-        m_buf.remove(0, toRead);
+    if (maxSize <= 0) return 0;
+    const quint64 epoch = m_debtState.load(std::memory_order_acquire) >> kDebtBits;
+
+    qint64 toRead = 0;
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        quint64 readPos = m_readPos.load(std::memory_order_acquire);
+        const quint64 writePos = m_writePos.load(std::memory_order_acquire);
+        const qint64 n = qMin(maxSize, qint64(writePos - readPos));
+        if (n <= 0) break;
+        copyOut(readPos, data, n);
+        if (m_readPos.compare_exchange_strong(readPos, readPos + quint64(n),
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire)) {
+            toRead = n;
+            break;
+        }
+        // The producer discarded bytes under this read (cap-trim, clear or
+        // fade) and may have reused them; the copy can be torn, so re-read.
     }
     if (toRead < maxSize) {
         // Pad with silence so the device clock never stalls.  While a
         // stream is active this is an underrun: record it so the next
         // push skips the bytes whose play time this silence consumed.
-        memset(data + toRead, 0, maxSize - toRead);
-        if (m_streamActive) {
-            m_underrunDebt += maxSize - toRead;
-            // Cap the debt at one ring's worth so a long stall (e.g. a pause
-            // with a stray late push leaving m_streamActive true) can swallow
-            // at most ~500 ms of real audio on resume, not the whole pause.
-            if (m_underrunDebt > m_maxBufBytes) {
-                m_underrunDebt = m_maxBufBytes;
-            }
-        }
+        memset(data + toRead, 0, size_t(maxSize - toRead));
+        if (m_streamActive.load()) addDebtBounded(maxSize - toRead, epoch, true);
     }
     return maxSize;
 }
@@ -296,9 +399,9 @@ void AudioPlayer::pushSamples(const uint8_t *data, int numBytes,
 
     // Repay underrun debt here (moved out of AudioRingBuffer::push): the
     // device already played this many bytes as silence, so skip them from the
-    // payload head to stay aligned with the device clock.  Draining the debt
-    // under the ring mutex (takeUnderrunDebt) matches readData's accrual under
-    // the same mutex — no double-count, no loss.
+    // payload head to stay aligned with the device clock.  takeUnderrunDebt
+    // swaps the debt out atomically against readData's atomic accrual — no
+    // double-count, no loss.
     // If the payload is smaller than the total debt, the leftover is written
     // back via addUnderrunDebt so it is repaid on the next push — one push
     // repays at most one payload's worth, keeping debt reduction frame-aligned.
@@ -9,39 +9,49 @@
 #include <QByteArray>
 #include <QtGlobal>
 #include <atomic>
+#include <memory>
 
 /**
- * Thread-safe FIFO QIODevice feeding QAudioSink in pull mode.
- * PlaybackWorker writes into it from its thread;
- * QAudioSink reads from it on the audio backend thread.
+ * Lock-free FIFO QIODevice feeding QAudioSink in pull mode.
+ * PlaybackWorker writes into it from its thread (single producer; AudioPlayer
+ * serializes push/clear/fade under its own mutex); QAudioSink reads from it on
+ * the audio backend thread (single consumer).  Neither side ever waits for the
+ * other: the PCM lives in a fixed power-of-two ring with atomic, monotonically
+ * increasing read/write positions, so a device callback is two memcpys and a
+ * compare-exchange.
  *
  * readData() always satisfies the full request (padding with silence)
  * so the device clock never stalls.  Silence played in place of due
  * stream data is tracked as "underrun debt": the same number of bytes
  * is dropped from the next push so the stream stays aligned with the
  * device clock instead of drifting later after every underrun.
+ *
+ * The producer discards queued bytes (cap-trim, clear, fade) by advancing the
+ * read position with a compare-exchange; a read that raced such a discard
+ * fails its own compare-exchange and re-reads from the new position.
  */
 class AudioRingBuffer : public QIODevice {
     Q_OBJECT
 public:
     explicit AudioRingBuffer(QObject *parent = nullptr);
 
-    /// Thread-safe append of PCM data (append + safety cap-trim only).
+    /// Append PCM data (append + safety cap-trim only).  Producer thread.
     void push(const char *data, qint64 len);
 
-    /// Discard all buffered data and reset underrun accounting.
+    /// Discard all buffered data and reset underrun accounting.  Producer thread.
     void clear();
 
     /// Apply a short fade-out to remaining data, then discard the rest.
+    /// Producer thread.
     void fadeOutAndClear(int channels);
 
-    /// Safety cap for buffered data (bytes).
-    void setMaxBufBytes(int bytes) { m_maxBufBytes = qMax(1, bytes); }
+    /// Safety cap for buffered data (bytes).  Re-sizes the ring and discards
+    /// its contents, so call it before the device starts reading.
+    void setMaxBufBytes(int bytes);
 
     /// Return and clear the accumulated underrun debt (bytes the device
     /// played as silence in place of due stream data).  Drained by
     /// AudioPlayer::pushSamples so it can repay the debt and fade the splice.
-    /// Locks the ring mutex.
     qint64 takeUnderrunDebt();
 
     /// Add back un-repaid underrun debt so it is carried into the next push.
@@ -49,13 +59,12 @@ public:
     /// than the outstanding debt (one push repays at most one payload's worth).
     /// Uses ADD semantics so concurrent readData increments on the device
     /// thread are preserved; clamps to m_maxBufBytes consistent with readData.
-    /// Locks the ring mutex.
     void addUnderrunDebt(qint64 bytes);
 
     /// Return and clear the overflow flag.  Set when push() had to trim the
     /// oldest (due-next) bytes because the buffer exceeded the safety cap;
     /// AudioPlayer uses it to force a re-alignment instead of permanently
-    /// desyncing.  Locks the ring mutex.
+    /// desyncing.
     bool takeOverflowed();
 
     // QIODevice sequential interface
@@ -67,12 +76,28 @@ protected:
     qint64 writeData(const char *data, qint64 maxSize) override;
 
 private:
-    mutable QMutex m_mutex;
-    QByteArray m_buf;
-    int m_maxBufBytes = 48000 * 2 * 2;  // ~500 ms @ 48 kHz stereo S16 (safety cap)
-    qint64 m_underrunDebt = 0;          // silence played in place of due data
-    bool m_streamActive = false;        // true once real data flowed since last clear
-    bool m_overflowed = false;          // push() cap-trimmed due-next bytes
+    // Underrun debt and a clear epoch share one word: a readData() that
+    // started before a clear() cannot add its silence to the cleared debt.
+    static constexpr int kDebtBits = 40;
+    static constexpr quint64 kDebtMask = (quint64(1) << kDebtBits) - 1;
+    static constexpr int kReadAttempts = 4;
+
+    void copyOut(quint64 pos, char *dst, qint64 len) const;
+    void copyIn(quint64 pos, const char *src, qint64 len);
+    // Advance the read position to at least `target` (a no-op if the
+    // consumer already moved past it).
+    void discardUpTo(quint64 target);
+    void addDebtBounded(qint64 bytes, quint64 expectedEpoch, bool checkEpoch);
+    void resetStreamAccounting();
+
+    std::unique_ptr<char[]> m_ring;
+    quint64 m_capacity = 0;                  // power of two
+    alignas(64) std::atomic<quint64> m_readPos{0};
+    alignas(64) std::atomic<quint64> m_writePos{0};
+    std::atomic<int> m_maxBufBytes{48000 * 2 * 2}; // ~500 ms @ 48 kHz stereo S16 (safety cap)
+    std::atomic<quint64> m_debtState{0};     // epoch << kDebtBits | debt bytes
+    std::atomic<bool> m_streamActive{false}; // true once real data flowed since last clear
+    std::atomic<bool> m_overflowed{false};   // push() cap-trimmed due-next bytes
 };
 
 /**
@@ -0,0 +1,76 @@
+#include "playback/cueslotplan.h"
+
+#include <QByteArray>
+
+#include <algorithm>
+
+int CueSlotPlan::maxSlotsFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_PREROLL_SLOTS");
+    if (env.isEmpty()) return kDefaultMaxSlots;
+    bool ok = false;
+    const int parsed = env.toInt(&ok);
+    return (ok && parsed >= 0) ? parsed : kDefaultMaxSlots;
+}
+
+qint64 CueSlotPlan::budgetBytesFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_PREROLL_BUDGET_MB");
+    bool ok = false;
+    const qint64 parsed = env.isEmpty() ? -1 : env.toLongLong(&ok);
+    const qint64 mb = (ok && parsed >= 0) ? parsed : kDefaultBudgetMb;
+    return mb * 1024 * 1024;
+}
+
+qint64 CueSlotPlan::bytesPerSlot(int feedCount, int width, int height, int fps, int spanMs) {
+    if (feedCount <= 0 || width <= 0 || height <= 0 || fps <= 0 || spanMs <= 0) return 0;
+    const qint64 framesPerFeed = (qint64(spanMs) * fps + 999) / 1000;
+    const qint64 frameBytes = qint64(width) * height * 3 / 2;
+    return qint64(feedCount) * framesPerFeed * frameBytes;
+}
+
+int CueSlotPlan::slotCount(qint64 budgetBytes, qint64 bytesPerSlot, int maxSlots) {
+    if (maxSlots <= 0 || budgetBytes <= 0) return 0;
+    if (bytesPerSlot <= 0) return maxSlots;
+    return int(std::min<qint64>(maxSlots, budgetBytes / bytesPerSlot));
+}
+
+QVector<int> CueSlotPlan::assign(const QVector<PrerollCue>& held,
+                                 const QVector<PrerollCue>& wanted) {
+    QVector<int> result(held.size(), -1);
+    // The highest-priority distinct cues, as many as there are slots.
+    QVector<int> candidates;
+    for (int i = 0; i < wanted.size() && candidates.size() < held.size(); ++i) {
+        if (!wanted[i].isValid()) continue;
+        const bool duplicate = std::any_of(candidates.begin(), candidates.end(),
+                                           [&](int c) { return wanted[c] == wanted[i]; });
+        if (!duplicate) candidates.append(i);
+    }
+    QVector<int> unplaced;
+    for (int i : candidates) {
+        int slot = -1;
+        for (int j = 0; j < held.size(); ++j) {
+            if (result[j] < 0 && held[j].isValid() && held[j] == wanted[i]) {
+                slot = j;
+                break;
+            }
+        }
+        if (slot >= 0)
+            result[slot] = i;
+        else
+            unplaced.append(i);
+    }
+    int next = 0;
+    for (int i : unplaced) {
+        while (next < result.size() && result[next] >= 0) ++next;
+        if (next == result.size()) break;
+        result[next] = i;
+    }
+    return result;
+}
+
+int CueSlotPlan::find(const QVector<PrerollCue>& held, const PrerollCue& cue) {
+    if (!cue.isValid()) return -1;
+    for (int j = 0; j < held.size(); ++j) {
+        if (held[j] == cue) return j;
+    }
+    return -1;
+}
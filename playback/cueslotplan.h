@@ -0,0 +1,49 @@
+#ifndef CUESLOTPLAN_H
+#define CUESLOTPLAN_H
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+// An upcoming cut point to keep pre-rolled: a position on a clip.
+struct PrerollCue {
+    QString clipPath; // empty = the clip the primary bank is playing
+    qint64 targetMs = -1;
+
+    bool isValid() const { return targetMs >= 0; }
+    bool operator==(const PrerollCue& other) const {
+        return clipPath == other.clipPath && targetMs == other.targetMs;
+    }
+    bool operator!=(const PrerollCue& other) const { return !(*this == other); }
+};
+
+// Pure slot bookkeeping for the multi-slot pre-roll: how many staged windows
+// fit the memory budget, and which upcoming cue each slot should hold. Cues
+// are compared verbatim, so callers resolve clip paths to one key form first.
+struct CueSlotPlan {
+    static constexpr int kDefaultMaxSlots = 3;
+    static constexpr qint64 kDefaultBudgetMb = 2048;
+
+    // OLR_PREROLL_SLOTS: upper bound on staged cues besides the armed cut's
+    // own pre-roll; 0 disables the slots.
+    static int maxSlotsFromEnvironment();
+    // OLR_PREROLL_BUDGET_MB: memory the slots' staged frames may occupy.
+    static qint64 budgetBytesFromEnvironment();
+
+    // Estimated bytes of one staged window: spanMs of 4:2:0 8-bit frames on
+    // every feed.
+    static qint64 bytesPerSlot(int feedCount, int width, int height, int fps, int spanMs);
+    // Slots that fit budgetBytes, capped at maxSlots.
+    static int slotCount(qint64 budgetBytes, qint64 bytesPerSlot, int maxSlots);
+
+    // Maps the wanted cues (highest priority first) onto the currently held
+    // ones. Returns, per slot, the index into `wanted` it should hold, or -1
+    // for a slot left free. A slot already holding a wanted cue keeps it;
+    // the remaining highest-priority cues take the free or unwanted slots in
+    // slot order. Duplicate and invalid wanted cues are ignored.
+    static QVector<int> assign(const QVector<PrerollCue>& held, const QVector<PrerollCue>& wanted);
+    // The slot holding `cue`, or -1.
+    static int find(const QVector<PrerollCue>& held, const PrerollCue& cue);
+};
+
+#endif // CUESLOTPLAN_H
@@ -0,0 +1,40 @@
+#ifndef DECODERTRACK_H
+#define DECODERTRACK_H
+
+#include <memory>
+
+#include "playback/trackbuffer.h"
+#include "recorder_engine/ingest/nativevideodecoder.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+class FrameProvider;
+
+struct DecoderTrack {
+    AVCodecContext* codecCtx = nullptr;
+    // Hardware H.264 decode: when set, this track is decoded via NativeVideoDecoder
+    // instead of the FFmpeg software codecCtx (which stays nullptr for H.264 tracks).
+    std::unique_ptr<NativeVideoDecoder> nativeDecoder;
+    H26xParameterSets h264ParamSets; // SPS/PPS parsed from avcC extradata at open time
+    // Dimensions for the output-graph init when codecCtx is null (H.264 tracks).
+    int codecWidth = 0;
+    int codecHeight = 0;
+    FrameProvider* provider = nullptr;
+    int streamIndex = -1;
+    int feedIndex = -1;
+    TrackBuffer buffer;
+    int64_t lastDeliveredPtsMs = -1; // last frame released to the provider
+    int decimateCounter = 0;         // per-track keep-counter (§6.3 decimation)
+};
+
+struct AudioDecoderTrack {
+    AVCodecContext* codecCtx = nullptr;
+    int streamIndex = -1;
+    int viewIndex = -1;             // which view (0..N-1) this audio belongs to
+    int64_t lastEnqueuedPtsMs = -1; // for dedup-before-decode after EOF un-latch
+    int64_t lastCachedPtsMs = -1;   // output-bus audio cache dedup
+};
+
+#endif // DECODERTRACK_H
@@ -0,0 +1,365 @@
+#include "playback/demuxbankpool.h"
+
+#include "recorder_engine/codec/avcc.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QDir>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace {
+constexpr auto kWarmRetryDelay = std::chrono::seconds(2);
+} // namespace
+
+bool parseAvcC(const AVCodecParameters* codecParams, H26xParameterSets& params) {
+    const QByteArray avcc = QByteArray::fromRawData(
+        reinterpret_cast<const char*>(codecParams->extradata), codecParams->extradata_size);
+    return parseAvcc(avcc, &params.h264Sps, &params.h264Pps);
+}
+
+DemuxBank::~DemuxBank() {
+    for (auto* track : video) {
+        track->nativeDecoder.reset(); // tear down VT/MF session before freeing track
+        if (track->codecCtx) avcodec_free_context(&track->codecCtx);
+        delete track;
+    }
+    for (auto* aTrack : audio) {
+        if (aTrack->codecCtx) avcodec_free_context(&aTrack->codecCtx);
+        delete aTrack;
+    }
+    if (fmtCtx) avformat_close_input(&fmtCtx);
+}
+
+std::unique_ptr<DemuxBank> DemuxBank::open(const QString& path, int maxVideoTracks,
+                                           AVIOInterruptCB interrupt) {
+    AVFormatContext* ctx = avformat_alloc_context();
+    if (!ctx) return nullptr;
+    ctx->interrupt_callback = interrupt;
+    if (avformat_open_input(&ctx, path.toUtf8().constData(), nullptr, nullptr) < 0) {
+        avformat_close_input(&ctx);
+        return nullptr;
+    }
+    auto bank = std::make_unique<DemuxBank>();
+    bank->path = path;
+    bank->fmtCtx = ctx;
+    if (avformat_find_stream_info(ctx, nullptr) < 0) return nullptr;
+
+    // Video bank, mapped 1:1 by stream order to feedIndex and capped at the
+    // provider count so the feedIndex matches the live cache feeds.
+    int feedIndex = 0;
+    for (unsigned int i = 0; i < ctx->nb_streams; i++) {
+        AVCodecParameters* codecParams = ctx->streams[i]->codecpar;
+        if (codecParams->codec_type != AVMEDIA_TYPE_VIDEO) continue;
+        if (feedIndex >= maxVideoTracks) break;
+
+        // H.264: hardware-only licensing constraint — NEVER software-decode.
+        // With HW available and usable avcC extradata, build a NativeVideoDecoder
+        // exactly as the primary bank does; otherwise skip the track, so an
+        // all-H.264 clip without HW yields no bank (armed cut unavailable).
+        if (codecParams->codec_id == AV_CODEC_ID_H264) {
+            if (!queryNativeVideoDecodeCapabilities().h264 || codecParams->extradata_size < 8)
+                continue;
+            H26xParameterSets params;
+            if (!parseAvcC(codecParams, params)) {
+                qWarning() << "DemuxBank: H.264 avcC parse failed for stream" << i << "of" << path
+                           << "— skipping (HW-only constraint)";
+                continue;
+            }
+            DecoderTrack* track = new DecoderTrack();
+            track->streamIndex = static_cast<int>(i);
+            track->nativeDecoder =
+                std::make_unique<NativeVideoDecoder>(codecParams->width, codecParams->height);
+            track->h264ParamSets = params;
+            track->codecWidth = codecParams->width;
+            track->codecHeight = codecParams->height;
+            track->feedIndex = feedIndex++;
+            bank->video.append(track);
+            continue;
+        }
+
+        const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
+        if (!codec) continue;
+        AVCodecContext* cctx = avcodec_alloc_context3(codec);
+        if (!cctx) continue;
+        avcodec_parameters_to_context(cctx, codecParams);
+        cctx->thread_count = 0;
+        if (avcodec_open2(cctx, codec, nullptr) < 0) {
+            avcodec_free_context(&cctx);
+            continue;
+        }
+        DecoderTrack* track = new DecoderTrack();
+        track->streamIndex = static_cast<int>(i);
+        track->codecCtx = cctx;
+        track->feedIndex = feedIndex++;
+        bank->video.append(track);
+    }
+    if (bank->video.isEmpty()) return nullptr;
+
+    // Audio bank (paired with video by order), like the primary.
+    int audioViewIdx = 0;
+    for (unsigned int i = 0; i < ctx->nb_streams; i++) {
+        AVCodecParameters* codecParams = ctx->streams[i]->codecpar;
+        if (codecParams->codec_type != AVMEDIA_TYPE_AUDIO) continue;
+        const int viewIndex = audioViewIdx++;
+        const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
+        if (!codec) continue;
+        AVCodecContext* cctx = avcodec_alloc_context3(codec);
+        if (!cctx) continue;
+        avcodec_parameters_to_context(cctx, codecParams);
+        cctx->thread_count = 0;
+        if (avcodec_open2(cctx, codec, nullptr) < 0) {
+            avcodec_free_context(&cctx);
+            continue;
+        }
+        AudioDecoderTrack* aTrack = new AudioDecoderTrack();
+        aTrack->streamIndex = static_cast<int>(i);
+        aTrack->codecCtx = cctx;
+        aTrack->viewIndex = viewIndex;
+        bank->audio.append(aTrack);
+    }
+    return bank;
+}
+
+int DemuxBankPool::capacityFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_DEMUX_POOL_SIZE");
+    if (env.isEmpty()) return kDefaultCapacity;
+    bool ok = false;
+    const int parsed = env.toInt(&ok);
+    return (ok && parsed >= 0) ? parsed : kDefaultCapacity;
+}
+
+QString DemuxBankPool::keyFor(const QString& path) { return QDir::cleanPath(path); }
+
+DemuxBankPool::DemuxBankPool(Opener opener, int capacity)
+    : m_opener(std::move(opener)), m_capacity(std::max(0, capacity)) {}
+
+DemuxBankPool::~DemuxBankPool() { stop(); }
+
+int DemuxBankPool::interruptCallback(void* opaque) {
+    const auto* pool = static_cast<const DemuxBankPool*>(opaque);
+    return pool->m_stopping.load(std::memory_order_acquire) ? 1 : 0;
+}
+
+AVIOInterruptCB DemuxBankPool::interruptCb() {
+    AVIOInterruptCB cb;
+    cb.callback = &DemuxBankPool::interruptCallback;
+    cb.opaque = this;
+    return cb;
+}
+
+std::unique_ptr<DemuxBank> DemuxBankPool::take(const QString& path) {
+    const QString key = keyFor(path);
+    std::unique_ptr<DemuxBank> bank;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        auto it = std::find_if(m_banks.begin(), m_banks.end(),
+                               [&](const auto& b) { return keyFor(b->path) == key; });
+        if (it != m_banks.end()) {
+            bank = std::move(*it);
+            m_banks.erase(it);
+            m_stats.hits++;
+        } else {
+            m_stats.misses++;
+        }
+    }
+    if (bank) m_cv.notify_one(); // a wanted clip may need re-warming
+    return bank;
+}
+
+void DemuxBankPool::adoptLocked(std::unique_ptr<DemuxBank> bank) {
+    const QString key = keyFor(bank->path);
+    if (bank->fmtCtx) bank->fmtCtx->interrupt_callback = interruptCb();
+    // The newcomer replaces an older bank on the same clip (closed by trimLocked).
+    m_banks.push_front(std::move(bank));
+    for (auto it = std::next(m_banks.begin()); it != m_banks.end(); ++it) {
+        if (keyFor((*it)->path) == key) {
+            m_banks.splice(m_banks.end(), m_banks, it);
+            break;
+        }
+    }
+}
+
+void DemuxBankPool::put(std::unique_ptr<DemuxBank> bank) {
+    if (!bank) return;
+    std::vector<std::unique_ptr<DemuxBank>> evicted;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        adoptLocked(std::move(bank));
+        evicted = trimLocked();
+    }
+    // Closing demuxers/decoders can block on I/O; never under the lock.
+    evicted.clear();
+    m_cv.notify_one();
+}
+
+// Drops duplicates beyond the banks reserved for a clip, then banks beyond
+// capacity (plus the reserved ones): not-wanted clips first (least recently
+// used first), then plain LRU. Caller holds m_mutex.
+std::vector<std::unique_ptr<DemuxBank>> DemuxBankPool::trimLocked() {
+    std::vector<std::unique_ptr<DemuxBank>> evicted;
+    QStringList seen;
+    for (auto it = m_banks.begin(); it != m_banks.end();) {
+        const QString key = keyFor((*it)->path);
+        if (seen.count(key) >= std::max<qsizetype>(1, m_reserved.count(key))) {
+            evicted.push_back(std::move(*it));
+            it = m_banks.erase(it);
+            m_stats.evictions++;
+        } else {
+            seen.append(key);
+            ++it;
+        }
+    }
+    QStringList keep = warmSetLocked();
+    keep.append(m_reserved);
+    const int limit = m_capacity + int(m_reserved.size());
+    for (int pass = 0; pass < 2 && int(m_banks.size()) > limit; ++pass) {
+        for (auto it = m_banks.end(); it != m_banks.begin() && int(m_banks.size()) > limit;) {
+            --it;
+            if (pass == 0 && keep.contains(keyFor((*it)->path))) continue;
+            evicted.push_back(std::move(*it));
+            it = m_banks.erase(it);
+            m_stats.evictions++;
+        }
+    }
+    return evicted;
+}
+
+bool DemuxBankPool::contains(const QString& path) const {
+    const QString key = keyFor(path);
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return std::any_of(m_banks.begin(), m_banks.end(),
+                       [&](const auto& b) { return keyFor(b->path) == key; });
+}
+
+int DemuxBankPool::size() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return int(m_banks.size());
+}
+
+void DemuxBankPool::setWanted(const QStringList& paths) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_wanted.clear();
+        for (const QString& path : paths) {
+            const QString key = keyFor(path);
+            if (!path.isEmpty() && !m_wanted.contains(key)) m_wanted.append(key);
+        }
+    }
+    m_cv.notify_one();
+}
+
+void DemuxBankPool::setReserved(const QStringList& paths) {
+    if (m_capacity <= 0) return;
+    QStringList keys;
+    for (const QString& path : paths) {
+        if (!path.isEmpty()) keys.append(keyFor(path));
+    }
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (keys == m_reserved) return;
+        m_reserved = keys;
+    }
+    m_cv.notify_one();
+}
+
+void DemuxBankPool::setInUse(const QString& path) {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_inUse = path.isEmpty() ? QString() : keyFor(path);
+    }
+    m_cv.notify_one();
+}
+
+void DemuxBankPool::start() {
+    if (m_capacity <= 0 || m_running.exchange(true, std::memory_order_acq_rel)) return;
+    m_stopping.store(false, std::memory_order_release);
+    m_thread = std::thread(&DemuxBankPool::warmLoop, this);
+}
+
+void DemuxBankPool::stop() {
+    m_stopping.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+    std::list<std::unique_ptr<DemuxBank>> banks;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        banks.swap(m_banks);
+    }
+    banks.clear();
+    m_stopping.store(false, std::memory_order_release);
+}
+
+DemuxBankPool::Stats DemuxBankPool::stats() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_stats;
+}
+
+// The first capacity() wanted clips, minus the one the pre-roll holds. Caller
+// holds m_mutex.
+QStringList DemuxBankPool::warmSetLocked() const {
+    QStringList keys;
+    for (const QString& key : m_wanted) {
+        if (keys.size() >= m_capacity) break;
+        if (key != m_inUse) keys.append(key);
+    }
+    return keys;
+}
+
+int DemuxBankPool::pooledLocked(const QString& key) const {
+    return int(std::count_if(m_banks.begin(), m_banks.end(),
+                             [&](const auto& b) { return keyFor(b->path) == key; }));
+}
+
+// A reserved clip short of banks, else a warm-set clip that is neither pooled
+// nor being opened. Caller holds m_mutex.
+QString DemuxBankPool::nextToWarmLocked() const {
+    for (const QString& key : m_reserved) {
+        const int coming = pooledLocked(key) + (key == m_warming ? 1 : 0);
+        if (coming < m_reserved.count(key)) return key;
+    }
+    for (const QString& key : warmSetLocked()) {
+        if (pooledLocked(key) == 0 && key != m_warming) return key;
+    }
+    return QString();
+}
+
+void DemuxBankPool::warmLoop() {
+    for (;;) {
+        QString key;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_cv.wait(lk, [this, &key] {
+                if (!m_running.load(std::memory_order_acquire)) return true;
+                key = nextToWarmLocked();
+                return !key.isEmpty();
+            });
+            if (!m_running.load(std::memory_order_acquire)) return;
+            m_warming = key;
+        }
+        std::unique_ptr<DemuxBank> bank = m_opener(key, interruptCb());
+        std::vector<std::unique_ptr<DemuxBank>> evicted;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_warming.clear();
+            if (bank) {
+                m_stats.warmed++;
+                adoptLocked(std::move(bank));
+                evicted = trimLocked();
+            } else if (m_running.load(std::memory_order_acquire)) {
+                // Not openable yet (e.g. a recording still being created): retry
+                // later instead of spinning on it.
+                qDebug() << "DemuxBankPool: could not warm" << key;
+                m_cv.wait_for(lk, kWarmRetryDelay,
+                              [this] { return !m_running.load(std::memory_order_acquire); });
+            }
+        }
+        evicted.clear();
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef DEMUXBANKPOOL_H
+#define DEMUXBANKPOOL_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "playback/decodertrack.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+// A stream's avcC extradata → params' H.264 SPS/PPS, via parseAvcc (codec/avcc.h).
+// Shared by every bank that builds a NativeVideoDecoder for an H.264 track.
+bool parseAvcC(const AVCodecParameters* codecParams, H26xParameterSets& params);
+
+// One opened clip: a demuxer context plus its video/audio decoder bank, mapped
+// 1:1 by stream order to feedIndex exactly like PlaybackWorker's primary bank
+// but with no provider wiring (banks feed the armed-cut staging cache). H.264
+// tracks get a NativeVideoDecoder or are skipped — never software-decoded.
+struct DemuxBank {
+    QString path;
+    AVFormatContext* fmtCtx = nullptr;
+    QVector<DecoderTrack*> video;
+    QVector<AudioDecoderTrack*> audio;
+
+    DemuxBank() = default;
+    ~DemuxBank();
+    DemuxBank(const DemuxBank&) = delete;
+    DemuxBank& operator=(const DemuxBank&) = delete;
+
+    // Opens `path` and builds at most maxVideoTracks video decoders. Returns
+    // nullptr when the file cannot be opened or yields no decodable video.
+    static std::unique_ptr<DemuxBank> open(const QString& path, int maxVideoTracks,
+                                           AVIOInterruptCB interrupt);
+};
+
+// LRU of opened DemuxBanks keyed by clip path, so an armed cut to another clip
+// (cross-clip Recall, playlist playout) pre-rolls from an already-open demuxer
+// instead of paying avformat_open_input + find_stream_info + decoder open on
+// the playback worker.
+//
+// The worker checks banks out with take() and hands them back with put(); a
+// checked-out bank does not count against the capacity. A warmer thread opens
+// the clips the playlist references (setWanted) ahead of use, skipping the
+// clip the worker's pre-roll currently holds (setInUse), and the banks the
+// worker's cue slots are waiting for (setReserved). Thread-safe.
+class DemuxBankPool {
+public:
+    // Opens one bank; `interrupt` aborts its blocking I/O when the pool stops.
+    using Opener =
+        std::function<std::unique_ptr<DemuxBank>(const QString& path, AVIOInterruptCB interrupt)>;
+
+    struct Stats {
+        qint64 hits = 0;      // take() served from the pool
+        qint64 misses = 0;    // take() found nothing
+        qint64 evictions = 0; // banks closed to stay within capacity or replaced on put()
+        qint64 warmed = 0;    // banks opened ahead of use by the warmer
+    };
+
+    static constexpr int kDefaultCapacity = 2;
+    // OLR_DEMUX_POOL_SIZE (banks kept open besides the worker's two); 0
+    // disables the pool and its warmer, and with them cue-slot staging and
+    // cross-clip armed cuts.
+    static int capacityFromEnvironment();
+    static QString keyFor(const QString& path);
+
+    explicit DemuxBankPool(Opener opener, int capacity = kDefaultCapacity);
+    ~DemuxBankPool();
+
+    DemuxBankPool(const DemuxBankPool&) = delete;
+    DemuxBankPool& operator=(const DemuxBankPool&) = delete;
+
+    int capacity() const { return m_capacity; }
+
+    // Removes and returns the bank for `path`, or nullptr on a miss.
+    std::unique_ptr<DemuxBank> take(const QString& path);
+    // Returns a bank as most-recently-used. A bank for a clip already pooled
+    // replaces it; the least-recently-used banks beyond capacity are closed.
+    void put(std::unique_ptr<DemuxBank> bank);
+    bool contains(const QString& path) const;
+    int size() const;
+
+    // Clips to keep warm, most important first; only the first capacity()
+    // distinct clips are opened.
+    void setWanted(const QStringList& paths);
+    void setInUse(const QString& path);
+    // One entry per bank the worker is waiting for; a clip listed n times gets n
+    // banks, opened by the warmer before the warm set and kept on top of the
+    // capacity until taken. Ignored when the pool is disabled.
+    void setReserved(const QStringList& paths);
+
+    void start();
+    void stop(); // joins the warmer and closes every pooled bank
+
+    Stats stats() const;
+
+private:
+    // The pool's own interrupt callback, installed on every pooled context so
+    // stop() aborts a warm-up blocked in I/O.
+    static int interruptCallback(void* opaque);
+    AVIOInterruptCB interruptCb();
+    void adoptLocked(std::unique_ptr<DemuxBank> bank);
+    void warmLoop();
+    QStringList warmSetLocked() const;
+    QString nextToWarmLocked() const;
+    int pooledLocked(const QString& key) const;
+    std::vector<std::unique_ptr<DemuxBank>> trimLocked();
+
+    const Opener m_opener;
+    const int m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::list<std::unique_ptr<DemuxBank>> m_banks; // front = most recently used
+    QStringList m_wanted;                          // keys, in priority order
+    QString m_inUse;                               // key
+    QStringList m_reserved;                        // keys, one per bank waited for
+    QString m_warming;                             // key being opened by the warmer
+    Stats m_stats;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+};
+
+#endif // DEMUXBANKPOOL_H
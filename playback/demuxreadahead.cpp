@@ -0,0 +1,124 @@
+#include "playback/demuxreadahead.h"
+
+#include <QByteArray>
+
+#include <algorithm>
+#include <climits>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#endif
+
+std::optional<DemuxReadAhead::Range> DemuxReadAhead::plan(int dir, qint64 readPos,
+                                                          std::optional<qint64> reverseLoOffset,
+                                                          qint64 windowBytes) {
+    if (readPos < 0 || windowBytes <= 0) return std::nullopt;
+    if (dir >= 0) return Range{readPos, windowBytes};
+    if (!reverseLoOffset.has_value() || reverseLoOffset.value() >= readPos) return std::nullopt;
+    // Reverse: the chunk below the current read position, clamped to the window
+    // so a far reverse jump does not prefetch the whole file.
+    const qint64 lo = std::max(reverseLoOffset.value(), readPos - windowBytes);
+    return Range{lo, readPos - lo};
+}
+
+DemuxReadAhead::~DemuxReadAhead() { close(); }
+
+bool DemuxReadAhead::open(const QString& path) {
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) return false;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_pending.reset();
+        m_lastPrefetched = Range{};
+    }
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&DemuxReadAhead::ioLoop, this);
+    return true;
+}
+
+void DemuxReadAhead::close() {
+    if (m_running.exchange(false, std::memory_order_acq_rel)) m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+    if (m_file.isOpen()) m_file.close();
+}
+
+void DemuxReadAhead::request(const Range& range) {
+    if (!isOpen() || range.length <= 0) return;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        const qint64 lastEnd = m_lastPrefetched.offset + m_lastPrefetched.length;
+        if (range.offset >= m_lastPrefetched.offset && range.offset + range.length <= lastEnd) {
+            m_coveredSkips.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        m_pending = range; // latest wins; a superseded range is never fetched
+    }
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+    m_cv.notify_one();
+}
+
+DemuxReadAhead::Stats DemuxReadAhead::stats() const {
+    Stats s;
+    s.requests = m_requests.load(std::memory_order_relaxed);
+    s.coveredSkips = m_coveredSkips.load(std::memory_order_relaxed);
+    s.prefetches = m_prefetches.load(std::memory_order_relaxed);
+    s.bytesPrefetched = m_bytesPrefetched.load(std::memory_order_relaxed);
+    return s;
+}
+
+void DemuxReadAhead::ioLoop() {
+    for (;;) {
+        Range range;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_cv.wait(lk, [this] {
+                return m_pending.has_value() || !m_running.load(std::memory_order_acquire);
+            });
+            if (!m_running.load(std::memory_order_acquire)) return;
+            range = m_pending.value();
+            m_pending.reset();
+            // Forward progression: only the part past the previous prefetch is
+            // new. The coverage record is the full requested window either way.
+            const Range last = m_lastPrefetched;
+            const qint64 lastEnd = last.offset + last.length;
+            const qint64 end = range.offset + range.length;
+            m_lastPrefetched = range;
+            if (range.offset >= last.offset && range.offset < lastEnd && end > lastEnd)
+                range = Range{lastEnd, end - lastEnd};
+        }
+        prefetch(range);
+    }
+}
+
+void DemuxReadAhead::prefetch(const Range& range) {
+    // The recording grows under us; never hint past the current end.
+    const qint64 size = m_file.size();
+    const qint64 end = std::min(range.offset + range.length, size);
+    if (range.offset >= end) return;
+    const qint64 length = end - range.offset;
+
+#if defined(__linux__)
+    // Asynchronous: the kernel schedules the reads and returns immediately.
+    ::posix_fadvise(m_file.handle(), range.offset, length, POSIX_FADV_WILLNEED);
+#elif defined(__APPLE__)
+    struct radvisory advice;
+    advice.ra_offset = range.offset;
+    advice.ra_count = int(std::min<qint64>(length, INT_MAX));
+    ::fcntl(m_file.handle(), F_RDADVISE, &advice);
+#else
+    // No advisory call: read the range through once so it lands in the OS
+    // cache. Bails out promptly on close().
+    constexpr qint64 kReadThroughChunkBytes = qint64(1) * 1024 * 1024;
+    QByteArray scratch(int(kReadThroughChunkBytes), Qt::Uninitialized);
+    if (!m_file.seek(range.offset)) return;
+    for (qint64 done = 0; done < length && m_running.load(std::memory_order_acquire);) {
+        const qint64 got =
+            m_file.read(scratch.data(), std::min(kReadThroughChunkBytes, length - done));
+        if (got <= 0) break;
+        done += got;
+    }
+#endif
+    m_prefetches.fetch_add(1, std::memory_order_relaxed);
+    m_bytesPrefetched.fetch_add(length, std::memory_order_relaxed);
+}
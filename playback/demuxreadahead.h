@@ -0,0 +1,78 @@
+#ifndef DEMUXREADAHEAD_H
+#define DEMUXREADAHEAD_H
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Background prefetch of the byte range the demuxer is about to read, so a
+// busy disk (RAID under recording load, network storage) costs the I/O thread
+// a wait instead of stalling the playback worker's av_read_frame.
+//
+// The worker posts the range it expects to read next (request(); the latest
+// request wins, non-blocking) and a dedicated thread hints the kernel on its
+// own file handle: POSIX_FADV_WILLNEED on Linux, F_RDADVISE on Apple, and a
+// plain read-through into a scratch buffer elsewhere. Nothing here touches the
+// worker's AVFormatContext, so there is no locking against the demuxer.
+class DemuxReadAhead {
+public:
+    struct Range {
+        qint64 offset = 0;
+        qint64 length = 0;
+    };
+    struct Stats {
+        qint64 requests = 0;       // request() calls that were queued
+        qint64 coveredSkips = 0;   // requests already inside the last prefetch
+        qint64 prefetches = 0;     // ranges actually hinted / read through
+        qint64 bytesPrefetched = 0;
+    };
+
+    static constexpr qint64 kForwardWindowBytes = qint64(24) * 1024 * 1024;
+
+    // Plans the next prefetch. Forward: [readPos, readPos + windowBytes).
+    // Reverse: from the FrameIndex offset of the chunk the reverse fill will
+    // seek to next (reverseLoOffset) up to the current read position, so the
+    // backward chunk is warm before the seek lands on it. nullopt when there is
+    // nothing useful to prefetch (unknown position / unindexed reverse target).
+    static std::optional<Range> plan(int dir, qint64 readPos,
+                                     std::optional<qint64> reverseLoOffset,
+                                     qint64 windowBytes = kForwardWindowBytes);
+
+    DemuxReadAhead() = default;
+    ~DemuxReadAhead();
+
+    DemuxReadAhead(const DemuxReadAhead&) = delete;
+    DemuxReadAhead& operator=(const DemuxReadAhead&) = delete;
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_running.load(std::memory_order_acquire); }
+
+    void request(const Range& range);
+    Stats stats() const;
+
+private:
+    void ioLoop();
+    void prefetch(const Range& range);
+
+    QFile m_file; // the I/O thread's own handle, never the demuxer's
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_running{false};
+    std::optional<Range> m_pending; // guarded by m_mutex
+    Range m_lastPrefetched;         // guarded by m_mutex
+
+    std::atomic<qint64> m_requests{0};
+    std::atomic<qint64> m_coveredSkips{0};
+    std::atomic<qint64> m_prefetches{0};
+    std::atomic<qint64> m_bytesPrefetched{0};
+};
+
+#endif // DEMUXREADAHEAD_H
@@ -0,0 +1,350 @@
+#include "playback/export/clipexporter.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopeGuard>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libavutil/dict.h>
+    #include <libavutil/mathematics.h>
+}
+
+namespace {
+constexpr AVRational kMsTimeBase{1, 1000};
+// An exact FrameIndex seek is kept only when the first primary-video packet lands within
+// this much before inMs; otherwise the container seek is used.
+constexpr qint64 kSeekBandMs = 1000;
+constexpr int kSeekProbePackets = 64;
+// Recordings interleave all tracks by time: once any packet is this far past outMs, no
+// selected packet inside the range can still follow.
+constexpr qint64 kInterleaveSlackMs = 2000;
+
+enum class TrackKind { Skip, Video, Audio, Metadata, Telemetry };
+
+struct TrackPlan {
+    TrackKind kind = TrackKind::Skip;
+    int view = -1;
+    int outIndex = -1;
+};
+
+bool isTelemetryTrack(const AVStream* stream) {
+    const AVDictionaryEntry* type = av_dict_get(stream->metadata, "olr_track_type", nullptr, 0);
+    return type && qstrcmp(type->value, "feed_telemetry") == 0;
+}
+
+// MPEG-TS has no codec query; it carries the compressed codecs a recording can hold
+// and nothing else (PCM only as SMPTE 302M, which needs a re-encode).
+bool containerCarries(ClipExportContainer container, const AVOutputFormat* format,
+                      AVCodecID codec) {
+    if (container == ClipExportContainer::MpegTs) {
+        return codec == AV_CODEC_ID_MPEG2VIDEO || codec == AV_CODEC_ID_H264 ||
+               codec == AV_CODEC_ID_HEVC || codec == AV_CODEC_ID_AAC ||
+               codec == AV_CODEC_ID_MP2 || codec == AV_CODEC_ID_AC3;
+    }
+    return avformat_query_codec(format, codec, FF_COMPLIANCE_NORMAL) == 1;
+}
+
+QString trackLabel(const AVStream* stream) {
+    const AVDictionaryEntry* title = av_dict_get(stream->metadata, "title", nullptr, 0);
+    const QString name = title ? QString::fromUtf8(title->value)
+                               : QStringLiteral("stream %1").arg(stream->index);
+    const QString codec = QString::fromUtf8(avcodec_get_name(stream->codecpar->codec_id));
+    return QStringLiteral("%1 (%2)").arg(name, codec);
+}
+
+qint64 packetPtsMs(const AVPacket* pkt, const AVStream* stream) {
+    const int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+    if (ts == AV_NOPTS_VALUE) return INT64_MIN;
+    return av_rescale_q(ts, stream->time_base, kMsTimeBase);
+}
+
+ClipExportResult failed(ClipExportResult result, const QString& error) {
+    result.ok = false;
+    result.error = error;
+    return result;
+}
+} // namespace
+
+ClipExporter::ClipExporter(const ClipExportRequest& request, QObject* parent)
+    : QThread(parent), m_request(request) {}
+
+ClipExporter::~ClipExporter() {
+    requestInterruption();
+    wait();
+}
+
+std::optional<ClipExportContainer> ClipExporter::containerForPath(const QString& path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == QLatin1String("mkv")) return ClipExportContainer::Matroska;
+    if (suffix == QLatin1String("mov")) return ClipExportContainer::QuickTime;
+    if (suffix == QLatin1String("ts") || suffix == QLatin1String("m2ts"))
+        return ClipExportContainer::MpegTs;
+    return std::nullopt;
+}
+
+const char* ClipExporter::muxerName(ClipExportContainer container) {
+    switch (container) {
+    case ClipExportContainer::Matroska: return "matroska";
+    case ClipExportContainer::QuickTime: return "mov";
+    case ClipExportContainer::MpegTs: return "mpegts";
+    }
+    return "matroska";
+}
+
+int ClipExporter::interruptCallback(void* opaque) {
+    auto* exporter = static_cast<ClipExporter*>(opaque);
+    return exporter ? exporter->isInterruptionRequested() : 0;
+}
+
+void ClipExporter::run() {
+    m_result = exportNow();
+    emit exportFinished(m_result.ok, m_result.error);
+}
+
+bool ClipExporter::seekToIn(AVFormatContext* in, int primaryStream, qint64 inMs) {
+    AVStream* primary = in->streams[primaryStream];
+    if (m_frameIndex.has_value() && in->pb) {
+        const std::optional<qint64> offset = m_frameIndex->nearestAtOrBefore(inMs);
+        if (offset.has_value() && avio_seek(in->pb, offset.value(), SEEK_SET) >= 0) {
+            avformat_flush(in);
+            // A raw byte seek into Matroska is not guaranteed to resync at that PTS:
+            // probe the landed primary-video PTS before trusting it.
+            bool landedInBand = false;
+            AVPacket* pkt = av_packet_alloc();
+            for (int probed = 0; pkt && probed < kSeekProbePackets; ++probed) {
+                if (av_read_frame(in, pkt) < 0) break;
+                const bool isPrimary = pkt->stream_index == primaryStream;
+                const qint64 ptsMs = isPrimary ? packetPtsMs(pkt, primary) : INT64_MIN;
+                av_packet_unref(pkt);
+                if (!isPrimary) continue;
+                landedInBand = ptsMs != INT64_MIN && ptsMs <= inMs && ptsMs >= inMs - kSeekBandMs;
+                break;
+            }
+            av_packet_free(&pkt);
+            if (landedInBand && avio_seek(in->pb, offset.value(), SEEK_SET) >= 0) {
+                avformat_flush(in);
+                return true;
+            }
+        }
+    }
+    const int64_t ts = av_rescale_q(inMs, kMsTimeBase, primary->time_base);
+    if (av_seek_frame(in, primaryStream, ts, AVSEEK_FLAG_BACKWARD) >= 0) return true;
+    // Unseekable input: read from the start and let the range filter skip ahead.
+    return av_seek_frame(in, primaryStream, 0, AVSEEK_FLAG_BACKWARD) >= 0 || !in->pb;
+}
+
+ClipExportResult ClipExporter::exportNow() {
+    ClipExportResult result;
+    const ReplayEntry& entry = m_request.entry;
+    const std::optional<ClipExportContainer> container = containerForPath(m_request.outputPath);
+    if (!container.has_value())
+        return failed(result, QStringLiteral("unsupported export container: %1")
+                                  .arg(m_request.outputPath));
+    if (entry.clipPath.isEmpty() || entry.inMs < 0 ||
+        (entry.outMs >= 0 && entry.outMs <= entry.inMs)) {
+        return failed(result, QStringLiteral("invalid clip range"));
+    }
+
+    // ── Input ────────────────────────────────────────────────────────────────
+    const QByteArray inPath = entry.clipPath.toUtf8();
+    AVFormatContext* in = avformat_alloc_context();
+    if (!in) return failed(result, QStringLiteral("out of memory"));
+    in->interrupt_callback.callback = &ClipExporter::interruptCallback;
+    in->interrupt_callback.opaque = this;
+    if (avformat_open_input(&in, inPath.constData(), nullptr, nullptr) < 0) {
+        return failed(result, QStringLiteral("cannot open %1").arg(entry.clipPath));
+    }
+    const auto closeInput = qScopeGuard([&in] { avformat_close_input(&in); });
+    if (avformat_find_stream_info(in, nullptr) < 0)
+        return failed(result, QStringLiteral("cannot read stream info"));
+
+    // Views are numbered by video-stream order, as PlaybackWorker maps feeds; the
+    // Muxer writes one audio and one metadata track per view in the same order.
+    std::vector<TrackPlan> plan(in->nb_streams);
+    int videoOrdinal = 0;
+    int audioOrdinal = 0;
+    int metadataOrdinal = 0;
+    const auto wantsView = [this](int view) {
+        return m_request.views.isEmpty() || m_request.views.contains(view);
+    };
+    for (unsigned int i = 0; i < in->nb_streams; ++i) {
+        const AVStream* stream = in->streams[i];
+        TrackPlan& track = plan[i];
+        switch (stream->codecpar->codec_type) {
+        case AVMEDIA_TYPE_VIDEO:
+            track.view = videoOrdinal++;
+            if (wantsView(track.view)) track.kind = TrackKind::Video;
+            break;
+        case AVMEDIA_TYPE_AUDIO:
+            track.view = audioOrdinal++;
+            if (m_request.includeAudio && wantsView(track.view)) track.kind = TrackKind::Audio;
+            break;
+        case AVMEDIA_TYPE_SUBTITLE:
+            if (isTelemetryTrack(stream)) {
+                if (m_request.includeMetadata) track.kind = TrackKind::Telemetry;
+            } else {
+                track.view = metadataOrdinal++;
+                if (m_request.includeMetadata && wantsView(track.view))
+                    track.kind = TrackKind::Metadata;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    // ── Output ───────────────────────────────────────────────────────────────
+    const QByteArray outPath = m_request.outputPath.toUtf8();
+    AVFormatContext* out = nullptr;
+    if (avformat_alloc_output_context2(&out, nullptr, muxerName(container.value()),
+                                       outPath.constData()) < 0 || !out) {
+        return failed(result, QStringLiteral("cannot create %1").arg(m_request.outputPath));
+    }
+    bool outOpened = false;
+    bool keepOutput = false;
+    const auto closeOutput = qScopeGuard([&] {
+        if (outOpened) avio_closep(&out->pb);
+        avformat_free_context(out);
+        if (!keepOutput) QFile::remove(m_request.outputPath);
+    });
+
+    int primaryStream = -1;
+    std::vector<bool> videoDone(in->nb_streams, true);
+    for (unsigned int i = 0; i < in->nb_streams; ++i) {
+        TrackPlan& track = plan[i];
+        if (track.kind == TrackKind::Skip) continue;
+        const AVStream* src = in->streams[i];
+        if (!containerCarries(container.value(), out->oformat, src->codecpar->codec_id)) {
+            result.skippedTracks << trackLabel(src);
+            track.kind = TrackKind::Skip;
+            continue;
+        }
+        AVStream* dst = avformat_new_stream(out, nullptr);
+        if (!dst || avcodec_parameters_copy(dst->codecpar, src->codecpar) < 0)
+            return failed(result, QStringLiteral("cannot add output track"));
+        dst->codecpar->codec_tag = 0;
+        dst->time_base = kMsTimeBase;
+        dst->avg_frame_rate = src->avg_frame_rate;
+        dst->r_frame_rate = src->r_frame_rate;
+        av_dict_copy(&dst->metadata, src->metadata, 0);
+        // The recording's start timecode does not describe the clip.
+        av_dict_set(&dst->metadata, "timecode", nullptr, 0);
+        track.outIndex = dst->index;
+        if (track.kind == TrackKind::Video) {
+            videoDone[i] = false;
+            if (primaryStream < 0) primaryStream = int(i);
+        }
+    }
+    if (primaryStream < 0) return failed(result, QStringLiteral("no video track selected"));
+
+    av_dict_copy(&out->metadata, in->metadata, 0);
+    av_dict_set(&out->metadata, "timecode", nullptr, 0);
+    av_dict_set(&out->metadata, "olr_clip_source", inPath.constData(), 0);
+    av_dict_set_int(&out->metadata, "olr_clip_in_ms", entry.inMs, 0);
+    if (entry.outMs >= 0) av_dict_set_int(&out->metadata, "olr_clip_out_ms", entry.outMs, 0);
+
+    if (!(out->oformat->flags & AVFMT_NOFILE)) {
+        if (avio_open(&out->pb, outPath.constData(), AVIO_FLAG_WRITE) < 0)
+            return failed(result, QStringLiteral("cannot write %1").arg(m_request.outputPath));
+        outOpened = true;
+    }
+    // Audio that overlaps the in-point rebases below zero; shift every track together.
+    out->avoid_negative_ts = AVFMT_AVOID_NEG_TS_MAKE_NON_NEGATIVE;
+    if (avformat_write_header(out, nullptr) < 0)
+        return failed(result, QStringLiteral("cannot write the container header"));
+
+    // ── Copy the range ───────────────────────────────────────────────────────
+    if (!seekToIn(in, primaryStream, entry.inMs))
+        return failed(result, QStringLiteral("cannot seek to %1 ms").arg(entry.inMs));
+
+    qint64 endMs = entry.outMs;
+    if (endMs < 0 && in->duration != AV_NOPTS_VALUE)
+        endMs = av_rescale_q(in->duration, AVRational{1, AV_TIME_BASE}, kMsTimeBase);
+    const qint64 spanMs = endMs > entry.inMs ? endMs - entry.inMs : 0;
+    int lastPercent = -1;
+
+    AVPacket* pkt = av_packet_alloc();
+    if (!pkt) return failed(result, QStringLiteral("out of memory"));
+    const auto freePacket = qScopeGuard([&pkt] { av_packet_free(&pkt); });
+    int readError = 0;
+    while (!isInterruptionRequested()) {
+        readError = av_read_frame(in, pkt);
+        if (readError < 0) break;
+        const int s = pkt->stream_index;
+        const AVStream* src = in->streams[s];
+        const qint64 ptsMs = packetPtsMs(pkt, src);
+        const TrackPlan& track = plan[size_t(s)];
+        if (entry.outMs >= 0 && ptsMs != INT64_MIN && ptsMs > entry.outMs + kInterleaveSlackMs) {
+            av_packet_unref(pkt);
+            break;
+        }
+        if (track.kind == TrackKind::Skip || ptsMs == INT64_MIN) {
+            av_packet_unref(pkt);
+            continue;
+        }
+        if (ptsMs < entry.inMs) {
+            // An audio packet that starts just before the in-point still carries the
+            // clip's first samples; keep it and let the muxer shift the negative start.
+            const qint64 endPtsMs =
+                ptsMs + av_rescale_q(pkt->duration, src->time_base, kMsTimeBase);
+            if (track.kind != TrackKind::Audio || pkt->duration <= 0 || endPtsMs <= entry.inMs) {
+                av_packet_unref(pkt);
+                continue;
+            }
+        }
+        if (entry.outMs >= 0 && ptsMs >= entry.outMs) {
+            av_packet_unref(pkt);
+            if (track.kind == TrackKind::Video) {
+                videoDone[size_t(s)] = true;
+                if (std::all_of(videoDone.begin(), videoDone.end(), [](bool d) { return d; }))
+                    break;
+            }
+            continue;
+        }
+
+        if (track.kind == TrackKind::Video) {
+            if (result.firstPtsMs < 0) result.firstPtsMs = ptsMs;
+            result.lastPtsMs = qMax(result.lastPtsMs, ptsMs);
+        }
+        const int64_t rebase = av_rescale_q(entry.inMs, kMsTimeBase, src->time_base);
+        if (pkt->pts != AV_NOPTS_VALUE) pkt->pts -= rebase;
+        if (pkt->dts != AV_NOPTS_VALUE) pkt->dts -= rebase;
+        AVStream* dst = out->streams[track.outIndex];
+        av_packet_rescale_ts(pkt, src->time_base, dst->time_base);
+        pkt->stream_index = track.outIndex;
+        pkt->pos = -1;
+        const int size = pkt->size;
+        if (av_interleaved_write_frame(out, pkt) < 0) {
+            av_packet_unref(pkt);
+            return failed(result, QStringLiteral("write failed at %1 ms").arg(ptsMs));
+        }
+        result.packetsWritten++;
+        result.bytesWritten += size;
+
+        if (s == primaryStream && spanMs > 0) {
+            const int percent = int(qBound<qint64>(0, (ptsMs - entry.inMs) * 100 / spanMs, 100));
+            if (percent != lastPercent) {
+                lastPercent = percent;
+                emit progress(percent / 100.0);
+            }
+        }
+    }
+    if (isInterruptionRequested()) return failed(result, QStringLiteral("cancelled"));
+    if (readError < 0 && readError != AVERROR_EOF)
+        return failed(result, QStringLiteral("read failed"));
+    if (result.firstPtsMs < 0) return failed(result, QStringLiteral("range holds no video"));
+
+    if (av_write_trailer(out) < 0)
+        return failed(result, QStringLiteral("cannot finalize %1").arg(m_request.outputPath));
+    if (lastPercent < 100) emit progress(1.0);
+    keepOutput = true;
+    result.ok = true;
+    return result;
+}
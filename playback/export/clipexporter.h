@@ -0,0 +1,80 @@
+#ifndef CLIPEXPORTER_H
+#define CLIPEXPORTER_H
+
+#include "playback/frameindex.h"
+#include "playback/replayplaylist.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+#include <optional>
+
+struct AVFormatContext;
+
+enum class ClipExportContainer { Matroska, QuickTime, MpegTs };
+
+struct ClipExportRequest {
+    ReplayEntry entry;  // clip, in/out (outMs < 0 = to the end of the file); speed is ignored
+    QString outputPath; // container chosen from the suffix: .mkv, .mov, .ts
+    QList<int> views;   // recorded views (video-track order) to keep; empty = every view
+    bool includeAudio = true;
+    bool includeMetadata = true; // per-view metadata and feed telemetry text tracks
+};
+
+struct ClipExportResult {
+    bool ok = false;
+    QString error;
+    qint64 packetsWritten = 0;
+    qint64 bytesWritten = 0;
+    qint64 firstPtsMs = -1; // source PTS of the first exported video packet
+    qint64 lastPtsMs = -1;  // source PTS of the last exported video packet
+    // Selected input streams the target container cannot carry without a re-encode
+    // (e.g. PCM audio in MPEG-TS, text tracks in MOV); they are left out.
+    QStringList skippedTracks;
+};
+
+// Stream-copy export of a marked range. Recordings are ALL-INTRA, so the packet range
+// [inMs, outMs) of every selected track remuxes into a standalone file with no decode or
+// re-encode: the result is bit-identical to the recording and costs only I/O. Timestamps
+// are rebased so the clip starts at 0. The start is found through the FrameIndex offset
+// when one is supplied (validated against the landed PTS, like PlaybackWorker's exact
+// seek), otherwise through the container's own seek.
+//
+// Run it on its own thread with start(); progress() and exportFinished() are emitted from
+// that thread. exportNow() does the same work synchronously on the caller's thread.
+class ClipExporter : public QThread {
+    Q_OBJECT
+public:
+    explicit ClipExporter(const ClipExportRequest& request, QObject* parent = nullptr);
+    ~ClipExporter() override;
+
+    static std::optional<ClipExportContainer> containerForPath(const QString& path);
+    static const char* muxerName(ClipExportContainer container);
+    // Primary-video byte offsets the caller already holds (PlaybackWorker builds one
+    // while reading); optional.
+    void setFrameIndex(const FrameIndex& index) { m_frameIndex = index; }
+
+    ClipExportResult exportNow();
+    ClipExportResult result() const { return m_result; }
+    void cancel() { requestInterruption(); }
+
+signals:
+    // Fraction of the range written, 0..1; throttled to whole percents.
+    void progress(double fraction);
+    void exportFinished(bool ok, const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    static int interruptCallback(void* opaque);
+    bool seekToIn(AVFormatContext* in, int primaryStream, qint64 inMs);
+
+    ClipExportRequest m_request;
+    std::optional<FrameIndex> m_frameIndex;
+    ClipExportResult m_result;
+};
+
+#endif // CLIPEXPORTER_H
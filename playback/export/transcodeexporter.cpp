@@ -0,0 +1,833 @@
+#include "playback/export/transcodeexporter.h"
+
+#include "playback/output/framehandle.h"
+#include "playback/output/yuv420pcompositor.h"
+#include "recorder_engine/codec/avcc.h"
+#include "recorder_engine/codec/nativevideoencoder.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QScopeGuard>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libavutil/dict.h>
+    #include <libavutil/mathematics.h>
+    #include <libswscale/swscale.h>
+}
+
+namespace {
+constexpr AVRational kMsTimeBase{1, 1000};
+// Recordings interleave all tracks by time: once any packet is this far past a segment's
+// end, no selected packet inside the segment can still follow.
+constexpr qint64 kInterleaveSlackMs = 2000;
+// Workers may run this many segments per worker ahead of the writer.
+constexpr int kSegmentsAheadPerWorker = 2;
+
+struct AvCodecContextDeleter {
+    void operator()(AVCodecContext* ctx) const { avcodec_free_context(&ctx); }
+};
+struct AvPacketDeleter {
+    void operator()(AVPacket* pkt) const { av_packet_free(&pkt); }
+};
+struct AvFrameDeleter {
+    void operator()(AVFrame* frm) const { av_frame_free(&frm); }
+};
+using AvCodecContextPtr = std::unique_ptr<AVCodecContext, AvCodecContextDeleter>;
+using AvPacketPtr = std::unique_ptr<AVPacket, AvPacketDeleter>;
+using AvFramePtr = std::unique_ptr<AVFrame, AvFrameDeleter>;
+
+qint64 packetPtsMs(const AVPacket* pkt, const AVStream* stream) {
+    const int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+    if (ts == AV_NOPTS_VALUE) return INT64_MIN;
+    return av_rescale_q(ts, stream->time_base, kMsTimeBase);
+}
+
+QString trackLabel(const AVStream* stream) {
+    const AVDictionaryEntry* title = av_dict_get(stream->metadata, "title", nullptr, 0);
+    const QString name = title ? QString::fromUtf8(title->value)
+                               : QStringLiteral("stream %1").arg(stream->index);
+    const QString codec = QString::fromUtf8(avcodec_get_name(stream->codecpar->codec_id));
+    return QStringLiteral("%1 (%2)").arg(name, codec);
+}
+
+TranscodeExportResult failed(TranscodeExportResult result, const QString& error) {
+    result.ok = false;
+    result.error = error;
+    return result;
+}
+
+int stopCallback(void* opaque) {
+    const auto* stop = static_cast<const std::atomic<bool>*>(opaque);
+    return stop && stop->load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+// Views are numbered by video-stream order, as PlaybackWorker maps feeds; the Muxer
+// writes one audio track per view in the same order.
+void mapViewStreams(const AVFormatContext* in, std::vector<int>* video, std::vector<int>* audio) {
+    for (unsigned int i = 0; i < in->nb_streams; ++i) {
+        const AVMediaType type = in->streams[i]->codecpar->codec_type;
+        if (type == AVMEDIA_TYPE_VIDEO) video->push_back(int(i));
+        if (type == AVMEDIA_TYPE_AUDIO) audio->push_back(int(i));
+    }
+}
+
+// Repeats the avcC's SPS/PPS in-band, length-prefixed like the frame's own NALs, ahead of
+// the frame in `pkt`.
+bool prependParameterSets(AVPacket* pkt, const QByteArray& avcc) {
+    QList<QByteArray> sps;
+    QList<QByteArray> pps;
+    if (avcc.size() < 5 || !parseAvcc(avcc, &sps, &pps)) return false;
+    const int lengthSize = (uchar(avcc.at(4)) & 0x03) + 1;
+    QByteArray prefix;
+    for (const QByteArray& nal : sps + pps) {
+        for (int shift = 8 * (lengthSize - 1); shift >= 0; shift -= 8)
+            prefix.append(char((nal.size() >> shift) & 0xff));
+        prefix.append(nal);
+    }
+    AvPacketPtr merged(av_packet_alloc());
+    if (!merged || av_new_packet(merged.get(), int(prefix.size()) + pkt->size) < 0) return false;
+    memcpy(merged->data, prefix.constData(), size_t(prefix.size()));
+    memcpy(merged->data + prefix.size(), pkt->data, size_t(pkt->size));
+    av_packet_copy_props(merged.get(), pkt);
+    av_packet_unref(pkt);
+    av_packet_move_ref(pkt, merged.get());
+    return true;
+}
+
+// Converts decoded pictures to YUV 4:2:0 at the encode size.
+class Yuv420pConverter {
+public:
+    Yuv420pConverter() = default;
+    ~Yuv420pConverter() { sws_freeContext(m_sws); }
+    Yuv420pConverter(const Yuv420pConverter&) = delete;
+    Yuv420pConverter& operator=(const Yuv420pConverter&) = delete;
+
+    // Returns `frame` itself when it already is YUV 4:2:0 at width x height, otherwise a
+    // converted copy owned by the converter and valid until the next call.
+    AVFrame* convert(AVFrame* frame, int width, int height) {
+        if (frame->format == AV_PIX_FMT_YUV420P && frame->width == width &&
+            frame->height == height) {
+            return frame;
+        }
+        m_sws = sws_getCachedContext(m_sws, frame->width, frame->height,
+                                     AVPixelFormat(frame->format), width, height,
+                                     AV_PIX_FMT_YUV420P, SWS_BILINEAR, nullptr, nullptr,
+                                     nullptr);
+        if (!m_sws) return nullptr;
+        if (!m_out || m_out->width != width || m_out->height != height) {
+            m_out.reset(av_frame_alloc());
+            if (!m_out) return nullptr;
+            m_out->format = AV_PIX_FMT_YUV420P;
+            m_out->width = width;
+            m_out->height = height;
+            if (av_frame_get_buffer(m_out.get(), 0) < 0) return nullptr;
+        }
+        // The encoder may still reference the previous picture.
+        if (av_frame_make_writable(m_out.get()) < 0) return nullptr;
+        sws_scale(m_sws, frame->data, frame->linesize, 0, frame->height, m_out->data,
+                  m_out->linesize);
+        return m_out.get();
+    }
+
+private:
+    SwsContext* m_sws = nullptr;
+    AvFramePtr m_out;
+};
+
+FrameHandle copyToFrameHandle(const AVFrame* frame, qint64 ptsMs) {
+    CpuPlanes planes;
+    planes.format = FramePixelFormat::Yuv420p;
+    planes.width = frame->width;
+    planes.height = frame->height;
+    planes.stride[0] = frame->width;
+    planes.stride[1] = (frame->width + 1) / 2;
+    planes.stride[2] = (frame->width + 1) / 2;
+    for (int i = 0; i < 3; ++i) {
+        const int rows = i == 0 ? frame->height : (frame->height + 1) / 2;
+        planes.plane[i] = QByteArray(qsizetype(planes.stride[i]) * rows, Qt::Uninitialized);
+        for (int y = 0; y < rows; ++y) {
+            memcpy(planes.plane[i].data() + qsizetype(y) * planes.stride[i],
+                   frame->data[i] + qsizetype(y) * frame->linesize[i], size_t(planes.stride[i]));
+        }
+    }
+    FrameMetadata meta;
+    meta.key.ptsMs = ptsMs;
+    meta.key.format = FramePixelFormat::Yuv420p;
+    meta.key.width = frame->width;
+    meta.key.height = frame->height;
+    for (int i = 0; i < 3; ++i) meta.stride[i] = planes.stride[i];
+    return makeCpuFrameHandle(std::move(planes), meta);
+}
+
+// One intra-only encoder session per segment: hardware H.264 or software MPEG-2, set up
+// as IsoRecorderOutputSink sets them up. Packets come out in source milliseconds.
+class SegmentEncoder {
+public:
+    bool open(VideoCodecChoice codec, int width, int height, AVRational rate, int bitrate,
+              QString* error) {
+        if (codec == VideoCodecChoice::H264Hardware) {
+            NativeVideoEncoder::Config config;
+            config.width = width;
+            config.height = height;
+            config.fpsNum = rate.num;
+            config.fpsDen = rate.den;
+            config.bitrate = bitrate;
+            m_native = NativeVideoEncoder::create(config, error);
+            return m_native != nullptr;
+        }
+        const AVCodec* encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+        m_context.reset(encoder ? avcodec_alloc_context3(encoder) : nullptr);
+        if (!m_context) {
+            if (error) *error = QStringLiteral("MPEG-2 encoder not available");
+            return false;
+        }
+        m_context->width = width;
+        m_context->height = height;
+        m_context->pix_fmt = AV_PIX_FMT_YUV420P;
+        m_context->time_base = av_inv_q(rate);
+        m_context->framerate = rate;
+        m_context->gop_size = 1;
+        m_context->max_b_frames = 0;
+        m_context->bit_rate = bitrate;
+        // Parallelism is across segments; a codec thread pool per worker would oversubscribe.
+        m_context->thread_count = 1;
+        if (avcodec_open2(m_context.get(), encoder, nullptr) < 0) {
+            if (error) *error = QStringLiteral("cannot open the MPEG-2 encoder");
+            return false;
+        }
+        return true;
+    }
+
+    bool encode(AVFrame* frame, qint64 ptsMs, std::vector<AvPacketPtr>* out, QString* error) {
+        if (m_native) {
+            QString encodeError;
+            const bool encoded = m_native->encode(frame, ptsMs, collector(out), &encodeError);
+            if (!encoded && error) *error = QStringLiteral("H.264 encode: %1").arg(encodeError);
+            return encoded;
+        }
+        frame->pts = m_frameCount++;
+        m_ptsMs.push_back(ptsMs);
+        if (avcodec_send_frame(m_context.get(), frame) < 0) {
+            if (error) *error = QStringLiteral("MPEG-2 encode failed");
+            return false;
+        }
+        return drain(out, error);
+    }
+
+    bool flush(std::vector<AvPacketPtr>* out, QString* error) {
+        if (m_native) {
+            QString flushError;
+            const bool flushed = m_native->flush(collector(out), &flushError);
+            if (!flushed && error) *error = QStringLiteral("H.264 flush: %1").arg(flushError);
+            return flushed;
+        }
+        if (avcodec_send_frame(m_context.get(), nullptr) < 0) {
+            if (error) *error = QStringLiteral("MPEG-2 flush failed");
+            return false;
+        }
+        return drain(out, error);
+    }
+
+    QByteArray avccExtradata() const { return m_native ? m_native->avccExtradata() : QByteArray(); }
+
+private:
+    static NativeVideoEncoder::PacketCallback collector(std::vector<AvPacketPtr>* out) {
+        return [out](const QByteArray& data, int64_t ptsTicks, bool keyframe) {
+            AvPacketPtr packet(av_packet_alloc());
+            if (!packet || av_new_packet(packet.get(), int(data.size())) < 0) return;
+            memcpy(packet->data, data.constData(), size_t(data.size()));
+            packet->pts = packet->dts = ptsTicks;
+            if (keyframe) packet->flags |= AV_PKT_FLAG_KEY;
+            out->push_back(std::move(packet));
+        };
+    }
+
+    bool drain(std::vector<AvPacketPtr>* out, QString* error) {
+        while (true) {
+            AvPacketPtr packet(av_packet_alloc());
+            if (!packet) {
+                if (error) *error = QStringLiteral("out of memory allocating a packet");
+                return false;
+            }
+            const int ret = avcodec_receive_packet(m_context.get(), packet.get());
+            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+            if (ret < 0) {
+                if (error) *error = QStringLiteral("MPEG-2 encoder output failed");
+                return false;
+            }
+            // Intra-only without B-frames: packets leave in submission order.
+            if (!m_ptsMs.empty()) {
+                packet->pts = packet->dts = m_ptsMs.front();
+                m_ptsMs.pop_front();
+            }
+            out->push_back(std::move(packet));
+        }
+    }
+
+    std::unique_ptr<NativeVideoEncoder> m_native;
+    AvCodecContextPtr m_context;
+    std::deque<qint64> m_ptsMs; // source PTS of frames submitted and not yet packetized
+    int64_t m_frameCount = 0;
+};
+
+struct SegmentJob {
+    QByteArray path;
+    std::vector<int> viewStreams; // selected views' video streams, composite order
+    VideoCodecChoice codec = VideoCodecChoice::Mpeg2Software;
+    int width = 0;
+    int height = 0;
+    int bitrate = 0;
+    AVRational frameRate{0, 1};
+    std::atomic<bool>* stop = nullptr;
+};
+
+struct EncodedSegment {
+    std::vector<AvPacketPtr> packets; // PTS/DTS in source milliseconds
+    QByteArray avcc;
+    QString error;
+    bool done = false;
+};
+
+// Decode -> (composite) -> encode of one segment on its own demuxer.
+class SegmentTranscoder {
+public:
+    SegmentTranscoder(const SegmentJob& job, const TranscodeSegment& segment,
+                      EncodedSegment* out)
+        : m_job(job), m_segment(segment), m_out(out), m_pending(job.viewStreams.size()),
+          m_held(job.viewStreams.size()), m_converters(job.viewStreams.size()) {}
+
+    bool run() {
+        AVFormatContext* in = avformat_alloc_context();
+        if (!in) return fail(QStringLiteral("out of memory"));
+        in->interrupt_callback.callback = &stopCallback;
+        in->interrupt_callback.opaque = m_job.stop;
+        if (avformat_open_input(&in, m_job.path.constData(), nullptr, nullptr) < 0)
+            return fail(QStringLiteral("cannot open %1").arg(QString::fromUtf8(m_job.path)));
+        const auto closeInput = qScopeGuard([&in] { avformat_close_input(&in); });
+        // The recording's headers carry every codec parameter needed here; the exporter
+        // already probed the stream info once, so workers skip that decode pass.
+
+        std::vector<int> viewOf(in->nb_streams, -1);
+        for (size_t v = 0; v < m_job.viewStreams.size(); ++v)
+            viewOf[size_t(m_job.viewStreams[v])] = int(v);
+        for (unsigned int i = 0; i < in->nb_streams; ++i)
+            if (viewOf[i] < 0) in->streams[i]->discard = AVDISCARD_ALL;
+
+        for (const int s : m_job.viewStreams) {
+            const AVStream* stream = in->streams[s];
+            const AVCodec* decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+            AvCodecContextPtr ctx(decoder ? avcodec_alloc_context3(decoder) : nullptr);
+            if (!ctx || avcodec_parameters_to_context(ctx.get(), stream->codecpar) < 0)
+                return fail(QStringLiteral("no decoder for %1").arg(trackLabel(stream)));
+            ctx->pkt_timebase = stream->time_base;
+            ctx->thread_count = 1;
+            if (avcodec_open2(ctx.get(), decoder, nullptr) < 0) {
+                return fail(
+                    QStringLiteral("cannot open the decoder for %1").arg(trackLabel(stream)));
+            }
+            m_decoders.push_back(std::move(ctx));
+        }
+        QString error;
+        if (!m_encoder.open(m_job.codec, m_job.width, m_job.height, m_job.frameRate,
+                            m_job.bitrate, &error)) {
+            return fail(error);
+        }
+
+        const int primary = m_job.viewStreams.front();
+        const int64_t ts = av_rescale_q(m_segment.startMs, kMsTimeBase,
+                                        in->streams[primary]->time_base);
+        if (av_seek_frame(in, primary, ts, AVSEEK_FLAG_BACKWARD) < 0)
+            av_seek_frame(in, primary, 0, AVSEEK_FLAG_BACKWARD);
+
+        AvPacketPtr pkt(av_packet_alloc());
+        AvFramePtr frame(av_frame_alloc());
+        if (!pkt || !frame) return fail(QStringLiteral("out of memory"));
+        std::vector<bool> viewDone(m_job.viewStreams.size(), false);
+        int readError = 0;
+        while (!m_job.stop->load(std::memory_order_relaxed)) {
+            readError = av_read_frame(in, pkt.get());
+            if (readError < 0) break;
+            const int view = viewOf[size_t(pkt->stream_index)];
+            const qint64 ptsMs = packetPtsMs(pkt.get(), in->streams[pkt->stream_index]);
+            if (ptsMs != INT64_MIN && ptsMs > m_segment.endMs + kInterleaveSlackMs) {
+                av_packet_unref(pkt.get());
+                break;
+            }
+            // All-intra: packets before the segment need no decoding at all.
+            if (view < 0 || ptsMs == INT64_MIN || ptsMs < m_segment.startMs) {
+                av_packet_unref(pkt.get());
+                continue;
+            }
+            if (ptsMs >= m_segment.endMs) {
+                av_packet_unref(pkt.get());
+                viewDone[size_t(view)] = true;
+                if (std::all_of(viewDone.begin(), viewDone.end(), [](bool d) { return d; }))
+                    break;
+                continue;
+            }
+            const int sent = avcodec_send_packet(m_decoders[size_t(view)].get(), pkt.get());
+            av_packet_unref(pkt.get());
+            if (sent < 0) return fail(QStringLiteral("decode failed at %1 ms").arg(ptsMs));
+            if (!receiveFrames(view, in->streams[m_job.viewStreams[size_t(view)]], frame.get()))
+                return false;
+        }
+        if (m_job.stop->load(std::memory_order_relaxed)) return fail(QStringLiteral("cancelled"));
+        if (readError < 0 && readError != AVERROR_EOF)
+            return fail(QStringLiteral("read failed"));
+
+        for (size_t v = 0; v < m_decoders.size(); ++v) {
+            avcodec_send_packet(m_decoders[v].get(), nullptr);
+            if (!receiveFrames(int(v), in->streams[m_job.viewStreams[v]], frame.get()))
+                return false;
+        }
+        if (!composeReady(true)) return false;
+        if (!m_encoder.flush(&m_out->packets, &error)) return fail(error);
+        m_out->avcc = m_encoder.avccExtradata();
+        return true;
+    }
+
+private:
+    bool fail(const QString& error) {
+        m_out->error = error;
+        return false;
+    }
+
+    bool receiveFrames(int view, const AVStream* stream, AVFrame* frame) {
+        AVCodecContext* decoder = m_decoders[size_t(view)].get();
+        while (avcodec_receive_frame(decoder, frame) == 0) {
+            const int64_t ts = frame->best_effort_timestamp != AV_NOPTS_VALUE
+                                   ? frame->best_effort_timestamp
+                                   : frame->pts;
+            const qint64 ptsMs = ts == AV_NOPTS_VALUE
+                                     ? INT64_MIN
+                                     : av_rescale_q(ts, stream->time_base, kMsTimeBase);
+            const bool inRange = ptsMs >= m_segment.startMs && ptsMs < m_segment.endMs;
+            const bool ok = !inRange || handleFrame(view, frame, ptsMs);
+            av_frame_unref(frame);
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    bool handleFrame(int view, AVFrame* frame, qint64 ptsMs) {
+        QString error;
+        Yuv420pConverter& converter = m_converters[size_t(view)];
+        if (m_job.viewStreams.size() == 1) {
+            AVFrame* picture = converter.convert(frame, m_job.width, m_job.height);
+            if (!picture) return fail(QStringLiteral("cannot convert the decoded picture"));
+            if (!m_encoder.encode(picture, ptsMs, &m_out->packets, &error)) return fail(error);
+            return true;
+        }
+        // PGM composite: tiles keep their own size here; the compositor scales them.
+        AVFrame* picture = converter.convert(frame, frame->width & ~1, frame->height & ~1);
+        if (!picture) return fail(QStringLiteral("cannot convert the decoded picture"));
+        m_pending[size_t(view)].push_back(copyToFrameHandle(picture, ptsMs));
+        return composeReady(false);
+    }
+
+    // Composites every primary-view frame whose partners have arrived (or, at the end of
+    // input, never will). Each tile shows its latest frame at or before the primary PTS.
+    bool composeReady(bool endOfInput) {
+        if (m_job.viewStreams.size() == 1) return true;
+        while (!m_pending[0].empty()) {
+            const qint64 t = m_pending[0].front().metadata().key.ptsMs;
+            for (size_t v = 1; v < m_pending.size() && !endOfInput; ++v) {
+                if (m_pending[v].empty() || m_pending[v].back().metadata().key.ptsMs < t)
+                    return true;
+            }
+            QList<FrameHandle> tiles{m_pending[0].front()};
+            for (size_t v = 1; v < m_pending.size(); ++v) {
+                while (!m_pending[v].empty() && m_pending[v].front().metadata().key.ptsMs <= t) {
+                    m_held[v] = m_pending[v].front();
+                    m_pending[v].pop_front();
+                }
+                tiles << m_held[v];
+            }
+            m_pending[0].pop_front();
+
+            const FrameHandle pgm = Yuv420pCompositor::composeGrid(tiles, m_job.width,
+                                                                   m_job.height);
+            const MediaVideoFrameView video(pgm);
+            if (!video.isValid()) return fail(QStringLiteral("composite failed at %1 ms").arg(t));
+            // Borrowed planes: FFmpeg copies non-refcounted input before an encoder keeps it.
+            const auto borrow = [](const QByteArray& plane) {
+                return reinterpret_cast<uint8_t*>(const_cast<char*>(plane.constData()));
+            };
+            AvFramePtr picture(av_frame_alloc());
+            if (!picture) return fail(QStringLiteral("out of memory"));
+            picture->format = AV_PIX_FMT_YUV420P;
+            picture->width = video.width;
+            picture->height = video.height;
+            picture->data[0] = borrow(video.planeY);
+            picture->data[1] = borrow(video.planeU);
+            picture->data[2] = borrow(video.planeV);
+            picture->linesize[0] = video.strideY;
+            picture->linesize[1] = video.strideU;
+            picture->linesize[2] = video.strideV;
+            QString error;
+            if (!m_encoder.encode(picture.get(), t, &m_out->packets, &error)) return fail(error);
+        }
+        return true;
+    }
+
+    const SegmentJob& m_job;
+    const TranscodeSegment m_segment;
+    EncodedSegment* m_out;
+    std::vector<AvCodecContextPtr> m_decoders;
+    SegmentEncoder m_encoder;
+    std::vector<std::deque<FrameHandle>> m_pending; // composite: decoded, not yet used
+    std::vector<FrameHandle> m_held;                // composite: last tile per view
+    std::vector<Yuv420pConverter> m_converters;
+};
+} // namespace
+
+TranscodeExporter::TranscodeExporter(const TranscodeExportRequest& request, QObject* parent)
+    : QThread(parent), m_request(request) {}
+
+TranscodeExporter::~TranscodeExporter() {
+    requestInterruption();
+    wait();
+}
+
+QList<TranscodeSegment> TranscodeExporter::planSegments(qint64 inMs, qint64 outMs,
+                                                        qint64 segmentMs, int workers) {
+    QList<TranscodeSegment> segments;
+    const qint64 span = outMs - inMs;
+    if (span <= 0) return segments;
+    qint64 length = qMax(segmentMs, kMinSegmentMs);
+    if (workers > 1 && span / length < workers)
+        length = qMax(kMinSegmentMs, (span + workers - 1) / workers);
+    for (qint64 start = inMs; start < outMs; start += length) {
+        TranscodeSegment segment;
+        segment.index = int(segments.size());
+        segment.startMs = start;
+        segment.endMs = qMin(outMs, start + length);
+        segments << segment;
+    }
+    return segments;
+}
+
+const char* TranscodeExporter::muxerForPath(const QString& path) {
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == QLatin1String("mp4") || suffix == QLatin1String("m4v")) return "mp4";
+    if (suffix == QLatin1String("mov")) return "mov";
+    if (suffix == QLatin1String("mkv")) return "matroska";
+    return nullptr;
+}
+
+int TranscodeExporter::interruptCallback(void* opaque) {
+    auto* exporter = static_cast<TranscodeExporter*>(opaque);
+    return exporter ? exporter->isInterruptionRequested() : 0;
+}
+
+void TranscodeExporter::run() {
+    m_result = exportNow();
+    emit exportFinished(m_result.ok, m_result.error);
+}
+
+TranscodeExportResult TranscodeExporter::exportNow() {
+    TranscodeExportResult result;
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const ReplayEntry& entry = m_request.entry;
+    const char* muxer = muxerForPath(m_request.outputPath);
+    if (!muxer) {
+        return failed(result, QStringLiteral("unsupported export container: %1")
+                                  .arg(m_request.outputPath));
+    }
+    if (entry.clipPath.isEmpty() || entry.inMs < 0 ||
+        (entry.outMs >= 0 && entry.outMs <= entry.inMs)) {
+        return failed(result, QStringLiteral("invalid clip range"));
+    }
+    if (m_request.codec == VideoCodecChoice::H264Hardware) {
+        const NativeVideoEncodeCapabilities caps = queryNativeVideoEncodeCapabilities();
+        if (!caps.h264) {
+            return failed(result, QStringLiteral("hardware H.264 encoder unavailable: %1")
+                                      .arg(caps.detail));
+        }
+    }
+
+    // ── Input ────────────────────────────────────────────────────────────────
+    // This context probes the layout and then carries the stream-copied audio.
+    const QByteArray inPath = entry.clipPath.toUtf8();
+    AVFormatContext* in = avformat_alloc_context();
+    if (!in) return failed(result, QStringLiteral("out of memory"));
+    in->interrupt_callback.callback = &TranscodeExporter::interruptCallback;
+    in->interrupt_callback.opaque = this;
+    if (avformat_open_input(&in, inPath.constData(), nullptr, nullptr) < 0)
+        return failed(result, QStringLiteral("cannot open %1").arg(entry.clipPath));
+    const auto closeInput = qScopeGuard([&in] { avformat_close_input(&in); });
+    if (avformat_find_stream_info(in, nullptr) < 0)
+        return failed(result, QStringLiteral("cannot read stream info"));
+
+    std::vector<int> videoStreams;
+    std::vector<int> audioStreams;
+    mapViewStreams(in, &videoStreams, &audioStreams);
+    const QList<int> views = m_request.views.isEmpty() ? QList<int>{0} : m_request.views;
+    SegmentJob job;
+    job.path = inPath;
+    for (const int view : views) {
+        if (view < 0 || view >= int(videoStreams.size()))
+            return failed(result, QStringLiteral("no recorded view %1").arg(view));
+        job.viewStreams.push_back(videoStreams[size_t(view)]);
+    }
+    const AVStream* primary = in->streams[job.viewStreams.front()];
+    job.codec = m_request.codec;
+    job.bitrate = m_request.bitrate;
+    job.width = (m_request.width > 0 ? m_request.width : primary->codecpar->width) & ~1;
+    job.height = (m_request.height > 0 ? m_request.height : primary->codecpar->height) & ~1;
+    job.frameRate = primary->avg_frame_rate.num > 0 ? primary->avg_frame_rate
+                                                    : primary->r_frame_rate;
+    if (job.width <= 0 || job.height <= 0)
+        return failed(result, QStringLiteral("unknown video size"));
+    if (job.frameRate.num <= 0 || job.frameRate.den <= 0)
+        return failed(result, QStringLiteral("unknown frame rate"));
+
+    qint64 endMs = entry.outMs;
+    if (endMs < 0 && in->duration != AV_NOPTS_VALUE)
+        endMs = av_rescale_q(in->duration, AVRational{1, AV_TIME_BASE}, kMsTimeBase);
+    const int workers = qMax(1, m_request.workers > 0 ? m_request.workers
+                                                      : QThread::idealThreadCount());
+    const QList<TranscodeSegment> segments =
+        planSegments(entry.inMs, endMs, m_request.segmentMs, workers);
+    if (segments.isEmpty()) return failed(result, QStringLiteral("range holds no video"));
+    result.segments = int(segments.size());
+    result.workers = qMin(workers, result.segments);
+
+    // ── Output ───────────────────────────────────────────────────────────────
+    const QByteArray outPath = m_request.outputPath.toUtf8();
+    AVFormatContext* out = nullptr;
+    if (avformat_alloc_output_context2(&out, nullptr, muxer, outPath.constData()) < 0 || !out)
+        return failed(result, QStringLiteral("cannot create %1").arg(m_request.outputPath));
+    bool outOpened = false;
+    bool keepOutput = false;
+    const auto closeOutput = qScopeGuard([&] {
+        if (outOpened) avio_closep(&out->pb);
+        avformat_free_context(out);
+        if (!keepOutput) QFile::remove(m_request.outputPath);
+    });
+
+    AVStream* video = avformat_new_stream(out, nullptr);
+    if (!video) return failed(result, QStringLiteral("cannot add output track"));
+    video->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+    video->codecpar->codec_id = job.codec == VideoCodecChoice::H264Hardware
+                                    ? AV_CODEC_ID_H264
+                                    : AV_CODEC_ID_MPEG2VIDEO;
+    video->codecpar->width = job.width;
+    video->codecpar->height = job.height;
+    video->codecpar->format = AV_PIX_FMT_YUV420P;
+    video->codecpar->bit_rate = job.bitrate;
+    video->time_base = kMsTimeBase;
+    video->avg_frame_rate = video->r_frame_rate = job.frameRate;
+    const int64_t frameDurationMs = qMax<int64_t>(1, av_rescale_q(1, av_inv_q(job.frameRate),
+                                                                  kMsTimeBase));
+
+    int audioIn = -1;
+    AVStream* audio = nullptr;
+    if (m_request.includeAudio && views.front() < int(audioStreams.size())) {
+        const AVStream* src = in->streams[audioStreams[size_t(views.front())]];
+        const AVCodecID codec = src->codecpar->codec_id;
+        if (avformat_query_codec(out->oformat, codec, FF_COMPLIANCE_NORMAL) == 1) {
+            audio = avformat_new_stream(out, nullptr);
+            if (!audio || avcodec_parameters_copy(audio->codecpar, src->codecpar) < 0)
+                return failed(result, QStringLiteral("cannot add output track"));
+            audio->codecpar->codec_tag = 0;
+            audio->time_base = src->time_base;
+            av_dict_copy(&audio->metadata, src->metadata, 0);
+            audioIn = src->index;
+        } else {
+            result.skippedTracks << trackLabel(src);
+        }
+    }
+    for (unsigned int i = 0; i < in->nb_streams; ++i)
+        if (int(i) != audioIn) in->streams[i]->discard = AVDISCARD_ALL;
+    if (audioIn >= 0) {
+        const int64_t ts = av_rescale_q(entry.inMs, kMsTimeBase, in->streams[audioIn]->time_base);
+        if (av_seek_frame(in, audioIn, ts, AVSEEK_FLAG_BACKWARD) < 0)
+            av_seek_frame(in, audioIn, 0, AVSEEK_FLAG_BACKWARD);
+    }
+
+    av_dict_set(&out->metadata, "olr_clip_source", inPath.constData(), 0);
+    av_dict_set_int(&out->metadata, "olr_clip_in_ms", entry.inMs, 0);
+    av_dict_set_int(&out->metadata, "olr_clip_out_ms", endMs, 0);
+
+    // ── Segment workers ──────────────────────────────────────────────────────
+    std::atomic<bool> stop{false};
+    job.stop = &stop;
+    std::vector<EncodedSegment> encoded(size_t(segments.size()));
+    std::mutex mutex;
+    std::condition_variable changed;
+    int nextSegment = 0;
+    int segmentsWritten = 0;
+    const int window = result.workers * kSegmentsAheadPerWorker;
+    const auto worker = [&] {
+        while (true) {
+            int index = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] {
+                    return stop.load() || nextSegment >= int(segments.size()) ||
+                           nextSegment < segmentsWritten + window;
+                });
+                if (stop.load() || nextSegment >= int(segments.size())) return;
+                index = nextSegment++;
+            }
+            EncodedSegment& slot = encoded[size_t(index)];
+            try {
+                SegmentTranscoder(job, segments.at(index), &slot).run();
+            } catch (...) {
+                slot.error = QStringLiteral("segment %1 failed").arg(index);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.done = true;
+            }
+            changed.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    pool.reserve(size_t(result.workers));
+    for (int i = 0; i < result.workers; ++i) pool.emplace_back(worker);
+    const auto joinPool = qScopeGuard([&] {
+        stop.store(true);
+        changed.notify_all();
+        for (std::thread& thread : pool) thread.join();
+    });
+
+    // ── Concatenate in order ─────────────────────────────────────────────────
+    AvPacketPtr audioPkt(av_packet_alloc());
+    if (!audioPkt) return failed(result, QStringLiteral("out of memory"));
+    bool audioHeld = false;
+    bool audioDone = audioIn < 0;
+    // Writes the copied audio up to `untilMs`, so the muxer interleaves by time.
+    const auto writeAudioUntil = [&](qint64 untilMs) {
+        const AVStream* src = in->streams[audioIn];
+        while (!audioDone) {
+            if (!audioHeld) {
+                if (av_read_frame(in, audioPkt.get()) < 0) {
+                    audioDone = true;
+                    break;
+                }
+                if (audioPkt->stream_index != audioIn) {
+                    av_packet_unref(audioPkt.get());
+                    continue;
+                }
+                audioHeld = true;
+            }
+            const qint64 ptsMs = packetPtsMs(audioPkt.get(), src);
+            if (ptsMs != INT64_MIN && ptsMs >= endMs) {
+                av_packet_unref(audioPkt.get());
+                audioHeld = false;
+                audioDone = true;
+                break;
+            }
+            if (ptsMs != INT64_MIN && ptsMs >= untilMs) break;
+            audioHeld = false;
+            if (ptsMs == INT64_MIN || ptsMs < entry.inMs) {
+                av_packet_unref(audioPkt.get());
+                continue;
+            }
+            const int64_t rebase = av_rescale_q(entry.inMs, kMsTimeBase, src->time_base);
+            if (audioPkt->pts != AV_NOPTS_VALUE) audioPkt->pts -= rebase;
+            if (audioPkt->dts != AV_NOPTS_VALUE) audioPkt->dts -= rebase;
+            av_packet_rescale_ts(audioPkt.get(), src->time_base, audio->time_base);
+            audioPkt->stream_index = audio->index;
+            audioPkt->pos = -1;
+            const int size = audioPkt->size;
+            if (av_interleaved_write_frame(out, audioPkt.get()) < 0) return false;
+            result.bytesWritten += size;
+        }
+        return true;
+    };
+
+    QByteArray avcc;
+    for (int index = 0; index < int(segments.size()); ++index) {
+        EncodedSegment& segment = encoded[size_t(index)];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!segment.done && !isInterruptionRequested())
+                changed.wait_for(lock, std::chrono::milliseconds(50));
+        }
+        if (isInterruptionRequested()) return failed(result, QStringLiteral("cancelled"));
+        if (!segment.error.isEmpty()) return failed(result, segment.error);
+
+        if (index == 0) {
+            if (job.codec == VideoCodecChoice::H264Hardware) {
+                avcc = segment.avcc;
+                if (avcc.isEmpty()) {
+                    return failed(result,
+                                  QStringLiteral("hardware H.264 encoder produced no avcC record"));
+                }
+                video->codecpar->extradata = static_cast<uint8_t*>(
+                    av_mallocz(size_t(avcc.size()) + AV_INPUT_BUFFER_PADDING_SIZE));
+                if (!video->codecpar->extradata)
+                    return failed(result, QStringLiteral("out of memory"));
+                memcpy(video->codecpar->extradata, avcc.constData(), size_t(avcc.size()));
+                video->codecpar->extradata_size = int(avcc.size());
+            }
+            if (!(out->oformat->flags & AVFMT_NOFILE)) {
+                if (avio_open(&out->pb, outPath.constData(), AVIO_FLAG_WRITE) < 0) {
+                    return failed(result,
+                                  QStringLiteral("cannot write %1").arg(m_request.outputPath));
+                }
+                outOpened = true;
+            }
+            if (avformat_write_header(out, nullptr) < 0)
+                return failed(result, QStringLiteral("cannot write the container header"));
+        }
+
+        const bool repeatParameterSets = !avcc.isEmpty() && segment.avcc != avcc;
+        for (size_t i = 0; i < segment.packets.size(); ++i) {
+            AVPacket* pkt = segment.packets[i].get();
+            const qint64 ptsMs = pkt->pts;
+            if (result.firstPtsMs < 0) result.firstPtsMs = ptsMs;
+            result.lastPtsMs = qMax(result.lastPtsMs, ptsMs);
+            if (i == 0 && repeatParameterSets && !prependParameterSets(pkt, segment.avcc))
+                return failed(result, QStringLiteral("cannot repeat the H.264 parameter sets"));
+            if (audioIn >= 0 && !writeAudioUntil(ptsMs))
+                return failed(result, QStringLiteral("audio write failed at %1 ms").arg(ptsMs));
+            pkt->pts = pkt->dts = av_rescale_q(ptsMs - entry.inMs, kMsTimeBase, video->time_base);
+            pkt->duration = av_rescale_q(frameDurationMs, kMsTimeBase, video->time_base);
+            pkt->stream_index = video->index;
+            pkt->flags |= AV_PKT_FLAG_KEY;
+            const int size = pkt->size;
+            if (av_interleaved_write_frame(out, pkt) < 0)
+                return failed(result, QStringLiteral("write failed at %1 ms").arg(ptsMs));
+            result.framesEncoded++;
+            result.bytesWritten += size;
+        }
+        if (audioIn >= 0 && !writeAudioUntil(segments.at(index).endMs))
+            return failed(result, QStringLiteral("audio write failed"));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            segment.packets.clear();
+            segmentsWritten = index + 1;
+        }
+        changed.notify_all();
+        emit progress(double(index + 1) / double(segments.size()));
+    }
+    if (result.framesEncoded == 0) return failed(result, QStringLiteral("range holds no video"));
+
+    if (av_write_trailer(out) < 0)
+        return failed(result, QStringLiteral("cannot finalize %1").arg(m_request.outputPath));
+    keepOutput = true;
+    result.ok = true;
+    result.elapsedMs = elapsed.elapsed();
+    return result;
+}
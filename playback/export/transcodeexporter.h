@@ -0,0 +1,94 @@
+#ifndef TRANSCODEEXPORTER_H
+#define TRANSCODEEXPORTER_H
+
+#include "playback/replayplaylist.h"
+#include "recorder_engine/codec/videocodecchoice.h"
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+struct TranscodeExportRequest {
+    ReplayEntry entry;  // clip, in/out (outMs < 0 = to the end of the file); speed is ignored
+    QString outputPath; // container chosen from the suffix: .mp4, .mov, .mkv
+    // Recorded views (video-track order). One view is transcoded as is; several are
+    // composited into a PGM grid in this order (Yuv420pCompositor). Empty = view 0.
+    QList<int> views;
+    VideoCodecChoice codec = VideoCodecChoice::H264Hardware; // no software H.264 fallback
+    int bitrate = 30'000'000;
+    int width = 0; // output size; 0 = the first selected view's size
+    int height = 0;
+    bool includeAudio = true; // the first selected view's audio, stream-copied
+    int workers = 0;          // segment workers; 0 = QThread::idealThreadCount()
+    qint64 segmentMs = 2000;  // nominal segment length
+};
+
+struct TranscodeSegment {
+    int index = 0;
+    qint64 startMs = 0; // source PTS range [startMs, endMs)
+    qint64 endMs = 0;
+};
+
+struct TranscodeExportResult {
+    bool ok = false;
+    QString error;
+    int segments = 0;
+    int workers = 0;
+    qint64 framesEncoded = 0;
+    qint64 bytesWritten = 0;
+    qint64 firstPtsMs = -1; // source PTS of the first exported frame
+    qint64 lastPtsMs = -1;  // source PTS of the last exported frame
+    QStringList skippedTracks; // selected tracks the target container cannot carry
+    qint64 elapsedMs = 0;
+};
+
+// Re-encoding export of a marked range for deliverables (H.264 for social/broadcast).
+// Recordings are ALL-INTRA, so every frame is a valid split point: the range is cut into
+// segments that a pool of workers transcodes independently (own demuxer, seek, decode,
+// optional PGM composite, encode), and the segments are concatenated in order into one
+// file with timestamps rebased to 0. Each worker runs single-threaded codecs; the speed-up
+// comes from segment parallelism. Workers run at most two segments per worker ahead of the
+// writer, which bounds the encoded data held in memory.
+//
+// Each segment gets its own encoder session. Hardware H.264 sessions with one config emit
+// the same SPS/PPS; should a segment's differ from the first's (which becomes the avcC),
+// its parameter sets are repeated in-band ahead of its first frame.
+//
+// Run it on its own thread with start(); progress() and exportFinished() are emitted from
+// that thread. exportNow() does the same work synchronously on the caller's thread.
+class TranscodeExporter : public QThread {
+    Q_OBJECT
+public:
+    static constexpr qint64 kMinSegmentMs = 200;
+
+    explicit TranscodeExporter(const TranscodeExportRequest& request, QObject* parent = nullptr);
+    ~TranscodeExporter() override;
+
+    // Splits [inMs, outMs) into contiguous segments of about segmentMs, shortened (down to
+    // kMinSegmentMs) so that every worker gets at least one.
+    static QList<TranscodeSegment> planSegments(qint64 inMs, qint64 outMs, qint64 segmentMs,
+                                                int workers);
+    // libavformat muxer for the output suffix; nullptr when unsupported.
+    static const char* muxerForPath(const QString& path);
+
+    TranscodeExportResult exportNow();
+    TranscodeExportResult result() const { return m_result; }
+    void cancel() { requestInterruption(); }
+
+signals:
+    // Fraction of the segments written, 0..1.
+    void progress(double fraction);
+    void exportFinished(bool ok, const QString& error);
+
+protected:
+    void run() override;
+
+private:
+    static int interruptCallback(void* opaque);
+
+    TranscodeExportRequest m_request;
+    TranscodeExportResult m_result;
+};
+
+#endif // TRANSCODEEXPORTER_H
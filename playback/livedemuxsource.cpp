@@ -0,0 +1,202 @@
+#include "playback/livedemuxsource.h"
+
+#include "recorder_engine/livepacketring.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <cstring>
+
+namespace {
+bool hasAnnexBStartCode(const uint8_t* p, int size) {
+    if (size >= 4 && p[0] == 0 && p[1] == 0 && p[2] == 0 && p[3] == 1) return true;
+    return size >= 3 && p[0] == 0 && p[1] == 0 && p[2] == 1;
+}
+
+// The matroska muxer stores H.264 as 4-byte length-prefixed NAL units (avcC)
+// even when handed Annex B; the ring holds what the encoder produced. Rewrite
+// an Annex B ring packet into the on-disk layout so the worker's avcC parser
+// sees identical bytes whichever source served it. Returns false (packet left
+// untouched) on allocation failure.
+bool annexBToLengthPrefixed(AVPacket* pkt) {
+    const uint8_t* data = pkt->data;
+    const int size = pkt->size;
+    QByteArray out;
+    out.reserve(size + 16);
+    auto nextStart = [&](int from, int* codeLen) {
+        for (int j = from; j + 2 < size; ++j) {
+            if (data[j] == 0 && data[j + 1] == 0) {
+                if (data[j + 2] == 1) {
+                    *codeLen = 3;
+                    return j;
+                }
+                if (j + 3 < size && data[j + 2] == 0 && data[j + 3] == 1) {
+                    *codeLen = 4;
+                    return j;
+                }
+            }
+        }
+        *codeLen = 0;
+        return size;
+    };
+    int codeLen = 0;
+    int i = nextStart(0, &codeLen);
+    while (i < size) {
+        const int nalStart = i + codeLen;
+        int nextLen = 0;
+        const int nalEnd = nextStart(nalStart, &nextLen);
+        const int nalLen = nalEnd - nalStart;
+        if (nalLen > 0) {
+            const char prefix[4] = {char((nalLen >> 24) & 0xff), char((nalLen >> 16) & 0xff),
+                                    char((nalLen >> 8) & 0xff), char(nalLen & 0xff)};
+            out.append(prefix, 4);
+            out.append(reinterpret_cast<const char*>(data + nalStart), nalLen);
+        }
+        i = nalEnd;
+        codeLen = nextLen;
+    }
+    if (out.isEmpty()) return false;
+
+    AVPacket* rewritten = av_packet_alloc();
+    if (!rewritten) return false;
+    if (av_new_packet(rewritten, int(out.size())) < 0 || av_packet_copy_props(rewritten, pkt) < 0) {
+        av_packet_free(&rewritten);
+        return false;
+    }
+    memcpy(rewritten->data, out.constData(), size_t(out.size()));
+    rewritten->stream_index = pkt->stream_index;
+    av_packet_unref(pkt);
+    av_packet_move_ref(pkt, rewritten);
+    av_packet_free(&rewritten);
+    return true;
+}
+} // namespace
+
+void LiveDemuxSource::attach(AVFormatContext* ctx, const QString& path, int refStreamIndex) {
+    m_ctx = ctx;
+    m_path = path;
+    m_refStreamIndex = refStreamIndex;
+    m_ring.reset();
+    m_mode = Mode::File;
+    m_nextSeq = 0;
+    m_lastRefPtsMs = -1;
+}
+
+void LiveDemuxSource::detach() {
+    m_ctx = nullptr;
+    m_ring.reset();
+    m_mode = Mode::File;
+}
+
+void LiveDemuxSource::refreshRing() {
+    // Cheap (one hash lookup): keeps us on the CURRENT session's ring and drops
+    // a withdrawn one. Between seeks, read() notices the withdrawal at the live
+    // edge (fallBackToFile).
+    m_ring = LivePacketRing::find(m_path);
+}
+
+// Leaves the ring for the file at the reader's position: the last served ref
+// PTS, or the anchor the ring was entered at when nothing has been served since.
+// Frames already decoded past that point are simply re-inserted over themselves.
+// A failed file seek is returned as the read's error rather than reading on
+// from wherever the file happened to be.
+int LiveDemuxSource::fallBackToFile(AVPacket* pkt) {
+    m_mode = Mode::File;
+    m_ring.reset();
+    m_ringFallbacks.fetch_add(1, std::memory_order_relaxed);
+    AVStream* st = m_ctx->streams[m_refStreamIndex];
+    const int64_t seekPts =
+        av_rescale_q(qMax<int64_t>(0, m_lastRefPtsMs), {1, 1000}, st->time_base);
+    const int ret = av_seek_frame(m_ctx, m_refStreamIndex, seekPts, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        qWarning() << "LiveDemuxSource: file seek to" << m_lastRefPtsMs << "ms failed on"
+                   << m_path << ret;
+        return ret;
+    }
+    return readFromFile(pkt);
+}
+
+bool LiveDemuxSource::tryServeFromRing(int64_t anchorMs) {
+    m_mode = Mode::File;
+    if (!m_ctx || m_refStreamIndex < 0) return false;
+    refreshRing();
+    if (!m_ring) return false;
+    const std::optional<quint64> seq = m_ring->seekSequence(m_refStreamIndex, anchorMs);
+    if (!seq.has_value()) return false;
+    m_nextSeq = seq.value();
+    // Until a ref packet is served, a fallback resumes where this seek asked for.
+    m_lastRefPtsMs = anchorMs;
+    m_mode = Mode::Ring;
+    m_ringSeeks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+int LiveDemuxSource::seekMs(int64_t anchorMs) {
+    if (tryServeFromRing(anchorMs)) return 0;
+    if (!m_ctx || m_refStreamIndex < 0) return AVERROR(EINVAL);
+    AVStream* st = m_ctx->streams[m_refStreamIndex];
+    const int64_t seekPts = av_rescale_q(anchorMs, {1, 1000}, st->time_base);
+    return av_seek_frame(m_ctx, m_refStreamIndex, seekPts, AVSEEK_FLAG_BACKWARD);
+}
+
+int LiveDemuxSource::readFromFile(AVPacket* pkt) {
+    QElapsedTimer timer;
+    timer.start();
+    const int ret = av_read_frame(m_ctx, pkt);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    if (ret >= 0) m_filePackets.fetch_add(1, std::memory_order_relaxed);
+    // A stall is a blocking disk wait on the worker thread — exactly what
+    // DemuxReadAhead exists to hide — so count it whatever the read returned.
+    if (elapsedNs >= kReadStallNs) m_readStalls.fetch_add(1, std::memory_order_relaxed);
+    if (elapsedNs > m_maxReadNs.load(std::memory_order_relaxed))
+        m_maxReadNs.store(elapsedNs, std::memory_order_relaxed);
+    return ret;
+}
+
+int LiveDemuxSource::read(AVPacket* pkt) {
+    if (!m_ctx) return AVERROR(EINVAL);
+    if (m_mode == Mode::File || !m_ring) return readFromFile(pkt);
+
+    const LivePacketRing::ReadResult result = m_ring->read(m_nextSeq, pkt);
+    if (result == LivePacketRing::ReadResult::LiveEdge) {
+        // Caught up. If the recorder has withdrawn this ring (recording
+        // stopped), nothing more will be appended: finish from the file, which
+        // reaches EOF, instead of waiting on the ring forever.
+        if (LivePacketRing::find(m_path) != m_ring) return fallBackToFile(pkt);
+        return AVERROR(EAGAIN);
+    }
+    // Fell off the tail (paused/slow reader outlived the ring window).
+    if (result == LivePacketRing::ReadResult::Evicted) return fallBackToFile(pkt);
+
+    ++m_nextSeq;
+    if (pkt->stream_index < 0 || pkt->stream_index >= int(m_ctx->nb_streams)) {
+        // A stream the file does not (yet) expose — skip it like the demuxer would.
+        av_packet_unref(pkt);
+        return read(pkt);
+    }
+    AVStream* st = m_ctx->streams[pkt->stream_index];
+    if (pkt->stream_index == m_refStreamIndex && pkt->pts != AV_NOPTS_VALUE)
+        m_lastRefPtsMs = pkt->pts;
+    av_packet_rescale_ts(pkt, {1, 1000}, st->time_base);
+    if (st->codecpar->codec_id == AV_CODEC_ID_H264 && hasAnnexBStartCode(pkt->data, pkt->size))
+        annexBToLengthPrefixed(pkt);
+    m_ringPackets.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+int64_t LiveDemuxSource::tell() const {
+    if (m_mode == Mode::Ring) return static_cast<int64_t>(m_nextSeq);
+    return (m_ctx && m_ctx->pb) ? avio_tell(m_ctx->pb) : -1;
+}
+
+LiveDemuxSource::Stats LiveDemuxSource::stats() const {
+    Stats s;
+    s.ringPackets = m_ringPackets.load(std::memory_order_relaxed);
+    s.filePackets = m_filePackets.load(std::memory_order_relaxed);
+    s.ringSeeks = m_ringSeeks.load(std::memory_order_relaxed);
+    s.ringFallbacks = m_ringFallbacks.load(std::memory_order_relaxed);
+    s.readStalls = m_readStalls.load(std::memory_order_relaxed);
+    s.maxReadNs = m_maxReadNs.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,86 @@
+#ifndef LIVEDEMUXSOURCE_H
+#define LIVEDEMUXSOURCE_H
+
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+class LivePacketRing;
+
+// Packet source for a PlaybackWorker demux context. Serves packets from the
+// recorder's LivePacketRing while the requested range is resident in RAM and
+// reads the file (av_read_frame on the owned-by-caller AVFormatContext)
+// otherwise. The AVFormatContext is still opened on the file for stream info;
+// the ring only replaces the packet reads and the seeks.
+//
+// Ring mode never reports EOF: catching up with the recorder returns
+// AVERROR(EAGAIN) (retry after a wait). If a slow reader falls off the ring's
+// evicted tail, or catches up after the recorder withdrew the ring, the source
+// seeks the file to the last served PTS (or the ring seek's anchor, if none was
+// served yet) and carries on from disk transparently; if that file seek fails,
+// read() returns its error.
+// Worker-thread-only, except stats() (atomics).
+class LiveDemuxSource {
+public:
+    enum class Mode { File, Ring };
+    struct Stats {
+        qint64 ringPackets = 0;   // packets served from RAM
+        qint64 filePackets = 0;   // packets read from the file
+        qint64 ringSeeks = 0;     // seeks resolved inside the ring
+        qint64 ringFallbacks = 0; // evicted-tail / withdrawn-ring fallbacks to the file
+        qint64 readStalls = 0;    // file reads slower than kReadStallNs
+        qint64 maxReadNs = 0;     // slowest single file read
+    };
+    // A file read this slow is already eating into a frame period at 50p.
+    static constexpr qint64 kReadStallNs = 10'000'000;
+
+    // refStreamIndex: the stream seeks are keyed on (the primary video track).
+    // The ring is looked up by `path` on every seek, so a ring published after
+    // the file was opened is still picked up, and a withdrawn one is released.
+    void attach(AVFormatContext* ctx, const QString& path, int refStreamIndex);
+    void detach();
+
+    // Positions the source at the newest refStream packet at/before anchorMs if
+    // that point is resident in the ring. On false the source is in File mode
+    // and the CALLER performs its own file seek (exact FrameIndex or coarse).
+    bool tryServeFromRing(int64_t anchorMs);
+    // Ring when resident, else av_seek_frame(BACKWARD) on the ref stream.
+    int seekMs(int64_t anchorMs);
+    // av_read_frame contract, plus AVERROR(EAGAIN) at the ring's live edge.
+    int read(AVPacket* pkt);
+    // Monotonic read position within the current mode (ring sequence or avio
+    // byte offset); -1 when unknown. Not comparable across a mode change.
+    int64_t tell() const;
+
+    Mode mode() const { return m_mode; }
+    Stats stats() const;
+
+private:
+    void refreshRing();
+    int fallBackToFile(AVPacket* pkt);
+    int readFromFile(AVPacket* pkt);
+
+    AVFormatContext* m_ctx = nullptr;
+    QString m_path;
+    int m_refStreamIndex = -1;
+    std::shared_ptr<LivePacketRing> m_ring;
+    Mode m_mode = Mode::File;
+    quint64 m_nextSeq = 0;
+    int64_t m_lastRefPtsMs = -1;
+
+    std::atomic<qint64> m_ringPackets{0};
+    std::atomic<qint64> m_filePackets{0};
+    std::atomic<qint64> m_ringSeeks{0};
+    std::atomic<qint64> m_ringFallbacks{0};
+    std::atomic<qint64> m_readStalls{0};
+    std::atomic<qint64> m_maxReadNs{0};
+};
+
+#endif // LIVEDEMUXSOURCE_H
@@ -22,7 +22,8 @@ QList<OutputBusId> orderedBuses(int feedCount) {
 const OutputTargetAssignment* findAssignment(const QList<OutputTargetAssignment>& outputs,
                                              OutputTargetKind kind, OutputBusId bus) {
     for (const OutputTargetAssignment& assignment : outputs) {
-        if (assignment.kind == kind && assignment.sourceBus == bus) return &assignment;
+        if (assignment.channel == 0 && assignment.kind == kind && assignment.sourceBus == bus)
+            return &assignment;
     }
     return nullptr;
 }
@@ -118,6 +119,11 @@ QString diagnosticText(const OutputTargetAssignment& assignment,
             .arg(hasIdentity ? QString::number(status->lastIdentity.sourceFeedIndex)
                              : QStringLiteral("-"))
             .arg(valueOrDash(hasIdentity ? status->lastIdentity.sourcePtsMs : 0, hasIdentity));
+    if (status->maxEncodeLatencyNs > 0) {
+        text += QStringLiteral(" encNs=%1 maxEncNs=%2")
+                    .arg(status->encodeLatencyNs)
+                    .arg(status->maxEncodeLatencyNs);
+    }
     if (!status->sinkState.isEmpty()) {
         text += QStringLiteral(" sinkState=%1").arg(status->sinkState);
     }
@@ -148,6 +154,8 @@ void addStatusFields(QVariantMap& row, const OutputTargetAssignment& assignment,
     row.insert(QStringLiteral("lastQueuedFrameIndex"), values.lastQueuedFrameIndex);
     row.insert(QStringLiteral("lastDeliveredFrameIndex"), values.lastDeliveredFrameIndex);
     row.insert(QStringLiteral("lastSubmitDurationNs"), values.lastSubmitDurationNs);
+    row.insert(QStringLiteral("encodeLatencyNs"), values.encodeLatencyNs);
+    row.insert(QStringLiteral("maxEncodeLatencyNs"), values.maxEncodeLatencyNs);
     row.insert(QStringLiteral("runtimeDeadlineMisses"), values.runtimeDeadlineMisses);
     row.insert(QStringLiteral("runtimeCatchUpCapHits"), values.runtimeCatchUpCapHits);
     row.insert(QStringLiteral("runtimeLastCappedCatchUpTicks"),
@@ -186,11 +194,20 @@ void addStatusFields(QVariantMap& row, const OutputTargetAssignment& assignment,
 
 namespace BroadcastOutputSettings {
 
+QList<OutputTargetAssignment> forChannel(const QList<OutputTargetAssignment>& outputs,
+                                         int channel) {
+    QList<OutputTargetAssignment> result;
+    for (const OutputTargetAssignment& assignment : outputs) {
+        if (assignment.channel == channel) result.append(assignment);
+    }
+    return result;
+}
+
 QList<OutputTargetAssignment> ensureTargets(const QList<OutputTargetAssignment>& outputs,
                                             int feedCount, OutputTargetKind kind) {
     QList<OutputTargetAssignment> result;
     for (const OutputTargetAssignment& assignment : outputs) {
-        if (assignment.kind != kind) result.append(assignment);
+        if (assignment.kind != kind || assignment.channel != 0) result.append(assignment);
     }
 
     for (OutputBusId bus : orderedBuses(feedCount)) {
@@ -215,7 +232,7 @@ QList<OutputTargetAssignment> setEnabled(const QList<OutputTargetAssignment>& ou
                                          bool enabled) {
     QList<OutputTargetAssignment> result = ensureTargets(outputs, feedCount, kind);
     for (OutputTargetAssignment& assignment : result) {
-        if (assignment.kind == kind && assignment.sourceBus == bus) {
+        if (assignment.channel == 0 && assignment.kind == kind && assignment.sourceBus == bus) {
             assignment.enabled = enabled;
             break;
         }
@@ -228,7 +245,7 @@ QList<OutputTargetAssignment> setSenderName(const QList<OutputTargetAssignment>&
                                             const QString& senderName) {
     QList<OutputTargetAssignment> result = ensureTargets(outputs, feedCount, kind);
     for (OutputTargetAssignment& assignment : result) {
-        if (assignment.kind == kind && assignment.sourceBus == bus) {
+        if (assignment.channel == 0 && assignment.kind == kind && assignment.sourceBus == bus) {
             const QString normalized = senderName.trimmed();
             assignment.settings.insert(senderNameKey(),
                                        normalized.isEmpty() ? defaultSenderName(bus) : normalized);
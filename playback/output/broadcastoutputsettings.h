@@ -22,6 +22,8 @@ struct BroadcastOutputTargetStatus {
     qint64 lastQueuedFrameIndex = -1;
     qint64 lastDeliveredFrameIndex = -1;
     qint64 lastSubmitDurationNs = 0;
+    qint64 encodeLatencyNs = 0;
+    qint64 maxEncodeLatencyNs = 0;
     qint64 runtimeDeadlineMisses = 0;
     qint64 runtimeCatchUpCapHits = 0;
     qint64 runtimeLastCappedCatchUpTicks = 0;
@@ -45,8 +47,14 @@ struct BroadcastOutputTargetStatus {
     OutputFrameIdentity lastIdentity;
 };
 
+// The editing helpers below (ensureTargets, setEnabled, rows, ...) work on channel 0's
+// targets and carry other channels' assignments through unchanged.
 namespace BroadcastOutputSettings {
 
+// The assignments of one playback channel.
+QList<OutputTargetAssignment> forChannel(const QList<OutputTargetAssignment>& outputs,
+                                         int channel);
+
 QList<OutputTargetAssignment> ensureTargets(const QList<OutputTargetAssignment>& outputs,
                                             int feedCount, OutputTargetKind kind);
 QList<OutputTargetAssignment> setEnabled(const QList<OutputTargetAssignment>& outputs,
@@ -19,6 +19,8 @@ QHash<QString, BroadcastOutputTargetStatus> fromDispatchStats(const OutputDispat
         status.lastQueuedFrameIndex = source.lastQueuedFrameIndex;
         status.lastDeliveredFrameIndex = source.lastDeliveredFrameIndex;
         status.lastSubmitDurationNs = source.lastSubmitDurationNs;
+        status.encodeLatencyNs = source.encodeLatencyNs;
+        status.maxEncodeLatencyNs = source.maxEncodeLatencyNs;
         status.runtimeDeadlineMisses = stats.runtime.deadlineMisses;
         status.runtimeCatchUpCapHits = stats.runtime.catchUpCapHits;
         status.runtimeLastCappedCatchUpTicks = stats.runtime.lastCappedCatchUpTicks;
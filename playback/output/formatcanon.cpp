@@ -351,6 +351,9 @@ FramePixelFormat sinkExportFormat(OutputTargetKind kind) {
     case OutputTargetKind::Ndi:
     case OutputTargetKind::Omt:
     case OutputTargetKind::Aja:
+    case OutputTargetKind::SharedMemory:
+    case OutputTargetKind::MpegTsStream:
+    case OutputTargetKind::IsoRecorder:
         return FramePixelFormat::Yuv420p;
     }
     return FramePixelFormat::Yuv420p;
@@ -27,6 +27,15 @@ struct FramePayloadKey {
     }
 };
 
+// Steady-clock stamps (PipelineTrace::nowNs) of a played-back frame on its way from the
+// file to the output cache; 0 = not stamped (placeholders, pre-staged cue-slot frames).
+// The dispatcher adds the dispatch and submit times per target.
+struct PlaybackFrameStamps {
+    qint64 demuxedNs = 0; // the packet came back from the demuxer (file or live ring)
+    qint64 decodedNs = 0; // the decoder returned the frame
+    qint64 cachedNs = 0;  // inserted into the worker's output frame cache
+};
+
 struct FrameMetadata {
     FramePayloadKey key;
     qint64 outputFrameIndex = -1;
@@ -34,6 +43,7 @@ struct FrameMetadata {
     int stride[3] = {0, 0, 0};
     ColorMetadata color;
     uint64_t gpuGeneration = 0;
+    PlaybackFrameStamps stamps;
 };
 
 struct CpuPlanes {
@@ -0,0 +1,43 @@
+#include "playback/output/framehandlevideobuffer.h"
+
+#include <utility>
+
+FrameHandleVideoBuffer::FrameHandleVideoBuffer(const QVideoFrameFormat& format, CpuPlanes planes)
+    : m_format(format), m_planes(std::move(planes)) {}
+
+std::unique_ptr<FrameHandleVideoBuffer> FrameHandleVideoBuffer::wrap(
+    const FrameHandle& frame, const QVideoFrameFormat& format) {
+    if (frame.isNull() || format.pixelFormat() != QVideoFrameFormat::Format_YUV420P)
+        return nullptr;
+    // CPU-backed handles return their own planes (shared, not copied); GPU-backed
+    // ones read back once here, as the copying path did.
+    CpuPlanes planes = frame.readToCpu(FramePixelFormat::Yuv420p);
+    if (!planes.isValid() || planes.format != FramePixelFormat::Yuv420p) return nullptr;
+    const int width = format.frameWidth();
+    const int height = format.frameHeight();
+    for (int i = 0; i < 3; ++i) {
+        const int rows = (i == 0) ? height : (height + 1) / 2;
+        const int rowBytes = (i == 0) ? width : (width + 1) / 2;
+        if (planes.stride[i] < rowBytes ||
+            planes.plane[i].size() < qsizetype(planes.stride[i]) * rows)
+            return nullptr;
+    }
+    return std::make_unique<FrameHandleVideoBuffer>(format, std::move(planes));
+}
+
+QAbstractVideoBuffer::MapData FrameHandleVideoBuffer::map(QVideoFrame::MapMode mode) {
+    MapData data;
+    if (mode == QVideoFrame::NotMapped) return data;
+    const bool writable = (mode & QVideoFrame::WriteOnly) != 0;
+    data.planeCount = 3;
+    for (int i = 0; i < 3; ++i) {
+        QByteArray& plane = m_planes.plane[i];
+        // data() detaches a shared plane, so writes never reach the cached frame.
+        uchar* bytes = writable ? reinterpret_cast<uchar*>(plane.data())
+                                : reinterpret_cast<uchar*>(const_cast<char*>(plane.constData()));
+        data.data[i] = bytes;
+        data.bytesPerLine[i] = m_planes.stride[i];
+        data.dataSize[i] = int(plane.size());
+    }
+    return data;
+}
@@ -0,0 +1,33 @@
+#ifndef FRAMEHANDLEVIDEOBUFFER_H
+#define FRAMEHANDLEVIDEOBUFFER_H
+
+#include "playback/output/framehandle.h"
+
+#include <QAbstractVideoBuffer>
+#include <QVideoFrame>
+#include <QVideoFrameFormat>
+
+// Presents a FrameHandle's YUV420P planes to Qt Multimedia without copying
+// them: the buffer holds the planes' implicitly shared QByteArrays, so wrapping
+// a CPU-backed handle is a refcount bump and the pixels stay alive for as long
+// as any QVideoFrame (provider latest-frame, QVideoSink, render thread) does.
+// A read-only map hands out the shared bytes directly; a writable map detaches
+// the planes first, so the cached frame is never modified through a preview.
+class FrameHandleVideoBuffer final : public QAbstractVideoBuffer {
+public:
+    FrameHandleVideoBuffer(const QVideoFrameFormat& format, CpuPlanes planes);
+
+    // nullptr when the handle has no presentable YUV420P planes or a plane is
+    // shorter than its stride x rows (callers fall back to a copy).
+    static std::unique_ptr<FrameHandleVideoBuffer> wrap(const FrameHandle& frame,
+                                                        const QVideoFrameFormat& format);
+
+    MapData map(QVideoFrame::MapMode mode) override;
+    QVideoFrameFormat format() const override { return m_format; }
+
+private:
+    QVideoFrameFormat m_format;
+    CpuPlanes m_planes;
+};
+
+#endif // FRAMEHANDLEVIDEOBUFFER_H
@@ -0,0 +1,417 @@
+#include "playback/output/isorecordersink.h"
+
+#include "recorder_engine/codec/nativevideoencoder.h"
+#include "recorder_engine/muxer.h"
+#include "recorder_engine/timing/smpte12m.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstring>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+namespace {
+
+constexpr int kAudioSampleRate = 48000;
+
+qint64 audioSampleBoundary(qint64 frameIndex, FrameRate rate) {
+    return (frameIndex * qint64(kAudioSampleRate) * rate.denominator) / rate.numerator;
+}
+
+// Programme timecode as "HH:MM:SS:FF" at the bus rate; empty when the frame carries none.
+QString programmeTimecodeText(qint64 timecode100ns, FrameRate rate) {
+    if (timecode100ns < 0) return QString();
+    char buffer[12];
+    return QString::fromLatin1(
+        Smpte12m::format(Smpte12m::from100ns(timecode100ns, rate.roundedFps()), buffer));
+}
+
+void freePackets(std::vector<AVPacket*>* packets) {
+    for (AVPacket*& packet : *packets) av_packet_free(&packet);
+    packets->clear();
+}
+
+} // namespace
+
+IsoRecorderOutputSink::IsoRecorderOutputSink() = default;
+
+IsoRecorderOutputSink::~IsoRecorderOutputSink() {
+    stop();
+}
+
+bool IsoRecorderOutputSink::start(const OutputTargetAssignment& assignment, FrameRate rate) {
+    stop();
+    {
+        QMutexLocker locker(&m_statusMutex);
+        m_status = OutputSinkStatus();
+        m_recordingPath.clear();
+    }
+    if (assignment.kind != OutputTargetKind::IsoRecorder || !assignment.enabled ||
+        !rate.isValid()) {
+        setStatus(QStringLiteral("invalid"), QStringLiteral("invalid ISO recorder assignment"));
+        return false;
+    }
+
+    m_assignment = assignment;
+    m_rate = rate;
+    m_videoCodec = videoCodecFromString(
+        assignment.settings.value(QStringLiteral("videoCodec")).toString().trimmed().toLower());
+    bool ok = false;
+    const int bitrate = assignment.settings.value(QStringLiteral("videoBitrate")).toInt(&ok);
+    m_videoBitrate = ok && bitrate > 0 ? bitrate : kDefaultVideoBitrate;
+    m_directory = assignment.settings.value(QStringLiteral("directory")).toString().trimmed();
+    m_baseName = assignment.settings.value(QStringLiteral("fileName")).toString().trimmed();
+    if (m_baseName.isEmpty()) m_baseName = assignment.id.trimmed();
+    if (m_baseName.isEmpty()) m_baseName = QStringLiteral("PGM");
+    m_fileCount = 0;
+    m_active = true;
+    // The file is created on the first frame, sized from it.
+    setStatus(QStringLiteral("armed"),
+              QStringLiteral("%1 recording waiting for the first frame")
+                  .arg(videoCodecToString(m_videoCodec)));
+    return true;
+}
+
+void IsoRecorderOutputSink::stop() {
+    const bool wasRecording = m_muxer != nullptr;
+    closeRecording();
+    m_active = false;
+    const QString path = recordingPath();
+    setStatus(QStringLiteral("stopped"), wasRecording && !path.isEmpty()
+                                             ? QStringLiteral("recorded %1").arg(path)
+                                             : QStringLiteral("ISO recorder stopped"));
+}
+
+bool IsoRecorderOutputSink::submit(const OutputBusFrame& frame) {
+    if (!m_active) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    const MediaVideoFrameView video(frame.video);
+    if (!video.isValid()) {
+        recordResult(frame, timer.nsecsElapsed(), false, QStringLiteral("record-failed"),
+                     QStringLiteral("frame has no YUV 4:2:0 video"));
+        return false;
+    }
+    if (m_muxer && m_muxer->hasFatalWriteError()) {
+        recordResult(frame, timer.nsecsElapsed(), false, QStringLiteral("write-failed"),
+                     m_muxer->fatalWriteMessage());
+        return false;
+    }
+    // A bus format change closes the file and continues in a new one at the new geometry.
+    if (m_muxer && (video.width != m_width || video.height != m_height)) closeRecording();
+
+    QString error;
+    if (!m_videoCodecContext && !m_nativeVideo && !openEncoder(video.width, video.height, &error)) {
+        recordResult(frame, timer.nsecsElapsed(), false, QStringLiteral("encoder-failed"), error);
+        return false;
+    }
+
+    if (m_firstFrameIndex < 0) m_firstFrameIndex = frame.outputFrameIndex;
+    // Output frame indexes only move forward; never write a timestamp twice.
+    const qint64 relative =
+        qMax(frame.outputFrameIndex - m_firstFrameIndex, m_lastRelativeIndex + 1);
+
+    std::vector<AVPacket*> packets;
+    if (!encodeVideo(video, relative, &packets, &error)) {
+        freePackets(&packets);
+        recordResult(frame, timer.nsecsElapsed(), false, QStringLiteral("encoder-failed"), error);
+        return false;
+    }
+    // H.264 needs the avcC record of the first encoded frame before the file can be opened.
+    if (!m_muxer && !openMuxer(frame, video.width, video.height, &error)) {
+        freePackets(&packets);
+        closeRecording();
+        recordResult(frame, timer.nsecsElapsed(), false, QStringLiteral("record-failed"), error);
+        return false;
+    }
+
+    AVStream* stream = m_muxer->getStream(0);
+    const AVRational frameTimeBase{m_rate.denominator, m_rate.numerator};
+    for (AVPacket* packet : packets) {
+        packet->stream_index = 0;
+        packet->duration = 1;
+        av_packet_rescale_ts(packet, frameTimeBase, stream->time_base);
+        m_muxer->writePacket(packet);
+    }
+    freePackets(&packets);
+
+    const qint64 ptsMs = m_rate.frameIndexToMs(relative);
+    writeFrameMetadata(frame, ptsMs);
+    writeAudio(frame.audio, relative);
+    m_lastRelativeIndex = relative;
+
+    recordResult(frame, timer.nsecsElapsed(), true, QStringLiteral("recording"),
+                 QStringLiteral("recording %1").arg(recordingPath()));
+    return true;
+}
+
+bool IsoRecorderOutputSink::openEncoder(int width, int height, QString* error) {
+    m_width = width;
+    m_height = height;
+    if (m_videoCodec == VideoCodecChoice::H264Hardware) {
+        // Hardware only, as for camera recordings: no software H.264 fallback.
+        NativeVideoEncoder::Config config;
+        config.width = width;
+        config.height = height;
+        config.fpsNum = m_rate.numerator;
+        config.fpsDen = m_rate.denominator;
+        config.bitrate = m_videoBitrate;
+        m_nativeVideo = NativeVideoEncoder::create(config, error);
+        if (!m_nativeVideo) return false;
+    } else {
+        const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+        m_videoCodecContext = codec ? avcodec_alloc_context3(codec) : nullptr;
+        if (!m_videoCodecContext) {
+            if (error) *error = QStringLiteral("MPEG-2 encoder not available");
+            return false;
+        }
+        // Same intra-only MPEG-2 as the camera recordings (see StreamWorker).
+        m_videoCodecContext->width = width;
+        m_videoCodecContext->height = height;
+        m_videoCodecContext->pix_fmt = AV_PIX_FMT_YUV420P;
+        m_videoCodecContext->time_base = AVRational{m_rate.denominator, m_rate.numerator};
+        m_videoCodecContext->framerate = AVRational{m_rate.numerator, m_rate.denominator};
+        m_videoCodecContext->gop_size = 1;
+        m_videoCodecContext->max_b_frames = 0;
+        m_videoCodecContext->bit_rate = m_videoBitrate;
+        const int ret = avcodec_open2(m_videoCodecContext, codec, nullptr);
+        if (ret < 0) {
+            char errbuf[AV_ERROR_MAX_STRING_SIZE] = {0};
+            av_strerror(ret, errbuf, sizeof(errbuf));
+            if (error) *error = QStringLiteral("MPEG-2 encoder: %1").arg(QLatin1String(errbuf));
+            avcodec_free_context(&m_videoCodecContext);
+            return false;
+        }
+    }
+    m_videoFrame = av_frame_alloc();
+    if (!m_videoFrame) {
+        if (error) *error = QStringLiteral("out of memory allocating the video frame");
+        return false;
+    }
+    return true;
+}
+
+bool IsoRecorderOutputSink::encodeVideo(const MediaVideoFrameView& video, qint64 pts,
+                                        std::vector<AVPacket*>* packets, QString* error) {
+    // Borrowed planes: FFmpeg copies non-refcounted input before an encoder keeps it.
+    const auto borrow = [](const QByteArray& plane) {
+        return reinterpret_cast<uint8_t*>(const_cast<char*>(plane.constData()));
+    };
+    m_videoFrame->format = AV_PIX_FMT_YUV420P;
+    m_videoFrame->width = m_width;
+    m_videoFrame->height = m_height;
+    m_videoFrame->data[0] = borrow(video.planeY);
+    m_videoFrame->data[1] = borrow(video.planeU);
+    m_videoFrame->data[2] = borrow(video.planeV);
+    m_videoFrame->linesize[0] = video.strideY;
+    m_videoFrame->linesize[1] = video.strideU;
+    m_videoFrame->linesize[2] = video.strideV;
+    m_videoFrame->pts = pts;
+
+    if (m_nativeVideo) {
+        QString encodeError;
+        const bool encoded = m_nativeVideo->encode(
+            m_videoFrame, pts,
+            [packets](const QByteArray& data, int64_t ptsTicks, bool keyframe) {
+                AVPacket* packet = av_packet_alloc();
+                if (!packet || av_new_packet(packet, int(data.size())) < 0) {
+                    av_packet_free(&packet);
+                    return;
+                }
+                memcpy(packet->data, data.constData(), size_t(data.size()));
+                packet->pts = ptsTicks;
+                packet->dts = ptsTicks;
+                if (keyframe) packet->flags |= AV_PKT_FLAG_KEY;
+                packets->push_back(packet);
+            },
+            &encodeError);
+        if (!encoded && error) *error = QStringLiteral("H.264 encode: %1").arg(encodeError);
+        return encoded;
+    }
+
+    if (avcodec_send_frame(m_videoCodecContext, m_videoFrame) < 0) {
+        if (error) *error = QStringLiteral("MPEG-2 encode failed");
+        return false;
+    }
+    while (true) {
+        AVPacket* packet = av_packet_alloc();
+        if (!packet) {
+            if (error) *error = QStringLiteral("out of memory allocating a packet");
+            return false;
+        }
+        const int ret = avcodec_receive_packet(m_videoCodecContext, packet);
+        if (ret < 0) {
+            av_packet_free(&packet);
+            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+            if (error) *error = QStringLiteral("MPEG-2 encoder output failed");
+            return false;
+        }
+        packets->push_back(packet);
+    }
+}
+
+bool IsoRecorderOutputSink::openMuxer(const OutputBusFrame& frame, int width, int height,
+                                      QString* error) {
+    QByteArray extradata;
+    if (m_nativeVideo) {
+        extradata = m_nativeVideo->avccExtradata();
+        if (extradata.isEmpty()) {
+            if (error) *error = QStringLiteral("hardware H.264 encoder produced no avcC record");
+            return false;
+        }
+    }
+
+    m_audioChannels = frame.audio.channels > 0 ? frame.audio.channels : 2;
+    QString fileName = QStringLiteral("%1_%2").arg(
+        m_baseName, QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd_HHmmss")));
+    if (m_fileCount > 0) fileName += QStringLiteral("_%1").arg(m_fileCount + 1);
+    auto muxer = std::make_unique<Muxer>();
+    muxer->setOutputDirectory(m_directory);
+    // Nothing plays the ISO file back while it grows: no live ring to hold.
+    muxer->setLiveRingEnabled(false);
+    // The first frame's programme timecode is known up front, so the header needs no
+    // timecode grace window.
+    if (!muxer->init(fileName, 1, width, height, m_rate.roundedFps(), QStringList{m_baseName},
+                     kAudioSampleRate, m_audioChannels, m_videoCodec, extradata,
+                     programmeTimecodeText(frame.programmeTimecode100ns, m_rate),
+                     m_rate.numerator, m_rate.denominator)) {
+        if (error) *error = QStringLiteral("cannot create recording file %1").arg(fileName);
+        return false;
+    }
+    m_muxer = std::move(muxer);
+    m_fileCount++;
+    QMutexLocker locker(&m_statusMutex);
+    m_recordingPath = m_muxer->getVideoPath(fileName);
+    return true;
+}
+
+void IsoRecorderOutputSink::writeAudio(const MediaAudioFrame& audio, qint64 relativeIndex) {
+    const qint64 start = audioSampleBoundary(relativeIndex, m_rate);
+    const qint64 expected = audioSampleBoundary(relativeIndex + 1, m_rate) - start;
+    const bool usable = audio.format == MediaSampleFormat::S16Interleaved &&
+                        audio.sampleRate == kAudioSampleRate &&
+                        audio.channels == m_audioChannels && audio.sampleFrames() > 0;
+    // A frame without usable audio records its share of silence, keeping A/V locked.
+    const int samples = usable ? audio.sampleFrames() : int(expected);
+    if (samples <= 0) return;
+
+    const int audioTrack = m_muxer->audioTrackOffset();
+    AVStream* stream = m_muxer->getStream(audioTrack);
+    if (!stream) return;
+    AVPacket* packet = av_packet_alloc();
+    if (!packet) return;
+    const int bytes = samples * m_audioChannels * int(sizeof(qint16));
+    if (av_new_packet(packet, bytes) == 0) {
+        if (usable)
+            memcpy(packet->data, audio.pcm.constData(), size_t(bytes));
+        else
+            memset(packet->data, 0, size_t(bytes));
+        packet->stream_index = audioTrack;
+        packet->pts = av_rescale_q(start, {1, kAudioSampleRate}, stream->time_base);
+        packet->dts = packet->pts;
+        packet->duration = av_rescale_q(samples, {1, kAudioSampleRate}, stream->time_base);
+        m_muxer->writePacket(packet);
+    }
+    av_packet_free(&packet);
+}
+
+void IsoRecorderOutputSink::writeFrameMetadata(const OutputBusFrame& frame, qint64 ptsMs) {
+    QJsonObject meta;
+    meta.insert(QStringLiteral("outputFrameIndex"), frame.outputFrameIndex);
+    meta.insert(QStringLiteral("playheadMs"), frame.sampledPlayheadMs);
+    const QString timecode = programmeTimecodeText(frame.programmeTimecode100ns, m_rate);
+    if (!timecode.isEmpty()) {
+        meta.insert(QStringLiteral("programmeTimecode"), timecode);
+        meta.insert(QStringLiteral("programmeTimecode100ns"), frame.programmeTimecode100ns);
+    }
+    if (frame.identity.sourceFeedIndex >= 0) {
+        meta.insert(QStringLiteral("sourceFeed"), frame.identity.sourceFeedIndex);
+        meta.insert(QStringLiteral("sourcePtsMs"), frame.identity.sourcePtsMs);
+    }
+    if (frame.identity.videoPlaceholder) meta.insert(QStringLiteral("placeholder"), true);
+    m_muxer->writeMetadataPacket(0, ptsMs,
+                                 QJsonDocument(meta).toJson(QJsonDocument::Compact));
+}
+
+void IsoRecorderOutputSink::closeRecording() {
+    if (m_nativeVideo && m_muxer) {
+        // All-intra: nothing should be pending, but drain whatever the encoder still holds.
+        std::vector<AVPacket*> packets;
+        QString error;
+        m_nativeVideo->flush(
+            [&packets](const QByteArray& data, int64_t ptsTicks, bool keyframe) {
+                AVPacket* packet = av_packet_alloc();
+                if (!packet || av_new_packet(packet, int(data.size())) < 0) {
+                    av_packet_free(&packet);
+                    return;
+                }
+                memcpy(packet->data, data.constData(), size_t(data.size()));
+                packet->pts = ptsTicks;
+                packet->dts = ptsTicks;
+                if (keyframe) packet->flags |= AV_PKT_FLAG_KEY;
+                packets.push_back(packet);
+            },
+            &error);
+        AVStream* stream = m_muxer->getStream(0);
+        for (AVPacket* packet : packets) {
+            packet->duration = 1;
+            av_packet_rescale_ts(packet, AVRational{m_rate.denominator, m_rate.numerator},
+                                 stream->time_base);
+            m_muxer->writePacket(packet);
+        }
+        freePackets(&packets);
+    }
+    if (m_muxer) {
+        m_muxer->close();
+        m_muxer.reset();
+    }
+    m_nativeVideo.reset();
+    avcodec_free_context(&m_videoCodecContext);
+    av_frame_free(&m_videoFrame);
+    m_firstFrameIndex = -1;
+    m_lastRelativeIndex = -1;
+}
+
+OutputSinkStatus IsoRecorderOutputSink::outputStatus() const {
+    QMutexLocker locker(&m_statusMutex);
+    return m_status;
+}
+
+QString IsoRecorderOutputSink::recordingPath() const {
+    QMutexLocker locker(&m_statusMutex);
+    return m_recordingPath;
+}
+
+void IsoRecorderOutputSink::setStatus(const QString& state, const QString& message) {
+    QMutexLocker locker(&m_statusMutex);
+    m_status.state = state;
+    m_status.message = message;
+}
+
+void IsoRecorderOutputSink::recordResult(const OutputBusFrame& frame, qint64 submitNs, bool ok,
+                                         const QString& state, const QString& message) {
+    QMutexLocker locker(&m_statusMutex);
+    if (ok) {
+        m_status.acceptedFrames++;
+        m_status.hasLastDeliveredFrameIndex = true;
+        m_status.lastDeliveredFrameIndex = frame.outputFrameIndex;
+        m_status.encodeLatencyNs = submitNs;
+        m_status.maxEncodeLatencyNs = qMax(m_status.maxEncodeLatencyNs, submitNs);
+    } else {
+        m_status.failedFrames++;
+    }
+    m_status.lastSubmitDurationNs = submitNs;
+    m_status.hasLastResult = true;
+    m_status.lastResultSucceeded = ok;
+    m_status.hasLastQueuedFrameIndex = true;
+    m_status.lastQueuedFrameIndex = frame.outputFrameIndex;
+    m_status.state = state;
+    m_status.message = message;
+}
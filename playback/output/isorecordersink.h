@@ -0,0 +1,84 @@
+#ifndef ISORECORDERSINK_H
+#define ISORECORDERSINK_H
+
+#include "playback/output/outputsink.h"
+#include "recorder_engine/codec/videocodecchoice.h"
+
+#include <QMutex>
+
+#include <memory>
+#include <vector>
+
+class Muxer;
+class NativeVideoEncoder;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+
+// Records a bus (normally PGM) to its own MKV through the recorder's Muxer, with the same
+// intra-only encoders the camera recordings use: MPEG-2 in software or hardware H.264.
+// Assignment settings: "directory" (default: the recorder's save location), "fileName"
+// (base name, default "<id>" or "PGM"; a start timestamp is appended), "videoCodec"
+// ("mpeg2" | "h264") and "videoBitrate".
+//
+// Meant to run behind QueuedOutputSink (kQueueCapacity), whose worker becomes the encode
+// thread; the Muxer's own bounded writer thread does the disk writes. A slow disk therefore
+// fills those queues and drops frames into the sink status, and never stalls the output
+// clock. Frames are timed by output frame index, so a dropped frame leaves a gap in the file
+// instead of shifting everything after it. The programme timecode of every frame goes to
+// the metadata track, and the first one becomes the file's start timecode.
+class IsoRecorderOutputSink final : public IOutputSink {
+public:
+    static constexpr int kQueueCapacity = 8;
+    static constexpr int kDefaultVideoBitrate = 30'000'000;
+
+    IsoRecorderOutputSink();
+    ~IsoRecorderOutputSink() override;
+
+    OutputTargetKind kind() const override { return OutputTargetKind::IsoRecorder; }
+    bool start(const OutputTargetAssignment& assignment, FrameRate rate) override;
+    void stop() override;
+    bool isActive() const override { return m_active; }
+    bool submit(const OutputBusFrame& frame) override;
+    OutputSinkStatus outputStatus() const override;
+
+    // Path of the file being (or last) recorded; empty before the first frame.
+    QString recordingPath() const;
+
+private:
+    bool openEncoder(int width, int height, QString* error);
+    bool encodeVideo(const MediaVideoFrameView& video, qint64 pts,
+                     std::vector<AVPacket*>* packets, QString* error);
+    bool openMuxer(const OutputBusFrame& frame, int width, int height, QString* error);
+    void writeAudio(const MediaAudioFrame& audio, qint64 relativeIndex);
+    void writeFrameMetadata(const OutputBusFrame& frame, qint64 ptsMs);
+    void closeRecording();
+    void setStatus(const QString& state, const QString& message);
+    void recordResult(const OutputBusFrame& frame, qint64 submitNs, bool ok,
+                      const QString& state, const QString& message);
+
+    OutputTargetAssignment m_assignment;
+    FrameRate m_rate;
+    VideoCodecChoice m_videoCodec = VideoCodecChoice::Mpeg2Software;
+    int m_videoBitrate = kDefaultVideoBitrate;
+    QString m_directory;
+    QString m_baseName;
+    bool m_active = false;
+
+    std::unique_ptr<Muxer> m_muxer;
+    std::unique_ptr<NativeVideoEncoder> m_nativeVideo;
+    AVCodecContext* m_videoCodecContext = nullptr;
+    AVFrame* m_videoFrame = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    int m_audioChannels = 2;
+    qint64 m_firstFrameIndex = -1;
+    qint64 m_lastRelativeIndex = -1;
+    int m_fileCount = 0;
+
+    mutable QMutex m_statusMutex;
+    OutputSinkStatus m_status;
+    QString m_recordingPath;
+};
+
+#endif // ISORECORDERSINK_H
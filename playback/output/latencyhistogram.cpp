@@ -0,0 +1,67 @@
+#include "playback/output/latencyhistogram.h"
+
+#include <QtAlgorithms>
+
+#include <cmath>
+
+int LatencyHistogram::bucketFor(qint64 ns) {
+    if (ns < kSubBuckets) return int(qMax<qint64>(0, ns));
+    const int exponent = 63 - int(qCountLeadingZeroBits(quint64(ns)));
+    if (exponent > kMaxExponent) return kBucketCount - 1;
+    const int subBucket = int((quint64(ns) >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + subBucket;
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < kSubBuckets) return qMax(0, bucket);
+    const int exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+    const int subBucket = bucket % kSubBuckets;
+    const int shift = exponent - kSubBucketBits;
+    const qint64 lower = qint64(kSubBuckets + subBucket) << shift;
+    return lower + (qint64(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(qint64 ns) {
+    const qint64 value = qMax<qint64>(0, ns);
+    m_buckets[size_t(bucketFor(value))]++;
+    m_count++;
+    m_max = qMax(m_max, value);
+    m_sum += value;
+}
+
+void LatencyHistogram::reset() {
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+    m_sum = 0;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t bucket = 0; bucket < m_buckets.size(); ++bucket) {
+        m_buckets[bucket] += other.m_buckets[bucket];
+    }
+    m_count += other.m_count;
+    m_max = qMax(m_max, other.m_max);
+    m_sum += other.m_sum;
+}
+
+qint64 LatencyHistogram::percentile(double q) const {
+    if (m_count <= 0) return 0;
+    const double clamped = qBound(0.0, q, 1.0);
+    const qint64 rank = qMax<qint64>(1, qint64(std::ceil(clamped * double(m_count))));
+    qint64 seen = 0;
+    for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        seen += m_buckets[size_t(bucket)];
+        if (seen >= rank) return qMin(bucketUpperBound(bucket), m_max);
+    }
+    return m_max;
+}
+
+qint64 LatencyHistogram::countAtOrBelow(qint64 ns) const {
+    if (ns < 0) return 0;
+    qint64 seen = 0;
+    for (int bucket = 0; bucket < kBucketCount && bucketUpperBound(bucket) <= ns; ++bucket) {
+        seen += m_buckets[size_t(bucket)];
+    }
+    return seen;
+}
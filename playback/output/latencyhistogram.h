@@ -0,0 +1,45 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+
+#include <array>
+
+// Fixed-size log-linear histogram of nanosecond durations: 8 sub-buckets per power of two,
+// so any reported percentile is within 12.5% above the true value, from 0 ns up to ~18
+// minutes. record() is a few shifts and an increment with no allocation, cheap enough for the
+// output dispatch thread to call on every tick. Negative samples (an early tick) count as 0.
+// Not thread-safe; the owner serializes access.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+    void record(qint64 ns);
+    void reset();
+    // Adds other's samples, as if each had been recorded here.
+    void merge(const LatencyHistogram& other);
+
+    qint64 count() const { return m_count; }
+    qint64 max() const { return m_max; }
+    qint64 sum() const { return m_sum; }
+    // Upper edge of the bucket holding the q-quantile (0 <= q <= 1), capped at max();
+    // 0 when empty.
+    qint64 percentile(double q) const;
+    // Samples in buckets lying entirely at or below ns: a cumulative count for exporting
+    // fixed bucket edges, short by at most the samples sharing ns's own bucket.
+    qint64 countAtOrBelow(qint64 ns) const;
+
+    static int bucketFor(qint64 ns);
+    static qint64 bucketUpperBound(int bucket);
+
+private:
+    std::array<qint64, kBucketCount> m_buckets{};
+    qint64 m_count = 0;
+    qint64 m_max = 0;
+    qint64 m_sum = 0;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,784 @@
+#include "playback/output/mpegtsstreamsink.h"
+
+#include "recorder_engine/codec/nativevideoencoder.h"
+#include "recorder_engine/ingest/nativesrturloptions.h"
+#include "recorder_engine/pipelinetrace.h"
+
+#include <QElapsedTimer>
+#include <QUrl>
+
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/audio_fifo.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/mem.h>
+}
+
+namespace {
+
+// Seven 188-byte TS packets per datagram: the SRT live payload size, and under a typical MTU.
+constexpr int kTsDatagramBytes = 7 * 188;
+// How long one transport attempt may block the encoder thread (an SRT caller handshaking)
+// before it counts as failed and the backoff starts. An SRT listener is not bounded: it
+// waits for its caller on a thread of its own.
+constexpr int kConnectAttemptMs = 1000;
+constexpr int kWriteTimeoutMs = 1000;
+constexpr int kAacSampleRate = 48000;
+constexpr int kMaxAudioChannels = 8;
+constexpr size_t kMaxPendingFrames = 64;
+
+qint64 monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+QString avErrorString(int errorCode) {
+    char buffer[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(errorCode, buffer, sizeof(buffer));
+    return QString::fromUtf8(buffer);
+}
+
+int positiveSetting(const OutputTargetAssignment& assignment, const QString& key, int fallback) {
+    bool ok = false;
+    const int value = assignment.settings.value(key).toInt(&ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+QString srtModeName(NativeSrtMode mode) {
+    switch (mode) {
+    case NativeSrtMode::Caller:
+        return QStringLiteral("caller");
+    case NativeSrtMode::Listener:
+        return QStringLiteral("listener");
+    case NativeSrtMode::Rendezvous:
+        return QStringLiteral("rendezvous");
+    }
+    return QStringLiteral("caller");
+}
+
+// Samples of 48 kHz audio belonging to output frame `frameIndex`, on the same boundaries the
+// bus engine cuts audio on, so a frame without audio is padded with exactly its share.
+int audioSamplesForFrame(qint64 frameIndex, FrameRate rate) {
+    const qint64 start = (frameIndex * qint64(kAacSampleRate) * rate.denominator) / rate.numerator;
+    const qint64 end =
+        ((frameIndex + 1) * qint64(kAacSampleRate) * rate.denominator) / rate.numerator;
+    return int(end - start);
+}
+
+} // namespace
+
+MpegTsStreamConfig MpegTsStreamConfig::fromAssignment(const OutputTargetAssignment& assignment) {
+    MpegTsStreamConfig config;
+    config.url = assignment.settings.value(QStringLiteral("url")).toString().trimmed();
+    config.videoCodec = videoCodecFromString(
+        assignment.settings.value(QStringLiteral("videoCodec")).toString().trimmed().toLower());
+    config.videoBitrate =
+        positiveSetting(assignment, QStringLiteral("videoBitrate"), kDefaultVideoBitrate);
+    config.audioBitrate =
+        positiveSetting(assignment, QStringLiteral("audioBitrate"), kDefaultAudioBitrate);
+    config.gopFrames = positiveSetting(assignment, QStringLiteral("gopFrames"), 0);
+    config.latencyMs = positiveSetting(assignment, QStringLiteral("latencyMs"), kDefaultLatencyMs);
+    return config;
+}
+
+bool mpegTsStreamEndpointFor(const MpegTsStreamConfig& config, MpegTsStreamEndpoint* endpoint,
+                             QString* error) {
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+    if (config.url.isEmpty()) return fail(QStringLiteral("mpegts-stream target has no url"));
+
+    const QUrl url(config.url, QUrl::StrictMode);
+    const QString scheme = url.scheme().toLower();
+    if (!url.isValid() || url.port() <= 0) {
+        return fail(QStringLiteral("invalid stream url %1 (expected srt://host:port or "
+                                   "udp://host:port)")
+                        .arg(url.toDisplayString(QUrl::RemoveQuery | QUrl::RemoveUserInfo)));
+    }
+
+    MpegTsStreamEndpoint result;
+    QString host = url.host();
+    if (scheme == QStringLiteral("udp")) {
+        if (host.isEmpty()) return fail(QStringLiteral("udp stream url needs a host"));
+        result.options.insert(QStringLiteral("pkt_size"), QString::number(kTsDatagramBytes));
+    } else if (scheme == QStringLiteral("srt")) {
+        const NativeSrtUrlOptions options = nativeSrtUrlOptionsFromUrl(url);
+        if (options.unknownMode)
+            return fail(QStringLiteral("unknown SRT mode (expected caller, listener or "
+                                       "rendezvous)"));
+        if (host.isEmpty()) {
+            if (options.mode != NativeSrtMode::Listener)
+                return fail(QStringLiteral("SRT %1 needs a host").arg(srtModeName(options.mode)));
+            host = QStringLiteral("0.0.0.0");
+        }
+        if (!options.passphrase.isEmpty()) {
+            if (!nativeSrtPassphraseIsValid(options.passphrase)) {
+                return fail(QStringLiteral("SRT passphrase must be %1..%2 characters")
+                                .arg(kNativeSrtMinPassphraseLen)
+                                .arg(kNativeSrtMaxPassphraseLen));
+            }
+            if (!nativeSrtPbKeyLenIsValid(options.pbKeyLen))
+                return fail(QStringLiteral("SRT pbkeylen must be 16, 24 or 32"));
+            result.options.insert(QStringLiteral("passphrase"), options.passphrase);
+            result.options.insert(QStringLiteral("pbkeylen"), QString::number(options.pbKeyLen));
+        }
+        if (!options.streamId.isEmpty())
+            result.options.insert(QStringLiteral("streamid"), options.streamId);
+        result.options.insert(QStringLiteral("mode"), srtModeName(options.mode));
+        result.options.insert(QStringLiteral("transtype"), QStringLiteral("live"));
+        // FFmpeg's srt protocol takes latency in microseconds.
+        result.options.insert(QStringLiteral("latency"),
+                              QString::number(qint64(config.latencyMs) * 1000));
+        result.options.insert(QStringLiteral("pkt_size"), QString::number(kTsDatagramBytes));
+        result.isSrt = true;
+        result.isSrtListener = options.mode == NativeSrtMode::Listener;
+    } else {
+        return fail(QStringLiteral("unsupported stream scheme '%1' (expected srt or udp)")
+                        .arg(url.scheme()));
+    }
+
+    QUrl bare;
+    bare.setScheme(scheme);
+    bare.setHost(host);
+    bare.setPort(url.port());
+    result.url = bare.toString();
+    if (endpoint) *endpoint = result;
+    return true;
+}
+
+// One connected stream: encoders, MPEG-TS muxer and transport, all driven from the sink's
+// (encoder) thread. Torn down and rebuilt on any transport failure or geometry change.
+class MpegTsEncoderPipeline {
+public:
+    MpegTsEncoderPipeline(const MpegTsStreamConfig& config, const MpegTsStreamEndpoint& endpoint,
+                          FrameRate rate, const std::atomic<bool>* abort)
+        : m_config(config), m_endpoint(endpoint), m_rate(rate), m_abort(abort) {}
+    ~MpegTsEncoderPipeline() { close(); }
+
+    MpegTsEncoderPipeline(const MpegTsEncoderPipeline&) = delete;
+    MpegTsEncoderPipeline& operator=(const MpegTsEncoderPipeline&) = delete;
+
+    // Opens the encoders and the muxer.
+    bool open(int width, int height, int audioChannels, QString* error);
+    // Opens the transport once open() succeeded. Bounded by kConnectAttemptMs, except for an
+    // SRT listener, which waits for its caller until the sink aborts. On failure the owner
+    // drops the pipeline on its encoder thread.
+    bool connect(QString* error);
+    bool encode(const OutputBusFrame& frame, const MediaVideoFrameView& video, QString* error);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    qint64 bytesSent() const { return m_format && m_format->pb ? avio_tell(m_format->pb) : 0; }
+    qint64 lastEncodeLatencyNs() const { return m_lastEncodeLatencyNs; }
+
+private:
+    static int interruptCallback(void* opaque);
+
+    bool openVideoEncoder(QString* error);
+    bool openAudioEncoder(int channels, QString* error);
+    bool openMuxer(QString* error);
+    bool writeHeader(QString* error);
+    bool encodeVideo(const MediaVideoFrameView& video, qint64 pts, QString* error);
+    bool encodeAudio(const MediaAudioFrame& audio, qint64 frameIndex, QString* error);
+    bool drain(AVCodecContext* codec, AVStream* stream, QString* error);
+    bool writePacket(AVPacket* packet, AVStream* stream, AVRational sourceTimeBase,
+                     QString* error);
+    void noteVideoPacketWritten(qint64 pts);
+    void close();
+
+    MpegTsStreamConfig m_config;
+    MpegTsStreamEndpoint m_endpoint;
+    FrameRate m_rate;
+    const std::atomic<bool>* m_abort = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+
+    AVFormatContext* m_format = nullptr;
+    AVStream* m_videoStream = nullptr;
+    AVStream* m_audioStream = nullptr;
+    AVCodecContext* m_videoCodec = nullptr;
+    AVCodecContext* m_audioCodec = nullptr;
+    std::unique_ptr<NativeVideoEncoder> m_nativeVideo;
+    AVFrame* m_videoFrame = nullptr;
+    AVFrame* m_audioFrame = nullptr;
+    AVAudioFifo* m_audioFifo = nullptr;
+    AVPacket* m_packet = nullptr;
+    std::vector<std::vector<float>> m_planarScratch;
+    bool m_headerWritten = false;
+    qint64 m_nextVideoPts = 0;
+    qint64 m_nextAudioPts = 0;
+    std::atomic<qint64> m_deadlineNs{0};
+    // (video pts, submit time) of frames whose packet has not been sent yet.
+    std::deque<std::pair<qint64, qint64>> m_pendingFrames;
+    qint64 m_lastEncodeLatencyNs = 0;
+};
+
+int MpegTsEncoderPipeline::interruptCallback(void* opaque) {
+    const auto* self = static_cast<const MpegTsEncoderPipeline*>(opaque);
+    if (self->m_abort && self->m_abort->load(std::memory_order_relaxed)) return 1;
+    const qint64 deadline = self->m_deadlineNs.load(std::memory_order_relaxed);
+    return deadline > 0 && monotonicNs() > deadline ? 1 : 0;
+}
+
+bool MpegTsEncoderPipeline::open(int width, int height, int audioChannels, QString* error) {
+    m_width = width;
+    m_height = height;
+    m_packet = av_packet_alloc();
+    if (!m_packet || !openVideoEncoder(error) ||
+        !openAudioEncoder(qBound(1, audioChannels, kMaxAudioChannels), error) ||
+        !openMuxer(error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MpegTsEncoderPipeline::openVideoEncoder(QString* error) {
+    if (m_config.videoCodec == VideoCodecChoice::H264Hardware) {
+        // Hardware only: never fall back to a software H.264 encoder.
+        NativeVideoEncoder::Config config;
+        config.width = m_width;
+        config.height = m_height;
+        config.fpsNum = m_rate.numerator;
+        config.fpsDen = m_rate.denominator;
+        config.bitrate = m_config.videoBitrate;
+        m_nativeVideo = NativeVideoEncoder::create(config, error);
+        if (!m_nativeVideo) return false;
+    } else {
+        const AVCodec* codec = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+        m_videoCodec = codec ? avcodec_alloc_context3(codec) : nullptr;
+        if (!m_videoCodec) {
+            if (error) *error = QStringLiteral("MPEG-2 encoder not available");
+            return false;
+        }
+        m_videoCodec->width = m_width;
+        m_videoCodec->height = m_height;
+        m_videoCodec->pix_fmt = AV_PIX_FMT_YUV420P;
+        m_videoCodec->time_base = AVRational{m_rate.denominator, m_rate.numerator};
+        m_videoCodec->framerate = AVRational{m_rate.numerator, m_rate.denominator};
+        m_videoCodec->gop_size = m_config.gopFrames > 0 ? m_config.gopFrames : m_rate.roundedFps();
+        // No B-frames: every packet leaves the encoder with the frame that produced it.
+        m_videoCodec->max_b_frames = 0;
+        m_videoCodec->bit_rate = m_config.videoBitrate;
+        m_videoCodec->rc_max_rate = m_config.videoBitrate;
+        m_videoCodec->rc_buffer_size = m_config.videoBitrate / 2;
+        m_videoCodec->thread_type = FF_THREAD_SLICE;
+        const int ret = avcodec_open2(m_videoCodec, codec, nullptr);
+        if (ret < 0) {
+            if (error) *error = QStringLiteral("MPEG-2 encoder: %1").arg(avErrorString(ret));
+            return false;
+        }
+    }
+    m_videoFrame = av_frame_alloc();
+    if (!m_videoFrame) {
+        if (error) *error = QStringLiteral("out of memory allocating the video frame");
+        return false;
+    }
+    return true;
+}
+
+bool MpegTsEncoderPipeline::openAudioEncoder(int channels, QString* error) {
+    const AVCodec* codec = avcodec_find_encoder_by_name("aac");
+    m_audioCodec = codec ? avcodec_alloc_context3(codec) : nullptr;
+    if (!m_audioCodec) {
+        if (error) *error = QStringLiteral("AAC encoder not available");
+        return false;
+    }
+    m_audioCodec->sample_fmt = AV_SAMPLE_FMT_FLTP;
+    m_audioCodec->sample_rate = kAacSampleRate;
+    av_channel_layout_default(&m_audioCodec->ch_layout, channels);
+    m_audioCodec->bit_rate = m_config.audioBitrate;
+    m_audioCodec->time_base = AVRational{1, kAacSampleRate};
+    int ret = avcodec_open2(m_audioCodec, codec, nullptr);
+    if (ret < 0) {
+        if (error) *error = QStringLiteral("AAC encoder: %1").arg(avErrorString(ret));
+        return false;
+    }
+
+    m_audioFrame = av_frame_alloc();
+    m_audioFifo = av_audio_fifo_alloc(AV_SAMPLE_FMT_FLTP, channels, m_audioCodec->frame_size * 2);
+    if (!m_audioFrame || !m_audioFifo) {
+        if (error) *error = QStringLiteral("out of memory allocating the audio buffers");
+        return false;
+    }
+    m_audioFrame->format = AV_SAMPLE_FMT_FLTP;
+    m_audioFrame->sample_rate = kAacSampleRate;
+    m_audioFrame->nb_samples = m_audioCodec->frame_size;
+    av_channel_layout_copy(&m_audioFrame->ch_layout, &m_audioCodec->ch_layout);
+    ret = av_frame_get_buffer(m_audioFrame, 0);
+    if (ret < 0) {
+        if (error) *error = QStringLiteral("audio frame buffer: %1").arg(avErrorString(ret));
+        return false;
+    }
+    m_planarScratch.assign(size_t(channels), {});
+    return true;
+}
+
+bool MpegTsEncoderPipeline::openMuxer(QString* error) {
+    int ret = avformat_alloc_output_context2(&m_format, nullptr, "mpegts", nullptr);
+    if (ret < 0 || !m_format) {
+        if (error) *error = QStringLiteral("MPEG-TS muxer: %1").arg(avErrorString(ret));
+        return false;
+    }
+    m_format->flags |= AVFMT_FLAG_FLUSH_PACKETS;
+    m_format->interrupt_callback.callback = &MpegTsEncoderPipeline::interruptCallback;
+    m_format->interrupt_callback.opaque = this;
+
+    m_videoStream = avformat_new_stream(m_format, nullptr);
+    m_audioStream = avformat_new_stream(m_format, nullptr);
+    if (!m_videoStream || !m_audioStream) {
+        if (error) *error = QStringLiteral("MPEG-TS muxer: cannot add streams");
+        return false;
+    }
+    if (m_videoCodec) {
+        avcodec_parameters_from_context(m_videoStream->codecpar, m_videoCodec);
+    } else {
+        // The avcC record is only known after the first hardware encode; writeHeader()
+        // attaches it. The muxer then converts the length-prefixed packets to Annex B itself.
+        m_videoStream->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+        m_videoStream->codecpar->codec_id = AV_CODEC_ID_H264;
+        m_videoStream->codecpar->width = m_width;
+        m_videoStream->codecpar->height = m_height;
+        m_videoStream->codecpar->format = AV_PIX_FMT_YUV420P;
+    }
+    m_videoStream->time_base = AVRational{m_rate.denominator, m_rate.numerator};
+    ret = avcodec_parameters_from_context(m_audioStream->codecpar, m_audioCodec);
+    if (ret < 0) {
+        if (error) *error = QStringLiteral("MPEG-TS audio stream: %1").arg(avErrorString(ret));
+        return false;
+    }
+    m_audioStream->time_base = AVRational{1, kAacSampleRate};
+    return true;
+}
+
+bool MpegTsEncoderPipeline::connect(QString* error) {
+    AVDictionary* options = nullptr;
+    for (auto it = m_endpoint.options.constBegin(); it != m_endpoint.options.constEnd(); ++it)
+        av_dict_set(&options, it.key().toUtf8().constData(), it.value().toUtf8().constData(), 0);
+
+    if (!m_endpoint.isSrtListener)
+        m_deadlineNs.store(monotonicNs() + qint64(kConnectAttemptMs) * 1000000);
+    const int ret = avio_open2(&m_format->pb, m_endpoint.url.toUtf8().constData(),
+                               AVIO_FLAG_WRITE, &m_format->interrupt_callback, &options);
+    m_deadlineNs.store(0);
+    av_dict_free(&options);
+    if (ret < 0) {
+        if (error) {
+            *error = QStringLiteral("cannot open %1: %2").arg(m_endpoint.url, avErrorString(ret));
+        }
+        return false;
+    }
+    return true;
+}
+
+bool MpegTsEncoderPipeline::writeHeader(QString* error) {
+    if (m_nativeVideo && m_videoStream->codecpar->extradata_size == 0) {
+        const QByteArray avcc = m_nativeVideo->avccExtradata();
+        if (avcc.isEmpty()) {
+            if (error) *error = QStringLiteral("hardware H.264 encoder produced no avcC record");
+            return false;
+        }
+        auto* extradata =
+            static_cast<uint8_t*>(av_mallocz(size_t(avcc.size()) + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!extradata) {
+            if (error) *error = QStringLiteral("out of memory copying the avcC record");
+            return false;
+        }
+        memcpy(extradata, avcc.constData(), size_t(avcc.size()));
+        m_videoStream->codecpar->extradata = extradata;
+        m_videoStream->codecpar->extradata_size = int(avcc.size());
+    }
+
+    m_deadlineNs.store(monotonicNs() + qint64(kWriteTimeoutMs) * 1000000);
+    const int ret = avformat_write_header(m_format, nullptr);
+    m_deadlineNs.store(0);
+    if (ret < 0) {
+        if (error) *error = QStringLiteral("MPEG-TS header: %1").arg(avErrorString(ret));
+        return false;
+    }
+    m_headerWritten = true;
+    return true;
+}
+
+bool MpegTsEncoderPipeline::encode(const OutputBusFrame& frame, const MediaVideoFrameView& video,
+                                   QString* error) {
+    // Latency runs from the dispatcher's submit, so time spent queued ahead of this encoder
+    // thread counts; a frame submitted directly starts its clock here.
+    const qint64 submitNs = frame.submitNs > 0 ? frame.submitNs : PipelineTrace::nowNs();
+    const qint64 pts = m_nextVideoPts++;
+    m_pendingFrames.emplace_back(pts, submitNs);
+    while (m_pendingFrames.size() > kMaxPendingFrames) m_pendingFrames.pop_front();
+
+    return encodeVideo(video, pts, error) && encodeAudio(frame.audio, pts, error);
+}
+
+bool MpegTsEncoderPipeline::encodeVideo(const MediaVideoFrameView& video, qint64 pts,
+                                        QString* error) {
+    const int chromaHeight = (m_height + 1) / 2;
+    if (video.width != m_width || video.height != m_height ||
+        video.planeY.size() < qint64(video.strideY) * m_height ||
+        video.planeU.size() < qint64(video.strideU) * chromaHeight ||
+        video.planeV.size() < qint64(video.strideV) * chromaHeight) {
+        if (error) *error = QStringLiteral("video frame does not match the stream geometry");
+        return false;
+    }
+
+    // Borrowed planes: FFmpeg copies non-refcounted input before the encoder keeps it, and
+    // encoders never write to their input.
+    m_videoFrame->format = AV_PIX_FMT_YUV420P;
+    m_videoFrame->width = m_width;
+    m_videoFrame->height = m_height;
+    const auto borrow = [](const QByteArray& plane) {
+        return reinterpret_cast<uint8_t*>(const_cast<char*>(plane.constData()));
+    };
+    m_videoFrame->data[0] = borrow(video.planeY);
+    m_videoFrame->data[1] = borrow(video.planeU);
+    m_videoFrame->data[2] = borrow(video.planeV);
+    m_videoFrame->linesize[0] = video.strideY;
+    m_videoFrame->linesize[1] = video.strideU;
+    m_videoFrame->linesize[2] = video.strideV;
+    m_videoFrame->pts = pts;
+
+    if (m_nativeVideo) {
+        bool written = true;
+        QString writeError;
+        const auto onPacket = [&](const QByteArray& data, int64_t ptsTicks, bool keyframe) {
+            if (!written) return;
+            AVPacket* packet = av_packet_alloc();
+            if (!packet || av_new_packet(packet, int(data.size())) < 0) {
+                av_packet_free(&packet);
+                written = false;
+                writeError = QStringLiteral("out of memory copying an H.264 packet");
+                return;
+            }
+            memcpy(packet->data, data.constData(), size_t(data.size()));
+            packet->pts = ptsTicks;
+            packet->dts = ptsTicks;
+            packet->duration = 1;
+            if (keyframe) packet->flags |= AV_PKT_FLAG_KEY;
+            written = writePacket(packet, m_videoStream,
+                                  AVRational{m_rate.denominator, m_rate.numerator}, &writeError);
+            av_packet_free(&packet);
+            if (written) noteVideoPacketWritten(ptsTicks);
+        };
+        QString encodeError;
+        if (!m_nativeVideo->encode(m_videoFrame, pts, onPacket, &encodeError)) {
+            if (error) *error = QStringLiteral("H.264 encode: %1").arg(encodeError);
+            return false;
+        }
+        if (!written && error) *error = writeError;
+        return written;
+    }
+
+    const int ret = avcodec_send_frame(m_videoCodec, m_videoFrame);
+    if (ret < 0) {
+        if (error) *error = QStringLiteral("MPEG-2 encode: %1").arg(avErrorString(ret));
+        return false;
+    }
+    return drain(m_videoCodec, m_videoStream, error);
+}
+
+bool MpegTsEncoderPipeline::encodeAudio(const MediaAudioFrame& audio, qint64 frameIndex,
+                                        QString* error) {
+    const int channels = m_audioCodec->ch_layout.nb_channels;
+    const bool usable = audio.format == MediaSampleFormat::S16Interleaved &&
+                        audio.sampleRate == kAacSampleRate && audio.channels == channels &&
+                        audio.sampleFrames() > 0;
+    // Frames without (usable) audio still advance the audio clock by their share of
+    // silence, so audio and video stay locked across gaps.
+    const int samples = usable ? audio.sampleFrames() : audioSamplesForFrame(frameIndex, m_rate);
+    if (samples <= 0) return true;
+
+    const auto* pcm = reinterpret_cast<const qint16*>(audio.pcm.constData());
+    void* planes[kMaxAudioChannels] = {};
+    for (int c = 0; c < channels; ++c) {
+        std::vector<float>& plane = m_planarScratch[size_t(c)];
+        plane.assign(size_t(samples), 0.0f);
+        if (usable) {
+            for (int i = 0; i < samples; ++i) plane[size_t(i)] = pcm[i * channels + c] / 32768.0f;
+        }
+        planes[c] = plane.data();
+    }
+    if (av_audio_fifo_write(m_audioFifo, planes, samples) < samples) {
+        if (error) *error = QStringLiteral("audio FIFO write failed");
+        return false;
+    }
+
+    const int frameSize = m_audioCodec->frame_size;
+    while (av_audio_fifo_size(m_audioFifo) >= frameSize) {
+        int ret = av_frame_make_writable(m_audioFrame);
+        if (ret >= 0) {
+            ret = av_audio_fifo_read(m_audioFifo, reinterpret_cast<void**>(m_audioFrame->data),
+                                     frameSize);
+        }
+        if (ret < 0) {
+            if (error) *error = QStringLiteral("audio FIFO read: %1").arg(avErrorString(ret));
+            return false;
+        }
+        m_audioFrame->pts = m_nextAudioPts;
+        m_nextAudioPts += frameSize;
+        ret = avcodec_send_frame(m_audioCodec, m_audioFrame);
+        if (ret < 0) {
+            if (error) *error = QStringLiteral("AAC encode: %1").arg(avErrorString(ret));
+            return false;
+        }
+        if (!drain(m_audioCodec, m_audioStream, error)) return false;
+    }
+    return true;
+}
+
+bool MpegTsEncoderPipeline::drain(AVCodecContext* codec, AVStream* stream, QString* error) {
+    while (true) {
+        const int ret = avcodec_receive_packet(codec, m_packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) {
+            if (error) *error = QStringLiteral("encoder output: %1").arg(avErrorString(ret));
+            return false;
+        }
+        const qint64 pts = m_packet->pts;
+        const bool written = writePacket(m_packet, stream, codec->time_base, error);
+        av_packet_unref(m_packet);
+        if (!written) return false;
+        if (stream == m_videoStream) noteVideoPacketWritten(pts);
+    }
+}
+
+bool MpegTsEncoderPipeline::writePacket(AVPacket* packet, AVStream* stream,
+                                        AVRational sourceTimeBase, QString* error) {
+    if (!m_headerWritten && !writeHeader(error)) return false;
+
+    packet->stream_index = stream->index;
+    av_packet_rescale_ts(packet, sourceTimeBase, stream->time_base);
+    m_deadlineNs.store(monotonicNs() + qint64(kWriteTimeoutMs) * 1000000);
+    const int ret = av_write_frame(m_format, packet);
+    m_deadlineNs.store(0);
+    if (ret < 0) {
+        if (error) {
+            *error = QStringLiteral("send to %1: %2").arg(m_endpoint.url, avErrorString(ret));
+        }
+        return false;
+    }
+    return true;
+}
+
+void MpegTsEncoderPipeline::noteVideoPacketWritten(qint64 pts) {
+    while (!m_pendingFrames.empty() && m_pendingFrames.front().first <= pts) {
+        if (m_pendingFrames.front().first == pts)
+            m_lastEncodeLatencyNs = PipelineTrace::nowNs() - m_pendingFrames.front().second;
+        m_pendingFrames.pop_front();
+    }
+}
+
+void MpegTsEncoderPipeline::close() {
+    if (m_format) {
+        if (m_headerWritten) {
+            m_deadlineNs.store(monotonicNs() + qint64(kWriteTimeoutMs) * 1000000);
+            av_write_trailer(m_format);
+            m_deadlineNs.store(0);
+        }
+        if (m_format->pb) avio_closep(&m_format->pb);
+        avformat_free_context(m_format);
+        m_format = nullptr;
+    }
+    m_videoStream = nullptr;
+    m_audioStream = nullptr;
+    m_headerWritten = false;
+    avcodec_free_context(&m_videoCodec);
+    avcodec_free_context(&m_audioCodec);
+    m_nativeVideo.reset();
+    av_frame_free(&m_videoFrame);
+    av_frame_free(&m_audioFrame);
+    if (m_audioFifo) {
+        av_audio_fifo_free(m_audioFifo);
+        m_audioFifo = nullptr;
+    }
+    av_packet_free(&m_packet);
+    m_pendingFrames.clear();
+}
+
+MpegTsStreamOutputSink::MpegTsStreamOutputSink() = default;
+
+MpegTsStreamOutputSink::~MpegTsStreamOutputSink() {
+    stop();
+}
+
+bool MpegTsStreamOutputSink::start(const OutputTargetAssignment& assignment, FrameRate rate) {
+    stop();
+    {
+        QMutexLocker locker(&m_statusMutex);
+        m_status = OutputSinkStatus();
+    }
+    if (assignment.kind != OutputTargetKind::MpegTsStream || !assignment.enabled ||
+        !rate.isValid()) {
+        setStatus(QStringLiteral("invalid"), QStringLiteral("invalid mpegts-stream assignment"));
+        return false;
+    }
+    const MpegTsStreamConfig config = MpegTsStreamConfig::fromAssignment(assignment);
+    MpegTsStreamEndpoint endpoint;
+    QString error;
+    if (!mpegTsStreamEndpointFor(config, &endpoint, &error)) {
+        setStatus(QStringLiteral("invalid"), error);
+        return false;
+    }
+    m_config = config;
+    m_endpoint = endpoint;
+    m_rate = rate;
+    m_nextAttemptMs = 0;
+    m_connections = 0;
+    m_abort.store(false);
+    m_active = true;
+    // Encoders and transport open on the first frame, on the thread that submits it.
+    setStatus(QStringLiteral("connecting"),
+              QStringLiteral("%1 stream to %2 waiting for the first frame")
+                  .arg(videoCodecToString(config.videoCodec), endpoint.url));
+    return true;
+}
+
+void MpegTsStreamOutputSink::stop() {
+    m_abort.store(true);
+    if (m_listener.joinable()) m_listener.join();
+    m_listening.reset();
+    m_pipeline.reset();
+    m_active = false;
+    setStatus(QStringLiteral("stopped"), QStringLiteral("mpegts stream stopped"));
+}
+
+bool MpegTsStreamOutputSink::submit(const OutputBusFrame& frame) {
+    if (!m_active) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    const MediaVideoFrameView video(frame.video);
+    if (!video.isValid()) {
+        recordFailure(frame, timer.nsecsElapsed(), QStringLiteral("send-failed"),
+                      QStringLiteral("frame has no YUV 4:2:0 video"));
+        return false;
+    }
+    // A bus format change restarts the stream at the new geometry.
+    if (m_pipeline && (m_pipeline->width() != video.width || m_pipeline->height() != video.height))
+        m_pipeline.reset();
+
+    const qint64 nowMs = monotonicNs() / 1000000;
+    if (!m_pipeline) {
+        std::unique_ptr<MpegTsEncoderPipeline> pipeline;
+        QString error;
+        if (m_listener.joinable()) {
+            // Frames meanwhile fail fast and keep the "listening" state.
+            if (!m_listenerDone.load(std::memory_order_acquire)) {
+                recordFailure(frame, timer.nsecsElapsed(), QString(), QString());
+                return false;
+            }
+            m_listener.join();
+            pipeline = std::move(m_listening);
+            if (!m_listenOk) pipeline.reset();
+            error = m_listenError;
+        } else {
+            if (nowMs < m_nextAttemptMs) {
+                recordFailure(frame, timer.nsecsElapsed(), QString(), QString());
+                return false;
+            }
+            pipeline =
+                std::make_unique<MpegTsEncoderPipeline>(m_config, m_endpoint, m_rate, &m_abort);
+            if (!pipeline->open(video.width, video.height, frame.audio.channels, &error)) {
+                m_nextAttemptMs = nowMs + kRetryIntervalMs;
+                recordFailure(frame, timer.nsecsElapsed(), QStringLiteral("encoder-failed"),
+                              error);
+                return false;
+            }
+            if (m_endpoint.isSrtListener) {
+                startListening(std::move(pipeline));
+                recordFailure(frame, timer.nsecsElapsed(), QStringLiteral("listening"),
+                              QStringLiteral("waiting for an SRT caller on %1")
+                                  .arg(m_endpoint.url));
+                return false;
+            }
+            if (!pipeline->connect(&error)) pipeline.reset();
+        }
+        if (!pipeline) {
+            m_nextAttemptMs = nowMs + kRetryIntervalMs;
+            recordFailure(frame, timer.nsecsElapsed(), QStringLiteral("connecting"), error);
+            return false;
+        }
+        m_pipeline = std::move(pipeline);
+        m_connections++;
+    }
+
+    QString error;
+    if (!m_pipeline->encode(frame, video, &error)) {
+        m_pipeline.reset();
+        m_nextAttemptMs = nowMs + kRetryIntervalMs;
+        recordFailure(frame, timer.nsecsElapsed(), QStringLiteral("reconnecting"), error);
+        return false;
+    }
+    recordSuccess(frame, timer.nsecsElapsed());
+    return true;
+}
+
+// The listener's accept runs here rather than on the encoder thread, so the port stays
+// bound until a caller arrives (or stop()) instead of closing after every bounded attempt.
+void MpegTsStreamOutputSink::startListening(std::unique_ptr<MpegTsEncoderPipeline> pipeline) {
+    m_listening = std::move(pipeline);
+    m_listenOk = false;
+    m_listenError.clear();
+    m_listenerDone.store(false, std::memory_order_relaxed);
+    m_listener = std::thread([this] {
+        PipelineTrace::setThreadName(QStringLiteral("mpegts listener"));
+        m_listenOk = m_listening->connect(&m_listenError);
+        m_listenerDone.store(true, std::memory_order_release);
+    });
+}
+
+OutputSinkStatus MpegTsStreamOutputSink::outputStatus() const {
+    QMutexLocker locker(&m_statusMutex);
+    return m_status;
+}
+
+void MpegTsStreamOutputSink::setStatus(const QString& state, const QString& message) {
+    QMutexLocker locker(&m_statusMutex);
+    m_status.state = state;
+    m_status.message = message;
+}
+
+void MpegTsStreamOutputSink::recordFailure(const OutputBusFrame& frame, qint64 submitNs,
+                                           const QString& state, const QString& message) {
+    QMutexLocker locker(&m_statusMutex);
+    m_status.failedFrames++;
+    m_status.lastSubmitDurationNs = submitNs;
+    m_status.hasLastResult = true;
+    m_status.lastResultSucceeded = false;
+    m_status.hasLastQueuedFrameIndex = true;
+    m_status.lastQueuedFrameIndex = frame.outputFrameIndex;
+    // Frames refused during the retry backoff keep the state of the attempt that failed.
+    if (!state.isEmpty()) m_status.state = state;
+    if (!message.isEmpty()) m_status.message = message;
+}
+
+void MpegTsStreamOutputSink::recordSuccess(const OutputBusFrame& frame, qint64 submitNs) {
+    const qint64 latencyNs = m_pipeline->lastEncodeLatencyNs();
+    const QString message = QStringLiteral("%1 stream to %2 (%3 kB sent, connection %4)")
+                                .arg(videoCodecToString(m_config.videoCodec), m_endpoint.url)
+                                .arg(m_pipeline->bytesSent() / 1024)
+                                .arg(m_connections);
+    QMutexLocker locker(&m_statusMutex);
+    m_status.acceptedFrames++;
+    m_status.lastSubmitDurationNs = submitNs;
+    m_status.encodeLatencyNs = latencyNs;
+    m_status.maxEncodeLatencyNs = qMax(m_status.maxEncodeLatencyNs, latencyNs);
+    m_status.hasLastResult = true;
+    m_status.lastResultSucceeded = true;
+    m_status.hasLastQueuedFrameIndex = true;
+    m_status.lastQueuedFrameIndex = frame.outputFrameIndex;
+    m_status.hasLastDeliveredFrameIndex = true;
+    m_status.lastDeliveredFrameIndex = frame.outputFrameIndex;
+    m_status.state = QStringLiteral("active");
+    m_status.message = message;
+}
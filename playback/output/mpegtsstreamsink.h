@@ -0,0 +1,97 @@
+#ifndef MPEGTSSTREAMSINK_H
+#define MPEGTSSTREAMSINK_H
+
+#include "playback/output/outputsink.h"
+#include "recorder_engine/codec/videocodecchoice.h"
+
+#include <QMap>
+#include <QMutex>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+// Settings of an "mpegts-stream" output target, read from OutputTargetAssignment::settings.
+struct MpegTsStreamConfig {
+    static constexpr int kDefaultVideoBitrate = 15'000'000;
+    static constexpr int kDefaultAudioBitrate = 192'000;
+    static constexpr int kDefaultLatencyMs = 120;
+
+    // "url": srt://host:port?mode=caller|listener|rendezvous&passphrase=..&pbkeylen=..&streamid=..
+    // or udp://host:port.
+    QString url;
+    // "videoCodec": "mpeg2" (software, default) or "h264" (hardware only, never software).
+    VideoCodecChoice videoCodec = VideoCodecChoice::Mpeg2Software;
+    int videoBitrate = kDefaultVideoBitrate; // "videoBitrate", bit/s
+    int audioBitrate = kDefaultAudioBitrate; // "audioBitrate", bit/s (AAC)
+    int gopFrames = 0;                       // "gopFrames"; 0 = one second at the bus rate
+    int latencyMs = kDefaultLatencyMs;       // "latencyMs"; SRT receive latency
+
+    static MpegTsStreamConfig fromAssignment(const OutputTargetAssignment& assignment);
+};
+
+// Where an "mpegts-stream" target sends: the bare protocol URL plus the FFmpeg protocol
+// options it is opened with. Passphrase and stream id travel as options rather than URL
+// query items, so characters like '&' or '=' in them survive.
+struct MpegTsStreamEndpoint {
+    QString url;
+    QMap<QString, QString> options;
+    bool isSrt = false;
+    bool isSrtListener = false;
+};
+
+// Validates `config.url` and derives the endpoint. srt:// URLs go through the same query
+// parsing and passphrase / pbkeylen rules as SRT ingest, so a too-short passphrase is
+// rejected instead of silently sending unencrypted.
+bool mpegTsStreamEndpointFor(const MpegTsStreamConfig& config, MpegTsStreamEndpoint* endpoint,
+                             QString* error);
+
+class MpegTsEncoderPipeline;
+
+// Encodes a bus (video to MPEG-2 or hardware H.264, audio to AAC), muxes MPEG-TS and sends
+// it over SRT or UDP. Meant to run behind QueuedOutputSink, whose worker thread becomes the
+// encoder thread. The transport is opened from that thread on the first frame and reopened
+// after a failure with a one-second backoff, so start() never waits for an SRT peer; frames
+// submitted while disconnected fail fast with state "connecting". An SRT listener instead
+// waits for its caller on a thread of its own, bound the whole time (state "listening").
+class MpegTsStreamOutputSink final : public IOutputSink {
+public:
+    static constexpr int kRetryIntervalMs = 1000;
+
+    MpegTsStreamOutputSink();
+    ~MpegTsStreamOutputSink() override;
+
+    OutputTargetKind kind() const override { return OutputTargetKind::MpegTsStream; }
+    bool start(const OutputTargetAssignment& assignment, FrameRate rate) override;
+    void stop() override;
+    bool isActive() const override { return m_active; }
+    bool submit(const OutputBusFrame& frame) override;
+    OutputSinkStatus outputStatus() const override;
+
+private:
+    void setStatus(const QString& state, const QString& message);
+    void recordFailure(const OutputBusFrame& frame, qint64 submitNs, const QString& state,
+                       const QString& message);
+    void recordSuccess(const OutputBusFrame& frame, qint64 submitNs);
+    void startListening(std::unique_ptr<MpegTsEncoderPipeline> pipeline);
+
+    MpegTsStreamConfig m_config;
+    MpegTsStreamEndpoint m_endpoint;
+    FrameRate m_rate;
+    bool m_active = false;
+    std::atomic<bool> m_abort{false};
+    std::unique_ptr<MpegTsEncoderPipeline> m_pipeline;
+    // SRT listener: m_listening and its result are m_listener's until m_listenerDone, then
+    // handed over (or dropped with m_listenError) on the encoder thread after the join.
+    std::thread m_listener;
+    std::atomic<bool> m_listenerDone{false};
+    std::unique_ptr<MpegTsEncoderPipeline> m_listening;
+    bool m_listenOk = false;
+    QString m_listenError;
+    qint64 m_nextAttemptMs = 0;
+    qint64 m_connections = 0;
+    mutable QMutex m_statusMutex;
+    OutputSinkStatus m_status;
+};
+
+#endif // MPEGTSSTREAMSINK_H
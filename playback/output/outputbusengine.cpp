@@ -168,6 +168,7 @@ OutputBusFrame OutputBusEngine::renderMultiview(qint64 outputFrameIndex,
     sources.reserve(m_feedCount);
     qint64 sourcePtsMs = 0;
     uint64_t sourceGpuGeneration = 0;
+    PlaybackFrameStamps sourceStamps; // the newest tile's, so latency follows fresh content
     bool anySourcePresent = false;
     for (int feed = 0; feed < m_feedCount; ++feed) {
         const std::optional<FrameHandle> src =
@@ -183,6 +184,9 @@ OutputBusFrame OutputBusEngine::renderMultiview(qint64 outputFrameIndex,
         sourceSignature = hashInt(sourceSignature, qint64(generation));
         sourceSignature = hashInt(sourceSignature, src ? 0 : 1);
         if (src) {
+            if (!anySourcePresent || src->metadata().key.ptsMs >= sourcePtsMs) {
+                sourceStamps = src->metadata().stamps;
+            }
             anySourcePresent = true;
             sourcePtsMs = qMax(sourcePtsMs, src->metadata().key.ptsMs);
             sourceGpuGeneration = qMax(sourceGpuGeneration, generation);
@@ -229,6 +233,7 @@ OutputBusFrame OutputBusEngine::renderMultiview(qint64 outputFrameIndex,
     out.video.metadata().gpuGeneration =
         out.video.isGpuBacked() ? state.gpuGeneration : sourceGpuGeneration;
     out.video.metadata().outputFrameIndex = outputFrameIndex;
+    out.video.metadata().stamps = sourceStamps;
 
     out.audio = renderAudioForFeed(state.selectedFeedIndex, outputFrameIndex, state, cache, true);
     out.identity = outputFrameIdentityFor(out);
@@ -263,6 +268,7 @@ OutputBusFrame OutputBusEngine::renderSingleSource(OutputBusId bus, int feedInde
                 gpu.metadata().key.ptsMs = sourceMeta.key.ptsMs;
                 gpu.metadata().key.isPlaceholder = sourceMeta.key.isPlaceholder;
                 gpu.metadata().gpuGeneration = state.gpuGeneration;
+                gpu.metadata().stamps = sourceMeta.stamps;
                 out.video = gpu;
             }
         }
@@ -56,6 +56,9 @@ struct OutputBusFrame {
     // backward/duplicate values. (The normal output path keeps identity-skip on, so a held
     // paused frame is not re-emitted with a repeating timecode.)
     qint64 programmeTimecode100ns = -1;
+    // PipelineTrace::nowNs() when the dispatcher handed the frame to this target's submit();
+    // 0 when submitted directly. Lets a queued sink time its own latency from submit.
+    qint64 submitNs = 0;
     FrameHandle video;
     MediaAudioFrame audio;
     OutputFrameIdentity identity;
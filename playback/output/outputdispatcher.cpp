@@ -7,9 +7,13 @@
 #endif
 #include "playback/output/gpureadbacktelemetry.h"
 #include "playback/output/outputframeclock.h"
+#include "recorder_engine/pipelinetrace.h"
 
+#include <QElapsedTimer>
 #include <QHash>
 
+#include <utility>
+
 namespace {
 
 QString targetStatsKey(const OutputTargetAssignment& assignment) {
@@ -21,6 +25,20 @@ QString targetStatsKey(const OutputTargetAssignment& assignment) {
         .arg(assignment.sourceBus.index);
 }
 
+// Trace names must be literals, so the bus kind picks the event name and the index rides
+// along as its argument.
+const char* renderTraceName(OutputBusKind kind) {
+    switch (kind) {
+    case OutputBusKind::Feed:
+        return "render feed";
+    case OutputBusKind::Multiview:
+        return "render multiview";
+    case OutputBusKind::Pgm:
+        return "render pgm";
+    }
+    return "render feed";
+}
+
 bool isSilentAudio(const MediaAudioFrame& audio) {
     for (const char sample : audio.pcm) {
         if (sample != '\0') return false;
@@ -31,8 +49,9 @@ bool isSilentAudio(const MediaAudioFrame& audio) {
 bool hasMeaningfulSinkStatus(const OutputSinkStatus& status) {
     return status.acceptedFrames > 0 || status.failedFrames > 0 || status.droppedFrames > 0 ||
            status.currentQueueDepth > 0 || status.maxQueueDepth > 0 || status.deliveryGaps > 0 ||
-           status.lastSubmitDurationNs > 0 || status.hasLastResult || status.queuePressure ||
-           status.lastSubmitDroppedFrame || status.lastDeliveryGap ||
+           status.lastSubmitDurationNs > 0 || status.maxEncodeLatencyNs > 0 ||
+           status.hasLastResult || status.queuePressure || status.lastSubmitDroppedFrame ||
+           status.lastDeliveryGap ||
            status.hasLastQueuedFrameIndex || status.hasLastDeliveredFrameIndex ||
            !status.state.isEmpty() || !status.message.isEmpty();
 }
@@ -65,6 +84,15 @@ void OutputDispatcher::setEndpoints(const QList<OutputEndpoint>& endpoints) {
 
     m_endpoints = endpoints;
     m_multiviewMemo = MultiviewComposite{};
+    const QSet<QString> keys = endpointTargetKeys();
+    for (auto it = m_targetLatency.begin(); it != m_targetLatency.end();) {
+        if (keys.contains(it.key())) ++it;
+        else it = m_targetLatency.erase(it);
+    }
+    for (auto it = m_lastCountedDemuxNs.begin(); it != m_lastCountedDemuxNs.end();) {
+        if (keys.contains(it.key())) ++it;
+        else it = m_lastCountedDemuxNs.erase(it);
+    }
     for (const OutputEndpoint& endpoint : m_endpoints) {
         if (!endpoint.sink || !endpoint.assignment.enabled) continue;
         if (endpoint.sink->kind() != endpoint.assignment.kind) continue;
@@ -74,6 +102,14 @@ void OutputDispatcher::setEndpoints(const QList<OutputEndpoint>& endpoints) {
     }
 }
 
+QSet<QString> OutputDispatcher::endpointTargetKeys() const {
+    QSet<QString> keys;
+    for (const OutputEndpoint& endpoint : m_endpoints) {
+        keys.insert(targetStatsKey(endpoint.assignment));
+    }
+    return keys;
+}
+
 void OutputDispatcher::resetFrameIndex(qint64 nextOutputFrameIndex) {
     m_nextOutputFrameIndex = qMax<qint64>(0, nextOutputFrameIndex);
     m_havePlayEpoch = false;
@@ -101,12 +137,29 @@ OutputDispatchStats OutputDispatcher::dispatchTick(const OutputFrameCache& cache
     const qint64 outputFrameIndex = m_nextOutputFrameIndex++;
     const PlaybackStateSnapshot tickState = clockedStateForTick(outputFrameIndex, state);
     QHash<OutputBusId, OutputBusFrame> rendered;
+    QHash<OutputBusId, qint64> dispatchedNs;
+    OutputDispatchTickTiming timing;
+    QElapsedTimer stageTimer;
+
+    // The last endpoint fed from each bus takes the rendered frame by move; earlier ones copy.
+    const auto isLive = [](const OutputEndpoint& endpoint) {
+        return endpoint.assignment.enabled && endpoint.sink && endpoint.sink->isActive();
+    };
+    QHash<OutputBusId, qsizetype> lastConsumer;
+    for (qsizetype i = 0; i < m_endpoints.size(); ++i) {
+        const OutputEndpoint& endpoint = m_endpoints.at(i);
+        if (isLive(endpoint)) lastConsumer.insert(endpoint.assignment.sourceBus, i);
+    }
 
-    for (const OutputEndpoint& endpoint : m_endpoints) {
-        if (!endpoint.assignment.enabled || !endpoint.sink || !endpoint.sink->isActive()) continue;
+    for (qsizetype endpointIndex = 0; endpointIndex < m_endpoints.size(); ++endpointIndex) {
+        const OutputEndpoint& endpoint = m_endpoints.at(endpointIndex);
+        if (!isLive(endpoint)) continue;
 
         const OutputBusId bus = endpoint.assignment.sourceBus;
         if (!rendered.contains(bus)) {
+            stageTimer.start();
+            dispatchedNs.insert(bus, PipelineTrace::nowNs());
+            PipelineTraceScope renderTrace("output", renderTraceName(bus.kind), "index", bus.index);
             OutputBusFrame frame = renderBus(bus, outputFrameIndex, tickState, cache);
             if (m_holdLastFrame && frame.video.metadata().key.isPlaceholder &&
                 m_lastGoodFrame.contains(bus)) {
@@ -140,9 +193,10 @@ OutputDispatchStats OutputDispatcher::dispatchTick(const OutputFrameCache& cache
                 const qint64 ad = d < 0 ? -d : d;
                 if (ad > m_stats.maxClockDivergenceMs) m_stats.maxClockDivergenceMs = ad;
             }
+            timing.renderNs += stageTimer.nsecsElapsed();
         }
 
-        const OutputBusFrame frame = rendered.value(bus);
+        OutputBusFrame& frame = rendered[bus];
 
         // Identity-skip: if this endpoint already received a byte-identical
         // payload, skip the submit (and the sink's map/copy/deliver entirely).
@@ -154,10 +208,26 @@ OutputDispatchStats OutputDispatcher::dispatchTick(const OutputFrameCache& cache
             continue;
         }
 
-        const bool submitted = endpoint.sink->submit(frame);
-        countTargetAttempt(endpoint.assignment, frame, submitted);
+        // Everything read from the frame is read before a move-in submit empties it.
+        countTargetFrame(endpoint.assignment, frame);
+        frame.submitNs = PipelineTrace::nowNs();
+        const PlaybackFrameStamps stamps = frame.video.metadata().stamps;
+        stageTimer.start();
+        bool submitted = false;
+        {
+            PipelineTraceScope trace("output", "sink submit", "target",
+                                     qint64(endpoint.assignment.kind));
+            if (lastConsumer.value(bus) == endpointIndex)
+                submitted = endpoint.sink->submit(std::move(frame));
+            else
+                submitted = endpoint.sink->submit(std::as_const(frame));
+        }
+        timing.sinkSubmitNs += stageTimer.nsecsElapsed();
+        countTargetAttempt(endpoint.assignment, submitted);
         if (submitted) {
             m_stats.framesSubmitted++;
+            countTargetLatency(endpoint.assignment, stamps, dispatchedNs.value(bus),
+                               PipelineTrace::nowNs());
         } else {
             m_stats.sinkFailures++;
         }
@@ -167,6 +237,11 @@ OutputDispatchStats OutputDispatcher::dispatchTick(const OutputFrameCache& cache
     m_stats.gpuReadbacks = gpu.gpuReadbacks;
     m_stats.redundantGpuReadbacks = gpu.redundantReadbacks;
 
+    m_lastTickTiming = timing;
+    m_lastTick.outputFrameIndex = outputFrameIndex;
+    m_lastTick.sampledPlayheadMs =
+        OutputFrameClock(m_rate).samplePlayheadMsForOutputTick(outputFrameIndex, tickState);
+    m_lastTick.state = tickState;
     m_stats.ticks++;
     return m_stats;
 }
@@ -193,6 +268,8 @@ OutputDispatchStats OutputDispatcher::stats() const {
         target.lastQueuedFrameIndex = sinkStatus.lastQueuedFrameIndex;
         target.lastDeliveredFrameIndex = sinkStatus.lastDeliveredFrameIndex;
         target.lastSubmitDurationNs = sinkStatus.lastSubmitDurationNs;
+        target.encodeLatencyNs = sinkStatus.encodeLatencyNs;
+        target.maxEncodeLatencyNs = sinkStatus.maxEncodeLatencyNs;
         target.queuePressure = sinkStatus.queuePressure;
         target.lastSubmitDroppedFrame = sinkStatus.lastSubmitDroppedFrame;
         target.lastDeliveryGap = sinkStatus.lastDeliveryGap;
@@ -261,7 +338,7 @@ void OutputDispatcher::countTargetStartFailure(const OutputTargetAssignment& ass
 }
 
 void OutputDispatcher::countTargetAttempt(const OutputTargetAssignment& assignment,
-                                          const OutputBusFrame& frame, bool submitted) {
+                                          bool submitted) {
     OutputTargetDispatchStats& stats = m_stats.targets[targetStatsKey(assignment)];
     stats.attemptedFrames++;
     if (submitted) {
@@ -271,6 +348,11 @@ void OutputDispatcher::countTargetAttempt(const OutputTargetAssignment& assignme
     }
     stats.hasLastSubmitResult = true;
     stats.lastSubmitSucceeded = submitted;
+}
+
+void OutputDispatcher::countTargetFrame(const OutputTargetAssignment& assignment,
+                                        const OutputBusFrame& frame) {
+    OutputTargetDispatchStats& stats = m_stats.targets[targetStatsKey(assignment)];
     if (frame.video.metadata().key.isPlaceholder) stats.placeholderFrames++;
     if (isSilentAudio(frame.audio)) stats.silentAudioFrames++;
     if (stats.hasLastIdentity && stats.lastIdentity.samePayloadAs(frame.identity)) {
@@ -279,3 +361,24 @@ void OutputDispatcher::countTargetAttempt(const OutputTargetAssignment& assignme
     stats.lastIdentity = frame.identity;
     stats.hasLastIdentity = true;
 }
+
+void OutputDispatcher::countTargetLatency(const OutputTargetAssignment& assignment,
+                                          const PlaybackFrameStamps& stamps, qint64 dispatchedNs,
+                                          qint64 submittedNs) {
+    // Placeholders and pre-staged frames carry no stamps.
+    if (stamps.demuxedNs <= 0) return;
+    const QString key = targetStatsKey(assignment);
+    qint64& lastCountedDemuxNs = m_lastCountedDemuxNs[key];
+    if (lastCountedDemuxNs == stamps.demuxedNs) return;
+    lastCountedDemuxNs = stamps.demuxedNs;
+    OutputTargetLatency& latency = m_targetLatency[key];
+
+    const auto span = [](LatencyHistogram& histogram, qint64 fromNs, qint64 toNs) {
+        if (fromNs > 0 && toNs >= fromNs) histogram.record(toNs - fromNs);
+    };
+    span(latency.demuxToDecodedNs, stamps.demuxedNs, stamps.decodedNs);
+    span(latency.decodedToCachedNs, stamps.decodedNs, stamps.cachedNs);
+    span(latency.cachedToDispatchedNs, stamps.cachedNs, dispatchedNs);
+    span(latency.dispatchedToSubmittedNs, dispatchedNs, submittedNs);
+    span(latency.totalNs, stamps.demuxedNs, submittedNs);
+}
@@ -1,10 +1,12 @@
 #ifndef OUTPUTDISPATCHER_H
 #define OUTPUTDISPATCHER_H
 
+#include "playback/output/latencyhistogram.h"
 #include "playback/output/outputsink.h"
 
 #include <QHash>
 #include <QList>
+#include <QSet>
 #include <QString>
 
 #include <memory>
@@ -30,6 +32,8 @@ struct OutputTargetDispatchStats {
     qint64 lastQueuedFrameIndex = -1;
     qint64 lastDeliveredFrameIndex = -1;
     qint64 lastSubmitDurationNs = 0;
+    qint64 encodeLatencyNs = 0;
+    qint64 maxEncodeLatencyNs = 0;
     bool queuePressure = false;
     bool lastSubmitDroppedFrame = false;
     bool lastDeliveryGap = false;
@@ -62,6 +66,40 @@ struct OutputRuntimeDispatchStats {
     qint64 cappedCatchUpTicks = 0;
     bool lastDispatchDeadlineMiss = false;
     qint64 lastCappedCatchUpTicks = 0;
+    // Per-tick lateness distribution since the runtime started (ticks dispatched early or on
+    // time count as 0), from a log-linear histogram (within 12.5% above the true value).
+    // OutputRuntime fills the percentiles here and below when stats are read or published.
+    qint64 latenessP50Ns = 0;
+    qint64 latenessP99Ns = 0;
+    qint64 latenessP999Ns = 0;
+    // Where a tick's time goes: taking the snapshot, rendering the buses, and the sink
+    // submit() calls. Last tick, and p99 since the runtime started.
+    qint64 lastSnapshotNs = 0;
+    qint64 snapshotP99Ns = 0;
+    qint64 lastRenderNs = 0;
+    qint64 renderP99Ns = 0;
+    qint64 lastSinkSubmitNs = 0;
+    qint64 sinkSubmitP99Ns = 0;
+    // Scheduling the dispatch thread actually obtained (OutputRuntimeSchedulingOptions).
+    bool absoluteDeadlineSleep = false;
+    bool realtimePriority = false;
+    bool memoryLocked = false;
+    bool cpuPinned = false;
+    QString schedulingError;
+};
+
+// Time one dispatchTick spent rendering buses and inside sink submit() calls.
+struct OutputDispatchTickTiming {
+    qint64 renderNs = 0;
+    qint64 sinkSubmitNs = 0;
+};
+
+// What the last dispatchTick played out: its output frame index, the playhead the output
+// clock sampled for it, and the state clocked for that tick.
+struct OutputDispatchedTick {
+    qint64 outputFrameIndex = -1;
+    qint64 sampledPlayheadMs = 0;
+    PlaybackStateSnapshot state;
 };
 
 struct OutputDispatchStats {
@@ -88,6 +126,18 @@ struct OutputDispatchStats {
     QHash<QString, OutputTargetDispatchStats> targets;
 };
 
+// Disk-to-output latency of the frames one target received, split at the stamps the frame
+// carries (PlaybackFrameStamps) plus the tick that rendered it and the return of the sink's
+// submit(). A frame counts once per target, on its first successful submit: held and
+// repeated frames are the same content again, not new latency.
+struct OutputTargetLatency {
+    LatencyHistogram demuxToDecodedNs;
+    LatencyHistogram decodedToCachedNs;
+    LatencyHistogram cachedToDispatchedNs;
+    LatencyHistogram dispatchedToSubmittedNs;
+    LatencyHistogram totalNs; // demuxed -> submitted
+};
+
 class OutputDispatcher {
 public:
     OutputDispatcher(FrameRate rate, int feedCount, int width, int height);
@@ -111,6 +161,18 @@ public:
     OutputDispatchStats dispatchTick(const OutputFrameCache& cache,
                                      const PlaybackStateSnapshot& state);
     OutputDispatchStats stats() const;
+    OutputDispatchTickTiming lastTickTiming() const { return m_lastTickTiming; }
+    const OutputDispatchedTick& lastTick() const { return m_lastTick; }
+    // Kept apart from stats() so the per-tick stats copy stays cheap. Holds the samples since
+    // the last swapTargetLatency; setEndpoints drops targets that are no longer configured.
+    const QHash<QString, OutputTargetLatency>& targetLatency() const { return m_targetLatency; }
+    // Hands the samples gathered so far to the caller in O(1), taking `latency` (typically the
+    // caller's drained, reset histograms) to record into next.
+    void swapTargetLatency(QHash<QString, OutputTargetLatency>& latency) {
+        m_targetLatency.swap(latency);
+    }
+    // The stats keys of the configured endpoints (assignment id, or kind and bus without one).
+    QSet<QString> endpointTargetKeys() const;
     FrameRate frameRate() const { return m_rate; }
 
 private:
@@ -120,8 +182,11 @@ private:
                                               const PlaybackStateSnapshot& state);
     void countFrameHealth(const OutputBusFrame& frame);
     void countTargetStartFailure(const OutputTargetAssignment& assignment);
-    void countTargetAttempt(const OutputTargetAssignment& assignment, const OutputBusFrame& frame,
-                            bool submitted);
+    void countTargetFrame(const OutputTargetAssignment& assignment, const OutputBusFrame& frame);
+    void countTargetAttempt(const OutputTargetAssignment& assignment, bool submitted);
+    void countTargetLatency(const OutputTargetAssignment& assignment,
+                            const PlaybackFrameStamps& stamps, qint64 dispatchedNs,
+                            qint64 submittedNs);
 
     FrameRate m_rate;
     int m_feedCount = 0;
@@ -132,6 +197,10 @@ private:
     bool m_havePlayEpoch = false;
     PlaybackStateSnapshot m_playEpoch;
     OutputDispatchStats m_stats;
+    OutputDispatchTickTiming m_lastTickTiming;
+    OutputDispatchedTick m_lastTick;
+    QHash<QString, OutputTargetLatency> m_targetLatency;
+    QHash<QString, qint64> m_lastCountedDemuxNs; // per target; survives swapTargetLatency
     MultiviewComposite m_multiviewMemo;
     std::shared_ptr<GpuRhiContext> m_gpuRhi;
     std::shared_ptr<GpuCompositor> m_gpuCompositor;
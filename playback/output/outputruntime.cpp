@@ -1,13 +1,150 @@
 #include "playback/output/outputruntime.h"
 
+#include "recorder_engine/pipelinetrace.h"
+#include "recorder_engine/threadplacement.h"
+#include "recorder_engine/timing/smpte12m.h"
+
+#include <QByteArray>
+#include <QDebug>
 #include <QElapsedTimer>
+#include <QStringList>
 #include <cmath>
+#include <optional>
 #include <utility>
 
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#endif
+
 namespace {
 constexpr qint64 kNsPerSecond = 1000000000;
+// The dispatch thread sleeps to the next tick's absolute deadline, but never longer than
+// this in one go, so a stop or a frame-index reset (which re-anchors the clock) is noticed
+// promptly.
+constexpr qint64 kMaxSleepNs = 4000000;
+constexpr qint64 kIdleSleepNs = 1000000;
+
+// Adds the samples in `from` to `into` and empties `from` for reuse.
+void drainTargetLatency(OutputTargetLatency& into, OutputTargetLatency& from) {
+    const auto drain = [](LatencyHistogram& to, LatencyHistogram& histogram) {
+        to.merge(histogram);
+        histogram.reset();
+    };
+    drain(into.demuxToDecodedNs, from.demuxToDecodedNs);
+    drain(into.decodedToCachedNs, from.decodedToCachedNs);
+    drain(into.cachedToDispatchedNs, from.cachedToDispatchedNs);
+    drain(into.dispatchedToSubmittedNs, from.dispatchedToSubmittedNs);
+    drain(into.totalNs, from.totalNs);
+}
+
+void dropRemovedTargets(QHash<QString, OutputTargetLatency>& latency,
+                        const QSet<QString>& keys) {
+    for (auto it = latency.begin(); it != latency.end();) {
+        if (keys.contains(it.key())) ++it;
+        else it = latency.erase(it);
+    }
+}
+
+#if defined(Q_OS_LINUX)
+// Stack below the run loop's frame that a tick (snapshot, render, sink submits) may touch.
+constexpr quintptr kLockedStackBytes = 256 * 1024;
+
+qint64 monotonicNowNs() {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return qint64(now.tv_sec) * kNsPerSecond + now.tv_nsec;
+}
+
+void sleepUntilNs(qint64 deadlineNs) {
+    timespec deadline{};
+    deadline.tv_sec = time_t(deadlineNs / kNsPerSecond);
+    deadline.tv_nsec = long(deadlineNs % kNsPerSecond);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {
+    }
+}
+
+QString errnoText(int error) {
+    return QString::fromLocal8Bit(std::strerror(error));
+}
+
+bool lockThreadStack(QString* error) {
+    pthread_attr_t attr;
+    const int rc = pthread_getattr_np(pthread_self(), &attr);
+    if (rc != 0) {
+        *error = errnoText(rc);
+        return false;
+    }
+    void* stackAddress = nullptr;
+    size_t stackSize = 0;
+    pthread_attr_getstack(&attr, &stackAddress, &stackSize);
+    pthread_attr_destroy(&attr);
+
+    // The stack grows down towards stackAddress; lock from a working depth below this
+    // frame up to the top, which also faults those pages in now instead of mid-tick.
+    const quintptr bottom = quintptr(stackAddress);
+    const quintptr top = bottom + stackSize;
+    const quintptr here = quintptr(&stackAddress);
+    const quintptr pageMask = ~(quintptr(sysconf(_SC_PAGESIZE)) - 1);
+    const quintptr begin =
+        (here - bottom > kLockedStackBytes ? here - kLockedStackBytes : bottom) & pageMask;
+    if (mlock(reinterpret_cast<void*>(begin), top - begin) != 0) {
+        *error = errnoText(errno);
+        return false;
+    }
+    return true;
+}
+
+int highestAllowedCpu() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) return -1;
+    for (int cpu = CPU_SETSIZE - 1; cpu >= 0; --cpu) {
+        if (CPU_ISSET(cpu, &set)) return cpu;
+    }
+    return -1;
+}
+#else
+qint64 monotonicNowNs() {
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+void sleepUntilNs(qint64 deadlineNs) {
+    const qint64 remainingNs = deadlineNs - monotonicNowNs();
+    if (remainingNs > 0) QThread::usleep(quint64(remainingNs / 1000));
+}
+#endif
 } // namespace
 
+OutputRuntimeSchedulingOptions OutputRuntimeSchedulingOptions::fromEnvironment() {
+    OutputRuntimeSchedulingOptions options;
+    bool ok = false;
+    const int priority = qEnvironmentVariableIntValue("OLR_OUTPUT_RT_PRIORITY", &ok);
+    if (ok && priority > 0) options.realtimePriority = qMin(priority, 99);
+    options.lockMemory = qEnvironmentVariableIntValue("OLR_OUTPUT_MLOCK") > 0;
+    const QByteArray cpus = qgetenv("OLR_OUTPUT_CPUS").trimmed().toLower();
+    if (cpus == "last") {
+        options.reserveLastCpu = true;
+    } else if (!cpus.isEmpty()) {
+        for (const QByteArray& part : cpus.split(',')) {
+            const int cpu = part.trimmed().toInt(&ok);
+            if (ok && cpu >= 0 && !options.cpus.contains(cpu)) options.cpus.append(cpu);
+        }
+    }
+    return options;
+}
+
 OutputRuntime::OutputRuntime(FrameRate rate, int feedCount, int width, int height)
     : m_dispatcher(rate, feedCount, width, height) {}
 
@@ -20,9 +157,24 @@ void OutputRuntime::setSnapshotProvider(SnapshotProvider provider) {
     m_snapshotProvider = std::move(provider);
 }
 
+void OutputRuntime::setSchedulingOptions(const OutputRuntimeSchedulingOptions& options) {
+    QMutexLocker locker(&m_mutex);
+    m_schedulingOptions = options;
+}
+
+void OutputRuntime::setTransportStreamOptions(const TransportStreamOptions& options) {
+    QMutexLocker locker(&m_mutex);
+    m_transportOptions = options;
+    m_transportOptionsChanged = true;
+}
+
 void OutputRuntime::setEndpoints(const QList<OutputEndpoint>& endpoints) {
     QMutexLocker locker(&m_mutex);
     m_dispatcher.setEndpoints(endpoints);
+    const QSet<QString> keys = m_dispatcher.endpointTargetKeys();
+    QMutexLocker publishedLocker(&m_publishedMutex);
+    dropRemovedTargets(m_published.targetLatency, keys);
+    dropRemovedTargets(m_pendingTargetLatency, keys);
 }
 
 void OutputRuntime::setIdentitySkip(bool enabled) {
@@ -35,7 +187,9 @@ void OutputRuntime::startRuntime() {
         QMutexLocker locker(&m_mutex);
         m_stopRequested = false;
         m_wallStartNs = -1;
+        m_lastPublishNs = -1;
         m_dispatcher.resetFrameIndex();
+        resetTimingHistograms();
     }
     if (!isRunning()) start();
 }
@@ -69,16 +223,18 @@ void OutputRuntime::incrementFenceWaitStalls() {
 }
 
 OutputDispatchStats OutputRuntime::dispatchDueTicksForTest(qint64 wallNowMs) {
-    return dispatchDueTicksNs(wallNowMs * kNsPerSecond / 1000);
+    dispatchDueTicksNs(wallNowMs * kNsPerSecond / 1000);
+    return stats();
 }
 
 OutputDispatchStats OutputRuntime::dispatchDueTicksForTestNs(qint64 wallNowNs) {
-    return dispatchDueTicksNs(wallNowNs);
+    dispatchDueTicksNs(wallNowNs);
+    return stats();
 }
 
 OutputDispatchStats OutputRuntime::stats() const {
     QMutexLocker locker(&m_mutex);
-    return m_dispatcher.stats();
+    return statsWithPercentiles();
 }
 
 qint64 OutputRuntime::dispatcherNextOutputFrameIndex() const {
@@ -92,17 +248,99 @@ qint64 OutputRuntime::outputFrameForPlayheadMs(qint64 playheadMs) const {
 }
 
 void OutputRuntime::run() {
-    QElapsedTimer timer;
-    timer.start();
+    PipelineTrace::setThreadName(QStringLiteral("output runtime"));
+    applySchedulingOptions();
 
     while (true) {
         {
             QMutexLocker locker(&m_mutex);
             if (m_stopRequested) break;
         }
-        dispatchDueTicksNs(timer.nsecsElapsed());
-        QThread::msleep(1);
+        dispatchDueTicksNs(monotonicNowNs());
+        const qint64 nowNs = monotonicNowNs();
+        const qint64 deadlineNs = nextDeadlineNs();
+        sleepUntilNs(deadlineNs < 0 ? nowNs + kIdleSleepNs : qMin(deadlineNs, nowNs + kMaxSleepNs));
     }
+
+    // The socket belongs to this thread; a restart reopens it on the new one.
+    m_transportStream.close();
+    QMutexLocker locker(&m_mutex);
+    m_transportOptionsChanged = true;
+}
+
+qint64 OutputRuntime::nextDeadlineNs() const {
+    QMutexLocker locker(&m_mutex);
+    const FrameRate rate = m_dispatcher.frameRate();
+    if (m_wallStartNs < 0 || !rate.isValid()) return -1;
+    return m_wallStartNs + frameIndexToNsCeil(rate, m_dispatcher.nextOutputFrameIndex());
+}
+
+void OutputRuntime::applySchedulingOptions() {
+    OutputRuntimeSchedulingOptions options;
+    {
+        QMutexLocker locker(&m_mutex);
+        options = m_schedulingOptions;
+    }
+
+    bool realtime = false;
+    bool locked = false;
+    bool pinned = false;
+    QStringList errors;
+#if defined(Q_OS_LINUX)
+    // Ticks are slept to with clock_nanosleep; drop the default 50 us timer slack that would
+    // otherwise be added to every wake-up.
+    prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+    if (options.realtimePriority > 0) {
+        sched_param param{};
+        param.sched_priority = qBound(sched_get_priority_min(SCHED_FIFO), options.realtimePriority,
+                                      sched_get_priority_max(SCHED_FIFO));
+        const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        realtime = rc == 0;
+        if (!realtime) errors << QStringLiteral("SCHED_FIFO: %1").arg(errnoText(rc));
+    }
+    if (options.lockMemory) {
+        QString error;
+        locked = lockThreadStack(&error);
+        if (!locked) errors << QStringLiteral("mlock: %1").arg(error);
+    }
+    QList<int> cpus = options.cpus;
+    if (cpus.isEmpty() && options.reserveLastCpu) {
+        const int last = highestAllowedCpu();
+        if (last >= 0) cpus.append(last);
+    }
+    if (!cpus.isEmpty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (const int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        pinned = rc == 0;
+        if (!pinned) errors << QStringLiteral("affinity: %1").arg(errnoText(rc));
+    }
+#else
+    if (options.realtimePriority > 0) {
+        // Only a hint to the OS scheduler here; nothing confirms a realtime class was granted,
+        // so realtimePriority stays false.
+        setPriority(QThread::TimeCriticalPriority);
+        errors << QStringLiteral("realtime priority: unverified on this platform");
+    }
+    if (options.lockMemory) errors << QStringLiteral("mlock: unsupported on this platform");
+    if (!options.cpus.isEmpty() || options.reserveLastCpu)
+        errors << QStringLiteral("affinity: unsupported on this platform");
+#endif
+
+    QMutexLocker locker(&m_mutex);
+    OutputRuntimeDispatchStats runtime = m_dispatcher.stats().runtime;
+#if defined(Q_OS_LINUX)
+    runtime.absoluteDeadlineSleep = true;
+#endif
+    runtime.realtimePriority = realtime;
+    runtime.memoryLocked = locked;
+    runtime.cpuPinned = pinned;
+    runtime.schedulingError = errors.join(QStringLiteral("; "));
+    m_dispatcher.setRuntimeStats(runtime);
 }
 
 OutputRuntimeSnapshot OutputRuntime::snapshot() const {
@@ -114,12 +352,23 @@ OutputRuntimeSnapshot OutputRuntime::snapshot() const {
     return provider ? provider() : OutputRuntimeSnapshot();
 }
 
-OutputDispatchStats OutputRuntime::dispatchDueTicksNs(qint64 wallNowNs) {
+void OutputRuntime::dispatchDueTicksNs(qint64 wallNowNs) {
     qint64 elapsedNs = 0;
+    std::optional<TransportStreamOptions> transportOptions;
     {
         QMutexLocker locker(&m_mutex);
         if (m_wallStartNs < 0) m_wallStartNs = wallNowNs;
         elapsedNs = qMax<qint64>(0, wallNowNs - m_wallStartNs);
+        if (m_transportOptionsChanged) {
+            transportOptions = m_transportOptions;
+            m_transportOptionsChanged = false;
+        }
+    }
+    if (transportOptions) {
+        QString error;
+        if (!m_transportStream.open(*transportOptions, &error)) {
+            qWarning() << "Output transport stream could not open:" << error;
+        }
     }
 
     int dispatched = 0;
@@ -133,17 +382,26 @@ OutputDispatchStats OutputRuntime::dispatchDueTicksNs(qint64 wallNowNs) {
             frameIndex = m_dispatcher.nextOutputFrameIndex();
             scheduledNs = frameIndexToNsCeil(rate, frameIndex);
             if (!rate.isValid() || scheduledNs > elapsedNs) {
-                return m_dispatcher.stats();
+                publishStats(wallNowNs);
+                return;
             }
         }
 
+        PipelineTraceScope trace("output", "dispatch tick", "outputFrame", frameIndex);
+        QElapsedTimer snapshotTimer;
+        snapshotTimer.start();
         OutputRuntimeSnapshot current = snapshot();
+        const qint64 snapshotNs = snapshotTimer.nsecsElapsed();
+        TransportStreamRecord record;
         {
             QMutexLocker locker(&m_mutex);
             if (m_stopRequested) break;
             m_dispatcher.dispatchTick(current.cache, current.state);
-            recordDispatchTiming(frameIndex, scheduledNs, elapsedNs);
+            recordDispatchTiming(frameIndex, scheduledNs, elapsedNs, snapshotNs);
+            if (m_transportStream.isOpen()) record = transportRecord();
         }
+        // Sent outside the lock: a slow socket must not hold up stats readers.
+        if (m_transportStream.isOpen()) m_transportStream.send(record);
         dispatched++;
     }
 
@@ -162,11 +420,58 @@ OutputDispatchStats OutputRuntime::dispatchDueTicksNs(qint64 wallNowNs) {
             m_dispatcher.setRuntimeStats(runtime);
         }
     }
-    return m_dispatcher.stats();
+    publishStats(wallNowNs);
+}
+
+void OutputRuntime::publishStats(qint64 wallNowNs) {
+    if (m_lastPublishNs >= 0 && wallNowNs - m_lastPublishNs < kStatsPublishIntervalNs) return;
+    m_lastPublishNs = wallNowNs;
+    const qint64 cpuNs = ThreadPlacement::currentThreadCpuNs();
+    QMutexLocker locker(&m_publishedMutex);
+    m_published.dispatch = statsWithPercentiles();
+    m_published.latenessNs = m_latenessHistogram;
+    m_published.dispatchCpuNs = cpuNs;
+    // The per-target histograms are handed over by swap; the next publishedStats() reader
+    // merges them. Until it has, the dispatcher keeps recording into the ones it holds.
+    if (!m_targetLatencyPending) {
+        m_dispatcher.swapTargetLatency(m_pendingTargetLatency);
+        m_targetLatencyPending = true;
+    }
+}
+
+TransportStreamRecord OutputRuntime::transportRecord() const {
+    const OutputDispatchedTick& tick = m_dispatcher.lastTick();
+    const FrameRate rate = m_dispatcher.frameRate();
+    TransportStreamRecord record;
+    record.outputFrameIndex = tick.outputFrameIndex;
+    record.sampledPlayheadMs = tick.sampledPlayheadMs;
+    // Same programme timecode the bus frames carry (OutputBusFrame::programmeTimecode100ns).
+    record.programmeTimecode100ns = qMax<qint64>(0, tick.sampledPlayheadMs) * 10000;
+    const Smpte12mTimecode timecode =
+        Smpte12m::from100ns(record.programmeTimecode100ns, rate.roundedFps());
+    if (timecode.valid) record.programmeTimecode = Smpte12m::toPackedWord(timecode);
+    record.speed = tick.state.speed;
+    record.playing = tick.state.playing;
+    record.cutArmed = tick.state.cutArmed;
+    record.cutStaged = tick.state.cutStaged;
+    record.scheduledCutFrame = tick.state.scheduledCutFrame;
+    record.rate = rate;
+    return record;
+}
+
+OutputRuntimePublishedStats OutputRuntime::publishedStats() const {
+    QMutexLocker locker(&m_publishedMutex);
+    if (m_targetLatencyPending) {
+        for (auto it = m_pendingTargetLatency.begin(); it != m_pendingTargetLatency.end(); ++it) {
+            drainTargetLatency(m_published.targetLatency[it.key()], it.value());
+        }
+        m_targetLatencyPending = false;
+    }
+    return m_published;
 }
 
 void OutputRuntime::recordDispatchTiming(qint64 outputFrameIndex, qint64 scheduledNs,
-                                         qint64 wallNowNs) {
+                                         qint64 wallNowNs, qint64 snapshotNs) {
     OutputDispatchStats stats = m_dispatcher.stats();
     OutputRuntimeDispatchStats runtime = stats.runtime;
     const qint64 latenessNs = wallNowNs - scheduledNs;
@@ -179,9 +484,37 @@ void OutputRuntime::recordDispatchTiming(qint64 outputFrameIndex, qint64 schedul
     runtime.maxLatenessNs = qMax(runtime.maxLatenessNs, latenessNs);
     runtime.lastDispatchDeadlineMiss = false;
     runtime.lastCappedCatchUpTicks = 0;
+
+    const OutputDispatchTickTiming tick = m_dispatcher.lastTickTiming();
+    m_latenessHistogram.record(latenessNs);
+    m_snapshotHistogram.record(snapshotNs);
+    m_renderHistogram.record(tick.renderNs);
+    m_sinkSubmitHistogram.record(tick.sinkSubmitNs);
+    runtime.lastSnapshotNs = snapshotNs;
+    runtime.lastRenderNs = tick.renderNs;
+    runtime.lastSinkSubmitNs = tick.sinkSubmitNs;
     m_dispatcher.setRuntimeStats(runtime);
 }
 
+OutputDispatchStats OutputRuntime::statsWithPercentiles() const {
+    OutputDispatchStats stats = m_dispatcher.stats();
+    OutputRuntimeDispatchStats& runtime = stats.runtime;
+    runtime.latenessP50Ns = m_latenessHistogram.percentile(0.5);
+    runtime.latenessP99Ns = m_latenessHistogram.percentile(0.99);
+    runtime.latenessP999Ns = m_latenessHistogram.percentile(0.999);
+    runtime.snapshotP99Ns = m_snapshotHistogram.percentile(0.99);
+    runtime.renderP99Ns = m_renderHistogram.percentile(0.99);
+    runtime.sinkSubmitP99Ns = m_sinkSubmitHistogram.percentile(0.99);
+    return stats;
+}
+
+void OutputRuntime::resetTimingHistograms() {
+    m_latenessHistogram.reset();
+    m_snapshotHistogram.reset();
+    m_renderHistogram.reset();
+    m_sinkSubmitHistogram.reset();
+}
+
 qint64 OutputRuntime::frameIndexToNsCeil(FrameRate rate, qint64 frameIndex) {
     if (!rate.isValid() || frameIndex <= 0) return 0;
 
@@ -1,8 +1,12 @@
 #ifndef OUTPUTRUNTIME_H
 #define OUTPUTRUNTIME_H
 
+#include "playback/output/latencyhistogram.h"
 #include "playback/output/outputdispatcher.h"
+#include "playback/output/transportstream.h"
 
+#include <QHash>
+#include <QList>
 #include <QMutex>
 #include <QThread>
 #include <functional>
@@ -14,6 +18,34 @@ struct OutputRuntimeSnapshot {
     OutputRuntimeSnapshot() : cache(0, 2, 2) {}
 };
 
+// How the dispatch thread asks to be scheduled. Everything is best effort: what was actually
+// granted (or why not) is reported in OutputRuntimeDispatchStats.
+struct OutputRuntimeSchedulingOptions {
+    // SCHED_FIFO priority (1..99) on Linux; elsewhere any value > 0 maps to
+    // QThread::TimeCriticalPriority. 0 keeps normal scheduling.
+    int realtimePriority = 0;
+    // Lock the dispatch thread's working stack in RAM so a tick never page-faults on it.
+    bool lockMemory = false;
+    // CPUs the dispatch thread is restricted to (Linux); empty inherits the process mask.
+    QList<int> cpus;
+    // Restrict the dispatch thread to the highest CPU of the process mask, so it does not
+    // share a core with decode threads the scheduler packs onto the low CPUs. Ignored when
+    // `cpus` is set.
+    bool reserveLastCpu = false;
+
+    // OLR_OUTPUT_RT_PRIORITY=<1..99>, OLR_OUTPUT_MLOCK=1, OLR_OUTPUT_CPUS=<list|"last">
+    // (e.g. "6,7"; PlaybackWorker applies the CPUs to playback channel 0 only).
+    static OutputRuntimeSchedulingOptions fromEnvironment();
+};
+
+// stats() as the dispatch thread last published it, with the tick-lateness distribution.
+struct OutputRuntimePublishedStats {
+    OutputDispatchStats dispatch;
+    LatencyHistogram latenessNs; // per-tick dispatch lateness since the runtime started
+    QHash<QString, OutputTargetLatency> targetLatency; // disk-to-output, by target key
+    qint64 dispatchCpuNs = -1; // CPU time of the dispatching thread; -1 = not reported
+};
+
 class OutputRuntime final : public QThread {
 public:
     using SnapshotProvider = std::function<OutputRuntimeSnapshot()>;
@@ -22,6 +54,11 @@ public:
     ~OutputRuntime() override;
 
     void setSnapshotProvider(SnapshotProvider provider);
+    // Applied by the dispatch thread when it starts; set before startRuntime().
+    void setSchedulingOptions(const OutputRuntimeSchedulingOptions& options);
+    // Where each dispatched tick's transport record goes (TransportStreamSender). Picked up
+    // by the next tick, so the socket is opened on the dispatching thread.
+    void setTransportStreamOptions(const TransportStreamOptions& options);
     void setEndpoints(const QList<OutputEndpoint>& endpoints);
     // Forward identity-skip to the wrapped dispatcher (e.g. tests that assert a
     // per-tick submit of an unchanged frame must disable it).
@@ -36,6 +73,11 @@ public:
     OutputDispatchStats dispatchDueTicksForTest(qint64 wallNowMs);
     OutputDispatchStats dispatchDueTicksForTestNs(qint64 wallNowNs);
     OutputDispatchStats stats() const;
+    // Refreshed by the dispatch thread at most every kStatsPublishIntervalNs, under its own
+    // lock, so a poller never waits behind a tick the way stats() can. The caller merges the
+    // per-target latency handed over since the last call, keeping that off the dispatch thread.
+    OutputRuntimePublishedStats publishedStats() const;
+    static constexpr qint64 kStatsPublishIntervalNs = 250'000'000;
     // Tier3 atomic cut: the next output frame index the dispatcher will emit,
     // read under m_mutex (the same lock that guards m_dispatcher's mutation in
     // dispatchTick/resetFrameIndex). SAFE to call from makeOutputSnapshot: that
@@ -54,8 +96,21 @@ protected:
 
 private:
     OutputRuntimeSnapshot snapshot() const;
-    OutputDispatchStats dispatchDueTicksNs(qint64 wallNowNs);
-    void recordDispatchTiming(qint64 outputFrameIndex, qint64 scheduledNs, qint64 wallNowNs);
+    void dispatchDueTicksNs(qint64 wallNowNs);
+    // Absolute wall time of the next tick, on the clock dispatchDueTicksNs is fed; -1 when
+    // there is none to wait for yet (invalid rate, or the clock is not anchored).
+    qint64 nextDeadlineNs() const;
+    void applySchedulingOptions();
+    void recordDispatchTiming(qint64 outputFrameIndex, qint64 scheduledNs, qint64 wallNowNs,
+                              qint64 snapshotNs);
+    void resetTimingHistograms();
+    // Called with m_mutex held. The dispatcher's stats with the timing percentiles filled in
+    // from the histograms; walked only when stats are read or published, never per tick.
+    OutputDispatchStats statsWithPercentiles() const;
+    // Called with m_mutex held.
+    void publishStats(qint64 wallNowNs);
+    // Called with m_mutex held, right after a dispatchTick.
+    TransportStreamRecord transportRecord() const;
     static qint64 frameIndexToNsCeil(FrameRate rate, qint64 frameIndex);
     static qint64 dueFrameCount(FrameRate rate, qint64 elapsedNs);
 
@@ -65,6 +120,20 @@ private:
     qint64 m_wallStartNs = -1;
     bool m_stopRequested = false;
     int m_maxCatchUpTicks = 8;
+    OutputRuntimeSchedulingOptions m_schedulingOptions;
+    LatencyHistogram m_latenessHistogram;
+    LatencyHistogram m_snapshotHistogram;
+    LatencyHistogram m_renderHistogram;
+    LatencyHistogram m_sinkSubmitHistogram;
+    mutable QMutex m_publishedMutex;
+    // Guarded by m_publishedMutex; publishedStats() merges the pending target latency in.
+    mutable OutputRuntimePublishedStats m_published;
+    mutable QHash<QString, OutputTargetLatency> m_pendingTargetLatency;
+    mutable bool m_targetLatencyPending = false;
+    qint64 m_lastPublishNs = -1;             // guarded by m_mutex
+    TransportStreamOptions m_transportOptions; // guarded by m_mutex
+    bool m_transportOptionsChanged = false;    // guarded by m_mutex
+    TransportStreamSender m_transportStream;   // dispatching thread only
 };
 
 #endif // OUTPUTRUNTIME_H
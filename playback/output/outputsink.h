@@ -14,6 +14,8 @@ struct OutputSinkStatus {
     qint64 lastQueuedFrameIndex = -1;
     qint64 lastDeliveredFrameIndex = -1;
     qint64 lastSubmitDurationNs = 0;
+    qint64 encodeLatencyNs = 0;
+    qint64 maxEncodeLatencyNs = 0;
     bool queuePressure = false;
     bool lastSubmitDroppedFrame = false;
     bool lastDeliveryGap = false;
@@ -34,6 +36,11 @@ public:
     virtual void stop() = 0;
     virtual bool isActive() const = 0;
     virtual bool submit(const OutputBusFrame& frame) = 0;
+    // The dispatcher hands the last target fed from a bus its frame by move. Sinks that keep
+    // the frame (QueuedOutputSink) override this to skip the copy; the rest just borrow it.
+    virtual bool submit(OutputBusFrame&& frame) {
+        return submit(static_cast<const OutputBusFrame&>(frame));
+    }
     virtual OutputSinkStatus outputStatus() const { return OutputSinkStatus{}; }
 };
 
@@ -14,6 +14,12 @@ QString outputTargetKindName(OutputTargetKind kind) {
         return QStringLiteral("omt");
     case OutputTargetKind::Aja:
         return QStringLiteral("aja");
+    case OutputTargetKind::SharedMemory:
+        return QStringLiteral("shared-memory");
+    case OutputTargetKind::MpegTsStream:
+        return QStringLiteral("mpegts-stream");
+    case OutputTargetKind::IsoRecorder:
+        return QStringLiteral("iso-recorder");
     }
     return QStringLiteral("unknown");
 }
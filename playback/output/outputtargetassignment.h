@@ -11,6 +11,8 @@ struct OutputTargetAssignment {
     OutputTargetKind kind = OutputTargetKind::QtPreview;
     bool enabled = false;
     QVariantMap settings;
+    // Playback channel whose buses feed the target (PlaybackChannel); 0 = the main one.
+    int channel = 0;
 
     void setEnabled(bool on) { enabled = on; }
 };
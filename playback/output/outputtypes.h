@@ -38,6 +38,9 @@ enum class OutputTargetKind {
     Ndi,
     Omt,
     Aja,
+    SharedMemory,
+    MpegTsStream,
+    IsoRecorder,
 };
 
 enum class MediaPixelFormat {
@@ -59,6 +62,12 @@ struct PlaybackStateSnapshot {
     int selectedFeedIndex = -1;
     uint64_t gpuGeneration = 0;
     bool forcePlayEpochReset = false;
+    // Armed-cut status, carried for transport consumers only (the dispatcher does not act
+    // on it): a cut is armed, its pre-roll is staged, and the output frame it fires at
+    // (-1 until scheduled).
+    bool cutArmed = false;
+    bool cutStaged = false;
+    qint64 scheduledCutFrame = -1;
 };
 
 #endif // OUTPUTTYPES_H
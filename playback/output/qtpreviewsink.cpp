@@ -1,11 +1,14 @@
 #include "playback/output/qtpreviewsink.h"
 
 #include "playback/frameprovider.h"
+#include "playback/output/framehandlevideobuffer.h"
 
 #include <QSize>
 #include <QVideoFrameFormat>
 #include <QtGlobal>
 #include <cstring>
+#include <memory>
+#include <utility>
 
 QtPreviewSink::QtPreviewSink(FrameProvider* provider) : m_provider(provider) {}
 
@@ -34,15 +37,30 @@ QVideoFrameFormat::ColorRange qtColorRangeFor(ColorRange range) {
                                      : QVideoFrameFormat::ColorRange_Video;
 }
 
+namespace {
+QVideoFrameFormat previewFormatFor(const FrameHandle& frame) {
+    const FrameMetadata& meta = frame.metadata();
+    QVideoFrameFormat format(QSize(meta.key.width, meta.key.height),
+                             QVideoFrameFormat::Format_YUV420P);
+    format.setColorSpace(qtColorSpaceFor(meta.color.matrix));
+    format.setColorRange(qtColorRangeFor(meta.color.range));
+    return format;
+}
+} // namespace
+
 QVideoFrame QtPreviewSink::toQVideoFrame(const FrameHandle& frame) {
+    if (frame.isNull() || frame.metadata().key.width <= 0 || frame.metadata().key.height <= 0)
+        return QVideoFrame();
+    std::unique_ptr<FrameHandleVideoBuffer> buffer =
+        FrameHandleVideoBuffer::wrap(frame, previewFormatFor(frame));
+    if (!buffer) return copyToQVideoFrame(frame);
+    return QVideoFrame(std::move(buffer));
+}
+
+QVideoFrame QtPreviewSink::copyToQVideoFrame(const FrameHandle& frame) {
     const MediaVideoFrameView view(frame);
     if (!view.isValid()) return QVideoFrame();
-    QVideoFrameFormat format(QSize(view.width, view.height), QVideoFrameFormat::Format_YUV420P);
-    const ColorMetadata& color = frame.metadata().color;
-    format.setColorSpace(qtColorSpaceFor(color.matrix));
-    format.setColorRange(qtColorRangeFor(color.range));
-
-    QVideoFrame qFrame(format);
+    QVideoFrame qFrame(previewFormatFor(frame));
     if (!qFrame.map(QVideoFrame::WriteOnly)) return QVideoFrame();
 
     const QByteArray planes[3] = {view.planeY, view.planeU, view.planeV};
@@ -51,7 +69,10 @@ QVideoFrame QtPreviewSink::toQVideoFrame(const FrameHandle& frame) {
         const int height = (i == 0) ? view.height : (view.height + 1) / 2;
         const int width = (i == 0) ? view.width : (view.width + 1) / 2;
         const int copyW = qMin(width, qMin(srcStrides[i], qFrame.bytesPerLine(i)));
-        for (int y = 0; y < height; ++y) {
+        // Never read past a short plane (the reason it missed the zero-copy path).
+        const qsizetype rows =
+            srcStrides[i] > 0 ? qMin<qsizetype>(height, planes[i].size() / srcStrides[i]) : 0;
+        for (qsizetype y = 0; y < rows; ++y) {
             std::memcpy(qFrame.bits(i) + static_cast<qsizetype>(y) * qFrame.bytesPerLine(i),
                         planes[i].constData() + static_cast<qsizetype>(y) * srcStrides[i],
                         size_t(copyW));
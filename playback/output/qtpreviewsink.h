@@ -17,7 +17,12 @@ public:
     explicit QtPreviewSink(FrameProvider* provider);
 
     bool deliver(const FrameHandle& frame);
+    // Wraps the handle's planes (FrameHandleVideoBuffer): no pixel copy for a
+    // CPU-backed frame. Falls back to copyToQVideoFrame for planes the wrapper
+    // cannot present as-is.
     static QVideoFrame toQVideoFrame(const FrameHandle& frame);
+    // Allocates a QVideoFrame and copies every line into it.
+    static QVideoFrame copyToQVideoFrame(const FrameHandle& frame);
 
 private:
     FrameProvider* m_provider = nullptr;
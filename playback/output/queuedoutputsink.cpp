@@ -5,115 +5,170 @@
 QueuedOutputSink::QueuedOutputSink(std::unique_ptr<IOutputSink> inner, int capacity)
     : m_inner(std::move(inner)), m_capacity(qMax(1, capacity)) {
     if (m_inner) m_kind = m_inner->kind();
+    m_slotCount = quint64(m_capacity) + 1;
+    m_slots = std::make_unique<Slot[]>(m_slotCount);
+    resetRing();
 }
 
 QueuedOutputSink::~QueuedOutputSink() {
     stop();
 }
 
+void QueuedOutputSink::resetRing() {
+    for (quint64 i = 0; i < m_slotCount; ++i) {
+        m_slots[i].frame = OutputBusFrame();
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_dropScratch = OutputBusFrame();
+}
+
 bool QueuedOutputSink::start(const OutputTargetAssignment& assignment, FrameRate rate) {
     stop();
     if (!m_inner || !m_inner->start(assignment, rate)) return false;
 
-    {
-        QMutexLocker locker(&m_mutex);
-        m_queue.clear();
-        m_stopRequested = false;
-        m_active = true;
-        m_droppedFrames = 0;
-        m_droppedFrameIndexes.clear();
-        m_asyncAcceptedFrames = 0;
-        m_asyncFailedFrames = 0;
-        m_maxQueueDepth = 0;
-        m_deliveryGaps = 0;
-        m_lastQueuedFrameIndex = -1;
-        m_lastDeliveredFrameIndex = -1;
-        m_queuePressure = false;
-        m_lastSubmitDroppedFrame = false;
-        m_lastDeliveryGap = false;
-        m_hasLastAsyncResult = false;
-        m_lastAsyncResultSucceeded = true;
-        m_hasLastQueuedFrameIndex = false;
-        m_hasLastDeliveredFrameIndex = false;
-    }
+    resetRing();
+    m_workerPops = 0;
+    m_dropsBeforeLastPop = 0;
+    m_dropsSinceLastDelivery = 0;
+    m_droppedFrames = 0;
+    m_asyncAcceptedFrames = 0;
+    m_asyncFailedFrames = 0;
+    m_maxQueueDepth = 0;
+    m_deliveryGaps = 0;
+    m_lastQueuedFrameIndex = -1;
+    m_lastDeliveredFrameIndex = -1;
+    m_queuePressure = false;
+    m_lastSubmitDroppedFrame = false;
+    m_lastDeliveryGap = false;
+    m_hasLastAsyncResult = false;
+    m_lastAsyncResultSucceeded = true;
+    m_hasLastQueuedFrameIndex = false;
+    m_hasLastDeliveredFrameIndex = false;
+    m_workerParked = false;
+    m_stopRequested = false;
+    m_active = true;
 
+    // QThread::start() publishes everything above to the worker.
     m_thread.reset(QThread::create([this]() { workerLoop(); }));
     m_thread->start();
     return true;
 }
 
 void QueuedOutputSink::stop() {
-    std::unique_ptr<QThread> thread;
+    m_active = false;
+    m_stopRequested = true;
     {
-        QMutexLocker locker(&m_mutex);
-        m_active = false;
-        m_stopRequested = true;
-        m_queue.clear();
+        QMutexLocker locker(&m_parkMutex);
         m_wake.wakeAll();
-        thread = std::move(m_thread);
     }
-
+    std::unique_ptr<QThread> thread = std::move(m_thread);
     if (thread) thread->wait();
+    // The worker is gone; release whatever was still queued.
+    resetRing();
     if (m_inner) m_inner->stop();
 }
 
 bool QueuedOutputSink::isActive() const {
-    QMutexLocker locker(&m_mutex);
     return m_active && !m_stopRequested;
 }
 
 bool QueuedOutputSink::submit(const OutputBusFrame& frame) {
-    QMutexLocker locker(&m_mutex);
-    if (!m_active || m_stopRequested || !m_thread) return false;
+    return submit(OutputBusFrame(frame));
+}
+
+bool QueuedOutputSink::submit(OutputBusFrame&& frame) {
+    if (!m_active.load(std::memory_order_acquire) ||
+        m_stopRequested.load(std::memory_order_acquire))
+        return false;
+
+    const quint64 position = m_tail.load(std::memory_order_relaxed);
     bool dropped = false;
-    if (m_queue.size() >= m_capacity) {
-        m_droppedFrameIndexes.append(m_queue.first().outputFrameIndex);
-        // Bound the tracked-drop history. Indexes are normally drained by the next
-        // successful delivery; only a persistently-failing inner sink (already reported as
-        // Error via the rejection path) lets them accumulate. Forgetting the oldest drop can
-        // only make a future gap look unexplained, which errs toward Error — the correct
-        // outcome in that all-reject state — so it never masks a real failure.
-        constexpr int kMaxTrackedDrops = 4096;
-        if (m_droppedFrameIndexes.size() > kMaxTrackedDrops) m_droppedFrameIndexes.removeFirst();
-        m_queue.removeFirst();
-        m_droppedFrames++;
-        dropped = true;
+    while (position - m_head.load(std::memory_order_acquire) >= quint64(m_capacity)) {
+        quint64 droppedPosition = 0;
+        if (tryPop(&m_dropScratch, &droppedPosition)) {
+            m_dropScratch = OutputBusFrame();
+            m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            dropped = true;
+        }
+    }
+
+    // The previous occupant of this slot has been claimed; if the worker is still moving it
+    // out (it would have to be a whole queue behind), that is a few pointer copies away.
+    Slot& slot = m_slots[position % m_slotCount];
+    while (slot.sequence.load(std::memory_order_acquire) != position)
+        QThread::yieldCurrentThread();
+    const qint64 frameIndex = frame.outputFrameIndex;
+    slot.frame = std::move(frame);
+    slot.sequence.store(position + 1, std::memory_order_release);
+    m_tail.store(position + 1, std::memory_order_seq_cst);
+
+    const qint64 depth = qint64(position + 1 - m_head.load(std::memory_order_acquire));
+    m_lastQueuedFrameIndex.store(frameIndex, std::memory_order_relaxed);
+    m_hasLastQueuedFrameIndex.store(true, std::memory_order_relaxed);
+    if (depth > m_maxQueueDepth.load(std::memory_order_relaxed))
+        m_maxQueueDepth.store(depth, std::memory_order_relaxed);
+    m_lastSubmitDroppedFrame.store(dropped, std::memory_order_relaxed);
+    m_queuePressure.store(depth > 1, std::memory_order_relaxed);
+
+    // Only an idle worker needs the lock; the seq_cst tail store above pairs with the
+    // worker's seq_cst parked flag so a frame is never published behind a sleeping worker.
+    if (m_workerParked.load(std::memory_order_seq_cst)) {
+        QMutexLocker locker(&m_parkMutex);
+        m_wake.wakeOne();
     }
-    m_queue.append(frame);
-    m_lastQueuedFrameIndex = frame.outputFrameIndex;
-    m_hasLastQueuedFrameIndex = true;
-    m_maxQueueDepth = qMax<qint64>(m_maxQueueDepth, m_queue.size());
-    m_lastSubmitDroppedFrame = dropped;
-    m_queuePressure = m_queue.size() > 1;
-    m_wake.wakeOne();
+    return true;
+}
+
+bool QueuedOutputSink::tryPop(OutputBusFrame* out, quint64* position) {
+    quint64 pos = m_head.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &m_slots[pos % m_slotCount];
+        const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+        const qint64 diff = qint64(sequence) - qint64(pos + 1);
+        if (diff == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false; // empty
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+    *out = std::move(slot->frame);
+    slot->frame = OutputBusFrame();
+    slot->sequence.store(pos + m_slotCount, std::memory_order_release);
+    *position = pos;
     return true;
 }
 
 int QueuedOutputSink::droppedFrames() const {
-    QMutexLocker locker(&m_mutex);
-    return m_droppedFrames;
+    return int(m_droppedFrames.load(std::memory_order_relaxed));
 }
 
 OutputSinkStatus QueuedOutputSink::outputStatus() const {
     OutputSinkStatus own;
-    {
-        QMutexLocker locker(&m_mutex);
-        own.acceptedFrames = m_asyncAcceptedFrames;
-        own.failedFrames = m_asyncFailedFrames;
-        own.droppedFrames = m_droppedFrames;
-        own.currentQueueDepth = m_queue.size();
-        own.maxQueueDepth = m_maxQueueDepth;
-        own.deliveryGaps = m_deliveryGaps;
-        own.lastQueuedFrameIndex = m_lastQueuedFrameIndex;
-        own.lastDeliveredFrameIndex = m_lastDeliveredFrameIndex;
-        own.queuePressure = m_queuePressure;
-        own.lastSubmitDroppedFrame = m_lastSubmitDroppedFrame;
-        own.lastDeliveryGap = m_lastDeliveryGap;
-        own.hasLastResult = m_hasLastAsyncResult;
-        own.lastResultSucceeded = m_lastAsyncResultSucceeded;
-        own.hasLastQueuedFrameIndex = m_hasLastQueuedFrameIndex;
-        own.hasLastDeliveredFrameIndex = m_hasLastDeliveredFrameIndex;
-    }
+    own.acceptedFrames = m_asyncAcceptedFrames.load(std::memory_order_relaxed);
+    own.failedFrames = m_asyncFailedFrames.load(std::memory_order_relaxed);
+    own.droppedFrames = m_droppedFrames.load(std::memory_order_relaxed);
+    const quint64 head = m_head.load(std::memory_order_acquire);
+    const quint64 tail = m_tail.load(std::memory_order_acquire);
+    own.currentQueueDepth = tail > head ? qint64(tail - head) : 0;
+    own.maxQueueDepth = m_maxQueueDepth.load(std::memory_order_relaxed);
+    own.deliveryGaps = m_deliveryGaps.load(std::memory_order_relaxed);
+    own.lastQueuedFrameIndex = m_lastQueuedFrameIndex.load(std::memory_order_relaxed);
+    own.lastDeliveredFrameIndex = m_lastDeliveredFrameIndex.load(std::memory_order_relaxed);
+    own.queuePressure = m_queuePressure.load(std::memory_order_relaxed);
+    own.lastSubmitDroppedFrame = m_lastSubmitDroppedFrame.load(std::memory_order_relaxed);
+    own.lastDeliveryGap = m_lastDeliveryGap.load(std::memory_order_relaxed);
+    own.hasLastResult = m_hasLastAsyncResult.load(std::memory_order_relaxed);
+    own.lastResultSucceeded = m_lastAsyncResultSucceeded.load(std::memory_order_relaxed);
+    own.hasLastQueuedFrameIndex = m_hasLastQueuedFrameIndex.load(std::memory_order_relaxed);
+    own.hasLastDeliveredFrameIndex =
+        m_hasLastDeliveredFrameIndex.load(std::memory_order_relaxed);
 
     const OutputSinkStatus inner = m_inner ? m_inner->outputStatus() : OutputSinkStatus{};
     own.acceptedFrames = qMax(own.acceptedFrames, inner.acceptedFrames);
@@ -134,6 +189,8 @@ OutputSinkStatus QueuedOutputSink::outputStatus() const {
         own.lastDeliveredFrameIndex = inner.lastDeliveredFrameIndex;
     }
     own.lastSubmitDurationNs = qMax(own.lastSubmitDurationNs, inner.lastSubmitDurationNs);
+    own.encodeLatencyNs = inner.encodeLatencyNs;
+    own.maxEncodeLatencyNs = inner.maxEncodeLatencyNs;
     if (inner.hasLastResult) {
         own.hasLastResult = true;
         own.lastResultSucceeded = inner.lastResultSucceeded;
@@ -144,53 +201,60 @@ OutputSinkStatus QueuedOutputSink::outputStatus() const {
 }
 
 void QueuedOutputSink::workerLoop() {
-    while (true) {
-        OutputBusFrame frame;
-        {
-            QMutexLocker locker(&m_mutex);
-            while (!m_stopRequested && m_queue.isEmpty()) {
-                m_wake.wait(&m_mutex);
-            }
-            if (m_stopRequested) return;
-            frame = m_queue.takeFirst();
-            m_queuePressure = m_queue.size() > 1;
+    OutputBusFrame frame;
+    quint64 position = 0;
+    while (!m_stopRequested.load(std::memory_order_acquire)) {
+        if (tryPop(&frame, &position)) {
+            const quint64 depth =
+                m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+            m_queuePressure.store(depth > 1, std::memory_order_relaxed);
+            const bool submitted = m_inner && m_inner->submit(frame);
+            recordDelivery(frame, position, submitted);
+            frame = OutputBusFrame();
+            continue;
+        }
+
+        QMutexLocker locker(&m_parkMutex);
+        m_workerParked.store(true, std::memory_order_seq_cst);
+        if (!m_stopRequested.load(std::memory_order_seq_cst) &&
+            m_tail.load(std::memory_order_seq_cst) == m_head.load(std::memory_order_seq_cst)) {
+            m_wake.wait(&m_parkMutex);
         }
-        const bool submitted = m_inner && m_inner->submit(frame);
-        {
-            QMutexLocker locker(&m_mutex);
-            if (submitted) {
-                // Consume the overflow-dropped indexes that precede this delivered frame.
-                // For a real gap (non-first delivery) these are exactly the missing indexes
-                // between the previous and current delivered frame that were dropped. Drops
-                // below the first-ever delivered index bracket no computed gap and are simply
-                // discarded here, scoped by index so they can never carry forward to suppress
-                // a later, independently-caused gap.
-                int droppedInGap = 0;
-                while (!m_droppedFrameIndexes.isEmpty() &&
-                       m_droppedFrameIndexes.first() < frame.outputFrameIndex) {
-                    m_droppedFrameIndexes.removeFirst();
-                    droppedInGap++;
-                }
-                if (m_hasLastDeliveredFrameIndex) {
-                    const qint64 gapSize =
-                        qMax<qint64>(0, frame.outputFrameIndex - m_lastDeliveredFrameIndex - 1);
-                    if (gapSize > 0) {
-                        m_deliveryGaps++;
-                    }
-                    // A gap fully explained by queue-overflow drops is backpressure
-                    // (surfaced as Degraded via lastSubmitDroppedFrame), not a delivery
-                    // failure. Only raise the Error-mapping lastDeliveryGap when missing
-                    // indexes remain unexplained by drops (e.g. an inner-sink rejection).
-                    m_lastDeliveryGap = gapSize > 0 && droppedInGap < gapSize;
-                }
-                m_lastDeliveredFrameIndex = frame.outputFrameIndex;
-                m_hasLastDeliveredFrameIndex = true;
-                m_asyncAcceptedFrames++;
-            } else {
-                m_asyncFailedFrames++;
-            }
-            m_hasLastAsyncResult = true;
-            m_lastAsyncResultSucceeded = submitted;
+        m_workerParked.store(false, std::memory_order_relaxed);
+    }
+}
+
+void QueuedOutputSink::recordDelivery(const OutputBusFrame& frame, quint64 position,
+                                      bool submitted) {
+    // Ring positions are claimed in order, by the worker or by a producer-side drop, so every
+    // position below this one that the worker did not pop was an overflow drop. That attributes
+    // drops to the gap they caused without keeping a list of dropped indexes.
+    const qint64 dropsBefore = qint64(position - m_workerPops);
+    m_workerPops++;
+    m_dropsSinceLastDelivery += dropsBefore - m_dropsBeforeLastPop;
+    m_dropsBeforeLastPop = dropsBefore;
+
+    if (submitted) {
+        const qint64 droppedInGap = m_dropsSinceLastDelivery;
+        m_dropsSinceLastDelivery = 0;
+        if (m_hasLastDeliveredFrameIndex.load(std::memory_order_relaxed)) {
+            const qint64 gapSize = qMax<qint64>(
+                0, frame.outputFrameIndex -
+                       m_lastDeliveredFrameIndex.load(std::memory_order_relaxed) - 1);
+            if (gapSize > 0) m_deliveryGaps.fetch_add(1, std::memory_order_relaxed);
+            // A gap fully explained by queue-overflow drops is backpressure (surfaced as
+            // Degraded via lastSubmitDroppedFrame), not a delivery failure. Only raise the
+            // Error-mapping lastDeliveryGap when missing indexes remain unexplained by drops
+            // (e.g. an inner-sink rejection).
+            m_lastDeliveryGap.store(gapSize > 0 && droppedInGap < gapSize,
+                                    std::memory_order_relaxed);
         }
+        m_lastDeliveredFrameIndex.store(frame.outputFrameIndex, std::memory_order_relaxed);
+        m_hasLastDeliveredFrameIndex.store(true, std::memory_order_relaxed);
+        m_asyncAcceptedFrames.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_asyncFailedFrames.fetch_add(1, std::memory_order_relaxed);
     }
+    m_lastAsyncResultSucceeded.store(submitted, std::memory_order_relaxed);
+    m_hasLastAsyncResult.store(true, std::memory_order_release);
 }
@@ -5,11 +5,19 @@
 
 #include <QMutex>
 #include <QThread>
-#include <QVector>
 #include <QWaitCondition>
 
+#include <atomic>
 #include <memory>
 
+// Decouples the output clock from a slow sink: submit() moves the frame into a fixed ring of
+// preallocated slots and returns; a worker thread delivers to the inner sink. When the ring is
+// full the oldest queued frame is dropped (counted in droppedFrames).
+//
+// Single producer (the output runtime thread), single consumer (the worker). Each slot
+// carries a sequence number, and dropping the oldest frame is the producer claiming the head
+// slot with the same compare-exchange the worker uses, so neither side locks on the hot path.
+// The mutex only parks an idle worker; status counters are atomics.
 class QueuedOutputSink final : public IOutputSink {
 public:
     explicit QueuedOutputSink(std::unique_ptr<IOutputSink> inner, int capacity = 3);
@@ -20,38 +28,65 @@ public:
     void stop() override;
     bool isActive() const override;
     bool submit(const OutputBusFrame& frame) override;
+    // Move-in variant: the frame's buffers are handed to the slot without touching refcounts.
+    bool submit(OutputBusFrame&& frame) override;
     OutputSinkStatus outputStatus() const override;
 
     int droppedFrames() const;
 
 private:
+    struct Slot {
+        std::atomic<quint64> sequence{0};
+        OutputBusFrame frame;
+    };
+
+    void resetRing();
+    // Claims the oldest queued slot and moves its frame out. Called by the worker, and by
+    // submit() to drop the oldest frame when the ring is full. *position is the ring
+    // position of the claimed frame.
+    bool tryPop(OutputBusFrame* out, quint64* position);
     void workerLoop();
+    void recordDelivery(const OutputBusFrame& frame, quint64 position, bool submitted);
 
     std::unique_ptr<IOutputSink> m_inner;
     OutputTargetKind m_kind = OutputTargetKind::QtPreview;
     int m_capacity = 3;
 
-    mutable QMutex m_mutex;
+    // capacity + 1 slots: the slot the worker is still moving a frame out of is never the
+    // one the producer writes next unless the producer laps a whole queue meanwhile.
+    std::unique_ptr<Slot[]> m_slots;
+    quint64 m_slotCount = 0;
+    alignas(64) std::atomic<quint64> m_head{0}; // next position to pop
+    alignas(64) std::atomic<quint64> m_tail{0}; // next position to push (producer-owned)
+    OutputBusFrame m_dropScratch;               // producer-owned; receives dropped frames
+
+    // Parking for an idle worker only.
+    mutable QMutex m_parkMutex;
     QWaitCondition m_wake;
-    QVector<OutputBusFrame> m_queue;
+    std::atomic<bool> m_workerParked{false};
     std::unique_ptr<QThread> m_thread;
-    bool m_active = false;
-    bool m_stopRequested = false;
-    int m_droppedFrames = 0;
-    QVector<qint64> m_droppedFrameIndexes;
-    qint64 m_asyncAcceptedFrames = 0;
-    qint64 m_asyncFailedFrames = 0;
-    qint64 m_maxQueueDepth = 0;
-    qint64 m_deliveryGaps = 0;
-    qint64 m_lastQueuedFrameIndex = -1;
-    qint64 m_lastDeliveredFrameIndex = -1;
-    bool m_queuePressure = false;
-    bool m_lastSubmitDroppedFrame = false;
-    bool m_lastDeliveryGap = false;
-    bool m_hasLastAsyncResult = false;
-    bool m_lastAsyncResultSucceeded = true;
-    bool m_hasLastQueuedFrameIndex = false;
-    bool m_hasLastDeliveredFrameIndex = false;
+    std::atomic<bool> m_active{false};
+    std::atomic<bool> m_stopRequested{false};
+
+    // Worker-owned delivery bookkeeping (no atomics needed).
+    quint64 m_workerPops = 0;
+    qint64 m_dropsBeforeLastPop = 0;
+    qint64 m_dropsSinceLastDelivery = 0;
+
+    std::atomic<qint64> m_droppedFrames{0};
+    std::atomic<qint64> m_asyncAcceptedFrames{0};
+    std::atomic<qint64> m_asyncFailedFrames{0};
+    std::atomic<qint64> m_maxQueueDepth{0};
+    std::atomic<qint64> m_deliveryGaps{0};
+    std::atomic<qint64> m_lastQueuedFrameIndex{-1};
+    std::atomic<qint64> m_lastDeliveredFrameIndex{-1};
+    std::atomic<bool> m_queuePressure{false};
+    std::atomic<bool> m_lastSubmitDroppedFrame{false};
+    std::atomic<bool> m_lastDeliveryGap{false};
+    std::atomic<bool> m_hasLastAsyncResult{false};
+    std::atomic<bool> m_lastAsyncResultSucceeded{true};
+    std::atomic<bool> m_hasLastQueuedFrameIndex{false};
+    std::atomic<bool> m_hasLastDeliveredFrameIndex{false};
 };
 
 #endif // QUEUEDOUTPUTSINK_H
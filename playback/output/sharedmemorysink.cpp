@@ -0,0 +1,140 @@
+#include "playback/output/sharedmemorysink.h"
+
+#include <QElapsedTimer>
+
+namespace {
+#if defined(Q_OS_UNIX)
+constexpr bool kSupported = true;
+#else
+constexpr bool kSupported = false;
+#endif
+} // namespace
+
+SharedMemoryOutputSink::~SharedMemoryOutputSink() {
+    stop();
+}
+
+bool SharedMemoryOutputSink::start(const OutputTargetAssignment& assignment, FrameRate rate) {
+    stop();
+    {
+        QMutexLocker locker(&m_statusMutex);
+        m_status = OutputSinkStatus();
+    }
+    if (assignment.kind != OutputTargetKind::SharedMemory || !assignment.enabled ||
+        !rate.isValid()) {
+        setStatus(QStringLiteral("invalid"),
+                  QStringLiteral("invalid shared-memory output assignment"));
+        return false;
+    }
+    if (!kSupported) {
+        setStatus(QStringLiteral("unsupported"),
+                  QStringLiteral("shared-memory output is not supported on this platform"));
+        return false;
+    }
+    const QString name = shmring::nativeSegmentName(segmentNameFor(assignment));
+    if (name.isEmpty()) {
+        setStatus(QStringLiteral("invalid"), QStringLiteral("shared-memory segment name is empty"));
+        return false;
+    }
+    m_assignment = assignment;
+    m_rate = rate;
+    m_segmentName = name;
+    m_active = true;
+    // The bus geometry arrives with the frames, so the ring is created on the first one.
+    setStatus(QStringLiteral("active"),
+              QStringLiteral("shared-memory ring %1 waiting for the first frame").arg(name));
+    return true;
+}
+
+void SharedMemoryOutputSink::stop() {
+    m_ring.close();
+    m_active = false;
+    setStatus(QStringLiteral("stopped"), QStringLiteral("shared-memory output stopped"));
+}
+
+bool SharedMemoryOutputSink::ensureRing(const OutputBusFrame& frame) {
+    const MediaVideoFrameView video(frame.video);
+    const quint64 needed = shmring::payloadBytesFor(video.width, video.height, m_rate);
+    if (m_ring.isOpen() && m_ring.payloadBytes() >= needed) return true;
+
+    // A larger frame than the ring was sized for (a bus format change): readers see the
+    // old segment close and reattach to the new one under the same name.
+    ShmFrameRingWriter::Geometry geometry;
+    geometry.slotCount = slotCountFor(m_assignment);
+    geometry.payloadBytes = qMax(needed, m_ring.payloadBytes());
+    geometry.rate = m_rate;
+    geometry.bus = m_assignment.sourceBus;
+    QString error;
+    if (!m_ring.open(m_segmentName, geometry, &error)) {
+        setStatus(QStringLiteral("create-failed"), error);
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryOutputSink::submit(const OutputBusFrame& frame) {
+    if (!m_active) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool published = ensureRing(frame) && m_ring.publish(frame);
+    QMutexLocker locker(&m_statusMutex);
+    m_status.lastSubmitDurationNs = timer.nsecsElapsed();
+    m_status.hasLastResult = true;
+    m_status.lastResultSucceeded = published;
+    m_status.hasLastQueuedFrameIndex = true;
+    m_status.lastQueuedFrameIndex = frame.outputFrameIndex;
+    if (!published) {
+        m_status.failedFrames++;
+        if (m_status.state != QStringLiteral("create-failed")) {
+            m_status.state = QStringLiteral("send-failed");
+            m_status.message = QStringLiteral("frame not published to shared-memory ring %1")
+                                   .arg(m_segmentName);
+        }
+        return false;
+    }
+    m_status.acceptedFrames++;
+    m_status.hasLastDeliveredFrameIndex = true;
+    m_status.lastDeliveredFrameIndex = frame.outputFrameIndex;
+    m_status.state = QStringLiteral("active");
+    m_status.message = QStringLiteral("shared-memory ring %1 active (%2 slots)")
+                           .arg(m_segmentName)
+                           .arg(slotCountFor(m_assignment));
+    return true;
+}
+
+OutputSinkStatus SharedMemoryOutputSink::outputStatus() const {
+    QMutexLocker locker(&m_statusMutex);
+    return m_status;
+}
+
+void SharedMemoryOutputSink::setStatus(const QString& state, const QString& message) {
+    QMutexLocker locker(&m_statusMutex);
+    m_status.state = state;
+    m_status.message = message;
+}
+
+QString SharedMemoryOutputSink::segmentNameFor(const OutputTargetAssignment& assignment) {
+    const QString configured =
+        assignment.settings.value(QStringLiteral("segmentName")).toString().trimmed();
+    if (!configured.isEmpty()) return configured;
+    if (!assignment.id.trimmed().isEmpty())
+        return QStringLiteral("olr-%1").arg(assignment.id.trimmed());
+
+    switch (assignment.sourceBus.kind) {
+    case OutputBusKind::Feed:
+        return QStringLiteral("olr-feed%1").arg(assignment.sourceBus.index + 1);
+    case OutputBusKind::Multiview:
+        return QStringLiteral("olr-multiview");
+    case OutputBusKind::Pgm:
+        return QStringLiteral("olr-pgm");
+    }
+    return QStringLiteral("olr-output");
+}
+
+int SharedMemoryOutputSink::slotCountFor(const OutputTargetAssignment& assignment) {
+    bool ok = false;
+    const int requested = assignment.settings.value(QStringLiteral("slots")).toInt(&ok);
+    if (!ok || requested <= 0) return kDefaultSlots;
+    return qBound(2, requested, kMaxSlots);
+}
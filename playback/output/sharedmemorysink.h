@@ -0,0 +1,44 @@
+#ifndef SHAREDMEMORYSINK_H
+#define SHAREDMEMORYSINK_H
+
+#include "playback/output/outputsink.h"
+#include "playback/output/shmframering.h"
+
+#include <QMutex>
+
+// Publishes a bus into a named shared-memory frame ring (see shmframering.h) for local
+// consumers. Assignment settings: "segmentName" (default "olr-<id>" or "olr-pgm" /
+// "olr-multiview" / "olr-feed<N>") and "slots" (ring depth, default 4). The ring is
+// created on the first frame, sized from it, and recreated if a later frame outgrows it.
+class SharedMemoryOutputSink final : public IOutputSink {
+public:
+    static constexpr int kDefaultSlots = 4;
+    static constexpr int kMaxSlots = 64;
+
+    SharedMemoryOutputSink() = default;
+    ~SharedMemoryOutputSink() override;
+
+    OutputTargetKind kind() const override { return OutputTargetKind::SharedMemory; }
+    bool start(const OutputTargetAssignment& assignment, FrameRate rate) override;
+    void stop() override;
+    bool isActive() const override { return m_active; }
+    bool submit(const OutputBusFrame& frame) override;
+    OutputSinkStatus outputStatus() const override;
+
+    static QString segmentNameFor(const OutputTargetAssignment& assignment);
+    static int slotCountFor(const OutputTargetAssignment& assignment);
+
+private:
+    bool ensureRing(const OutputBusFrame& frame);
+    void setStatus(const QString& state, const QString& message);
+
+    OutputTargetAssignment m_assignment;
+    FrameRate m_rate;
+    QString m_segmentName;
+    bool m_active = false;
+    ShmFrameRingWriter m_ring;
+    mutable QMutex m_statusMutex;
+    OutputSinkStatus m_status;
+};
+
+#endif // SHAREDMEMORYSINK_H
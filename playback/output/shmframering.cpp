@@ -0,0 +1,474 @@
+#include "playback/output/shmframering.h"
+
+#include <QByteArray>
+#include <QThread>
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(Q_OS_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+
+namespace {
+
+using namespace shmring;
+
+constexpr quint64 kAlign = 64;
+constexpr quint32 kHeaderBytes = 4096;
+constexpr int kMaxSegmentNameChars = 30;
+constexpr int kReadAttempts = 4;
+
+quint64 alignUp(quint64 bytes) {
+    return (bytes + kAlign - 1) & ~(kAlign - 1);
+}
+
+// The doorbell is shared between processes, so the non-private futex ops are used.
+void wakeReaders(std::atomic<quint32>* doorbell) {
+#if defined(Q_OS_LINUX)
+    syscall(SYS_futex, reinterpret_cast<quint32*>(doorbell), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+#else
+    Q_UNUSED(doorbell);
+#endif
+}
+
+void parkOnDoorbell(std::atomic<quint32>* doorbell, quint32 seen, qint64 timeoutNs) {
+#if defined(Q_OS_LINUX)
+    timespec ts{};
+    ts.tv_sec = time_t(timeoutNs / 1000000000);
+    ts.tv_nsec = long(timeoutNs % 1000000000);
+    syscall(SYS_futex, reinterpret_cast<quint32*>(doorbell), FUTEX_WAIT, seen, &ts, nullptr,
+            0);
+#else
+    // No portable cross-process wait on a shared word: poll at well under a frame period.
+    Q_UNUSED(doorbell);
+    Q_UNUSED(seen);
+    QThread::usleep(quint64(qMin<qint64>(timeoutNs / 1000, 500)));
+#endif
+}
+
+int planeRows(int plane, int height) {
+    return plane == 0 ? height : (height + 1) / 2;
+}
+
+int planeRowBytes(int plane, int width) {
+    return plane == 0 ? width : (width + 1) / 2;
+}
+
+} // namespace
+
+namespace shmring {
+
+quint64 slotBytesFor(quint64 payloadBytes) {
+    return alignUp(sizeof(SlotHeader)) + alignUp(payloadBytes);
+}
+
+quint64 payloadBytesFor(int width, int height, FrameRate rate) {
+    quint64 video = 0;
+    for (int i = 0; i < kMaxPlanes; ++i) {
+        video += alignUp(quint64(qMax(0, planeRowBytes(i, width))) *
+                         quint64(qMax(0, planeRows(i, height))));
+    }
+    const qint64 samplesPerFrame =
+        rate.isValid() ? (qint64(48000) * rate.denominator + rate.numerator - 1) / rate.numerator
+                       : 48000 / 25;
+    const quint64 audio = alignUp(quint64(samplesPerFrame) * 2 * sizeof(qint16) * 2);
+    return video + audio;
+}
+
+QString nativeSegmentName(const QString& name) {
+    QString cleaned;
+    for (const QChar c : name.trimmed()) {
+        if (cleaned.isEmpty() && c == QLatin1Char('/')) continue;
+        const bool safe = (c >= QLatin1Char('a') && c <= QLatin1Char('z')) ||
+                          (c >= QLatin1Char('A') && c <= QLatin1Char('Z')) ||
+                          (c >= QLatin1Char('0') && c <= QLatin1Char('9')) ||
+                          c == QLatin1Char('.') || c == QLatin1Char('_') || c == QLatin1Char('-');
+        cleaned.append(safe ? c : QLatin1Char('-'));
+    }
+    cleaned.truncate(kMaxSegmentNameChars);
+    if (cleaned.isEmpty()) return QString();
+    return QLatin1Char('/') + cleaned;
+}
+
+qint64 steadyClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace shmring
+
+ShmFrameRingWriter::~ShmFrameRingWriter() {
+    close();
+}
+
+bool ShmFrameRingWriter::open(const QString& name, const Geometry& geometry, QString* error) {
+    close();
+    const auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+#if defined(Q_OS_UNIX)
+    const QString native = nativeSegmentName(name);
+    if (native.isEmpty()) return fail(QStringLiteral("shared-memory segment name is empty"));
+    if (geometry.slotCount < 2 || geometry.payloadBytes == 0)
+        return fail(QStringLiteral("shared-memory ring needs at least two non-empty slots"));
+
+    const QByteArray path = native.toLocal8Bit();
+    // A segment left behind by a crashed writer would otherwise block O_EXCL.
+    shm_unlink(path.constData());
+    const int fd = shm_open(path.constData(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) return fail(QStringLiteral("shm_open(%1) failed: %2").arg(native).arg(errno));
+
+    const quint64 slotBytes = slotBytesFor(geometry.payloadBytes);
+    const size_t total = size_t(kHeaderBytes + quint64(geometry.slotCount) * slotBytes);
+    if (ftruncate(fd, off_t(total)) != 0) {
+        const int err = errno;
+        ::close(fd);
+        shm_unlink(path.constData());
+        return fail(QStringLiteral("sizing %1 to %2 bytes failed: %3")
+                        .arg(native)
+                        .arg(qulonglong(total))
+                        .arg(err));
+    }
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        shm_unlink(path.constData());
+        return fail(QStringLiteral("mapping %1 failed: %2").arg(native).arg(err));
+    }
+
+    // ftruncate zero-fills, so every atomic starts at 0 before it is constructed in place.
+    auto* header = new (base) RingHeader();
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->slotCount = quint32(geometry.slotCount);
+    header->headerBytes = kHeaderBytes;
+    header->slotBytes = slotBytes;
+    header->payloadBytes = slotBytes - alignUp(sizeof(SlotHeader));
+    header->rateNumerator = geometry.rate.numerator;
+    header->rateDenominator = geometry.rate.denominator;
+    header->busKind = int(geometry.bus.kind);
+    header->busIndex = geometry.bus.index;
+    m_fd = fd;
+    m_base = base;
+    m_mappedBytes = total;
+    m_header = header;
+    m_name = native;
+    for (int i = 0; i < geometry.slotCount; ++i) new (slotAt(quint64(i) + 1)) SlotHeader();
+    header->writerOpen.store(1, std::memory_order_release);
+    return true;
+#else
+    Q_UNUSED(name);
+    Q_UNUSED(geometry);
+    return fail(QStringLiteral("shared-memory output is not supported on this platform"));
+#endif
+}
+
+void ShmFrameRingWriter::close() {
+#if defined(Q_OS_UNIX)
+    if (m_header) {
+        m_header->writerOpen.store(0, std::memory_order_release);
+        m_header->doorbell.fetch_add(1);
+        wakeReaders(&m_header->doorbell);
+    }
+    if (m_base) munmap(m_base, m_mappedBytes);
+    if (m_fd >= 0) ::close(m_fd);
+    if (!m_name.isEmpty()) shm_unlink(m_name.toLocal8Bit().constData());
+#endif
+    m_fd = -1;
+    m_base = nullptr;
+    m_mappedBytes = 0;
+    m_header = nullptr;
+    m_name.clear();
+}
+
+quint64 ShmFrameRingWriter::payloadBytes() const {
+    return m_header ? m_header->payloadBytes : 0;
+}
+
+quint64 ShmFrameRingWriter::published() const {
+    return m_header ? m_header->writeSeq.load(std::memory_order_relaxed) : 0;
+}
+
+SlotHeader* ShmFrameRingWriter::slotAt(quint64 frameNumber) const {
+    const quint64 index = (frameNumber - 1) % m_header->slotCount;
+    return reinterpret_cast<SlotHeader*>(static_cast<uchar*>(m_base) + m_header->headerBytes +
+                                         index * m_header->slotBytes);
+}
+
+bool ShmFrameRingWriter::publish(const OutputBusFrame& frame) {
+    if (!m_header) return false;
+
+    // Size everything before touching the slot, so a rejected frame leaves the ring as is.
+    const MediaVideoFrameView video(frame.video);
+    const QByteArray* planes[kMaxPlanes] = {&video.planeY, &video.planeU, &video.planeV};
+    const int strides[kMaxPlanes] = {video.strideY, video.strideU, video.strideV};
+    const bool hasVideo = video.isValid();
+    quint64 offsets[kMaxPlanes] = {0, 0, 0};
+    quint64 bytes[kMaxPlanes] = {0, 0, 0};
+    quint64 cursor = alignUp(sizeof(SlotHeader));
+    if (hasVideo) {
+        for (int i = 0; i < kMaxPlanes; ++i) {
+            const int rows = planeRows(i, video.height);
+            const int rowBytes = planeRowBytes(i, video.width);
+            if (strides[i] < rowBytes || planes[i]->size() < qsizetype(strides[i]) * rows)
+                return false;
+            offsets[i] = cursor;
+            bytes[i] = quint64(rowBytes) * quint64(rows);
+            cursor += alignUp(bytes[i]);
+        }
+    }
+    const MediaAudioFrame& audio = frame.audio;
+    const bool hasAudio =
+        audio.format == MediaSampleFormat::S16Interleaved && audio.channels > 0 &&
+        audio.sampleFrames() > 0;
+    const quint64 audioBytes =
+        hasAudio ? quint64(audio.sampleFrames()) * quint64(audio.channels) * sizeof(qint16) : 0;
+    const quint64 audioOffset = cursor;
+    if (audioOffset + audioBytes > m_header->slotBytes) return false;
+
+    const quint64 n = m_header->writeSeq.load(std::memory_order_relaxed) + 1;
+    SlotHeader* slot = slotAt(n);
+    uchar* slotBase = reinterpret_cast<uchar*>(slot);
+    slot->seq.store(2 * n - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const OutputFrameIdentity identity = outputFrameIdentityFor(frame);
+    slot->outputFrameIndex = identity.outputFrameIndex;
+    slot->sampledPlayheadMs = identity.sampledPlayheadMs;
+    slot->programmeTimecode100ns = frame.programmeTimecode100ns;
+    slot->sourcePtsMs = identity.sourcePtsMs;
+    slot->sourceFeedIndex = identity.sourceFeedIndex;
+    slot->flags = (identity.videoPlaceholder ? SlotVideoPlaceholder : 0u) |
+                  (identity.audioSilent ? SlotAudioSilent : 0u);
+    slot->videoHash = identity.videoHash;
+    slot->audioHash = identity.audioHash;
+    slot->videoGpuGeneration = identity.videoGpuGeneration;
+    slot->width = hasVideo ? video.width : 0;
+    slot->height = hasVideo ? video.height : 0;
+    for (int i = 0; i < kMaxPlanes; ++i) {
+        const int rowBytes = hasVideo ? planeRowBytes(i, video.width) : 0;
+        slot->stride[i] = rowBytes;
+        slot->planeOffset[i] = offsets[i];
+        slot->planeBytes[i] = bytes[i];
+        if (!hasVideo) continue;
+        const int rows = planeRows(i, video.height);
+        const char* src = planes[i]->constData();
+        uchar* dst = slotBase + offsets[i];
+        if (strides[i] == rowBytes) {
+            memcpy(dst, src, size_t(bytes[i]));
+        } else {
+            for (int y = 0; y < rows; ++y) {
+                memcpy(dst + qsizetype(y) * rowBytes, src + qsizetype(y) * strides[i],
+                       size_t(rowBytes));
+            }
+        }
+    }
+    slot->sampleRate = hasAudio ? audio.sampleRate : 0;
+    slot->channels = hasAudio ? audio.channels : 0;
+    slot->startSample = audio.startSample;
+    slot->audioOffset = audioOffset;
+    slot->audioBytes = audioBytes;
+    if (audioBytes > 0) memcpy(slotBase + audioOffset, audio.pcm.constData(), size_t(audioBytes));
+    slot->publishedAtNs = steadyClockNs();
+
+    slot->seq.store(2 * n, std::memory_order_release);
+    m_header->writeSeq.store(n, std::memory_order_release);
+    m_header->doorbell.fetch_add(1);
+    if (m_header->waiters.load() > 0) wakeReaders(&m_header->doorbell);
+    return true;
+}
+
+ShmFrameRingReader::~ShmFrameRingReader() {
+    close();
+}
+
+bool ShmFrameRingReader::open(const QString& name, QString* error) {
+    close();
+    const auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+#if defined(Q_OS_UNIX)
+    const QString native = nativeSegmentName(name);
+    if (native.isEmpty()) return fail(QStringLiteral("shared-memory segment name is empty"));
+    // Read-write: parking on the doorbell registers the reader in header.waiters.
+    const int fd = shm_open(native.toLocal8Bit().constData(), O_RDWR, 0);
+    if (fd < 0) return fail(QStringLiteral("no shared-memory ring %1 (%2)").arg(native).arg(errno));
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || quint64(st.st_size) < kHeaderBytes) {
+        ::close(fd);
+        return fail(QStringLiteral("shared-memory ring %1 is not initialised").arg(native));
+    }
+    const size_t total = size_t(st.st_size);
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        return fail(QStringLiteral("mapping %1 failed: %2").arg(native).arg(err));
+    }
+    auto* header = static_cast<RingHeader*>(base);
+    const quint64 needed = quint64(header->headerBytes) + quint64(header->slotCount) *
+                                                              header->slotBytes;
+    if (header->magic != kMagic || header->version != kVersion || header->slotCount < 2 ||
+        header->slotBytes < alignUp(sizeof(SlotHeader)) || needed > total) {
+        munmap(base, total);
+        ::close(fd);
+        return fail(QStringLiteral("%1 is not a compatible frame ring").arg(native));
+    }
+    m_fd = fd;
+    m_base = base;
+    m_mappedBytes = total;
+    m_header = header;
+    return true;
+#else
+    Q_UNUSED(name);
+    return fail(QStringLiteral("shared-memory output is not supported on this platform"));
+#endif
+}
+
+void ShmFrameRingReader::close() {
+#if defined(Q_OS_UNIX)
+    if (m_base) munmap(m_base, m_mappedBytes);
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+    m_fd = -1;
+    m_base = nullptr;
+    m_mappedBytes = 0;
+    m_header = nullptr;
+    m_lastSeq = 0;
+    m_dropped = 0;
+    m_started = false;
+}
+
+bool ShmFrameRingReader::writerOpen() const {
+    return m_header && m_header->writerOpen.load(std::memory_order_acquire) != 0;
+}
+
+FrameRate ShmFrameRingReader::rate() const {
+    if (!m_header) return FrameRate();
+    return FrameRate::fromFraction(m_header->rateNumerator, m_header->rateDenominator);
+}
+
+int ShmFrameRingReader::slotCount() const {
+    return m_header ? int(m_header->slotCount) : 0;
+}
+
+const SlotHeader* ShmFrameRingReader::slotAt(quint64 frameNumber) const {
+    const quint64 index = (frameNumber - 1) % m_header->slotCount;
+    return reinterpret_cast<const SlotHeader*>(static_cast<const uchar*>(m_base) +
+                                               m_header->headerBytes +
+                                               index * m_header->slotBytes);
+}
+
+bool ShmFrameRingReader::waitForFrame(int timeoutMs) {
+    if (!m_header) return false;
+    const auto available = [this] {
+        return m_header->writeSeq.load(std::memory_order_acquire) > m_lastSeq;
+    };
+    const qint64 deadline = steadyClockNs() + qint64(qMax(0, timeoutMs)) * 1000000;
+    for (;;) {
+        // Load the doorbell before re-checking, so a publish in between changes the word
+        // the futex compares against and the wait returns at once.
+        const quint32 seen = m_header->doorbell.load();
+        if (available()) return true;
+        if (!writerOpen()) return false;
+        const qint64 remaining = deadline - steadyClockNs();
+        if (remaining <= 0) return false;
+        m_header->waiters.fetch_add(1);
+        parkOnDoorbell(&m_header->doorbell, seen, remaining);
+        m_header->waiters.fetch_sub(1);
+    }
+}
+
+bool ShmFrameRingReader::fillView(quint64 frameNumber, ShmFrameView* view) const {
+    const SlotHeader* slot = slotAt(frameNumber);
+    if (slot->seq.load(std::memory_order_acquire) != 2 * frameNumber) return false;
+
+    const uchar* slotBase = reinterpret_cast<const uchar*>(slot);
+    const quint64 slotBytes = m_header->slotBytes;
+    ShmFrameView out;
+    out.sequence = frameNumber;
+    out.slot = slot;
+    out.identity.bus.kind = OutputBusKind(m_header->busKind);
+    out.identity.bus.index = m_header->busIndex;
+    out.identity.outputFrameIndex = slot->outputFrameIndex;
+    out.identity.sampledPlayheadMs = slot->sampledPlayheadMs;
+    out.identity.sourceFeedIndex = slot->sourceFeedIndex;
+    out.identity.sourcePtsMs = slot->sourcePtsMs;
+    out.identity.videoPlaceholder = (slot->flags & SlotVideoPlaceholder) != 0;
+    out.identity.audioSilent = (slot->flags & SlotAudioSilent) != 0;
+    out.identity.videoHash = slot->videoHash;
+    out.identity.audioHash = slot->audioHash;
+    out.identity.videoGpuGeneration = slot->videoGpuGeneration;
+    out.programmeTimecode100ns = slot->programmeTimecode100ns;
+    out.publishedAtNs = slot->publishedAtNs;
+    out.width = slot->width;
+    out.height = slot->height;
+    // Offsets come from another process: never hand out a pointer past this slot.
+    for (int i = 0; i < kMaxPlanes && out.width > 0; ++i) {
+        if (slot->planeOffset[i] + slot->planeBytes[i] > slotBytes) return false;
+        out.plane[i] = slotBase + slot->planeOffset[i];
+        out.stride[i] = slot->stride[i];
+    }
+    out.sampleRate = slot->sampleRate;
+    out.channels = slot->channels;
+    out.startSample = slot->startSample;
+    if (slot->audioBytes > 0 && out.channels > 0) {
+        if (slot->audioOffset + slot->audioBytes > slotBytes) return false;
+        out.pcm = reinterpret_cast<const qint16*>(slotBase + slot->audioOffset);
+        out.sampleFrames = int(slot->audioBytes / (quint64(out.channels) * sizeof(qint16)));
+    }
+    if (!isIntact(out)) return false;
+    *view = out;
+    return true;
+}
+
+bool ShmFrameRingReader::readNext(ShmFrameView* view) {
+    if (!m_header || !view) return false;
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        const quint64 newest = m_header->writeSeq.load(std::memory_order_acquire);
+        if (newest == 0 || newest <= m_lastSeq) return false;
+        // The writer may already be filling frame newest + 1, which reuses the slot of
+        // frame newest + 1 - slotCount: only the slotCount - 1 newest frames are safe.
+        const quint64 safe = quint64(m_header->slotCount) - 1;
+        const quint64 oldestSafe = newest > safe ? newest - safe + 1 : 1;
+        quint64 next = m_started ? m_lastSeq + 1 : newest;
+        if (next < oldestSafe) {
+            m_dropped += oldestSafe - next;
+            next = oldestSafe;
+        }
+        if (fillView(next, view)) {
+            m_lastSeq = next;
+            m_started = true;
+            return true;
+        }
+        // Lapped while reading: that frame is lost; the next pass re-reads the head.
+        m_dropped++;
+        m_lastSeq = next;
+        m_started = true;
+    }
+    return false;
+}
+
+bool ShmFrameRingReader::isIntact(const ShmFrameView& view) const {
+    if (!view.slot) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.slot->seq.load(std::memory_order_relaxed) == 2 * view.sequence;
+}
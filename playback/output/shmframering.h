@@ -0,0 +1,203 @@
+#ifndef SHMFRAMERING_H
+#define SHMFRAMERING_H
+
+#include "playback/output/outputbusengine.h"
+
+#include <QString>
+
+#include <atomic>
+#include <cstdint>
+
+// A POSIX shared-memory ring of output bus frames for consumers on the same machine
+// (graphics engines, analysis tools, local recorders). One writer (the shared-memory
+// output sink) publishes each bus frame's YUV420P planes, S16 PCM, OutputFrameIdentity
+// and programme timecode into the next of `slotCount` fixed-size slots; any number of
+// readers map the same segment and read slots in place, without copying.
+//
+// Protocol (no locks, no writer -> reader back-pressure):
+//   * Frames are numbered 1, 2, 3, ...; frame n lives in slot (n - 1) % slotCount.
+//   * The writer stores slot.seq = 2n - 1, fills the slot, stores slot.seq = 2n (release),
+//     then header.writeSeq = n (release) and bumps header.doorbell.
+//   * A reader takes the next frame it has not seen, checks slot.seq == 2n (acquire), uses
+//     the payload in place and re-checks slot.seq afterwards (isIntact). A changed seq means
+//     the writer lapped the reader while it was reading; the view must be discarded.
+//   * A reader that falls more than slotCount - 2 frames behind skips forward to the oldest
+//     frame the writer cannot be overwriting and counts the skipped frames as dropped.
+//   * Readers park on header.doorbell (a futex on Linux; a short poll elsewhere). The
+//     writer only issues the wake syscall while header.waiters is non-zero.
+//
+// The layout is host-endian and versioned; readers refuse a segment whose magic or
+// version differs. Segment names follow shm_open ("/name"; macOS allows 31 characters).
+namespace shmring {
+
+constexpr quint32 kMagic = 0x53524C4F; // "OLRS"
+constexpr quint32 kVersion = 1;
+constexpr int kMaxPlanes = 3;
+
+enum SlotFlag : quint32 {
+    SlotVideoPlaceholder = 1u << 0,
+    SlotAudioSilent = 1u << 1,
+};
+
+struct RingHeader {
+    quint32 magic;
+    quint32 version;
+    quint32 slotCount;
+    quint32 headerBytes;
+    quint64 slotBytes;    // distance between slots (slot header + payload)
+    quint64 payloadBytes; // video + audio bytes one slot can carry
+    qint32 rateNumerator;
+    qint32 rateDenominator;
+    qint32 busKind; // OutputBusKind
+    qint32 busIndex;
+    alignas(64) std::atomic<quint64> writeSeq; // last published frame number, 0 = none
+    std::atomic<quint32> doorbell;             // bumped on every publish and on close
+    std::atomic<quint32> waiters;              // readers parked on the doorbell
+    std::atomic<quint32> writerOpen;           // 0 once the writer has closed the segment
+};
+
+struct SlotHeader {
+    alignas(64) std::atomic<quint64> seq; // 2n - 1 while frame n is written, 2n once published
+    qint64 publishedAtNs;                 // steady clock at publish, for reader-side latency
+    qint64 outputFrameIndex;
+    qint64 sampledPlayheadMs;
+    qint64 programmeTimecode100ns;
+    qint64 sourcePtsMs;
+    qint32 sourceFeedIndex;
+    quint32 flags; // SlotFlag
+    quint32 videoHash;
+    quint32 audioHash;
+    quint64 videoGpuGeneration;
+    qint32 width;
+    qint32 height;
+    qint32 stride[kMaxPlanes];
+    quint32 reserved;
+    quint64 planeOffset[kMaxPlanes]; // from the start of the slot
+    quint64 planeBytes[kMaxPlanes];
+    qint32 sampleRate;
+    qint32 channels;
+    qint64 startSample;
+    quint64 audioOffset;
+    quint64 audioBytes; // interleaved S16
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free &&
+                  std::atomic<quint32>::is_always_lock_free,
+              "the shared-memory ring needs address-free (lock-free) atomics");
+
+// Bytes per slot for `payloadBytes` of video + audio, rounded to a cache line.
+quint64 slotBytesFor(quint64 payloadBytes);
+
+// Payload one slot needs for a `width` x `height` YUV420P frame at `rate`, plus twice one
+// frame period of 48 kHz stereo S16 (headroom for the audio cadence of fractional rates).
+quint64 payloadBytesFor(int width, int height, FrameRate rate);
+
+// "/olr-pgm" style shm_open name: a leading slash, [A-Za-z0-9._-] only, at most 30
+// characters after the slash. Empty when nothing usable remains.
+QString nativeSegmentName(const QString& name);
+
+qint64 steadyClockNs();
+
+} // namespace shmring
+
+class ShmFrameRingWriter {
+public:
+    struct Geometry {
+        int slotCount = 4;
+        quint64 payloadBytes = 0;
+        FrameRate rate;
+        OutputBusId bus;
+    };
+
+    ShmFrameRingWriter() = default;
+    ~ShmFrameRingWriter();
+    ShmFrameRingWriter(const ShmFrameRingWriter&) = delete;
+    ShmFrameRingWriter& operator=(const ShmFrameRingWriter&) = delete;
+
+    // Creates (replacing any stale segment of the same name) and maps the ring.
+    bool open(const QString& name, const Geometry& geometry, QString* error = nullptr);
+    // Marks the segment closed, wakes parked readers and unlinks the name. Readers that
+    // still have it mapped keep their mapping until they close.
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    QString name() const { return m_name; }
+    quint64 payloadBytes() const;
+    quint64 published() const;
+
+    // Copies the frame into the next slot. False when the frame does not fit the slot
+    // payload or the video is not YUV420P; nothing is published in that case.
+    bool publish(const OutputBusFrame& frame);
+
+private:
+    shmring::SlotHeader* slotAt(quint64 frameNumber) const;
+
+    QString m_name;
+    int m_fd = -1;
+    void* m_base = nullptr;
+    size_t m_mappedBytes = 0;
+    shmring::RingHeader* m_header = nullptr;
+};
+
+// A frame read in place from the ring. Pointers stay inside the reader's mapping and are
+// only meaningful while ShmFrameRingReader::isIntact(view) holds.
+struct ShmFrameView {
+    quint64 sequence = 0;
+    const shmring::SlotHeader* slot = nullptr;
+    OutputFrameIdentity identity;
+    qint64 programmeTimecode100ns = -1;
+    qint64 publishedAtNs = 0;
+    int width = 0;
+    int height = 0;
+    const uchar* plane[shmring::kMaxPlanes] = {nullptr, nullptr, nullptr};
+    int stride[shmring::kMaxPlanes] = {0, 0, 0};
+    int sampleRate = 0;
+    int channels = 0;
+    qint64 startSample = 0;
+    const qint16* pcm = nullptr;
+    int sampleFrames = 0;
+
+    bool isValid() const { return slot != nullptr; }
+};
+
+class ShmFrameRingReader {
+public:
+    ShmFrameRingReader() = default;
+    ~ShmFrameRingReader();
+    ShmFrameRingReader(const ShmFrameRingReader&) = delete;
+    ShmFrameRingReader& operator=(const ShmFrameRingReader&) = delete;
+
+    // Attaches to an existing ring. The first readNext() returns the newest frame.
+    bool open(const QString& name, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // False once the writer closed the segment; reopen to pick up a new one.
+    bool writerOpen() const;
+    FrameRate rate() const;
+    int slotCount() const;
+
+    // Blocks up to `timeoutMs` for a frame newer than the last one read.
+    bool waitForFrame(int timeoutMs);
+    // The next unread frame, skipping (and counting as dropped) any the writer lapped.
+    bool readNext(ShmFrameView* view);
+    // True while the slot behind `view` still holds that frame; check it after using the
+    // payload and discard whatever was read when it fails.
+    bool isIntact(const ShmFrameView& view) const;
+
+    quint64 lastSequence() const { return m_lastSeq; }
+    quint64 dropped() const { return m_dropped; }
+
+private:
+    const shmring::SlotHeader* slotAt(quint64 frameNumber) const;
+    bool fillView(quint64 frameNumber, ShmFrameView* view) const;
+
+    int m_fd = -1;
+    void* m_base = nullptr;
+    size_t m_mappedBytes = 0;
+    shmring::RingHeader* m_header = nullptr;
+    quint64 m_lastSeq = 0;
+    quint64 m_dropped = 0;
+    bool m_started = false;
+};
+
+#endif // SHMFRAMERING_H
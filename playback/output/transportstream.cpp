@@ -0,0 +1,158 @@
+#include "playback/output/transportstream.h"
+
+#include <QNetworkInterface>
+#include <QUdpSocket>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+
+template <typename T> void put(char* out, int offset, T value) {
+    qToLittleEndian(value, out + offset);
+}
+
+template <typename T> T get(const char* data, int offset) {
+    return qFromLittleEndian<T>(data + offset);
+}
+
+} // namespace
+
+namespace transportstream {
+
+void encode(const TransportStreamRecord& record, char out[kRecordBytes]) {
+    quint64 speedBits = 0;
+    static_assert(sizeof(speedBits) == sizeof(record.speed), "speed travels as an IEEE double");
+    std::memcpy(&speedBits, &record.speed, sizeof(speedBits));
+
+    quint32 flags = 0;
+    if (record.playing) flags |= FlagPlaying;
+    if (record.cutArmed) flags |= FlagCutArmed;
+    if (record.cutStaged) flags |= FlagCutStaged;
+    if (record.scheduledCutFrame >= 0) flags |= FlagCutScheduled;
+
+    put<quint32>(out, 0, kMagic);
+    put<quint16>(out, 4, kVersion);
+    put<quint16>(out, 6, quint16(kRecordBytes));
+    put<quint64>(out, 8, record.sequence);
+    put<qint64>(out, 16, record.outputFrameIndex);
+    put<qint64>(out, 24, record.sampledPlayheadMs);
+    put<qint64>(out, 32, record.programmeTimecode100ns);
+    put<quint64>(out, 40, speedBits);
+    put<qint64>(out, 48, record.scheduledCutFrame);
+    put<quint32>(out, 56, record.programmeTimecode);
+    put<quint32>(out, 60, flags);
+    put<qint32>(out, 64, record.rate.numerator);
+    put<qint32>(out, 68, record.rate.denominator);
+    put<quint32>(out, 72, record.channel);
+    put<quint32>(out, 76, 0);
+}
+
+bool decode(const char* data, qsizetype size, TransportStreamRecord* record) {
+    if (!data || size < kVersion1RecordBytes || get<quint32>(data, 0) != kMagic) return false;
+    const quint16 version = get<quint16>(data, 4);
+    if (version != 1 && version != kVersion) return false;
+    const int recordBytes = version == 1 ? kVersion1RecordBytes : kRecordBytes;
+    if (size < recordBytes || get<quint16>(data, 6) < recordBytes) return false;
+
+    const quint64 speedBits = get<quint64>(data, 40);
+    const quint32 flags = get<quint32>(data, 60);
+    TransportStreamRecord out;
+    out.sequence = get<quint64>(data, 8);
+    out.outputFrameIndex = get<qint64>(data, 16);
+    out.sampledPlayheadMs = get<qint64>(data, 24);
+    out.programmeTimecode100ns = get<qint64>(data, 32);
+    std::memcpy(&out.speed, &speedBits, sizeof(out.speed));
+    out.scheduledCutFrame = get<qint64>(data, 48);
+    out.programmeTimecode = get<quint32>(data, 56);
+    out.playing = flags & FlagPlaying;
+    out.cutArmed = flags & FlagCutArmed;
+    out.cutStaged = flags & FlagCutStaged;
+    out.rate = FrameRate::fromFraction(get<qint32>(data, 64), get<qint32>(data, 68));
+    out.channel = version == 1 ? 0 : get<quint32>(data, 72);
+    *record = out;
+    return true;
+}
+
+} // namespace transportstream
+
+TransportStreamOptions TransportStreamOptions::fromEnvironment() {
+    TransportStreamOptions options;
+    const QString destination = qEnvironmentVariable("OLR_TRANSPORT_STREAM").trimmed();
+    const int colon = destination.lastIndexOf(QLatin1Char(':'));
+    if (colon > 0) {
+        bool ok = false;
+        const uint port = destination.mid(colon + 1).toUInt(&ok);
+        QString host = destination.left(colon);
+        if (host.startsWith(QLatin1Char('[')) && host.endsWith(QLatin1Char(']'))) {
+            host = host.mid(1, host.size() - 2); // "[ff15::115]:8117"
+        }
+        const QHostAddress address(host);
+        if (ok && port > 0 && port <= 0xffff && !address.isNull()) {
+            options.address = address;
+            options.port = quint16(port);
+        }
+    }
+    bool ok = false;
+    const int ttl = qEnvironmentVariableIntValue("OLR_TRANSPORT_STREAM_TTL", &ok);
+    if (ok && ttl > 0) options.ttl = qMin(ttl, 255);
+    options.interfaceName = qEnvironmentVariable("OLR_TRANSPORT_STREAM_IF").trimmed();
+    return options;
+}
+
+TransportStreamSender::TransportStreamSender() = default;
+
+TransportStreamSender::~TransportStreamSender() {
+    close();
+}
+
+bool TransportStreamSender::open(const TransportStreamOptions& options, QString* error) {
+    close();
+    m_options = options;
+    m_nextSequence = 0;
+    if (!options.isEnabled()) return true;
+
+    auto socket = std::make_unique<QUdpSocket>();
+    // Bind first so the multicast options below have a socket to land on.
+    const QHostAddress any = options.address.protocol() == QAbstractSocket::IPv6Protocol
+                                 ? QHostAddress(QHostAddress::AnyIPv6)
+                                 : QHostAddress(QHostAddress::AnyIPv4);
+    if (!socket->bind(any, 0)) {
+        if (error) *error = socket->errorString();
+        return false;
+    }
+    if (options.address.isMulticast()) {
+        socket->setSocketOption(QAbstractSocket::MulticastTtlOption, options.ttl);
+        if (!options.interfaceName.isEmpty()) {
+            const QNetworkInterface egress =
+                QNetworkInterface::interfaceFromName(options.interfaceName);
+            if (!egress.isValid()) {
+                if (error) {
+                    *error = QStringLiteral("unknown interface %1").arg(options.interfaceName);
+                }
+                return false;
+            }
+            socket->setMulticastInterface(egress);
+        }
+    }
+    m_socket = std::move(socket);
+    return true;
+}
+
+void TransportStreamSender::close() {
+    m_socket.reset();
+}
+
+void TransportStreamSender::send(TransportStreamRecord record) {
+    if (!m_socket) return;
+    record.sequence = m_nextSequence++;
+    record.channel = m_options.channel;
+    char datagram[transportstream::kRecordBytes];
+    transportstream::encode(record, datagram);
+    if (m_socket->writeDatagram(datagram, sizeof(datagram), m_options.address, m_options.port) ==
+        qint64(sizeof(datagram))) {
+        m_sent++;
+    } else {
+        m_failures++;
+    }
+}
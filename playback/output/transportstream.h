@@ -0,0 +1,110 @@
+#ifndef TRANSPORTSTREAM_H
+#define TRANSPORTSTREAM_H
+
+#include "playback/framerate.h"
+
+#include <QHostAddress>
+#include <QString>
+
+#include <memory>
+
+class QUdpSocket;
+
+// One output frame's transport state, as external controllers (jog wheels, tally, graphics)
+// need it at frame rate: sent by the output runtime's dispatch thread after every tick,
+// without going through the GUI thread or the WebSocket API's throttled timecode.
+struct TransportStreamRecord {
+    quint64 sequence = 0; // datagram number since the stream opened, for loss detection
+    qint64 outputFrameIndex = -1;
+    qint64 sampledPlayheadMs = 0;
+    qint64 programmeTimecode100ns = -1;
+    quint32 programmeTimecode = 0; // SMPTE 12M packed BCD word at the output rate, 0 = none
+    double speed = 1.0;
+    bool playing = false;
+    bool cutArmed = false;
+    bool cutStaged = false;
+    qint64 scheduledCutFrame = -1;
+    FrameRate rate;
+    quint32 channel = 0; // playback channel (PlaybackChannel); 0 = the UI's own
+};
+
+// Wire format: one UDP datagram per record, kRecordBytes long, little-endian:
+//
+//   0  u32 magic "OLRT"          40  f64 speed
+//   4  u16 version               48  i64 scheduledCutFrame (-1 = none)
+//   6  u16 record bytes          56  u32 programme timecode (SMPTE 12M packed BCD)
+//   8  u64 sequence              60  u32 flags (Flag)
+//  16  i64 outputFrameIndex      64  i32 rate numerator
+//  24  i64 sampledPlayheadMs     68  i32 rate denominator
+//  32  i64 programmeTimecode100ns 72  u32 playback channel (version 2)
+//      (-1 = none)               76  u32 reserved, 0
+//
+// Readers check magic and version and use the record-bytes field to skip fields a later
+// version appends. Every playback channel's runtime streams to the same destination, so
+// receivers tell them apart by the channel field.
+namespace transportstream {
+
+constexpr quint32 kMagic = 0x54524C4F; // "OLRT"
+constexpr quint16 kVersion = 2;
+constexpr int kRecordBytes = 80;
+constexpr int kVersion1RecordBytes = 72; // no channel field: always channel 0
+
+enum Flag : quint32 {
+    FlagPlaying = 1u << 0,
+    FlagCutArmed = 1u << 1,
+    FlagCutStaged = 1u << 2,
+    FlagCutScheduled = 1u << 3,
+};
+
+void encode(const TransportStreamRecord& record, char out[kRecordBytes]);
+// Reads version 1 and 2 records. False when `size` is short, or the magic or version does
+// not match.
+bool decode(const char* data, qsizetype size, TransportStreamRecord* record);
+
+} // namespace transportstream
+
+struct TransportStreamOptions {
+    QHostAddress address;  // multicast group or unicast host; null = disabled
+    quint16 port = 0;
+    int ttl = 1;           // multicast hops; 1 keeps it on the local segment
+    QString interfaceName; // multicast egress interface; empty = the system default
+    quint32 channel = 0;   // stamped into every record; set by the channel's worker
+
+    bool isEnabled() const { return !address.isNull() && port != 0; }
+
+    // OLR_TRANSPORT_STREAM=<address>:<port> (e.g. "239.255.0.115:8117", "[ff15::115]:8117"),
+    // OLR_TRANSPORT_STREAM_TTL=<1..255>, OLR_TRANSPORT_STREAM_IF=<interface name>.
+    static TransportStreamOptions fromEnvironment();
+};
+
+// Sends transport records to the configured destination. Owned by the output runtime and
+// used only from the thread that dispatches its ticks: the socket is opened on that thread
+// and written synchronously, so no event loop is needed.
+class TransportStreamSender {
+public:
+    TransportStreamSender();
+    ~TransportStreamSender();
+    TransportStreamSender(const TransportStreamSender&) = delete;
+    TransportStreamSender& operator=(const TransportStreamSender&) = delete;
+
+    // Replaces the destination and restarts the sequence. Disabled options just close.
+    bool open(const TransportStreamOptions& options, QString* error = nullptr);
+    void close();
+    bool isOpen() const { return m_socket != nullptr; }
+
+    // Stamps the record's sequence and channel and sends it; a failed send is counted, not
+    // retried.
+    void send(TransportStreamRecord record);
+
+    quint64 sentRecords() const { return m_sent; }
+    quint64 sendFailures() const { return m_failures; }
+
+private:
+    std::unique_ptr<QUdpSocket> m_socket;
+    TransportStreamOptions m_options;
+    quint64 m_nextSequence = 0;
+    quint64 m_sent = 0;
+    quint64 m_failures = 0;
+};
+
+#endif // TRANSPORTSTREAM_H
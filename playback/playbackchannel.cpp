@@ -0,0 +1,74 @@
+#include "playback/playbackchannel.h"
+
+#include "playback/playbacktransport.h"
+#include "playback/shareddecodedframecache.h"
+
+#include <algorithm>
+
+int PlaybackChannel::countFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_PLAYBACK_CHANNELS");
+    if (env.isEmpty()) return 1;
+    bool ok = false;
+    const int parsed = env.toInt(&ok);
+    return ok ? std::clamp(parsed, 1, kMaxChannels) : 1;
+}
+
+PlaybackChannel::PlaybackChannel(int index, QObject* parent)
+    : QObject(parent), m_index(index), m_transport(new PlaybackTransport(this)) {}
+
+PlaybackChannel::~PlaybackChannel() { stop(); }
+
+void PlaybackChannel::start(const QString& videoPath, int feedCount, FrameRate rate,
+                            const QList<OutputTargetAssignment>& targets,
+                            std::shared_ptr<SharedDecodedFrameCache> frames) {
+    stop();
+    m_transport->setPlaying(false);
+    m_transport->setFrameRate(rate.numerator, rate.denominator);
+    m_transport->seek(0);
+
+    // No providers (nothing on screen) and no audio player: the channel only
+    // feeds its output targets.
+    const QList<FrameProvider*> providers(std::max(0, feedCount), nullptr);
+    m_worker = new PlaybackWorker(providers, m_transport, nullptr, this);
+    m_worker->setExternalOutputTargets(targets);
+    m_worker->setSharedFrameCache(std::move(frames));
+    m_worker->setPlaybackChannel(m_index);
+    m_worker->openFile(videoPath);
+    m_worker->start();
+}
+
+void PlaybackChannel::stop() {
+    if (!m_worker) return;
+    m_transport->setPlaying(false);
+    m_worker->stop();
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void PlaybackChannel::setOutputTargets(const QList<OutputTargetAssignment>& targets) {
+    if (m_worker) m_worker->setExternalOutputTargets(targets);
+}
+
+void PlaybackChannel::setSelectedOutputFeed(int feedIndex) {
+    if (m_worker) m_worker->setSelectedOutputFeed(feedIndex);
+}
+
+void PlaybackChannel::seek(qint64 positionMs, qint64 liveEdgeMs) {
+    m_transport->seek(std::clamp<qint64>(positionMs, 0, std::max<qint64>(0, liveEdgeMs)));
+    if (m_worker) m_worker->seekTo(m_transport->currentPos());
+}
+
+void PlaybackChannel::step(int frames, qint64 liveEdgeMs) {
+    m_transport->step(frames);
+    m_transport->setPlaying(false);
+    if (m_transport->currentPos() > liveEdgeMs) m_transport->seek(std::max<qint64>(0, liveEdgeMs));
+    if (m_worker) m_worker->seekTo(m_transport->currentPos());
+}
+
+PlaybackWorker::PlaybackCounters PlaybackChannel::counters() const {
+    return m_worker ? m_worker->counters() : PlaybackWorker::PlaybackCounters{};
+}
+
+OutputRuntimePublishedStats PlaybackChannel::publishedOutputStats() const {
+    return m_worker ? m_worker->publishedOutputStats() : OutputRuntimePublishedStats{};
+}
@@ -0,0 +1,60 @@
+#ifndef PLAYBACKCHANNEL_H
+#define PLAYBACKCHANNEL_H
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include <memory>
+
+#include "playback/framerate.h"
+#include "playback/output/outputruntime.h"
+#include "playback/output/outputtargetassignment.h"
+#include "playback/playbackworker.h"
+
+class PlaybackTransport;
+class SharedDecodedFrameCache;
+
+// One additional playback channel over the session's recording: its own transport,
+// worker and output targets (the assignments with this channel number), so a second
+// operator can cue or play a replay while channel 0 is on air. Channel 0 is
+// UIManager's own transport and worker, which the UI, playlist and Stream Deck drive;
+// channels from 1 up are driven over the control socket and have no on-screen preview
+// or local audio. Every channel reads the same recorder live ring and shares decoded
+// frames through one SharedDecodedFrameCache.
+class PlaybackChannel : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int kMaxChannels = 4;
+    // OLR_PLAYBACK_CHANNELS, 1 (channel 0 only) to kMaxChannels.
+    static int countFromEnvironment();
+
+    explicit PlaybackChannel(int index, QObject* parent = nullptr);
+    ~PlaybackChannel() override;
+
+    int index() const { return m_index; }
+    PlaybackTransport* transport() const { return m_transport; }
+    bool isRunning() const { return m_worker != nullptr; }
+
+    // (Re)starts the worker on `videoPath` with `feedCount` feeds, paused at 0.
+    void start(const QString& videoPath, int feedCount, FrameRate rate,
+               const QList<OutputTargetAssignment>& targets,
+               std::shared_ptr<SharedDecodedFrameCache> frames);
+    void stop();
+
+    void setOutputTargets(const QList<OutputTargetAssignment>& targets);
+    void setSelectedOutputFeed(int feedIndex);
+    // Moves the transport and repositions the worker, keeping to [0, liveEdgeMs].
+    void seek(qint64 positionMs, qint64 liveEdgeMs);
+    void step(int frames, qint64 liveEdgeMs);
+
+    PlaybackWorker::PlaybackCounters counters() const;
+    OutputRuntimePublishedStats publishedOutputStats() const;
+
+private:
+    const int m_index;
+    PlaybackTransport* m_transport;
+    PlaybackWorker* m_worker = nullptr;
+};
+
+#endif // PLAYBACKCHANNEL_H
@@ -4,10 +4,15 @@
 #include "playback/output/colormetadatapolicy.h"
 #include "playback/output/outputbusengine.h"
 #include "playback/output/outputframecache.h"
+#include "playback/output/isorecordersink.h"
+#include "playback/output/mpegtsstreamsink.h"
 #include "playback/output/ndisink.h"
 #include "playback/output/qtpreviewsink.h"
 #include "playback/output/queuedoutputsink.h"
+#include "playback/output/sharedmemorysink.h"
 #include "recorder_engine/ingest/colorvui.h"
+#include "recorder_engine/pipelinetrace.h"
+#include "recorder_engine/threadplacement.h"
 #ifdef OLR_GPU_PIPELINE_BUILD
 #include "playback/gpu/decodedonefence.h"
 #include "playback/gpu/gpuframedata.h"
@@ -26,6 +31,9 @@
 #include <QDebug>
 #include <QMutexLocker>
 #include <QElapsedTimer>
+#include <QSize>
+#include <algorithm>
+#include <climits>
 #include <cstdio>
 #include <cmath>
 #include <cstdint>
@@ -48,7 +56,12 @@ ColorMetadata colorMetadataForNativeTrack(const DecoderTrack* track) {
 
 PlaybackWorker::PlaybackWorker(const QList<FrameProvider*>& providers, PlaybackTransport* transport,
                                AudioPlayer* audioPlayer, QObject* parent)
-    : QThread(parent) {
+    : QThread(parent),
+      m_bankPool(
+          [this](const QString& path, AVIOInterruptCB interrupt) {
+              return DemuxBank::open(path, int(m_providers.size()), interrupt);
+          },
+          DemuxBankPool::capacityFromEnvironment()) {
     m_transport = transport;
     m_providers = providers;
     m_audioPlayer = audioPlayer;
@@ -56,6 +69,7 @@ PlaybackWorker::PlaybackWorker(const QList<FrameProvider*>& providers, PlaybackT
 
 PlaybackWorker::~PlaybackWorker() {
     stop();
+    m_bankPool.stop();
     shutdownOutputGraph();
     for (auto* track : m_decoderBank) {
         track->nativeDecoder.reset(); // Tear down VideoToolbox before freeing track
@@ -86,8 +100,26 @@ void PlaybackWorker::openFile(const QString& filePath) {
     m_currentFilePath = filePath;
 }
 
+QString PlaybackWorker::currentClipPath() const {
+    QMutexLocker locker(&m_mutex);
+    return m_currentFilePath;
+}
+
+void PlaybackWorker::setPrewarmClips(const QStringList& clipPaths) {
+    m_bankPool.setWanted(clipPaths);
+}
+
+void PlaybackWorker::setStagedCues(const QVector<PrerollCue>& cues) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_wantedCues = cues;
+    }
+    m_cuesDirty.store(true, std::memory_order_release);
+}
+
 void PlaybackWorker::seekTo(int64_t timestampMs) {
     const int64_t clamped = qMax<int64_t>(0, timestampMs);
+    PipelineTrace::instant("playback", "seek request", "targetMs", clamped);
     QMutexLocker locker(&m_mutex);
     // Record travel direction from the current playhead (spec §4/§5/§6.7):
     // drives reverse reposition anchoring, the backward-scrub audio re-prime,
@@ -147,6 +179,10 @@ void PlaybackWorker::setBusPreviewProviders(FrameProvider* multiviewProvider,
     m_outputTargetsDirty.store(true, std::memory_order_relaxed);
 }
 
+void PlaybackWorker::setSharedFrameCache(std::shared_ptr<SharedDecodedFrameCache> cache) {
+    m_sharedFrames = std::move(cache);
+}
+
 void PlaybackWorker::setExternalOutputTargets(const QList<OutputTargetAssignment>& assignments) {
     QMutexLocker locker(&m_mutex);
     m_externalOutputAssignments = assignments;
@@ -158,11 +194,32 @@ OutputDispatchStats PlaybackWorker::outputStats() const {
     return m_outputRuntime ? m_outputRuntime->stats() : OutputDispatchStats{};
 }
 
+OutputRuntimePublishedStats PlaybackWorker::publishedOutputStats() const {
+    QMutexLocker runtimeLocker(&m_outputRuntimeMutex);
+    return m_outputRuntime ? m_outputRuntime->publishedStats() : OutputRuntimePublishedStats{};
+}
+
+std::optional<FrameIndex> PlaybackWorker::frameIndexFor(const QString& clipPath) const {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (clipPath.isEmpty() || m_currentFilePath != clipPath) return std::nullopt;
+    }
+    QMutexLocker indexLocker(&m_frameIndexMutex);
+    return m_frameIndex;
+}
+
 PlaybackWorker::PlaybackCounters PlaybackWorker::counters() const {
     PlaybackCounters counters = m_counters;
 #ifdef OLR_GPU_PIPELINE_BUILD
     counters.gpuReadToCpuCount = gpuFrameReadToCpuCount();
 #endif
+    const LiveDemuxSource::Stats primaryRing = m_demux.stats();
+    const LiveDemuxSource::Stats prerollRing = m_prerollDemux.stats();
+    counters.liveRingPackets = primaryRing.ringPackets + prerollRing.ringPackets;
+    counters.liveRingFallbacks = primaryRing.ringFallbacks + prerollRing.ringFallbacks;
+    counters.readStalls = primaryRing.readStalls + prerollRing.readStalls;
+    counters.maxReadStallMs = qMax(primaryRing.maxReadNs, prerollRing.maxReadNs) / 1000000;
+    counters.readAheadBytes = m_readAhead.stats().bytesPrefetched;
     return counters;
 }
 
@@ -414,6 +471,22 @@ void PlaybackWorker::initializeOutputGraph(int feedCount, int width, int height)
         m_outputRuntime = std::make_unique<OutputRuntime>(
             m_transport->frameRate(), m_outputFeedCount, m_outputWidth, m_outputHeight);
         m_outputRuntime->setSnapshotProvider([this]() { return makeOutputSnapshot(); });
+        OutputRuntimeSchedulingOptions scheduling =
+            OutputRuntimeSchedulingOptions::fromEnvironment();
+        // OLR_OUTPUT_CPUS wins for channel 0; otherwise the dispatch thread takes its
+        // placement-plan core. The knob names one dispatcher, so another channel's always
+        // takes its own plan core (or floats) rather than contend for channel 0's.
+        if (m_playbackChannel > 0) {
+            scheduling.cpus = ThreadPlacement::plan().cpusFor(ThreadRole::Output,
+                                                              m_playbackChannel);
+            scheduling.reserveLastCpu = false;
+        } else if (scheduling.cpus.isEmpty() && !scheduling.reserveLastCpu) {
+            scheduling.cpus = ThreadPlacement::plan().cpusFor(ThreadRole::Output);
+        }
+        m_outputRuntime->setSchedulingOptions(scheduling);
+        TransportStreamOptions transportStream = TransportStreamOptions::fromEnvironment();
+        transportStream.channel = quint32(m_playbackChannel);
+        m_outputRuntime->setTransportStreamOptions(transportStream);
     }
     m_outputTargetsDirty.store(true, std::memory_order_relaxed);
     rebuildOutputEndpoints();
@@ -520,6 +593,16 @@ void PlaybackWorker::rebuildOutputEndpoints() {
         case OutputTargetKind::Ndi:
             sink = std::make_unique<QueuedOutputSink>(std::make_unique<NdiOutputSink>());
             break;
+        case OutputTargetKind::SharedMemory:
+            sink = std::make_unique<QueuedOutputSink>(std::make_unique<SharedMemoryOutputSink>());
+            break;
+        case OutputTargetKind::MpegTsStream:
+            sink = std::make_unique<QueuedOutputSink>(std::make_unique<MpegTsStreamOutputSink>());
+            break;
+        case OutputTargetKind::IsoRecorder:
+            sink = std::make_unique<QueuedOutputSink>(std::make_unique<IsoRecorderOutputSink>(),
+                                                      IsoRecorderOutputSink::kQueueCapacity);
+            break;
         case OutputTargetKind::QtPreview:
             break; // handled by the preview loop above; not expected in external list
         case OutputTargetKind::DeckLinkSdiHdmi:
@@ -737,9 +820,72 @@ OutputRuntimeSnapshot PlaybackWorker::makeOutputSnapshot() const {
     }
     snapshot.state.playing = m_transport && m_transport->isPlaying();
     snapshot.state.speed = m_transport ? m_transport->speed() : 1.0;
+    snapshot.state.cutArmed = m_cutArmed.load(std::memory_order_acquire);
+    snapshot.state.cutStaged =
+        snapshot.state.cutArmed && m_stagingCovers.load(std::memory_order_acquire);
+    snapshot.state.scheduledCutFrame = m_scheduledCutFrame.load(std::memory_order_acquire);
     return snapshot;
 }
 
+// ---------------------------------------------------------------------------
+// Varispeed audio (spec §6.7). Between kMinRate and kMaxRate forward, released
+// active-view audio is time-stretched (pitch kept) instead of dropped.
+// ---------------------------------------------------------------------------
+bool PlaybackWorker::audioAudibleAt(double speed) {
+    return (speed > 0.99 && speed < 1.01) ||
+           (speed >= TimeStretcher::kMinRate && speed <= TimeStretcher::kMaxRate);
+}
+
+int64_t PlaybackWorker::varispeedWallMs(int64_t mediaMs) const {
+    return m_varispeedAnchorWallMs +
+           std::llround(double(mediaMs - m_varispeedAnchorMediaMs) / m_varispeedRate);
+}
+
+void PlaybackWorker::releaseVarispeedAudio(int64_t P, double speed) {
+    if (m_varispeedAudio && qAbs(speed - m_varispeedRate) > 1e-3) {
+        // Rate change: re-anchor at P so the wall axis (and the player's alignment) stays
+        // continuous; the stretcher picks the new rate up at its next hop.
+        m_varispeedAnchorWallMs = varispeedWallMs(P);
+        m_varispeedAnchorMediaMs = P;
+        m_varispeedRate = speed;
+        m_audioStretcher.setRate(speed);
+    }
+    // kAudioLeadMs is a wall-time lead: in media time it shrinks with the rate so slow
+    // motion does not overfill the player's ring.
+    const int64_t leadMs = qMax<int64_t>(20, int64_t(kAudioLeadMs * speed));
+    const int bytesPerFrame = 2 * int(sizeof(int16_t));
+    AudioFrameQueue::Frame af;
+    QByteArray stretched;
+    while (m_audioQueue.releaseDue(P, leadMs, af)) {
+        const int frames = int(af.pcm.size()) / bytesPerFrame;
+        if (frames <= 0) continue;
+        if (!m_varispeedAudio || qAbs(af.ptsMs - m_varispeedNextPtsMs) > kVarispeedGapMs) {
+            // Entering varispeed, or a seek/re-prime broke PTS continuity: restart the
+            // stretcher and the wall axis at this frame.
+            m_audioStretcher.reset();
+            m_audioStretcher.setRate(speed);
+            m_audioPlayer->clear();
+            m_varispeedAudio = true;
+            m_varispeedRate = speed;
+            m_varispeedAnchorMediaMs = af.ptsMs;
+            m_varispeedAnchorWallMs = af.ptsMs;
+            m_varispeedWallOriginMs = af.ptsMs;
+        }
+        m_varispeedNextPtsMs = af.ptsMs + int64_t(frames) * 1000 / 48000;
+
+        const int64_t outPtsMs =
+            m_varispeedWallOriginMs + m_audioStretcher.outputFrames() * 1000 / 48000;
+        stretched.clear();
+        m_audioStretcher.process(reinterpret_cast<const int16_t*>(af.pcm.constData()), frames,
+                                 stretched);
+        if (stretched.isEmpty()) continue;
+        m_audioPlayer->pushSamples(reinterpret_cast<const uint8_t*>(stretched.constData()),
+                                   static_cast<int>(stretched.size()), outPtsMs,
+                                   varispeedWallMs(P));
+        m_counters.audioPushes++;
+    }
+}
+
 // ---------------------------------------------------------------------------
 // enqueueAudioFrame — format-guarded enqueue of active-view audio (spec §6.7).
 // Mirrors the old pushAudioFrame format guard (S16 / 48k / stereo) but routes
@@ -821,7 +967,13 @@ void PlaybackWorker::cacheOutputAudioFrame(AudioDecoderTrack* aTrack, AVFrame* a
 int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame* af, int64_t P,
                                              int dir, int trackCount, bool decimate,
                                              int decimateStep, bool audioOn, bool dedupTail) {
+    PipelineTraceScope trace("playback", "decode packet", "stream", pkt ? pkt->stream_index : -1);
+    // Every caller hands over a packet m_demux.read() has just returned.
+    const qint64 demuxedNs = PipelineTrace::nowNs();
     int64_t lastVideoPtsMs = INT64_MIN;
+    // A cross-clip cut fired: these are the old clip's packets, which must not
+    // reach the promoted (new-clip) cache before the run loop swaps the banks.
+    if (m_clipSwapPending.load(std::memory_order_acquire)) return lastVideoPtsMs;
     int cap = capFrames(trackCount);
 #ifdef OLR_GPU_PIPELINE_BUILD
     if (gpuPipelineEnabled()) {
@@ -838,6 +990,11 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
     for (auto* track : m_decoderBank) {
         if (pkt->stream_index != track->streamIndex) continue;
 
+        if (takeSharedFrame(track, pkt, cap, protectLo, protectHi, decimate, decimateStep,
+                            dedupTail, demuxedNs, &lastVideoPtsMs)) {
+            return lastVideoPtsMs;
+        }
+
         // H.264 tracks use NativeVideoDecoder (hardware); all others use FFmpeg.
         if (track->nativeDecoder) {
             // Convert avcC length-prefixed packet → Annex B for the decoder.
@@ -925,8 +1082,11 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
                 auto commitMediaFrame = [&](FrameHandle mediaFrame, int64_t framePtsMs) -> bool {
                     mediaFrame.metadata().key.ptsMs = framePtsMs;
                     if (!mediaFrame.isPresentable()) return false;
+                    mediaFrame.metadata().stamps.demuxedNs = demuxedNs;
+                    mediaFrame.metadata().stamps.decodedNs = PipelineTrace::nowNs();
                     {
                         QMutexLocker bufferLocker(bufferMutex);
+                        mediaFrame.metadata().stamps.cachedNs = PipelineTrace::nowNs();
                         TrackBuffer::EvictedFrames evictedTrackFrames;
                         if (!track->buffer.insert(framePtsMs, mediaFrame, cap, protectLo, protectHi,
                                                   &evictedTrackFrames)) {
@@ -1123,7 +1283,8 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
                     // dereferenced unconditionally above, so it is never null here.
                     // NOLINTNEXTLINE(clang-analyzer-core.CallAndMessage)
                     FrameHandle mediaFrame = convertToMediaVideoFrame(nativeVf, track->feedIndex);
-                    commitMediaFrame(mediaFrame, framePtsMs);
+                    mediaFrame.metadata().key.ptsMs = framePtsMs;
+                    if (commitMediaFrame(mediaFrame, framePtsMs)) publishSharedFrame(mediaFrame);
                     lastVideoPtsMs = framePtsMs;
                     av_frame_free(&nativeVf);
                 };
@@ -1171,6 +1332,7 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
                 // are harmlessly ignored and the index stays sorted.
                 if (!m_decoderBank.isEmpty() &&
                     track->streamIndex == m_decoderBank[0]->streamIndex && pkt->pos >= 0) {
+                    QMutexLocker indexLocker(&m_frameIndexMutex);
                     m_frameIndex.append(framePtsMs, static_cast<qint64>(pkt->pos));
                 }
 
@@ -1190,9 +1352,12 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
 
                 FrameHandle mediaFrame = convertToMediaVideoFrame(vf, track->feedIndex);
                 mediaFrame.metadata().key.ptsMs = framePtsMs;
+                mediaFrame.metadata().stamps.demuxedNs = demuxedNs;
+                mediaFrame.metadata().stamps.decodedNs = PipelineTrace::nowNs();
                 if (mediaFrame.isValid()) {
                     {
                         QMutexLocker bufferLocker(&m_bufferMutex);
+                        mediaFrame.metadata().stamps.cachedNs = PipelineTrace::nowNs();
                         TrackBuffer::EvictedFrames evictedTrackFrames;
                         if (!track->buffer.insert(framePtsMs, mediaFrame, cap, protectLo, protectHi,
                                                   &evictedTrackFrames))
@@ -1214,6 +1379,7 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
                     drainEvictedGpuFrames();
 #endif
                     m_counters.decodedVideoFrames++;
+                    publishSharedFrame(mediaFrame);
                 }
                 lastVideoPtsMs = framePtsMs;
                 av_frame_unref(vf);
@@ -1241,11 +1407,93 @@ int64_t PlaybackWorker::decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame
     return lastVideoPtsMs;
 }
 
+// ---------------------------------------------------------------------------
+// Shared decoded-frame cache (playback channels). Recordings are all-intra, so
+// leaving a packet out of a decoder never starves a later one of a reference;
+// a decoder with a reorder delay just releases its held frame on the next
+// packet it is given. GPU frames stay per channel: their surfaces are fenced
+// against this worker's renderer.
+// ---------------------------------------------------------------------------
+bool PlaybackWorker::takeSharedFrame(DecoderTrack* track, const AVPacket* pkt, int cap,
+                                     int64_t protectLo, int64_t protectHi, bool decimate,
+                                     int decimateStep, bool dedupTail, qint64 demuxedNs,
+                                     int64_t* lastVideoPtsMs) {
+    if (!m_sharedFrames) return false;
+#ifdef OLR_GPU_PIPELINE_BUILD
+    if (gpuPipelineEnabled()) return false;
+#endif
+    const int64_t pktPts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+    if (pktPts == AV_NOPTS_VALUE) return false;
+    const AVRational tb = m_fmtCtx->streams[track->streamIndex]->time_base;
+    const int64_t framePtsMs = av_rescale_q(pktPts, tb, {1, 1000});
+
+    FrameHandle frame = m_sharedFrames->find(m_currentFilePath, track->feedIndex, framePtsMs);
+    if (frame.isNull()) return false;
+
+    // From here the packet counts as decoded: same keep-counter, index and
+    // dedup rules as the decode paths below.
+    if (decimate) {
+        const bool keep = (track->decimateCounter % decimateStep) == 0;
+        track->decimateCounter++;
+        if (!keep) return true;
+    }
+    if (!track->nativeDecoder && !m_decoderBank.isEmpty() &&
+        track->streamIndex == m_decoderBank[0]->streamIndex && pkt->pos >= 0) {
+        QMutexLocker indexLocker(&m_frameIndexMutex);
+        m_frameIndex.append(framePtsMs, static_cast<qint64>(pkt->pos));
+    }
+    if (dedupTail) {
+        int64_t nv;
+        {
+            QMutexLocker bufferLocker(&m_bufferMutex);
+            nv = track->buffer.newestPts();
+        }
+        if (nv >= 0 && framePtsMs <= nv) return true;
+    }
+
+    frame.metadata().stamps = PlaybackFrameStamps{};
+    frame.metadata().stamps.demuxedNs = demuxedNs;
+    frame.metadata().stamps.decodedNs = PipelineTrace::nowNs();
+    {
+        QMutexLocker bufferLocker(&m_bufferMutex);
+        frame.metadata().stamps.cachedNs = PipelineTrace::nowNs();
+        TrackBuffer::EvictedFrames evictedTrackFrames;
+        if (!track->buffer.insert(framePtsMs, frame, cap, protectLo, protectHi,
+                                  &evictedTrackFrames))
+            m_counters.framesDropped++;
+#ifdef OLR_GPU_PIPELINE_BUILD
+        collectEvictedGpuFramesLocked(evictedTrackFrames);
+#endif
+        if (m_outputCache) {
+            OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
+            m_outputCache->insertVideoFrame(frame, &evictedCacheFrames);
+#ifdef OLR_GPU_PIPELINE_BUILD
+            collectEvictedGpuFramesLocked(evictedCacheFrames);
+#endif
+        }
+    }
+#ifdef OLR_GPU_PIPELINE_BUILD
+    drainEvictedGpuFrames();
+#endif
+    m_counters.sharedDecodeHits++;
+    *lastVideoPtsMs = framePtsMs;
+    return true;
+}
+
+void PlaybackWorker::publishSharedFrame(const FrameHandle& frame) {
+    if (!m_sharedFrames) return;
+#ifdef OLR_GPU_PIPELINE_BUILD
+    if (gpuPipelineEnabled()) return;
+#endif
+    m_sharedFrames->insert(m_currentFilePath, frame);
+}
+
 // ---------------------------------------------------------------------------
 // repositionTo (spec §6.2) — reuse fast-path or full trail-covering reposition.
 // ---------------------------------------------------------------------------
 void PlaybackWorker::repositionTo(int64_t target, int dir, AVPacket* pkt, AVFrame* vf, AVFrame* af,
                                   bool cutFollow) {
+    PipelineTraceScope trace("playback", "reposition", "targetMs", target);
     const int trackCount = qMax(1, int(m_decoderBank.size()));
     const uint64_t startedSeekGeneration = m_seekGeneration.load(std::memory_order_acquire);
 
@@ -1335,8 +1583,13 @@ void PlaybackWorker::repositionTo(int64_t target, int dir, AVPacket* pkt, AVFram
     // fall back to the proven coarse av_seek_frame BACKWARD. Fully additive: when
     // the region is unindexed, pb is not byte-seekable, the seek fails, or the
     // probe lands out of band, we behave exactly like before — no gate regresses.
+    //
+    // Live window first: if the anchor is still resident in the recorder's RAM
+    // packet ring, the fill below is served from memory and no file seek (or
+    // disk read of the region still being written) happens at all.
+    const bool ringSought = m_demux.tryServeFromRing(anchor);
     bool exactSought = false;
-    if (m_fmtCtx->pb) {
+    if (!ringSought && m_fmtCtx->pb) {
         const std::optional<qint64> offset = m_frameIndex.nearestAtOrBefore(anchor);
         if (offset.has_value() && avio_seek(m_fmtCtx->pb, offset.value(), SEEK_SET) >= 0) {
             avformat_flush(m_fmtCtx);
@@ -1363,7 +1616,7 @@ void PlaybackWorker::repositionTo(int64_t target, int dir, AVPacket* pkt, AVFram
             }
         }
     }
-    if (!exactSought) {
+    if (!ringSought && !exactSought) {
         int64_t seekPts = av_rescale_q(anchor, {1, 1000}, vStream->time_base);
         av_seek_frame(m_fmtCtx, vStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
     }
@@ -1428,8 +1681,11 @@ void PlaybackWorker::repositionTo(int64_t target, int dir, AVPacket* pkt, AVFram
             if (m_seekTargetMs >= 0) break;
         }
 
-        int ret = av_read_frame(m_fmtCtx, pkt);
-        if (ret < 0) break; // EOF/short file: deliver what we have
+        // A cross-clip cut fired mid-fill: the run loop switches clips next.
+        if (m_clipSwapPending.load(std::memory_order_acquire)) break;
+
+        int ret = m_demux.read(pkt);
+        if (ret < 0) break; // EOF/short file/ring live edge: deliver what we have
 
         // Reposition decodes forward from the anchor; protect the [target,
         // target+kLead] span (dir=+1) — the trail below target is also kept by
@@ -1544,188 +1800,374 @@ void PlaybackWorker::repositionTo(int64_t target, int dir, AVPacket* pkt, AVFram
 //     clears it first. v1 does not handle a manual seek racing an in-flight cut
 //     (out of scope) — armNextCut + the makeOutputSnapshot cut are the only
 //     writers of the schedule atomics.
+//   * Cross-clip cuts: fillStaging re-points the pre-roll at the armed clip
+//     (a DemuxBankPool bank) on the worker thread. When such a cut fires, the
+//     output thread only raises m_clipSwapPending; the worker swaps the primary
+//     and pre-roll banks at the top of its next pass (swapPrimaryAndPrerollBanks).
 // ---------------------------------------------------------------------------
 
-// Mirrors the primary open/init in run() (alloc_context, interrupt_callback,
-// avformat_open_input, find_stream_info, per-video-stream DecoderTrack +
-// per-audio AudioDecoderTrack) but writes the preroll members. No provider
-// wiring (the pre-roll feeds staging, not the live providers). Returns false on
-// failure; the caller leaves pre-roll disabled. Worker thread only.
+// Opens the pre-roll bank on the current clip (DemuxBank::open mirrors the
+// primary open/init in run(), minus provider wiring: the pre-roll feeds staging,
+// not the live providers). Returns false on failure; the caller leaves pre-roll
+// disabled. Worker thread only.
 bool PlaybackWorker::openPrerollContext() {
-    if (m_prerollFmtCtx) avformat_close_input(&m_prerollFmtCtx);
+    releasePrerollBank().reset();
+    std::unique_ptr<DemuxBank> bank =
+        DemuxBank::open(m_currentFilePath, int(m_providers.size()),
+                        AVIOInterruptCB{&PlaybackWorker::ffmpegInterruptCallback, this});
+    if (!bank) return false;
+    adoptPrerollBank(std::move(bank));
+    // Staging cache sized identically to m_outputCache.
+    m_prerollStagingCache =
+        std::make_unique<OutputFrameCache>(m_outputFeedCount, m_outputWidth, m_outputHeight);
+    qDebug() << "PlaybackWorker: pre-roll context opened (" << m_prerollBank.size()
+             << "video tracks )";
+    return true;
+}
 
-    AVFormatContext* ctx = avformat_alloc_context();
-    if (!ctx) return false;
-    ctx->interrupt_callback.callback = &PlaybackWorker::ffmpegInterruptCallback;
-    ctx->interrupt_callback.opaque = this;
-    if (avformat_open_input(&ctx, m_currentFilePath.toUtf8().constData(), nullptr, nullptr) < 0) {
-        avformat_close_input(&ctx);
-        return false;
-    }
-    m_prerollFmtCtx = ctx;
-    if (avformat_find_stream_info(m_prerollFmtCtx, nullptr) < 0) {
-        avformat_close_input(&m_prerollFmtCtx);
-        return false;
-    }
+void PlaybackWorker::adoptPrerollBank(std::unique_ptr<DemuxBank> bank) {
+    m_prerollDemux.detach();
+    m_prerollFmtCtx = bank->fmtCtx;
+    m_prerollFmtCtx->interrupt_callback.callback = &PlaybackWorker::ffmpegInterruptCallback;
+    m_prerollFmtCtx->interrupt_callback.opaque = this;
+    m_prerollBank = bank->video;
+    m_prerollAudioBank = bank->audio;
+    m_prerollClipPath = bank->path;
+    bank->fmtCtx = nullptr;
+    bank->video.clear();
+    bank->audio.clear();
+    m_prerollDemux.attach(m_prerollFmtCtx, m_prerollClipPath, m_prerollBank[0]->streamIndex);
+    m_bankPool.setInUse(m_prerollClipPath);
+}
 
-    // Build the pre-roll video bank, mapped 1:1 by stream order to feedIndex,
-    // exactly like the primary loop (but capped at the provider count so the
-    // feedIndex matches the live cache feeds).
-    int feedIndex = 0;
-    for (unsigned int i = 0; i < m_prerollFmtCtx->nb_streams; i++) {
-        AVCodecParameters* codecParams = m_prerollFmtCtx->streams[i]->codecpar;
-        if (codecParams->codec_type != AVMEDIA_TYPE_VIDEO) continue;
-        if (feedIndex >= m_providers.size()) break;
-
-        // H.264: hardware-only licensing constraint — NEVER software-decode.
-        // Mirror the primary bank guard: when HW is available and extradata is
-        // usable, build a NativeVideoDecoder exactly as the primary bank does
-        // (playbackworker.cpp:1463-1522) so the pre-roll bank can stage H.264
-        // frames. When HW is unavailable or avcC parse fails, skip (continue)
-        // so the bank stays empty and armNextCut returns false (graceful
-        // degradation, feature off for that file).
-        //
-        // Homogeneous-codec invariant: OLR recordings are single-codec by
-        // construction. Both layouts are now supported:
-        //   • all-H.264  → NativeVideoDecoder built, feedIndex advances 1:1
-        //   • all-MPEG-2 → no H.264 branch taken, existing FFmpeg path below
-        // A hypothetical externally-authored MIXED-codec file is out of scope.
-        if (codecParams->codec_id == AV_CODEC_ID_H264) {
-            if (queryNativeVideoDecodeCapabilities().h264 && codecParams->extradata_size >= 8) {
-                // Parse avcC extradata → SPS/PPS NAL payloads (verbatim from
-                // the primary bank, playbackworker.cpp:1466-1522).
-                H26xParameterSets params;
-                bool parseOk = true;
-                const uint8_t* ed = codecParams->extradata;
-                const int edSize = codecParams->extradata_size;
-                int off = 5;
-                const int numSps = off < edSize ? (ed[off] & 0x1f) : 0;
-                off++;
-                for (int s = 0; s < numSps && parseOk; ++s) {
-                    if (off + 2 > edSize) {
-                        parseOk = false;
-                        break;
-                    }
-                    const int len = (ed[off] << 8) | ed[off + 1];
-                    off += 2;
-                    if (len <= 0 || off + len > edSize) {
-                        parseOk = false;
-                        break;
-                    }
-                    params.h264Sps.append(QByteArray(reinterpret_cast<const char*>(ed + off), len));
-                    off += len;
-                }
-                if (parseOk && off < edSize) {
-                    const int numPps = ed[off++];
-                    for (int p = 0; p < numPps && parseOk; ++p) {
-                        if (off + 2 > edSize) {
-                            parseOk = false;
-                            break;
-                        }
-                        const int len = (ed[off] << 8) | ed[off + 1];
-                        off += 2;
-                        if (len <= 0 || off + len > edSize) {
-                            parseOk = false;
-                            break;
-                        }
-                        params.h264Pps.append(
-                            QByteArray(reinterpret_cast<const char*>(ed + off), len));
-                        off += len;
-                    }
-                }
-                if (!parseOk || params.h264Sps.isEmpty() || params.h264Pps.isEmpty()) {
-                    qWarning() << "PlaybackWorker: pre-roll H.264 avcC parse failed"
-                               << "for stream" << i << "— skipping (HW-only constraint)";
-                    continue;
-                }
-                DecoderTrack* track = new DecoderTrack();
-                track->streamIndex = static_cast<int>(i);
-                track->nativeDecoder =
-                    std::make_unique<NativeVideoDecoder>(codecParams->width, codecParams->height);
-                track->h264ParamSets = params;
-                track->codecWidth = codecParams->width;
-                track->codecHeight = codecParams->height;
-                track->codecCtx = nullptr;
-                track->provider = nullptr; // no live provider wiring for pre-roll
-                track->feedIndex = feedIndex;
-                m_prerollBank.append(track);
-                feedIndex++;
-                qDebug() << "PlaybackWorker: pre-roll NativeVideoDecoder (H.264)"
-                         << "stream" << i << "feedIndex" << (feedIndex - 1);
-                continue;
-            }
-            // No HW or bad extradata: skip — graceful degradation.
-            continue;
+std::unique_ptr<DemuxBank> PlaybackWorker::releasePrerollBank() {
+    m_prerollDemux.detach();
+    if (!m_prerollFmtCtx) return nullptr;
+    auto bank = std::make_unique<DemuxBank>();
+    bank->path = m_prerollClipPath;
+    bank->fmtCtx = m_prerollFmtCtx;
+    bank->video = m_prerollBank;
+    bank->audio = m_prerollAudioBank;
+    m_prerollFmtCtx = nullptr;
+    m_prerollBank.clear();
+    m_prerollAudioBank.clear();
+    m_prerollClipPath.clear();
+    return bank;
+}
+
+PlaybackWorker::PrerollSwitch PlaybackWorker::switchPrerollClip(const QString& clipPath) {
+    std::unique_ptr<DemuxBank> bank;
+    if (m_bankPool.contains(clipPath)) bank = m_bankPool.take(clipPath);
+    if (!bank) {
+        if (m_bankPool.capacity() <= 0) {
+            qWarning() << "PlaybackWorker: no bank pool to open" << clipPath
+                       << "— armed cut dropped";
+            return PrerollSwitch::Failed;
         }
+        const int64_t target = m_armedTargetMs.load();
+        if (!m_armedBankWait.isValid() || m_armedBankWaitClip != clipPath ||
+            m_armedBankWaitTargetMs != target) {
+            m_counters.bankPoolMisses++;
+            m_armedBankWait.start();
+            m_armedBankWaitClip = clipPath;
+            m_armedBankWaitTargetMs = target;
+            m_bankPool.setReserved({clipPath});
+        } else if (m_armedBankWait.hasExpired(kArmedBankWaitMs)) {
+            qWarning() << "PlaybackWorker: no bank for" << clipPath << "after"
+                       << kArmedBankWaitMs << "ms — armed cut dropped";
+            m_armedBankWait.invalidate();
+            m_bankPool.setReserved({}); // the cue slots re-reserve on their next pass
+            return PrerollSwitch::Failed;
+        }
+        return PrerollSwitch::Waiting;
+    }
+    if (m_armedBankWait.isValid()) {
+        m_armedBankWait.invalidate();
+        m_bankPool.setReserved({}); // taken: the warmer must not open a second one
+    }
+    m_counters.bankPoolHits++;
+    if (!bankFitsSession(*bank)) {
+        qWarning() << "PlaybackWorker:" << clipPath
+                   << "does not match the session's feed layout — armed cut dropped";
+        m_bankPool.put(std::move(bank));
+        return PrerollSwitch::Failed;
+    }
+    m_bankPool.put(releasePrerollBank());
+    adoptPrerollBank(std::move(bank));
+    return PrerollSwitch::Switched;
+}
 
-        const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
-        if (!codec) continue;
-        AVCodecContext* cctx = avcodec_alloc_context3(codec);
-        if (!cctx) continue;
-        avcodec_parameters_to_context(cctx, codecParams);
-        cctx->thread_count = 0;
-        if (avcodec_open2(cctx, codec, nullptr) < 0) {
-            avcodec_free_context(&cctx);
-            continue;
+namespace {
+QSize decodedTrackSize(const DecoderTrack* track) {
+    if (track->codecCtx) return QSize(track->codecCtx->width, track->codecCtx->height);
+    return QSize(track->codecWidth, track->codecHeight);
+}
+} // namespace
+
+bool PlaybackWorker::bankFitsSession(const DemuxBank& bank) const {
+    if (bank.video.isEmpty() || bank.video.size() != m_decoderBank.size()) return false;
+    for (qsizetype i = 0; i < bank.video.size(); ++i) {
+        if (decodedTrackSize(bank.video[i]) != decodedTrackSize(m_decoderBank[i])) return false;
+    }
+    const QSize ref = decodedTrackSize(bank.video[0]);
+    return qMax(2, ref.width()) == m_outputWidth && qMax(2, ref.height()) == m_outputHeight;
+}
+
+// Worker thread only. The bank vectors are swapped under m_bufferMutex, the
+// lock deliverDueFrames and the trim take while walking m_decoderBank.
+void PlaybackWorker::swapPrimaryAndPrerollBanks() {
+    clearDecoderBuffers(/*invalidateGpuGeneration*/ false);
+    m_readAhead.close();
+    m_demux.detach();
+    m_prerollDemux.detach();
+    {
+        QMutexLocker bufferLocker(&m_bufferMutex);
+        std::swap(m_fmtCtx, m_prerollFmtCtx);
+        std::swap(m_decoderBank, m_prerollBank);
+        std::swap(m_audioDecoderBank, m_prerollAudioBank);
+        for (auto* track : m_decoderBank) {
+            track->provider = m_providers.value(track->feedIndex, nullptr);
+            track->lastDeliveredPtsMs = -1;
+            track->decimateCounter = 0;
         }
-        DecoderTrack* track = new DecoderTrack();
-        track->streamIndex = static_cast<int>(i);
-        track->codecCtx = cctx;
-        track->provider = nullptr; // no live provider wiring for pre-roll
-        track->feedIndex = feedIndex;
-        m_prerollBank.append(track);
-        feedIndex++;
-    }
-
-    // Build the pre-roll audio bank (paired with video by order), like primary.
-    int audioViewIdx = 0;
-    for (unsigned int i = 0; i < m_prerollFmtCtx->nb_streams; i++) {
-        AVCodecParameters* codecParams = m_prerollFmtCtx->streams[i]->codecpar;
-        if (codecParams->codec_type != AVMEDIA_TYPE_AUDIO) continue;
-        const AVCodec* codec = avcodec_find_decoder(codecParams->codec_id);
-        if (!codec) {
-            audioViewIdx++;
-            continue;
+        for (auto* track : m_prerollBank) {
+            track->provider = nullptr;
+            TrackBuffer::EvictedFrames evicted;
+            track->buffer.clear(&evicted);
+#ifdef OLR_GPU_PIPELINE_BUILD
+            collectEvictedGpuFramesLocked(evicted);
+#endif
         }
-        AVCodecContext* cctx = avcodec_alloc_context3(codec);
-        if (!cctx) {
-            audioViewIdx++;
-            continue;
+    }
+#ifdef OLR_GPU_PIPELINE_BUILD
+    drainEvictedGpuFrames();
+#endif
+    for (auto* aTrack : m_audioDecoderBank) {
+        aTrack->lastEnqueuedPtsMs = -1;
+        aTrack->lastCachedPtsMs = -1;
+    }
+    // Per-clip primary state: the offset index, the EOF growth latch and the
+    // reverse-chunk anchor all described the old file. The index is cleared before
+    // the path changes so frameIndexFor never pairs the new clip with old offsets.
+    {
+        QMutexLocker indexLocker(&m_frameIndexMutex);
+        m_frameIndex.clear();
+    }
+    QString oldClip;
+    {
+        QMutexLocker locker(&m_mutex);
+        oldClip = m_currentFilePath;
+        m_currentFilePath = m_prerollClipPath;
+    }
+    m_prerollClipPath = oldClip;
+    m_sizeAtLastEof = -1;
+    m_reverseAnchorMs = INT64_MAX;
+    m_audioQueue.clear();
+    m_demux.attach(m_fmtCtx, m_currentFilePath, m_decoderBank[0]->streamIndex);
+    m_prerollDemux.attach(m_prerollFmtCtx, m_prerollClipPath, m_prerollBank[0]->streamIndex);
+    if (!m_readAhead.open(m_currentFilePath))
+        qWarning() << "PlaybackWorker: demux read-ahead unavailable for" << m_currentFilePath;
+    m_bankPool.setInUse(m_prerollClipPath);
+    m_counters.clipSwitches++;
+}
+
+// ---------------------------------------------------------------------------
+// Multi-slot pre-roll: besides the armed cut's own pre-roll, up to N cue slots
+// (CueSlotPlan budget) keep upcoming cues — the next playlist boundaries, the
+// clips after the last Recall — staged on their own demux banks. Arming a cut
+// whose window a covered slot holds swaps that slot's bank and cache into the
+// pre-roll (takeStagedCue), so the cut schedules on the next pass without a
+// seek or a decode. Slots are worker-thread-only; the UI thread only replaces
+// the wanted list (setStagedCues) under m_mutex.
+// ---------------------------------------------------------------------------
+
+// Sized from the memory budget: each slot holds a full staged window (trail +
+// span on every feed), like m_prerollStagingCache. Worker thread only.
+void PlaybackWorker::createCueSlots() {
+    const qint64 perSlot = CueSlotPlan::bytesPerSlot(
+        m_outputFeedCount, m_outputWidth, m_outputHeight, fps(), kTrailMs + kStagingSpanMs);
+    const int count = CueSlotPlan::slotCount(CueSlotPlan::budgetBytesFromEnvironment(), perSlot,
+                                             CueSlotPlan::maxSlotsFromEnvironment());
+    releaseCueSlots();
+    for (int i = 0; i < count; ++i) m_cueSlots.push_back(std::make_unique<CueSlot>());
+    m_cuesDirty.store(true, std::memory_order_release);
+    qDebug() << "PlaybackWorker:" << count << "pre-roll cue slots (" << perSlot / (1024 * 1024)
+             << "MB each )";
+}
+
+void PlaybackWorker::releaseCueSlots() {
+    for (auto& slot : m_cueSlots) {
+        slot->demux.detach();
+        clearCueSlotCache(*slot);
+    }
+    m_cueSlots.clear();
+    m_bankPool.setReserved({});
+}
+
+void PlaybackWorker::clearCueSlotCache(CueSlot& slot) {
+    slot.newestRefPtsMs = INT64_MIN;
+    if (!slot.cache) return;
+    OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
+    slot.cache->clear(&evictedCacheFrames);
+#ifdef OLR_GPU_PIPELINE_BUILD
+    QMutexLocker bufferLocker(&m_bufferMutex);
+    collectEvictedGpuFramesLocked(evictedCacheFrames);
+#endif
+}
+
+PlaybackWorker::StagingTarget PlaybackWorker::cueSlotStagingTarget(CueSlot& slot) {
+    return StagingTarget{slot.bank->fmtCtx, &slot.bank->video, &slot.bank->audio, &slot.demux,
+                         slot.cache.get(), &slot.newestRefPtsMs};
+}
+
+// Re-plans the slots against the latest wanted cues: slots already holding a
+// wanted cue keep their staged window, the others are re-pointed (their bank
+// goes back to the pool when the clip changes) and restaged. Slots are kept in
+// fill order — highest-priority cue first, free slots last.
+void PlaybackWorker::reassignCueSlots() {
+    QVector<PrerollCue> wanted;
+    QString current;
+    {
+        QMutexLocker locker(&m_mutex);
+        wanted = m_wantedCues;
+        current = m_currentFilePath;
+    }
+    for (PrerollCue& cue : wanted)
+        cue.clipPath = DemuxBankPool::keyFor(cue.clipPath.isEmpty() ? current : cue.clipPath);
+    QVector<PrerollCue> held;
+    for (const auto& slot : m_cueSlots) held.append(slot->cue);
+    const QVector<int> plan = CueSlotPlan::assign(held, wanted);
+    for (int j = 0; j < plan.size(); ++j) {
+        CueSlot& slot = *m_cueSlots[size_t(j)];
+        slot.priority = plan[j] >= 0 ? plan[j] : INT_MAX;
+        const PrerollCue next = plan[j] >= 0 ? wanted[plan[j]] : PrerollCue();
+        if (next == slot.cue) continue;
+        slot.cue = next;
+        slot.covers = false;
+        slot.awaitingBank = false;
+        slot.seekPending = next.isValid();
+        clearCueSlotCache(slot);
+        if (slot.bank &&
+            (!next.isValid() || DemuxBankPool::keyFor(slot.bank->path) != next.clipPath)) {
+            slot.demux.detach();
+            m_bankPool.put(std::move(slot.bank));
         }
-        avcodec_parameters_to_context(cctx, codecParams);
-        cctx->thread_count = 0;
-        if (avcodec_open2(cctx, codec, nullptr) < 0) {
-            avcodec_free_context(&cctx);
-            audioViewIdx++;
+    }
+    std::stable_sort(m_cueSlots.begin(), m_cueSlots.end(),
+                     [](const auto& a, const auto& b) { return a->priority < b->priority; });
+#ifdef OLR_GPU_PIPELINE_BUILD
+    drainEvictedGpuFrames();
+#endif
+}
+
+// A bank for the slot's clip, only ever one the pool's warmer has opened:
+// opening it here would stall decode on avformat_open_input and stream
+// probing. On a miss the slot waits for the bank fillCueSlots reserves for it.
+// A bank whose track count does not match the session drops the cue until the
+// wanted list changes.
+bool PlaybackWorker::acquireCueSlotBank(CueSlot& slot) {
+    std::unique_ptr<DemuxBank> bank;
+    if (m_bankPool.contains(slot.cue.clipPath)) bank = m_bankPool.take(slot.cue.clipPath);
+    if (!bank) {
+        if (!slot.awaitingBank) m_counters.bankPoolMisses++;
+        slot.awaitingBank = true;
+        return false;
+    }
+    slot.awaitingBank = false;
+    m_counters.bankPoolHits++;
+    if (!bankFitsSession(*bank)) {
+        qWarning() << "PlaybackWorker: cannot stage" << slot.cue.clipPath << "in a cue slot";
+        m_bankPool.put(std::move(bank));
+        slot.cue = PrerollCue();
+        slot.priority = INT_MAX;
+        return false;
+    }
+    bank->fmtCtx->interrupt_callback.callback = &PlaybackWorker::ffmpegInterruptCallback;
+    bank->fmtCtx->interrupt_callback.opaque = this;
+    slot.demux.attach(bank->fmtCtx, bank->path, bank->video[0]->streamIndex);
+    slot.bank = std::move(bank);
+    slot.seekPending = true;
+    return true;
+}
+
+// One bounded batch (kPrerollPacketsPerTick) into the highest-priority slot
+// that has a bank and is not yet covered. Slots still without a bank are
+// skipped and reserved in the bank pool, one bank each. Runs only while the
+// armed pre-roll is idle, so the armed cut always stages first.
+void PlaybackWorker::fillCueSlots() {
+    if (m_cueSlots.empty() || m_clipSwapPending.load(std::memory_order_acquire)) return;
+    if (m_cuesDirty.exchange(false, std::memory_order_acq_rel)) reassignCueSlots();
+    QStringList waiting;
+    CueSlot* target = nullptr;
+    for (auto& slotPtr : m_cueSlots) {
+        CueSlot& slot = *slotPtr;
+        if (!slot.cue.isValid() || slot.covers) continue;
+        if (!slot.bank && !acquireCueSlotBank(slot)) {
+            if (slot.awaitingBank) waiting.append(slot.cue.clipPath);
             continue;
         }
-        AudioDecoderTrack* aTrack = new AudioDecoderTrack();
-        aTrack->streamIndex = static_cast<int>(i);
-        aTrack->codecCtx = cctx;
-        aTrack->viewIndex = audioViewIdx;
-        m_prerollAudioBank.append(aTrack);
-        audioViewIdx++;
+        if (!target) target = &slot;
     }
+    m_bankPool.setReserved(waiting);
+    if (!target) return;
 
-    if (m_prerollBank.isEmpty()) {
-        avformat_close_input(&m_prerollFmtCtx);
-        return false;
+    CueSlot& slot = *target;
+    if (!slot.cache) {
+        slot.cache =
+            std::make_unique<OutputFrameCache>(m_outputFeedCount, m_outputWidth, m_outputHeight);
     }
-    // Staging cache sized identically to m_outputCache.
-    m_prerollStagingCache =
-        std::make_unique<OutputFrameCache>(m_outputFeedCount, m_outputWidth, m_outputHeight);
-    qDebug() << "PlaybackWorker: pre-roll context opened (" << m_prerollBank.size()
-             << "video tracks )";
+    const StagingTarget staging = cueSlotStagingTarget(slot);
+    if (slot.seekPending) {
+        rewindStaging(staging, slot.cue.targetMs);
+        slot.seekPending = false;
+    }
+    slot.covers = stagePackets(staging, slot.cue.targetMs);
+    if (slot.covers) m_counters.cueSlotsStaged++;
+#ifdef OLR_GPU_PIPELINE_BUILD
+    drainEvictedGpuFrames();
+#endif
+}
+
+// Hands a covered slot holding (clipPath, targetMs) to the armed pre-roll: the
+// slot's bank and cache become the pre-roll's, and the slot keeps the old
+// pre-roll bank for its next cue. False when no covered slot matches.
+bool PlaybackWorker::takeStagedCue(const QString& clipPath, int64_t targetMs) {
+    QVector<PrerollCue> held;
+    for (const auto& slot : m_cueSlots) held.append(slot->covers ? slot->cue : PrerollCue());
+    const int index =
+        CueSlotPlan::find(held, PrerollCue{DemuxBankPool::keyFor(clipPath), targetMs});
+    if (index < 0) return false;
+    CueSlot& slot = *m_cueSlots[size_t(index)];
+    slot.demux.detach();
+    std::unique_ptr<DemuxBank> previous = releasePrerollBank();
+    adoptPrerollBank(std::move(slot.bank));
+    std::swap(m_prerollStagingCache, slot.cache);
+    m_stagingNewestRefPtsMs = slot.newestRefPtsMs;
+    slot.cue = PrerollCue();
+    slot.priority = INT_MAX;
+    slot.covers = false;
+    slot.seekPending = false;
+    clearCueSlotCache(slot);
+    slot.bank = std::move(previous);
+    if (slot.bank)
+        slot.demux.attach(slot.bank->fmtCtx, slot.bank->path, slot.bank->video[0]->streamIndex);
+    std::stable_sort(m_cueSlots.begin(), m_cueSlots.end(),
+                     [](const auto& a, const auto& b) { return a->priority < b->priority; });
+    m_counters.cueSlotHits++;
     return true;
 }
 
-// UI-thread-safe: atomic stores only, never blocks. Arms a scheduled atomic cut
-// to targetMs. Returns false (feature unavailable) if the pre-roll context
-// failed to open (e.g. H.264 recordings: the pre-roll bank is hardware-only-
-// guarded and stays empty). Returns true when the cut is armed or queued for
-// re-arm. v1 is single-clip (ms-only; same currently-open file).
-bool PlaybackWorker::armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs) {
-    if (!m_prerollFmtCtx) return false; // pre-roll disabled — feature unavailable
+// UI-thread-safe: atomic stores plus a brief m_mutex hold for the clip path;
+// never waits on the worker. Arms a scheduled atomic cut to targetMs. Returns
+// false (feature unavailable) if the pre-roll context failed to open (e.g.
+// H.264 recordings on a machine without a HW decoder: the pre-roll bank never
+// software-decodes H.264, so it stays empty). Returns true when the cut is
+// armed or queued for re-arm. clipPath (empty = current clip) is resolved on
+// the worker when the pre-roll starts staging (fillStaging).
+bool PlaybackWorker::armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs,
+                                const QString& clipPath) {
+    if (!m_armedCutReady.load(std::memory_order_acquire))
+        return false; // pre-roll disabled — feature unavailable
     // Safe re-arm queue: a re-arm (rapid double "Recall") while a cut is already
     // armed/in-flight must NOT reset the staging state from this (UI) thread. The
     // worker fills m_prerollStagingCache lock-free and only stops once
@@ -1736,6 +2178,10 @@ bool PlaybackWorker::armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs) {
     // in-flight cut clears m_cutArmed, so the re-arm and its staging fill run
     // sequentially on the worker thread. Latest queued target wins.
     if (m_cutArmed.load(std::memory_order_acquire)) {
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pendingRearmClipPath = clipPath;
+        }
         m_pendingRearmMs.store(targetMs < 0 ? 0 : targetMs);
         m_pendingRearmFireAtMs.store(fireAtPlayheadMs, std::memory_order_relaxed);
         // Capture the seek generation NOW (queue time): if a manual seek lands
@@ -1748,7 +2194,8 @@ bool PlaybackWorker::armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs) {
     }
     // Fresh arm: armNextCut and seekTo are both UI-thread, so reading m_seekGeneration
     // here is a coherent baseline (no seek can interleave between this read and the arm).
-    armCutInternal(targetMs, m_seekGeneration.load(std::memory_order_acquire), fireAtPlayheadMs);
+    armCutInternal(targetMs, m_seekGeneration.load(std::memory_order_acquire), fireAtPlayheadMs,
+                   clipPath);
     return true;
 }
 
@@ -1758,7 +2205,11 @@ bool PlaybackWorker::armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs) {
 // thread (queued re-arm applied in the run loop). m_cutArmed is released LAST so
 // a worker observing it true (acquire) sees the target/seek-pending stores.
 void PlaybackWorker::armCutInternal(int64_t targetMs, uint64_t baselineSeekGen,
-                                    int64_t fireAtPlayheadMs) {
+                                    int64_t fireAtPlayheadMs, const QString& clipPath) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_armedClipPath = clipPath;
+    }
     m_armedTargetMs.store(targetMs < 0 ? 0 : targetMs);
     m_armedFireAtMs.store(fireAtPlayheadMs);
     m_prerollSeekPending.store(true);
@@ -1775,42 +2226,44 @@ void PlaybackWorker::armCutInternal(int64_t targetMs, uint64_t baselineSeekGen,
     m_cutArmed.store(true, std::memory_order_release);
 }
 
-// Worker-thread-only. Bounded incremental pre-roll into m_prerollStagingCache.
-// NOT published until the cut swap, so no lock during the fill. On the first
-// call after arm, av_seek_frame's the pre-roll context BACKWARD to target-kTrailMs
-// (a raw avio_seek into this MKV is unreliable — Part A proved it) then decodes
-// forward until staging covers [target, target+kStagingSpanMs]; schedules the cut
-// the moment coverage is reached.
-void PlaybackWorker::fillStaging() {
-    if (!m_prerollFmtCtx || m_prerollBank.isEmpty() || !m_prerollStagingCache) return;
-    const int64_t target = m_armedTargetMs.load();
-    if (target < 0 || m_stagingCovers.load()) return;
-
-    const int primaryStreamIndex = m_prerollBank[0]->streamIndex;
-    AVStream* refStream = m_prerollFmtCtx->streams[primaryStreamIndex];
+PlaybackWorker::StagingTarget PlaybackWorker::prerollStagingTarget() {
+    return StagingTarget{m_prerollFmtCtx, &m_prerollBank, &m_prerollAudioBank, &m_prerollDemux,
+                         m_prerollStagingCache.get(), &m_stagingNewestRefPtsMs};
+}
 
-    if (m_prerollSeekPending.exchange(false)) {
-        const int64_t anchor = qMax<int64_t>(0, target - kTrailMs);
+// av_seek_frame's the staging context BACKWARD to target-kTrailMs (a raw
+// avio_seek into this MKV is unreliable — Part A proved it) and empties the
+// staging cache. Worker thread only.
+void PlaybackWorker::rewindStaging(const StagingTarget& staging, int64_t target) {
+    AVStream* refStream = staging.fmtCtx->streams[staging.video->first()->streamIndex];
+    const int64_t anchor = qMax<int64_t>(0, target - kTrailMs);
+    // A recall into the live window pre-rolls straight from the RAM ring.
+    if (!staging.demux->tryServeFromRing(anchor)) {
         const int64_t seekPts = av_rescale_q(anchor, {1, 1000}, refStream->time_base);
-        av_seek_frame(m_prerollFmtCtx, refStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
-        avformat_flush(m_prerollFmtCtx);
-        OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
-        m_prerollStagingCache->clear(&evictedCacheFrames);
+        av_seek_frame(staging.fmtCtx, refStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
+        avformat_flush(staging.fmtCtx);
+    }
+    OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
+    staging.cache->clear(&evictedCacheFrames);
 #ifdef OLR_GPU_PIPELINE_BUILD
-        {
-            QMutexLocker bufferLocker(&m_bufferMutex);
-            collectEvictedGpuFramesLocked(evictedCacheFrames);
-        }
+    {
+        QMutexLocker bufferLocker(&m_bufferMutex);
+        collectEvictedGpuFramesLocked(evictedCacheFrames);
+    }
 #endif
-        m_stagingNewestRefPtsMs = INT64_MIN;
-        // Step 3: reset native sessions post-seek so the VT/MF decoder starts
-        // clean — guarantees PTS fidelity (maxClockDivergenceMs gate).
-        // All-intra mezzanine makes this safe and cheap.
-        for (auto* track : m_prerollBank) {
-            if (track->nativeDecoder) track->nativeDecoder->reset();
-        }
+    *staging.newestRefPtsMs = INT64_MIN;
+    // Step 3: reset native sessions post-seek so the VT/MF decoder starts
+    // clean — guarantees PTS fidelity (maxClockDivergenceMs gate).
+    // All-intra mezzanine makes this safe and cheap.
+    for (auto* track : *staging.video) {
+        if (track->nativeDecoder) track->nativeDecoder->reset();
     }
+}
 
+// Decodes at most kPrerollPacketsPerTick packets forward into staging.cache.
+// Returns true once the cache covers [target, target+kStagingSpanMs], or the
+// source ran dry (EOF / short clip / ring live edge). Worker thread only.
+bool PlaybackWorker::stagePackets(const StagingTarget& staging, int64_t target) {
     AVPacket* pkt = av_packet_alloc();
     AVFrame* vf = av_frame_alloc();
     AVFrame* af = av_frame_alloc(); // Tier3 audio staging (active view)
@@ -1818,34 +2271,37 @@ void PlaybackWorker::fillStaging() {
         if (pkt) av_packet_free(&pkt);
         if (vf) av_frame_free(&vf);
         if (af) av_frame_free(&af);
-        return;
+        return false;
     }
     const int activeView = m_activeAudioView.load(std::memory_order_relaxed);
 
+    const int primaryStreamIndex = staging.video->first()->streamIndex;
     const int64_t coverTo = target + kStagingSpanMs;
+    bool covered = false;
     int packets = 0;
     while (packets++ < kPrerollPacketsPerTick) {
-        int ret = av_read_frame(m_prerollFmtCtx, pkt);
+        int ret = staging.demux->read(pkt);
         if (ret < 0) {
-            // EOF / short clip: take whatever we staged as "covering" so the cut
-            // can still fire (it will land on the largest pts<=target available).
-            m_stagingCovers.store(true);
+            // EOF / short clip / ring live edge: take whatever we staged as
+            // "covering" so the cut can still fire (it will land on the largest
+            // pts<=target available).
+            covered = true;
             av_packet_unref(pkt);
             break;
         }
 
         // Decode video packets into the staging cache (mirror decodePacketIntoBank's
-        // video insert path, but into m_prerollStagingCache; no FrameIndex append,
+        // video insert path, but into staging.cache; no FrameIndex append,
         // no per-track buffer, no live cache touch).
-        for (auto* track : m_prerollBank) {
+        for (auto* track : *staging.video) {
             if (pkt->stream_index != track->streamIndex) continue;
             if (track->nativeDecoder) {
                 // H.264 native path: mirrors decodePacketIntoBank native branch
-                // (~:557-634) but writes m_prerollStagingCache (not m_outputCache)
+                // (~:557-634) but writes staging.cache (not m_outputCache)
                 // and omits primary-bank-only state (m_bufferMutex, track->buffer).
                 // NativeVideoDecoder::decode() is SYNCHRONOUS — the stage lambda
                 // fires inline on this (worker) thread before decode() returns, so
-                // m_stagingNewestRefPtsMs is updated before the coverage check below.
+                // *staging.newestRefPtsMs is updated before the coverage check below.
                 // This holds on VideoToolbox (WaitForAsynchronousFrames blocks until
                 // the output callback runs) and is the only configuration validated
                 // here. An ASYNC MediaFoundation MFT (Windows) could defer delivery
@@ -1855,7 +2311,7 @@ void PlaybackWorker::fillStaging() {
                 // The stage lambda captures the per-packet locals BY VALUE so a
                 // (hypothetical) deferred callback can never read a stale/dangling
                 // reference — behavior-identical to the inline VT path.
-                AVRational tb = m_prerollFmtCtx->streams[track->streamIndex]->time_base;
+                AVRational tb = staging.fmtCtx->streams[track->streamIndex]->time_base;
                 const int64_t pktPts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
                 // Convert avcC length-prefixed packet → Annex B (verbatim from
                 // decodePacketIntoBank, ~:558-571).
@@ -1884,8 +2340,9 @@ void PlaybackWorker::fillStaging() {
                         (pkt->dts != AV_NOPTS_VALUE) ? av_rescale_q(pkt->dts, tb, {1, 90000}) : -1;
                     unit.annexB = annexB;
 
-                    auto stage = [this, pktPts, tb, target, track,
-                                  primaryStreamIndex](AVFrame* nativeVf) {
+                    auto stage = [this, pktPts, tb, target, track, primaryStreamIndex,
+                                  cache = staging.cache,
+                                  newestRef = staging.newestRefPtsMs](AVFrame* nativeVf) {
                         int64_t framePtsMs;
                         if (pktPts != AV_NOPTS_VALUE) {
                             framePtsMs = av_rescale_q(pktPts, tb, {1, 1000});
@@ -1897,8 +2354,7 @@ void PlaybackWorker::fillStaging() {
                         mediaFrame.metadata().key.ptsMs = framePtsMs;
                         if (mediaFrame.isValid()) {
                             OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
-                            m_prerollStagingCache->insertVideoFrame(mediaFrame,
-                                                                    &evictedCacheFrames);
+                            cache->insertVideoFrame(mediaFrame, &evictedCacheFrames);
 #ifdef OLR_GPU_PIPELINE_BUILD
                             if (!evictedCacheFrames.isEmpty()) {
                                 QMutexLocker bufferLocker(&m_bufferMutex);
@@ -1907,7 +2363,7 @@ void PlaybackWorker::fillStaging() {
 #endif
                             m_counters.stagingVideoFramesDecoded++;
                             if (track->streamIndex == primaryStreamIndex) {
-                                m_stagingNewestRefPtsMs = qMax(m_stagingNewestRefPtsMs, framePtsMs);
+                                *newestRef = qMax(*newestRef, framePtsMs);
                             }
                         }
                         av_frame_free(&nativeVf);
@@ -1923,7 +2379,7 @@ void PlaybackWorker::fillStaging() {
                         int64_t framePtsMs;
                         if (framePts != AV_NOPTS_VALUE) {
                             framePtsMs = av_rescale_q(
-                                framePts, m_prerollFmtCtx->streams[track->streamIndex]->time_base,
+                                framePts, staging.fmtCtx->streams[track->streamIndex]->time_base,
                                 {1, 1000});
                         } else {
                             framePtsMs = target;
@@ -1932,8 +2388,7 @@ void PlaybackWorker::fillStaging() {
                         mediaFrame.metadata().key.ptsMs = framePtsMs;
                         if (mediaFrame.isValid()) {
                             OutputFrameCache::EvictedVideoFrames evictedCacheFrames;
-                            m_prerollStagingCache->insertVideoFrame(mediaFrame,
-                                                                    &evictedCacheFrames);
+                            staging.cache->insertVideoFrame(mediaFrame, &evictedCacheFrames);
 #ifdef OLR_GPU_PIPELINE_BUILD
                             if (!evictedCacheFrames.isEmpty()) {
                                 QMutexLocker bufferLocker(&m_bufferMutex);
@@ -1942,7 +2397,8 @@ void PlaybackWorker::fillStaging() {
 #endif
                             m_counters.stagingVideoFramesDecoded++;
                             if (track->streamIndex == primaryStreamIndex)
-                                m_stagingNewestRefPtsMs = qMax(m_stagingNewestRefPtsMs, framePtsMs);
+                                *staging.newestRefPtsMs =
+                                    qMax(*staging.newestRefPtsMs, framePtsMs);
                         }
                         av_frame_unref(vf);
                     }
@@ -1954,9 +2410,9 @@ void PlaybackWorker::fillStaging() {
         // Stage the ACTIVE-VIEW audio for the armed window into the (worker-
         // private) staging cache so the output bus has the target's audio the
         // instant the cut promotes it — mirrors cacheOutputAudioFrame but writes
-        // m_prerollStagingCache (no lock; not published until the cut swap) and
-        // uses the pre-roll context's time base. Bounded to [.., target+span].
-        for (auto* aTrack : m_prerollAudioBank) {
+        // the staging cache (no lock; not published until the cut swap) and
+        // uses the staging context's time base. Bounded to [.., target+span].
+        for (auto* aTrack : *staging.audio) {
             if (pkt->stream_index != aTrack->streamIndex) continue;
             if (aTrack->viewIndex == activeView &&
                 avcodec_send_packet(aTrack->codecCtx, pkt) == 0) {
@@ -1967,7 +2423,7 @@ void PlaybackWorker::fillStaging() {
                         if (apts == AV_NOPTS_VALUE) apts = af->best_effort_timestamp;
                         if (apts != AV_NOPTS_VALUE) {
                             const AVRational atb =
-                                m_prerollFmtCtx->streams[aTrack->streamIndex]->time_base;
+                                staging.fmtCtx->streams[aTrack->streamIndex]->time_base;
                             const int64_t aPtsMs = av_rescale_q(apts, atb, {1, 1000});
                             if (aPtsMs <= target + kPrerollAudioSpanMs) {
                                 const int dataSize = af->nb_samples * 2 * int(sizeof(int16_t));
@@ -1979,7 +2435,7 @@ void PlaybackWorker::fillStaging() {
                                 frame.format = MediaSampleFormat::S16Interleaved;
                                 frame.pcm = QByteArray(reinterpret_cast<const char*>(af->data[0]),
                                                        dataSize);
-                                m_prerollStagingCache->insertAudioFrame(frame);
+                                staging.cache->insertAudioFrame(frame);
                             }
                         }
                     }
@@ -1990,19 +2446,77 @@ void PlaybackWorker::fillStaging() {
         }
         av_packet_unref(pkt);
 
-        if (m_stagingNewestRefPtsMs >= coverTo) {
+        if (*staging.newestRefPtsMs >= coverTo) {
+            covered = true;
+            break;
+        }
+    }
+
+    av_frame_free(&vf);
+    av_frame_free(&af);
+    av_packet_free(&pkt);
+    return covered;
+}
+
+// Worker-thread-only. Bounded incremental pre-roll into m_prerollStagingCache.
+// NOT published until the cut swap, so no lock during the fill. On the first
+// call after arm it takes the window ready-made from a covered cue slot when
+// one holds the target; otherwise it rewinds the pre-roll context to the trail
+// anchor (rewindStaging) then decodes forward until staging covers
+// [target, target+kStagingSpanMs]; schedules the cut the moment coverage is
+// reached.
+void PlaybackWorker::fillStaging() {
+    if (!m_prerollFmtCtx || m_prerollBank.isEmpty() || !m_prerollStagingCache) return;
+    // The pre-roll bank is about to become the primary (a cross-clip cut just
+    // fired); a re-arm stages once the run loop has swapped the banks.
+    if (m_clipSwapPending.load(std::memory_order_acquire)) return;
+    const int64_t target = m_armedTargetMs.load();
+    if (target < 0 || m_stagingCovers.load()) return;
+
+    // Cross-clip cut: move the pre-roll onto the armed clip before seeking it.
+    if (m_prerollSeekPending.load()) {
+        QString clip;
+        QString current;
+        {
+            QMutexLocker locker(&m_mutex);
+            clip = m_armedClipPath.isEmpty() ? m_currentFilePath : m_armedClipPath;
+            current = m_currentFilePath;
+        }
+        if (takeStagedCue(clip, target)) {
+            // A cue slot already staged this window: no seek, no decode.
+            m_prerollSeekPending.store(false);
             m_stagingCovers.store(true);
 #ifdef OLR_GPU_PIPELINE_BUILD
             if (m_stagingFence && gpuPipelineEnabled())
                 m_stagedFenceValue.store(m_stagingFence->signal(), std::memory_order_release);
 #endif
-            break;
+        } else if (DemuxBankPool::keyFor(clip) != DemuxBankPool::keyFor(m_prerollClipPath)) {
+            const PrerollSwitch switched = switchPrerollClip(clip);
+            // No warmed bank yet: keep the arm and look again next pass.
+            if (switched == PrerollSwitch::Waiting) return;
+            if (switched == PrerollSwitch::Failed) {
+                // Unusable clip: disarm (nothing was staged or scheduled yet).
+                m_prerollSeekPending.store(false);
+                m_armedTargetMs.store(-1);
+                m_armedFireAtMs.store(-1);
+                m_cutArmed.store(false, std::memory_order_release);
+                return;
+            }
         }
+        m_stagingCrossClip.store(DemuxBankPool::keyFor(m_prerollClipPath) !=
+                                     DemuxBankPool::keyFor(current),
+                                 std::memory_order_release);
     }
 
-    av_frame_free(&vf);
-    av_frame_free(&af);
-    av_packet_free(&pkt);
+    const StagingTarget staging = prerollStagingTarget();
+    if (m_prerollSeekPending.exchange(false)) rewindStaging(staging, target);
+    if (!m_stagingCovers.load() && stagePackets(staging, target)) {
+        m_stagingCovers.store(true);
+#ifdef OLR_GPU_PIPELINE_BUILD
+        if (m_stagingFence && gpuPipelineEnabled())
+            m_stagedFenceValue.store(m_stagingFence->signal(), std::memory_order_release);
+#endif
+    }
 
 #ifdef OLR_GPU_PIPELINE_BUILD
     drainEvictedGpuFrames();
@@ -2128,7 +2642,17 @@ void PlaybackWorker::maybeFireScheduledCut(qint64 dispatcherNextIndex) {
     // reposition==0). The follow is non-clearing (the promoted cache is preserved via
     // repositionTo's staging double-buffer) and does NOT bump m_seekGeneration, so the
     // CommitGate never re-engages — no placeholder.
-    if (newPlayhead < prePlayhead) m_decoderFollowMs.store(newPlayhead, std::memory_order_release);
+    //
+    // A CROSS-CLIP cut always needs the follow, in either direction: the primary
+    // bank is still demuxing the old clip. m_clipSwapPending (released before the
+    // follow) makes the worker swap the banks first and, until it has, keeps the
+    // old clip's packets out of the promoted cache.
+    if (m_stagingCrossClip.exchange(false, std::memory_order_acq_rel)) {
+        m_clipSwapPending.store(true, std::memory_order_release);
+        m_decoderFollowMs.store(newPlayhead, std::memory_order_release);
+    } else if (newPlayhead < prePlayhead) {
+        m_decoderFollowMs.store(newPlayhead, std::memory_order_release);
+    }
     // Re-base the playhead WITHOUT bumping m_seekGeneration: m_transport->seek does
     // not touch the worker's seek token, so committedGen stays == seekGen and
     // makeOutputSnapshot exposes the LIVE transport playhead (now == target) against
@@ -2166,6 +2690,8 @@ void PlaybackWorker::maybeFireScheduledCut(qint64 dispatcherNextIndex) {
 }
 
 void PlaybackWorker::run() {
+    PipelineTrace::setThreadName(QStringLiteral("playback"));
+    ThreadPlacement::placeCurrentThread(ThreadRole::Playback);
     qDebug() << "Opening file: " << m_currentFilePath;
 
     if (m_currentFilePath.isEmpty()) return;
@@ -2233,51 +2759,8 @@ void PlaybackWorker::run() {
                 const bool isH264 = (codecParams->codec_id == AV_CODEC_ID_H264);
                 if (isH264 && queryNativeVideoDecodeCapabilities().h264 &&
                     codecParams->extradata_size >= 8) {
-                    // Parse avcC extradata → SPS/PPS NAL payloads (raw, no start codes).
-                    // Layout: [0]=0x01 [1..3]=profile/compat/level [4]=0xFF
-                    //         [5]=0xE0|numSPS  then numSPS*(2B length + payload)
-                    //         then 1B numPPS   then numPPS*(2B length + payload)
                     H26xParameterSets params;
-                    bool parseOk = true;
-                    const uint8_t* ed = codecParams->extradata;
-                    const int edSize = codecParams->extradata_size;
-                    int off = 5;
-                    const int numSps = off < edSize ? (ed[off] & 0x1f) : 0;
-                    off++;
-                    for (int s = 0; s < numSps && parseOk; ++s) {
-                        if (off + 2 > edSize) {
-                            parseOk = false;
-                            break;
-                        }
-                        const int len = (ed[off] << 8) | ed[off + 1];
-                        off += 2;
-                        if (len <= 0 || off + len > edSize) {
-                            parseOk = false;
-                            break;
-                        }
-                        params.h264Sps.append(
-                            QByteArray(reinterpret_cast<const char*>(ed + off), len));
-                        off += len;
-                    }
-                    if (parseOk && off < edSize) {
-                        const int numPps = ed[off++];
-                        for (int p = 0; p < numPps && parseOk; ++p) {
-                            if (off + 2 > edSize) {
-                                parseOk = false;
-                                break;
-                            }
-                            const int len = (ed[off] << 8) | ed[off + 1];
-                            off += 2;
-                            if (len <= 0 || off + len > edSize) {
-                                parseOk = false;
-                                break;
-                            }
-                            params.h264Pps.append(
-                                QByteArray(reinterpret_cast<const char*>(ed + off), len));
-                            off += len;
-                        }
-                    }
-                    if (!parseOk || params.h264Sps.isEmpty() || params.h264Pps.isEmpty()) {
+                    if (!parseAvcC(codecParams, params)) {
                         qWarning() << "PlaybackWorker: H.264 avcC parse failed for stream" << i
                                    << "— skipping track (hardware-only constraint)";
                         continue; // do NOT software-decode H.264
@@ -2392,6 +2875,9 @@ void PlaybackWorker::run() {
         if (m_fmtCtx) avformat_close_input(&m_fmtCtx);
         return;
     }
+    m_demux.attach(m_fmtCtx, m_currentFilePath, m_decoderBank[0]->streamIndex);
+    if (!m_readAhead.open(m_currentFilePath))
+        qWarning() << "PlaybackWorker: demux read-ahead unavailable for" << m_currentFilePath;
 
     int outputWidth = 1920;
     int outputHeight = 1080;
@@ -2410,8 +2896,13 @@ void PlaybackWorker::run() {
     // Tier3: open the SECOND (pre-roll) AVFormatContext on the same clip now
     // that the primary bank + output graph are up. On failure the armed-cut
     // feature is silently disabled (armNextCut becomes a no-op).
-    if (!openPrerollContext())
+    if (openPrerollContext()) {
+        m_armedCutReady.store(true, std::memory_order_release);
+        m_bankPool.start();
+        createCueSlots();
+    } else {
         qWarning() << "PlaybackWorker: pre-roll context unavailable — armed cut disabled";
+    }
 
     AVPacket* pkt = av_packet_alloc();
     AVFrame* frame = av_frame_alloc();
@@ -2447,6 +2938,7 @@ void PlaybackWorker::run() {
         if (m_audioReprime.exchange(false, std::memory_order_relaxed)) {
             m_audioQueue.clear();
             if (m_audioPlayer) m_audioPlayer->clear();
+            m_varispeedAudio = false;
         }
         if (m_outputTargetsDirty.load(std::memory_order_relaxed)) rebuildOutputEndpoints();
 
@@ -2455,6 +2947,7 @@ void PlaybackWorker::run() {
         if (nowMs - lastTelemetryMs >= 1000) {
             lastTelemetryMs = nowMs;
             emitTelemetry(P, newestPtsMax(), speed);
+            m_counters.workerCpuNs = ThreadPlacement::currentThreadCpuNs();
         }
 
         // --- Pause handling (§6.9): block, but wake on a pending seek OR when
@@ -2491,6 +2984,17 @@ void PlaybackWorker::run() {
 
         // === CLASSIFY (spec §6.1, priority order) ===
 
+        // (0) Cross-clip cut fired: the output already shows the new clip, so
+        //     move the primary onto it before anything else reads or decodes.
+        //     The decoder-follow below (or a newer explicit seek) then resyncs
+        //     the new primary bank around the re-based playhead.
+        bool switchedClip = false;
+        if (m_clipSwapPending.load(std::memory_order_acquire)) {
+            swapPrimaryAndPrerollBanks();
+            m_clipSwapPending.store(false, std::memory_order_release);
+            switchedClip = true;
+        }
+
         // (1) Explicit seek — coalesce to the latest target, clear it. → §6.2.
         int64_t seekTarget = -1;
         {
@@ -2518,7 +3022,10 @@ void PlaybackWorker::run() {
         {
             const int64_t follow = m_decoderFollowMs.exchange(-1, std::memory_order_acquire);
             if (follow >= 0) {
-                repositionTo(follow, /*dir*/ -1, pkt, frame, audioFrame, /*cutFollow*/ true);
+                // Same-clip follows are backward cuts; a clip switch refills the
+                // fresh primary in the travel direction.
+                repositionTo(follow, switchedClip ? dir : -1, pkt, frame, audioFrame,
+                             /*cutFollow*/ true);
                 continue;
             }
         }
@@ -2541,10 +3048,8 @@ void PlaybackWorker::run() {
                 // Fall through to deliver(last)+wait; no seek.
             } else {
                 // §6.5 skip-forward: seek back a trail, resume decimated fill.
-                AVStream* vStream = m_fmtCtx->streams[m_decoderBank[0]->streamIndex];
                 int64_t anchor = qMax<int64_t>(0, P - kTrailMs);
-                int64_t seekPts = av_rescale_q(anchor, {1, 1000}, vStream->time_base);
-                av_seek_frame(m_fmtCtx, vStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
+                m_demux.seekMs(anchor);
                 clearDecoderBuffers(/*invalidateGpuGeneration*/ false);
                 m_audioQueue.clear();
                 for (auto* aTrack : m_audioDecoderBank) {
@@ -2585,7 +3090,8 @@ void PlaybackWorker::run() {
                     if (m_seekTargetMs >= 0) break;
                 }
 
-                int ret = av_read_frame(m_fmtCtx, pkt);
+                int ret = m_demux.read(pkt);
+                if (ret == AVERROR(EAGAIN)) break; // caught up with the recorder (ring)
                 if (ret == AVERROR_EOF) {
                     hitEof = true;
                     break;
@@ -2598,8 +3104,8 @@ void PlaybackWorker::run() {
                 batch++;
                 packetsThisIter++;
 
-                // Audio enqueue only when at 1× forward single-view playing.
-                bool audioOn = playing && dir == 1 && (speed > 0.99 && speed < 1.01);
+                // Audio enqueue only when forward at an audible speed, single-view playing.
+                bool audioOn = playing && dir == 1 && audioAudibleAt(speed);
                 int64_t lastV = decodePacketIntoBank(pkt, frame, audioFrame, P, /*dir*/ 1,
                                                      trackCount, decimate, decStep, audioOn,
                                                      /*dedupTail*/ false);
@@ -2621,14 +3127,15 @@ void PlaybackWorker::run() {
                 (m_reverseAnchorMs == INT64_MAX) || (m_reverseAnchorMs - newAnchor >= kChunkMs);
             if (needFill && anchorMoved) {
                 m_reverseAnchorMs = newAnchor;
-                // Record the avio position of the current oldest (file-position
-                // terminator: well-defined under non-interleave skew).
-                const int64_t stopPos = (m_fmtCtx->pb) ? avio_tell(m_fmtCtx->pb) : -1;
-
-                AVStream* vStream = m_fmtCtx->streams[m_decoderBank[0]->streamIndex];
-                int64_t anchor = newAnchor;
-                int64_t seekPts = av_rescale_q(anchor, {1, 1000}, vStream->time_base);
-                av_seek_frame(m_fmtCtx, vStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
+                // Record the read position of the current oldest (file-position
+                // terminator: well-defined under non-interleave skew). A ring
+                // sequence and an avio offset are not comparable, so the stop is
+                // dropped (budget-bounded chunk) if the seek changes source.
+                const LiveDemuxSource::Mode stopMode = m_demux.mode();
+                int64_t stopPos = m_demux.tell();
+
+                m_demux.seekMs(newAnchor);
+                if (m_demux.mode() != stopMode) stopPos = -1;
                 m_counters.reverseChunkSeek++;
 
                 const int kReverseChunkBudget =
@@ -2640,7 +3147,8 @@ void PlaybackWorker::run() {
                         QMutexLocker locker(&m_mutex);
                         if (m_seekTargetMs >= 0) break;
                     }
-                    int ret = av_read_frame(m_fmtCtx, pkt);
+                    int ret = m_demux.read(pkt);
+                    if (ret == AVERROR(EAGAIN)) break;
                     if (ret == AVERROR_EOF) {
                         hitEof = true;
                         break;
@@ -2661,7 +3169,7 @@ void PlaybackWorker::run() {
 
                     // Terminate when the read cursor reaches the previous oldest
                     // file position (the chunk above this is already buffered).
-                    int64_t cur = (m_fmtCtx->pb) ? avio_tell(m_fmtCtx->pb) : -1;
+                    int64_t cur = m_demux.tell();
                     av_packet_unref(pkt);
                     if (stopPos >= 0 && cur >= 0 && cur >= stopPos) break;
                 }
@@ -2670,6 +3178,19 @@ void PlaybackWorker::run() {
             }
         }
 
+        // --- READ-AHEAD: warm the next byte range in the travel direction ---
+        // Forward: the window past the current read position. Reverse: from the
+        // FrameIndex offset of the NEXT chunk down (the seek the following
+        // reverse fill will issue) up to here. Ring-served reads need no disk.
+        if (m_readAhead.isOpen() && m_demux.mode() == LiveDemuxSource::Mode::File) {
+            std::optional<qint64> reverseLo;
+            if (dir < 0)
+                reverseLo =
+                    m_frameIndex.nearestAtOrBefore(qMax<int64_t>(0, P - kLeadMs - 2 * kChunkMs));
+            if (const auto range = DemuxReadAhead::plan(dir, m_demux.tell(), reverseLo))
+                m_readAhead.request(range.value());
+        }
+
         // --- TRIM (§6.6) + audio queue bound ---
         {
             int64_t keepFrom, keepTo;
@@ -2703,13 +3224,24 @@ void PlaybackWorker::run() {
 #endif
         m_audioQueue.dropOlderThan(P, kAudioLeadMs);
 
-        // --- AUDIO release (§6.7): only at 1× forward, playing, single active
-        //     view, unmuted. Release queued frames within kAudioLeadMs of P. ---
+        // --- AUDIO release (§6.7): only forward at an audible speed, playing,
+        //     single active view, unmuted. Release queued frames within
+        //     kAudioLeadMs of P; off 1× they go through the time-stretcher. ---
         {
             bool oneX = (speed > 0.99 && speed < 1.01);
             int activeView = m_activeAudioView.load(std::memory_order_relaxed);
             bool unmuted = m_audioPlayer && !m_audioPlayer->isMuted();
-            if (playing && dir == 1 && oneX && activeView >= 0 && unmuted) {
+            bool audible = playing && dir == 1 && audioAudibleAt(speed) && activeView >= 0 &&
+                           unmuted;
+            if (m_varispeedAudio && (!audible || oneX)) {
+                // Leaving varispeed: the player holds wall-axis audio, so drop it and
+                // let 1× re-align on media PTS.
+                m_varispeedAudio = false;
+                if (m_audioPlayer) m_audioPlayer->clear();
+            }
+            if (audible && !oneX) {
+                releaseVarispeedAudio(P, speed);
+            } else if (audible) {
                 AudioFrameQueue::Frame af;
                 while (m_audioQueue.releaseDue(P, kAudioLeadMs, af)) {
                     m_audioPlayer->pushSamples(reinterpret_cast<const uint8_t*>(af.pcm.constData()),
@@ -2717,8 +3249,8 @@ void PlaybackWorker::run() {
                     m_counters.audioPushes++;
                 }
             } else {
-                // |speed|≠1 / reverse / multiview / muted: drop queued audio so
-                // it can't be stale-re-released on return to 1× (§6.7).
+                // Out-of-range speed / reverse / multiview / muted: drop queued audio
+                // so it can't be stale-re-released on return to 1× (§6.7).
                 if (!m_audioQueue.isEmpty()) m_audioQueue.clear();
             }
         }
@@ -2732,23 +3264,30 @@ void PlaybackWorker::run() {
             m_hasPendingRearm.exchange(false, std::memory_order_acq_rel)) {
             const uint64_t qgen = m_pendingRearmSeekGen.load(std::memory_order_acquire);
             bool seekPending;
-            {
-                QMutexLocker l(&m_mutex);
-                seekPending = (m_seekTargetMs >= 0);
-            }
             // Apply the queued re-arm ONLY if no manual seek has superseded it since
             // it was queued: the generation must be unchanged AND no seek target may
             // be outstanding. Otherwise drop it — the operator's seek is the newer
             // explicit action. armCutInternal is given the QUEUE-time generation as
             // the baseline, so even a seek that races this apply aborts the cut later.
+            QString clipPath;
+            {
+                QMutexLocker l(&m_mutex);
+                seekPending = (m_seekTargetMs >= 0);
+                clipPath = m_pendingRearmClipPath;
+            }
             if (!seekPending && m_seekGeneration.load(std::memory_order_acquire) == qgen)
                 armCutInternal(m_pendingRearmMs.load(), qgen,
-                               m_pendingRearmFireAtMs.load(std::memory_order_relaxed));
+                               m_pendingRearmFireAtMs.load(std::memory_order_relaxed), clipPath);
         }
         // Worker-private; never starves the primary tick (kPrerollPacketsPerTick
         // per pass). Stops once staging covers the armed window (m_stagingCovers),
         // at which point the cut is scheduled and fires on the output thread.
-        if (m_cutArmed.load() && !m_stagingCovers.load()) fillStaging();
+        // With no armed window left to stage, the same budget stages the
+        // upcoming cues into the pre-roll cue slots instead.
+        if (m_cutArmed.load() && !m_stagingCovers.load())
+            fillStaging();
+        else
+            fillCueSlots();
 
         // --- EOF / live-growth handling (§6.8) ---
         if (hitEof) {
@@ -2762,20 +3301,20 @@ void PlaybackWorker::run() {
                     m_fmtCtx->pb->error = 0;
                 }
                 avformat_flush(m_fmtCtx);
+                // While recording, the tail is resident in the live packet ring:
+                // seekMs switches to it and forward fill stops hitting file EOF.
                 int64_t rNewest = refNewestPts();
-                AVStream* vStream = m_fmtCtx->streams[m_decoderBank[0]->streamIndex];
                 int64_t anchorMs = qMax<int64_t>(0, rNewest);
-                int64_t seekPts = av_rescale_q(anchorMs, {1, 1000}, vStream->time_base);
-                int sret = av_seek_frame(m_fmtCtx, vStream->index, seekPts, AVSEEK_FLAG_BACKWARD);
+                int sret = m_demux.seekMs(anchorMs);
                 m_sizeAtLastEof = sz;
                 m_counters.eofTailSeek++;
                 if (sret >= 0) {
                     // Dedup-before-decode: re-read tail clusters cost reads only.
                     // Drain a bounded number of packets, skipping already-buffered.
-                    bool audioOn = playing && (speed > 0.99 && speed < 1.01);
+                    bool audioOn = playing && audioAudibleAt(speed);
                     const int kEofDrain = 4 * trackCount;
                     for (int i = 0; i < kEofDrain && !shouldInterrupt(); ++i) {
-                        int ret = av_read_frame(m_fmtCtx, pkt);
+                        int ret = m_demux.read(pkt);
                         if (ret < 0) break;
                         decodePacketIntoBank(pkt, frame, audioFrame, P, /*dir*/ 1, trackCount,
                                              /*decimate*/ false, /*step*/ 1, audioOn,
@@ -2822,21 +3361,16 @@ void PlaybackWorker::run() {
     av_frame_free(&frame);
     av_frame_free(&audioFrame);
     clearDecoders();
+    m_readAhead.close();
+    m_demux.detach();
+    m_prerollDemux.detach();
     if (m_fmtCtx) avformat_close_input(&m_fmtCtx);
 
     // Tier3: free pre-roll resources (worker-thread-owned).
-    for (auto* track : m_prerollBank) {
-        track->nativeDecoder.reset(); // tear down VT/MF session before freeing track
-        if (track->codecCtx) avcodec_free_context(&track->codecCtx);
-        delete track;
-    }
-    m_prerollBank.clear();
-    for (auto* aTrack : m_prerollAudioBank) {
-        if (aTrack->codecCtx) avcodec_free_context(&aTrack->codecCtx);
-        delete aTrack;
-    }
-    m_prerollAudioBank.clear();
-    if (m_prerollFmtCtx) avformat_close_input(&m_prerollFmtCtx);
+    m_armedCutReady.store(false, std::memory_order_release);
+    releaseCueSlots();
+    m_bankPool.stop();
+    releasePrerollBank().reset();
     m_prerollStagingCache.reset();
     m_cutArmed.store(false);
     m_scheduledCutFrame.store(-1);
@@ -2846,9 +3380,12 @@ void PlaybackWorker::run() {
 #endif
     m_hasPendingRearm.store(false);
     m_decoderFollowMs.store(-1);
+    m_stagingCrossClip.store(false);
+    m_clipSwapPending.store(false);
 }
 
 void PlaybackWorker::deliverDueFrames(int64_t P, int dir) {
+    PipelineTraceScope trace("playback", "deliver frames", "playheadMs", P);
     struct PendingDeliver {
         FrameProvider* provider = nullptr;
         FrameHandle frame;
@@ -5,16 +5,23 @@
 #include <TargetConditionals.h>
 #endif
 
+#include <QElapsedTimer>
 #include <QThread>
 #include <QVector>
 #include <QMutex>
 #include <QList>
 #include <atomic>
+#include <climits>
 #include <memory>
 #include <vector>
 #include "frameprovider.h"
 #include "playback/commitgate.h"
+#include "playback/cueslotplan.h"
+#include "playback/decodertrack.h"
+#include "playback/demuxbankpool.h"
+#include "playback/demuxreadahead.h"
 #include "playback/frameindex.h"
+#include "playback/livedemuxsource.h"
 #ifdef OLR_GPU_PIPELINE_BUILD
 #include "playback/gpu/gpuframeretirequeue.h"
 #endif
@@ -24,9 +31,11 @@
 #include "playback/output/sharedcacheslot.h"
 #include "playback/output/outputtargetassignment.h"
 #include "playback/playbacktransport.h"
+#include "playback/shareddecodedframecache.h"
 #include "playback/audioplayer.h"
 #include "playback/trackbuffer.h"
 #include "playback/audioframequeue.h"
+#include "playback/timestretcher.h"
 #include "recorder_engine/ingest/nativevideodecoder.h"
 
 extern "C" {
@@ -45,31 +54,6 @@ class GpuRhiContext;
 class WinGpuImportEdge;
 #endif
 
-struct DecoderTrack {
-    AVCodecContext* codecCtx = nullptr;
-    // Hardware H.264 decode: when set, this track is decoded via NativeVideoDecoder
-    // instead of the FFmpeg software codecCtx (which stays nullptr for H.264 tracks).
-    std::unique_ptr<NativeVideoDecoder> nativeDecoder;
-    H26xParameterSets h264ParamSets; // SPS/PPS parsed from avcC extradata at open time
-    // Dimensions for the output-graph init when codecCtx is null (H.264 tracks).
-    int codecWidth = 0;
-    int codecHeight = 0;
-    FrameProvider* provider = nullptr;
-    int streamIndex = -1;
-    int feedIndex = -1;
-    TrackBuffer buffer;
-    int64_t lastDeliveredPtsMs = -1; // last frame released to the provider
-    int decimateCounter = 0;         // per-track keep-counter (§6.3 decimation)
-};
-
-struct AudioDecoderTrack {
-    AVCodecContext* codecCtx = nullptr;
-    int streamIndex = -1;
-    int viewIndex = -1;             // which view (0..N-1) this audio belongs to
-    int64_t lastEnqueuedPtsMs = -1; // for dedup-before-decode after EOF un-latch
-    int64_t lastCachedPtsMs = -1;   // output-bus audio cache dedup
-};
-
 class PlaybackWorker : public QThread {
     Q_OBJECT
 #ifdef OLR_UNIT_TEST
@@ -92,17 +76,47 @@ public:
         // fill is counted separately by stagingVideoFramesDecoded below.
         qint64 decodedVideoFrames = 0;
         // Video frames the armed-cut pre-roll committed into m_prerollStagingCache
-        // (fillStaging). This is the DIRECT, unfakeable non-vacuity proof that the
-        // staging bank actually decoded the target window before a cut promoted it
-        // — distinct from decodedVideoFrames (primary bank). A cut that "fires" off
-        // an empty/dry staging cache (riding the dispatcher's hold-last) leaves this
-        // at 0, so the H.264 armed-cut gate asserts a floor on it. Counts both the
-        // native (H.264) and the FFmpeg (MPEG-2) staging paths.
+        // (fillStaging) or into a cue slot a cut later takes over. This is the
+        // DIRECT, unfakeable non-vacuity proof that the staging bank actually
+        // decoded the target window before a cut promoted it — distinct from
+        // decodedVideoFrames (primary bank). A cut that "fires" off an empty/dry
+        // staging cache (riding the dispatcher's hold-last) leaves this at 0, so
+        // the H.264 armed-cut gate asserts a floor on it. Counts both the native
+        // (H.264) and the FFmpeg (MPEG-2) staging paths.
         qint64 stagingVideoFramesDecoded = 0;
         // GPU-backed frames materialized to CPU planes. Stays 0 on the CPU path;
         // Phase-2 macOS GPU playback increments it only when a sink/preview asks
         // a GpuFrameData to read back.
         qint64 gpuReadToCpuCount = 0;
+        // Packets served from the recorder's in-RAM LivePacketRing instead of
+        // the file (primary + pre-roll contexts), and how often a reader fell
+        // off the ring's evicted tail and had to resume from disk.
+        qint64 liveRingPackets = 0;
+        qint64 liveRingFallbacks = 0;
+        // File reads that blocked the worker for >= LiveDemuxSource::kReadStallNs
+        // (the slowest one in maxReadStallMs), and bytes the demux read-ahead
+        // thread prefetched in the travel direction to prevent them.
+        qint64 readStalls = 0;
+        qint64 maxReadStallMs = 0;
+        qint64 readAheadBytes = 0;
+        // Cross-clip armed cuts and cue slots: banks served warm from the demux
+        // bank pool vs not pooled yet (an armed cut then opens its bank on the
+        // worker at arm time; a cue slot waits for the warmer), and clip
+        // switches the primary bank performed after such a cut fired.
+        qint64 bankPoolHits = 0;
+        qint64 bankPoolMisses = 0;
+        int clipSwitches = 0;
+        // Multi-slot pre-roll: windows fully staged into cue slots, and armed
+        // cuts that took their window ready-made from one (no seek, no decode).
+        qint64 cueSlotsStaged = 0;
+        qint64 cueSlotHits = 0;
+        // Primary-bank video frames taken ready-decoded from the shared decoded-frame
+        // cache (another playback channel decoded them) instead of decoding the
+        // packet. Not part of decodedVideoFrames.
+        qint64 sharedDecodeHits = 0;
+        // CPU time of the worker thread (ThreadPlacement::currentThreadCpuNs), sampled
+        // once a wall-second; -1 when the platform cannot report it.
+        qint64 workerCpuNs = 0;
     };
 
     explicit PlaybackWorker(const QList<FrameProvider*>& providers, PlaybackTransport* transport,
@@ -112,27 +126,45 @@ public:
     void openFile(const QString& filePath);
     void seekTo(int64_t timestampMs);
     // Tier3 frame-perfect ARMED CUT: arm a scheduled atomic cut to targetMs.
-    // UI-thread-safe (atomic stores only, never blocks). The worker pre-rolls
+    // UI-thread-safe (never waits on the worker). The worker pre-rolls
     // [target, target+kStagingSpanMs] into a private staging cache on a SECOND
     // AVFormatContext while the primary keeps playing, then promotes staging ->
     // active at a scheduled output frame (makeOutputSnapshot) with zero gray and
-    // zero reposition. v1 is single-clip (ms-only; same currently-open file). If
-    // the pre-roll context failed to open, this is a no-op (feature unavailable).
+    // zero reposition. If the pre-roll context failed to open, this is a no-op
+    // (feature unavailable).
     // Returns true when the cut was armed (or queued for re-arm), false when the
-    // armed-cut feature is unavailable (e.g. H.264: the pre-roll bank is empty).
-    // Callers that need navigation even when arming fails should seekPlayback on
-    // false — that keeps Recall functional on H.264 recordings.
+    // armed-cut feature is unavailable (no pre-roll bank, e.g. H.264 without a HW
+    // decoder). Callers that need navigation even when arming fails should
+    // seekPlayback on false — that keeps Recall functional on such recordings.
     //
     // fireAtPlayheadMs: when >= 0, the cut fires when the playhead reaches this
     // position (e.g. a playlist entry's out-point) rather than as-soon-as-staged,
     // for frame-perfect playout transitions. -1 (default, e.g. a Recall) = fire ASAP.
-    bool armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs = -1);
+    //
+    // clipPath: the clip targetMs refers to; empty = the currently playing clip.
+    // A cut to another clip pre-rolls from a bank out of the demux bank pool
+    // (opened on the worker on a miss) and, once it fires, the primary bank
+    // switches to that clip. Clips must share the session's feed layout (same
+    // video-track count); otherwise the cut is dropped when staging starts.
+    bool armNextCut(int64_t targetMs, int64_t fireAtPlayheadMs = -1,
+                    const QString& clipPath = QString());
     // True if the frame-perfect armed cut is available (the pre-roll context opened).
-    // False on recordings without an all-intra pre-roll bank (e.g. H.264), where
-    // armNextCut returns false. Callers that depend on armed cuts (playlist playout)
-    // gate on this to fail fast rather than silently dead-end. Read from the UI
-    // thread, mirroring armNextCut's own m_prerollFmtCtx check.
-    bool armedCutAvailable() const { return m_prerollFmtCtx != nullptr; }
+    // MPEG-2 stages through FFmpeg decoders and H.264 through NativeVideoDecoder
+    // (both all-intra); false only when no track could be decoded (H.264 without a
+    // HW decoder), where armNextCut returns false. Callers that depend on armed
+    // cuts (playlist playout) gate on this to fail fast rather than silently
+    // dead-end. UI-thread-safe.
+    bool armedCutAvailable() const { return m_armedCutReady.load(std::memory_order_acquire); }
+    // Clips to keep pre-opened for cross-clip armed cuts (e.g. every clip the
+    // playlist references), most important first. UI-thread-safe.
+    void setPrewarmClips(const QStringList& clipPaths);
+    // Upcoming cues to keep staged in the pre-roll cue slots, highest priority
+    // first (the next playlist boundary leads). Only as many as the slot
+    // budget allows are staged; an armed cut whose window a slot already
+    // covers schedules without a seek. UI-thread-safe.
+    void setStagedCues(const QVector<PrerollCue>& cues);
+    // The clip the primary bank is playing (changes when a cross-clip cut fires).
+    QString currentClipPath() const;
     // Direction-aware delivery (spec §5): forward delivers iff pts moved up,
     // reverse iff pts moved down (dir = +1 / -1).
     void deliverDueFrames(int64_t P, int dir);
@@ -140,10 +172,24 @@ public:
     void setSelectedOutputFeed(int feedIndex);
     void setBusPreviewProviders(FrameProvider* multiviewProvider, FrameProvider* pgmProvider);
     void setExternalOutputTargets(const QList<OutputTargetAssignment>& assignments);
+    // Decoded frames shared with the session's other playback channels: primary-bank
+    // CPU decodes are published to it and looked up in it before a packet is decoded.
+    // Set before start(); null (the default) decodes everything locally.
+    void setSharedFrameCache(std::shared_ptr<SharedDecodedFrameCache> cache);
+    // Playback channel this worker serves (PlaybackChannel; 0 = the UI's own): picks its
+    // output dispatcher's placement-plan core and tags its transport-stream records.
+    // Set before start().
+    void setPlaybackChannel(int channel) { m_playbackChannel = channel; }
     void stop();
 
     PlaybackCounters counters() const;
     OutputDispatchStats outputStats() const;
+    // The output runtime's last published stats (OutputRuntime::publishedStats): never
+    // waits behind a dispatch tick. For periodic monitors.
+    OutputRuntimePublishedStats publishedOutputStats() const;
+    // Copy of the primary clip's PTS -> byte-offset index when clipPath is the clip
+    // currently open, so an exporter can seek without rescanning; nullopt otherwise.
+    std::optional<FrameIndex> frameIndexFor(const QString& clipPath) const;
     uint64_t gpuGeneration() const;
     // The committed cache generation (set at repositionTo's tail). >=1 after a
     // real reposition proves a target was decoded and committed to the cache.
@@ -165,11 +211,13 @@ private:
     static constexpr int kTrailMs = 300;           // video window behind P
     static constexpr int kChunkMs = 500;           // reverse backward-fetch chunk size
     static constexpr int kAudioLeadMs = 200;       // max lead of pushed audio over P
+    static constexpr int kVarispeedGapMs = 40;     // audio PTS jump that restarts varispeed
     static constexpr int kAudioQueueMs = 900;      // worker audio-queue span bound
     static constexpr int kSlackMs = 200;           // trim hysteresis beyond the window
     static constexpr int kIdleSleepMs = 3;         // sleep when window full and playing
     static constexpr int kEofSleepMs = 10;         // sleep between EOF re-checks
     static constexpr int kReadErrSleepMs = 20;     // sleep after a non-EOF read error
+    static constexpr int kArmedBankWaitMs = 5000;  // armed cut's wait for a warmed bank
     static constexpr int kBackJumpSlackMs = 150;   // P below buffered span by this ⇒ reposition
     static constexpr int kGlobalFrameBudget = 256; // aggregate decoded-frame cap (memory)
     static constexpr double kDecimateAbove = 1.5;  // |speed| above which decimation engages
@@ -210,6 +258,22 @@ private:
     int64_t decodePacketIntoBank(AVPacket* pkt, AVFrame* vf, AVFrame* af, int64_t P, int dir,
                                  int trackCount, bool decimate, int decimateStep, bool audioOn,
                                  bool dedupTail);
+    // decodePacketIntoBank's shared-cache path for one video packet: when another
+    // channel already decoded the frame, commits it to `track` exactly as a decode
+    // would (decimation, frame index, dedupTail) and returns true — the packet is
+    // consumed and must not be decoded. False on a miss or when sharing is off.
+    bool takeSharedFrame(DecoderTrack* track, const AVPacket* pkt, int cap, int64_t protectLo,
+                         int64_t protectHi, bool decimate, int decimateStep, bool dedupTail,
+                         qint64 demuxedNs, int64_t* lastVideoPtsMs);
+    // Offers a primary-bank CPU decode to the other channels.
+    void publishSharedFrame(const FrameHandle& frame);
+    // Forward speeds at which the active view's audio is decoded and released: 1x plain,
+    // or time-stretched within [TimeStretcher::kMinRate, kMaxRate].
+    static bool audioAudibleAt(double speed);
+    // Release due audio through m_audioStretcher at a non-1x forward speed (§6.7).
+    void releaseVarispeedAudio(int64_t P, double speed);
+    // Varispeed wall-axis position of media time `mediaMs` (see m_varispeedAnchorMediaMs).
+    int64_t varispeedWallMs(int64_t mediaMs) const;
     // Enqueue a decoded active-view audio frame onto m_audioQueue (format-guarded).
     void enqueueAudioFrame(AudioDecoderTrack* aTrack, AVFrame* audioFrame, bool dedupTail);
     void cacheOutputAudioFrame(AudioDecoderTrack* aTrack, AVFrame* audioFrame, bool dedupTail);
@@ -239,12 +303,58 @@ private:
     // (pre-roll silently disabled; armNextCut becomes a no-op). Called once in
     // run() after the primary bank + output graph are up.
     bool openPrerollContext();
+    // Install `bank` as the pre-roll context + bank (interrupt callback and
+    // demux source re-pointed at this worker), and the inverse: package the
+    // current pre-roll back up for the pool. Worker thread only.
+    void adoptPrerollBank(std::unique_ptr<DemuxBank> bank);
+    std::unique_ptr<DemuxBank> releasePrerollBank();
+    // Point the pre-roll at clipPath, using only a bank the pool's warmer opened:
+    // opening one here would stall decode on avformat_open_input and probing.
+    // Waiting (pre-roll unchanged, clip reserved in the pool) until that bank
+    // arrives; Failed when the pool is disabled, the wait outlasts
+    // kArmedBankWaitMs, or the bank does not fit the session (bankFitsSession).
+    enum class PrerollSwitch { Switched, Waiting, Failed };
+    PrerollSwitch switchPrerollClip(const QString& clipPath);
+    // A bank can stand in for the primary only with the same feed layout: one
+    // video track per feed, each decoding at the size the primary's does (the
+    // reference track's size being the output graph's).
+    bool bankFitsSession(const DemuxBank& bank) const;
+    // After a cross-clip cut fired: the pre-roll bank (already on the new clip)
+    // becomes the primary and the old primary becomes the pre-roll. Called from
+    // the run loop's decoder-follow before the resync reposition.
+    void swapPrimaryAndPrerollBanks();
     // Bounded incremental pre-roll into m_prerollStagingCache (worker-private;
     // NOT published until the cut swap, so no lock during fill). On first call
     // after arm it av_seek_frame's the preroll context BACKWARD to the trail
     // anchor, then decodes forward until the staging cache covers
     // [target, target+kStagingSpanMs]; schedules the cut once covered.
     void fillStaging();
+    // One staging destination — the armed pre-roll or a cue slot — so both
+    // share the seek and the bounded decode below.
+    struct StagingTarget {
+        AVFormatContext* fmtCtx = nullptr;
+        const QVector<DecoderTrack*>* video = nullptr;
+        const QVector<AudioDecoderTrack*>* audio = nullptr;
+        LiveDemuxSource* demux = nullptr;
+        OutputFrameCache* cache = nullptr;
+        int64_t* newestRefPtsMs = nullptr;
+    };
+    StagingTarget prerollStagingTarget();
+    // Seek the target's demuxer BACKWARD to the trail anchor and empty its cache.
+    void rewindStaging(const StagingTarget& staging, int64_t target);
+    // Decode at most kPrerollPacketsPerTick packets into the target's cache;
+    // true once it covers [target, target+kStagingSpanMs] (or the source ran dry).
+    bool stagePackets(const StagingTarget& staging, int64_t target);
+    // --- Multi-slot pre-roll (worker thread) ---
+    struct CueSlot;
+    void createCueSlots();
+    void releaseCueSlots();
+    void clearCueSlotCache(CueSlot& slot);
+    StagingTarget cueSlotStagingTarget(CueSlot& slot);
+    void reassignCueSlots();
+    bool acquireCueSlotBank(CueSlot& slot);
+    void fillCueSlots();
+    bool takeStagedCue(const QString& clipPath, int64_t targetMs);
     // Arm the cut state (target + staging reset). Caller MUST guarantee no cut is
     // in flight (m_cutArmed false). Called from armNextCut (UI thread, fresh arm)
     // and from the run loop (worker thread, applying a queued re-arm). Atomics
@@ -252,7 +362,8 @@ private:
     // the m_seekGeneration captured when the recall was ISSUED (arm time for a
     // fresh arm, QUEUE time for a re-arm) — stored as m_armSeekGen so any manual
     // seek after that point aborts the cut at fire time (manual-seek-wins policy).
-    void armCutInternal(int64_t targetMs, uint64_t baselineSeekGen, int64_t fireAtPlayheadMs);
+    void armCutInternal(int64_t targetMs, uint64_t baselineSeekGen, int64_t fireAtPlayheadMs,
+                        const QString& clipPath);
     // Store the atomic schedule (output frame index + target ms).
     void scheduleCutAtFrame(qint64 outputFrameIndex, int64_t targetMs);
     bool stagingGpuSurfacesIdle() const;
@@ -280,6 +391,18 @@ private:
     std::atomic<int> m_selectedOutputFeed{-1};
 
     AudioFrameQueue m_audioQueue;            // worker-thread-only
+    // Varispeed audio (worker-thread-only). AudioPlayer aligns pushed PTS against a master
+    // clock it expects to advance at real time, so stretched audio is pushed on a wall axis:
+    // stretcher output frame n sits at m_varispeedWallOriginMs + n ms-equivalent, and the
+    // playhead maps piecewise-linearly, re-anchored on every rate change so it stays
+    // continuous. m_varispeedAudio is false while at 1x or silent.
+    TimeStretcher m_audioStretcher{48000, 2};
+    bool m_varispeedAudio = false;
+    double m_varispeedRate = 1.0;
+    int64_t m_varispeedAnchorMediaMs = 0; // media position where the current rate began
+    int64_t m_varispeedAnchorWallMs = 0;  // its position on the wall axis
+    int64_t m_varispeedWallOriginMs = 0;  // wall position of stretcher output frame 0
+    int64_t m_varispeedNextPtsMs = 0;     // expected PTS of the next released frame
     std::atomic<bool> m_audioReprime{false}; // set by setActiveAudioView (UI thread)
     std::atomic<int> m_lastMoveDir{1};
     int64_t m_sizeAtLastEof = -1;
@@ -291,12 +414,23 @@ private:
     int64_t m_reverseAnchorMs = INT64_MAX;
 
     // PTS(ms) -> byte-offset index of the primary video stream, appended as
-    // packets are read (worker-thread-only; no mutex). All recordings are
+    // packets are read (written on the worker thread under m_frameIndexMutex, which
+    // frameIndexFor takes to copy it; worker-thread reads need no lock). All recordings are
     // ALL-INTRA, so any indexed offset is a valid standalone decode start; the
     // full-reposition path avio_seeks straight to nearestAtOrBefore(target)
     // instead of the coarse av_seek_frame anchor, shortening the forward fill.
     // Survives clearDecoderBuffers (only the per-track frame buffers are wiped).
     FrameIndex m_frameIndex;
+    mutable QMutex m_frameIndexMutex;
+
+    // Packet source for m_fmtCtx / m_prerollFmtCtx: serves the live window from
+    // the recorder's LivePacketRing when resident, the file otherwise. All
+    // reads and seeks on those contexts go through these (worker-thread-only).
+    LiveDemuxSource m_demux;
+    LiveDemuxSource m_prerollDemux;
+    // Prefetches the primary context's next byte range (forward window, or the
+    // FrameIndex-located reverse chunk) on its own I/O thread.
+    DemuxReadAhead m_readAhead;
 
     // Seek-gate generations (read in makeOutputSnapshot; written in seekTo /
     // repositionTo). When m_committedGeneration == m_seekGeneration there is no
@@ -318,13 +452,16 @@ private:
     mutable std::atomic<int64_t> m_lastVisiblePlayheadMs{0};
     mutable std::atomic<bool> m_outputPlayheadCacheGuarded{false};
 
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
     mutable QMutex m_bufferMutex;
     mutable QMutex m_outputRuntimeMutex;
 
     QList<OutputTargetAssignment> m_externalOutputAssignments;
     std::atomic<bool> m_outputTargetsDirty{false};
     std::unique_ptr<OutputFrameCache> m_outputCache;
+    // Shared with the other playback channels; set before start(), may be null.
+    std::shared_ptr<SharedDecodedFrameCache> m_sharedFrames;
+    int m_playbackChannel = 0;
     // Worker-thread-only staging buffer: a reposition decodes the target window
     // here, then merges into the live cache and trims old frames only after
     // coverage (double-buffer; never published to the output thread).
@@ -339,6 +476,13 @@ private:
     AVFormatContext* m_prerollFmtCtx = nullptr;     // mirrors m_fmtCtx
     QVector<DecoderTrack*> m_prerollBank;           // mirrors m_decoderBank
     QVector<AudioDecoderTrack*> m_prerollAudioBank; // mirrors m_audioDecoderBank
+    QString m_prerollClipPath;                      // clip the pre-roll bank is on
+    // Set once the pre-roll opened (run()), cleared at cleanup. Read by the UI
+    // thread in armNextCut / armedCutAvailable instead of m_prerollFmtCtx, which
+    // the worker re-points on every clip switch.
+    std::atomic<bool> m_armedCutReady{false};
+    // Spare opened banks for cross-clip cuts, warmed off the worker thread.
+    DemuxBankPool m_bankPool;
     // Pre-roll target window, sized identically to m_outputCache. Worker-private
     // during the fill (never published) — swapped into m_outputCache at the cut.
     std::unique_ptr<OutputFrameCache> m_prerollStagingCache;
@@ -346,6 +490,12 @@ private:
     std::atomic<int64_t> m_armedTargetMs{-1};
     std::atomic<bool> m_cutArmed{false};
     std::atomic<bool> m_prerollSeekPending{false};
+    // Started when an armed cross-clip cut first finds no warmed bank for its
+    // clip, keyed by that clip and target so a re-arm restarts it. Worker
+    // thread only.
+    QElapsedTimer m_armedBankWait;
+    QString m_armedBankWaitClip;
+    int64_t m_armedBankWaitTargetMs = -1;
     // True once the staging cache covers [target, target+span]. Atomic because
     // armNextCut clears it from the UI thread while the worker reads/writes it.
     std::atomic<bool> m_stagingCovers{false};
@@ -401,6 +551,36 @@ private:
     // through the safe re-arm queue (alongside m_pendingRearmMs).
     std::atomic<int64_t> m_armedFireAtMs{-1};
     std::atomic<int64_t> m_pendingRearmFireAtMs{-1};
+    // Clip of the armed / queued cut (empty = current clip); guarded by m_mutex.
+    QString m_armedClipPath;
+    QString m_pendingRearmClipPath;
+    // True while the staged window comes from a clip other than the primary's
+    // (written by fillStaging, read at fire time on the output thread).
+    std::atomic<bool> m_stagingCrossClip{false};
+    // A cross-clip cut fired: the output cache shows the new clip but the
+    // primary bank is still on the old one. Set by maybeFireScheduledCut (with
+    // the decoder-follow), cleared by the run loop once the banks are swapped;
+    // while set, decodePacketIntoBank and fillStaging stand down so no old-clip
+    // frame lands in the promoted cache and the pre-roll is not touched.
+    std::atomic<bool> m_clipSwapPending{false};
+    // One staged upcoming cue: its own demux bank, packet source and staging
+    // cache (sized like m_prerollStagingCache). Worker-thread-only.
+    struct CueSlot {
+        PrerollCue cue;          // clip key + target; invalid = free
+        int priority = INT_MAX;  // index in the wanted list (fill order)
+        std::unique_ptr<DemuxBank> bank;
+        LiveDemuxSource demux;
+        std::unique_ptr<OutputFrameCache> cache;
+        int64_t newestRefPtsMs = INT64_MIN;
+        bool seekPending = false;
+        bool covers = false;
+        bool awaitingBank = false; // reserved in the bank pool, not opened yet
+    };
+    std::vector<std::unique_ptr<CueSlot>> m_cueSlots; // fill order
+    // Wanted cues from setStagedCues (guarded by m_mutex); the dirty flag makes
+    // the worker re-plan the slots on its next fill.
+    QVector<PrerollCue> m_wantedCues;
+    std::atomic<bool> m_cuesDirty{false};
     // Immutable snapshot of m_outputCache published to the output thread
     // (replaces the per-tick deep copy in makeOutputSnapshot).
     SharedCacheSlot m_publishedCache;
@@ -38,7 +38,7 @@ PlaylistPlayout::Boundary PlaylistPlayout::evaluate(qint64 playheadMs, double cu
 
     const ReplayEntry next = m_entries[m_index + 1];
     m_armedCurrent = true;
-    return Boundary{/*valid*/ true, cur.outMs, next.inMs, next.speed};
+    return Boundary{/*valid*/ true, cur.outMs, next.inMs, next.speed, next.clipPath};
 }
 
 std::optional<ReplayEntry> PlaylistPlayout::onBoundaryFired() {
@@ -18,13 +18,15 @@
 class PlaylistPlayout {
 public:
     // A boundary cut to arm: fire when the current entry's playhead reaches fireAtMs
-    // (its out-point), jumping to targetMs (the next entry's in-point), after which
-    // the next entry plays at targetSpeed.
+    // (its out-point), jumping to targetMs (the next entry's in-point) on
+    // targetClipPath (the next entry's clip), after which the next entry plays at
+    // targetSpeed.
     struct Boundary {
         bool valid = false;
         qint64 fireAtMs = -1;
         qint64 targetMs = 0;
         double targetSpeed = 1.0;
+        QString targetClipPath;
     };
 
     // Begin playout at `index` over `entries`. The caller seeks to the entry's
@@ -0,0 +1,62 @@
+#include "playback/shareddecodedframecache.h"
+
+#include <algorithm>
+
+int SharedDecodedFrameCache::capacityFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_SHARED_DECODE_FRAMES");
+    if (env.isEmpty()) return kDefaultCapacity;
+    bool ok = false;
+    const int parsed = env.toInt(&ok);
+    return (ok && parsed >= 0) ? parsed : kDefaultCapacity;
+}
+
+SharedDecodedFrameCache::SharedDecodedFrameCache(int capacity)
+    : m_capacity(std::max(0, capacity)) {}
+
+FrameHandle SharedDecodedFrameCache::find(const QString& clipPath, int feedIndex, qint64 ptsMs) {
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_index.find(Key(clipPath, feedIndex, ptsMs));
+    if (it == m_index.end()) {
+        m_stats.misses++;
+        return FrameHandle();
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    m_stats.hits++;
+    return it->second->frame;
+}
+
+void SharedDecodedFrameCache::insert(const QString& clipPath, const FrameHandle& frame) {
+    if (m_capacity == 0 || frame.isNull() || frame.isGpuBacked()) return;
+    const FramePayloadKey& payload = frame.metadata().key;
+    if (payload.isPlaceholder) return;
+
+    const Key key(clipPath, payload.feedIndex, payload.ptsMs);
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        it->second->frame = frame;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return;
+    }
+    m_entries.push_front({key, frame});
+    m_index.emplace(key, m_entries.begin());
+    m_stats.insertions++;
+    while (int(m_entries.size()) > m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        m_stats.evictions++;
+    }
+}
+
+void SharedDecodedFrameCache::clear() {
+    QMutexLocker locker(&m_mutex);
+    m_index.clear();
+    m_entries.clear();
+}
+
+SharedDecodedFrameCache::Stats SharedDecodedFrameCache::stats() const {
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.frames = int(m_entries.size());
+    return stats;
+}
@@ -0,0 +1,66 @@
+#ifndef SHAREDDECODEDFRAMECACHE_H
+#define SHAREDDECODEDFRAMECACHE_H
+
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+
+#include <list>
+#include <map>
+#include <tuple>
+
+#include "playback/output/framehandle.h"
+
+// Decoded video frames shared by the playback channels of one session, so two channels
+// playing the same moment of the same clip decode it once. Keyed by clip path, feed and
+// pts; the least-recently-used frames beyond the capacity are dropped (handles a channel
+// already holds stay valid, frame data is immutable). GPU-backed frames are never
+// cached: their surfaces are fenced against the decoding channel's renderer.
+// Thread-safe.
+class SharedDecodedFrameCache {
+public:
+    struct Stats {
+        qint64 hits = 0;       // find() returned a frame
+        qint64 misses = 0;     // find() found nothing (the caller decodes)
+        qint64 insertions = 0; // frames published
+        qint64 evictions = 0;  // frames dropped to stay within capacity
+        int frames = 0;        // frames held now
+    };
+
+    static constexpr int kDefaultCapacity = 96;
+    // OLR_SHARED_DECODE_FRAMES (frames kept across all feeds); 0 disables sharing.
+    static int capacityFromEnvironment();
+
+    explicit SharedDecodedFrameCache(int capacity = kDefaultCapacity);
+
+    SharedDecodedFrameCache(const SharedDecodedFrameCache&) = delete;
+    SharedDecodedFrameCache& operator=(const SharedDecodedFrameCache&) = delete;
+
+    int capacity() const { return m_capacity; }
+
+    // The frame of `clipPath` / `feedIndex` at `ptsMs`, or a null handle on a miss.
+    FrameHandle find(const QString& clipPath, int feedIndex, qint64 ptsMs);
+    // Publishes a decoded frame (keyed by its metadata) as most recently used. Null,
+    // placeholder and GPU-backed frames are ignored.
+    void insert(const QString& clipPath, const FrameHandle& frame);
+    void clear();
+
+    Stats stats() const;
+
+private:
+    using Key = std::tuple<QString, int, qint64>; // clip, feed, pts
+
+    struct Entry {
+        Key key;
+        FrameHandle frame;
+    };
+
+    const int m_capacity;
+
+    mutable QMutex m_mutex;
+    std::list<Entry> m_entries; // front = most recently used
+    std::map<Key, std::list<Entry>::iterator> m_index;
+    Stats m_stats;
+};
+
+#endif // SHAREDDECODEDFRAMECACHE_H
@@ -0,0 +1,186 @@
+#include "playback/thumbnailatlas.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+constexpr char kMagic[8] = {'O', 'L', 'R', 'T', 'H', 'M', 'B', '1'};
+constexpr quint32 kVersion = 1;
+
+struct Header {
+    char magic[8];
+    quint32 version;
+    quint32 thumbWidth;
+    quint32 thumbHeight;
+    quint32 reserved;
+    qint64 count; // committed records; written last on append
+};
+
+constexpr qint64 kHeaderBytes = 64;
+static_assert(sizeof(Header) <= kHeaderBytes, "atlas header overflows its slot");
+constexpr qint64 kRecordHeaderBytes = 16; // int64 ptsMs, int32 view, int32 reserved
+constexpr qint64 kRecordBytes = kRecordHeaderBytes + ThumbnailAtlas::kThumbBytes;
+// ~11 MB per growth step: a few remaps per hour of a multi-view recording.
+constexpr qint64 kGrowRecords = 256;
+// Guards the per-view index against a corrupt record on resume.
+constexpr int kMaxViews = 64;
+} // namespace
+
+QString ThumbnailAtlas::atlasPathFor(const QString& videoPath) {
+    return videoPath + QStringLiteral(".thumbs");
+}
+
+ThumbnailAtlas::~ThumbnailAtlas() { close(); }
+
+bool ThumbnailAtlas::open(const QString& path) {
+    close();
+    QWriteLocker locker(&m_lock);
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) return false;
+
+    Header header{};
+    const qint64 fileSize = m_file.size();
+    const bool resumable =
+        fileSize >= kHeaderBytes &&
+        m_file.read(reinterpret_cast<char*>(&header), sizeof(header)) == qint64(sizeof(header)) &&
+        std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion &&
+        header.thumbWidth == quint32(kThumbWidth) && header.thumbHeight == quint32(kThumbHeight) &&
+        header.count >= 0 && kHeaderBytes + header.count * kRecordBytes <= fileSize;
+
+    if (!resumable) {
+        if (!m_file.resize(0)) {
+            m_file.close();
+            return false;
+        }
+        header = Header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.thumbWidth = kThumbWidth;
+        header.thumbHeight = kThumbHeight;
+    }
+
+    const qint64 fileRecords = resumable ? (fileSize - kHeaderBytes) / kRecordBytes : 0;
+    if (!mapCapacity(std::max(fileRecords, kGrowRecords))) {
+        m_file.close();
+        return false;
+    }
+    if (!resumable) std::memcpy(m_map, &header, sizeof(header));
+
+    // Rebuild the per-view index from the committed records.
+    m_count = header.count;
+    for (qint64 r = 0; r < m_count; ++r) {
+        const uchar* rec = recordAt(r);
+        qint64 ptsMs = 0;
+        qint32 view = 0;
+        std::memcpy(&ptsMs, rec, sizeof(ptsMs));
+        std::memcpy(&view, rec + 8, sizeof(view));
+        if (view < 0 || view >= kMaxViews) continue;
+        if (view >= int(m_views.size())) m_views.resize(size_t(view) + 1);
+        m_views[size_t(view)].append(ptsMs, r);
+    }
+    return true;
+}
+
+void ThumbnailAtlas::close() {
+    QWriteLocker locker(&m_lock);
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+        // Drop the unused pre-grown tail.
+        m_file.resize(kHeaderBytes + m_count * kRecordBytes);
+    }
+    if (m_file.isOpen()) m_file.close();
+    m_capacity = 0;
+    m_count = 0;
+    m_views.clear();
+}
+
+bool ThumbnailAtlas::isOpen() const {
+    QReadLocker locker(&m_lock);
+    return m_map != nullptr;
+}
+
+QString ThumbnailAtlas::path() const {
+    QReadLocker locker(&m_lock);
+    return m_file.fileName();
+}
+
+bool ThumbnailAtlas::append(int view, qint64 ptsMs, const uchar* rgb) {
+    if (view < 0 || view >= kMaxViews || !rgb) return false;
+    QWriteLocker locker(&m_lock);
+    if (!m_map) return false;
+    if (view >= int(m_views.size())) m_views.resize(size_t(view) + 1);
+    FrameIndex& index = m_views[size_t(view)];
+    const std::optional<qint64> newest = index.newestPtsMs();
+    if (newest.has_value() && ptsMs <= newest.value()) return false;
+    if (m_count == m_capacity && !mapCapacity(m_capacity + kGrowRecords)) return false;
+
+    uchar* rec = recordAt(m_count);
+    const qint32 view32 = view;
+    const qint32 reserved = 0;
+    std::memcpy(rec, &ptsMs, sizeof(ptsMs));
+    std::memcpy(rec + 8, &view32, sizeof(view32));
+    std::memcpy(rec + 12, &reserved, sizeof(reserved));
+    std::memcpy(rec + kRecordHeaderBytes, rgb, size_t(kThumbBytes));
+    index.append(ptsMs, m_count);
+    ++m_count;
+    commitCount();
+    return true;
+}
+
+QImage ThumbnailAtlas::image(int view, qint64 ptsMs) const {
+    QReadLocker locker(&m_lock);
+    if (!m_map || view < 0 || view >= int(m_views.size())) return {};
+    const std::optional<qint64> record = m_views[size_t(view)].nearestAtOrBefore(ptsMs);
+    if (!record.has_value()) return {};
+    const uchar* pixels = recordAt(record.value()) + kRecordHeaderBytes;
+    // Deep copy: the mapping may move on the next growth.
+    return QImage(pixels, kThumbWidth, kThumbHeight, kThumbWidth * 3, QImage::Format_RGB888)
+        .copy();
+}
+
+std::optional<qint64> ThumbnailAtlas::newestPtsMs(int view) const {
+    QReadLocker locker(&m_lock);
+    if (view < 0 || view >= int(m_views.size())) return std::nullopt;
+    return m_views[size_t(view)].newestPtsMs();
+}
+
+int ThumbnailAtlas::count() const {
+    QReadLocker locker(&m_lock);
+    return int(m_count);
+}
+
+int ThumbnailAtlas::viewCount() const {
+    QReadLocker locker(&m_lock);
+    return int(m_views.size());
+}
+
+bool ThumbnailAtlas::mapCapacity(qint64 records) {
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_capacity = 0;
+    const qint64 bytes = kHeaderBytes + records * kRecordBytes;
+    if (m_file.size() < bytes && !m_file.resize(bytes)) return false;
+    m_map = m_file.map(0, bytes);
+    if (!m_map) return false;
+    m_capacity = records;
+    return true;
+}
+
+const uchar* ThumbnailAtlas::recordAt(qint64 record) const {
+    return m_map + kHeaderBytes + record * kRecordBytes;
+}
+
+uchar* ThumbnailAtlas::recordAt(qint64 record) {
+    return m_map + kHeaderBytes + record * kRecordBytes;
+}
+
+void ThumbnailAtlas::commitCount() {
+    std::memcpy(m_map + offsetof(Header, count), &m_count, sizeof(m_count));
+}
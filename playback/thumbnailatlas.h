@@ -0,0 +1,74 @@
+#ifndef THUMBNAILATLAS_H
+#define THUMBNAILATLAS_H
+
+#include "playback/frameindex.h"
+
+#include <QFile>
+#include <QImage>
+#include <QReadWriteLock>
+#include <QString>
+#include <QtGlobal>
+
+#include <optional>
+#include <vector>
+
+// Filmstrip store for one recording: small RGB888 thumbnails per view, kept
+// in a memory-mapped side file next to the video (<video>.thumbs) so a
+// reopened recording shows its filmstrip without decoding anything.
+//
+// File layout: a fixed header, then fixed-size records
+// { int64 ptsMs, int32 view, int32 reserved, RGB888 pixels }. The header's
+// record count is written after the record itself, so a crash mid-append only
+// loses that record. The file is pre-grown in chunks and remapped on growth.
+//
+// One writer (ThumbnailIndexer) appends; any thread (the QML image provider's
+// loader threads) reads. Thumbnails per view are appended in strictly
+// increasing PTS order; out-of-order appends are dropped, as in FrameIndex.
+class ThumbnailAtlas {
+public:
+    static constexpr int kThumbWidth = 160;
+    static constexpr int kThumbHeight = 90;
+    static constexpr int kThumbBytes = kThumbWidth * kThumbHeight * 3;
+
+    // <video>.thumbs, alongside the recording.
+    static QString atlasPathFor(const QString& videoPath);
+
+    ThumbnailAtlas() = default;
+    ~ThumbnailAtlas();
+
+    ThumbnailAtlas(const ThumbnailAtlas&) = delete;
+    ThumbnailAtlas& operator=(const ThumbnailAtlas&) = delete;
+
+    // Opens an existing atlas (resuming its records) or creates a new one. A
+    // file with a foreign header or thumbnail size is discarded and recreated.
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const;
+    QString path() const;
+
+    // `rgb` is kThumbBytes of tightly packed RGB888.
+    bool append(int view, qint64 ptsMs, const uchar* rgb);
+
+    // Nearest thumbnail at/before ptsMs for `view`; null when there is none
+    // (view not indexed yet, or ptsMs before its first thumbnail).
+    QImage image(int view, qint64 ptsMs) const;
+    std::optional<qint64> newestPtsMs(int view) const;
+    int count() const;
+    int viewCount() const;
+
+private:
+    bool mapCapacity(qint64 records);
+    const uchar* recordAt(qint64 record) const;
+    uchar* recordAt(qint64 record);
+    void commitCount();
+
+    mutable QReadWriteLock m_lock;
+    QFile m_file;
+    uchar* m_map = nullptr;
+    qint64 m_capacity = 0; // records the mapping can hold
+    qint64 m_count = 0;    // committed records
+    // Per view: ptsMs -> record number (stored in FrameIndex's offset slot).
+    std::vector<FrameIndex> m_views;
+};
+
+#endif // THUMBNAILATLAS_H
@@ -0,0 +1,47 @@
+#include "playback/thumbnailimageprovider.h"
+
+#include "playback/thumbnailatlas.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+
+#include <utility>
+
+void ThumbnailAtlasSlot::set(std::shared_ptr<ThumbnailAtlas> atlas) {
+    QMutexLocker locker(&m_mutex);
+    m_atlas = std::move(atlas);
+}
+
+std::shared_ptr<ThumbnailAtlas> ThumbnailAtlasSlot::get() const {
+    QMutexLocker locker(&m_mutex);
+    return m_atlas;
+}
+
+ThumbnailImageProvider::ThumbnailImageProvider(std::shared_ptr<ThumbnailAtlasSlot> slot)
+    : QQuickImageProvider(QQuickImageProvider::Image), m_slot(std::move(slot)) {}
+
+QImage ThumbnailImageProvider::requestImage(const QString& id, QSize* size,
+                                            const QSize& requestedSize) {
+    const QStringList parts = id.section(QLatin1Char('?'), 0, 0).split(QLatin1Char('/'));
+    QImage image;
+    if (parts.size() == 2 && m_slot) {
+        bool viewOk = false;
+        bool ptsOk = false;
+        const int view = parts.at(0).toInt(&viewOk);
+        const qint64 ptsMs = parts.at(1).toLongLong(&ptsOk);
+        const std::shared_ptr<ThumbnailAtlas> atlas = m_slot->get();
+        if (viewOk && ptsOk && atlas) image = atlas->image(view, ptsMs);
+    }
+    if (image.isNull()) {
+        // Not indexed (yet): a transparent cell instead of a provider warning.
+        image = QImage(ThumbnailAtlas::kThumbWidth, ThumbnailAtlas::kThumbHeight,
+                       QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+    }
+    if (size) *size = image.size();
+    if (requestedSize.width() > 0 && requestedSize.height() > 0 &&
+        requestedSize != image.size()) {
+        image = image.scaled(requestedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
@@ -0,0 +1,37 @@
+#ifndef THUMBNAILIMAGEPROVIDER_H
+#define THUMBNAILIMAGEPROVIDER_H
+
+#include <QMutex>
+#include <QQuickImageProvider>
+
+#include <memory>
+
+class ThumbnailAtlas;
+
+// Hand-off point between UIManager, which swaps the atlas per recording, and
+// the image provider, which the QML engine owns and calls from its loader
+// threads. Either side may outlive the other.
+class ThumbnailAtlasSlot {
+public:
+    void set(std::shared_ptr<ThumbnailAtlas> atlas);
+    std::shared_ptr<ThumbnailAtlas> get() const;
+
+private:
+    mutable QMutex m_mutex;
+    std::shared_ptr<ThumbnailAtlas> m_atlas;
+};
+
+// "image://thumbs/<view>/<ptsMs>": the filmstrip thumbnail nearest at/before
+// ptsMs. A trailing "?r=<revision>" is ignored here; QML appends the UI's
+// thumbnail revision so cached misses are re-requested as the index grows.
+class ThumbnailImageProvider : public QQuickImageProvider {
+public:
+    explicit ThumbnailImageProvider(std::shared_ptr<ThumbnailAtlasSlot> slot);
+
+    QImage requestImage(const QString& id, QSize* size, const QSize& requestedSize) override;
+
+private:
+    std::shared_ptr<ThumbnailAtlasSlot> m_slot;
+};
+
+#endif // THUMBNAILIMAGEPROVIDER_H
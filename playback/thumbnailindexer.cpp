@@ -0,0 +1,237 @@
+#include "playback/thumbnailindexer.h"
+
+#include "playback/livedemuxsource.h"
+#include "playback/thumbnailatlas.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libswscale/swscale.h>
+}
+
+namespace {
+// Live edge / EOF poll: thumbnails are seconds apart, no need to spin faster.
+constexpr unsigned long kPollMs = 500;
+// Header not written yet (recording just started): retry the open.
+constexpr unsigned long kOpenRetryMs = 500;
+// Upper bound on thumbnailsAdded() while catching up on an existing file.
+constexpr qint64 kNotifyIntervalMs = 500;
+
+struct ViewDecoder {
+    int view = -1;
+    AVCodecContext* codec = nullptr;
+    SwsContext* sws = nullptr;
+};
+
+// Decodes exactly one packet into a kThumbBytes RGB888 thumbnail. The decoder
+// is drained and flushed afterwards: packets in between are never sent, so no
+// reference state may carry over (none is needed, every packet is intra).
+bool decodeThumbnail(ViewDecoder& dec, const AVPacket* pkt, AVFrame* frame, uint8_t* rgb) {
+    if (avcodec_send_packet(dec.codec, pkt) < 0) {
+        avcodec_flush_buffers(dec.codec);
+        return false;
+    }
+    int ret = avcodec_receive_frame(dec.codec, frame);
+    if (ret == AVERROR(EAGAIN)) {
+        // Held back by the decoder's output delay: drain it out.
+        avcodec_send_packet(dec.codec, nullptr);
+        ret = avcodec_receive_frame(dec.codec, frame);
+    }
+    avcodec_flush_buffers(dec.codec);
+    if (ret < 0) return false;
+
+    dec.sws = sws_getCachedContext(dec.sws, frame->width, frame->height,
+                                   static_cast<AVPixelFormat>(frame->format),
+                                   ThumbnailAtlas::kThumbWidth, ThumbnailAtlas::kThumbHeight,
+                                   AV_PIX_FMT_RGB24, SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+    if (!dec.sws) {
+        av_frame_unref(frame);
+        return false;
+    }
+    uint8_t* dst[4] = {rgb, nullptr, nullptr, nullptr};
+    int dstStride[4] = {ThumbnailAtlas::kThumbWidth * 3, 0, 0, 0};
+    sws_scale(dec.sws, frame->data, frame->linesize, 0, frame->height, dst, dstStride);
+    av_frame_unref(frame);
+    return true;
+}
+} // namespace
+
+qint64 ThumbnailIndexer::intervalFromEnvironment() {
+    const QByteArray env = qgetenv("OLR_THUMBNAIL_INTERVAL_MS");
+    if (env.isEmpty()) return kDefaultIntervalMs;
+    bool ok = false;
+    const qint64 parsed = env.toLongLong(&ok);
+    return (ok && parsed >= 0) ? parsed : kDefaultIntervalMs;
+}
+
+bool ThumbnailIndexer::isDue(std::optional<qint64> lastPtsMs, qint64 ptsMs, qint64 intervalMs) {
+    return !lastPtsMs.has_value() || ptsMs >= lastPtsMs.value() + intervalMs;
+}
+
+int ThumbnailIndexer::lowresFor(int codecWidth, int maxLowres) {
+    int shift = 0;
+    while (shift < maxLowres && (codecWidth >> (shift + 1)) >= ThumbnailAtlas::kThumbWidth) {
+        ++shift;
+    }
+    return shift;
+}
+
+ThumbnailIndexer::ThumbnailIndexer(std::shared_ptr<ThumbnailAtlas> atlas,
+                                   const QString& videoPath, qint64 intervalMs, QObject* parent)
+    : QThread(parent), m_atlas(std::move(atlas)), m_videoPath(videoPath),
+      m_intervalMs(std::max<qint64>(1, intervalMs)) {}
+
+ThumbnailIndexer::~ThumbnailIndexer() { stop(); }
+
+void ThumbnailIndexer::stop() {
+    requestInterruption();
+    wait();
+}
+
+int ThumbnailIndexer::interruptCallback(void* opaque) {
+    auto* indexer = static_cast<ThumbnailIndexer*>(opaque);
+    return indexer ? indexer->isInterruptionRequested() : 0;
+}
+
+void ThumbnailIndexer::run() {
+    if (!m_atlas || !m_atlas->isOpen()) return;
+    const QByteArray path = m_videoPath.toUtf8();
+
+    AVFormatContext* ctx = nullptr;
+    while (!isInterruptionRequested()) {
+        ctx = avformat_alloc_context();
+        if (!ctx) return;
+        ctx->interrupt_callback.callback = &ThumbnailIndexer::interruptCallback;
+        ctx->interrupt_callback.opaque = this;
+        if (avformat_open_input(&ctx, path.constData(), nullptr, nullptr) == 0 &&
+            avformat_find_stream_info(ctx, nullptr) >= 0) {
+            break;
+        }
+        avformat_close_input(&ctx);
+        msleep(kOpenRetryMs);
+    }
+    if (!ctx) return;
+
+    // Views are numbered by video-stream order, as PlaybackWorker maps feeds.
+    std::vector<ViewDecoder> decoders;
+    std::vector<int> decoderForStream(ctx->nb_streams, -1);
+    int refStream = -1;
+    int view = 0;
+    for (unsigned int i = 0; i < ctx->nb_streams; ++i) {
+        const AVCodecParameters* params = ctx->streams[i]->codecpar;
+        if (params->codec_type != AVMEDIA_TYPE_VIDEO) continue;
+        const int thisView = view++;
+        if (refStream < 0) refStream = int(i);
+        if (params->codec_id == AV_CODEC_ID_H264) continue; // hardware-only decode
+
+        const AVCodec* codec = avcodec_find_decoder(params->codec_id);
+        if (!codec) continue;
+        AVCodecContext* cctx = avcodec_alloc_context3(codec);
+        if (!cctx) continue;
+        avcodec_parameters_to_context(cctx, params);
+        cctx->thread_count = 1;
+        cctx->lowres = lowresFor(params->width, codec->max_lowres);
+        cctx->skip_loop_filter = AVDISCARD_ALL;
+        cctx->flags2 |= AV_CODEC_FLAG2_FAST;
+        if (avcodec_open2(cctx, codec, nullptr) < 0) {
+            avcodec_free_context(&cctx);
+            continue;
+        }
+        decoderForStream[i] = int(decoders.size());
+        decoders.push_back(ViewDecoder{thisView, cctx, nullptr});
+    }
+
+    // Resume point: the least-advanced view's newest thumbnail (0 if any view
+    // has none yet). Already-covered packets are skipped by isDue().
+    auto resumeMs = [&]() -> qint64 {
+        qint64 ms = -1;
+        for (const ViewDecoder& dec : decoders) {
+            const std::optional<qint64> newest = m_atlas->newestPtsMs(dec.view);
+            if (!newest.has_value()) return 0;
+            ms = (ms < 0) ? newest.value() : std::min(ms, newest.value());
+        }
+        return std::max<qint64>(0, ms);
+    };
+
+    LiveDemuxSource demux;
+    AVPacket* pkt = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    QByteArray rgb(ThumbnailAtlas::kThumbBytes, Qt::Uninitialized);
+    if (!decoders.empty() && pkt && frame) {
+        demux.attach(ctx, m_videoPath, refStream);
+        const qint64 startMs = resumeMs();
+        if (startMs > 0) demux.seekMs(startMs);
+
+        int64_t sizeAtLastEof = -1;
+        bool pendingNotify = false;
+        QElapsedTimer sinceNotify;
+        sinceNotify.start();
+        while (!isInterruptionRequested()) {
+            const int ret = demux.read(pkt);
+            if (ret == AVERROR(EAGAIN)) { // caught up with the recorder (ring)
+                msleep(kPollMs);
+                // Recording over: re-seeking drops the withdrawn ring for the file.
+                if (!m_follow.load()) demux.seekMs(resumeMs());
+                continue;
+            }
+            if (ret < 0) {
+                if (!m_follow.load()) break;
+                msleep(kPollMs);
+                const int64_t sz = ctx->pb ? avio_size(ctx->pb) : -1;
+                if (sz > sizeAtLastEof) {
+                    // Grown: un-latch the demuxer, as the playback EOF path does.
+                    if (ctx->pb) {
+                        ctx->pb->eof_reached = 0;
+                        ctx->pb->error = 0;
+                    }
+                    avformat_flush(ctx);
+                    demux.seekMs(resumeMs());
+                    sizeAtLastEof = sz;
+                }
+            } else {
+                const int idx = (pkt->stream_index >= 0 &&
+                                 pkt->stream_index < int(decoderForStream.size()))
+                                    ? decoderForStream[size_t(pkt->stream_index)]
+                                    : -1;
+                const int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+                if (idx >= 0 && ts != AV_NOPTS_VALUE) {
+                    ViewDecoder& dec = decoders[size_t(idx)];
+                    const qint64 ptsMs = av_rescale_q(
+                        ts, ctx->streams[pkt->stream_index]->time_base, AVRational{1, 1000});
+                    if (isDue(m_atlas->newestPtsMs(dec.view), ptsMs, m_intervalMs) &&
+                        decodeThumbnail(dec, pkt, frame, reinterpret_cast<uint8_t*>(rgb.data())) &&
+                        m_atlas->append(dec.view, ptsMs,
+                                        reinterpret_cast<const uchar*>(rgb.constData()))) {
+                        pendingNotify = true;
+                    }
+                }
+                av_packet_unref(pkt);
+            }
+            if (pendingNotify && sinceNotify.elapsed() >= kNotifyIntervalMs) {
+                emit thumbnailsAdded();
+                pendingNotify = false;
+                sinceNotify.restart();
+            }
+        }
+        if (pendingNotify) emit thumbnailsAdded();
+        demux.detach();
+    }
+
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    for (ViewDecoder& dec : decoders) {
+        sws_freeContext(dec.sws);
+        avcodec_free_context(&dec.codec);
+    }
+    avformat_close_input(&ctx);
+    qDebug() << "ThumbnailIndexer: stopped with" << m_atlas->count() << "thumbnails for"
+             << m_videoPath;
+}
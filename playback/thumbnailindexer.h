@@ -0,0 +1,63 @@
+#ifndef THUMBNAILINDEXER_H
+#define THUMBNAILINDEXER_H
+
+#include <QString>
+#include <QThread>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+class ThumbnailAtlas;
+
+// Background filmstrip builder. Reads the recording with its own demux
+// context (the live packet ring while recording, the file otherwise), decodes
+// one packet per view every intervalMs and appends a ThumbnailAtlas-sized RGB
+// thumbnail. Recordings are ALL-INTRA, so a due packet decodes on its own and
+// every packet in between is skipped without touching a decoder.
+//
+// Kept cheap so it never competes with PlaybackWorker for decode time: a
+// single-threaded decoder per view at the largest lowres that still covers the
+// thumbnail width, loop filter skipped, and the thread runs at
+// QThread::LowestPriority (the caller's start()). H.264 views are skipped:
+// H.264 is hardware-decode-only and the hardware sessions belong to playback.
+//
+// Resumes from the atlas's newest thumbnails on reopen, and follows the
+// growing file until stop() or, after finishAtEof(), the end of the file.
+class ThumbnailIndexer : public QThread {
+    Q_OBJECT
+public:
+    static constexpr qint64 kDefaultIntervalMs = 2000;
+    // OLR_THUMBNAIL_INTERVAL_MS; 0 disables the filmstrip.
+    static qint64 intervalFromEnvironment();
+    // A view's first packet, or the first one intervalMs past its last thumbnail.
+    static bool isDue(std::optional<qint64> lastPtsMs, qint64 ptsMs, qint64 intervalMs);
+    // Largest lowres shift (<= maxLowres) whose decoded width still covers a
+    // thumbnail, so the scaler only ever shrinks.
+    static int lowresFor(int codecWidth, int maxLowres);
+
+    ThumbnailIndexer(std::shared_ptr<ThumbnailAtlas> atlas, const QString& videoPath,
+                     qint64 intervalMs, QObject* parent = nullptr);
+    ~ThumbnailIndexer() override;
+
+    void stop();
+    // The recording has ended: index up to the end of the file, then exit.
+    void finishAtEof() { m_follow.store(false); }
+
+signals:
+    // Throttled: new thumbnails are in the atlas.
+    void thumbnailsAdded();
+
+protected:
+    void run() override;
+
+private:
+    static int interruptCallback(void* opaque);
+
+    std::shared_ptr<ThumbnailAtlas> m_atlas;
+    QString m_videoPath;
+    qint64 m_intervalMs;
+    std::atomic<bool> m_follow{true};
+};
+
+#endif // THUMBNAILINDEXER_H
@@ -0,0 +1,168 @@
+#include "playback/timestretcher.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+namespace {
+constexpr int kCoarseStep = 4; // coarse search grid, frames; refined to 1 around the best
+constexpr int kLanes = 8;      // independent partial sums in correlation()
+constexpr float kFromS16 = 1.0f / 32768.0f;
+constexpr double kPi = 3.14159265358979323846;
+} // namespace
+
+TimeStretcher::TimeStretcher(int sampleRate, int channels)
+    : m_sampleRate(qMax(8000, sampleRate)),
+      m_channels(qMax(1, channels)),
+      m_hop(m_sampleRate / 100),
+      m_window(2 * m_hop),
+      m_search(m_sampleRate / 200) {
+    m_hann.resize(m_window);
+    for (int i = 0; i < m_window; ++i)
+        m_hann[i] = float(0.5 - 0.5 * std::cos(2.0 * kPi * double(i) / double(m_window)));
+    reset();
+}
+
+void TimeStretcher::setRate(double rate) {
+    m_rate = qBound(kMinRate, rate, kMaxRate);
+}
+
+void TimeStretcher::reset() {
+    m_in.clear();
+    m_mono.clear();
+    m_overlap.fill(0.0f, m_hop * m_channels);
+    m_analysisPos = 0.0;
+    m_prevSegment = 0;
+    m_hasPrevious = false;
+    m_inputFramesTotal = 0;
+    m_outputFramesTotal = 0;
+}
+
+double TimeStretcher::correlation(const float* candidate) const {
+    // Match against the natural continuation of the previous segment over one hop, the span
+    // the two segments overlap in the output. Normalized by the candidate's energy only: the
+    // template is the same for every candidate. Independent lane accumulators let the
+    // compiler keep the sums in vector registers without reassociating (no -ffast-math).
+    const float* natural = m_mono.constData() + m_prevSegment + m_hop;
+    float dot[kLanes] = {};
+    float energy[kLanes] = {};
+    const int blocked = m_hop - m_hop % kLanes;
+    for (int i = 0; i < blocked; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            dot[l] += natural[i + l] * candidate[i + l];
+            energy[l] += candidate[i + l] * candidate[i + l];
+        }
+    }
+    double dotSum = 0.0;
+    double energySum = 0.0;
+    for (int l = 0; l < kLanes; ++l) {
+        dotSum += dot[l];
+        energySum += energy[l];
+    }
+    for (int i = blocked; i < m_hop; ++i) {
+        dotSum += natural[i] * candidate[i];
+        energySum += candidate[i] * candidate[i];
+    }
+    return dotSum / std::sqrt(energySum + 1e-9);
+}
+
+int TimeStretcher::bestOffset(int nominal, int lo, int hi) const {
+    const float* mono = m_mono.constData();
+    int best = nominal;
+    double bestScore = correlation(mono + nominal);
+    for (int pos = lo; pos <= hi; pos += kCoarseStep) {
+        const double score = correlation(mono + pos);
+        if (score > bestScore) {
+            bestScore = score;
+            best = pos;
+        }
+    }
+    const int center = best;
+    for (int pos = qMax(lo, center - kCoarseStep + 1); pos <= qMin(hi, center + kCoarseStep - 1);
+         ++pos) {
+        if (pos == center) continue;
+        const double score = correlation(mono + pos);
+        if (score > bestScore) {
+            bestScore = score;
+            best = pos;
+        }
+    }
+    return best;
+}
+
+void TimeStretcher::trimConsumedInput() {
+    // Keep everything the next hop may still read: its search window and the natural
+    // continuation of the last segment.
+    int keepFrom = int(std::floor(m_analysisPos)) - m_search;
+    if (m_hasPrevious) keepFrom = qMin(keepFrom, m_prevSegment + m_hop);
+    const int available = m_mono.size();
+    const int drop = qBound(0, keepFrom, available);
+    if (drop <= 0) return;
+    m_in.remove(0, drop * m_channels);
+    m_mono.remove(0, drop);
+    m_analysisPos -= drop;
+    m_prevSegment -= drop;
+}
+
+int TimeStretcher::process(const int16_t* in, int frames, QByteArray& out) {
+    if (in && frames > 0) {
+        const int base = m_mono.size();
+        m_in.resize((base + frames) * m_channels);
+        m_mono.resize(base + frames);
+        float* dst = m_in.data() + qsizetype(base) * m_channels;
+        float* mono = m_mono.data() + base;
+        const int samples = frames * m_channels;
+        for (int i = 0; i < samples; ++i) dst[i] = float(in[i]) * kFromS16;
+        for (int f = 0; f < frames; ++f) {
+            float sum = 0.0f;
+            for (int c = 0; c < m_channels; ++c) sum += dst[f * m_channels + c];
+            mono[f] = sum;
+        }
+        m_inputFramesTotal += frames;
+    }
+
+    int produced = 0;
+    const int hopSamples = m_hop * m_channels;
+    for (;;) {
+        const int available = m_mono.size();
+        const int nominal = int(std::floor(m_analysisPos + 0.5));
+        int segment = nominal;
+        if (!m_hasPrevious) {
+            if (nominal + m_window > available) break;
+        } else {
+            if (nominal + m_search + m_window > available) break;
+            segment = bestOffset(nominal, qMax(0, nominal - m_search), nominal + m_search);
+        }
+
+        // Overlap-add: the first half of this segment completes the previous tail into one
+        // output hop; the second half becomes the next tail.
+        const float* seg = m_in.constData() + qsizetype(segment) * m_channels;
+        const float* hann = m_hann.constData();
+        float* tail = m_overlap.data();
+        const int outBase = out.size();
+        out.resize(outBase + hopSamples * int(sizeof(int16_t)));
+        auto* pcm = reinterpret_cast<int16_t*>(out.data() + outBase);
+        for (int f = 0; f < m_hop; ++f) {
+            for (int c = 0; c < m_channels; ++c) {
+                const int i = f * m_channels + c;
+                const float v = qBound(-1.0f, tail[i] + hann[f] * seg[i], 1.0f) * 32767.0f;
+                pcm[i] = int16_t(v >= 0.0f ? v + 0.5f : v - 0.5f);
+            }
+        }
+        const float* secondHalf = seg + hopSamples;
+        for (int f = 0; f < m_hop; ++f) {
+            for (int c = 0; c < m_channels; ++c) {
+                const int i = f * m_channels + c;
+                tail[i] = hann[m_hop + f] * secondHalf[i];
+            }
+        }
+
+        m_prevSegment = segment;
+        m_hasPrevious = true;
+        m_analysisPos += double(m_hop) * m_rate;
+        m_outputFramesTotal += m_hop;
+        produced += m_hop;
+    }
+    trimConsumedInput();
+    return produced;
+}
@@ -0,0 +1,61 @@
+#ifndef TIMESTRETCHER_H
+#define TIMESTRETCHER_H
+#include <QByteArray>
+#include <QVector>
+#include <cstdint>
+
+// Streaming WSOLA time-stretch for interleaved S16 PCM: changes duration by 1/rate while
+// keeping pitch, so varispeed replay (0.5x slow motion, 2x catch-up) still carries usable
+// audio. Output is produced in fixed 10 ms hops; each hop overlap-adds one Hann-windowed
+// 20 ms input segment whose start is searched within +/-5 ms of the nominal position for
+// the best waveform match (coarse 4-sample grid, then refined). The search cost is fixed per
+// hop regardless of rate or content, so CPU per 10 ms block is bounded. The inner loops are
+// plain contiguous float loops the compiler vectorizes.
+// Not thread-safe; PlaybackWorker owns one on its own thread.
+class TimeStretcher {
+public:
+    static constexpr double kMinRate = 0.25;
+    static constexpr double kMaxRate = 2.0;
+
+    explicit TimeStretcher(int sampleRate = 48000, int channels = 2);
+
+    // Playback rate (media seconds per wall second), clamped to [kMinRate, kMaxRate].
+    // Takes effect at the next hop without resetting the stream.
+    void setRate(double rate);
+    double rate() const { return m_rate; }
+
+    // Drop buffered input and overlap state, e.g. after a seek or a PTS discontinuity.
+    void reset();
+
+    // Feed `frames` interleaved S16 frames and append every completed output hop to `out`.
+    // Returns the number of frames appended. Output trails input by one 20 ms segment.
+    int process(const int16_t* in, int frames, QByteArray& out);
+
+    int hopFrames() const { return m_hop; }
+    int64_t inputFrames() const { return m_inputFramesTotal; }
+    int64_t outputFrames() const { return m_outputFramesTotal; }
+
+private:
+    int bestOffset(int nominal, int lo, int hi) const;
+    double correlation(const float* candidate) const;
+    void trimConsumedInput();
+
+    int m_sampleRate;
+    int m_channels;
+    int m_hop;      // synthesis hop, frames (10 ms)
+    int m_window;   // segment length, frames (2 * hop)
+    int m_search;   // search radius, frames (5 ms)
+    double m_rate = 1.0;
+
+    QVector<float> m_hann;    // periodic Hann, m_window long: 50% overlap sums to 1
+    QVector<float> m_in;      // buffered input, interleaved float
+    QVector<float> m_mono;    // channel sum of m_in, used for matching
+    QVector<float> m_overlap; // tail of the last segment awaiting the next hop, interleaved
+    double m_analysisPos = 0.0; // nominal start of the next segment in m_in frames
+    int m_prevSegment = 0;      // start of the last chosen segment in m_in frames (may be < 0
+                                // once trimmed: only its continuation is kept)
+    bool m_hasPrevious = false;
+    int64_t m_inputFramesTotal = 0;
+    int64_t m_outputFramesTotal = 0;
+};
+#endif
@@ -26,6 +26,12 @@ bool saveBenchmarkResult(const QString& path, const CodecBenchmarkResult& result
     root[QStringLiteral("resolution")] = result.resolution;
     root[QStringLiteral("timestamp")] = result.timestamp;
     root[QStringLiteral("ceilingReached")] = result.ceilingReached;
+    root[QStringLiteral("storageSafeFeeds")] = result.storageSafeFeeds;
+    root[QStringLiteral("storageWriteMBps")] = result.storageWriteMBps;
+    root[QStringLiteral("storageWriteP99Ms")] = result.storageWriteP99Ms;
+    root[QStringLiteral("storageWriteMaxMs")] = result.storageWriteMaxMs;
+    root[QStringLiteral("storageDirectory")] = result.storageDirectory;
+    root[QStringLiteral("threadPlacement")] = result.threadPlacement;
 
     QJsonDocument doc(root);
     QFile file(path);
@@ -81,10 +87,17 @@ bool loadBenchmarkResult(const QString& path, CodecBenchmarkResult& out) {
     out.resolution = root[QStringLiteral("resolution")].toString();
     out.timestamp = root[QStringLiteral("timestamp")].toString();
     out.ceilingReached = root[QStringLiteral("ceilingReached")].toBool();
+    out.storageSafeFeeds = root[QStringLiteral("storageSafeFeeds")].toInt(-1);
+    out.storageWriteMBps = root[QStringLiteral("storageWriteMBps")].toDouble();
+    out.storageWriteP99Ms = root[QStringLiteral("storageWriteP99Ms")].toDouble();
+    out.storageWriteMaxMs = root[QStringLiteral("storageWriteMaxMs")].toDouble();
+    out.storageDirectory = root[QStringLiteral("storageDirectory")].toString();
+    out.threadPlacement = root[QStringLiteral("threadPlacement")].toString();
     return true;
 }
 
 bool benchmarkResultMatches(const CodecBenchmarkResult& cached, const QString& deviceLabel,
-                            const QString& resolution) {
-    return cached.deviceLabel == deviceLabel && cached.resolution == resolution;
+                            const QString& resolution, const QString& threadPlacement) {
+    return cached.deviceLabel == deviceLabel && cached.resolution == resolution &&
+           cached.threadPlacement == threadPlacement;
 }
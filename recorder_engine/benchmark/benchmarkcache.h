@@ -13,9 +13,10 @@ QString benchmarkDeviceLabel();
 bool saveBenchmarkResult(const QString& path, const CodecBenchmarkResult& result);
 bool loadBenchmarkResult(const QString& path, CodecBenchmarkResult& out);
 
-// Returns true iff the cached result's deviceLabel and resolution match the given values.
-// Used to invalidate the cache on device change or resolution change.
+// Returns true iff the cached result's deviceLabel, resolution and thread placement match
+// the given values. Used to invalidate the cache on device, resolution or placement change:
+// feed counts measured on floating threads do not hold once threads are pinned.
 bool benchmarkResultMatches(const CodecBenchmarkResult& cached, const QString& deviceLabel,
-                            const QString& resolution);
+                            const QString& resolution, const QString& threadPlacement = QString());
 
 #endif // OLR_BENCHMARKCACHE_H
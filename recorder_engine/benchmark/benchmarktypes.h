@@ -12,6 +12,8 @@ struct BenchmarkConfig {
     int fps = 30;
     int bitrate = 30'000'000;
     int durationMsPerStep = 3000; // measurement window per ramp step
+    int maxConcurrency = 0;       // ramp steps above this are skipped; 0 = the whole ramp
+    QString outputDirectory;      // recording volume for the storage stage; empty skips it
 };
 
 struct RampStepResult {
@@ -39,6 +41,17 @@ struct CodecBenchmarkResult {
     QString resolution;          // e.g. "1920x1080@30"
     QString timestamp;           // ISO-8601, stamped by the caller
     bool ceilingReached = false; // true if a codec ramp hit N=32 without failing
+    // Storage stage, ramped on the recording volume up to the codec ceiling.
+    // -1 = not measured (no/unwritable output directory, cancelled); 0 = the volume could not
+    // take even one feed with headroom; >0 = safe feed count as far as the disk is concerned
+    int storageSafeFeeds = -1;
+    double storageWriteMBps = 0.0;   // at the largest sustained storage step
+    double storageWriteP99Ms = 0.0;  // write/flush/sync call latency at that step
+    double storageWriteMaxMs = 0.0;
+    QString storageDirectory;        // volume the storage stage measured
+    // ThreadPlacementPlan::describe() the ramps ran under (encode threads pinned like
+    // source encoders, the storage writer like the muxer); empty = threads floated.
+    QString threadPlacement;
 };
 
 #endif // OLR_BENCHMARKTYPES_H
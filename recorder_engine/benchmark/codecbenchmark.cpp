@@ -12,6 +12,7 @@ CodecBenchmark::CodecResult CodecBenchmark::rampCodec(CodecRunner& runner,
     for (int i = 0; i < steps.size(); ++i) {
         if (cancel.load(std::memory_order_acquire)) break;
         const int n = steps[i];
+        if (config.maxConcurrency > 0 && n > config.maxConcurrency) break;
         RampStepResult r = runner.runStep(n, config, cancel);
         out.steps.append(r);
         const bool sustained = rampStepSustained(r);
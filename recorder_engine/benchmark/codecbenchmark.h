@@ -19,7 +19,8 @@ public:
         QVector<RampStepResult> steps;
     };
     // Walk the ramp on the CALLING thread (the caller is already a worker thread).
-    // Stops at the first non-sustained step, on cancel, or after the last ramp step.
+    // Stops at the first non-sustained step, on cancel, or after the last ramp step (or the
+    // last one within config.maxConcurrency).
     static CodecResult rampCodec(CodecRunner& runner, const BenchmarkConfig& config,
                                  const ProgressFn& onStep, const std::atomic<bool>& cancel);
 };
@@ -4,6 +4,7 @@
 #include "recorder_engine/codec/nativevideoencoder.h"
 #include "recorder_engine/ingest/nativevideodecoder.h"
 #include "recorder_engine/ingest/h26xaccessunit.h"
+#include "recorder_engine/threadplacement.h"
 
 #include <QElapsedTimer>
 
@@ -111,6 +112,9 @@ RampStepResult Mpeg2CodecRunner::runStep(int concurrency, const BenchmarkConfig&
 
     // C1: capture cancel by reference so threads can observe it
     auto threadFn = [&](int idx) {
+        // Feed idx runs where source idx's encoder would, so the ramp measures the
+        // placement recording will use.
+        ThreadPlacement::placeCurrentThread(ThreadRole::Encode, idx);
         // I1: catch all exceptions so no std::terminate on thread exit
         try {
             ThreadResult& res = results[idx];
@@ -302,6 +306,9 @@ RampStepResult H264CodecRunner::runStep(int concurrency, const BenchmarkConfig&
 
     // C1: capture cancel by reference so threads can observe it
     auto threadFn = [&](int idx) {
+        // Feed idx runs where source idx's encoder would, so the ramp measures the
+        // placement recording will use.
+        ThreadPlacement::placeCurrentThread(ThreadRole::Encode, idx);
         // I1: catch all exceptions so no std::terminate on thread exit
         try {
             ThreadResult& res = results[idx];
@@ -8,6 +8,42 @@ bool feedCountExceedsSafe(int configuredFeeds, int safeFeeds) {
     return safeFeeds > 0 && configuredFeeds > safeFeeds;
 }
 
+FeedLimit exceededFeedLimit(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds) {
+    const bool overCodec = feedCountExceedsSafe(configuredFeeds, codecSafeFeeds);
+    const bool overStorage = storageSafeFeeds >= 0 && configuredFeeds > storageSafeFeeds;
+    if (overStorage && (!overCodec || storageSafeFeeds < codecSafeFeeds)) {
+        return FeedLimit::Storage;
+    }
+    return overCodec ? FeedLimit::Codec : FeedLimit::None;
+}
+
+bool feedCountExceedsSafe(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds) {
+    return exceededFeedLimit(configuredFeeds, codecSafeFeeds, storageSafeFeeds) != FeedLimit::None;
+}
+
+QString feedLimitWarning(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds) {
+    switch (exceededFeedLimit(configuredFeeds, codecSafeFeeds, storageSafeFeeds)) {
+    case FeedLimit::Codec:
+        return QStringLiteral("Recording %1 feeds; this device benchmarked %2 as the safe limit "
+                              "for the selected codec — frames may drop.")
+            .arg(configuredFeeds)
+            .arg(codecSafeFeeds);
+    case FeedLimit::Storage:
+        if (storageSafeFeeds == 0) {
+            return QStringLiteral("Recording %1 feeds; the recording volume could not keep up "
+                                  "with a single feed when benchmarked — frames may drop.")
+                .arg(configuredFeeds);
+        }
+        return QStringLiteral("Recording %1 feeds; the recording volume benchmarked %2 as the "
+                              "safe limit (disk throughput, not the codec) — frames may drop.")
+            .arg(configuredFeeds)
+            .arg(storageSafeFeeds);
+    case FeedLimit::None:
+        break;
+    }
+    return QString();
+}
+
 QString recordCodecBlockReason(VideoCodecChoice codec) {
     if (codec == VideoCodecChoice::H264Hardware) {
         return QStringLiteral("H.264 hardware encoding is not available on this device. "
@@ -12,6 +12,20 @@ bool recordCodecUnavailable(VideoCodecChoice codec, bool h264HardwareAvailable);
 // safeFeeds <= 0 means "not benchmarked / unknown" and never warns.
 bool feedCountExceedsSafe(int configuredFeeds, int safeFeeds);
 
+// Which benchmarked limit a configured feed count runs into.
+enum class FeedLimit { None, Codec, Storage };
+
+// The tighter exceeded limit; a tie goes to the codec. codecSafeFeeds follows the
+// feedCountExceedsSafe() rule; storageSafeFeeds < 0 is "not measured", while 0 is a
+// measured volume that could not take a single feed and so warns for any feed count.
+FeedLimit exceededFeedLimit(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds);
+
+// Soft warn against the codec and the recording-volume limits together.
+bool feedCountExceedsSafe(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds);
+
+// Operator-facing warning naming the limit that is exceeded; empty when none is.
+QString feedLimitWarning(int configuredFeeds, int codecSafeFeeds, int storageSafeFeeds);
+
 // Actionable message for the hard-block case.
 QString recordCodecBlockReason(VideoCodecChoice codec);
 
@@ -2,7 +2,9 @@
 #include "recorder_engine/benchmark/benchmarkcache.h"
 #include "recorder_engine/benchmark/benchmarkplan.h"
 #include "recorder_engine/benchmark/realcodecrunners.h"
+#include "recorder_engine/benchmark/storagerunner.h"
 #include "recorder_engine/codec/videocodecchoice.h"
+#include "recorder_engine/threadplacement.h"
 
 CodecBenchmarkResult runCodecBenchmark(const BenchmarkConfig& config,
                                        const CodecBenchmark::ProgressFn& onStep,
@@ -19,6 +21,7 @@ CodecBenchmarkResult runCodecBenchmark(const BenchmarkConfig& config,
 
     // --- H.264 (hardware, only if available) ---
     H264CodecRunner h264Runner;
+    int h264Ceiling = 0;
     result.h264Available = H264CodecRunner::hardwareAvailable();
     if (result.h264Available && h264Runner.available() && !cancel.load()) {
         const CodecBenchmark::CodecResult h264 =
@@ -26,12 +29,33 @@ CodecBenchmarkResult runCodecBenchmark(const BenchmarkConfig& config,
         result.h264SafeFeeds = h264.safeFeeds;
         result.h264EncodeMs = h264.encodeMs;
         result.h264DecodeMs = h264.decodeMs;
+        h264Ceiling = h264.ceiling;
         result.ceilingReached = mpeg2.ceilingReached || h264.ceilingReached;
     } else {
         result.h264SafeFeeds = -1;
         result.ceilingReached = mpeg2.ceilingReached;
     }
 
+    // --- Storage (recording volume, only up to what the codecs can feed it) ---
+    StorageRunner storageRunner(config.outputDirectory);
+    const int codecCeiling = qMax(mpeg2.ceiling, h264Ceiling);
+    if (codecCeiling > 0 && storageRunner.available() && !cancel.load()) {
+        BenchmarkConfig storageConfig = config;
+        storageConfig.maxConcurrency = codecCeiling;
+        const CodecBenchmark::CodecResult storage =
+            CodecBenchmark::rampCodec(storageRunner, storageConfig, onStep, cancel);
+        if (!cancel.load()) {
+            result.storageSafeFeeds = storage.safeFeeds;
+            result.storageDirectory = config.outputDirectory;
+            if (storage.ceiling > 0) {
+                const StorageStepStats stats = storageRunner.stepStats(storage.ceiling);
+                result.storageWriteMBps = stats.writeMBps;
+                result.storageWriteP99Ms = stats.writeP99Ms;
+                result.storageWriteMaxMs = stats.writeMaxMs;
+            }
+        }
+    }
+
     // --- Recommendation ---
     result.recommended =
         recommendCodec(result.h264Available, result.h264SafeFeeds, result.mpeg2SafeFeeds);
@@ -41,6 +65,7 @@ CodecBenchmarkResult runCodecBenchmark(const BenchmarkConfig& config,
     result.resolution = QString::number(config.width) + QStringLiteral("x") +
                         QString::number(config.height) + QStringLiteral("@") +
                         QString::number(config.fps);
+    result.threadPlacement = ThreadPlacement::plan().describe();
 
     return result;
 }
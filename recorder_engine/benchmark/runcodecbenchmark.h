@@ -7,7 +7,8 @@
 #include <atomic>
 
 // Top-level blocking benchmark entry point. Meant to be called on a worker thread.
-// Constructs real runners, runs rampCodec for each codec, and assembles a full
+// Constructs real runners, runs rampCodec for each codec and then for the storage stage on
+// config.outputDirectory (capped at the codec ceiling), and assembles a full
 // CodecBenchmarkResult. The caller is responsible for stamping result.timestamp.
 CodecBenchmarkResult runCodecBenchmark(const BenchmarkConfig& config,
                                        const CodecBenchmark::ProgressFn& onStep,
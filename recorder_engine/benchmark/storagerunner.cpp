@@ -0,0 +1,188 @@
+#include "recorder_engine/benchmark/storagerunner.h"
+
+#include "playback/output/latencyhistogram.h"
+#include "recorder_engine/threadplacement.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr int kAudioBytesPerSecond = 48000 * 2 * 2; // 48 kHz stereo S16, as the Muxer writes
+constexpr int kMetadataPacketBytes = 64;            // per-frame source metadata subtitle
+constexpr int kPacketsPerFeedFrame = 3;             // video + audio + metadata
+constexpr qint64 kMuxerMaxQueued = 4096;            // Muxer::kMaxQueued
+constexpr qsizetype kAvioBufferBytes = 32 * 1024;   // FFmpeg's file protocol buffer
+constexpr int kFlushIntervalMs = 100;               // Muxer::writerLoop flush cadence
+constexpr double kHeadroomProven = 1.25;            // stop writing past 120% with margin
+constexpr qint64 kReadChunkBytes = 1024 * 1024;
+
+bool syncToDisk(QFile& file) {
+#ifdef _WIN32
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+// Re-reads the growing scratch file from where it left off, idling one flush interval at
+// the live edge — the disk side of a chase-play reader.
+void chaseReader(const QString& path, const std::atomic<bool>& done, qint64& bytesRead) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return;
+    }
+    QByteArray chunk(kReadChunkBytes, Qt::Uninitialized);
+    while (!done.load(std::memory_order_acquire)) {
+        const qint64 got = file.read(chunk.data(), chunk.size());
+        if (got > 0) {
+            bytesRead += got;
+            continue;
+        }
+        QThread::msleep(kFlushIntervalMs);
+    }
+}
+
+} // namespace
+
+StorageRunner::StorageRunner(const QString& directory) : m_directory(directory) {}
+
+bool StorageRunner::available() const {
+    if (m_directory.isEmpty()) {
+        return false;
+    }
+    const QFileInfo info(m_directory);
+    return info.isDir() && info.isWritable();
+}
+
+qint64 StorageRunner::bytesPerFeedPerSecond(const BenchmarkConfig& config) {
+    return qint64(config.bitrate) / 8 + kAudioBytesPerSecond +
+           qint64(kMetadataPacketBytes) * config.fps;
+}
+
+qint64 StorageRunner::queueAbsorbMs(int feeds, int fps) {
+    const qint64 packetsPerSecond = qint64(qMax(feeds, 1)) * qMax(fps, 1) * kPacketsPerFeedFrame;
+    return kMuxerMaxQueued * 1000 / packetsPerSecond;
+}
+
+RampStepResult StorageRunner::runStep(int concurrency, const BenchmarkConfig& cfg,
+                                      const std::atomic<bool>& cancel) {
+    // The writes stand in for the muxer writer; the ramp borrows the benchmark's thread.
+    ScopedThreadPlacement placement(ThreadRole::Mux);
+    RampStepResult r;
+    r.concurrency = concurrency;
+    r.framesRequired = int64_t(concurrency) * cfg.fps * cfg.durationMsPerStep / 1000;
+
+    const QString path = QDir(m_directory).filePath(
+        QStringLiteral(".olr-storage-benchmark-%1.mkv").arg(QCoreApplication::applicationPid()));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        r.startupFailed = true;
+        r.budgetMet = false;
+        return r;
+    }
+
+    // Payloads are never inspected; distinct fill bytes keep compressing filesystems
+    // from collapsing them.
+    std::vector<char> video(size_t(qMax<qint64>(qint64(cfg.bitrate) / 8 / cfg.fps, 1)), '\x5a');
+    std::vector<char> audio(size_t(qMax(kAudioBytesPerSecond / cfg.fps, 1)), '\x21');
+    std::vector<char> metadata(kMetadataPacketBytes, '\x7e');
+    for (size_t i = 0; i < video.size(); i += 4096) video[i] = char(i >> 12);
+
+    LatencyHistogram callNs;
+    std::vector<char> buffer(size_t(kAvioBufferBytes));
+    qsizetype pending = 0;
+    qint64 bytesWritten = 0;
+    bool ok = true;
+    auto timed = [&callNs](auto&& call) {
+        QElapsedTimer t;
+        t.start();
+        const bool result = call();
+        callNs.record(t.nsecsElapsed());
+        return result;
+    };
+    // avio_flush: hand the buffered bytes to the OS.
+    auto drain = [&]() {
+        if (pending == 0) return true;
+        const qsizetype n = pending;
+        pending = 0;
+        bytesWritten += n;
+        return timed([&]() { return file.write(buffer.data(), n) == n; });
+    };
+    // avio_write: fill the buffer, drain it whenever it is full.
+    auto put = [&](const std::vector<char>& packet) {
+        const char* data = packet.data();
+        qsizetype left = qsizetype(packet.size());
+        while (left > 0) {
+            const qsizetype take = std::min(left, kAvioBufferBytes - pending);
+            std::memcpy(buffer.data() + pending, data, size_t(take));
+            pending += take;
+            data += take;
+            left -= take;
+            if (pending == kAvioBufferBytes && !drain()) return false;
+        }
+        return true;
+    };
+
+    std::atomic<bool> readerDone{false};
+    qint64 bytesRead = 0;
+    std::thread reader(chaseReader, path, std::cref(readerDone), std::ref(bytesRead));
+
+    const int64_t stopAt = int64_t(double(r.framesRequired) * kHeadroomProven) + 1;
+    int64_t frames = 0;
+    QElapsedTimer wall;
+    wall.start();
+    qint64 lastFlushMs = 0;
+    while (ok && frames < stopAt && wall.elapsed() < cfg.durationMsPerStep &&
+           !cancel.load(std::memory_order_acquire)) {
+        for (int feed = 0; feed < concurrency && ok; ++feed) {
+            ok = put(video) && put(audio) && put(metadata);
+        }
+        ++frames;
+        if (ok && wall.elapsed() - lastFlushMs >= kFlushIntervalMs) {
+            ok = drain();
+            lastFlushMs = wall.elapsed();
+        }
+        if (ok && frames % cfg.fps == 0) {
+            ok = drain() && timed([&]() { return syncToDisk(file); });
+        }
+    }
+    if (ok) {
+        ok = drain() && timed([&]() { return syncToDisk(file); });
+    }
+    const qint64 elapsedMs = qMax<qint64>(wall.elapsed(), 1);
+
+    readerDone.store(true, std::memory_order_release);
+    reader.join();
+    file.close();
+    QFile::remove(path);
+
+    StorageStepStats stats;
+    stats.writeMBps = double(bytesWritten) / 1e6 * 1000.0 / double(elapsedMs);
+    stats.writeP99Ms = double(callNs.percentile(0.99)) / 1e6;
+    stats.writeMaxMs = double(callNs.max()) / 1e6;
+    stats.bytesRead = bytesRead;
+    m_stats.insert(concurrency, stats);
+
+    // A step cut short by the headroom cap still reports against the full window.
+    r.framesProcessed = int(frames);
+    r.budgetMet = ok && stats.writeMaxMs <= double(queueAbsorbMs(concurrency, cfg.fps));
+    return r;
+}
@@ -0,0 +1,51 @@
+#ifndef OLR_STORAGERUNNER_H
+#define OLR_STORAGERUNNER_H
+
+#include "recorder_engine/benchmark/codecrunner.h"
+
+#include <QMap>
+#include <QString>
+
+// Detail the ramp's RampStepResult has no room for, kept per concurrency.
+struct StorageStepStats {
+    double writeMBps = 0.0;  // bytes written (incl. syncs) / wall time of the step
+    double writeP99Ms = 0.0; // write/flush/sync call latency tail
+    double writeMaxMs = 0.0;
+    qint64 bytesRead = 0;    // what the chase reader pulled back while the step ran
+};
+
+// Recording-volume stage of the benchmark ramp. A step at N writes N feeds' worth of
+// Muxer-shaped traffic into a scratch file in the output directory as fast as the volume
+// takes it: per frame, one video packet (bitrate/fps), the paired PCM track and a metadata
+// packet per feed, through a 32 KiB AVIO-sized buffer that is drained at least every
+// 100 ms (the Muxer's flush cadence), while a second thread chases the growing file the
+// way chase-play does. The Muxer never syncs, but a step lasts seconds and the page cache
+// would absorb all of it; syncing after every second of recorded media charges the volume
+// for what a long recording eventually has to write.
+//
+// framesProcessed counts frame groups (one frame for every feed) written in the window, so
+// rampStepSustained/HasHeadroom read as for the codec runners. A step stops writing once it
+// has proven headroom, which bounds the scratch file. budgetMet fails on any write error or
+// on a single call stalling longer than the Muxer queue can absorb at N feeds.
+class StorageRunner : public CodecRunner {
+public:
+    explicit StorageRunner(const QString& directory);
+    // The directory exists and is writable.
+    bool available() const override;
+    RampStepResult runStep(int concurrency, const BenchmarkConfig& config,
+                           const std::atomic<bool>& cancel) override;
+    StorageStepStats stepStats(int concurrency) const { return m_stats.value(concurrency); }
+
+    // Bytes one feed puts on disk per second: video at config.bitrate, the 48 kHz stereo
+    // S16 track the Muxer pairs with every video track, and the per-frame metadata packet.
+    static qint64 bytesPerFeedPerSecond(const BenchmarkConfig& config);
+    // How long a stalled write can last at N feeds before the Muxer's bounded packet queue
+    // fills and the encoders block (video, audio and metadata packet per feed per frame).
+    static qint64 queueAbsorbMs(int feeds, int fps);
+
+private:
+    QString m_directory;
+    QMap<int, StorageStepStats> m_stats;
+};
+
+#endif // OLR_STORAGERUNNER_H
@@ -14,6 +14,9 @@ IngestBackendKind selectIngestBackend(const QUrl& url, const IngestBackendOption
     if (options.preferNativeNdi && scheme == QStringLiteral("ndi")) {
         return IngestBackendKind::NativeNdi;
     }
+    if (options.preferSynthetic && scheme == QStringLiteral("synthetic")) {
+        return IngestBackendKind::Synthetic;
+    }
     return IngestBackendKind::Unsupported;
 }
 
@@ -68,5 +71,6 @@ IngestBackendOptions ingestBackendOptionsFromEnvironment(const QUrl& url, bool n
     options.preferNativeRtmp = nativeRtmpAvailable && (scheme == QStringLiteral("rtmp") ||
                                                        scheme == QStringLiteral("rtmps"));
     options.preferNativeNdi = nativeNdiAvailable && scheme == QStringLiteral("ndi");
+    options.preferSynthetic = scheme == QStringLiteral("synthetic");
     return options;
 }
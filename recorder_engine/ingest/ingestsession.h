@@ -13,7 +13,7 @@ extern "C" {
 struct AVFrame;
 }
 
-enum class IngestBackendKind { NativeSrt, NativeRtmp, NativeNdi, Unsupported };
+enum class IngestBackendKind { NativeSrt, NativeRtmp, NativeNdi, Synthetic, Unsupported };
 
 enum class IngestFailureKind {
     None,
@@ -33,12 +33,16 @@ struct IngestBackendOptions {
     bool preferNativeSrt = false;
     bool preferNativeRtmp = false;
     bool preferNativeNdi = false;
+    bool preferSynthetic = false; // synthetic:// test-pattern source (benchmarks, soaks)
 };
 
 struct DecodedVideoFrame {
     AVFrame* frame = nullptr;
     int64_t sourcePtsMs = 0;
     int64_t sourceTimecode100ns = -1;
+    // PipelineTrace::nowNs() when the transport delivered the bytes that completed this
+    // frame (srt_recv, the RTMP socket read, the NDI capture), or 0 when unknown.
+    qint64 arrivalNs = 0;
 };
 
 struct DecodedAudioChunk {
@@ -80,6 +84,13 @@ struct IngestStats {
     int64_t interCamPhaseMs = 0; // measured phase to the reference, ms (signed; late=positive)
     int interCamBoundMs = 0;     // +/-ms bound on interCamPhaseMs (0 for FrameAccurate)
     bool isReference = false;    // this source is the session reference (its phase is 0)
+    // Glass-to-disk latency of this source's recorded frames (arrival -> written to the
+    // file) over the current recording, stamped by ReplayManager from the muxer the same
+    // way; glassToDiskFrames == 0 while nothing has been recorded.
+    qint64 glassToDiskFrames = 0;
+    int64_t glassToDiskP50Ms = 0;
+    int64_t glassToDiskP99Ms = 0;
+    int64_t glassToDiskMaxMs = 0;
 };
 
 // Per-source link health -> the connection dot: Green=healthy, Amber=stressed, Red=losing content.
@@ -126,6 +137,7 @@ public:
 };
 
 IngestBackendKind selectIngestBackend(const QUrl& url, const IngestBackendOptions& options);
+// synthetic:// needs no runtime and is always preferred for its scheme.
 IngestBackendOptions ingestBackendOptionsFromEnvironment(const QUrl& url, bool nativeSrtAvailable,
                                                          bool nativeRtmpAvailable,
                                                          bool nativeNdiAvailable = false);
@@ -1,4 +1,5 @@
 #include "nativendiingestsession.h"
+#include "recorder_engine/pipelinetrace.h"
 
 #include <QByteArray>
 #include <QDir>
@@ -439,6 +440,7 @@ void NativeNdiIngestSession::run() {
             m_backend->capture(&video, &audio, kCaptureTimeoutMs);
         if (result == INdiReceiverBackend::Capture::Video) {
             m_lastFrameAtMs = m_monotonic.elapsed();
+            const qint64 arrivalNs = PipelineTrace::nowNs();
             AVFrame* frame = ndiVideoToYuv420p(video, m_outputWidth, m_outputHeight, &m_sws);
             const int64_t sourcePtsMs =
                 mapTimestampMs(video.timestamp100ns, ClockObservationRole::Authority);
@@ -449,6 +451,7 @@ void NativeNdiIngestSession::run() {
                 decoded.sourcePtsMs = sourcePtsMs;
                 decoded.sourceTimecode100ns =
                     video.timecode100ns == kNdiTimecodeSynthesize ? -1 : video.timecode100ns;
+                decoded.arrivalNs = arrivalNs;
                 m_callbacks.onVideoFrame(decoded);
             } else if (frame) {
                 av_frame_free(&frame);
@@ -1,4 +1,5 @@
 #include "nativertmpingestsession.h"
+#include "recorder_engine/pipelinetrace.h"
 
 #include <QAbstractSocket>
 #include <QDateTime>
@@ -653,6 +654,7 @@ bool NativeRtmpIngestSession::readMessage(RtmpMessage* message, QString* error)
             continue;
         }
         m_lastPacketAtMs = m_monotonic.elapsed();
+        m_lastReadNs = PipelineTrace::nowNs();
         if (!acknowledgeIncomingBytes(bytes.size(), error)) {
             return false;
         }
@@ -1069,10 +1071,11 @@ void NativeRtmpIngestSession::processVideoMessage(qint64 timestampMs, const QByt
     // THIS access unit's TC even if m_pendingVideoTimecode100ns is overwritten by a
     // later AU before the callback fires.
     const int64_t timecode100ns = m_pendingVideoTimecode100ns;
+    const qint64 arrivalNs = m_lastReadNs;
     QString error;
     const bool decoded = m_videoDecoder->decode(
         unit,
-        [this, sourcePtsMs, timecode100ns](AVFrame* frame) {
+        [this, sourcePtsMs, timecode100ns, arrivalNs](AVFrame* frame) {
             if (!frame) return;
             if (!m_callbacks.onVideoFrame) {
                 av_frame_free(&frame);
@@ -1082,6 +1085,7 @@ void NativeRtmpIngestSession::processVideoMessage(qint64 timestampMs, const QByt
             decodedFrame.frame = frame;
             decodedFrame.sourcePtsMs = sourcePtsMs;
             decodedFrame.sourceTimecode100ns = timecode100ns;
+            decodedFrame.arrivalNs = arrivalNs;
             m_callbacks.onVideoFrame(decodedFrame);
         },
         &error);
@@ -78,6 +78,9 @@ private:
     int64_t m_amfTimecode100ns = -1;
     int64_t m_prevAudioPtsMs = -1;
     int64_t m_lastPacketAtMs = -1;
+    // PipelineTrace::nowNs() of the socket read that completed the messages being
+    // processed; the arrival stamp of their video frames.
+    qint64 m_lastReadNs = 0;
     int64_t m_lastKeyframeAtMs = -1;
     int64_t m_lastStatsAtMs = -1;
     quint64 m_decodeFailures = 0;
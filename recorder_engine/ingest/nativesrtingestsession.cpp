@@ -3,6 +3,7 @@
 #include "nativesrtaddress.h"
 #include "nativesrtconnectdiagnostics.h"
 #include "nativesrturloptions.h"
+#include "recorder_engine/pipelinetrace.h"
 
 #include <QDebug>
 #include <QThread>
@@ -291,6 +292,7 @@ void NativeSrtIngestSession::run() {
         const int received = srt_recv(m_socket, buffer.data(), int(buffer.size()));
         if (received > 0) {
             m_lastPacketAtMs = m_monotonic.elapsed();
+            m_lastRecvNs = PipelineTrace::nowNs();
             processReceivedBytes(buffer.constData(), received);
             // Snapshot SRT receiver stats ~1x/s while receiving. The socket is
             // closed only after this loop returns (the session is torn down on
@@ -789,10 +791,11 @@ void NativeSrtIngestSession::processPesPacket(const PesPacket& pes) {
         }
 
         const int64_t timecode100ns = m_pendingVideoTimecode100ns;
+        const qint64 arrivalNs = m_lastRecvNs;
         QString error;
         const bool decoded = m_decoder->decode(
             unit,
-            [this, sourcePtsMs, timecode100ns](AVFrame* frame) {
+            [this, sourcePtsMs, timecode100ns, arrivalNs](AVFrame* frame) {
                 if (!frame) {
                     return;
                 }
@@ -806,6 +809,7 @@ void NativeSrtIngestSession::processPesPacket(const PesPacket& pes) {
                 const int64_t decodedPtsMs = m_clock->toSessionMs(frame->pts);
                 decodedFrame.sourcePtsMs = decodedPtsMs >= 0 ? decodedPtsMs : sourcePtsMs;
                 decodedFrame.sourceTimecode100ns = timecode100ns;
+                decodedFrame.arrivalNs = arrivalNs;
                 m_callbacks.onVideoFrame(decodedFrame);
             },
             &error);
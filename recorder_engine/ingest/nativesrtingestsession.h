@@ -122,6 +122,9 @@ private:
     // frame without a TC SEI never inherits a previous frame's timecode.
     int64_t m_pendingVideoTimecode100ns = -1;
     int64_t m_lastPacketAtMs = -1;
+    // PipelineTrace::nowNs() of the srt_recv being parsed; the arrival stamp of any
+    // access unit it completes.
+    qint64 m_lastRecvNs = 0;
     int64_t m_lastDecodeErrorLogMs = -1;
     bool m_loggedLatmUnsupported = false;
 
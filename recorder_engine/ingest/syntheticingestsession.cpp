@@ -0,0 +1,209 @@
+#include "syntheticingestsession.h"
+
+#include "recorder_engine/benchmark/syntheticframes.h"
+#include "recorder_engine/pipelinetrace.h"
+
+#include <QThread>
+#include <QUrlQuery>
+
+#include <cmath>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kAudioSampleRate = 48000;
+constexpr int kToneHz = 1000;
+constexpr int kToneAmplitude = 3000; // ~-21 dBFS
+constexpr int kMaxSleepUs = 20000;   // stop-flag responsiveness while pacing
+
+} // namespace
+
+SyntheticIngestSession::SyntheticIngestSession(int sourceIndex, int outputWidth, int outputHeight,
+                                               std::atomic<bool>* captureRunning)
+    : m_sourceIndex(sourceIndex), m_outputWidth(outputWidth), m_outputHeight(outputHeight),
+      m_captureRunning(captureRunning) {}
+
+SyntheticIngestSession::~SyntheticIngestSession() {
+    freePool();
+}
+
+bool SyntheticIngestSession::supportsUrl(const QUrl& url) {
+    return url.scheme().toLower() == QStringLiteral("synthetic");
+}
+
+int SyntheticIngestSession::fpsFromUrl(const QUrl& url) {
+    bool ok = false;
+    const int fps = QUrlQuery(url).queryItemValue(QStringLiteral("fps")).toInt(&ok);
+    return ok && fps > 0 ? qMin(fps, 240) : kDefaultFps;
+}
+
+bool SyntheticIngestSession::open(const QUrl& url, const IngestCallbacks& callbacks) {
+    m_callbacks = callbacks;
+    m_stopRequested.store(false, std::memory_order_relaxed);
+    if (!supportsUrl(url)) {
+        return false;
+    }
+    m_fps = fpsFromUrl(url);
+    m_audio = QUrlQuery(url).queryItemValue(QStringLiteral("audio")) != QStringLiteral("0");
+
+    freePool();
+    // Offset the pattern per source so views are told apart in the recording.
+    for (int i = 0; i < kFramePoolSize; ++i) {
+        AVFrame* frame =
+            makeSyntheticFrame(m_outputWidth, m_outputHeight, m_sourceIndex * 37 + i * 3);
+        if (!frame) {
+            freePool();
+            return false;
+        }
+        m_pool.push_back(frame);
+    }
+
+    m_framesDelivered.store(0, std::memory_order_relaxed);
+    m_framesDropped.store(0, std::memory_order_relaxed);
+    m_bytesTotal = 0;
+    m_audioSamplesSent = 0;
+    m_audioStartSample = -1;
+    m_lastStatsAtMs = -1;
+    m_monotonic.start();
+    if (m_callbacks.logInfo) {
+        m_callbacks.logInfo(QStringLiteral("Synthetic source %1: %2x%3 @ %4 fps%5")
+                                .arg(m_sourceIndex)
+                                .arg(m_outputWidth)
+                                .arg(m_outputHeight)
+                                .arg(m_fps)
+                                .arg(m_audio ? QStringLiteral(" + tone") : QString()));
+    }
+    if (m_callbacks.setConnected) {
+        m_callbacks.setConnected(true);
+    }
+    return true;
+}
+
+void SyntheticIngestSession::run() {
+    const qint64 periodNs = 1'000'000'000LL / m_fps;
+    const qint64 startNs = m_monotonic.nsecsElapsed();
+    int64_t seq = 0;
+    while (!shouldStop()) {
+        const qint64 deadlineNs = startNs + seq * periodNs;
+        const qint64 nowNs = m_monotonic.nsecsElapsed();
+        if (nowNs < deadlineNs) {
+            QThread::usleep(
+                static_cast<unsigned long>(qMin<qint64>((deadlineNs - nowNs) / 1000, kMaxSleepUs)));
+            continue;
+        }
+        // More than a period late: skip to the frame that is due now instead of
+        // bursting the backlog (a live camera does not wait for us).
+        const int64_t due = (nowNs - startNs) / periodNs;
+        if (due > seq) {
+            m_framesDropped.fetch_add(due - seq, std::memory_order_relaxed);
+            seq = due;
+        }
+        deliverVideo(seq);
+        if (m_audio) {
+            deliverAudioUpTo(m_monotonic.elapsed());
+        }
+        maybeReportStats();
+        ++seq;
+    }
+}
+
+void SyntheticIngestSession::requestStop() {
+    m_stopRequested.store(true, std::memory_order_relaxed);
+}
+
+bool SyntheticIngestSession::shouldStop() const {
+    if (m_stopRequested.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (m_captureRunning && !m_captureRunning->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    return m_callbacks.shouldStop ? m_callbacks.shouldStop() : false;
+}
+
+void SyntheticIngestSession::freePool() {
+    for (AVFrame*& frame : m_pool) {
+        av_frame_free(&frame);
+    }
+    m_pool.clear();
+}
+
+void SyntheticIngestSession::deliverVideo(int64_t seq) {
+    const int64_t ptsMs = m_callbacks.recordingClockMs ? m_callbacks.recordingClockMs() : -1;
+    if (ptsMs < 0 || !m_callbacks.onVideoFrame || m_pool.empty()) {
+        return;
+    }
+    const qint64 arrivalNs = PipelineTrace::nowNs();
+    const AVFrame* src = m_pool[static_cast<size_t>(seq % int64_t(m_pool.size()))];
+    AVFrame* frame = av_frame_alloc();
+    if (!frame) {
+        return;
+    }
+    frame->format = src->format;
+    frame->width = src->width;
+    frame->height = src->height;
+    if (av_frame_get_buffer(frame, 0) < 0 || av_frame_copy(frame, src) < 0) {
+        av_frame_free(&frame);
+        return;
+    }
+    DecodedVideoFrame decoded;
+    decoded.frame = frame;
+    decoded.sourcePtsMs = ptsMs;
+    decoded.arrivalNs = arrivalNs;
+    m_bytesTotal += quint64(frame->width) * quint64(frame->height) * 3 / 2;
+    m_framesDelivered.fetch_add(1, std::memory_order_relaxed);
+    m_callbacks.onVideoFrame(decoded);
+}
+
+void SyntheticIngestSession::deliverAudioUpTo(int64_t elapsedMs) {
+    if (!m_callbacks.onAudioChunk) {
+        return;
+    }
+    if (m_audioStartSample < 0) {
+        const int64_t nowMs = m_callbacks.recordingClockMs ? m_callbacks.recordingClockMs() : -1;
+        if (nowMs < 0) {
+            return;
+        }
+        // Sample 0 of the tone lands at the recording-clock instant of elapsedMs 0.
+        m_audioStartSample = (nowMs - elapsedMs) * kAudioSampleRate / 1000;
+    }
+    const int64_t target = elapsedMs * kAudioSampleRate / 1000;
+    const int count = static_cast<int>(target - m_audioSamplesSent);
+    if (count <= 0) {
+        return;
+    }
+    DecodedAudioChunk chunk;
+    chunk.startSample = m_audioStartSample + m_audioSamplesSent;
+    chunk.pcmS16Stereo.resize(qsizetype(count) * kDecodedAudioBytesPerSample);
+    auto* out = reinterpret_cast<int16_t*>(chunk.pcmS16Stereo.data());
+    for (int i = 0; i < count; ++i) {
+        const int64_t n = m_audioSamplesSent + i;
+        const double phase = 2.0 * kPi * double(n % kAudioSampleRate) * kToneHz / kAudioSampleRate;
+        const auto v = static_cast<int16_t>(std::lround(kToneAmplitude * std::sin(phase)));
+        out[2 * i] = v;
+        out[2 * i + 1] = v;
+    }
+    m_audioSamplesSent = target;
+    m_bytesTotal += quint64(chunk.pcmS16Stereo.size());
+    m_callbacks.onAudioChunk(std::move(chunk));
+}
+
+void SyntheticIngestSession::maybeReportStats() {
+    if (!m_callbacks.reportStats) {
+        return;
+    }
+    const int64_t now = m_monotonic.elapsed();
+    if (m_lastStatsAtMs >= 0 && now - m_lastStatsAtMs < 1000) {
+        return;
+    }
+    m_lastStatsAtMs = now;
+    IngestStats stats;
+    stats.recvTotal = m_framesDelivered.load(std::memory_order_relaxed);
+    stats.dropTotal = m_framesDropped.load(std::memory_order_relaxed);
+    stats.bytesTotal = m_bytesTotal;
+    m_callbacks.reportStats(stats);
+}
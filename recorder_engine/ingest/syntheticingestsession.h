@@ -0,0 +1,68 @@
+#ifndef SYNTHETICINGESTSESSION_H
+#define SYNTHETICINGESTSESSION_H
+
+#include "ingestsession.h"
+
+#include <QElapsedTimer>
+#include <QUrl>
+
+#include <atomic>
+#include <vector>
+
+// Camera-less source for benchmarks and soak runs: synthetic://<name>[?fps=N&audio=0|1]
+// produces makeSyntheticFrame() pictures at the session's output size, paced to absolute
+// wall-clock deadlines at fps (default 30) and stamped with the recording clock the way an
+// arrival-clocked source is, plus a 1 kHz stereo tone as 48 kHz PCM (audio=0 disables it).
+// A small pool of distinct frames is rendered at open(); every delivered frame is a fresh
+// copy the receiver owns, so the cost per frame is one picture copy, like a decoder output.
+//
+// When the capture thread falls more than one frame period behind (the host cannot keep
+// up), the missed frames are skipped, not bursted, and counted as drops. reportStats()
+// fills the SRT loss-domain counters ~1/sec: recvTotal = frames delivered, dropTotal =
+// frames skipped, bytesTotal = picture + PCM bytes.
+class SyntheticIngestSession final : public IngestSession {
+public:
+    static constexpr int kDefaultFps = 30;
+    static constexpr int kFramePoolSize = 16;
+
+    SyntheticIngestSession(int sourceIndex, int outputWidth, int outputHeight,
+                           std::atomic<bool>* captureRunning);
+    ~SyntheticIngestSession() override;
+
+    static bool supportsUrl(const QUrl& url);
+    // fps query parameter clamped to 1..240; kDefaultFps when absent or malformed.
+    static int fpsFromUrl(const QUrl& url);
+
+    bool open(const QUrl& url, const IngestCallbacks& callbacks) override;
+    void run() override;
+    void requestStop() override;
+
+    qint64 framesDelivered() const { return m_framesDelivered.load(std::memory_order_relaxed); }
+    qint64 framesDropped() const { return m_framesDropped.load(std::memory_order_relaxed); }
+
+private:
+    int m_sourceIndex = 0;
+    int m_outputWidth = 1920;
+    int m_outputHeight = 1080;
+    int m_fps = kDefaultFps;
+    bool m_audio = true;
+    std::atomic<bool>* m_captureRunning = nullptr;
+    std::atomic<bool> m_stopRequested{false};
+    IngestCallbacks m_callbacks;
+    std::vector<AVFrame*> m_pool;
+    QElapsedTimer m_monotonic;
+    int64_t m_lastStatsAtMs = -1;
+    int64_t m_audioSamplesSent = 0;
+    int64_t m_audioStartSample = -1;
+    std::atomic<qint64> m_framesDelivered{0};
+    std::atomic<qint64> m_framesDropped{0};
+    quint64 m_bytesTotal = 0;
+
+    bool shouldStop() const;
+    void freePool();
+    void deliverVideo(int64_t seq);
+    void deliverAudioUpTo(int64_t elapsedMs);
+    void maybeReportStats();
+};
+
+#endif // SYNTHETICINGESTSESSION_H
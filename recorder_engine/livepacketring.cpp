@@ -0,0 +1,163 @@
+#include "livepacketring.h"
+
+#include <QDir>
+#include <QHash>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+namespace {
+// Per-packet bookkeeping charged against the byte budget on top of the payload
+// (AVPacket + AVBufferRef + deque slot), so a flood of tiny metadata/audio
+// packets cannot sneak past maxBytes.
+constexpr qint64 kPacketOverheadBytes = 256;
+
+QMutex g_registryMutex;
+QHash<QString, std::shared_ptr<LivePacketRing>>& registry() {
+    static QHash<QString, std::shared_ptr<LivePacketRing>> rings;
+    return rings;
+}
+
+QString registryKey(const QString& path) { return QDir::cleanPath(path); }
+
+qint64 envOr(const char* name, qint64 fallback) {
+    const QByteArray env = qgetenv(name);
+    if (env.isEmpty()) return fallback;
+    bool ok = false;
+    const qint64 parsed = env.toLongLong(&ok);
+    return (ok && parsed >= 0) ? parsed : fallback;
+}
+} // namespace
+
+LivePacketRing::Limits LivePacketRing::limitsFromEnvironment() {
+    Limits limits;
+    limits.maxBytes = envOr("OLR_LIVE_RING_MB", kDefaultMaxBytes / (1024 * 1024)) * 1024 * 1024;
+    limits.maxSpanMs = envOr("OLR_LIVE_RING_SECONDS", kDefaultMaxSpanMs / 1000) * 1000;
+    return limits;
+}
+
+LivePacketRing::LivePacketRing(Limits limits) : m_limits(limits) {}
+
+LivePacketRing::~LivePacketRing() {
+    for (Entry& e : m_entries) av_packet_free(&e.pkt);
+}
+
+void LivePacketRing::append(const AVPacket* pkt) {
+    if (!pkt || !pkt->data || pkt->size <= 0) return;
+    AVPacket* ref = av_packet_alloc();
+    if (!ref) return;
+    if (av_packet_ref(ref, pkt) < 0) {
+        av_packet_free(&ref);
+        return;
+    }
+    // Ring packets never carry a file position: readers must not mistake them
+    // for demuxed packets (FrameIndex keys off pos >= 0).
+    ref->pos = -1;
+
+    QMutexLocker locker(&m_mutex);
+    const int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+    // A timestamp-less packet inherits the newest PTS so span eviction and the
+    // key index stay monotonic.
+    const qint64 ptsMs =
+        (ts != AV_NOPTS_VALUE) ? qint64(ts) : (m_newestPtsMs != INT64_MIN ? m_newestPtsMs : 0);
+
+    const quint64 seq = m_baseSeq + m_entries.size();
+    Entry entry;
+    entry.pkt = ref;
+    entry.ptsMs = ptsMs;
+    entry.bytes = qint64(pkt->size) + kPacketOverheadBytes;
+    m_entries.push_back(entry);
+    m_bytes += entry.bytes;
+    m_newestPtsMs = std::max(m_newestPtsMs, ptsMs);
+
+    if (pkt->flags & AV_PKT_FLAG_KEY) {
+        std::deque<KeyEntry>& keys = m_keys[pkt->stream_index];
+        // Keep PTS strictly increasing (same rule as FrameIndex).
+        if (keys.empty() || ptsMs > keys.back().ptsMs) keys.push_back(KeyEntry{ptsMs, seq});
+    }
+
+    evictLocked();
+}
+
+void LivePacketRing::evictLocked() {
+    // Never evict the packet just appended: a single over-budget packet still
+    // has to be readable at the live edge.
+    while (m_entries.size() > 1) {
+        const Entry& front = m_entries.front();
+        const bool overBytes = m_bytes > m_limits.maxBytes;
+        const bool overSpan = (m_newestPtsMs - front.ptsMs) > m_limits.maxSpanMs;
+        if (!overBytes && !overSpan) break;
+        m_bytes -= front.bytes;
+        av_packet_free(&m_entries.front().pkt);
+        m_entries.pop_front();
+        ++m_baseSeq;
+    }
+    for (auto& [stream, keys] : m_keys) {
+        Q_UNUSED(stream);
+        while (!keys.empty() && keys.front().seq < m_baseSeq) keys.pop_front();
+    }
+}
+
+std::optional<quint64> LivePacketRing::seekSequence(int refStreamIndex, qint64 anchorMs) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_keys.find(refStreamIndex);
+    if (it == m_keys.end() || it->second.empty()) return std::nullopt;
+    const std::deque<KeyEntry>& keys = it->second;
+    // First key with ptsMs > anchor; the one before it is the answer.
+    auto k = std::upper_bound(keys.begin(), keys.end(), anchorMs,
+                              [](qint64 value, const KeyEntry& e) { return value < e.ptsMs; });
+    if (k == keys.begin()) return std::nullopt; // anchor predates the window
+    --k;
+    return k->seq;
+}
+
+LivePacketRing::ReadResult LivePacketRing::read(quint64 seq, AVPacket* out) const {
+    QMutexLocker locker(&m_mutex);
+    if (seq < m_baseSeq) return ReadResult::Evicted;
+    const quint64 offset = seq - m_baseSeq;
+    if (offset >= m_entries.size()) return ReadResult::LiveEdge;
+    if (av_packet_ref(out, m_entries[offset].pkt) < 0) return ReadResult::Evicted;
+    return ReadResult::Packet;
+}
+
+qint64 LivePacketRing::residentBytes() const {
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+int LivePacketRing::packetCount() const {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_entries.size());
+}
+
+std::optional<qint64> LivePacketRing::oldestPtsMs(int streamIndex) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_keys.find(streamIndex);
+    if (it == m_keys.end() || it->second.empty()) return std::nullopt;
+    return it->second.front().ptsMs;
+}
+
+std::optional<qint64> LivePacketRing::newestPtsMs(int streamIndex) const {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_keys.find(streamIndex);
+    if (it == m_keys.end() || it->second.empty()) return std::nullopt;
+    return it->second.back().ptsMs;
+}
+
+void LivePacketRing::publish(const QString& path, const std::shared_ptr<LivePacketRing>& ring) {
+    if (path.isEmpty() || !ring) return;
+    QMutexLocker locker(&g_registryMutex);
+    registry().insert(registryKey(path), ring);
+}
+
+void LivePacketRing::withdraw(const QString& path, const LivePacketRing* ring) {
+    QMutexLocker locker(&g_registryMutex);
+    auto it = registry().find(registryKey(path));
+    if (it != registry().end() && it.value().get() == ring) registry().erase(it);
+}
+
+std::shared_ptr<LivePacketRing> LivePacketRing::find(const QString& path) {
+    if (path.isEmpty()) return nullptr;
+    QMutexLocker locker(&g_registryMutex);
+    return registry().value(registryKey(path));
+}
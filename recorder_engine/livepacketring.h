@@ -0,0 +1,103 @@
+#ifndef LIVEPACKETRING_H
+#define LIVEPACKETRING_H
+
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+}
+
+// Memory-bounded ring of the most recently muxed COMPRESSED packets (every
+// track), fed by Muxer::writePacket in exactly the order the writer thread will
+// put them on disk. Playback of the live window (instant replay of the last
+// N seconds) reads packets straight from here instead of round-tripping through
+// the page cache / disk while the recorder is still writing that same region.
+//
+// Packets are stored as av_packet_ref()s of the muxer's own clone, so the
+// payload is shared with the writer queue (no extra copy). Timestamps are in the
+// muxer's 1/1000 stream time_base. Every packet gets a monotonically increasing
+// sequence number; readers walk sequences and are told when they fall off the
+// evicted tail so they can fall back to the file.
+//
+// Bounded two ways: total payload bytes and the PTS span between the newest and
+// the oldest resident packet. Thread-safe: many producer threads (every
+// StreamWorker via Muxer::writePacket) and any number of reader threads.
+class LivePacketRing {
+public:
+    struct Limits {
+        qint64 maxBytes = 0;
+        qint64 maxSpanMs = 0;
+    };
+    static constexpr qint64 kDefaultMaxBytes = qint64(1024) * 1024 * 1024; // 1 GiB
+    static constexpr qint64 kDefaultMaxSpanMs = 120000;                    // 2 min
+    // Defaults, overridable with OLR_LIVE_RING_MB / OLR_LIVE_RING_SECONDS. A 0
+    // for either disables the ring (Muxer then never creates one).
+    static Limits limitsFromEnvironment();
+
+    explicit LivePacketRing(Limits limits);
+    ~LivePacketRing();
+
+    LivePacketRing(const LivePacketRing&) = delete;
+    LivePacketRing& operator=(const LivePacketRing&) = delete;
+
+    // Takes a new reference to pkt's payload; the caller keeps its own.
+    void append(const AVPacket* pkt);
+
+    // First sequence to read so that a forward read covers anchorMs on
+    // refStreamIndex: the newest refStreamIndex packet at or before anchorMs,
+    // mirroring av_seek_frame(AVSEEK_FLAG_BACKWARD). nullopt when anchorMs is
+    // older than the resident window (the caller must use the file).
+    std::optional<quint64> seekSequence(int refStreamIndex, qint64 anchorMs) const;
+
+    enum class ReadResult {
+        Packet,   // *out holds a new reference; caller unrefs
+        LiveEdge, // seq is not written yet — retry later
+        Evicted,  // seq fell off the tail — fall back to the file
+    };
+    ReadResult read(quint64 seq, AVPacket* out) const;
+
+    qint64 residentBytes() const;
+    int packetCount() const;
+    std::optional<qint64> oldestPtsMs(int streamIndex) const;
+    std::optional<qint64> newestPtsMs(int streamIndex) const;
+    Limits limits() const { return m_limits; }
+
+    // ─── Process-wide registry keyed by recording path ────────────────────
+    // The muxer publishes its ring under the file it is writing; a playback
+    // worker opening that same path picks it up. withdraw() only removes the
+    // entry if it still points at `ring` (a newer session may have replaced it).
+    static void publish(const QString& path, const std::shared_ptr<LivePacketRing>& ring);
+    static void withdraw(const QString& path, const LivePacketRing* ring);
+    static std::shared_ptr<LivePacketRing> find(const QString& path);
+
+private:
+    struct Entry {
+        AVPacket* pkt = nullptr;
+        qint64 ptsMs = 0;
+        qint64 bytes = 0;
+    };
+    struct KeyEntry {
+        qint64 ptsMs;
+        quint64 seq;
+    };
+    void evictLocked();
+
+    const Limits m_limits;
+    mutable QMutex m_mutex;
+    std::deque<Entry> m_entries;  // m_entries[i] has sequence m_baseSeq + i
+    quint64 m_baseSeq = 0;
+    qint64 m_bytes = 0;
+    qint64 m_newestPtsMs = INT64_MIN; // across all streams
+    // Per-stream keyframe index (PTS increasing), trimmed as entries evict.
+    std::unordered_map<int, std::deque<KeyEntry>> m_keys;
+};
+
+#endif // LIVEPACKETRING_H
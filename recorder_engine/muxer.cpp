@@ -1,10 +1,16 @@
 #include "muxer.h"
+#include "livepacketring.h"
+#include "pipelinetrace.h"
+#include "threadplacement.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QFileInfo>
 #include <QDebug>
 #include <QRegularExpression>
 
+#include <chrono>
+#include <vector>
+
 Muxer::Muxer() {}
 
 Muxer::~Muxer() { close(); }
@@ -18,6 +24,21 @@ bool isWellFormedTimecode(const QString& tc) {
     static const QRegularExpression re(QStringLiteral("^\\d{2}:\\d{2}:\\d{2}[:;]\\d{2}$"));
     return re.match(tc).hasMatch();
 }
+
+void recordSpan(LatencyHistogram& histogram, qint64 fromNs, qint64 toNs) {
+    if (fromNs > 0 && toNs > 0) histogram.record(toNs - fromNs);
+}
+
+void recordCaptureLatency(CaptureLatency& latency, const CaptureFrameStamps& stamps,
+                          qint64 queuedNs, qint64 writtenNs) {
+    recordSpan(latency.arrivalToDecodedNs, stamps.arrivalNs, stamps.decodedNs);
+    recordSpan(latency.decodedToDequeuedNs, stamps.decodedNs, stamps.dequeuedNs);
+    recordSpan(latency.dequeuedToEncodedNs, stamps.dequeuedNs, stamps.encodedNs);
+    recordSpan(latency.encodedToQueuedNs, stamps.encodedNs, queuedNs);
+    recordSpan(latency.queuedToWrittenNs, queuedNs, writtenNs);
+    recordSpan(latency.totalNs, stamps.arrivalNs > 0 ? stamps.arrivalNs : stamps.decodedNs,
+               writtenNs);
+}
 } // namespace
 
 bool Muxer::init(const QString& filename, int videoTrackCount, int width, int height, int fps,
@@ -242,9 +263,21 @@ bool Muxer::init(const QString& filename, int videoTrackCount, int width, int he
     }
     m_fatalWriteError.store(false, std::memory_order_relaxed);
     m_consecutiveWriteErrors = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_statsMutex);
+        m_stats = MuxerWriteStats{};
+    }
 
     m_initialized = true;
 
+    // Live-window packet ring: published BEFORE the first packet can be queued,
+    // so a playback worker opening this path never misses the head of the ring.
+    const LivePacketRing::Limits ringLimits = LivePacketRing::limitsFromEnvironment();
+    if (m_liveRingEnabled && ringLimits.maxBytes > 0 && ringLimits.maxSpanMs > 0) {
+        m_liveRing = std::make_shared<LivePacketRing>(ringLimits);
+        LivePacketRing::publish(m_activePath, m_liveRing);
+    }
+
     // Start the dedicated writer thread. The header has NOT been written yet, but
     // every write path calls ensureHeaderWritten() before enqueuing a packet, so
     // by the time the writer thread pops anything the header is in place. From here
@@ -312,6 +345,10 @@ void Muxer::setStartTimecodeCandidate(const QString& tc) {
 }
 
 void Muxer::writePacket(AVPacket* pkt) {
+    writePacket(pkt, -1, CaptureFrameStamps{});
+}
+
+void Muxer::writePacket(AVPacket* pkt, int sourceIndex, const CaptureFrameStamps& stamps) {
     // ENQUEUE-ONLY. Clone the caller's packet (the caller still owns theirs,
     // exactly as before) and hand the clone to the writer thread, then return
     // immediately. The DTS-bump, av_write_frame and avio_flush all happen on
@@ -328,6 +365,8 @@ void Muxer::writePacket(AVPacket* pkt) {
     if (!localPkt) return;
 
     std::unique_lock<std::mutex> lk(m_qMutex);
+    const bool queueFull = m_pktQueue.size() >= kMaxQueued;
+    const qint64 stallStartNs = queueFull ? PipelineTrace::nowNs() : 0;
     // Backpressure: never drop (dropping corrupts the file) and never grow
     // unbounded. A transient stall is absorbed by the queue; a SUSTAINED
     // disk-too-slow eventually blocks the caller here — unavoidable, the disk
@@ -341,7 +380,22 @@ void Muxer::writePacket(AVPacket* pkt) {
         av_packet_free(&localPkt);
         return;
     }
+    // Shares localPkt's payload (refcounted); appended under m_qMutex so the
+    // ring's order matches the writer's, i.e. the on-disk packet order.
+    if (m_liveRing) m_liveRing->append(localPkt);
+    const qint64 enqueuedNs = PipelineTrace::nowNs();
     m_pktQueue.push(localPkt);
+    m_pktTiming.push({enqueuedNs, stamps.decodedNs > 0 ? sourceIndex : -1, stamps});
+    m_queueDepth.store(qint64(m_pktQueue.size()), std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        ++m_stats.packetsQueued;
+        m_stats.maxQueueDepth = qMax(m_stats.maxQueueDepth, qint64(m_pktQueue.size()));
+        if (queueFull) {
+            ++m_stats.producerStalls;
+            m_stats.producerStallNs += enqueuedNs - stallStartNs;
+        }
+    }
     lk.unlock();
     m_qCv.notify_one();
 }
@@ -362,9 +416,33 @@ void Muxer::recordWriteOutcome(bool failed, const char* errLabel) {
     }
 }
 
+MuxerWriteStats Muxer::writeStats() const {
+    std::lock_guard<std::mutex> lk(m_statsMutex);
+    return m_stats;
+}
+
+CaptureLatency Muxer::captureLatency(int sourceIndex) const {
+    std::lock_guard<std::mutex> lk(m_statsMutex);
+    return m_stats.sourceLatency.value(sourceIndex);
+}
+
 void Muxer::writerLoop() {
+    PipelineTrace::setThreadName(QStringLiteral("muxer writer"));
+    ThreadPlacement::placeCurrentThread(ThreadRole::Mux);
+    // Stamped packets already in the AVIO buffer but not yet flushed to the OS: their
+    // capture latency ends at the flush that covers them, not at av_write_frame.
+    std::vector<QueuedPacketTiming> unflushed;
+    const auto recordFlushed = [this, &unflushed](qint64 flushedNs) { // holds m_statsMutex
+        for (const QueuedPacketTiming& t : unflushed) {
+            recordCaptureLatency(m_stats.sourceLatency[t.sourceIndex], t.stamps, t.enqueuedNs,
+                                 flushedNs);
+        }
+        unflushed.clear();
+    };
     for (;;) {
         AVPacket* pkt = nullptr;
+        QueuedPacketTiming timing;
+        qint64 queueDepth = 0;
         {
             std::unique_lock<std::mutex> lk(m_qMutex);
             // Wait for work, or for shutdown. Keep draining while the queue is
@@ -374,8 +452,17 @@ void Muxer::writerLoop() {
                 return !m_pktQueue.empty() || !m_writerRunning.load(std::memory_order_acquire);
             });
             if (m_pktQueue.empty()) {
-                // Queue drained AND shutdown requested → done.
-                if (!m_writerRunning.load(std::memory_order_acquire)) return;
+                // Queue drained AND shutdown requested → done, once the tail
+                // since the last throttled flush has reached the OS as well.
+                if (!m_writerRunning.load(std::memory_order_acquire)) {
+                    lk.unlock();
+                    if (unflushed.empty()) return;
+                    avio_flush(m_outCtx->pb);
+                    const qint64 flushedNs = PipelineTrace::nowNs();
+                    std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                    recordFlushed(flushedNs);
+                    return;
+                }
                 continue;
             }
             // Hold the first packet(s) while the header write is deferred for the
@@ -392,7 +479,13 @@ void Muxer::writerLoop() {
             }
             pkt = m_pktQueue.front();
             m_pktQueue.pop();
+            timing = m_pktTiming.front();
+            m_pktTiming.pop();
+            queueDepth = qint64(m_pktQueue.size());
+            m_queueDepth.store(queueDepth, std::memory_order_relaxed);
         }
+        const qint64 poppedNs = PipelineTrace::nowNs();
+        PipelineTrace::counter("record", "muxer queue", queueDepth);
         // Notify a possibly back-pressured producer that there is now room.
         m_qCv.notify_one();
 
@@ -403,6 +496,8 @@ void Muxer::writerLoop() {
         if (!ensureHeaderWritten()) {
             av_packet_free(&pkt);
             recordWriteOutcome(true, "avformat_write_header failed");
+            std::lock_guard<std::mutex> statsLock(m_statsMutex);
+            ++m_stats.writeErrors;
             continue;
         }
 
@@ -424,7 +519,12 @@ void Muxer::writerLoop() {
         // independently. av_interleaved_write_frame buffers packets across
         // ALL streams and won't flush stream A until stream B catches up,
         // causing one disrupted source to freeze every other source.
-        const int ret = av_write_frame(m_outCtx, pkt);
+        const int packetBytes = pkt->size;
+        int ret = 0;
+        {
+            PipelineTraceScope trace("record", "write packet", "stream", idx);
+            ret = av_write_frame(m_outCtx, pkt);
+        }
         av_packet_free(&pkt); // av_write_frame does NOT take ownership
 
         if (ret < 0) {
@@ -438,13 +538,29 @@ void Muxer::writerLoop() {
 
         // Flush at most every ~100 ms: keeps the chase-play reader within a
         // cluster of the live edge without a disk flush per packet.
+        bool flushed = false;
         if (!m_lastFlush.isValid() || m_lastFlush.elapsed() >= 100) {
+            PipelineTraceScope trace("record", "flush");
             avio_flush(m_outCtx->pb);
             if (m_outCtx->pb && m_outCtx->pb->error != 0) {
                 recordWriteOutcome(true, "avio flush error");
             }
             m_lastFlush.restart();
+            flushed = true;
         }
+
+        const qint64 writtenNs = PipelineTrace::nowNs();
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        m_stats.queueDwellNs.record(poppedNs - timing.enqueuedNs);
+        m_stats.writeNs.record(writtenNs - poppedNs);
+        if (ret < 0) {
+            ++m_stats.writeErrors;
+        } else {
+            ++m_stats.packetsWritten;
+            m_stats.bytesWritten += packetBytes;
+            if (timing.sourceIndex >= 0) unflushed.push_back(timing);
+        }
+        if (flushed) recordFlushed(writtenNs);
     }
 }
 
@@ -530,6 +646,13 @@ void Muxer::close() {
         m_writerThread.join();
     }
 
+    // The file is complete now; new readers go to disk. Existing readers keep
+    // their shared_ptr (and its resident packets) until they let go.
+    if (m_liveRing) {
+        LivePacketRing::withdraw(m_activePath, m_liveRing.get());
+        m_liveRing.reset();
+    }
+
     // Defensive: on a clean close the writer drains fully, so the queue is
     // empty here. Free anything left only to guarantee no leak on an abnormal
     // path (would have been written before the trailer otherwise).
@@ -540,6 +663,8 @@ void Muxer::close() {
             m_pktQueue.pop();
             av_packet_free(&p);
         }
+        m_pktTiming = {};
+        m_queueDepth.store(0, std::memory_order_relaxed);
     }
 
     if (m_initialized && m_outCtx) {
@@ -9,6 +9,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -25,6 +26,51 @@ extern "C" {
 }
 
 #include "recorder_engine/codec/videocodecchoice.h"
+#include "playback/output/latencyhistogram.h"
+
+class LivePacketRing;
+
+// Steady-clock stamps (PipelineTrace::nowNs) of one camera frame on its way to the file;
+// 0 = stage not observed. StreamWorker fills them and hands them to writePacket() with
+// the first packet encoded from a freshly pulled frame.
+struct CaptureFrameStamps {
+    qint64 arrivalNs = 0;  // the transport delivered the frame (0 when the backend can't tell)
+    qint64 decodedNs = 0;  // the decoder handed it to the capture thread
+    qint64 dequeuedNs = 0; // the master-pulse tick pulled it from the jitter queue
+    qint64 encodedNs = 0;  // the encoder returned its packet
+};
+
+// Glass-to-disk latency of one source's frames this session, recorded by the writer thread
+// once the throttled avio_flush covering the packet has handed it to the OS (so
+// queuedToWritten includes up to ~100 ms of AVIO buffering). decodedToDequeued includes the
+// jitter window by design; total runs from arrival, or from decode for backends that report
+// no arrival time.
+struct CaptureLatency {
+    LatencyHistogram arrivalToDecodedNs;
+    LatencyHistogram decodedToDequeuedNs;
+    LatencyHistogram dequeuedToEncodedNs;
+    LatencyHistogram encodedToQueuedNs;
+    LatencyHistogram queuedToWrittenNs;
+    LatencyHistogram totalNs;
+};
+
+// Writer-thread counters for the current session (reset by init()). Read with
+// Muxer::writeStats() from any thread; the pipeline benchmark reports them as the
+// record stage.
+struct MuxerWriteStats {
+    qint64 packetsQueued = 0;
+    qint64 packetsWritten = 0;
+    qint64 bytesWritten = 0;
+    qint64 writeErrors = 0;
+    qint64 maxQueueDepth = 0;
+    // writePacket() calls that found the queue full and blocked (the disk fell
+    // behind), and the total time they spent blocked.
+    qint64 producerStalls = 0;
+    qint64 producerStallNs = 0;
+    LatencyHistogram queueDwellNs; // enqueue -> popped by the writer thread
+    LatencyHistogram writeNs;      // header commit, av_write_frame and any throttled flush
+    QHash<int, CaptureLatency> sourceLatency; // by source index, stamped packets only
+};
 
 class Muxer {
 public:
@@ -58,6 +104,8 @@ public:
               const QByteArray& videoExtradata = {}, const QString& startTimecode = QString(),
               int fpsNum = 0, int fpsDen = 0);
     void writePacket(AVPacket* pkt);
+    // As above, attributing the packet's glass-to-disk latency to sourceIndex.
+    void writePacket(AVPacket* pkt, int sourceIndex, const CaptureFrameStamps& stamps);
     void writeMetadataPacket(int viewTrack, int64_t ptsMs, const QByteArray& jsonData);
     void writeTelemetryPacket(int feedIndex, int64_t ptsMs, const QByteArray& jsonData);
     // Offer a session-start timecode candidate. The header is written on the FIRST
@@ -86,6 +134,21 @@ public:
     // Deliberately unlocked: init() calls getVideoPath() while holding
     // m_mutex, and the value never changes during a recording session.
     void setOutputDirectory(const QString& dir) { m_outputDir = dir; }
+    // Whether init() publishes a live packet ring for the session (default on).
+    // Set BEFORE init(); off for files no playback worker reads while they grow.
+    void setLiveRingEnabled(bool enabled) { m_liveRingEnabled = enabled; }
+
+    // In-RAM ring of the last N minutes of muxed packets for this session
+    // (nullptr when disabled via OLR_LIVE_RING_MB/SECONDS=0 or setLiveRingEnabled,
+    // or not recording).
+    // Also published under the active path so playback can find it by file.
+    std::shared_ptr<LivePacketRing> liveRing() const { return m_liveRing; }
+
+    MuxerWriteStats writeStats() const;
+    // One source's slice of writeStats().sourceLatency, without copying the rest.
+    CaptureLatency captureLatency(int sourceIndex) const;
+    // Packets waiting for the writer thread right now. Lock-free, for polling monitors.
+    qint64 queueDepth() const { return m_queueDepth.load(std::memory_order_relaxed); }
 private:
     // Drains m_pktQueue and performs the actual av_write_frame/avio_flush.
     // Runs on m_writerThread; the ONLY thread that touches m_outCtx between
@@ -178,9 +241,21 @@ private:
     static constexpr size_t kMaxQueued = 4096; // ~ a few seconds of packets
     std::thread m_writerThread;
     std::queue<AVPacket*> m_pktQueue; // owns the cloned packets it holds
+    struct QueuedPacketTiming {
+        qint64 enqueuedNs = 0; // PipelineTrace::nowNs()
+        int sourceIndex = -1;  // >= 0 when stamps should be recorded
+        CaptureFrameStamps stamps;
+    };
+    std::queue<QueuedPacketTiming> m_pktTiming; // parallel to m_pktQueue
     std::mutex m_qMutex;
     std::condition_variable m_qCv;
+    std::atomic<qint64> m_queueDepth{0}; // m_pktQueue.size(), stored under m_qMutex
     std::atomic<bool> m_writerRunning{false};
+    // Fed under m_qMutex in writePacket so ring order == queue order == file
+    // order. Created in init(), withdrawn from the registry in close(); readers
+    // holding a shared_ptr keep the resident packets valid past close().
+    std::shared_ptr<LivePacketRing> m_liveRing;
+    bool m_liveRingEnabled = true;
 
     // Set on the FIRST sustained write failure (kFatalWriteThreshold consecutive
     // av_write_frame errors on any stream). Written once; reset only on init().
@@ -191,6 +266,11 @@ private:
     mutable std::mutex m_fatalMsgMutex;
     static constexpr int kFatalWriteThreshold = 3;
 
+    // Guarded by m_statsMutex: the producer side updates it under m_qMutex first
+    // (lock order m_qMutex -> m_statsMutex), the writer thread after each write.
+    MuxerWriteStats m_stats;
+    mutable std::mutex m_statsMutex;
+
 #ifdef OLR_UNIT_TEST
     friend class TestMuxer;
 #endif
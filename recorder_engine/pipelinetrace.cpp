@@ -0,0 +1,258 @@
+#include "pipelinetrace.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+std::atomic<bool> PipelineTrace::s_enabled{false};
+
+namespace {
+
+static_assert((PipelineTrace::kRingCapacity & (PipelineTrace::kRingCapacity - 1)) == 0,
+              "ring capacity must be a power of two");
+constexpr quint64 kRingMask = PipelineTrace::kRingCapacity - 1;
+
+const auto kTraceEpoch = std::chrono::steady_clock::now();
+
+// Every field is a relaxed atomic so a concurrent dump is race-free; seq brackets them
+// (seqlock): 0 while the owner rewrites the slot, index + 1 once the event is complete.
+struct TraceSlot {
+    std::atomic<quint64> seq{0};
+    std::atomic<qint64> tsNs{0};
+    std::atomic<qint64> durNs{0};
+    std::atomic<qint64> arg{0};
+    std::atomic<const char*> category{nullptr};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<const char*> argName{nullptr};
+    std::atomic<char> phase{0};
+};
+
+struct ThreadRing {
+    int tid = 0;
+    QString name;         // guarded by the registry mutex
+    bool retired = false; // guarded by the registry mutex
+    std::atomic<quint64> head{0};
+    std::atomic<quint64> clearedAt{0}; // dumps skip indexes below this
+    std::unique_ptr<TraceSlot[]> slots{new TraceSlot[PipelineTrace::kRingCapacity]};
+};
+
+struct TraceRegistry {
+    QMutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    int nextTid = 1;
+};
+
+// Leaked on purpose: a thread still recording during static destruction must not find
+// the registry gone.
+TraceRegistry& registry() {
+    static TraceRegistry* instance = new TraceRegistry;
+    return *instance;
+}
+
+void retireRing(const std::shared_ptr<ThreadRing>& ring) {
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    ring->retired = true;
+    const auto retired = std::count_if(reg.rings.begin(), reg.rings.end(),
+                                       [](const auto& r) { return r->retired; });
+    if (retired <= PipelineTrace::kMaxRetiredRings) return;
+    const auto oldest = std::find_if(reg.rings.begin(), reg.rings.end(),
+                                     [](const auto& r) { return r->retired; });
+    reg.rings.erase(oldest);
+}
+
+// The calling thread's ring and name; the ring is registered on the first event.
+struct ThreadTraceState {
+    std::shared_ptr<ThreadRing> ring;
+    QString name;
+    ~ThreadTraceState() {
+        if (ring) retireRing(ring);
+    }
+};
+
+thread_local ThreadTraceState t_trace;
+
+ThreadRing* currentRing() {
+    if (!t_trace.ring) {
+        auto ring = std::make_shared<ThreadRing>();
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        ring->tid = reg.nextTid++;
+        ring->name = t_trace.name;
+        reg.rings.push_back(ring);
+        t_trace.ring = std::move(ring);
+    }
+    return t_trace.ring.get();
+}
+
+void push(char phase, const char* category, const char* name, qint64 tsNs, qint64 durNs,
+          const char* argName, qint64 arg) {
+    ThreadRing* ring = currentRing();
+    const quint64 index = ring->head.load(std::memory_order_relaxed);
+    TraceSlot& slot = ring->slots[index & kRingMask];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tsNs.store(tsNs, std::memory_order_relaxed);
+    slot.durNs.store(durNs, std::memory_order_relaxed);
+    slot.arg.store(arg, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.argName.store(argName, std::memory_order_relaxed);
+    slot.phase.store(phase, std::memory_order_relaxed);
+    slot.seq.store(index + 1, std::memory_order_release);
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void appendString(QByteArray& out, const char* text) {
+    out += '"';
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') out += '\\';
+        out += *c;
+    }
+    out += '"';
+}
+
+void appendMicros(QByteArray& out, qint64 ns) {
+    out += QByteArray::number(double(ns) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+void PipelineTrace::setEnabled(bool on) {
+    s_enabled.store(on, std::memory_order_relaxed);
+}
+
+void PipelineTrace::clear() {
+    TraceRegistry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    for (const auto& ring : reg.rings) {
+        ring->clearedAt.store(ring->head.load(std::memory_order_acquire),
+                              std::memory_order_relaxed);
+    }
+}
+
+qint64 PipelineTrace::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                kTraceEpoch)
+        .count();
+}
+
+void PipelineTrace::setThreadName(const QString& name) {
+    t_trace.name = name;
+    if (t_trace.ring) {
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        t_trace.ring->name = name;
+    }
+}
+
+void PipelineTrace::complete(const char* category, const char* name, qint64 startNs,
+                             qint64 endNs, const char* argName, qint64 arg) {
+    if (!enabled()) return;
+    push('X', category, name, startNs, qMax<qint64>(0, endNs - startNs), argName, arg);
+}
+
+void PipelineTrace::instant(const char* category, const char* name, const char* argName,
+                            qint64 arg) {
+    if (!enabled()) return;
+    push('i', category, name, nowNs(), 0, argName, arg);
+}
+
+void PipelineTrace::counter(const char* category, const char* name, qint64 value) {
+    if (!enabled()) return;
+    push('C', category, name, nowNs(), 0, "value", value);
+}
+
+QByteArray PipelineTrace::chromeTraceJson(int* eventCount) {
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    std::vector<QString> names;
+    {
+        TraceRegistry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        rings = reg.rings;
+        for (const auto& ring : rings) names.push_back(ring->name);
+    }
+
+    QByteArray out;
+    out.reserve(1 << 20);
+    out += "{\"traceEvents\":[";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+           "\"args\":{\"name\":\"OpenLiveReplay\"}}";
+    int events = 0;
+    for (size_t r = 0; r < rings.size(); ++r) {
+        const ThreadRing& ring = *rings[r];
+        const QString name =
+            names[r].isEmpty() ? QStringLiteral("thread %1").arg(ring.tid) : names[r];
+        out += ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        out += QByteArray::number(ring.tid);
+        out += ",\"args\":";
+        out += QJsonDocument(QJsonObject{{QStringLiteral("name"), name}})
+                   .toJson(QJsonDocument::Compact);
+        out += '}';
+
+        const quint64 head = ring.head.load(std::memory_order_acquire);
+        const quint64 oldest = head > quint64(kRingCapacity) ? head - kRingCapacity : 0;
+        const quint64 from = std::max(oldest, ring.clearedAt.load(std::memory_order_relaxed));
+        for (quint64 i = from; i < head; ++i) {
+            const TraceSlot& slot = ring.slots[i & kRingMask];
+            const quint64 seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != i + 1) continue;
+            const qint64 tsNs = slot.tsNs.load(std::memory_order_relaxed);
+            const qint64 durNs = slot.durNs.load(std::memory_order_relaxed);
+            const qint64 arg = slot.arg.load(std::memory_order_relaxed);
+            const char* category = slot.category.load(std::memory_order_relaxed);
+            const char* eventName = slot.name.load(std::memory_order_relaxed);
+            const char* argName = slot.argName.load(std::memory_order_relaxed);
+            const char phase = slot.phase.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) continue; // overwritten
+
+            out += ",{\"name\":";
+            appendString(out, eventName);
+            out += ",\"cat\":";
+            appendString(out, category);
+            out += ",\"ph\":\"";
+            out += phase;
+            out += "\",\"ts\":";
+            appendMicros(out, tsNs);
+            if (phase == 'X') {
+                out += ",\"dur\":";
+                appendMicros(out, durNs);
+            } else if (phase == 'i') {
+                out += ",\"s\":\"t\"";
+            }
+            out += ",\"pid\":1,\"tid\":";
+            out += QByteArray::number(ring.tid);
+            if (argName) {
+                out += ",\"args\":{";
+                appendString(out, argName);
+                out += ':';
+                out += QByteArray::number(arg);
+                out += '}';
+            }
+            out += '}';
+            ++events;
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ms\"}";
+    if (eventCount) *eventCount = events;
+    return out;
+}
+
+bool PipelineTrace::writeChromeTrace(const QString& path, int* eventCount) {
+    const QByteArray json = chromeTraceJson(eventCount);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    if (file.write(json) != json.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -0,0 +1,84 @@
+#ifndef PIPELINETRACE_H
+#define PIPELINETRACE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+#include <atomic>
+
+// Pipeline-wide event tracing, exported as Chrome trace-event JSON (chrome://tracing,
+// ui.perfetto.dev). Always compiled in; off until setEnabled(true), and while off every
+// call site costs one relaxed load. When on, each thread records into its own fixed ring
+// of kRingCapacity events (allocated on the thread's first event, oldest overwritten), so
+// recording takes no lock and never allocates. chromeTraceJson() may run on any thread
+// while the others keep recording: every slot is a seqlock, and a slot overwritten
+// mid-read is skipped rather than torn.
+//
+// Names, categories and argument keys are stored as pointers and MUST be string literals
+// (or otherwise outlive the process). Thread names are copied.
+class PipelineTrace {
+public:
+    static constexpr int kRingCapacity = 8192; // per thread, power of two
+    // Rings of exited threads kept for the next dump; older ones are recycled.
+    static constexpr int kMaxRetiredRings = 32;
+
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool on);
+    // Drops every recorded event (rings stay allocated).
+    static void clear();
+
+    // Steady-clock nanoseconds; the time base of every event.
+    static qint64 nowNs();
+
+    // Names the calling thread's track. Cheap and safe to call while disabled; takes
+    // effect for the thread's ring whenever it is (or was) created.
+    static void setThreadName(const QString& name);
+
+    // A span [startNs, endNs) on the calling thread ("ph":"X").
+    static void complete(const char* category, const char* name, qint64 startNs, qint64 endNs,
+                         const char* argName = nullptr, qint64 arg = 0);
+    // A point event on the calling thread ("ph":"i").
+    static void instant(const char* category, const char* name, const char* argName = nullptr,
+                        qint64 arg = 0);
+    // A sampled value, drawn as its own counter track ("ph":"C").
+    static void counter(const char* category, const char* name, qint64 value);
+
+    // {"traceEvents":[...],"displayTimeUnit":"ms"} with thread-name metadata; events in
+    // per-thread order. eventCount, when given, receives the number of trace events.
+    static QByteArray chromeTraceJson(int* eventCount = nullptr);
+    // Writes chromeTraceJson() to path; false on I/O failure.
+    static bool writeChromeTrace(const QString& path, int* eventCount = nullptr);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Records the enclosing scope as a complete event when tracing was on at entry.
+class PipelineTraceScope {
+public:
+    PipelineTraceScope(const char* category, const char* name, const char* argName = nullptr,
+                       qint64 arg = 0)
+        : m_category(category), m_name(name), m_argName(argName), m_arg(arg),
+          m_startNs(PipelineTrace::enabled() ? PipelineTrace::nowNs() : -1) {}
+    ~PipelineTraceScope() {
+        if (m_startNs >= 0) {
+            PipelineTrace::complete(m_category, m_name, m_startNs, PipelineTrace::nowNs(),
+                                    m_argName, m_arg);
+        }
+    }
+    PipelineTraceScope(const PipelineTraceScope&) = delete;
+    PipelineTraceScope& operator=(const PipelineTraceScope&) = delete;
+
+    // Argument known only once the work is done (e.g. the packet's stream).
+    void setArg(qint64 arg) { m_arg = arg; }
+
+private:
+    const char* m_category;
+    const char* m_name;
+    const char* m_argName;
+    qint64 m_arg;
+    qint64 m_startNs;
+};
+
+#endif // PIPELINETRACE_H
@@ -533,6 +533,13 @@ void ReplayManager::updateSourceUrl(int sourceIndex, const QString &url) {
     }
 }
 
+QList<EncoderTickStats> ReplayManager::encoderTickStats() const {
+    QList<EncoderTickStats> stats;
+    stats.reserve(m_workers.size());
+    for (const StreamWorker* worker : m_workers) stats.append(worker->encoderTickStats());
+    return stats;
+}
+
 void ReplayManager::updateSourceTrim(int sourceIndex, int ms) {
     if (sourceIndex < 0) return;
     if (sourceIndex < m_sourceTrims.size()) m_sourceTrims[sourceIndex] = ms;
@@ -600,10 +607,19 @@ void ReplayManager::onSourceStatsUpdated(int sourceIndex, IngestStats stats) {
         stats.interCamPhaseMs = m_offsetEstimator.offsetMs(sourceIndex);
         stats.interCamBoundMs = m_offsetEstimator.boundMs(sourceIndex);
         stats.isReference = (sourceIndex == m_referenceSource);
+
+        // Glass-to-disk for this source from the muxer's per-source histogram (empty
+        // until a recording writes a stamped packet of this source).
+        const LatencyHistogram glassToDisk = m_muxer->captureLatency(sourceIndex).totalNs;
+        constexpr qint64 kNsPerMs = 1000000;
+        stats.glassToDiskFrames = glassToDisk.count();
+        stats.glassToDiskP50Ms = glassToDisk.percentile(0.50) / kNsPerMs;
+        stats.glassToDiskP99Ms = glassToDisk.percentile(0.99) / kNsPerMs;
+        stats.glassToDiskMaxMs = glassToDisk.max() / kNsPerMs;
     }
 
     // Relay the stats onward for the UI. Every pre-existing field is byte-identical;
-    // only the additive Phase-4 estimator fields were stamped above.
+    // only the additive estimator and glass-to-disk fields were stamped above.
     emit sourceStatsUpdated(sourceIndex, stats);
 }
 
@@ -92,6 +92,15 @@ public:
     int64_t getElapsedMs();
     QString getVideoPath();
     qint64 getRecordingStartEpochMs() const { return m_recordingStartEpochMs; }
+    // Writer-thread counters of the current (or last) recording session.
+    MuxerWriteStats muxerWriteStats() const { return m_muxer->writeStats(); }
+    // Lock-free muxer gauges for polling monitors: packets waiting on the writer thread,
+    // and whether the session's writes have failed for good.
+    qint64 muxerQueueDepth() const { return m_muxer->queueDepth(); }
+    bool muxerWriteFailed() const { return m_muxer->hasFatalWriteError(); }
+    // Per-source encode timing of the current session, indexed by source; empty when
+    // not recording. Call from the thread that starts/stops recording.
+    QList<EncoderTickStats> encoderTickStats() const;
 
     // Inter-camera timecode alignment (Phase 4 consumes these). True iff both
     // sources carried a common timecode AND their equal-TC frames coincide
@@ -8,6 +8,9 @@
 #include "ingest/nativertmpingestsession.h"
 #endif
 #include "ingest/nativendiingestsession.h"
+#include "ingest/syntheticingestsession.h"
+#include "pipelinetrace.h"
+#include "threadplacement.h"
 #include "timing/smpte12m.h"
 #include <QDebug>
 #include <QDateTime>
@@ -89,6 +92,8 @@ void StreamWorker::stop() {
 }
 
 void StreamWorker::run() {
+    PipelineTrace::setThreadName(QStringLiteral("encoder %1").arg(m_sourceIndex));
+    ThreadPlacement::placeCurrentThread(ThreadRole::Encode, m_sourceIndex);
     // 1. Setup the persistent encoder context (MPEG-2) or native encoder (H.264).
     if (!setupEncoder(&m_persistentEncCtx)) return;
 
@@ -162,11 +167,44 @@ void StreamWorker::onMasterPulse(int64_t frameIndex, int64_t streamTimeMs) {
         m_captureThread = std::thread([this]() { this->captureLoop(); });
     }
 
+    QElapsedTimer tickTimer;
+    tickTimer.start();
     processEncoderTick(m_persistentEncCtx, streamTimeMs, trimMs, jitterMs);
+    recordEncoderTick(tickTimer.nsecsElapsed(), streamTimeMs);
+}
+
+void StreamWorker::recordEncoderTick(qint64 tickNs, int64_t streamTimeMs) {
+    const qint64 lagMs =
+        m_sharedClock ? qMax<qint64>(0, m_sharedClock->elapsedMs() - streamTimeMs) : 0;
+    m_encodeTicks.fetch_add(1, std::memory_order_relaxed);
+    if (tickNs > 1000000000LL / qMax(1, m_targetFps)) {
+        m_encodeLateTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_lastEncodeTickNs.store(tickNs, std::memory_order_relaxed);
+    m_lastEncodeLagMs.store(lagMs, std::memory_order_relaxed);
+    // Single writer: a plain load/compare/store is enough.
+    if (tickNs > m_maxEncodeTickNs.load(std::memory_order_relaxed)) {
+        m_maxEncodeTickNs.store(tickNs, std::memory_order_relaxed);
+    }
+    if (lagMs > m_maxEncodeLagMs.load(std::memory_order_relaxed)) {
+        m_maxEncodeLagMs.store(lagMs, std::memory_order_relaxed);
+    }
+}
+
+EncoderTickStats StreamWorker::encoderTickStats() const {
+    EncoderTickStats stats;
+    stats.ticks = m_encodeTicks.load(std::memory_order_relaxed);
+    stats.lateTicks = m_encodeLateTicks.load(std::memory_order_relaxed);
+    stats.lastTickNs = m_lastEncodeTickNs.load(std::memory_order_relaxed);
+    stats.maxTickNs = m_maxEncodeTickNs.load(std::memory_order_relaxed);
+    stats.lastLagMs = m_lastEncodeLagMs.load(std::memory_order_relaxed);
+    stats.maxLagMs = m_maxEncodeLagMs.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTimeMs, int64_t trimMs,
                                       int64_t jitterMs) {
+    PipelineTraceScope trace("record", "encoder tick", "frame", m_internalFrameCount);
     AVPacket* outPkt = av_packet_alloc();
     bool havePacket = false;
     int track = -1;
@@ -174,6 +212,8 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
 
     AVFrame* pulled = nullptr;
     int64_t pulledTimecode100ns = -1;
+    // Latency stamps of a frame pulled THIS tick; a held/repeated frame muxes unstamped.
+    CaptureFrameStamps stamps;
     const bool paintBlue = m_paintBlue.fetchAndStoreRelaxed(0) != 0;
 
     // The mutex only guards m_frameQueue (shared with the capture
@@ -200,8 +240,10 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
             if (pulled) av_frame_free(&pulled);
             pulled = top.frame;
             pulledTimecode100ns = top.sourceTimecode100ns;
+            stamps = top.stamps;
         }
     }
+    if (pulled) stamps.dequeuedNs = PipelineTrace::nowNs();
 
     if (paintBlue && m_latestFrame && m_latestFrame->data[0]) {
         memset(m_latestFrame->data[0], 128, m_latestFrame->linesize[0] * m_latestFrame->height);
@@ -266,7 +308,13 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
                         pkt->duration = av_rescale_q(
                             1, AVRational{1, m_targetFps}, st->time_base);
                         if (keyframe) pkt->flags |= AV_PKT_FLAG_KEY;
-                        m_muxer->writePacket(pkt);
+                        if (stamps.decodedNs > 0) {
+                            stamps.encodedNs = PipelineTrace::nowNs();
+                            m_muxer->writePacket(pkt, m_sourceIndex, stamps);
+                            stamps = {}; // the frame's first packet carries its latency
+                        } else {
+                            m_muxer->writePacket(pkt);
+                        }
                         havePacket = true;
                     }
                     av_packet_free(&pkt);
@@ -280,6 +328,7 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
 
             if (avcodec_send_frame(encCtx, m_latestFrame) == 0) {
                 if (avcodec_receive_packet(encCtx, outPkt) == 0) {
+                    if (stamps.decodedNs > 0) stamps.encodedNs = PipelineTrace::nowNs();
                     outPkt->stream_index = track;
                     outPkt->duration = 1;
                     AVStream* st = m_muxer->getStream(track);
@@ -296,7 +345,7 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
         // For MPEG-2, the packet is in outPkt and has not been written yet.
         // For H.264, packets were written inline in the callback above.
         if (m_videoCodec != VideoCodecChoice::H264Hardware && encCtx) {
-            m_muxer->writePacket(outPkt);
+            m_muxer->writePacket(outPkt, m_sourceIndex, stamps);
         }
 
         // Forward this frame's source timecode to ReplayManager's TimecodeAligner,
@@ -329,6 +378,8 @@ void StreamWorker::processEncoderTick(AVCodecContext* encCtx, int64_t streamTime
 }
 
 void StreamWorker::captureLoop() {
+    PipelineTrace::setThreadName(QStringLiteral("capture %1").arg(m_sourceIndex));
+    ThreadPlacement::placeCurrentThread(ThreadRole::Capture, m_sourceIndex);
     while (m_captureRunning) {
         // If a restart was requested (e.g. changeSource), acknowledge it
         // and loop back to re-read the URL instead of exiting.
@@ -378,6 +429,7 @@ void StreamWorker::captureLoop() {
         };
         callbacks.onVideoFrame = [this](DecodedVideoFrame decoded) {
             if (!decoded.frame) return;
+            PipelineTrace::instant("ingest", "frame", "ptsMs", decoded.sourcePtsMs);
 
             // Bug 4: a restart/blue-paint is pending (source was cleared to an
             // empty URL). Drop frames from the old source so a late straggler
@@ -391,6 +443,8 @@ void StreamWorker::captureLoop() {
             qf.frame = decoded.frame;
             qf.sourcePts = decoded.sourcePtsMs;
             qf.sourceTimecode100ns = decoded.sourceTimecode100ns;
+            qf.stamps.arrivalNs = decoded.arrivalNs;
+            qf.stamps.decodedNs = PipelineTrace::nowNs();
 
             QMutexLocker locker(&m_frameMutex);
             m_frameQueue.enqueue(qf);
@@ -466,6 +520,10 @@ void StreamWorker::captureLoop() {
             session = std::make_unique<NativeNdiIngestSession>(
                 m_sourceIndex, m_targetWidth, m_targetHeight, &m_captureRunning, &m_ndiSourceClock);
         }
+        if (backendKind == IngestBackendKind::Synthetic) {
+            session = std::make_unique<SyntheticIngestSession>(m_sourceIndex, m_targetWidth,
+                                                               m_targetHeight, &m_captureRunning);
+        }
         if (!session) {
             const QString scheme = sourceUrl.scheme().toLower();
             if (scheme == QStringLiteral("srt") || scheme == QStringLiteral("rtmp") ||
@@ -33,6 +33,20 @@ extern "C" {
     #include <libswresample/swresample.h>
 }
 
+// Master-pulse encode timing for one source since the worker started. Read with
+// StreamWorker::encoderTickStats() from any thread; every field is a relaxed atomic on the
+// worker side, so readers never block the tick.
+struct EncoderTickStats {
+    qint64 ticks = 0;
+    qint64 lateTicks = 0;  // ticks whose jitter pull + encode + mux took over a frame period
+    qint64 lastTickNs = 0;
+    qint64 maxTickNs = 0;
+    // How far the finished tick trailed its slot on the session clock (queued pulses
+    // waiting behind a slow encode show up here first).
+    qint64 lastLagMs = 0;
+    qint64 maxLagMs = 0;
+};
+
 class StreamWorker : public QThread {
     Q_OBJECT
 public:
@@ -107,6 +121,7 @@ public:
     void stop();
 
     int sourceIndex() const { return m_sourceIndex; }
+    EncoderTickStats encoderTickStats() const;
 
 signals:
     // Emitted from the capture thread ONLY when the connection state flips
@@ -202,6 +217,15 @@ private:
     // frames the next tick would discard anyway.
     std::atomic<int64_t> m_lastTickTargetMs{-1};
 
+    // EncoderTickStats, written by the tick thread only.
+    void recordEncoderTick(qint64 tickNs, int64_t streamTimeMs);
+    std::atomic<qint64> m_encodeTicks{0};
+    std::atomic<qint64> m_encodeLateTicks{0};
+    std::atomic<qint64> m_lastEncodeTickNs{0};
+    std::atomic<qint64> m_maxEncodeTickNs{0};
+    std::atomic<qint64> m_lastEncodeLagMs{0};
+    std::atomic<qint64> m_maxEncodeLagMs{0};
+
     // Audio FIFO: the capture thread produces resampled 48 kHz stereo S16
     // stamped on the global recording timeline; the master-pulse tick
     // consumes it on a sample-accurate cursor (gap-filled with silence).
@@ -230,6 +254,8 @@ private:
         // transport carried no TC. Purely additive: never affects A/V sync or the
         // jitter pull; only forwarded via frameTimecode() when the frame is muxed.
         int64_t sourceTimecode100ns = -1;
+        // arrival and decode stamps; the tick adds dequeue and encode before muxing.
+        CaptureFrameStamps stamps;
     };
 
     QQueue<QueuedFrame> m_frameQueue;
@@ -0,0 +1,387 @@
+#include "recorder_engine/threadplacement.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#endif
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_UNIX)
+#include <time.h>
+#endif
+
+namespace {
+
+QMutex g_planMutex;
+ThreadPlacementPlan g_plan; // guarded by g_planMutex
+
+QString readTrimmed(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QString();
+    return QString::fromLatin1(file.readAll()).trimmed();
+}
+
+int readInt(const QString& path, int fallback) {
+    bool ok = false;
+    const int value = readTrimmed(path).toInt(&ok);
+    return ok ? value : fallback;
+}
+
+// Entries of `dir` named <prefix><number>, as the numbers.
+QList<int> numberedEntries(const QString& dir, const QString& prefix) {
+    const QRegularExpression pattern(QStringLiteral("^%1(\\d+)$").arg(prefix));
+    QList<int> out;
+    for (const QString& name : QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QRegularExpressionMatch match = pattern.match(name);
+        if (match.hasMatch()) out.append(match.captured(1).toInt());
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+QList<int> without(const QList<int>& cpus, const QList<int>& removed) {
+    QList<int> out;
+    for (const int cpu : cpus) {
+        if (!removed.contains(cpu)) out.append(cpu);
+    }
+    return out;
+}
+
+QList<int> flattened(const QList<QList<int>>& cores) {
+    QList<int> out;
+    for (const QList<int>& core : cores) out += core;
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+const char* roleName(ThreadRole role) {
+    switch (role) {
+    case ThreadRole::Capture:
+        return "capture";
+    case ThreadRole::Encode:
+        return "encode";
+    case ThreadRole::Mux:
+        return "mux";
+    case ThreadRole::Playback:
+        return "playback";
+    case ThreadRole::Output:
+        return "output";
+    }
+    return "capture";
+}
+
+} // namespace
+
+CpuTopology CpuTopology::detect() {
+#if defined(Q_OS_LINUX)
+    QList<int> allowed;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) allowed.append(cpu);
+        }
+    }
+    return fromSysfs(QStringLiteral("/sys/devices/system"), allowed);
+#else
+    return CpuTopology();
+#endif
+}
+
+CpuTopology CpuTopology::fromSysfs(const QString& root, const QList<int>& allowed) {
+    QHash<int, int> nodeOfCpu;
+    for (const int node : numberedEntries(root + QStringLiteral("/node"), QStringLiteral("node"))) {
+        const QString list =
+            readTrimmed(QStringLiteral("%1/node/node%2/cpulist").arg(root).arg(node));
+        for (const int cpu : ThreadPlacement::parseCpuList(list)) nodeOfCpu.insert(cpu, node);
+    }
+
+    CpuTopology topology;
+    const QString cpuDir = root + QStringLiteral("/cpu");
+    for (const int id : numberedEntries(cpuDir, QStringLiteral("cpu"))) {
+        if (!allowed.isEmpty() && !allowed.contains(id)) continue;
+        const QString base = QStringLiteral("%1/cpu%2").arg(cpuDir).arg(id);
+        // cpu0 usually has no "online" file: it cannot be taken offline.
+        if (readTrimmed(base + QStringLiteral("/online")) == QLatin1String("0")) continue;
+        Cpu cpu;
+        cpu.id = id;
+        cpu.core = readInt(base + QStringLiteral("/topology/core_id"), id);
+        cpu.package = readInt(base + QStringLiteral("/topology/physical_package_id"), 0);
+        cpu.node = nodeOfCpu.value(id, 0);
+        topology.cpus.append(cpu);
+    }
+    return topology;
+}
+
+QList<int> CpuTopology::nodes() const {
+    QList<int> out;
+    for (const Cpu& cpu : cpus) {
+        if (!out.contains(cpu.node)) out.append(cpu.node);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+QList<int> CpuTopology::cpusOfNode(int node) const {
+    QList<int> out;
+    for (const Cpu& cpu : cpus) {
+        if (cpu.node == node) out.append(cpu.id);
+    }
+    return out;
+}
+
+QList<QList<int>> CpuTopology::coresOfNode(int node) const {
+    QMap<QPair<int, int>, QList<int>> cores; // (package, core) -> siblings
+    for (const Cpu& cpu : cpus) {
+        if (cpu.node == node) cores[qMakePair(cpu.package, cpu.core)].append(cpu.id);
+    }
+    return cores.values();
+}
+
+int CpuTopology::physicalCoreCount() const {
+    QList<QPair<int, int>> seen;
+    for (const Cpu& cpu : cpus) {
+        const QPair<int, int> core = qMakePair(cpu.package, cpu.core);
+        if (!seen.contains(core)) seen.append(core);
+    }
+    return int(seen.size());
+}
+
+ThreadPlacementPolicy ThreadPlacementPolicy::fromEnvironment() {
+    ThreadPlacementPolicy policy;
+    const QList<QPair<ThreadRole, const char*>> variables = {
+        {ThreadRole::Capture, "OLR_CPUS_CAPTURE"}, {ThreadRole::Encode, "OLR_CPUS_ENCODE"},
+        {ThreadRole::Mux, "OLR_CPUS_MUX"},         {ThreadRole::Playback, "OLR_CPUS_PLAYBACK"},
+        {ThreadRole::Output, "OLR_CPUS_OUTPUT"},
+    };
+    for (const auto& [role, name] : variables) {
+        const QList<int> cpus = ThreadPlacement::parseCpuList(qEnvironmentVariable(name));
+        if (!cpus.isEmpty()) policy.cpus.insert(role, cpus);
+    }
+
+    const QString mode = qEnvironmentVariable("OLR_THREAD_PLACEMENT").trimmed().toLower();
+    if (mode == QLatin1String("auto")) {
+        policy.mode = Mode::Auto;
+    } else if (mode == QLatin1String("manual")) {
+        policy.mode = Mode::Manual;
+    } else if (mode.isEmpty() && !policy.cpus.isEmpty()) {
+        // Role sets on their own mean what they say.
+        policy.mode = Mode::Manual;
+    }
+    return policy;
+}
+
+bool ThreadPlacementPlan::isActive() const {
+    if (!mux.isEmpty() || !playback.isEmpty() || !output.isEmpty()) return true;
+    for (const QList<int>& set : channelOutputs) {
+        if (!set.isEmpty()) return true;
+    }
+    for (const QList<int>& set : sourceSets) {
+        if (!set.isEmpty()) return true;
+    }
+    for (const QList<int>& set : overrides) {
+        if (!set.isEmpty()) return true;
+    }
+    return false;
+}
+
+QList<int> ThreadPlacementPlan::cpusFor(ThreadRole role, int index) const {
+    // Another channel's dispatcher never shares channel 0's core, explicit or planned.
+    if (role == ThreadRole::Output && index >= 1)
+        return index <= channelOutputs.size() ? channelOutputs.at(index - 1) : QList<int>();
+    if (overrides.contains(role)) return overrides.value(role);
+    switch (role) {
+    case ThreadRole::Capture:
+    case ThreadRole::Encode:
+        if (sourceSets.isEmpty()) return {};
+        return sourceSets.at(qMax(0, index) % int(sourceSets.size()));
+    case ThreadRole::Mux:
+        return mux;
+    case ThreadRole::Playback:
+        return playback;
+    case ThreadRole::Output:
+        return output;
+    }
+    return {};
+}
+
+QString ThreadPlacementPlan::describe() const {
+    QStringList parts;
+    for (const ThreadRole role : {ThreadRole::Output, ThreadRole::Mux, ThreadRole::Playback,
+                                  ThreadRole::Capture, ThreadRole::Encode}) {
+        if (role == ThreadRole::Capture && !overrides.contains(role)) continue;
+        if (role == ThreadRole::Encode && !overrides.contains(role)) continue;
+        QStringList sets;
+        if (const QList<int> cpus = cpusFor(role); !cpus.isEmpty())
+            sets << ThreadPlacement::formatCpuList(cpus);
+        if (role == ThreadRole::Output && !sets.isEmpty()) {
+            for (const QList<int>& set : channelOutputs)
+                sets << ThreadPlacement::formatCpuList(set);
+        }
+        if (!sets.isEmpty()) {
+            parts << QStringLiteral("%1 %2").arg(QLatin1String(roleName(role)),
+                                                 sets.join(QStringLiteral(" | ")));
+        }
+    }
+    const bool sourcesOverridden =
+        overrides.contains(ThreadRole::Capture) && overrides.contains(ThreadRole::Encode);
+    if (!sourcesOverridden && !sourceSets.isEmpty()) {
+        QStringList sets;
+        for (const QList<int>& set : sourceSets) sets << ThreadPlacement::formatCpuList(set);
+        parts << QStringLiteral("sources %1").arg(sets.join(QStringLiteral(" | ")));
+    }
+    return parts.join(QStringLiteral("; "));
+}
+
+ThreadPlacementPlan ThreadPlacementPlan::build(const CpuTopology& topology,
+                                               const ThreadPlacementPolicy& policy) {
+    ThreadPlacementPlan plan;
+    if (policy.mode == ThreadPlacementPolicy::Mode::Off) return plan;
+    plan.overrides = policy.cpus;
+    if (policy.mode != ThreadPlacementPolicy::Mode::Auto) return plan;
+    if (topology.physicalCoreCount() < kMinAutoCores) return plan;
+
+    const QList<int> nodes = topology.nodes();
+    QList<QList<int>> homeCores = topology.coresOfNode(nodes.first());
+    if (homeCores.size() >= 2) plan.output = homeCores.takeLast();
+    if (topology.physicalCoreCount() >= kMinMuxCoreCores && homeCores.size() >= 2) {
+        plan.mux = homeCores.takeLast();
+    }
+    for (int channel = 1; channel < policy.outputChannels && homeCores.size() >= 2; ++channel)
+        plan.channelOutputs.append(homeCores.takeLast());
+    plan.playback = flattened(homeCores);
+
+    QList<int> reserved = plan.output + plan.mux;
+    for (const QList<int>& set : plan.channelOutputs) reserved += set;
+    for (const int node : nodes) {
+        const QList<int> set = without(topology.cpusOfNode(node), reserved);
+        if (!set.isEmpty()) plan.sourceSets.append(set);
+    }
+    return plan;
+}
+
+void ThreadPlacement::configure(const ThreadPlacementPlan& plan) {
+    QMutexLocker locker(&g_planMutex);
+    g_plan = plan;
+}
+
+ThreadPlacementPlan ThreadPlacement::plan() {
+    QMutexLocker locker(&g_planMutex);
+    return g_plan;
+}
+
+bool ThreadPlacement::placeCurrentThread(ThreadRole role, int sourceIndex, QString* error) {
+    QList<int> cpus;
+    {
+        QMutexLocker locker(&g_planMutex);
+        cpus = g_plan.cpusFor(role, sourceIndex);
+    }
+    if (cpus.isEmpty()) return true;
+    QString reason;
+    if (setCurrentThreadCpus(cpus, &reason)) return true;
+    qWarning() << "Thread placement:" << roleName(role) << sourceIndex << "not pinned to"
+               << formatCpuList(cpus) << reason;
+    if (error) *error = reason;
+    return false;
+}
+
+bool ThreadPlacement::setCurrentThreadCpus(const QList<int>& cpus, QString* error) {
+#if defined(Q_OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0 && error) *error = QString::fromLocal8Bit(std::strerror(rc));
+    return rc == 0;
+#else
+    Q_UNUSED(cpus);
+    if (error) *error = QStringLiteral("unsupported on this platform");
+    return false;
+#endif
+}
+
+QList<int> ThreadPlacement::currentThreadCpus() {
+    QList<int> out;
+#if defined(Q_OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return out;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) out.append(cpu);
+    }
+#endif
+    return out;
+}
+
+qint64 ThreadPlacement::currentThreadCpuNs() {
+#if defined(Q_OS_WIN)
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) return -1;
+    const auto ticks = [](const FILETIME& t) {
+        return (qint64(t.dwHighDateTime) << 32) | qint64(t.dwLowDateTime);
+    };
+    return (ticks(kernel) + ticks(user)) * 100; // 100 ns units
+#elif defined(Q_OS_UNIX)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return -1;
+    return qint64(ts.tv_sec) * 1000000000LL + qint64(ts.tv_nsec);
+#else
+    return -1;
+#endif
+}
+
+QList<int> ThreadPlacement::parseCpuList(const QString& text) {
+    QList<int> out;
+    for (const QString& part : text.split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const QStringList range = part.trimmed().split(QLatin1Char('-'));
+        bool okFirst = false;
+        bool okLast = false;
+        const int first = range.value(0).trimmed().toInt(&okFirst);
+        const int last = range.size() == 2 ? range.value(1).trimmed().toInt(&okLast) : first;
+        if (!okFirst || (range.size() == 2 && !okLast) || range.size() > 2) continue;
+        if (first < 0 || last < first) continue;
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (!out.contains(cpu)) out.append(cpu);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+QString ThreadPlacement::formatCpuList(QList<int> cpus) {
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    QStringList parts;
+    for (qsizetype i = 0; i < cpus.size();) {
+        qsizetype j = i;
+        while (j + 1 < cpus.size() && cpus.at(j + 1) == cpus.at(j) + 1) ++j;
+        parts << (j == i ? QString::number(cpus.at(i))
+                         : QStringLiteral("%1-%2").arg(cpus.at(i)).arg(cpus.at(j)));
+        i = j + 1;
+    }
+    return parts.join(QLatin1Char(','));
+}
+
+ScopedThreadPlacement::ScopedThreadPlacement(ThreadRole role, int sourceIndex) {
+    const QList<int> cpus = ThreadPlacement::plan().cpusFor(role, sourceIndex);
+    if (cpus.isEmpty()) return;
+    m_previous = ThreadPlacement::currentThreadCpus();
+    m_placed = ThreadPlacement::setCurrentThreadCpus(cpus);
+}
+
+ScopedThreadPlacement::~ScopedThreadPlacement() {
+    if (m_placed && !m_previous.isEmpty()) ThreadPlacement::setCurrentThreadCpus(m_previous);
+}
@@ -0,0 +1,132 @@
+#ifndef THREADPLACEMENT_H
+#define THREADPLACEMENT_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// The pipeline threads a placement policy can pin.
+enum class ThreadRole {
+    Capture,  // StreamWorker capture thread, per source
+    Encode,   // StreamWorker encoder tick thread, per source
+    Mux,      // Muxer writer thread
+    Playback, // PlaybackWorker thread
+    Output,   // OutputRuntime dispatch thread
+};
+
+// The CPUs this process may run on, with the physical core, package and NUMA node of
+// each. Read from sysfs on Linux; empty elsewhere (placement then never pins).
+struct CpuTopology {
+    struct Cpu {
+        int id = 0;
+        int core = 0;    // core_id within the package
+        int package = 0; // physical_package_id
+        int node = 0;    // NUMA node, 0 when the kernel reports none
+    };
+
+    QList<Cpu> cpus; // ascending id
+
+    static CpuTopology detect();
+    // `root` stands in for /sys/devices/system; `allowed` is the process affinity mask
+    // (empty = every CPU found).
+    static CpuTopology fromSysfs(const QString& root, const QList<int>& allowed);
+
+    bool isEmpty() const { return cpus.isEmpty(); }
+    QList<int> nodes() const;
+    QList<int> cpusOfNode(int node) const;
+    // Physical cores of `node` in ascending order, each as its SMT siblings.
+    QList<QList<int>> coresOfNode(int node) const;
+    int physicalCoreCount() const;
+};
+
+// How pipeline threads are placed.
+//   Off:    threads float (the default).
+//   Auto:   from the topology (ThreadPlacementPlan::build); explicit sets override roles.
+//   Manual: only the explicit sets; roles without one float.
+struct ThreadPlacementPolicy {
+    enum class Mode { Off, Auto, Manual };
+
+    Mode mode = Mode::Off;
+    QMap<ThreadRole, QList<int>> cpus; // Capture and Encode sets apply to every source
+    // Playback channels, each with its own output dispatcher (OLR_PLAYBACK_CHANNELS); the
+    // caller fills it in. The Output set applies to channel 0 only.
+    int outputChannels = 1;
+
+    // OLR_THREAD_PLACEMENT=off|auto|manual, and per role OLR_CPUS_CAPTURE, OLR_CPUS_ENCODE,
+    // OLR_CPUS_MUX, OLR_CPUS_PLAYBACK, OLR_CPUS_OUTPUT as CPU lists ("0-3,8").
+    static ThreadPlacementPolicy fromEnvironment();
+};
+
+// Which CPUs each role's threads run on. An empty set means the thread floats.
+//
+// Auto on a machine with at least kMinAutoCores physical cores:
+//   * the output dispatcher gets the last physical core of node 0 to itself (every SMT
+//     sibling), so no encoder or decoder ever shares its core;
+//   * from kMinMuxCoreCores cores up, the muxer writer gets the core before it;
+//   * each further playback channel's dispatcher gets the next core down, while at least
+//     one is left for playback; channels past that float rather than share a core;
+//   * playback gets the rest of node 0;
+//   * sources go round-robin over the nodes, capture and encode of one source on the same
+//     node minus the reserved cores. The capture thread first-touches the source's frame
+//     buffers, so they are allocated on that node and the encoder reads them locally.
+struct ThreadPlacementPlan {
+    static constexpr int kMinAutoCores = 4;
+    static constexpr int kMinMuxCoreCores = 8;
+
+    QList<int> mux;
+    QList<int> playback;
+    QList<int> output;
+    QList<QList<int>> channelOutputs;       // playback channel c >= 1 uses [c - 1]
+    QList<QList<int>> sourceSets;           // source i uses sourceSets[i % size]
+    QMap<ThreadRole, QList<int>> overrides; // explicit sets, every source alike
+
+    bool isActive() const;
+    // `index` is the source for Capture and Encode and the playback channel for Output.
+    QList<int> cpusFor(ThreadRole role, int index = -1) const;
+    // Stable one-line summary, e.g. "output 15,31; mux 14,30; playback 0-13,16-29;
+    // sources 0-13,16-29", with further channels' output cores as "output 15,31 | 13,29".
+    // Empty when nothing is pinned, so results recorded without a placement still compare
+    // equal.
+    QString describe() const;
+
+    static ThreadPlacementPlan build(const CpuTopology& topology,
+                                     const ThreadPlacementPolicy& policy);
+};
+
+// The process-wide plan. Each pipeline thread places itself right after naming its trace
+// track, so one configure() at startup covers threads started later.
+class ThreadPlacement {
+public:
+    static void configure(const ThreadPlacementPlan& plan);
+    static ThreadPlacementPlan plan();
+
+    // Restricts the calling thread to its role's CPUs. True when pinned or when the plan
+    // leaves the role floating; false with `error` when the OS refused.
+    static bool placeCurrentThread(ThreadRole role, int sourceIndex = -1,
+                                   QString* error = nullptr);
+
+    static bool setCurrentThreadCpus(const QList<int>& cpus, QString* error = nullptr);
+    // Empty when unknown (non-Linux).
+    static QList<int> currentThreadCpus();
+    // CPU time the calling thread has consumed, in ns; -1 when the OS cannot report it.
+    static qint64 currentThreadCpuNs();
+
+    static QList<int> parseCpuList(const QString& text);
+    static QString formatCpuList(QList<int> cpus);
+};
+
+// Places the calling thread for its lifetime and restores the previous CPU set on exit,
+// for work that borrows a pooled thread (the benchmark ramps).
+class ScopedThreadPlacement {
+public:
+    explicit ScopedThreadPlacement(ThreadRole role, int sourceIndex = -1);
+    ~ScopedThreadPlacement();
+    ScopedThreadPlacement(const ScopedThreadPlacement&) = delete;
+    ScopedThreadPlacement& operator=(const ScopedThreadPlacement&) = delete;
+
+private:
+    QList<int> m_previous;
+    bool m_placed = false;
+};
+
+#endif // THREADPLACEMENT_H
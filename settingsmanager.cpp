@@ -58,6 +58,18 @@ bool outputTargetKindFromString(const QString& name, OutputTargetKind* kind) {
         *kind = OutputTargetKind::Aja;
         return true;
     }
+    if (name == QStringLiteral("shared-memory")) {
+        *kind = OutputTargetKind::SharedMemory;
+        return true;
+    }
+    if (name == QStringLiteral("mpegts-stream")) {
+        *kind = OutputTargetKind::MpegTsStream;
+        return true;
+    }
+    if (name == QStringLiteral("iso-recorder")) {
+        *kind = OutputTargetKind::IsoRecorder;
+        return true;
+    }
     return false;
 }
 
@@ -70,6 +82,7 @@ QJsonArray broadcastOutputsToJson(const QList<OutputTargetAssignment>& outputs)
         obj.insert(QStringLiteral("kind"), outputTargetKindName(assignment.kind));
         obj.insert(QStringLiteral("enabled"), assignment.enabled);
         obj.insert(QStringLiteral("settings"), QJsonObject::fromVariantMap(assignment.settings));
+        if (assignment.channel != 0) obj.insert(QStringLiteral("channel"), assignment.channel);
         arr.append(obj);
     }
     return arr;
@@ -91,6 +104,7 @@ QList<OutputTargetAssignment> broadcastOutputsFromJson(const QJsonValue& value)
         assignment.kind = kind;
         assignment.enabled = obj.value(QStringLiteral("enabled")).toBool(false);
         assignment.settings = obj.value(QStringLiteral("settings")).toObject().toVariantMap();
+        assignment.channel = qMax(0, obj.value(QStringLiteral("channel")).toInt(0));
         outputs.append(assignment);
     }
     return outputs;
@@ -0,0 +1,378 @@
+// Headless end-to-end pipeline benchmark: answers "can this box sustain N feeds" without
+// cameras or GPUs. N synthetic:// sources (SyntheticIngestSession: makeSyntheticFrame
+// pictures + a tone, paced to wall clock) record through the real ReplayManager ->
+// StreamWorker -> Muxer -> disk for a fixed window while a real PlaybackWorker chases the
+// growing file near the live edge and drives its OutputRuntime into shared-memory sinks
+// (PGM + multiview; none off Unix or with --no-shm, the runtime still renders every tick).
+//
+// At the end one JSON report is printed on stdout (or written to --json):
+//   config    feeds, size, rate, codec, seconds, host thread count
+//   ingest    frames delivered / skipped per source (sampled ~1/sec from the sessions)
+//   record    muxer packets + bytes written, MB/s, queue dwell and write latency
+//             percentiles, writer queue high-water mark, producer stalls (disk too slow)
+//   playback  decoded frames + fps, dropped frames, repositions, read stalls, and the
+//             live-edge lag percentiles (recording clock - playhead)
+//   output    ticks, deadline misses, lateness percentiles, render/submit p99,
+//             placeholder/held frames, per-target sink submitted/dropped/failed
+//   drops     every drop counter above in one place; all 0 on a box that keeps up
+//
+// usage: pipeline_bench [--feeds N] [--seconds S] [--width W] [--height H] [--fps F]
+//                       [--codec mpeg2|h264] [--chase-ms MS] [--outdir DIR] [--json FILE]
+//                       [--no-shm] [--strict]
+//   Defaults: 4 feeds, 1280x720@30, MPEG-2, playback chasing 1500 ms behind live after
+//   2 s of recording. --seconds falls back to OLR_PIPELINE_BENCH_SECONDS (default 10).
+//   Recordings go to a temporary directory unless --outdir is given. --strict exits 1
+//   when any drop counter is non-zero.
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+
+#include <cstdio>
+#include <memory>
+
+#include "playback/audioplayer.h"
+#include "playback/frameprovider.h"
+#include "playback/output/latencyhistogram.h"
+#include "playback/output/outputdispatcher.h"
+#include "playback/output/outputtargetassignment.h"
+#include "playback/playbacktransport.h"
+#include "playback/playbackworker.h"
+#include "recorder_engine/ingest/ingestsession.h"
+#include "recorder_engine/replaymanager.h"
+
+namespace {
+
+constexpr int kPlaybackStartMs = 2000; // recording lead before the chase player opens
+constexpr int kSampleIntervalMs = 100;
+
+QString argValue(const QStringList& args, const QString& flag, const QString& fallback) {
+    const int i = args.indexOf(flag);
+    if (i >= 0 && i + 1 < args.size()) return args.at(i + 1);
+    return fallback;
+}
+
+int envIntOr(const char* key, int def) {
+    bool ok = false;
+    const int v = qEnvironmentVariableIntValue(key, &ok);
+    return ok ? v : def;
+}
+
+double perSecond(qint64 count, qint64 ms) {
+    return ms > 0 ? double(count) * 1000.0 / double(ms) : 0.0;
+}
+
+// Percentiles of a nanosecond histogram, reported in the given unit (1000 = us, 1e6 = ms).
+QJsonObject percentiles(const LatencyHistogram& h, double unitNs) {
+    QJsonObject o;
+    o.insert(QStringLiteral("count"), h.count());
+    o.insert(QStringLiteral("p50"), double(h.percentile(0.50)) / unitNs);
+    o.insert(QStringLiteral("p95"), double(h.percentile(0.95)) / unitNs);
+    o.insert(QStringLiteral("p99"), double(h.percentile(0.99)) / unitNs);
+    o.insert(QStringLiteral("max"), double(h.max()) / unitNs);
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+
+    const int feeds = argValue(args, QStringLiteral("--feeds"), QStringLiteral("4")).toInt();
+    const int seconds =
+        argValue(args, QStringLiteral("--seconds"),
+                 QString::number(envIntOr("OLR_PIPELINE_BENCH_SECONDS", 10)))
+            .toInt();
+    const int width = argValue(args, QStringLiteral("--width"), QStringLiteral("1280")).toInt();
+    const int height = argValue(args, QStringLiteral("--height"), QStringLiteral("720")).toInt();
+    const int fps = argValue(args, QStringLiteral("--fps"), QStringLiteral("30")).toInt();
+    const QString codecName =
+        argValue(args, QStringLiteral("--codec"), QStringLiteral("mpeg2")).toLower();
+    const int chaseMs =
+        argValue(args, QStringLiteral("--chase-ms"), QStringLiteral("1500")).toInt();
+    const QString jsonPath = argValue(args, QStringLiteral("--json"), QString());
+    QString outdir = argValue(args, QStringLiteral("--outdir"), QString());
+    bool useShm = !args.contains(QStringLiteral("--no-shm"));
+#ifndef Q_OS_UNIX
+    useShm = false;
+#endif
+    const bool strict = args.contains(QStringLiteral("--strict"));
+
+    if (feeds <= 0 || seconds <= 0 || width <= 0 || height <= 0 || fps <= 0) {
+        fprintf(stderr, "pipeline_bench: --feeds/--seconds/--width/--height/--fps must be > 0\n");
+        return 2;
+    }
+    if (seconds * 1000 <= kPlaybackStartMs) {
+        fprintf(stderr, "pipeline_bench: --seconds must exceed the %d ms recording lead\n",
+                kPlaybackStartMs);
+        return 2;
+    }
+    if (codecName != QStringLiteral("mpeg2") && codecName != QStringLiteral("h264")) {
+        fprintf(stderr, "pipeline_bench: --codec must be mpeg2 or h264\n");
+        return 2;
+    }
+    const VideoCodecChoice codec = codecName == QStringLiteral("h264")
+                                       ? VideoCodecChoice::H264Hardware
+                                       : VideoCodecChoice::Mpeg2Software;
+
+    QTemporaryDir tempDir;
+    if (outdir.isEmpty()) {
+        if (!tempDir.isValid()) {
+            fprintf(stderr, "pipeline_bench: cannot create a temporary directory\n");
+            return 3;
+        }
+        outdir = tempDir.path();
+    }
+    QDir().mkpath(outdir);
+
+    QStringList urls, sourceNames, viewNames;
+    QList<int> viewSlotMap;
+    for (int i = 0; i < feeds; ++i) {
+        urls << QStringLiteral("synthetic://src%1?fps=%2").arg(i).arg(fps);
+        sourceNames << QStringLiteral("SRC%1").arg(i);
+        viewNames << QStringLiteral("SRC%1").arg(i);
+        viewSlotMap << i;
+    }
+
+    ReplayManager rm;
+    rm.setSourceUrls(urls);
+    rm.setSourceNames(sourceNames);
+    rm.setViewCount(feeds);
+    rm.setViewNames(viewNames);
+    rm.setOutputDirectory(outdir);
+    rm.setBaseFileName(QStringLiteral("olr_pipeline_bench"));
+    rm.setVideoWidth(width);
+    rm.setVideoHeight(height);
+    rm.setFps(fps);
+    rm.setVideoCodec(codec);
+
+    // Latest cumulative ingest counters per source (queued to this thread).
+    QHash<int, IngestStats> ingestStats;
+    QObject::connect(&rm, &ReplayManager::sourceStatsUpdated, &app,
+                     [&ingestStats](int sourceIndex, IngestStats stats) {
+                         ingestStats.insert(sourceIndex, stats);
+                     });
+
+    QElapsedTimer wall;
+    wall.start();
+    rm.startRecording();
+    if (!rm.isRecording()) {
+        fprintf(stderr, "pipeline_bench: startRecording() failed (engine not recording)\n");
+        return 4;
+    }
+    rm.updateViewMapping(viewSlotMap);
+    const QString recordingPath = rm.getVideoPath();
+
+    QList<FrameProvider*> providers;
+    for (int i = 0; i < feeds; ++i) providers.append(new FrameProvider());
+    PlaybackTransport transport;
+    transport.setFps(fps);
+    AudioPlayer audio;
+    audio.start(48000, 2);
+    std::unique_ptr<PlaybackWorker> worker;
+    qint64 playbackStartedAtMs = -1;
+    LatencyHistogram liveLagNs;
+
+    QTimer sampler;
+    sampler.setInterval(kSampleIntervalMs);
+    QObject::connect(&sampler, &QTimer::timeout, &app, [&]() {
+        if (!worker) return;
+        liveLagNs.record((rm.getElapsedMs() - transport.currentPos()) * 1'000'000LL);
+    });
+
+    QTimer::singleShot(kPlaybackStartMs, &app, [&]() {
+        worker = std::make_unique<PlaybackWorker>(providers, &transport, &audio);
+        worker->openFile(recordingPath);
+        worker->setActiveAudioView(0);
+        QList<OutputTargetAssignment> targets;
+        if (useShm) {
+            const QString tag = QString::number(QCoreApplication::applicationPid());
+            OutputTargetAssignment pgm;
+            pgm.id = QStringLiteral("bench-pgm");
+            pgm.sourceBus = OutputBusId::pgm();
+            pgm.kind = OutputTargetKind::SharedMemory;
+            pgm.enabled = true;
+            pgm.settings.insert(QStringLiteral("segmentName"),
+                                QStringLiteral("olr-bench-pgm-%1").arg(tag));
+            OutputTargetAssignment multiview = pgm;
+            multiview.id = QStringLiteral("bench-multiview");
+            multiview.sourceBus = OutputBusId::multiview();
+            multiview.settings.insert(QStringLiteral("segmentName"),
+                                      QStringLiteral("olr-bench-mv-%1").arg(tag));
+            targets << pgm << multiview;
+        }
+        worker->setExternalOutputTargets(targets);
+        worker->start();
+        const qint64 startPos = qMax<qint64>(0, rm.getElapsedMs() - chaseMs);
+        transport.setSpeed(1.0);
+        transport.seek(startPos);
+        worker->seekTo(startPos);
+        transport.setPlaying(true);
+        playbackStartedAtMs = wall.elapsed();
+        sampler.start();
+    });
+
+    int exitCode = 0;
+    QTimer::singleShot(seconds * 1000, &app, [&]() {
+        sampler.stop();
+        const qint64 recordMs = wall.elapsed();
+        const qint64 playbackMs = playbackStartedAtMs >= 0 ? recordMs - playbackStartedAtMs : 0;
+        // Output stats must be read BEFORE stop(): the worker tears its OutputRuntime down.
+        const OutputDispatchStats os = worker ? worker->outputStats() : OutputDispatchStats{};
+        if (worker) worker->stop();
+        const PlaybackWorker::PlaybackCounters pc =
+            worker ? worker->counters() : PlaybackWorker::PlaybackCounters{};
+        rm.stopRecording(); // joins the workers and drains the muxer queue
+        const MuxerWriteStats ms = rm.muxerWriteStats();
+        const qint64 fileBytes = QFileInfo(recordingPath).size();
+
+        QJsonObject config;
+        config.insert(QStringLiteral("feeds"), feeds);
+        config.insert(QStringLiteral("width"), width);
+        config.insert(QStringLiteral("height"), height);
+        config.insert(QStringLiteral("fps"), fps);
+        config.insert(QStringLiteral("codec"), codecName);
+        config.insert(QStringLiteral("seconds"), seconds);
+        config.insert(QStringLiteral("chaseMs"), chaseMs);
+        config.insert(QStringLiteral("sharedMemorySinks"), useShm);
+        config.insert(QStringLiteral("hostThreads"), QThread::idealThreadCount());
+
+        qint64 ingestFrames = 0, ingestDrops = 0;
+        QJsonArray perSource;
+        for (int i = 0; i < feeds; ++i) {
+            const IngestStats s = ingestStats.value(i);
+            ingestFrames += s.recvTotal;
+            ingestDrops += s.dropTotal;
+            QJsonObject src;
+            src.insert(QStringLiteral("source"), i);
+            src.insert(QStringLiteral("frames"), s.recvTotal);
+            src.insert(QStringLiteral("dropped"), s.dropTotal);
+            src.insert(QStringLiteral("bytes"), qint64(s.bytesTotal));
+            perSource.append(src);
+        }
+        QJsonObject ingest;
+        ingest.insert(QStringLiteral("framesDelivered"), ingestFrames);
+        ingest.insert(QStringLiteral("framesDropped"), ingestDrops);
+        ingest.insert(QStringLiteral("framesPerSecond"), perSecond(ingestFrames, recordMs));
+        ingest.insert(QStringLiteral("sources"), perSource);
+
+        QJsonObject record;
+        record.insert(QStringLiteral("packetsQueued"), ms.packetsQueued);
+        record.insert(QStringLiteral("packetsWritten"), ms.packetsWritten);
+        record.insert(QStringLiteral("packetsPerSecond"), perSecond(ms.packetsWritten, recordMs));
+        record.insert(QStringLiteral("bytesWritten"), ms.bytesWritten);
+        record.insert(QStringLiteral("megabytesPerSecond"),
+                      perSecond(ms.bytesWritten, recordMs) / 1e6);
+        record.insert(QStringLiteral("fileBytes"), fileBytes);
+        record.insert(QStringLiteral("writeErrors"), ms.writeErrors);
+        record.insert(QStringLiteral("maxQueueDepth"), ms.maxQueueDepth);
+        record.insert(QStringLiteral("producerStalls"), ms.producerStalls);
+        record.insert(QStringLiteral("producerStallMs"), double(ms.producerStallNs) / 1e6);
+        record.insert(QStringLiteral("queueDwellUs"), percentiles(ms.queueDwellNs, 1e3));
+        record.insert(QStringLiteral("writeUs"), percentiles(ms.writeNs, 1e3));
+
+        QJsonObject playback;
+        playback.insert(QStringLiteral("seconds"), double(playbackMs) / 1000.0);
+        playback.insert(QStringLiteral("decodedVideoFrames"), pc.decodedVideoFrames);
+        playback.insert(QStringLiteral("decodedFramesPerSecond"),
+                        perSecond(pc.decodedVideoFrames, playbackMs));
+        playback.insert(QStringLiteral("framesDropped"), pc.framesDropped);
+        playback.insert(QStringLiteral("repositions"), pc.reposition);
+        playback.insert(QStringLiteral("readStalls"), pc.readStalls);
+        playback.insert(QStringLiteral("maxReadStallMs"), pc.maxReadStallMs);
+        playback.insert(QStringLiteral("liveRingPackets"), pc.liveRingPackets);
+        playback.insert(QStringLiteral("liveRingFallbacks"), pc.liveRingFallbacks);
+        playback.insert(QStringLiteral("liveLagMs"), percentiles(liveLagNs, 1e6));
+
+        qint64 sinkDropped = 0, sinkFailed = 0;
+        QJsonArray targets;
+        for (auto it = os.targets.cbegin(); it != os.targets.cend(); ++it) {
+            const OutputTargetDispatchStats& t = it.value();
+            sinkDropped += t.sinkDroppedFrames;
+            sinkFailed += t.sinkFailedFrames;
+            QJsonObject target;
+            target.insert(QStringLiteral("id"), it.key());
+            target.insert(QStringLiteral("framesSubmitted"), t.framesSubmitted);
+            target.insert(QStringLiteral("sinkSubmittedFrames"), t.sinkSubmittedFrames);
+            target.insert(QStringLiteral("sinkDroppedFrames"), t.sinkDroppedFrames);
+            target.insert(QStringLiteral("sinkFailedFrames"), t.sinkFailedFrames);
+            target.insert(QStringLiteral("maxQueueDepth"), t.maxQueueDepth);
+            target.insert(QStringLiteral("state"), t.sinkState);
+            targets.append(target);
+        }
+        QJsonObject lateness;
+        lateness.insert(QStringLiteral("p50"), double(os.runtime.latenessP50Ns) / 1e3);
+        lateness.insert(QStringLiteral("p99"), double(os.runtime.latenessP99Ns) / 1e3);
+        lateness.insert(QStringLiteral("p999"), double(os.runtime.latenessP999Ns) / 1e3);
+        lateness.insert(QStringLiteral("max"), double(os.runtime.maxLatenessNs) / 1e3);
+        QJsonObject output;
+        output.insert(QStringLiteral("ticks"), os.ticks);
+        output.insert(QStringLiteral("ticksPerSecond"), perSecond(os.ticks, playbackMs));
+        output.insert(QStringLiteral("framesSubmitted"), os.framesSubmitted);
+        output.insert(QStringLiteral("placeholderFrames"), os.placeholderFrames);
+        output.insert(QStringLiteral("heldFrames"), os.heldFrames);
+        output.insert(QStringLiteral("deadlineMisses"), os.runtime.deadlineMisses);
+        output.insert(QStringLiteral("catchUpCapHits"), os.runtime.catchUpCapHits);
+        output.insert(QStringLiteral("latenessUs"), lateness);
+        output.insert(QStringLiteral("renderP99Us"), double(os.runtime.renderP99Ns) / 1e3);
+        output.insert(QStringLiteral("sinkSubmitP99Us"), double(os.runtime.sinkSubmitP99Ns) / 1e3);
+        output.insert(QStringLiteral("targets"), targets);
+
+        QJsonObject drops;
+        drops.insert(QStringLiteral("ingestSkippedFrames"), ingestDrops);
+        drops.insert(QStringLiteral("recordProducerStalls"), ms.producerStalls);
+        drops.insert(QStringLiteral("recordWriteErrors"), ms.writeErrors);
+        drops.insert(QStringLiteral("playbackDroppedFrames"), pc.framesDropped);
+        drops.insert(QStringLiteral("outputDeadlineMisses"), os.runtime.deadlineMisses);
+        drops.insert(QStringLiteral("sinkDroppedFrames"), sinkDropped);
+        drops.insert(QStringLiteral("sinkFailedFrames"), sinkFailed);
+        const bool anyDrop = ingestDrops > 0 || ms.producerStalls > 0 || ms.writeErrors > 0 ||
+                             pc.framesDropped > 0 || os.runtime.deadlineMisses > 0 ||
+                             sinkDropped > 0 || sinkFailed > 0;
+
+        QJsonObject report;
+        report.insert(QStringLiteral("config"), config);
+        report.insert(QStringLiteral("ingest"), ingest);
+        report.insert(QStringLiteral("record"), record);
+        report.insert(QStringLiteral("playback"), playback);
+        report.insert(QStringLiteral("output"), output);
+        report.insert(QStringLiteral("drops"), drops);
+        report.insert(QStringLiteral("sustained"), !anyDrop);
+
+        const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+        if (jsonPath.isEmpty()) {
+            fwrite(json.constData(), 1, size_t(json.size()), stdout);
+            fflush(stdout);
+        } else {
+            QFile out(jsonPath);
+            if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate) || out.write(json) < 0) {
+                fprintf(stderr, "pipeline_bench: cannot write %s\n", qPrintable(jsonPath));
+                exitCode = 3;
+            }
+        }
+        if (ingestFrames == 0 || ms.packetsWritten == 0) {
+            fprintf(stderr, "pipeline_bench: the pipeline produced nothing\n");
+            exitCode = 1;
+        } else if (strict && anyDrop) {
+            fprintf(stderr, "pipeline_bench: drops reported (--strict)\n");
+            exitCode = 1;
+        }
+        worker.reset();
+        app.quit();
+    });
+
+    app.exec();
+    qDeleteAll(providers);
+    return exitCode;
+}
@@ -199,8 +199,9 @@ int main(int argc, char** argv) {
     // maxLandErr. A zero error with zero samples is vacuous and must not pass.
     auto* cutLandingSamples = new int(0);
     // armNextCut return value for armedcut-h264: 1 = armed (pre-roll bank accepted
-    // the cut), 0 = rejected (H.264 guard fired — pre-roll bank skipped H.264
-    // streams, bank empty). -1 = not applicable / armNextCut not called.
+    // the cut), 0 = rejected (no pre-roll bank: DemuxBank skipped every H.264
+    // stream for lack of a HW decoder or usable avcC). -1 = not applicable /
+    // armNextCut not called.
     int armNextCutArmed = -1;
 
     // Print the final counters in a parseable form, then quit.
@@ -89,7 +89,7 @@ trap cleanup EXIT
 # VideoToolbox/MediaFoundation — encode and decode are paired capabilities on
 # both platforms. VAC-1's codec assertion below catches any silent codec fallback.
 case "$SCENARIO" in
-    h264_play|armedcut-h264|armedcut-h264-back|gpucapstress)
+    h264_play|armedcut-h264|armedcut-h264-back|playlist-h264|gpucapstress)
         case "$(uname -s)" in
             MINGW*|MSYS*|CYGWIN*)
                 if [ "${OLR_RUN_UNSTABLE_MF_H264_TESTS:-0}" != "1" ]; then
@@ -152,13 +152,12 @@ start_producer() {
 }
 
 # PRODUCER_VCODEC controls the SRT wire format only — it does NOT change the
-# recorded fixture codec. record_harness always records an Mpeg2Software
-# mezzanine by default (no --codec flag passed here), so the pre-roll bank
-# always decodes MPEG-2 and the armed-cut gate always exercises the pre-roll
-# staging path. The armedcut override to mpeg2video keeps the SRT ingest path
-# software-decodable and production-representative; all other scenarios use
-# libx264 for the wire. Neither path exercises the pre-roll H.264 guard
-# (that guard skips H.264 fixtures; none appear here).
+# recorded fixture codec. record_harness records an Mpeg2Software mezzanine
+# unless REC_CODEC_EXTRA below passes --codec h264, so the MPEG-2 armed-cut
+# scenarios stage through FFmpeg decoders and the *-h264 ones through the
+# pre-roll bank's NativeVideoDecoder. The armedcut override to mpeg2video keeps
+# the SRT ingest path software-decodable and production-representative; all
+# other scenarios use libx264 for the wire.
 PRODUCER_VCODEC="libx264"
 [ "$SCENARIO" = "armedcut" ] && PRODUCER_VCODEC="mpeg2video"
 
@@ -184,7 +183,7 @@ sleep 1.0  # let the SRT listener come up before the caller connects
 # Written as a plain string (not an array) to stay compatible with bash 3.2 (macOS).
 REC_CODEC_EXTRA=""
 case "$SCENARIO" in
-    h264_play|armedcut-h264|armedcut-h264-back|gpucapstress) REC_CODEC_EXTRA="--codec h264" ;;
+    h264_play|armedcut-h264|armedcut-h264-back|playlist-h264|gpucapstress) REC_CODEC_EXTRA="--codec h264" ;;
 esac
 
 URL="$(srt_caller_url "$SRT_PORT")"
@@ -226,7 +225,7 @@ fi
 # would make the H.264 gate exercise the wrong codec — assert early so the test
 # fails loudly rather than passing vacuously.
 case "$SCENARIO" in
-    h264_play|armedcut-h264|armedcut-h264-back|gpucapstress)
+    h264_play|armedcut-h264|armedcut-h264-back|playlist-h264|gpucapstress)
         VCODEC="$(ffprobe -v error -select_streams v:0 -show_entries stream=codec_name \
             -of default=nk=1:nw=1 "$FIXTURE" | head -n1)"
         echo "[pb-e2e] fixture video codec: ${VCODEC:-?}"
@@ -245,6 +244,9 @@ elif [ "$SCENARIO" = "h264_play" ]; then
     # The H.264 fixture is what makes this an H.264 test; the play scenario is
     # the same as the regular 1x playback gate.
     PH_SCENARIO="play1x"
+elif [ "$SCENARIO" = "playlist-h264" ]; then
+    # Same rundown as "playlist"; every boundary stages through the native pre-roll.
+    PH_SCENARIO="playlist"
 fi
 PLAY_OUT="$("$PLAY" "$FIXTURE" "$PH_SCENARIO" "$VIEWS")"
 PLAY_RC=$?
@@ -690,7 +692,7 @@ case "$SCENARIO" in
             fail=1
         fi
         ;;
-    playlist)
+    playlist|playlist-h264)
         # EVS rundown AUTO-PLAYOUT: a 3-entry playlist (one slow-motion segment)
         # plays itself, auto-advancing across each entry boundary with a frame-perfect
         # cut that fires at the entry's out-point. Gates:
@@ -748,6 +750,15 @@ case "$SCENARIO" in
             echo "FAIL: playlist observed $cutLandingSamples boundary landing samples (expected 2 for 3 entries) — landing-error gate is vacuous"
             fail=1
         fi
+        # playlist-h264: the same bounds on an H.264 fixture prove the boundaries land
+        # with MPEG-2 accuracy; the staging floor proves they rode HW-decoded pre-roll
+        # windows (two boundaries x kStagingSpanMs) rather than a dry staging cache.
+        if [ "$SCENARIO" = "playlist-h264" ]; then
+            if ! num "$stagingVideoFramesDecoded" || [ "$stagingVideoFramesDecoded" -lt 30 ]; then
+                echo "FAIL: playlist-h264 pre-roll decoded too few staging frames (stagingVideoFramesDecoded=$stagingVideoFramesDecoded, expected >=30) — boundaries did not ride HW-decoded staging windows"
+                fail=1
+            fi
+        fi
         ;;
     gpucapstress)
         if ! num "$placeholderFramesDelta" || [ "$placeholderFramesDelta" -ne 0 ]; then
@@ -965,7 +976,7 @@ esac
 
 if [ "$GPU_RUNTIME_ENABLED" -eq 1 ]; then
     case "$SCENARIO" in
-        h264_play|armedcut-h264|armedcut-h264-back)
+        h264_play|armedcut-h264|armedcut-h264-back|playlist-h264)
             if ! num "$gpuReadToCpuCount" || [ "$gpuReadToCpuCount" -le 0 ]; then
                 echo "FAIL: GPU path produced no CPU materialization (gpuReadToCpuCount=$gpuReadToCpuCount, expected >0)"
                 fail=1
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Shared-memory output ring across processes: one shm_reader_probe publishes 1080p50 frames
+# through a real SharedMemoryOutputSink, a second attaches as a local consumer. Asserts the
+# consumer read frames, every frame it kept was intact and matched its identity, and the
+# mean publish -> read latency stayed under one frame period.
+#
+# Usage: run_shm_output_e2e.sh <shm_reader_probe_exe>
+# Env: OLR_SHM_E2E_SECONDS (default 3).
+set -uo pipefail
+
+PROBE="${1:?shm_reader_probe executable path required}"
+SECONDS_RUN="${OLR_SHM_E2E_SECONDS:-3}"
+NAME="olr-shm-e2e-$$"
+FRAME_PERIOD_US=20000
+
+"$PROBE" --write --name "$NAME" --seconds "$((SECONDS_RUN + 2))" &
+writer=$!
+trap 'kill "$writer" 2>/dev/null; wait "$writer" 2>/dev/null' EXIT
+
+OUT="$("$PROBE" --name "$NAME" --seconds "$SECONDS_RUN")"
+status=$?
+echo "$OUT"
+if ! kill -0 "$writer" 2>/dev/null; then
+    wait "$writer"
+    wstatus=$?
+    [ $wstatus -eq 77 ] && { echo "SKIP: shared-memory output unsupported"; exit 77; }
+fi
+if [ $status -ne 0 ]; then
+    echo "FAIL: reader exited $status"
+    exit 1
+fi
+
+field() { sed -n "s/.*$2=\\([0-9.-]*\\).*/\\1/p" <<<"$1"; }
+line="$(grep "^SHM " <<<"$OUT" || true)"
+[ -n "$line" ] || { echo "FAIL: missing SHM report line"; exit 1; }
+
+fail=0
+frames=$(field "$line" frames)
+mismatched=$(field "$line" mismatched)
+latency=$(field "$line" latencyUsMean)
+[ "${frames:-0}" -gt 0 ]           || { echo "FAIL: frames=$frames"; fail=1; }
+[ "${mismatched:-1}" = "0" ]       || { echo "FAIL: mismatched=$mismatched"; fail=1; }
+[ "${latency:-999999}" -lt "$FRAME_PERIOD_US" ] || {
+    echo "FAIL: latencyUsMean=$latency (>= one frame period)"; fail=1; }
+
+if [ "$fail" = "0" ]; then echo "PASS: shared-memory output ring OK"; exit 0; fi
+exit 1
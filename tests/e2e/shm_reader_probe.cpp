@@ -0,0 +1,163 @@
+// Shared-memory output ring probe. Two roles of one binary, run as separate processes by
+// run_shm_output_e2e.sh:
+//   --write : publishes synthetic bus frames through a real SharedMemoryOutputSink
+//   (default): attaches to the ring as a local consumer and reports what it saw:
+//     SHM frames=<n> dropped=<n> torn=<n> mismatched=<n> fps=<f> latencyUsMean=<n>
+//         latencyUsMax=<n>
+// Latency is publish -> read on the shared steady clock, i.e. what a local graphics or
+// analysis consumer waiting on the ring would see.
+#include "playback/output/sharedmemorysink.h"
+#include "playback/output/shmframering.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThread>
+
+#include <csignal>
+#include <cstdio>
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handleSignal(int) {
+    g_stop = 1;
+}
+
+QString argValue(const QStringList& args, const QString& name, const QString& fallback) {
+    const int index = args.indexOf(name);
+    if (index >= 0 && index + 1 < args.size()) return args.at(index + 1);
+    return fallback;
+}
+
+// The luma value encodes the output frame index, so the reader can verify every frame it
+// reads is the one the identity says it is.
+uchar lumaFor(qint64 frameIndex) {
+    return uchar(16 + (frameIndex % 200));
+}
+
+MediaAudioFrame makeAudio(qint64 frameIndex, FrameRate rate) {
+    const qint64 start = (frameIndex * qint64(48000) * rate.denominator) / rate.numerator;
+    const qint64 end = ((frameIndex + 1) * qint64(48000) * rate.denominator) / rate.numerator;
+    MediaAudioFrame audio;
+    audio.feedIndex = 0;
+    audio.startSample = start;
+    audio.pcm = QByteArray(int(end - start) * audio.channels * int(sizeof(qint16)), '\0');
+    return audio;
+}
+
+int runWriter(const QString& name, int seconds, int width, int height, int fps) {
+    const FrameRate rate = FrameRate::fromFraction(fps, 1);
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("shm-e2e");
+    assignment.kind = OutputTargetKind::SharedMemory;
+    assignment.sourceBus = OutputBusId::pgm();
+    assignment.enabled = true;
+    assignment.settings.insert(QStringLiteral("segmentName"), name);
+
+    SharedMemoryOutputSink sink;
+    if (!sink.start(assignment, rate)) {
+        fprintf(stderr, "shm_reader_probe: writer failed to start: %s\n",
+                qPrintable(sink.outputStatus().message));
+        return sink.outputStatus().state == QStringLiteral("unsupported") ? 77 : 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 deadlineMs = qint64(seconds) * 1000;
+    for (qint64 frameIndex = 0; !g_stop && timer.elapsed() < deadlineMs; ++frameIndex) {
+        const qint64 dueMs = rate.frameIndexToMs(frameIndex);
+        while (!g_stop && timer.elapsed() < dueMs) QThread::usleep(500);
+
+        OutputBusFrame frame;
+        frame.bus = OutputBusId::pgm();
+        frame.outputFrameIndex = frameIndex;
+        frame.sampledPlayheadMs = dueMs;
+        frame.programmeTimecode100ns = dueMs * 10000;
+        frame.video = solidYuv420pHandle(width, height, lumaFor(frameIndex), 128, 128);
+        frame.video.metadata().outputFrameIndex = frameIndex;
+        frame.audio = makeAudio(frameIndex, rate);
+        if (!sink.submit(frame)) {
+            fprintf(stderr, "shm_reader_probe: publish failed at frame %lld: %s\n",
+                    static_cast<long long>(frameIndex), qPrintable(sink.outputStatus().message));
+            return 1;
+        }
+    }
+    fprintf(stderr, "[shm-writer] published=%lld\n",
+            static_cast<long long>(sink.outputStatus().acceptedFrames));
+    return 0;
+}
+
+int runReader(const QString& name, int seconds) {
+    ShmFrameRingReader reader;
+    QString error;
+    QElapsedTimer attach;
+    attach.start();
+    while (!reader.open(name, &error)) {
+        if (g_stop || attach.elapsed() > 5000) {
+            fprintf(stderr, "shm_reader_probe: %s\n", qPrintable(error));
+            return 1;
+        }
+        QThread::msleep(20);
+    }
+
+    qint64 frames = 0;
+    qint64 torn = 0;
+    qint64 mismatched = 0;
+    qint64 latencySumNs = 0;
+    qint64 latencyMaxNs = 0;
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 deadlineMs = qint64(seconds) * 1000;
+    while (!g_stop && timer.elapsed() < deadlineMs && reader.writerOpen()) {
+        if (!reader.waitForFrame(100)) continue;
+        ShmFrameView view;
+        while (reader.readNext(&view)) {
+            const qint64 latencyNs = shmring::steadyClockNs() - view.publishedAtNs;
+            const bool matches = view.width > 0 && view.plane[0] &&
+                                 view.plane[0][0] == lumaFor(view.identity.outputFrameIndex);
+            if (!reader.isIntact(view)) {
+                ++torn;
+                continue;
+            }
+            ++frames;
+            if (!matches) ++mismatched;
+            latencySumNs += latencyNs;
+            latencyMaxNs = qMax(latencyMaxNs, latencyNs);
+        }
+    }
+
+    const double elapsedSec = qMax<qint64>(1, timer.elapsed()) / 1000.0;
+    printf("SHM frames=%lld dropped=%llu torn=%lld mismatched=%lld fps=%.2f "
+           "latencyUsMean=%lld latencyUsMax=%lld\n",
+           static_cast<long long>(frames), static_cast<unsigned long long>(reader.dropped()),
+           static_cast<long long>(torn), static_cast<long long>(mismatched),
+           double(frames) / elapsedSec,
+           static_cast<long long>(frames > 0 ? latencySumNs / frames / 1000 : 0),
+           static_cast<long long>(latencyMaxNs / 1000));
+    return frames > 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const QString name = argValue(args, QStringLiteral("--name"), QStringLiteral("olr-shm-e2e"));
+    const int seconds = argValue(args, QStringLiteral("--seconds"), QStringLiteral("3")).toInt();
+    const int width = argValue(args, QStringLiteral("--width"), QStringLiteral("1920")).toInt();
+    const int height = argValue(args, QStringLiteral("--height"), QStringLiteral("1080")).toInt();
+    const int fps = argValue(args, QStringLiteral("--fps"), QStringLiteral("50")).toInt();
+    if (seconds <= 0 || width <= 0 || height <= 0 || fps <= 0) {
+        fprintf(stderr, "shm_reader_probe: invalid arguments\n");
+        return 2;
+    }
+
+    if (args.contains(QStringLiteral("--write")))
+        return runWriter(name, seconds, width, height, fps);
+    return runReader(name, seconds);
+}
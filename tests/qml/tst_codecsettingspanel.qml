@@ -153,6 +153,22 @@ TestCase {
                "shows H.264 not-benchmarked line: " + txt.text)
         verify(txt.text.indexOf("-1 safe feeds") < 0,
                "does not show sentinel safe-feed count: " + txt.text)
+        verify(txt.text.indexOf("Recording volume") < 0,
+               "no storage line when the volume was not measured: " + txt.text)
+    }
+
+    function test_storage_stage_renders() {
+        mock.benchmarkResult = {
+            "recommended": "mpeg2",
+            "mpeg2SafeFeeds": 8,
+            "h264Available": false,
+            "storageSafeFeeds": 4,
+            "storageWriteMBps": 61.4
+        }
+        var p = makePanel()
+        var txt = findChild(p, "benchmarkResultText")
+        verify(txt.text.indexOf("Recording volume: 4 safe feeds (61 MB/s)") >= 0,
+               "shows recording-volume line: " + txt.text)
     }
 
     function test_empty_result_shows_not_benchmarked() {
@@ -17,6 +17,7 @@ Rectangle {
         id: rundownModel
         ListElement {
             index: 0
+            clipPath: "/rec/goal-cam3.mkv"
             label: "goal-cam3.mkv"
             inMs: 5000
             outMs: 12000
@@ -27,6 +28,7 @@ Rectangle {
         }
         ListElement {
             index: 1
+            clipPath: "/rec/save-cam1.mkv"
             label: "save-cam1.mkv"
             inMs: 22000
             outMs: 27500
@@ -37,6 +39,7 @@ Rectangle {
         }
         ListElement {
             index: 2
+            clipPath: "/rec/open-final.mkv"
             label: "open-final.mkv"
             inMs: 31000
             outMs: -1
@@ -57,6 +60,9 @@ Rectangle {
         property bool playlistPlayoutActive: true
         property bool playlistDirty: true
         property string playlistOperationError: ""
+        property bool exportActive: false
+        property real exportProgress: 0
+        property bool h264EncodeAvailable: true
 
         function recordTimecode(ms) {
             if (ms < 0) return "OPEN"
@@ -75,6 +81,8 @@ Rectangle {
         function insertPlaylistEntryAt(index) {}
         function recallEntry(index) {}
         function removePlaylistEntry(index) {}
+        function exportPlaylistEntry(index) { return true }
+        function transcodePlaylistEntry(index) { return true }
         function movePlaylistEntry(fromIndex, toIndex) {}
         function setPlaylistEntrySpeed(index, speed) {}
         function setPlaylistEntryInFromPlayhead(index) {}
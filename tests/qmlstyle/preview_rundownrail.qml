@@ -14,6 +14,7 @@ Rectangle {
         id: rundownModel
         ListElement {
             index: 0
+            clipPath: "/rec/goal-cam3.mkv"
             label: "goal-cam3.mkv"
             inMs: 5000
             outMs: 12000
@@ -24,6 +25,7 @@ Rectangle {
         }
         ListElement {
             index: 1
+            clipPath: "/rec/save-cam1.mkv"
             label: "save-cam1.mkv"
             inMs: 22000
             outMs: 27500
@@ -34,6 +36,7 @@ Rectangle {
         }
         ListElement {
             index: 2
+            clipPath: "/rec/open-final.mkv"
             label: "open-final.mkv"
             inMs: 31000
             outMs: -1
@@ -55,6 +58,9 @@ Rectangle {
         property bool playlistDirty: true
         property string playlistFilePath: "/clips/final-rundown.json"
         property string playlistOperationError: ""
+        property bool exportActive: false
+        property real exportProgress: 0
+        property bool h264EncodeAvailable: true
 
         function recordTimecode(ms) {
             if (ms < 0) return "OPEN"
@@ -73,6 +79,8 @@ Rectangle {
         function insertPlaylistEntryAt(index) {}
         function recallEntry(index) {}
         function removePlaylistEntry(index) {}
+        function exportPlaylistEntry(index) { return true }
+        function transcodePlaylistEntry(index) { return true }
         function movePlaylistEntry(fromIndex, toIndex) {}
         function setPlaylistEntrySpeed(index, speed) {}
         function setPlaylistEntryInFromPlayhead(index) {}
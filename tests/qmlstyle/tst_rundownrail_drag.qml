@@ -14,6 +14,7 @@ TestCase {
         id: rundownModel
         ListElement {
             index: 0
+            clipPath: "/rec/a.mkv"
             label: "a.mkv"
             inMs: 0
             outMs: 1000
@@ -24,6 +25,7 @@ TestCase {
         }
         ListElement {
             index: 1
+            clipPath: "/rec/b.mkv"
             label: "b.mkv"
             inMs: 2000
             outMs: 3000
@@ -34,6 +36,7 @@ TestCase {
         }
         ListElement {
             index: 2
+            clipPath: "/rec/c.mkv"
             label: "c.mkv"
             inMs: 4000
             outMs: 5000
@@ -54,6 +57,9 @@ TestCase {
         property bool playlistPlayoutActive: false
         property bool playlistDirty: false
         property string playlistOperationError: ""
+        property bool exportActive: false
+        property real exportProgress: 0
+        property bool h264EncodeAvailable: true
         property int moveCount: 0
         property int lastFrom: -1
         property int lastTo: -1
@@ -67,6 +73,8 @@ TestCase {
         function insertPlaylistEntryAt(index) {}
         function recallEntry(index) {}
         function removePlaylistEntry(index) {}
+        function exportPlaylistEntry(index) { return true }
+        function transcodePlaylistEntry(index) { return true }
         function setPlaylistEntrySpeed(index, speed) {}
         function setPlaylistEntryInFromPlayhead(index) {}
         function setPlaylistEntryOutFromPlayhead(index) {}
@@ -90,6 +90,20 @@ TestCase {
         function recordTimecode(ms) { return String(ms) }
     }
 
+    QtObject {
+        id: uiWithThumbnails
+
+        property int recordedDurationMs: 61000
+        property int liveBufferMs: 1000
+        property int scrubPosition: 15000
+        property int thumbnailRevision: 3
+        property int playbackSelectedIndex: 1
+
+        function seekPlayback(ms) {}
+        function endScrubGesture() {}
+        function recordTimecode(ms) { return String(ms) }
+    }
+
     ScrubTimeline {
         id: timeline
         width: tc.width
@@ -245,4 +259,16 @@ TestCase {
         compare(Math.round(timeline.xToMs(timeline.width)), 60000)
         compare(findChild(timeline, "closedRegion"), null)
     }
+
+    function test_filmstripOnlyWithThumbnailIndex() {
+        var filmstrip = findChild(timeline, "filmstrip")
+        verify(filmstrip !== null)
+        verify(!filmstrip.visible) // mockUi has no thumbnailRevision
+
+        timeline.ui = uiWithThumbnails
+        wait(0)
+        verify(filmstrip.visible)
+        compare(filmstrip.view, 1)
+        verify(filmstrip.cellWidth > 0)
+    }
 }
@@ -0,0 +1,155 @@
+#include <QtTest>
+
+#include "playback/audioplayer.h"
+
+#include <atomic>
+
+namespace {
+
+QByteArray filled(int bytes, char value) {
+    return QByteArray(bytes, value);
+}
+
+QByteArray readExactly(AudioRingBuffer& ring, qint64 bytes) {
+    QByteArray out(int(bytes), Qt::Uninitialized);
+    const qint64 n = ring.read(out.data(), bytes);
+    out.resize(int(qMax<qint64>(0, n)));
+    return out;
+}
+
+} // namespace
+
+class TestAudioRingBuffer : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void underrunPadsSilenceAndAccruesDebt();
+    void capTrimKeepsNewestAndFlagsOverflow();
+    void clearDropsDataAndDebt();
+    void addUnderrunDebtIsCapped();
+    void concurrentPushAndReadKeepOrder();
+
+private:
+    std::unique_ptr<AudioRingBuffer> m_ring;
+};
+
+void TestAudioRingBuffer::init() {
+    m_ring = std::make_unique<AudioRingBuffer>();
+    // Read straight through readData() so QIODevice does not pull ahead into its own buffer.
+    m_ring->close();
+    m_ring->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void TestAudioRingBuffer::underrunPadsSilenceAndAccruesDebt() {
+    // Before any stream data, padding is not an underrun.
+    QCOMPARE(readExactly(*m_ring, 32), filled(32, '\0'));
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(0));
+
+    const QByteArray data = filled(100, '\x11');
+    m_ring->push(data.constData(), data.size());
+    QCOMPARE(m_ring->bytesAvailable(), qint64(100));
+
+    const QByteArray out = readExactly(*m_ring, 160);
+    QCOMPARE(out.size(), 160);
+    QCOMPARE(out.left(100), data);
+    QCOMPARE(out.mid(100), filled(60, '\0'));
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(60));
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(0));
+}
+
+void TestAudioRingBuffer::capTrimKeepsNewestAndFlagsOverflow() {
+    m_ring->setMaxBufBytes(64);
+    const QByteArray first = filled(48, 'a');
+    const QByteArray second = filled(32, 'b');
+    m_ring->push(first.constData(), first.size());
+    QVERIFY(!m_ring->takeOverflowed());
+    m_ring->push(second.constData(), second.size());
+    QVERIFY(m_ring->takeOverflowed());
+    QVERIFY(!m_ring->takeOverflowed());
+
+    QCOMPARE(m_ring->bytesAvailable(), qint64(64));
+    QCOMPARE(readExactly(*m_ring, 64), filled(32, 'a') + filled(32, 'b'));
+
+    // A single push larger than the cap keeps only its newest bytes.
+    QByteArray big = filled(40, 'x') + filled(64, 'y');
+    m_ring->push(big.constData(), big.size());
+    QVERIFY(m_ring->takeOverflowed());
+    QCOMPARE(readExactly(*m_ring, 64), filled(64, 'y'));
+}
+
+void TestAudioRingBuffer::clearDropsDataAndDebt() {
+    const QByteArray data = filled(40, '\x22');
+    m_ring->push(data.constData(), data.size());
+    readExactly(*m_ring, 100);
+    m_ring->push(data.constData(), data.size());
+
+    m_ring->clear();
+    QCOMPARE(m_ring->bytesAvailable(), qint64(0));
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(0));
+    // The stream is inactive until the next push, so this silence is not debt.
+    QCOMPARE(readExactly(*m_ring, 64), filled(64, '\0'));
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(0));
+}
+
+void TestAudioRingBuffer::addUnderrunDebtIsCapped() {
+    m_ring->setMaxBufBytes(1000);
+    m_ring->addUnderrunDebt(600);
+    m_ring->addUnderrunDebt(600);
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(1000));
+    m_ring->addUnderrunDebt(-5);
+    QCOMPARE(m_ring->takeUnderrunDebt(), qint64(0));
+}
+
+void TestAudioRingBuffer::concurrentPushAndReadKeepOrder() {
+    // A producer thread pushes a running sample counter (never 0) while this thread reads
+    // like the audio device: every sample must arrive once and in order, with only
+    // silence (0) between runs.
+    m_ring->setMaxBufBytes(1 << 20);
+    constexpr int kChunkSamples = 480;
+    constexpr int kChunks = 2000;
+    constexpr qint64 kTotalSamples = qint64(kChunkSamples) * kChunks;
+    std::atomic<bool> producerDone{false};
+
+    std::unique_ptr<QThread> producer(QThread::create([&]() {
+        QVector<qint16> chunk(kChunkSamples);
+        qint64 next = 0;
+        for (int c = 0; c < kChunks; ++c) {
+            // Pace like PlaybackWorker does, so the safety cap never trims.
+            while (m_ring->bytesAvailable() > (1 << 19)) QThread::usleep(100);
+            for (qint16& sample : chunk) sample = qint16(next++ % 32767 + 1);
+            m_ring->push(reinterpret_cast<const char*>(chunk.constData()),
+                         qint64(chunk.size()) * qint64(sizeof(qint16)));
+            if (c % 64 == 0) QThread::usleep(200);
+        }
+        producerDone = true;
+    }));
+    producer->start();
+
+    qint64 received = 0;
+    qint16 last = 0;
+    bool ordered = true;
+    bool fullReads = true;
+    QVector<qint16> buffer(256);
+    QElapsedTimer timer;
+    timer.start();
+    while ((!producerDone || m_ring->bytesAvailable() > 0) && timer.elapsed() < 10000) {
+        const qint64 n = m_ring->read(reinterpret_cast<char*>(buffer.data()),
+                                      qint64(buffer.size()) * qint64(sizeof(qint16)));
+        if (n != qint64(buffer.size()) * qint64(sizeof(qint16))) fullReads = false;
+        for (const qint16 sample : buffer) {
+            if (sample == 0) continue;
+            if (received > 0 && sample != qint16(last % 32767 + 1)) ordered = false;
+            last = sample;
+            received++;
+        }
+    }
+    producer->wait();
+
+    QVERIFY2(fullReads, "readData must always satisfy the full request");
+    QVERIFY(ordered);
+    QCOMPARE(received, kTotalSamples);
+    QVERIFY(!m_ring->takeOverflowed());
+}
+
+QTEST_GUILESS_MAIN(TestAudioRingBuffer)
+#include "tst_audioringbuffer.moc"
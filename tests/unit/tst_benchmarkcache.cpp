@@ -32,6 +32,12 @@ void TestBenchmarkCache::roundTrip() {
     in.resolution = "1920x1080@30";
     in.timestamp = "2026-06-19T00:00:00Z";
     in.ceilingReached = true;
+    in.storageSafeFeeds = 8;
+    in.storageWriteMBps = 412.5;
+    in.storageWriteP99Ms = 3.25;
+    in.storageWriteMaxMs = 41.0;
+    in.storageDirectory = "/Volumes/Replay";
+    in.threadPlacement = "output 7,15; playback 0-6,8-14; sources 0-6,8-14";
     QVERIFY(saveBenchmarkResult(path, in));
     CodecBenchmarkResult out;
     QVERIFY(loadBenchmarkResult(path, out));
@@ -47,6 +53,12 @@ void TestBenchmarkCache::roundTrip() {
     QCOMPARE(out.resolution, in.resolution);
     QCOMPARE(out.timestamp, in.timestamp);
     QCOMPARE(out.ceilingReached, true);
+    QCOMPARE(out.storageSafeFeeds, 8);
+    QCOMPARE(out.storageWriteMBps, 412.5);
+    QCOMPARE(out.storageWriteP99Ms, 3.25);
+    QCOMPARE(out.storageWriteMaxMs, 41.0);
+    QCOMPARE(out.storageDirectory, in.storageDirectory);
+    QCOMPARE(out.threadPlacement, in.threadPlacement);
 }
 
 void TestBenchmarkCache::invalidatesOnDeviceOrResolutionChange() {
@@ -56,6 +68,11 @@ void TestBenchmarkCache::invalidatesOnDeviceOrResolutionChange() {
     QVERIFY(benchmarkResultMatches(c, "ChipA arm64", "1920x1080@30"));
     QVERIFY(!benchmarkResultMatches(c, "ChipB arm64", "1920x1080@30"));
     QVERIFY(!benchmarkResultMatches(c, "ChipA arm64", "1280x720@30"));
+    // Feed counts measured on floating threads do not stand for a pinned run, or vice versa.
+    QVERIFY(!benchmarkResultMatches(c, "ChipA arm64", "1920x1080@30", "output 7,15"));
+    c.threadPlacement = "output 7,15";
+    QVERIFY(benchmarkResultMatches(c, "ChipA arm64", "1920x1080@30", "output 7,15"));
+    QVERIFY(!benchmarkResultMatches(c, "ChipA arm64", "1920x1080@30"));
 }
 
 void TestBenchmarkCache::deviceLabelIsNonEmpty() {
@@ -97,6 +114,11 @@ void TestBenchmarkCache::loadMissingKeysYieldsDocumentedDefaults() {
     // h264Available and ceilingReached default to false per toBool() fallback
     QCOMPARE(out.h264Available, false);
     QCOMPARE(out.ceilingReached, false);
+    // Caches written before the storage stage existed read as "not measured".
+    QCOMPARE(out.storageSafeFeeds, -1);
+    QVERIFY(out.storageDirectory.isEmpty());
+    // ...and as measured on floating threads, so they still match an unpinned run.
+    QVERIFY(out.threadPlacement.isEmpty());
 }
 
 QTEST_GUILESS_MAIN(TestBenchmarkCache)
@@ -0,0 +1,406 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "playback/export/clipexporter.h"
+
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/dict.h>
+}
+
+namespace {
+constexpr int kFps = 50;
+constexpr int kFrameMs = 1000 / kFps;
+constexpr int kAudioBytesPerFrame = 48000 / kFps * 2 * 2;
+constexpr int kTelemetryEveryMs = 500;
+
+// A picture start code (so MPEG-TS readers' MPEG-2 parser splits one packet per frame) and
+// the packet's view and source PTS as text, free of further start codes.
+QByteArray videoTag(int view, qint64 ptsMs) {
+    return QByteArray("\x00\x00\x01\x00", 4) +
+           QStringLiteral("olr view=%1 pts=%2;").arg(view).arg(ptsMs).toLatin1();
+}
+
+bool parseVideoTag(const AVPacket* pkt, qint32& view, qint32& ptsMs) {
+    const QByteArray payload(reinterpret_cast<const char*>(pkt->data), pkt->size);
+    const int at = payload.indexOf("olr view=");
+    return at >= 0 && sscanf(payload.constData() + at, "olr view=%d pts=%d;", &view, &ptsMs) == 2;
+}
+
+// Writes a recording with the Muxer's track layout (N video, N PCM audio, N metadata text,
+// one feed telemetry text track) and stand-in intra payloads: every video packet carries
+// its view and PTS (videoTag) so an export can be checked packet by packet. Clusters are cut as the
+// Muxer cuts them (100 ms).
+bool writeRecording(const QString& path, int views, qint64 durationMs, int videoBytes) {
+    AVFormatContext* ctx = nullptr;
+    const QByteArray encodedPath = path.toUtf8();
+    if (avformat_alloc_output_context2(&ctx, nullptr, "matroska", encodedPath.constData()) < 0)
+        return false;
+    const auto freeContext = qScopeGuard([&ctx] {
+        if (ctx->pb) avio_closep(&ctx->pb);
+        avformat_free_context(ctx);
+    });
+    const auto addStream = [&](AVMediaType type, AVCodecID codec, const QString& title) {
+        AVStream* st = avformat_new_stream(ctx, nullptr);
+        st->codecpar->codec_type = type;
+        st->codecpar->codec_id = codec;
+        st->time_base = AVRational{1, 1000};
+        av_dict_set(&st->metadata, "title", title.toUtf8().constData(), 0);
+        return st;
+    };
+    for (int v = 0; v < views; ++v) {
+        AVStream* st = addStream(AVMEDIA_TYPE_VIDEO, AV_CODEC_ID_MPEG2VIDEO,
+                                 QStringLiteral("Track %1").arg(v + 1));
+        st->codecpar->width = 1920;
+        st->codecpar->height = 1080;
+        st->codecpar->format = AV_PIX_FMT_YUV420P;
+        st->avg_frame_rate = st->r_frame_rate = AVRational{kFps, 1};
+    }
+    for (int v = 0; v < views; ++v) {
+        AVStream* st = addStream(AVMEDIA_TYPE_AUDIO, AV_CODEC_ID_PCM_S16LE,
+                                 QStringLiteral("Track %1 Audio").arg(v + 1));
+        st->codecpar->sample_rate = 48000;
+        st->codecpar->format = AV_SAMPLE_FMT_S16;
+        av_channel_layout_default(&st->codecpar->ch_layout, 2);
+    }
+    for (int v = 0; v < views; ++v) {
+        addStream(AVMEDIA_TYPE_SUBTITLE, AV_CODEC_ID_TEXT,
+                  QStringLiteral("Track %1 Metadata").arg(v + 1));
+    }
+    AVStream* telemetry = addStream(AVMEDIA_TYPE_SUBTITLE, AV_CODEC_ID_TEXT,
+                                    QStringLiteral("Feed cam Telemetry"));
+    av_dict_set(&telemetry->metadata, "olr_track_type", "feed_telemetry", 0);
+    av_dict_set(&telemetry->metadata, "olr_feed_id", "cam", 0);
+
+    if (avio_open(&ctx->pb, encodedPath.constData(), AVIO_FLAG_WRITE) < 0) return false;
+    AVDictionary* options = nullptr;
+    av_dict_set(&options, "cluster_size_limit", "1M", 0);
+    av_dict_set(&options, "cluster_time_limit", "100", 0);
+    const int headerRet = avformat_write_header(ctx, &options);
+    av_dict_free(&options);
+    if (headerRet < 0) return false;
+
+    AVPacket* pkt = av_packet_alloc();
+    const auto freePacket = qScopeGuard([&pkt] { av_packet_free(&pkt); });
+    const auto write = [&](int stream, qint64 ptsMs, const QByteArray& payload) {
+        if (av_new_packet(pkt, int(payload.size())) < 0) return false;
+        memcpy(pkt->data, payload.constData(), size_t(payload.size()));
+        pkt->stream_index = stream;
+        pkt->pts = pkt->dts = av_rescale_q(ptsMs, AVRational{1, 1000},
+                                           ctx->streams[stream]->time_base);
+        pkt->duration = av_rescale_q(kFrameMs, AVRational{1, 1000},
+                                     ctx->streams[stream]->time_base);
+        pkt->flags |= AV_PKT_FLAG_KEY;
+        return av_write_frame(ctx, pkt) >= 0;
+    };
+    for (qint64 pts = 0; pts < durationMs; pts += kFrameMs) {
+        for (int v = 0; v < views; ++v) {
+            QByteArray video = videoTag(v, pts);
+            video.append(QByteArray(qMax(0, videoBytes - int(video.size())), 'x'));
+            if (!write(v, pts, video)) return false;
+            if (!write(views + v, pts, QByteArray(kAudioBytesPerFrame, char(v)))) return false;
+            if (!write(2 * views + v, pts, QByteArrayLiteral("{}"))) return false;
+        }
+        if (pts % kTelemetryEveryMs == 0 &&
+            !write(3 * views, pts, QByteArrayLiteral("{\"feedId\":\"cam\"}"))) {
+            return false;
+        }
+    }
+    return av_write_trailer(ctx) >= 0;
+}
+
+// View-0 PTS -> packet byte offset, built while reading as PlaybackWorker builds its own.
+bool indexRecording(const QString& path, FrameIndex& index) {
+    AVFormatContext* ctx = nullptr;
+    const QByteArray encodedPath = path.toUtf8();
+    if (avformat_open_input(&ctx, encodedPath.constData(), nullptr, nullptr) < 0) return false;
+    const auto closeInput = qScopeGuard([&ctx] { avformat_close_input(&ctx); });
+    AVPacket* pkt = av_packet_alloc();
+    while (av_read_frame(ctx, pkt) >= 0) {
+        if (pkt->stream_index == 0 && pkt->pos >= 0) {
+            index.append(av_rescale_q(pkt->pts, ctx->streams[0]->time_base,
+                                      AVRational{1, 1000}),
+                         pkt->pos);
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+    return index.size() > 0;
+}
+
+struct ExportedFile {
+    QList<AVMediaType> trackTypes;
+    QList<QPair<qint32, qint32>> videoTags; // (view, source PTS) of every video packet
+    QList<qint64> videoPtsMs;
+    int audioPackets = 0;
+    int textPackets = 0;
+};
+
+bool readExport(const QString& path, ExportedFile& file) {
+    AVFormatContext* ctx = nullptr;
+    const QByteArray encodedPath = path.toUtf8();
+    if (avformat_open_input(&ctx, encodedPath.constData(), nullptr, nullptr) < 0) return false;
+    const auto closeInput = qScopeGuard([&ctx] { avformat_close_input(&ctx); });
+    if (avformat_find_stream_info(ctx, nullptr) < 0) return false;
+    for (unsigned int i = 0; i < ctx->nb_streams; ++i)
+        file.trackTypes << ctx->streams[i]->codecpar->codec_type;
+    AVPacket* pkt = av_packet_alloc();
+    while (av_read_frame(ctx, pkt) >= 0) {
+        const AVStream* st = ctx->streams[pkt->stream_index];
+        qint32 view = -1;
+        qint32 sourcePtsMs = -1;
+        if (st->codecpar->codec_type == AVMEDIA_TYPE_VIDEO &&
+            parseVideoTag(pkt, view, sourcePtsMs)) {
+            file.videoTags << qMakePair(view, sourcePtsMs);
+            file.videoPtsMs << av_rescale_q(pkt->pts, st->time_base, AVRational{1, 1000});
+        } else if (st->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            file.audioPackets++;
+        } else if (st->codecpar->codec_type == AVMEDIA_TYPE_SUBTITLE) {
+            file.textPackets++;
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+    return true;
+}
+} // namespace
+
+class TestClipExporter : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void containerFollowsSuffix();
+    void exportsExactRangeOfSelectedView();
+    void exportsEveryViewByDefault();
+    void keepsAudioOverlappingTheInPoint();
+    void frameIndexSeekMatchesContainerSeek();
+    void containersWithoutPcmOrTextSkipThoseTracks();
+    void invalidRequestsFailWithoutOutput();
+    void backgroundExportReportsProgressAndFinishes();
+    void twentySecondClipExportsWellUnderASecond();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_recording;
+    FrameIndex m_index;
+};
+
+void TestClipExporter::initTestCase() {
+    QVERIFY(m_dir.isValid());
+    m_recording = m_dir.filePath(QStringLiteral("recording.mkv"));
+    QVERIFY(writeRecording(m_recording, 2, 4000, 4096));
+    QVERIFY(indexRecording(m_recording, m_index));
+}
+
+void TestClipExporter::containerFollowsSuffix() {
+    QCOMPARE(ClipExporter::containerForPath(QStringLiteral("a/clip.MKV")),
+             std::optional<ClipExportContainer>(ClipExportContainer::Matroska));
+    QCOMPARE(ClipExporter::containerForPath(QStringLiteral("clip.mov")),
+             std::optional<ClipExportContainer>(ClipExportContainer::QuickTime));
+    QCOMPARE(ClipExporter::containerForPath(QStringLiteral("clip.ts")),
+             std::optional<ClipExportContainer>(ClipExportContainer::MpegTs));
+    QVERIFY(!ClipExporter::containerForPath(QStringLiteral("clip.mp4")).has_value());
+}
+
+void TestClipExporter::exportsExactRangeOfSelectedView() {
+    ClipExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 1000;
+    request.entry.outMs = 2000;
+    request.views = {1};
+    request.outputPath = m_dir.filePath(QStringLiteral("view1.mkv"));
+    ClipExporter exporter(request);
+    const ClipExportResult result = exporter.exportNow();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.firstPtsMs, qint64(1000));
+    QCOMPARE(result.lastPtsMs, qint64(2000 - kFrameMs));
+    QVERIFY(result.skippedTracks.isEmpty());
+
+    ExportedFile file;
+    QVERIFY(readExport(request.outputPath, file));
+    // One view's video, audio and metadata plus the feed telemetry track.
+    QCOMPARE(file.trackTypes, (QList<AVMediaType>{AVMEDIA_TYPE_VIDEO, AVMEDIA_TYPE_AUDIO,
+                                                  AVMEDIA_TYPE_SUBTITLE, AVMEDIA_TYPE_SUBTITLE}));
+    QCOMPARE(file.videoTags.size(), 1000 / kFrameMs);
+    for (int i = 0; i < file.videoTags.size(); ++i) {
+        QCOMPARE(file.videoTags[i].first, 1);
+        QCOMPARE(file.videoTags[i].second, qint32(1000 + i * kFrameMs));
+        QCOMPARE(file.videoPtsMs[i], qint64(i * kFrameMs)); // rebased to start at 0
+    }
+    QCOMPARE(file.audioPackets, 1000 / kFrameMs);
+    QCOMPARE(file.textPackets, 1000 / kFrameMs + 1000 / kTelemetryEveryMs);
+}
+
+void TestClipExporter::exportsEveryViewByDefault() {
+    ClipExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 3000;
+    request.entry.outMs = -1; // to the end of the file
+    request.includeMetadata = false;
+    request.outputPath = m_dir.filePath(QStringLiteral("all.mkv"));
+    ClipExporter exporter(request);
+    const ClipExportResult result = exporter.exportNow();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.lastPtsMs, qint64(4000 - kFrameMs));
+
+    ExportedFile file;
+    QVERIFY(readExport(request.outputPath, file));
+    QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_VIDEO), 2);
+    QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_AUDIO), 2);
+    QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_SUBTITLE), 0);
+    QCOMPARE(file.videoTags.size(), 2 * 1000 / kFrameMs);
+}
+
+void TestClipExporter::keepsAudioOverlappingTheInPoint() {
+    ClipExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 1000 + kFrameMs / 2; // inside the audio packet at 1000 ms
+    request.entry.outMs = 2000;
+    request.views = {0};
+    request.includeMetadata = false;
+    request.outputPath = m_dir.filePath(QStringLiteral("overlap.mkv"));
+    ClipExporter exporter(request);
+    const ClipExportResult result = exporter.exportNow();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.firstPtsMs, qint64(1000 + kFrameMs));
+
+    ExportedFile file;
+    QVERIFY(readExport(request.outputPath, file));
+    QCOMPARE(file.videoTags.size(), 1000 / kFrameMs - 1);
+    // The packet at 1000 ms holds the in-point's samples, so it is kept.
+    QCOMPARE(file.audioPackets, 1000 / kFrameMs);
+}
+
+void TestClipExporter::frameIndexSeekMatchesContainerSeek() {
+    ExportedFile viaIndex;
+    ExportedFile viaContainer;
+    for (const bool useIndex : {true, false}) {
+        ClipExportRequest request;
+        request.entry.clipPath = m_recording;
+        request.entry.inMs = 2210;
+        request.entry.outMs = 2710;
+        request.outputPath = m_dir.filePath(useIndex ? QStringLiteral("indexed.mkv")
+                                                     : QStringLiteral("sought.mkv"));
+        ClipExporter exporter(request);
+        if (useIndex) exporter.setFrameIndex(m_index);
+        const ClipExportResult result = exporter.exportNow();
+        QVERIFY2(result.ok, qPrintable(result.error));
+        QCOMPARE(result.firstPtsMs, qint64(2220)); // first frame at or after inMs
+        QVERIFY(readExport(request.outputPath, useIndex ? viaIndex : viaContainer));
+    }
+    QCOMPARE(viaIndex.videoTags, viaContainer.videoTags);
+    QCOMPARE(viaIndex.audioPackets, viaContainer.audioPackets);
+    QCOMPARE(viaIndex.textPackets, viaContainer.textPackets);
+}
+
+void TestClipExporter::containersWithoutPcmOrTextSkipThoseTracks() {
+    for (const QString& name : {QStringLiteral("clip.mov"), QStringLiteral("clip.ts")}) {
+        ClipExportRequest request;
+        request.entry.clipPath = m_recording;
+        request.entry.inMs = 500;
+        request.entry.outMs = 1500;
+        request.views = {0};
+        request.outputPath = m_dir.filePath(name);
+        ClipExporter exporter(request);
+        const ClipExportResult result = exporter.exportNow();
+        QVERIFY2(result.ok, qPrintable(name + QLatin1String(": ") + result.error));
+
+        ExportedFile file;
+        QVERIFY(readExport(request.outputPath, file));
+        QCOMPARE(file.videoTags.size(), 1000 / kFrameMs);
+        QCOMPARE(file.videoTags.first(), qMakePair(qint32(0), qint32(500)));
+        QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_SUBTITLE), 0);
+        QVERIFY(!result.skippedTracks.isEmpty());
+        if (name.endsWith(QLatin1String(".ts"))) {
+            // PCM has no stream-copy mapping in MPEG-TS.
+            QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_AUDIO), 0);
+            QCOMPARE(result.skippedTracks.size(), 3);
+        } else {
+            QCOMPARE(file.trackTypes.count(AVMEDIA_TYPE_AUDIO), 1);
+            QCOMPARE(result.skippedTracks.size(), 2);
+        }
+    }
+}
+
+void TestClipExporter::invalidRequestsFailWithoutOutput() {
+    ClipExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 1000;
+    request.entry.outMs = 900;
+    request.outputPath = m_dir.filePath(QStringLiteral("backwards.mkv"));
+    QVERIFY(!ClipExporter(request).exportNow().ok);
+
+    request.entry.outMs = 2000;
+    request.outputPath = m_dir.filePath(QStringLiteral("clip.avi"));
+    QVERIFY(!ClipExporter(request).exportNow().ok);
+
+    request.outputPath = m_dir.filePath(QStringLiteral("noview.mkv"));
+    request.views = {7};
+    const ClipExportResult result = ClipExporter(request).exportNow();
+    QVERIFY(!result.ok);
+    QVERIFY(!QFile::exists(request.outputPath));
+
+    request.views.clear();
+    request.entry.inMs = 9000; // past the end
+    request.entry.outMs = 9500;
+    request.outputPath = m_dir.filePath(QStringLiteral("empty.mkv"));
+    QVERIFY(!ClipExporter(request).exportNow().ok);
+    QVERIFY(!QFile::exists(request.outputPath));
+}
+
+void TestClipExporter::backgroundExportReportsProgressAndFinishes() {
+    ClipExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 0;
+    request.entry.outMs = 4000;
+    request.outputPath = m_dir.filePath(QStringLiteral("background.mkv"));
+    ClipExporter exporter(request);
+    QSignalSpy progress(&exporter, &ClipExporter::progress);
+    QSignalSpy finished(&exporter, &ClipExporter::exportFinished);
+    exporter.start();
+    QVERIFY(exporter.wait(10000));
+    QCOMPARE(finished.size(), 1);
+    QCOMPARE(finished.first().at(0).toBool(), true);
+    QVERIFY(exporter.result().ok);
+
+    QVERIFY(progress.size() >= 2);
+    double previous = -1.0;
+    for (const QList<QVariant>& args : progress) {
+        const double fraction = args.at(0).toDouble();
+        QVERIFY(fraction > previous && fraction <= 1.0);
+        previous = fraction;
+    }
+    QCOMPARE(previous, 1.0);
+}
+
+void TestClipExporter::twentySecondClipExportsWellUnderASecond() {
+    // A single-view 1080p50 all-intra recording at ~24 Mb/s (60 KB per frame); the
+    // 20-second clip is ~60 MB of video.
+    const QString recording = m_dir.filePath(QStringLiteral("long.mkv"));
+    QVERIFY(writeRecording(recording, 1, 25000, 60 * 1024));
+
+    ClipExportRequest request;
+    request.entry.clipPath = recording;
+    request.entry.inMs = 2000;
+    request.entry.outMs = 22000;
+    request.outputPath = m_dir.filePath(QStringLiteral("twenty.mkv"));
+    ClipExporter exporter(request);
+    QElapsedTimer timer;
+    timer.start();
+    const ClipExportResult result = exporter.exportNow();
+    const qint64 elapsedMs = timer.elapsed();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.lastPtsMs - result.firstPtsMs, qint64(20000 - kFrameMs));
+    qInfo().noquote() << QStringLiteral("stream-copy export: 20 s clip, %1 MB in %2 ms")
+                             .arg(double(result.bytesWritten) / (1024 * 1024), 0, 'f', 1)
+                             .arg(elapsedMs);
+    QVERIFY2(elapsedMs < 1000, qPrintable(QString::number(elapsedMs)));
+}
+
+QTEST_GUILESS_MAIN(TestClipExporter)
+#include "tst_clipexporter.moc"
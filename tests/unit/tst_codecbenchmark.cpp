@@ -65,6 +65,7 @@ private slots:
     void unavailableRunnerYieldsNoFeeds();
     void cancelReachesRunStep();        // T-cancel (C1 wiring)
     void runStepObservesCancelInLoop(); // T-cancel: in-loop observation
+    void maxConcurrencyCapsRamp();
 };
 
 void TestCodecBenchmark::stopsAtFirstFailingStep() {
@@ -155,5 +156,18 @@ void TestCodecBenchmark::runStepObservesCancelInLoop() {
     QVERIFY(runner.loopIterations < 50);
 }
 
+void TestCodecBenchmark::maxConcurrencyCapsRamp() {
+    FakeRunner runner(32, 32);
+    BenchmarkConfig cfg;
+    cfg.fps = 30;
+    cfg.durationMsPerStep = 1000;
+    cfg.maxConcurrency = 12;
+    std::atomic<bool> cancel{false};
+    auto res = CodecBenchmark::rampCodec(runner, cfg, [](int, bool) {}, cancel);
+    QCOMPARE(runner.visited, (QVector<int>{1, 2, 4, 8, 12}));
+    QCOMPARE(res.safeFeeds, 12);
+    QVERIFY(!res.ceilingReached); // capped, not the end of the ramp
+}
+
 QTEST_GUILESS_MAIN(TestCodecBenchmark)
 #include "tst_codecbenchmark.moc"
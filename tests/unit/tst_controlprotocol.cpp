@@ -1,4 +1,7 @@
 #include <QtTest>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 
@@ -14,11 +17,17 @@ private slots:
     void validatesSeekArgsAcceptsLargeInteger();
     void rejectsSeekWithFractionalPosition();
     void rejectsSeekWithoutPosition();
+    void validatesTransportChannelArg();
     void validatesHoldSpeedReleaseWithoutSpeed();
     void rejectsHoldSpeedStartWithoutSpeed();
     void validatesActionDispatchDefaultsPressed();
     void rejectsActionDispatchForShuttleId();
     void validatesActionShuttleDelta();
+    void validatesDiagnosticsTraceArgs();
+    void dumpTraceRejectsPaths();
+    void validatesExportClipArgs();
+    void parsesAndValidatesSubscribe();
+    void parsesCborCommand();
     void buildsSuccessAck();
     void buildsFailureAck();
     void buildsErrorWithoutId();
@@ -100,6 +109,29 @@ void TestControlProtocol::rejectsSeekWithoutPosition() {
     QVERIFY(validation.message.contains(QStringLiteral("positionMs")));
 }
 
+void TestControlProtocol::validatesTransportChannelArg() {
+    const ControlCommandMessage seek{
+        QStringLiteral("command"), QStringLiteral("seek-ch1"), QStringLiteral("transport.seek"),
+        QJsonObject{{QStringLiteral("positionMs"), 42}, {QStringLiteral("channel"), 1}}};
+    QVERIFY(ControlProtocol::validateCommand(seek).ok);
+
+    const ControlCommandMessage select{
+        QStringLiteral("command"), QStringLiteral("select-ch1"), QStringLiteral("view.selectFeed"),
+        QJsonObject{{QStringLiteral("index"), 2}, {QStringLiteral("channel"), 1}}};
+    QVERIFY(ControlProtocol::validateCommand(select).ok);
+
+    for (const QJsonValue& bad : {QJsonValue(-1), QJsonValue(1.5), QJsonValue("1")}) {
+        const ControlCommandMessage play{QStringLiteral("command"), QStringLiteral("play-bad"),
+                                         QStringLiteral("transport.play"),
+                                         QJsonObject{{QStringLiteral("channel"), bad}}};
+        const ControlProtocol::CommandValidation validation =
+            ControlProtocol::validateCommand(play);
+        QVERIFY(!validation.ok);
+        QCOMPARE(validation.code, QStringLiteral("invalid_args"));
+        QVERIFY(validation.message.contains(QStringLiteral("channel")));
+    }
+}
+
 void TestControlProtocol::validatesHoldSpeedReleaseWithoutSpeed() {
     const ControlCommandMessage command{QStringLiteral("command"), QStringLiteral("hold-release"),
                                         QStringLiteral("transport.holdSpeed"),
@@ -158,6 +190,152 @@ void TestControlProtocol::validatesActionShuttleDelta() {
     QCOMPARE(validation.normalizedArgs.value(QStringLiteral("delta")).toInt(), -1);
 }
 
+void TestControlProtocol::validatesDiagnosticsTraceArgs() {
+    const ControlCommandMessage enable{QStringLiteral("command"), QStringLiteral("trace-1"),
+                                       QStringLiteral("diagnostics.trace"),
+                                       QJsonObject{{QStringLiteral("enabled"), true}}};
+    QVERIFY(ControlProtocol::validateCommand(enable).ok);
+
+    const ControlCommandMessage missing{QStringLiteral("command"), QStringLiteral("trace-2"),
+                                        QStringLiteral("diagnostics.trace"), QJsonObject{}};
+    const ControlProtocol::CommandValidation rejected = ControlProtocol::validateCommand(missing);
+    QVERIFY(!rejected.ok);
+    QCOMPARE(rejected.code, QStringLiteral("invalid_args"));
+
+    const ControlCommandMessage dump{QStringLiteral("command"), QStringLiteral("trace-3"),
+                                     QStringLiteral("diagnostics.dumpTrace"), QJsonObject{}};
+    QVERIFY(ControlProtocol::validateCommand(dump).ok);
+
+    const ControlCommandMessage badName{QStringLiteral("command"), QStringLiteral("trace-4"),
+                                        QStringLiteral("diagnostics.dumpTrace"),
+                                        QJsonObject{{QStringLiteral("name"), 5}}};
+    QVERIFY(!ControlProtocol::validateCommand(badName).ok);
+
+    const ControlCommandMessage named{QStringLiteral("command"), QStringLiteral("trace-5"),
+                                      QStringLiteral("diagnostics.dumpTrace"),
+                                      QJsonObject{{QStringLiteral("name"),
+                                                   QStringLiteral("olr-trace.json")}}};
+    QVERIFY(ControlProtocol::validateCommand(named).ok);
+
+    const ControlCommandMessage latency{QStringLiteral("command"), QStringLiteral("latency-1"),
+                                        QStringLiteral("diagnostics.latency"), QJsonObject{}};
+    QVERIFY(ControlProtocol::validateCommand(latency).ok);
+}
+
+void TestControlProtocol::dumpTraceRejectsPaths() {
+    // The control socket is unauthenticated: a client may only name the file, never
+    // point the write somewhere else.
+    for (const QString& name :
+         {QStringLiteral("../olr-trace.json"), QStringLiteral("../../etc/passwd"),
+          QStringLiteral("/etc/passwd"), QStringLiteral("traces/olr.json"),
+          QStringLiteral("..\\olr.json"), QStringLiteral("C:\\olr.json"), QStringLiteral(".."),
+          QStringLiteral("  ")}) {
+        const ControlCommandMessage dump{QStringLiteral("command"), QStringLiteral("trace-6"),
+                                         QStringLiteral("diagnostics.dumpTrace"),
+                                         QJsonObject{{QStringLiteral("name"), name}}};
+        const ControlProtocol::CommandValidation validation =
+            ControlProtocol::validateCommand(dump);
+        QVERIFY2(!validation.ok, qPrintable(name));
+        QCOMPARE(validation.code, QStringLiteral("invalid_args"));
+    }
+
+    // The old path argument is refused outright.
+    const ControlCommandMessage path{QStringLiteral("command"), QStringLiteral("trace-7"),
+                                     QStringLiteral("diagnostics.dumpTrace"),
+                                     QJsonObject{{QStringLiteral("path"),
+                                                  QStringLiteral("/tmp/olr-trace.json")}}};
+    QVERIFY(!ControlProtocol::validateCommand(path).ok);
+    QVERIFY(ControlProtocol::isBareFileName(QStringLiteral("trace-20261018.json")));
+}
+
+void TestControlProtocol::validatesExportClipArgs() {
+    const auto validate = [](const QJsonObject& args) {
+        return ControlProtocol::validateCommand(ControlCommandMessage{
+            QStringLiteral("command"), QStringLiteral("export-1"), QStringLiteral("export.clip"),
+            args});
+    };
+    QVERIFY(validate(QJsonObject{{QStringLiteral("index"), 0}}).ok);
+    QVERIFY(validate(QJsonObject{{QStringLiteral("index"), 2},
+                                 {QStringLiteral("name"), QStringLiteral("goal.mov")},
+                                 {QStringLiteral("views"), QJsonArray{0, 2}}})
+                .ok);
+
+    QVERIFY(validate(QJsonObject{{QStringLiteral("index"), 1},
+                                 {QStringLiteral("mode"), QStringLiteral("transcode")}})
+                .ok);
+
+    QVERIFY(!validate(QJsonObject{}).ok);
+    QVERIFY(!validate(QJsonObject{{QStringLiteral("index"), -1}}).ok);
+    QVERIFY(!validate(QJsonObject{{QStringLiteral("index"), 1},
+                                  {QStringLiteral("mode"), QStringLiteral("h264")}})
+                 .ok);
+    QVERIFY(!validate(QJsonObject{{QStringLiteral("index"), 0},
+                                  {QStringLiteral("name"), QStringLiteral("../goal.mkv")}})
+                 .ok);
+    QVERIFY(!validate(QJsonObject{{QStringLiteral("index"), 0},
+                                  {QStringLiteral("views"), QJsonArray{0, 1.5}}})
+                 .ok);
+    QVERIFY(!validate(QJsonObject{{QStringLiteral("index"), 0},
+                                  {QStringLiteral("views"), 1}})
+                 .ok);
+
+    const ControlCommandMessage cancel{QStringLiteral("command"), QStringLiteral("export-2"),
+                                       QStringLiteral("export.cancel"), QJsonObject{}};
+    QVERIFY(ControlProtocol::validateCommand(cancel).ok);
+}
+
+void TestControlProtocol::parsesAndValidatesSubscribe() {
+    const auto parsed = ControlProtocol::parseTextMessage(
+        R"({"type":"subscribe","id":"sub-1","topics":["transport","sources"],"encoding":"cbor"})");
+    QVERIFY(parsed.ok);
+    QCOMPARE(parsed.message.type, QStringLiteral("subscribe"));
+    QCOMPARE(parsed.message.id, QStringLiteral("sub-1"));
+
+    const ControlProtocol::Subscription subscription =
+        ControlProtocol::validateSubscription(parsed.message);
+    QVERIFY(subscription.ok);
+    QCOMPARE(subscription.topics,
+             QSet<QString>({QStringLiteral("transport"), QStringLiteral("sources")}));
+    QVERIFY(subscription.cbor);
+
+    // Encoding defaults to JSON; an empty topic list is a valid "nothing but acks".
+    const auto quiet = ControlProtocol::parseTextMessage(R"({"type":"subscribe","topics":[]})");
+    QVERIFY(quiet.ok);
+    const ControlProtocol::Subscription none = ControlProtocol::validateSubscription(quiet.message);
+    QVERIFY(none.ok);
+    QVERIFY(none.topics.isEmpty());
+    QVERIFY(!none.cbor);
+
+    for (const char* bad : {R"({"type":"subscribe"})",
+                            R"({"type":"subscribe","topics":["outputs"]})",
+                            R"({"type":"subscribe","topics":["transport"],"encoding":"xml"})"}) {
+        const auto message = ControlProtocol::parseTextMessage(bad);
+        QVERIFY(message.ok);
+        const ControlProtocol::Subscription rejected =
+            ControlProtocol::validateSubscription(message.message);
+        QVERIFY2(!rejected.ok, bad);
+        QCOMPARE(rejected.code, QStringLiteral("invalid_args"));
+    }
+}
+
+void TestControlProtocol::parsesCborCommand() {
+    QCborMap map;
+    map.insert(QStringLiteral("type"), QStringLiteral("command"));
+    map.insert(QStringLiteral("id"), QStringLiteral("cbor-1"));
+    map.insert(QStringLiteral("name"), QStringLiteral("transport.seek"));
+    map.insert(QStringLiteral("args"), QCborMap{{QStringLiteral("positionMs"), 500}});
+
+    const auto parsed = ControlProtocol::parseBinaryMessage(map.toCborValue().toCbor());
+    QVERIFY(parsed.ok);
+    QCOMPARE(parsed.message.id, QStringLiteral("cbor-1"));
+    QCOMPARE(parsed.message.name, QStringLiteral("transport.seek"));
+    QVERIFY(ControlProtocol::validateCommand(parsed.message).ok);
+
+    const auto notAMap = ControlProtocol::parseBinaryMessage(QCborValue(5).toCbor());
+    QVERIFY(!notAMap.ok);
+    QCOMPARE(notAMap.code, QStringLiteral("unsupported_message"));
+}
+
 void TestControlProtocol::buildsSuccessAck() {
     const QJsonObject ack = ControlProtocol::ack(QStringLiteral("abc-1"));
 
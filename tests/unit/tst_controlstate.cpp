@@ -9,7 +9,8 @@ class FakeControlAdapter final : public ControlApiAdapter {
 public:
     RecordingState recordingState() const override { return {true, 1500, 1700000000123}; }
     TransportState transportState() const override {
-        return {1200, 1200, 1500, QStringLiteral("00:00:01:06"), true, 1.0, 30, true, 1000};
+        return {1200, 1200, 1500, QStringLiteral("00:00:01:06"), true, 1.0, 30, true, 1000,
+                QVector<PlaybackChannelState>{{1, 400, false, 0.5}}};
     }
     QVector<SourceState> sourceStates() const override {
         SourceState s;
@@ -66,6 +67,9 @@ private slots:
     void buildsSnapshotWithExpectedTopLevelObjects();
     void buildsPathPatch();
     void buildsTimecodeMessageFromTransport();
+    void transportListsOtherPlaybackChannels();
+    void mergePatchCarriesOnlyChangedMembers();
+    void snapshotStateHasEverySection();
 };
 
 void TestControlState::buildsSnapshotWithExpectedTopLevelObjects() {
@@ -128,5 +132,63 @@ void TestControlState::buildsTimecodeMessageFromTransport() {
     QCOMPARE(msg.value(QStringLiteral("followLive")).toBool(), true);
 }
 
+void TestControlState::transportListsOtherPlaybackChannels() {
+    FakeControlAdapter adapter;
+
+    const QJsonObject transport = ControlState::transportObject(adapter);
+    const QJsonArray channels = transport.value(QStringLiteral("channels")).toArray();
+
+    QCOMPARE(channels.size(), 1);
+    const QJsonObject channel = channels.first().toObject();
+    QCOMPARE(channel.value(QStringLiteral("channel")).toInt(), 1);
+    QCOMPARE(channel.value(QStringLiteral("positionMs")).toInt(), 400);
+    QCOMPARE(channel.value(QStringLiteral("playing")).toBool(), false);
+    QCOMPARE(channel.value(QStringLiteral("speed")).toDouble(), 0.5);
+}
+
+void TestControlState::mergePatchCarriesOnlyChangedMembers() {
+    const QJsonObject before{{QStringLiteral("playing"), false},
+                             {QStringLiteral("speed"), 1.0},
+                             {QStringLiteral("nested"), QJsonObject{{QStringLiteral("a"), 1},
+                                                                    {QStringLiteral("b"), 2}}},
+                             {QStringLiteral("gone"), 5}};
+    const QJsonObject after{{QStringLiteral("playing"), true},
+                            {QStringLiteral("speed"), 1.0},
+                            {QStringLiteral("nested"), QJsonObject{{QStringLiteral("a"), 1},
+                                                                   {QStringLiteral("b"), 3}}}};
+
+    const QJsonObject patch = ControlState::mergePatch(before, after).toObject();
+    QCOMPARE(patch.size(), 3);
+    QCOMPARE(patch.value(QStringLiteral("playing")).toBool(), true);
+    QCOMPARE(patch.value(QStringLiteral("nested")).toObject(),
+             QJsonObject({{QStringLiteral("b"), 3}}));
+    QVERIFY(patch.value(QStringLiteral("gone")).isNull());
+
+    QVERIFY(ControlState::mergePatch(after, after).isUndefined());
+    // Arrays are replaced whole; a section seen for the first time is sent whole.
+    const QJsonArray sources{QJsonObject{{QStringLiteral("index"), 0}}};
+    QCOMPARE(ControlState::mergePatch(QJsonArray{}, sources).toArray(), sources);
+    QCOMPARE(ControlState::mergePatch(QJsonValue(QJsonValue::Undefined), after).toObject(), after);
+
+    const QJsonObject msg = ControlState::mergeMessage(QStringLiteral("transport"), patch);
+    QCOMPARE(msg.value(QStringLiteral("type")).toString(), QStringLiteral("state.merge"));
+    QCOMPARE(msg.value(QStringLiteral("path")).toString(), QStringLiteral("transport"));
+    QCOMPARE(msg.value(QStringLiteral("patch")).toObject(), patch);
+}
+
+void TestControlState::snapshotStateHasEverySection() {
+    FakeControlAdapter adapter;
+    const QJsonObject state = ControlState::stateObject(adapter);
+    QStringList keys = state.keys();
+    QStringList sections = ControlState::sectionNames();
+    keys.sort();
+    sections.sort();
+    QCOMPARE(keys, sections);
+    QCOMPARE(ControlState::snapshotMessage(adapter).value(QStringLiteral("state")).toObject(),
+             state);
+    QCOMPARE(ControlState::eventTopic(QStringLiteral("diagnostics.traceDumped")),
+             QStringLiteral("diagnostics"));
+}
+
 QTEST_GUILESS_MAIN(TestControlState)
 #include "tst_controlstate.moc"
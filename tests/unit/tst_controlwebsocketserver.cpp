@@ -1,12 +1,21 @@
 #include <QtTest>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
 #include <QHostAddress>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QSignalSpy>
 #include <QWebSocket>
 
+#include <memory>
+#include <vector>
+
+#include "playback/playbacktransport.h"
 #include "websocket/controlapiadapter.h"
 #include "websocket/controlstate.h"
+#include "websocket/controltransportpublisher.h"
 #include "websocket/controlwebsocketserver.h"
 
 class ServerFakeAdapter final : public QObject, public ControlApiAdapter {
@@ -14,10 +23,18 @@ public:
     QString lastCommand;
     QJsonObject lastArgs;
 
+    TransportState transport{0, 0, 0, QStringLiteral("00:00:00:00"), false, 1.0, 30, false, 1000};
+    PlaybackTransport* channelTransport = nullptr; // channel 1, when set
+
     RecordingState recordingState() const override { return {}; }
 
     TransportState transportState() const override {
-        return {0, 0, 0, QStringLiteral("00:00:00:00"), false, 1.0, 30, false, 1000};
+        TransportState state = transport;
+        if (channelTransport) {
+            state.channels.append({1, channelTransport->currentPos(),
+                                   channelTransport->isPlaying(), channelTransport->speed()});
+        }
+        return state;
     }
 
     QVector<SourceState> sourceStates() const override { return {}; }
@@ -39,6 +56,12 @@ public:
     CommandResult executeCommand(const QString& name, const QJsonObject& args) override {
         lastCommand = name;
         lastArgs = args;
+        if (channelTransport && args.value(QStringLiteral("channel")).toInt() == 1) {
+            if (name == QStringLiteral("transport.seek"))
+                channelTransport->seek(args.value(QStringLiteral("positionMs")).toInteger());
+            else if (name == QStringLiteral("transport.setSpeed"))
+                channelTransport->setSpeed(args.value(QStringLiteral("speed")).toDouble());
+        }
         return CommandResult::success();
     }
 };
@@ -52,8 +75,42 @@ private slots:
     void sendsErrorForBadJson();
     void publishEventBroadcastsToAllSockets();
     void rejectsBinaryMessageAsUnsupported();
+    void subscriberGetsMergesForItsTopicsOnly();
+    void cborSubscriberGetsBinaryFrames();
+    void fiftyClientsGetOneCoalescedMergePerTurn();
+    void channelCommandPublishesTransportChannels();
+
+private:
+    static QJsonObject decodeText(const QSignalSpy& spy, int index);
+    static QJsonObject decodeCbor(const QSignalSpy& spy, int index);
+    // The `transport.channels[0]` of the first transport patch at or after `from`.
+    static QJsonObject channelPatch(const QSignalSpy& spy, int from);
 };
 
+QJsonObject TestControlWebSocketServer::decodeText(const QSignalSpy& spy, int index) {
+    return QJsonDocument::fromJson(spy.at(index).at(0).toString().toUtf8()).object();
+}
+
+QJsonObject TestControlWebSocketServer::decodeCbor(const QSignalSpy& spy, int index) {
+    return QCborValue::fromCbor(spy.at(index).at(0).toByteArray()).toMap().toJsonObject();
+}
+
+QJsonObject TestControlWebSocketServer::channelPatch(const QSignalSpy& spy, int from) {
+    for (int i = from; i < spy.count(); ++i) {
+        const QJsonObject message = decodeText(spy, i);
+        if (message.value(QStringLiteral("type")).toString() != QStringLiteral("state.patch") ||
+            message.value(QStringLiteral("path")).toString() != QStringLiteral("transport")) {
+            continue;
+        }
+        const QJsonArray channels = message.value(QStringLiteral("value"))
+                                        .toObject()
+                                        .value(QStringLiteral("channels"))
+                                        .toArray();
+        if (!channels.isEmpty()) return channels.first().toObject();
+    }
+    return {};
+}
+
 void TestControlWebSocketServer::sendsSnapshotAndTimecodeOnConnect() {
     ServerFakeAdapter adapter;
     ControlWebSocketServer server(&adapter);
@@ -207,5 +264,202 @@ void TestControlWebSocketServer::rejectsBinaryMessageAsUnsupported() {
     QCOMPARE(err.value(QStringLiteral("code")).toString(), QStringLiteral("unsupported_message"));
 }
 
+void TestControlWebSocketServer::subscriberGetsMergesForItsTopicsOnly() {
+    ServerFakeAdapter adapter;
+    ControlWebSocketServer server(&adapter);
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QUrl url(QStringLiteral("ws://127.0.0.1:%1/api/ws").arg(server.serverPort()));
+
+    QWebSocket legacy;
+    QWebSocket subscriber;
+    QSignalSpy legacyMessages(&legacy, &QWebSocket::textMessageReceived);
+    QSignalSpy messages(&subscriber, &QWebSocket::textMessageReceived);
+    legacy.open(url);
+    subscriber.open(url);
+    QTRY_COMPARE_WITH_TIMEOUT(legacyMessages.count(), 2, 2000);
+    QTRY_COMPARE_WITH_TIMEOUT(messages.count(), 2, 2000);
+
+    subscriber.sendTextMessage(
+        QStringLiteral("{\"type\":\"subscribe\",\"id\":\"sub-1\",\"topics\":[\"transport\"]}"));
+    QTRY_COMPARE_WITH_TIMEOUT(messages.count(), 5, 2000);
+    QCOMPARE(decodeText(messages, 2).value(QStringLiteral("type")).toString(),
+             QStringLiteral("ack"));
+    const QJsonObject snapshot = decodeText(messages, 3);
+    QCOMPARE(snapshot.value(QStringLiteral("type")).toString(), QStringLiteral("state.snapshot"));
+    QCOMPARE(snapshot.value(QStringLiteral("state")).toObject().keys(),
+             QStringList({QStringLiteral("transport")}));
+    QCOMPARE(decodeText(messages, 4).value(QStringLiteral("type")).toString(),
+             QStringLiteral("timecode"));
+
+    // Three patches of the same path in one turn are one message; the subscriber's is only
+    // the member that changed, and topics it did not ask for never reach it.
+    adapter.transport.playing = true;
+    server.publishPatch(QStringLiteral("transport"));
+    server.publishPatch(QStringLiteral("transport"));
+    server.publishPatch(QStringLiteral("settings"));
+    server.publishPatch(QStringLiteral("transport"));
+    server.publishEvent(QStringLiteral("recording.started"));
+    server.publishEvent(QStringLiteral("transport.marker"));
+
+    QTRY_COMPARE_WITH_TIMEOUT(messages.count(), 7, 2000);
+    const QJsonObject merge = decodeText(messages, 5);
+    QCOMPARE(merge.value(QStringLiteral("type")).toString(), QStringLiteral("state.merge"));
+    QCOMPARE(merge.value(QStringLiteral("path")).toString(), QStringLiteral("transport"));
+    QCOMPARE(merge.value(QStringLiteral("patch")).toObject(),
+             QJsonObject({{QStringLiteral("playing"), true}}));
+    QCOMPARE(decodeText(messages, 6).value(QStringLiteral("name")).toString(),
+             QStringLiteral("transport.marker"));
+
+    // Unsubscribed clients keep the full patches and every event, in publish order.
+    QTRY_COMPARE_WITH_TIMEOUT(legacyMessages.count(), 6, 2000);
+    QCOMPARE(decodeText(legacyMessages, 2).value(QStringLiteral("path")).toString(),
+             QStringLiteral("transport"));
+    QCOMPARE(decodeText(legacyMessages, 2)
+                 .value(QStringLiteral("value"))
+                 .toObject()
+                 .value(QStringLiteral("playing"))
+                 .toBool(),
+             true);
+    QCOMPARE(decodeText(legacyMessages, 3).value(QStringLiteral("path")).toString(),
+             QStringLiteral("settings"));
+    QCOMPARE(decodeText(legacyMessages, 4).value(QStringLiteral("name")).toString(),
+             QStringLiteral("recording.started"));
+    QCOMPARE(decodeText(legacyMessages, 5).value(QStringLiteral("name")).toString(),
+             QStringLiteral("transport.marker"));
+    QTest::qWait(50);
+    QCOMPARE(messages.count(), 7);
+}
+
+void TestControlWebSocketServer::cborSubscriberGetsBinaryFrames() {
+    ServerFakeAdapter adapter;
+    ControlWebSocketServer server(&adapter);
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    QWebSocket socket;
+    QSignalSpy text(&socket, &QWebSocket::textMessageReceived);
+    QSignalSpy binary(&socket, &QWebSocket::binaryMessageReceived);
+    socket.open(QUrl(QStringLiteral("ws://127.0.0.1:%1/api/ws").arg(server.serverPort())));
+    QTRY_COMPARE_WITH_TIMEOUT(text.count(), 2, 2000);
+
+    QCborMap subscribe;
+    subscribe.insert(QStringLiteral("type"), QStringLiteral("subscribe"));
+    subscribe.insert(QStringLiteral("id"), QStringLiteral("sub-cbor"));
+    subscribe.insert(QStringLiteral("topics"), QCborArray{QStringLiteral("*")});
+    subscribe.insert(QStringLiteral("encoding"), QStringLiteral("cbor"));
+    socket.sendBinaryMessage(subscribe.toCborValue().toCbor());
+
+    QTRY_COMPARE_WITH_TIMEOUT(binary.count(), 3, 2000);
+    QCOMPARE(decodeCbor(binary, 0).value(QStringLiteral("id")).toString(),
+             QStringLiteral("sub-cbor"));
+    QCOMPARE(decodeCbor(binary, 1).value(QStringLiteral("state")).toObject().size(),
+             ControlState::sectionNames().size());
+    QCOMPARE(decodeCbor(binary, 2).value(QStringLiteral("type")).toString(),
+             QStringLiteral("timecode"));
+
+    adapter.transport.speed = 0.5;
+    server.publishPatch(QStringLiteral("transport"));
+    QTRY_COMPARE_WITH_TIMEOUT(binary.count(), 4, 2000);
+    QCOMPARE(decodeCbor(binary, 3).value(QStringLiteral("patch")).toObject(),
+             QJsonObject({{QStringLiteral("speed"), 0.5}}));
+    QCOMPARE(text.count(), 2);
+}
+
+void TestControlWebSocketServer::fiftyClientsGetOneCoalescedMergePerTurn() {
+    constexpr int kClients = 50;
+    constexpr int kTurns = 20;
+    ServerFakeAdapter adapter;
+    ControlWebSocketServer server(&adapter);
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QUrl url(QStringLiteral("ws://127.0.0.1:%1/api/ws").arg(server.serverPort()));
+
+    // Half JSON, half CBOR; all on the transport topic.
+    std::vector<std::unique_ptr<QWebSocket>> sockets;
+    std::vector<std::unique_ptr<QSignalSpy>> spies;
+    for (int i = 0; i < kClients; ++i) {
+        sockets.push_back(std::make_unique<QWebSocket>());
+        QWebSocket* socket = sockets.back().get();
+        spies.push_back(std::make_unique<QSignalSpy>(
+            socket, i % 2 ? &QWebSocket::binaryMessageReceived : &QWebSocket::textMessageReceived));
+        socket->open(url);
+    }
+    for (int i = 0; i < kClients; ++i) {
+        if (i % 2 == 0) {
+            QTRY_COMPARE_WITH_TIMEOUT(spies[size_t(i)]->count(), 2, 5000);
+        } else {
+            QTRY_VERIFY_WITH_TIMEOUT(
+                sockets[size_t(i)]->state() == QAbstractSocket::ConnectedState, 5000);
+        }
+        const QString encoding = i % 2 ? QStringLiteral("cbor") : QStringLiteral("json");
+        sockets[size_t(i)]->sendTextMessage(
+            QStringLiteral("{\"type\":\"subscribe\",\"topics\":[\"transport\"],"
+                           "\"encoding\":\"%1\"}")
+                .arg(encoding));
+    }
+    // JSON clients: connect snapshot + timecode, then ack, snapshot, timecode; CBOR clients
+    // get the last three as binary frames.
+    for (int i = 0; i < kClients; ++i) {
+        QTRY_COMPARE_WITH_TIMEOUT(spies[size_t(i)]->count(), i % 2 ? 3 : 5, 5000);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int turn = 1; turn <= kTurns; ++turn) {
+        adapter.transport.positionMs = turn * 40;
+        for (int i = 0; i < 5; ++i) server.publishPatch(QStringLiteral("transport"));
+        for (int i = 0; i < kClients; ++i) {
+            QTRY_COMPARE_WITH_TIMEOUT(spies[size_t(i)]->count(), (i % 2 ? 3 : 5) + turn, 5000);
+        }
+    }
+    qInfo() << kClients << "clients," << kTurns << "turns in" << timer.elapsed() << "ms";
+
+    for (int i = 0; i < kClients; ++i) {
+        const QSignalSpy& spy = *spies[size_t(i)];
+        const QJsonObject last = i % 2 ? decodeCbor(spy, spy.count() - 1)
+                                       : decodeText(spy, spy.count() - 1);
+        QCOMPARE(last.value(QStringLiteral("type")).toString(), QStringLiteral("state.merge"));
+        QCOMPARE(last.value(QStringLiteral("patch")).toObject(),
+                 QJsonObject({{QStringLiteral("positionMs"), kTurns * 40}}));
+    }
+}
+
+void TestControlWebSocketServer::channelCommandPublishesTransportChannels() {
+    ServerFakeAdapter adapter;
+    PlaybackTransport channel;
+    adapter.channelTransport = &channel;
+    ControlWebSocketServer server(&adapter);
+    ControlTransportPublisher publisher(&server);
+    publisher.watch(&channel, 1);
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+
+    QWebSocket socket;
+    QSignalSpy messages(&socket, &QWebSocket::textMessageReceived);
+    socket.open(QUrl(QStringLiteral("ws://127.0.0.1:%1/api/ws").arg(server.serverPort())));
+    QTRY_COMPARE_WITH_TIMEOUT(messages.count(), 2, 2000);
+
+    // A channel's speed is published at once, its position within kPositionPatchMs.
+    int from = messages.count();
+    socket.sendTextMessage(QStringLiteral(
+        "{\"type\":\"command\",\"id\":\"ch1-speed\",\"name\":\"transport.setSpeed\","
+        "\"args\":{\"channel\":1,\"speed\":0.5}}"));
+    QTRY_VERIFY_WITH_TIMEOUT(!channelPatch(messages, from).isEmpty(), 2000);
+    QCOMPARE(channelPatch(messages, from).value(QStringLiteral("speed")).toDouble(), 0.5);
+    // The patch the command caused is ahead of its ack.
+    QTRY_VERIFY_WITH_TIMEOUT(decodeText(messages, messages.count() - 1)
+                                     .value(QStringLiteral("type"))
+                                     .toString() == QStringLiteral("ack"),
+                             2000);
+    QCOMPARE(decodeText(messages, from).value(QStringLiteral("type")).toString(),
+             QStringLiteral("state.patch"));
+
+    from = messages.count();
+    socket.sendTextMessage(QStringLiteral(
+        "{\"type\":\"command\",\"id\":\"ch1-seek\",\"name\":\"transport.seek\","
+        "\"args\":{\"channel\":1,\"positionMs\":4200}}"));
+    QTRY_VERIFY_WITH_TIMEOUT(!channelPatch(messages, from).isEmpty(), 2000);
+    const QJsonObject seeked = channelPatch(messages, from);
+    QCOMPARE(seeked.value(QStringLiteral("channel")).toInt(), 1);
+    QCOMPARE(seeked.value(QStringLiteral("positionMs")).toInteger(), qint64(4200));
+}
+
 QTEST_GUILESS_MAIN(TestControlWebSocketServer)
 #include "tst_controlwebsocketserver.moc"
@@ -0,0 +1,109 @@
+#include <QtTest>
+
+#include "playback/cueslotplan.h"
+
+namespace {
+PrerollCue cue(const char* clip, qint64 targetMs) {
+    return PrerollCue{QString::fromLatin1(clip), targetMs};
+}
+} // namespace
+
+class TestCueSlotPlan : public QObject {
+    Q_OBJECT
+private slots:
+    void emptySlotsTakeCuesInPriorityOrder();
+    void heldCuesStayInTheirSlots();
+    void unwantedSlotIsReused();
+    void lowerPriorityCuesDoNotFit();
+    void duplicateAndInvalidCuesIgnored();
+    void noWantedCuesFreesEverySlot();
+    void findMatchesClipAndTarget();
+    void slotCountFollowsBudget();
+    void bytesPerSlotCountsEveryFeed();
+    void environmentOverrides();
+};
+
+void TestCueSlotPlan::emptySlotsTakeCuesInPriorityOrder() {
+    const QVector<PrerollCue> held(3);
+    const QVector<int> plan = CueSlotPlan::assign(held, {cue("a", 100), cue("b", 200)});
+    QCOMPARE(plan, (QVector<int>{0, 1, -1}));
+}
+
+void TestCueSlotPlan::heldCuesStayInTheirSlots() {
+    const QVector<PrerollCue> held{cue("b", 200), PrerollCue(), cue("a", 100)};
+    const QVector<int> plan =
+        CueSlotPlan::assign(held, {cue("a", 100), cue("b", 200), cue("c", 300)});
+    QCOMPARE(plan, (QVector<int>{1, 2, 0}));
+}
+
+void TestCueSlotPlan::unwantedSlotIsReused() {
+    // The cue in slot 0 already fired; the next boundary moves in.
+    const QVector<PrerollCue> held{cue("a", 100), cue("b", 200)};
+    const QVector<int> plan = CueSlotPlan::assign(held, {cue("b", 200), cue("c", 300)});
+    QCOMPARE(plan, (QVector<int>{1, 0}));
+}
+
+void TestCueSlotPlan::lowerPriorityCuesDoNotFit() {
+    const QVector<PrerollCue> held{cue("c", 300), cue("d", 400)};
+    const QVector<int> plan =
+        CueSlotPlan::assign(held, {cue("a", 100), cue("b", 200), cue("c", 300)});
+    // Only the two highest-priority cues are staged; c gives way to b.
+    QCOMPARE(plan, (QVector<int>{0, 1}));
+}
+
+void TestCueSlotPlan::duplicateAndInvalidCuesIgnored() {
+    const QVector<PrerollCue> held(2);
+    const QVector<int> plan =
+        CueSlotPlan::assign(held, {cue("a", 100), cue("a", 100), cue("a", -1), cue("b", 200)});
+    QCOMPARE(plan, (QVector<int>{0, 3}));
+}
+
+void TestCueSlotPlan::noWantedCuesFreesEverySlot() {
+    const QVector<PrerollCue> held{cue("a", 100), cue("b", 200)};
+    QCOMPARE(CueSlotPlan::assign(held, {}), (QVector<int>{-1, -1}));
+    QVERIFY(CueSlotPlan::assign({}, {cue("a", 100)}).isEmpty());
+}
+
+void TestCueSlotPlan::findMatchesClipAndTarget() {
+    const QVector<PrerollCue> held{cue("a", 100), cue("b", 100)};
+    QCOMPARE(CueSlotPlan::find(held, cue("b", 100)), 1);
+    QCOMPARE(CueSlotPlan::find(held, cue("b", 101)), -1);
+    QCOMPARE(CueSlotPlan::find(held, PrerollCue()), -1);
+}
+
+void TestCueSlotPlan::slotCountFollowsBudget() {
+    QCOMPARE(CueSlotPlan::slotCount(1000, 300, 5), 3);
+    QCOMPARE(CueSlotPlan::slotCount(1000, 300, 2), 2);
+    QCOMPARE(CueSlotPlan::slotCount(200, 300, 5), 0);
+    QCOMPARE(CueSlotPlan::slotCount(1000, 300, 0), 0);
+    QCOMPARE(CueSlotPlan::slotCount(1000, 0, 4), 4);
+}
+
+void TestCueSlotPlan::bytesPerSlotCountsEveryFeed() {
+    // 4 feeds x ceil(1100 ms at 50 fps) = 55 frames x 1920x1080 4:2:0.
+    QCOMPARE(CueSlotPlan::bytesPerSlot(4, 1920, 1080, 50, 1100),
+             qint64(4) * 55 * 1920 * 1080 * 3 / 2);
+    QCOMPARE(CueSlotPlan::bytesPerSlot(0, 1920, 1080, 50, 1100), qint64(0));
+}
+
+void TestCueSlotPlan::environmentOverrides() {
+    qunsetenv("OLR_PREROLL_SLOTS");
+    qunsetenv("OLR_PREROLL_BUDGET_MB");
+    QCOMPARE(CueSlotPlan::maxSlotsFromEnvironment(), CueSlotPlan::kDefaultMaxSlots);
+    QCOMPARE(CueSlotPlan::budgetBytesFromEnvironment(),
+             CueSlotPlan::kDefaultBudgetMb * 1024 * 1024);
+    qputenv("OLR_PREROLL_SLOTS", "0");
+    qputenv("OLR_PREROLL_BUDGET_MB", "512");
+    QCOMPARE(CueSlotPlan::maxSlotsFromEnvironment(), 0);
+    QCOMPARE(CueSlotPlan::budgetBytesFromEnvironment(), qint64(512) * 1024 * 1024);
+    qputenv("OLR_PREROLL_SLOTS", "x");
+    qputenv("OLR_PREROLL_BUDGET_MB", "-3");
+    QCOMPARE(CueSlotPlan::maxSlotsFromEnvironment(), CueSlotPlan::kDefaultMaxSlots);
+    QCOMPARE(CueSlotPlan::budgetBytesFromEnvironment(),
+             CueSlotPlan::kDefaultBudgetMb * 1024 * 1024);
+    qunsetenv("OLR_PREROLL_SLOTS");
+    qunsetenv("OLR_PREROLL_BUDGET_MB");
+}
+
+QTEST_GUILESS_MAIN(TestCueSlotPlan)
+#include "tst_cueslotplan.moc"
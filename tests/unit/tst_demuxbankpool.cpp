@@ -0,0 +1,198 @@
+#include <QtTest>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "playback/demuxbankpool.h"
+
+namespace {
+// A bank with no demuxer behind it: the pool only ever looks at the path.
+std::unique_ptr<DemuxBank> fakeBank(const QString& path) {
+    auto bank = std::make_unique<DemuxBank>();
+    bank->path = path;
+    return bank;
+}
+
+DemuxBankPool::Opener noOpener() {
+    return [](const QString&, AVIOInterruptCB) { return std::unique_ptr<DemuxBank>(); };
+}
+
+// Records every clip the warmer opened.
+struct RecordingOpener {
+    QMutex mutex;
+    QStringList opened;
+
+    DemuxBankPool::Opener opener() {
+        return [this](const QString& path, AVIOInterruptCB) {
+            QMutexLocker locker(&mutex);
+            opened.append(path);
+            return fakeBank(path);
+        };
+    }
+    int count(const QString& path) {
+        QMutexLocker locker(&mutex);
+        return opened.count(path);
+    }
+};
+} // namespace
+
+class TestDemuxBankPool : public QObject {
+    Q_OBJECT
+private slots:
+    void takeServesPooledBankOnce();
+    void keysAreCleanedPaths();
+    void putEvictsLeastRecentlyUsed();
+    void putReplacesBankForSameClip();
+    void evictionSparesWantedClips();
+    void zeroCapacityPoolsNothing();
+    void warmerOpensWantedClipsExceptInUse();
+    void warmerRewarmsTakenClip();
+    void warmerOpensReservedBanksPerClip();
+    void stopClosesPooledBanks();
+    void capacityFromEnvironment();
+    void openFailsOnMissingFile();
+};
+
+void TestDemuxBankPool::takeServesPooledBankOnce() {
+    DemuxBankPool pool(noOpener());
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    const std::unique_ptr<DemuxBank> bank = pool.take(QStringLiteral("/clips/a.mkv"));
+    QVERIFY(bank);
+    QCOMPARE(bank->path, QStringLiteral("/clips/a.mkv"));
+    QVERIFY(!pool.take(QStringLiteral("/clips/a.mkv")));
+    QCOMPARE(pool.stats().hits, qint64(1));
+    QCOMPARE(pool.stats().misses, qint64(1));
+}
+
+void TestDemuxBankPool::keysAreCleanedPaths() {
+    DemuxBankPool pool(noOpener());
+    pool.put(fakeBank(QStringLiteral("/clips/./a.mkv")));
+    QVERIFY(pool.contains(QStringLiteral("/clips//a.mkv")));
+    QVERIFY(pool.take(QStringLiteral("/clips/a.mkv")));
+}
+
+void TestDemuxBankPool::putEvictsLeastRecentlyUsed() {
+    DemuxBankPool pool(noOpener(), 2);
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/b.mkv")));
+    pool.put(pool.take(QStringLiteral("/clips/a.mkv"))); // a is now most recent
+    pool.put(fakeBank(QStringLiteral("/clips/c.mkv")));
+    QCOMPARE(pool.size(), 2);
+    QVERIFY(pool.contains(QStringLiteral("/clips/a.mkv")));
+    QVERIFY(!pool.contains(QStringLiteral("/clips/b.mkv")));
+    QVERIFY(pool.contains(QStringLiteral("/clips/c.mkv")));
+    QCOMPARE(pool.stats().evictions, qint64(1));
+}
+
+void TestDemuxBankPool::putReplacesBankForSameClip() {
+    DemuxBankPool pool(noOpener(), 2);
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/b.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    QCOMPARE(pool.size(), 2);
+    QVERIFY(pool.contains(QStringLiteral("/clips/b.mkv")));
+    QCOMPARE(pool.stats().evictions, qint64(1)); // the replaced bank was closed
+}
+
+void TestDemuxBankPool::evictionSparesWantedClips() {
+    DemuxBankPool pool(noOpener(), 2);
+    pool.setWanted({QStringLiteral("/clips/a.mkv")});
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/b.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/c.mkv")));
+    QVERIFY(pool.contains(QStringLiteral("/clips/a.mkv"))); // least recent, but wanted
+    QVERIFY(!pool.contains(QStringLiteral("/clips/b.mkv")));
+    QVERIFY(pool.contains(QStringLiteral("/clips/c.mkv")));
+}
+
+void TestDemuxBankPool::zeroCapacityPoolsNothing() {
+    RecordingOpener recorder;
+    DemuxBankPool pool(recorder.opener(), 0);
+    pool.setWanted({QStringLiteral("/clips/a.mkv")});
+    pool.start();
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    QCOMPARE(pool.size(), 0);
+    QTest::qWait(50);
+    QCOMPARE(recorder.count(QStringLiteral("/clips/a.mkv")), 0);
+}
+
+void TestDemuxBankPool::warmerOpensWantedClipsExceptInUse() {
+    RecordingOpener recorder;
+    DemuxBankPool pool(recorder.opener(), 2);
+    pool.setInUse(QStringLiteral("/clips/a.mkv"));
+    pool.setWanted({QStringLiteral("/clips/a.mkv"), QStringLiteral("/clips/b.mkv"),
+                    QStringLiteral("/clips/c.mkv"), QStringLiteral("/clips/d.mkv")});
+    pool.start();
+    QTRY_COMPARE(pool.size(), 2);
+    QVERIFY(pool.contains(QStringLiteral("/clips/b.mkv")));
+    QVERIFY(pool.contains(QStringLiteral("/clips/c.mkv")));
+    QTest::qWait(50); // the warm set is full: nothing further is opened
+    QCOMPARE(recorder.count(QStringLiteral("/clips/a.mkv")), 0);
+    QCOMPARE(recorder.count(QStringLiteral("/clips/d.mkv")), 0);
+    QCOMPARE(pool.stats().warmed, qint64(2));
+    pool.stop();
+}
+
+void TestDemuxBankPool::warmerRewarmsTakenClip() {
+    RecordingOpener recorder;
+    DemuxBankPool pool(recorder.opener(), 2);
+    pool.setWanted({QStringLiteral("/clips/b.mkv")});
+    pool.start();
+    QTRY_VERIFY(pool.contains(QStringLiteral("/clips/b.mkv")));
+    QVERIFY(pool.take(QStringLiteral("/clips/b.mkv")));
+    QTRY_VERIFY(pool.contains(QStringLiteral("/clips/b.mkv")));
+    QCOMPARE(recorder.count(QStringLiteral("/clips/b.mkv")), 2);
+    pool.stop();
+}
+
+void TestDemuxBankPool::warmerOpensReservedBanksPerClip() {
+    RecordingOpener recorder;
+    DemuxBankPool pool(recorder.opener(), 1);
+    pool.setWanted({QStringLiteral("/clips/b.mkv")});
+    // Two cue slots on a, one on c: reserved banks sit on top of the capacity.
+    pool.setReserved({QStringLiteral("/clips/a.mkv"), QStringLiteral("/clips/a.mkv"),
+                      QStringLiteral("/clips/c.mkv")});
+    pool.start();
+    QTRY_COMPARE(pool.size(), 4);
+    QCOMPARE(recorder.count(QStringLiteral("/clips/a.mkv")), 2);
+    QCOMPARE(recorder.count(QStringLiteral("/clips/c.mkv")), 1);
+    QVERIFY(pool.contains(QStringLiteral("/clips/b.mkv")));
+
+    // Once nothing is reserved the banks left are served, not re-opened, and a
+    // second bank per clip is a duplicate again.
+    pool.setReserved({});
+    QVERIFY(pool.take(QStringLiteral("/clips/a.mkv")));
+    QVERIFY(pool.take(QStringLiteral("/clips/a.mkv")));
+    pool.put(fakeBank(QStringLiteral("/clips/c.mkv")));
+    QCOMPARE(pool.size(), 1);
+    QTest::qWait(50);
+    QCOMPARE(recorder.count(QStringLiteral("/clips/a.mkv")), 2);
+    pool.stop();
+}
+
+void TestDemuxBankPool::stopClosesPooledBanks() {
+    DemuxBankPool pool(noOpener());
+    pool.put(fakeBank(QStringLiteral("/clips/a.mkv")));
+    pool.start();
+    pool.stop();
+    QCOMPARE(pool.size(), 0);
+}
+
+void TestDemuxBankPool::capacityFromEnvironment() {
+    qunsetenv("OLR_DEMUX_POOL_SIZE");
+    QCOMPARE(DemuxBankPool::capacityFromEnvironment(), DemuxBankPool::kDefaultCapacity);
+    qputenv("OLR_DEMUX_POOL_SIZE", "0");
+    QCOMPARE(DemuxBankPool::capacityFromEnvironment(), 0);
+    qputenv("OLR_DEMUX_POOL_SIZE", "5");
+    QCOMPARE(DemuxBankPool::capacityFromEnvironment(), 5);
+    qputenv("OLR_DEMUX_POOL_SIZE", "-1");
+    QCOMPARE(DemuxBankPool::capacityFromEnvironment(), DemuxBankPool::kDefaultCapacity);
+    qunsetenv("OLR_DEMUX_POOL_SIZE");
+}
+
+void TestDemuxBankPool::openFailsOnMissingFile() {
+    QVERIFY(!DemuxBank::open(QStringLiteral("/nonexistent/olr/clip.mkv"), 4,
+                             AVIOInterruptCB{nullptr, nullptr}));
+}
+
+QTEST_GUILESS_MAIN(TestDemuxBankPool)
+#include "tst_demuxbankpool.moc"
@@ -0,0 +1,113 @@
+#include <QtTest>
+#include <QTemporaryFile>
+
+#include <memory>
+
+#include "playback/demuxreadahead.h"
+
+class TestDemuxReadAhead : public QObject {
+    Q_OBJECT
+private slots:
+    void planForwardIsWindowFromReadPos();
+    void planReverseCoversIndexedChunkBelowReadPos();
+    void planReverseClampsToWindow();
+    void planReturnsNulloptWithoutPosition();
+    void openFailsForMissingFile();
+    void prefetchClampsToFileSize();
+    void coveredRequestIsSkipped();
+    void forwardProgressionPrefetchesOnlyTheNewTail();
+    void closeIsIdempotent();
+};
+
+namespace {
+// Writes `bytes` of filler to a fresh temp file and returns it (kept open).
+std::unique_ptr<QTemporaryFile> makeFile(qint64 bytes) {
+    auto file = std::make_unique<QTemporaryFile>();
+    if (!file->open()) return nullptr;
+    file->write(QByteArray(int(bytes), 'x'));
+    file->flush();
+    return file;
+}
+} // namespace
+
+void TestDemuxReadAhead::planForwardIsWindowFromReadPos() {
+    const auto range = DemuxReadAhead::plan(1, 4096, std::nullopt, 1000);
+    QVERIFY(range.has_value());
+    QCOMPARE(range->offset, qint64(4096));
+    QCOMPARE(range->length, qint64(1000));
+}
+
+void TestDemuxReadAhead::planReverseCoversIndexedChunkBelowReadPos() {
+    const auto range = DemuxReadAhead::plan(-1, 10000, qint64(6000), 1 << 20);
+    QVERIFY(range.has_value());
+    QCOMPARE(range->offset, qint64(6000));
+    QCOMPARE(range->length, qint64(4000));
+}
+
+void TestDemuxReadAhead::planReverseClampsToWindow() {
+    const auto range = DemuxReadAhead::plan(-1, 10000, qint64(0), 3000);
+    QVERIFY(range.has_value());
+    QCOMPARE(range->offset, qint64(7000));
+    QCOMPARE(range->length, qint64(3000));
+}
+
+void TestDemuxReadAhead::planReturnsNulloptWithoutPosition() {
+    QVERIFY(!DemuxReadAhead::plan(1, -1, std::nullopt).has_value());
+    QVERIFY(!DemuxReadAhead::plan(-1, 10000, std::nullopt).has_value()); // unindexed
+    QVERIFY(!DemuxReadAhead::plan(-1, 10000, qint64(10000)).has_value());
+}
+
+void TestDemuxReadAhead::openFailsForMissingFile() {
+    DemuxReadAhead ra;
+    QVERIFY(!ra.open(QStringLiteral("/nonexistent/olr/readahead.mkv")));
+    QVERIFY(!ra.isOpen());
+    ra.request({0, 100}); // harmless when closed
+    QCOMPARE(ra.stats().requests, qint64(0));
+}
+
+void TestDemuxReadAhead::prefetchClampsToFileSize() {
+    auto file = makeFile(64 * 1024);
+    QVERIFY(file);
+    DemuxReadAhead ra;
+    QVERIFY(ra.open(file->fileName()));
+    ra.request({1024, 1 << 20}); // runs past the (growing) end of file
+    QTRY_COMPARE(ra.stats().prefetches, qint64(1));
+    QCOMPARE(ra.stats().bytesPrefetched, qint64(64 * 1024 - 1024));
+}
+
+void TestDemuxReadAhead::coveredRequestIsSkipped() {
+    auto file = makeFile(64 * 1024);
+    QVERIFY(file);
+    DemuxReadAhead ra;
+    QVERIFY(ra.open(file->fileName()));
+    ra.request({0, 32 * 1024});
+    QTRY_COMPARE(ra.stats().prefetches, qint64(1));
+    ra.request({4096, 8192}); // inside the last prefetch
+    QCOMPARE(ra.stats().coveredSkips, qint64(1));
+    QCOMPARE(ra.stats().requests, qint64(1));
+}
+
+void TestDemuxReadAhead::forwardProgressionPrefetchesOnlyTheNewTail() {
+    auto file = makeFile(64 * 1024);
+    QVERIFY(file);
+    DemuxReadAhead ra;
+    QVERIFY(ra.open(file->fileName()));
+    ra.request({0, 16 * 1024});
+    QTRY_COMPARE(ra.stats().prefetches, qint64(1));
+    ra.request({8 * 1024, 16 * 1024}); // overlaps: only [16K, 24K) is new
+    QTRY_COMPARE(ra.stats().prefetches, qint64(2));
+    QCOMPARE(ra.stats().bytesPrefetched, qint64(24 * 1024));
+}
+
+void TestDemuxReadAhead::closeIsIdempotent() {
+    auto file = makeFile(1024);
+    QVERIFY(file);
+    DemuxReadAhead ra;
+    QVERIFY(ra.open(file->fileName()));
+    ra.close();
+    ra.close();
+    QVERIFY(!ra.isOpen());
+}
+
+QTEST_MAIN(TestDemuxReadAhead)
+#include "tst_demuxreadahead.moc"
@@ -324,6 +324,12 @@ void TestFormatCanon::sinkExportFormatMapsEachTarget() {
              int(FramePixelFormat::Yuv420p));
     QCOMPARE(int(sinkExportFormat(OutputTargetKind::Omt)), int(FramePixelFormat::Yuv420p));
     QCOMPARE(int(sinkExportFormat(OutputTargetKind::Aja)), int(FramePixelFormat::Yuv420p));
+    QCOMPARE(int(sinkExportFormat(OutputTargetKind::SharedMemory)),
+             int(FramePixelFormat::Yuv420p));
+    QCOMPARE(int(sinkExportFormat(OutputTargetKind::MpegTsStream)),
+             int(FramePixelFormat::Yuv420p));
+    QCOMPARE(int(sinkExportFormat(OutputTargetKind::IsoRecorder)),
+             int(FramePixelFormat::Yuv420p));
 }
 
 void TestFormatCanon::rgbToYuvRoundTripsWithinTolerance() {
@@ -22,6 +22,7 @@ private slots:
     void srtUnknownModeIsRejected();
     void rtmpRoutesToNativeRtmp();
     void ndiRoutesToNativeNdi();
+    void syntheticRoutesToSyntheticSession();
     void unsupportedSchemesAreRejected();
     void srtIsNativeByDefaultWithoutEnv();
     void rtmpIsNativeByDefault();
@@ -165,6 +166,16 @@ void TestIngestBackendSelector::ndiRoutesToNativeNdi() {
     QCOMPARE(selectIngestBackend(QUrl(QStringLiteral("ndi://STUDIO%20(CAM1)")), opts),
              IngestBackendKind::NativeNdi);
 }
+void TestIngestBackendSelector::syntheticRoutesToSyntheticSession() {
+    const QUrl url(QStringLiteral("synthetic://cam1?fps=50"));
+    const IngestBackendOptions opts = ingestBackendOptionsFromEnvironment(url, false, false, false);
+    QVERIFY(opts.preferSynthetic);
+    QCOMPARE(selectIngestBackend(url, opts), IngestBackendKind::Synthetic);
+    QCOMPARE(selectIngestBackend(url, IngestBackendOptions{}), IngestBackendKind::Unsupported);
+    QVERIFY(!ingestBackendOptionsFromEnvironment(QUrl(QStringLiteral("srt://127.0.0.1:9000")),
+                                                 true, true, true)
+                 .preferSynthetic);
+}
 void TestIngestBackendSelector::unsupportedSchemesAreRejected() {
     IngestBackendOptions opts;
     opts.preferNativeSrt = true;
@@ -0,0 +1,194 @@
+#include <QtTest>
+
+#include "playback/output/isorecordersink.h"
+
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace {
+
+constexpr qint64 kTenHours100ns = qint64(10) * 3600 * 10'000'000;
+
+OutputBusFrame busFrame(qint64 index, int width = 64, int height = 48) {
+    OutputBusFrame frame;
+    frame.bus = OutputBusId::pgm();
+    frame.outputFrameIndex = index;
+    frame.sampledPlayheadMs = index * 40;
+    frame.programmeTimecode100ns = kTenHours100ns + index * 400'000;
+    frame.video = solidYuv420pHandle(width, height, uchar(16 + index % 200), 128, 128);
+    frame.video.metadata().outputFrameIndex = index;
+    frame.identity.outputFrameIndex = index;
+    frame.identity.sourceFeedIndex = 1;
+    frame.identity.sourcePtsMs = 5000 + index * 40;
+    frame.audio.feedIndex = 1;
+    frame.audio.startSample = index * 1920;
+    frame.audio.pcm = QByteArray(1920 * 2 * int(sizeof(qint16)), '\x01');
+    return frame;
+}
+
+OutputTargetAssignment recorderAssignment(const QString& directory) {
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("pgm-iso");
+    assignment.kind = OutputTargetKind::IsoRecorder;
+    assignment.sourceBus = OutputBusId::pgm();
+    assignment.enabled = true;
+    assignment.settings.insert(QStringLiteral("directory"), directory);
+    assignment.settings.insert(QStringLiteral("videoBitrate"), 2'000'000);
+    return assignment;
+}
+
+struct RecordedFile {
+    QString timecodeTag;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    AVCodecID videoCodec = AV_CODEC_ID_NONE;
+    AVCodecID audioCodec = AV_CODEC_ID_NONE;
+    QList<qint64> videoPtsMs;
+    qint64 audioSamples = 0;
+    QList<QJsonObject> metadata;
+};
+
+bool readRecording(const QString& path, RecordedFile* out) {
+    AVFormatContext* ctx = nullptr;
+    if (avformat_open_input(&ctx, path.toUtf8().constData(), nullptr, nullptr) < 0) return false;
+    if (avformat_find_stream_info(ctx, nullptr) < 0) {
+        avformat_close_input(&ctx);
+        return false;
+    }
+    if (const AVDictionaryEntry* tc = av_dict_get(ctx->metadata, "timecode", nullptr, 0))
+        out->timecodeTag = QString::fromUtf8(tc->value);
+    AVPacket* packet = av_packet_alloc();
+    while (av_read_frame(ctx, packet) >= 0) {
+        const AVStream* stream = ctx->streams[packet->stream_index];
+        const AVCodecParameters* par = stream->codecpar;
+        if (par->codec_type == AVMEDIA_TYPE_VIDEO) {
+            out->videoCodec = par->codec_id;
+            out->videoWidth = par->width;
+            out->videoHeight = par->height;
+            out->videoPtsMs.append(av_rescale_q(packet->pts, stream->time_base, {1, 1000}));
+        } else if (par->codec_type == AVMEDIA_TYPE_AUDIO) {
+            out->audioCodec = par->codec_id;
+            out->audioSamples += packet->size / (par->ch_layout.nb_channels * 2);
+        } else if (par->codec_type == AVMEDIA_TYPE_SUBTITLE) {
+            out->metadata.append(
+                QJsonDocument::fromJson(QByteArray(reinterpret_cast<const char*>(packet->data),
+                                                   packet->size))
+                    .object());
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&ctx);
+    return true;
+}
+
+} // namespace
+
+class TestIsoRecorderSink : public QObject {
+    Q_OBJECT
+private slots:
+    void startRejectsInvalidAssignment();
+    void recordsBusWithProgrammeTimecodeAndAudio();
+    void droppedFramesLeaveGapsInsteadOfShifting();
+    void geometryChangeContinuesInNewFile();
+};
+
+void TestIsoRecorderSink::startRejectsInvalidAssignment() {
+    QTemporaryDir dir;
+    IsoRecorderOutputSink sink;
+    OutputTargetAssignment wrongKind = recorderAssignment(dir.path());
+    wrongKind.kind = OutputTargetKind::Ndi;
+    QVERIFY(!sink.start(wrongKind, FrameRate::fromFraction(25, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("invalid"));
+    QVERIFY(!sink.start(recorderAssignment(dir.path()), FrameRate()));
+    QVERIFY(!sink.isActive());
+    QVERIFY(!sink.submit(busFrame(0)));
+    QVERIFY(sink.recordingPath().isEmpty());
+}
+
+void TestIsoRecorderSink::recordsBusWithProgrammeTimecodeAndAudio() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    IsoRecorderOutputSink sink;
+    QVERIFY(sink.start(recorderAssignment(dir.path()), FrameRate::fromFraction(25, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("armed"));
+
+    constexpr int kFrames = 25;
+    for (int i = 0; i < kFrames; ++i)
+        QVERIFY2(sink.submit(busFrame(100 + i)), qPrintable(sink.outputStatus().message));
+    const OutputSinkStatus status = sink.outputStatus();
+    QCOMPARE(status.state, QStringLiteral("recording"));
+    QCOMPARE(status.acceptedFrames, qint64(kFrames));
+    QCOMPARE(status.lastDeliveredFrameIndex, qint64(100 + kFrames - 1));
+    QVERIFY(status.maxEncodeLatencyNs > 0);
+
+    const QString path = sink.recordingPath();
+    QVERIFY(path.startsWith(dir.path()));
+    QVERIFY(QFileInfo(path).fileName().startsWith(QStringLiteral("pgm-iso_")));
+    sink.stop();
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("stopped"));
+
+    RecordedFile file;
+    QVERIFY(readRecording(path, &file));
+    QCOMPARE(file.videoCodec, AV_CODEC_ID_MPEG2VIDEO);
+    QCOMPARE(file.videoWidth, 64);
+    QCOMPARE(file.videoHeight, 48);
+    QCOMPARE(file.audioCodec, AV_CODEC_ID_PCM_S16LE);
+    QCOMPARE(file.timecodeTag, QStringLiteral("10:00:04:00"));
+    QCOMPARE(file.videoPtsMs.size(), kFrames);
+    QCOMPARE(file.videoPtsMs.first(), qint64(0));
+    QCOMPARE(file.videoPtsMs.last(), qint64((kFrames - 1) * 40));
+    QCOMPARE(file.audioSamples, qint64(kFrames) * 1920);
+
+    QCOMPARE(file.metadata.size(), kFrames);
+    const QJsonObject third = file.metadata.at(3);
+    QCOMPARE(third.value(QStringLiteral("outputFrameIndex")).toInteger(), qint64(103));
+    QCOMPARE(third.value(QStringLiteral("programmeTimecode")).toString(),
+             QStringLiteral("10:00:04:03"));
+    QCOMPARE(third.value(QStringLiteral("sourceFeed")).toInt(), 1);
+    QCOMPARE(third.value(QStringLiteral("sourcePtsMs")).toInteger(), qint64(5000 + 103 * 40));
+}
+
+void TestIsoRecorderSink::droppedFramesLeaveGapsInsteadOfShifting() {
+    QTemporaryDir dir;
+    IsoRecorderOutputSink sink;
+    QVERIFY(sink.start(recorderAssignment(dir.path()), FrameRate::fromFraction(25, 1)));
+    for (const qint64 index : {0, 1, 2, 5, 6}) QVERIFY(sink.submit(busFrame(index)));
+    const QString path = sink.recordingPath();
+    sink.stop();
+
+    RecordedFile file;
+    QVERIFY(readRecording(path, &file));
+    QCOMPARE(file.videoPtsMs, (QList<qint64>{0, 40, 80, 200, 240}));
+}
+
+void TestIsoRecorderSink::geometryChangeContinuesInNewFile() {
+    QTemporaryDir dir;
+    IsoRecorderOutputSink sink;
+    QVERIFY(sink.start(recorderAssignment(dir.path()), FrameRate::fromFraction(25, 1)));
+    for (int i = 0; i < 5; ++i) QVERIFY(sink.submit(busFrame(i)));
+    const QString first = sink.recordingPath();
+    for (int i = 5; i < 10; ++i) QVERIFY(sink.submit(busFrame(i, 32, 32)));
+    const QString second = sink.recordingPath();
+    sink.stop();
+
+    QVERIFY(first != second);
+    RecordedFile a;
+    RecordedFile b;
+    QVERIFY(readRecording(first, &a));
+    QVERIFY(readRecording(second, &b));
+    QCOMPARE(a.videoWidth, 64);
+    QCOMPARE(b.videoWidth, 32);
+    QCOMPARE(a.videoPtsMs.size(), 5);
+    QCOMPARE(b.videoPtsMs.size(), 5);
+    QCOMPARE(b.videoPtsMs.first(), qint64(0));
+}
+
+QTEST_GUILESS_MAIN(TestIsoRecorderSink)
+#include "tst_isorecordersink.moc"
@@ -0,0 +1,120 @@
+#include <QtTest>
+
+#include "playback/output/latencyhistogram.h"
+
+class TestLatencyHistogram : public QObject {
+    Q_OBJECT
+private slots:
+    void emptyHistogramReportsZero();
+    void smallValuesAreExact();
+    void bucketBoundsStayWithinRelativeError();
+    void percentilesOfUniformSamples();
+    void negativeAndHugeSamplesAreClamped();
+    void resetClearsEverything();
+    void cumulativeCountsAndSum();
+    void mergeAddsSamples();
+};
+
+void TestLatencyHistogram::emptyHistogramReportsZero() {
+    const LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), qint64(0));
+    QCOMPARE(histogram.percentile(0.5), qint64(0));
+    QCOMPARE(histogram.percentile(0.999), qint64(0));
+}
+
+void TestLatencyHistogram::smallValuesAreExact() {
+    for (qint64 value = 0; value < 16; ++value) {
+        LatencyHistogram histogram;
+        histogram.record(value);
+        QCOMPARE(histogram.percentile(0.5), value);
+    }
+}
+
+void TestLatencyHistogram::bucketBoundsStayWithinRelativeError() {
+    int previousBucket = 0;
+    for (qint64 value = 1; value < (qint64(1) << 40); value = value * 3 / 2 + 1) {
+        const int bucket = LatencyHistogram::bucketFor(value);
+        QVERIFY(bucket >= previousBucket);
+        QVERIFY(bucket < LatencyHistogram::kBucketCount);
+        const qint64 upper = LatencyHistogram::bucketUpperBound(bucket);
+        QVERIFY2(upper >= value, qPrintable(QString::number(value)));
+        QVERIFY2(upper - value <= value / 8, qPrintable(QString::number(value)));
+        previousBucket = bucket;
+    }
+}
+
+void TestLatencyHistogram::percentilesOfUniformSamples() {
+    LatencyHistogram histogram;
+    for (qint64 us = 1; us <= 1000; ++us) histogram.record(us * 1000);
+    QCOMPARE(histogram.count(), qint64(1000));
+    QCOMPARE(histogram.max(), qint64(1000000));
+
+    const qint64 p50 = histogram.percentile(0.5);
+    QVERIFY(p50 >= 500000 && p50 <= 500000 * 9 / 8);
+    const qint64 p99 = histogram.percentile(0.99);
+    QVERIFY(p99 >= 990000 && p99 <= 1000000);
+    // The top quantile never reports more than was seen.
+    QCOMPARE(histogram.percentile(1.0), qint64(1000000));
+    QVERIFY(histogram.percentile(0.999) <= histogram.max());
+}
+
+void TestLatencyHistogram::negativeAndHugeSamplesAreClamped() {
+    LatencyHistogram histogram;
+    histogram.record(-5000);
+    QCOMPARE(histogram.percentile(1.0), qint64(0));
+
+    const qint64 huge = qint64(1) << 50;
+    histogram.record(huge);
+    QCOMPARE(LatencyHistogram::bucketFor(huge), LatencyHistogram::kBucketCount - 1);
+    QCOMPARE(histogram.max(), huge);
+    QCOMPARE(histogram.percentile(0.5), qint64(0));
+    QVERIFY(histogram.percentile(1.0) > 0);
+}
+
+void TestLatencyHistogram::resetClearsEverything() {
+    LatencyHistogram histogram;
+    histogram.record(123456);
+    histogram.reset();
+    QCOMPARE(histogram.count(), qint64(0));
+    QCOMPARE(histogram.max(), qint64(0));
+    QCOMPARE(histogram.percentile(0.99), qint64(0));
+    QCOMPARE(histogram.sum(), qint64(0));
+}
+
+void TestLatencyHistogram::cumulativeCountsAndSum() {
+    LatencyHistogram histogram;
+    for (qint64 us = 1; us <= 1000; ++us) histogram.record(us * 1000);
+    QCOMPARE(histogram.sum(), qint64(500500) * 1000);
+    QCOMPARE(histogram.countAtOrBelow(-1), qint64(0));
+    QCOMPARE(histogram.countAtOrBelow(qint64(1) << 40), qint64(1000));
+    // Short only by the samples sharing the edge's bucket (within 12.5% below it).
+    const qint64 half = histogram.countAtOrBelow(500000);
+    QVERIFY(half <= 500 && half >= 500 * 7 / 8);
+    qint64 previous = 0;
+    for (qint64 edge = 1000; edge <= 1000000; edge *= 10) {
+        const qint64 count = histogram.countAtOrBelow(edge);
+        QVERIFY(count >= previous);
+        previous = count;
+    }
+}
+
+void TestLatencyHistogram::mergeAddsSamples() {
+    LatencyHistogram low;
+    LatencyHistogram high;
+    LatencyHistogram both;
+    for (qint64 us = 1; us <= 100; ++us) {
+        low.record(us * 1000);
+        both.record(us * 1000);
+        high.record(us * 1000000);
+        both.record(us * 1000000);
+    }
+    low.merge(high);
+    QCOMPARE(low.count(), both.count());
+    QCOMPARE(low.sum(), both.sum());
+    QCOMPARE(low.max(), both.max());
+    QCOMPARE(low.percentile(0.5), both.percentile(0.5));
+    QCOMPARE(low.percentile(0.99), both.percentile(0.99));
+}
+
+QTEST_GUILESS_MAIN(TestLatencyHistogram)
+#include "tst_latencyhistogram.moc"
@@ -0,0 +1,219 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "recorder_engine/livepacketring.h"
+#include "recorder_engine/muxer.h"
+
+namespace {
+// One refcounted packet of `size` bytes on `stream` at ptsMs (key flag set, as
+// every recorded packet is ALL-INTRA).
+AVPacket* makePacket(int stream, qint64 ptsMs, int size = 100, bool key = true) {
+    AVPacket* pkt = av_packet_alloc();
+    if (av_new_packet(pkt, size) < 0) {
+        av_packet_free(&pkt);
+        return nullptr;
+    }
+    memset(pkt->data, stream, size_t(size));
+    pkt->stream_index = stream;
+    pkt->pts = pkt->dts = ptsMs;
+    pkt->pos = 1234;
+    if (key) pkt->flags |= AV_PKT_FLAG_KEY;
+    return pkt;
+}
+
+void appendPacket(LivePacketRing& ring, int stream, qint64 ptsMs, int size = 100) {
+    AVPacket* pkt = makePacket(stream, ptsMs, size);
+    ring.append(pkt);
+    av_packet_free(&pkt);
+}
+
+LivePacketRing::Limits generousLimits() {
+    LivePacketRing::Limits limits;
+    limits.maxBytes = qint64(64) * 1024 * 1024;
+    limits.maxSpanMs = 60000;
+    return limits;
+}
+} // namespace
+
+class TestLivePacketRing : public QObject {
+    Q_OBJECT
+private slots:
+    void emptyRingHasNothingResident();
+    void readsBackInAppendOrderSharingPayload();
+    void seekPicksNewestKeyAtOrBeforeAnchor();
+    void anchorBeforeWindowIsNotResident();
+    void liveEdgeThenGrowth();
+    void spanLimitEvictsOldest();
+    void byteLimitEvictsOldestAndReportsEvicted();
+    void registryPublishFindWithdraw();
+    void muxerFeedsAndWithdrawsRing();
+    void muxerWithRingDisabledPublishesNone();
+};
+
+void TestLivePacketRing::emptyRingHasNothingResident() {
+    LivePacketRing ring(generousLimits());
+    QCOMPARE(ring.packetCount(), 0);
+    QCOMPARE(ring.residentBytes(), qint64(0));
+    QVERIFY(!ring.seekSequence(0, 0).has_value());
+    AVPacket* out = av_packet_alloc();
+    QCOMPARE(ring.read(0, out), LivePacketRing::ReadResult::LiveEdge);
+    av_packet_free(&out);
+}
+
+void TestLivePacketRing::readsBackInAppendOrderSharingPayload() {
+    LivePacketRing ring(generousLimits());
+    AVPacket* src = makePacket(1, 40);
+    ring.append(src);
+    appendPacket(ring, 0, 40);
+    QCOMPARE(ring.packetCount(), 2);
+
+    AVPacket* out = av_packet_alloc();
+    QCOMPARE(ring.read(0, out), LivePacketRing::ReadResult::Packet);
+    QCOMPARE(out->stream_index, 1);
+    QCOMPARE(out->pts, int64_t(40));
+    QCOMPARE(out->data, src->data);  // refcounted, no payload copy
+    QCOMPARE(out->pos, int64_t(-1)); // never mistaken for a demuxed offset
+    av_packet_unref(out);
+    QCOMPARE(ring.read(1, out), LivePacketRing::ReadResult::Packet);
+    QCOMPARE(out->stream_index, 0);
+    av_packet_unref(out);
+    av_packet_free(&out);
+    av_packet_free(&src);
+}
+
+void TestLivePacketRing::seekPicksNewestKeyAtOrBeforeAnchor() {
+    LivePacketRing ring(generousLimits());
+    // Interleaved video (0) + audio (1): seq 0..5.
+    appendPacket(ring, 0, 0);
+    appendPacket(ring, 1, 0);
+    appendPacket(ring, 0, 40);
+    appendPacket(ring, 1, 20);
+    appendPacket(ring, 0, 80);
+    appendPacket(ring, 1, 40);
+    QCOMPARE(ring.seekSequence(0, 0).value(), quint64(0));
+    QCOMPARE(ring.seekSequence(0, 39).value(), quint64(0));
+    QCOMPARE(ring.seekSequence(0, 40).value(), quint64(2));
+    QCOMPARE(ring.seekSequence(0, 9999).value(), quint64(4));
+    QCOMPARE(ring.seekSequence(1, 20).value(), quint64(3));
+    QVERIFY(!ring.seekSequence(7, 40).has_value()); // unknown stream
+    QCOMPARE(ring.oldestPtsMs(0).value(), qint64(0));
+    QCOMPARE(ring.newestPtsMs(0).value(), qint64(80));
+}
+
+void TestLivePacketRing::anchorBeforeWindowIsNotResident() {
+    LivePacketRing ring(generousLimits());
+    appendPacket(ring, 0, 5000);
+    appendPacket(ring, 0, 5040);
+    QVERIFY(!ring.seekSequence(0, 4999).has_value());
+    QVERIFY(ring.seekSequence(0, 5000).has_value());
+}
+
+void TestLivePacketRing::liveEdgeThenGrowth() {
+    LivePacketRing ring(generousLimits());
+    appendPacket(ring, 0, 0);
+    AVPacket* out = av_packet_alloc();
+    QCOMPARE(ring.read(1, out), LivePacketRing::ReadResult::LiveEdge);
+    appendPacket(ring, 0, 40);
+    QCOMPARE(ring.read(1, out), LivePacketRing::ReadResult::Packet);
+    QCOMPARE(out->pts, int64_t(40));
+    av_packet_unref(out);
+    av_packet_free(&out);
+}
+
+void TestLivePacketRing::spanLimitEvictsOldest() {
+    LivePacketRing::Limits limits = generousLimits();
+    limits.maxSpanMs = 100;
+    LivePacketRing ring(limits);
+    for (qint64 pts = 0; pts <= 200; pts += 40) appendPacket(ring, 0, pts); // 0..200
+    // Oldest resident must be within 100 ms of the newest (200).
+    QVERIFY(ring.oldestPtsMs(0).value() >= 100);
+    QCOMPARE(ring.newestPtsMs(0).value(), qint64(200));
+    QVERIFY(!ring.seekSequence(0, 40).has_value());
+    QVERIFY(ring.seekSequence(0, 160).has_value());
+}
+
+void TestLivePacketRing::byteLimitEvictsOldestAndReportsEvicted() {
+    LivePacketRing::Limits limits = generousLimits();
+    limits.maxBytes = 3 * (1000 + 256); // three 1000-byte packets + overhead
+    LivePacketRing ring(limits);
+    for (int i = 0; i < 5; ++i) appendPacket(ring, 0, i * 40, 1000);
+    QCOMPARE(ring.packetCount(), 3);
+    QVERIFY(ring.residentBytes() <= limits.maxBytes);
+    AVPacket* out = av_packet_alloc();
+    QCOMPARE(ring.read(0, out), LivePacketRing::ReadResult::Evicted);
+    QCOMPARE(ring.read(1, out), LivePacketRing::ReadResult::Evicted);
+    QCOMPARE(ring.read(2, out), LivePacketRing::ReadResult::Packet);
+    QCOMPARE(out->pts, int64_t(80));
+    av_packet_unref(out);
+    av_packet_free(&out);
+
+    // A single packet larger than the whole budget is still kept (live edge).
+    appendPacket(ring, 0, 400, 10000);
+    QCOMPARE(ring.packetCount(), 1);
+}
+
+void TestLivePacketRing::registryPublishFindWithdraw() {
+    const QString path = QStringLiteral("/tmp/olr_ring_unit/clip.mkv");
+    auto ring = std::make_shared<LivePacketRing>(generousLimits());
+    LivePacketRing::publish(path, ring);
+    QCOMPARE(LivePacketRing::find(path).get(), ring.get());
+    QCOMPARE(LivePacketRing::find(QStringLiteral("/tmp/olr_ring_unit//clip.mkv")).get(),
+             ring.get()); // keyed on the cleaned path
+
+    // A stale session's withdraw must not remove a newer ring on the same path.
+    auto newer = std::make_shared<LivePacketRing>(generousLimits());
+    LivePacketRing::publish(path, newer);
+    LivePacketRing::withdraw(path, ring.get());
+    QCOMPARE(LivePacketRing::find(path).get(), newer.get());
+    LivePacketRing::withdraw(path, newer.get());
+    QVERIFY(!LivePacketRing::find(path));
+}
+
+void TestLivePacketRing::muxerFeedsAndWithdrawsRing() {
+    QTemporaryDir home;
+    QVERIFY(home.isValid());
+    Muxer m;
+    m.setOutputDirectory(home.path());
+    const QStringList names{QStringLiteral("A")};
+    QVERIFY(m.init(QStringLiteral("olr_unit_ring"), 1, 320, 240, 30, names, 48000, 2));
+    const QString path = m.getVideoPath(QStringLiteral("olr_unit_ring"));
+    const std::shared_ptr<LivePacketRing> ring = m.liveRing();
+    QVERIFY(ring);
+    QCOMPARE(LivePacketRing::find(path).get(), ring.get());
+
+    for (int i = 0; i < 3; ++i) {
+        AVPacket* pkt = makePacket(0, i * 33);
+        m.writePacket(pkt);
+        av_packet_free(&pkt);
+    }
+    QCOMPARE(ring->packetCount(), 3);
+    QCOMPARE(ring->seekSequence(0, 40).value(), quint64(1));
+
+    m.close();
+    QVERIFY(!LivePacketRing::find(path));
+    QVERIFY(!m.liveRing());
+    // The reader's reference keeps the resident packets valid past close().
+    QCOMPARE(ring->packetCount(), 3);
+}
+
+void TestLivePacketRing::muxerWithRingDisabledPublishesNone() {
+    QTemporaryDir home;
+    QVERIFY(home.isValid());
+    Muxer m;
+    m.setOutputDirectory(home.path());
+    m.setLiveRingEnabled(false);
+    const QStringList names{QStringLiteral("A")};
+    QVERIFY(m.init(QStringLiteral("olr_unit_noring"), 1, 320, 240, 30, names, 48000, 2));
+    const QString path = m.getVideoPath(QStringLiteral("olr_unit_noring"));
+    QVERIFY(!m.liveRing());
+    QVERIFY(!LivePacketRing::find(path));
+
+    AVPacket* pkt = makePacket(0, 0);
+    m.writePacket(pkt);
+    av_packet_free(&pkt);
+    m.close();
+    QVERIFY(!m.hasFatalWriteError());
+}
+
+QTEST_MAIN(TestLivePacketRing)
+#include "tst_livepacketring.moc"
@@ -0,0 +1,114 @@
+#include <QtTest>
+#include <QHostAddress>
+#include <QTcpSocket>
+
+#include "websocket/metricshttpserver.h"
+
+class TestMetricsHttpServer : public QObject {
+    Q_OBJECT
+private slots:
+    void servesLatestMetricsText();
+    void unknownPathIsNotFound();
+    void nonGetIsRejected();
+    void oversizedRequestIsRejected();
+    void requestSplitAcrossPacketsIsAnswered();
+    void incompleteRequestTimesOut();
+
+private:
+    // Sends raw request bytes (in the given pieces) and returns the whole response.
+    static QByteArray exchange(quint16 port, const QList<QByteArray>& pieces);
+};
+
+QByteArray TestMetricsHttpServer::exchange(quint16 port, const QList<QByteArray>& pieces) {
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    if (!socket.waitForConnected(2000)) return {};
+    for (const QByteArray& piece : pieces) {
+        socket.write(piece);
+        socket.flush();
+        // Let the server's event loop see each piece on its own.
+        QTest::qWait(20);
+    }
+    QByteArray response;
+    QElapsedTimer timer;
+    timer.start();
+    while (socket.state() != QAbstractSocket::UnconnectedState && timer.elapsed() < 2000) {
+        QCoreApplication::processEvents();
+        socket.waitForReadyRead(20);
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+    return response;
+}
+
+void TestMetricsHttpServer::servesLatestMetricsText() {
+    MetricsHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    server.setMetricsText("olr_recording 0\n");
+    server.setMetricsText("olr_recording 1\n");
+
+    const QByteArray response =
+        exchange(server.serverPort(), {"GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n"});
+    QVERIFY2(response.startsWith("HTTP/1.1 200 OK\r\n"), response.constData());
+    QVERIFY(response.contains("Content-Type: text/plain; version=0.0.4"));
+    QVERIFY(response.contains("Content-Length: 16\r\n"));
+    QVERIFY(response.endsWith("\r\n\r\nolr_recording 1\n"));
+}
+
+void TestMetricsHttpServer::unknownPathIsNotFound() {
+    MetricsHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QByteArray response =
+        exchange(server.serverPort(), {"GET /status HTTP/1.1\r\n\r\n"});
+    QVERIFY2(response.startsWith("HTTP/1.1 404"), response.constData());
+
+    // A query string does not change the path.
+    const QByteArray query =
+        exchange(server.serverPort(), {"GET /metrics?name[]=olr_recording HTTP/1.1\r\n\r\n"});
+    QVERIFY2(query.startsWith("HTTP/1.1 200"), query.constData());
+}
+
+void TestMetricsHttpServer::nonGetIsRejected() {
+    MetricsHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QByteArray response = exchange(server.serverPort(),
+                                         {"POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n"});
+    QVERIFY2(response.startsWith("HTTP/1.1 405"), response.constData());
+
+    const QByteArray garbage = exchange(server.serverPort(), {"hello\r\n\r\n"});
+    QVERIFY2(garbage.startsWith("HTTP/1.1 400"), garbage.constData());
+}
+
+void TestMetricsHttpServer::oversizedRequestIsRejected() {
+    MetricsHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    const QByteArray header = "GET /metrics HTTP/1.1\r\nX-Padding: " +
+                              QByteArray(MetricsHttpServer::kMaxRequestBytes, 'a');
+    const QByteArray response = exchange(server.serverPort(), {header});
+    QVERIFY2(response.startsWith("HTTP/1.1 431"), response.constData());
+}
+
+void TestMetricsHttpServer::requestSplitAcrossPacketsIsAnswered() {
+    MetricsHttpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    server.setMetricsText("olr_playback_active 1\n");
+    const QByteArray response =
+        exchange(server.serverPort(), {"GET /met", "rics HTTP/1.1\r\nHost: x\r\n", "\r\n"});
+    QVERIFY2(response.startsWith("HTTP/1.1 200 OK\r\n"), response.constData());
+    QVERIFY(response.endsWith("olr_playback_active 1\n"));
+}
+
+void TestMetricsHttpServer::incompleteRequestTimesOut() {
+    MetricsHttpServer server;
+    server.setRequestTimeoutMs(100);
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    QElapsedTimer timer;
+    timer.start();
+    // The head never ends; the server answers and closes instead of waiting on the client.
+    const QByteArray response = exchange(server.serverPort(), {"GET /metrics HTTP/1.1\r\n"});
+    QVERIFY2(response.startsWith("HTTP/1.1 408"), response.constData());
+    QVERIFY(timer.elapsed() < 2000);
+}
+
+QTEST_GUILESS_MAIN(TestMetricsHttpServer)
+#include "tst_metricshttpserver.moc"
@@ -0,0 +1,348 @@
+#include <QtTest>
+
+#include "playback/output/mpegtsstreamsink.h"
+#include "playback/output/queuedoutputsink.h"
+#include "recorder_engine/pipelinetrace.h"
+
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QUdpSocket>
+
+#include <atomic>
+#include <thread>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace {
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 48;
+
+OutputBusFrame busFrame(qint64 index) {
+    OutputBusFrame frame;
+    frame.bus = OutputBusId::pgm();
+    frame.outputFrameIndex = index;
+    frame.sampledPlayheadMs = index * 40;
+    frame.video = solidYuv420pHandle(kWidth, kHeight, uchar(16 + index % 200), 128, 128);
+    frame.video.metadata().outputFrameIndex = index;
+    frame.audio.feedIndex = 0;
+    frame.audio.startSample = index * 1920;
+    QByteArray pcm(1920 * 2 * int(sizeof(qint16)), '\0');
+    auto* samples = reinterpret_cast<qint16*>(pcm.data());
+    for (int i = 0; i < 1920 * 2; ++i) samples[i] = qint16((i % 96) * 200 - 9600);
+    frame.audio.pcm = pcm;
+    return frame;
+}
+
+OutputTargetAssignment streamAssignment(const QString& url) {
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("ts-test");
+    assignment.kind = OutputTargetKind::MpegTsStream;
+    assignment.sourceBus = OutputBusId::pgm();
+    assignment.enabled = true;
+    assignment.settings.insert(QStringLiteral("url"), url);
+    assignment.settings.insert(QStringLiteral("videoBitrate"), 1'000'000);
+    return assignment;
+}
+
+MpegTsStreamConfig configFor(const QString& url) {
+    MpegTsStreamConfig config;
+    config.url = url;
+    return config;
+}
+
+quint16 freeUdpPort() {
+    QUdpSocket probe;
+    if (!probe.bind(QHostAddress::LocalHost, 0)) return 0;
+    return probe.localPort();
+}
+
+} // namespace
+
+class TestMpegTsStreamSink : public QObject {
+    Q_OBJECT
+private slots:
+    void configReadsAssignmentSettings();
+    void udpEndpointCarriesDatagramSize();
+    void srtEndpointReusesIngestOptionParsing();
+    void srtListenerWithoutHostBindsAllInterfaces();
+    void rejectsBadEndpoints();
+    void startRejectsInvalidAssignment();
+    void udpLoopbackCarriesDecodableTransportStream();
+    void unreachableSrtPeerFailsFastAndKeepsRetrying();
+    void srtLoopbackDeliversToCaller();
+    void srtListenerStaysBoundWhileWaiting();
+};
+
+void TestMpegTsStreamSink::configReadsAssignmentSettings() {
+    OutputTargetAssignment assignment = streamAssignment(QStringLiteral(" udp://10.0.0.1:5000 "));
+    assignment.settings.insert(QStringLiteral("videoCodec"), QStringLiteral("H264"));
+    assignment.settings.insert(QStringLiteral("audioBitrate"), 128000);
+    assignment.settings.insert(QStringLiteral("gopFrames"), 25);
+    assignment.settings.insert(QStringLiteral("latencyMs"), -5);
+
+    const MpegTsStreamConfig config = MpegTsStreamConfig::fromAssignment(assignment);
+    QCOMPARE(config.url, QStringLiteral("udp://10.0.0.1:5000"));
+    QCOMPARE(int(config.videoCodec), int(VideoCodecChoice::H264Hardware));
+    QCOMPARE(config.videoBitrate, 1'000'000);
+    QCOMPARE(config.audioBitrate, 128000);
+    QCOMPARE(config.gopFrames, 25);
+    QCOMPARE(config.latencyMs, MpegTsStreamConfig::kDefaultLatencyMs);
+
+    const MpegTsStreamConfig defaults =
+        MpegTsStreamConfig::fromAssignment(OutputTargetAssignment());
+    QCOMPARE(int(defaults.videoCodec), int(VideoCodecChoice::Mpeg2Software));
+    QCOMPARE(defaults.videoBitrate, MpegTsStreamConfig::kDefaultVideoBitrate);
+    QCOMPARE(defaults.gopFrames, 0);
+}
+
+void TestMpegTsStreamSink::udpEndpointCarriesDatagramSize() {
+    MpegTsStreamEndpoint endpoint;
+    QString error;
+    QVERIFY2(mpegTsStreamEndpointFor(configFor(QStringLiteral("udp://239.1.1.1:5000")), &endpoint,
+                                     &error),
+             qPrintable(error));
+    QCOMPARE(endpoint.url, QStringLiteral("udp://239.1.1.1:5000"));
+    QVERIFY(!endpoint.isSrt);
+    QCOMPARE(endpoint.options.value(QStringLiteral("pkt_size")), QStringLiteral("1316"));
+}
+
+void TestMpegTsStreamSink::srtEndpointReusesIngestOptionParsing() {
+    MpegTsStreamEndpoint endpoint;
+    QString error;
+    QVERIFY2(mpegTsStreamEndpointFor(
+                 configFor(QStringLiteral("srt://truck.example:9000?mode=caller"
+                                          "&passphrase=a%26b%3Dcdefghij&pbkeylen=32"
+                                          "&streamid=pgm")),
+                 &endpoint, &error),
+             qPrintable(error));
+    QVERIFY(endpoint.isSrt);
+    // Secrets never end up in the URL shown in status messages.
+    QCOMPARE(endpoint.url, QStringLiteral("srt://truck.example:9000"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("mode")), QStringLiteral("caller"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("passphrase")), QStringLiteral("a&b=cdefghij"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("pbkeylen")), QStringLiteral("32"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("streamid")), QStringLiteral("pgm"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("transtype")), QStringLiteral("live"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("latency")), QStringLiteral("120000"));
+}
+
+void TestMpegTsStreamSink::srtListenerWithoutHostBindsAllInterfaces() {
+    MpegTsStreamEndpoint endpoint;
+    QString error;
+    QVERIFY2(mpegTsStreamEndpointFor(configFor(QStringLiteral("srt://:9001?mode=listener")),
+                                     &endpoint, &error),
+             qPrintable(error));
+    QCOMPARE(endpoint.url, QStringLiteral("srt://0.0.0.0:9001"));
+    QCOMPARE(endpoint.options.value(QStringLiteral("mode")), QStringLiteral("listener"));
+    QVERIFY(!endpoint.options.contains(QStringLiteral("passphrase")));
+}
+
+void TestMpegTsStreamSink::rejectsBadEndpoints() {
+    const QStringList bad = {
+        QString(),
+        QStringLiteral("rtmp://host:1935/live"),
+        QStringLiteral("udp://host"),
+        QStringLiteral("srt://:9000?mode=caller"),
+        QStringLiteral("srt://host:9000?mode=sideways"),
+        QStringLiteral("srt://host:9000?passphrase=short"),
+        QStringLiteral("srt://host:9000?passphrase=longenough1&pbkeylen=20"),
+    };
+    for (const QString& url : bad) {
+        QString error;
+        QVERIFY2(!mpegTsStreamEndpointFor(configFor(url), nullptr, &error), qPrintable(url));
+        QVERIFY2(!error.isEmpty(), qPrintable(url));
+    }
+}
+
+void TestMpegTsStreamSink::startRejectsInvalidAssignment() {
+    MpegTsStreamOutputSink sink;
+    OutputTargetAssignment wrongKind = streamAssignment(QStringLiteral("udp://127.0.0.1:5000"));
+    wrongKind.kind = OutputTargetKind::Ndi;
+    QVERIFY(!sink.start(wrongKind, FrameRate::fromFraction(25, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("invalid"));
+
+    QVERIFY(!sink.start(streamAssignment(QStringLiteral("srt://host:9000?passphrase=short")),
+                        FrameRate::fromFraction(25, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("invalid"));
+    QVERIFY(sink.outputStatus().message.contains(QStringLiteral("passphrase")));
+    QVERIFY(!sink.isActive());
+    QVERIFY(!sink.submit(busFrame(0)));
+}
+
+void TestMpegTsStreamSink::udpLoopbackCarriesDecodableTransportStream() {
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    receiver.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+
+    MpegTsStreamOutputSink sink;
+    const QString url = QStringLiteral("udp://127.0.0.1:%1").arg(receiver.localPort());
+    QVERIFY(sink.start(streamAssignment(url), FrameRate::fromFraction(25, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("connecting"));
+
+    // Encode latency runs from the dispatcher's submit stamp, queue wait included.
+    constexpr int kFrames = 50;
+    constexpr qint64 kQueuedNs = 20'000'000;
+    for (int i = 0; i < kFrames; ++i) {
+        OutputBusFrame frame = busFrame(i);
+        frame.submitNs = PipelineTrace::nowNs() - kQueuedNs;
+        QVERIFY2(sink.submit(frame), qPrintable(sink.outputStatus().message));
+    }
+    const OutputSinkStatus status = sink.outputStatus();
+    QCOMPARE(status.acceptedFrames, qint64(kFrames));
+    QCOMPARE(status.failedFrames, qint64(0));
+    QCOMPARE(status.state, QStringLiteral("active"));
+    QVERIFY(status.encodeLatencyNs >= kQueuedNs);
+    QVERIFY(status.maxEncodeLatencyNs >= status.encodeLatencyNs);
+    QCOMPARE(status.lastDeliveredFrameIndex, qint64(kFrames - 1));
+    sink.stop();
+
+    QByteArray stream;
+    while (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(200)) {
+        QByteArray datagram(int(receiver.pendingDatagramSize()), '\0');
+        receiver.readDatagram(datagram.data(), datagram.size());
+        QVERIFY(!datagram.isEmpty());
+        QCOMPARE(datagram.size() % 188, 0);
+        QCOMPARE(quint8(datagram.at(0)), quint8(0x47));
+        stream += datagram;
+    }
+    QVERIFY(stream.size() > 0);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("loopback.ts"));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(stream);
+    file.close();
+
+    AVFormatContext* ctx = nullptr;
+    QVERIFY(avformat_open_input(&ctx, path.toUtf8().constData(), nullptr, nullptr) >= 0);
+    QVERIFY(avformat_find_stream_info(ctx, nullptr) >= 0);
+    bool sawVideo = false;
+    bool sawAudio = false;
+    for (unsigned i = 0; i < ctx->nb_streams; ++i) {
+        const AVCodecParameters* par = ctx->streams[i]->codecpar;
+        if (par->codec_id == AV_CODEC_ID_MPEG2VIDEO) {
+            sawVideo = true;
+            QCOMPARE(par->width, kWidth);
+            QCOMPARE(par->height, kHeight);
+        }
+        if (par->codec_id == AV_CODEC_ID_AAC) sawAudio = true;
+    }
+    avformat_close_input(&ctx);
+    QVERIFY(sawVideo);
+    QVERIFY(sawAudio);
+}
+
+void TestMpegTsStreamSink::unreachableSrtPeerFailsFastAndKeepsRetrying() {
+    if (!avio_find_protocol_name("srt://127.0.0.1:1"))
+        QSKIP("FFmpeg built without the srt protocol");
+
+    // Behind QueuedOutputSink the blocked connect attempt happens on the worker thread:
+    // submit() itself never waits for the peer.
+    QueuedOutputSink queued(std::make_unique<MpegTsStreamOutputSink>());
+    const QString url = QStringLiteral("srt://127.0.0.1:%1?mode=caller").arg(freeUdpPort());
+    QVERIFY(queued.start(streamAssignment(url), FrameRate::fromFraction(25, 1)));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 10; ++i) queued.submit(busFrame(i));
+    QVERIFY(timer.elapsed() < 500);
+
+    QTRY_VERIFY_WITH_TIMEOUT(queued.outputStatus().failedFrames > 0, 5000);
+    const OutputSinkStatus status = queued.outputStatus();
+    QCOMPARE(status.acceptedFrames, qint64(0));
+    QCOMPARE(status.state, QStringLiteral("connecting"));
+    QVERIFY(status.droppedFrames > 0);
+    queued.stop();
+}
+
+void TestMpegTsStreamSink::srtLoopbackDeliversToCaller() {
+    if (!avio_find_protocol_name("srt://127.0.0.1:1"))
+        QSKIP("FFmpeg built without the srt protocol");
+
+    const quint16 port = freeUdpPort();
+    QVERIFY(port != 0);
+    MpegTsStreamOutputSink sink;
+    QVERIFY(sink.start(
+        streamAssignment(QStringLiteral("srt://127.0.0.1:%1?mode=listener").arg(port)),
+        FrameRate::fromFraction(25, 1)));
+
+    // The remote truck: an SRT caller demuxing what the listener sends.
+    std::atomic<int> videoPackets{0};
+    std::atomic<bool> receiverDone{false};
+    std::thread receiver([&]() {
+        AVFormatContext* ctx = nullptr;
+        AVDictionary* options = nullptr;
+        av_dict_set(&options, "mode", "caller", 0);
+        av_dict_set(&options, "connect_timeout", "5000", 0);
+        const QByteArray url = QStringLiteral("srt://127.0.0.1:%1").arg(port).toUtf8();
+        if (avformat_open_input(&ctx, url.constData(), nullptr, &options) >= 0) {
+            AVPacket* packet = av_packet_alloc();
+            while (videoPackets.load() < 10 && av_read_frame(ctx, packet) >= 0) {
+                if (ctx->streams[packet->stream_index]->codecpar->codec_type ==
+                    AVMEDIA_TYPE_VIDEO)
+                    videoPackets++;
+                av_packet_unref(packet);
+            }
+            av_packet_free(&packet);
+            avformat_close_input(&ctx);
+        }
+        av_dict_free(&options);
+        receiverDone = true;
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; !receiverDone.load() && timer.elapsed() < 15000; ++i) {
+        sink.submit(busFrame(i));
+        QThread::msleep(40);
+    }
+    sink.stop();
+    receiver.join();
+
+    QVERIFY2(videoPackets.load() >= 10, qPrintable(sink.outputStatus().message));
+    QVERIFY(sink.outputStatus().acceptedFrames > 0);
+    QVERIFY(sink.outputStatus().maxEncodeLatencyNs > 0);
+}
+
+void TestMpegTsStreamSink::srtListenerStaysBoundWhileWaiting() {
+    if (!avio_find_protocol_name("srt://127.0.0.1:1"))
+        QSKIP("FFmpeg built without the srt protocol");
+
+    const quint16 port = freeUdpPort();
+    QVERIFY(port != 0);
+    MpegTsStreamOutputSink sink;
+    QVERIFY(sink.start(
+        streamAssignment(QStringLiteral("srt://127.0.0.1:%1?mode=listener").arg(port)),
+        FrameRate::fromFraction(25, 1)));
+
+    const auto portBound = [port] {
+        QUdpSocket probe;
+        return !probe.bind(QHostAddress::LocalHost, port, QAbstractSocket::DontShareAddress);
+    };
+    QVERIFY(!sink.submit(busFrame(0)));
+    QTRY_VERIFY_WITH_TIMEOUT(portBound(), 2000);
+
+    // Past several former one-second attempts: no submit waits on the accept, and the
+    // port is never released for a caller to miss.
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 1; timer.elapsed() < 2500; ++i) {
+        QElapsedTimer submitTimer;
+        submitTimer.start();
+        QVERIFY(!sink.submit(busFrame(i)));
+        QVERIFY(submitTimer.elapsed() < 500);
+        QCOMPARE(sink.outputStatus().state, QStringLiteral("listening"));
+        QVERIFY(portBound());
+        QThread::msleep(100);
+    }
+    sink.stop();
+}
+
+QTEST_GUILESS_MAIN(TestMpegTsStreamSink)
+#include "tst_mpegtsstreamsink.moc"
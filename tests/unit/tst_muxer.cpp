@@ -15,6 +15,7 @@
 #include <QScopeGuard>
 
 #include "recorder_engine/muxer.h"
+#include "recorder_engine/pipelinetrace.h"
 
 class TestMuxer : public QObject {
     Q_OBJECT
@@ -40,6 +41,8 @@ private slots:
     void noTimecodeTagWhenCandidateAbsentButPacketWritten();
     void emptyRecordingClosesToValidMkv();
     void advertisesRationalFrameRate();
+    void writeStatsCountQueuedAndWrittenPackets();
+    void captureLatencyRecordsOnlyStampedPackets();
 
 private:
     QTemporaryDir m_home;
@@ -623,6 +626,80 @@ void TestMuxer::emptyRecordingClosesToValidMkv() {
              "empty recording must still carry the EBML/Matroska header magic");
 }
 
+void TestMuxer::writeStatsCountQueuedAndWrittenPackets() {
+    QVERIFY(m_home.isValid());
+    Muxer m;
+    m.setOutputDirectory(m_home.path());
+    const QStringList names{QStringLiteral("A")};
+
+    // An up-front timecode skips the header grace, so the writer drains at once.
+    QVERIFY(m.init(QStringLiteral("olr_unit_stats"), 1, 320, 240, 30, names, 48000, 2,
+                   QStringLiteral("10:00:00:00")));
+    QCOMPARE(m.writeStats().packetsQueued, qint64(0));
+    const QByteArray json = QByteArrayLiteral("{\"k\":1}");
+    for (int i = 0; i < 10; ++i) m.writeMetadataPacket(0, i * 33, json);
+    m.close(); // drains the queue
+
+    const MuxerWriteStats stats = m.writeStats();
+    QCOMPARE(stats.packetsQueued, qint64(10));
+    QCOMPARE(stats.packetsWritten, qint64(10));
+    QCOMPARE(stats.writeErrors, qint64(0));
+    QCOMPARE(stats.bytesWritten, qint64(10 * json.size()));
+    QVERIFY(stats.maxQueueDepth >= 1 && stats.maxQueueDepth <= 10);
+    QCOMPARE(stats.producerStalls, qint64(0));
+    QCOMPARE(stats.queueDwellNs.count(), qint64(10));
+    QCOMPARE(stats.writeNs.count(), qint64(10));
+
+    // The next session starts from zero.
+    QVERIFY(m.init(QStringLiteral("olr_unit_stats2"), 1, 320, 240, 30, names, 48000, 2,
+                   QStringLiteral("10:00:00:00")));
+    QCOMPARE(m.writeStats().packetsWritten, qint64(0));
+    QCOMPARE(m.writeStats().queueDwellNs.count(), qint64(0));
+    m.close();
+}
+
+void TestMuxer::captureLatencyRecordsOnlyStampedPackets() {
+    QVERIFY(m_home.isValid());
+    Muxer m;
+    m.setOutputDirectory(m_home.path());
+    const QStringList names{QStringLiteral("A")};
+    QVERIFY(m.init(QStringLiteral("olr_unit_latency"), 1, 320, 240, 30, names, 48000, 2,
+                   QStringLiteral("10:00:00:00")));
+
+    AVPacket* pkt = av_packet_alloc();
+    QVERIFY(av_new_packet(pkt, 64) == 0);
+    const auto freePacket = qScopeGuard([&pkt] { av_packet_free(&pkt); });
+    memset(pkt->data, 0, 64);
+    pkt->stream_index = 0;
+    pkt->flags |= AV_PKT_FLAG_KEY;
+
+    const qint64 now = PipelineTrace::nowNs();
+    CaptureFrameStamps stamps;
+    stamps.arrivalNs = now - 4'000'000;
+    stamps.decodedNs = now - 3'000'000;
+    stamps.dequeuedNs = now - 2'000'000;
+    stamps.encodedNs = now - 1'000'000;
+    pkt->pts = pkt->dts = 0;
+    m.writePacket(pkt, 0, stamps);
+    // Unstamped packets (audio, the tail of a multi-packet frame) are not latency samples.
+    pkt->pts = pkt->dts = 1;
+    m.writePacket(pkt);
+    pkt->pts = pkt->dts = 2;
+    m.writePacket(pkt, 0, CaptureFrameStamps{});
+    m.close();
+
+    const MuxerWriteStats stats = m.writeStats();
+    QCOMPARE(stats.packetsWritten, qint64(3));
+    QCOMPARE(stats.sourceLatency.size(), 1);
+    const CaptureLatency latency = m.captureLatency(0);
+    QCOMPARE(latency.totalNs.count(), qint64(1));
+    QCOMPARE(latency.arrivalToDecodedNs.count(), qint64(1));
+    QCOMPARE(latency.queuedToWrittenNs.count(), qint64(1));
+    QCOMPARE(latency.arrivalToDecodedNs.max(), qint64(1'000'000));
+    QVERIFY(latency.totalNs.max() >= 4'000'000);
+    QCOMPARE(m.captureLatency(1).totalNs.count(), qint64(0));
+}
+
 void TestMuxer::fatalWriteErrorFlagAndMessage() {
     Muxer m;
     QVERIFY(!m.hasFatalWriteError());
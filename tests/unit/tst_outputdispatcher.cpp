@@ -2,6 +2,7 @@
 
 #include "playback/output/broadcastoutputstatus.h"
 #include "playback/output/outputdispatcher.h"
+#include "recorder_engine/pipelinetrace.h"
 
 static FrameHandle video(int feed, qint64 pts, uchar y) {
     FrameHandle f = solidYuv420pHandle(4, 4, y, 128, 128);
@@ -46,9 +47,18 @@ public:
         return true;
     }
 
+    bool submit(OutputBusFrame&& frame) override {
+        if (!m_active) return false;
+        if (m_failSubmits) return false;
+        ++movedSubmits;
+        frames.append(std::move(frame));
+        return true;
+    }
+
     FrameRate receivedRate() const { return m_rate; }
 
     QVector<OutputBusFrame> frames;
+    int movedSubmits = 0;
 
 private:
     OutputTargetKind m_kind = OutputTargetKind::QtPreview;
@@ -67,8 +77,10 @@ private slots:
     void resetPlayEpochKeepsOutputFrameIndexContinuous();
     void rendersFeedMultiviewAndPgmAssignmentsFromSameTick();
     void targetsOnSameBusReceiveMatchingFrameIdentity();
+    void lastTargetOnBusReceivesFrameByMove();
     void targetStatsTrackRepeatedPayloadsAndFailuresIndependently();
     void identicalConsecutiveTicksSkipDuplicateSubmit();
+    void targetLatencyCountsEachFrameOncePerTarget();
     void statsMergeSinkOutputStatusWithDispatchAttempts();
     void dispatchStatsConvertToBroadcastStatuses();
     void startFailuresAreVisibleInTargetStats();
@@ -284,6 +296,48 @@ void TestOutputDispatcher::targetsOnSameBusReceiveMatchingFrameIdentity() {
     QVERIFY(previewSink.frames[0].identity.videoHash != 0);
 }
 
+void TestOutputDispatcher::lastTargetOnBusReceivesFrameByMove() {
+    OutputFrameCache cache(2, 4, 4);
+    cache.insertVideoFrame(video(0, 100, 40));
+    cache.insertVideoFrame(video(1, 100, 80));
+
+    PlaybackStateSnapshot state;
+    state.playheadMs = 100;
+    state.selectedFeedIndex = 0;
+
+    OutputTargetAssignment first;
+    first.id = QStringLiteral("feed0-preview");
+    first.sourceBus = OutputBusId::feed(0);
+    first.kind = OutputTargetKind::QtPreview;
+    first.enabled = true;
+    OutputTargetAssignment second = first;
+    second.id = QStringLiteral("feed0-ndi");
+    second.kind = OutputTargetKind::Ndi;
+    OutputTargetAssignment other = first;
+    other.id = QStringLiteral("feed1-preview");
+    other.sourceBus = OutputBusId::feed(1);
+
+    CollectingSink firstSink(OutputTargetKind::QtPreview);
+    CollectingSink secondSink(OutputTargetKind::Ndi);
+    CollectingSink otherSink(OutputTargetKind::QtPreview);
+    OutputDispatcher dispatcher(FrameRate::fromFraction(25, 1), 2, 4, 4);
+    dispatcher.setEndpoints({{first, &firstSink}, {second, &secondSink}, {other, &otherSink}});
+
+    const OutputDispatchStats stats = dispatcher.dispatchTick(cache, state);
+
+    QCOMPARE(firstSink.frames.size(), 1);
+    QCOMPARE(secondSink.frames.size(), 1);
+    QCOMPARE(otherSink.frames.size(), 1);
+    QCOMPARE(firstSink.movedSubmits, 0);
+    QCOMPARE(secondSink.movedSubmits, 1);
+    QCOMPARE(otherSink.movedSubmits, 1);
+    QCOMPARE(yPlane(secondSink.frames[0]), yPlane(firstSink.frames[0]));
+    QVERIFY(secondSink.frames[0].identity.samePayloadAs(firstSink.frames[0].identity));
+    QCOMPARE(yAt(otherSink.frames[0], 0), uchar(80));
+    QCOMPARE(stats.targets.value(second.id).placeholderFrames, qint64(0));
+    QCOMPARE(stats.targets.value(second.id).framesSubmitted, qint64(1));
+}
+
 void TestOutputDispatcher::targetStatsTrackRepeatedPayloadsAndFailuresIndependently() {
     OutputFrameCache cache(1, 4, 4);
     cache.insertVideoFrame(video(0, 100, 44));
@@ -369,6 +423,60 @@ void TestOutputDispatcher::identicalConsecutiveTicksSkipDuplicateSubmit() {
     QCOMPARE(after2.skippedDuplicateFrames, qint64(1));
 }
 
+void TestOutputDispatcher::targetLatencyCountsEachFrameOncePerTarget() {
+    OutputFrameCache cache(1, 4, 4);
+    FrameHandle stamped = video(0, 100, 44);
+    const qint64 now = PipelineTrace::nowNs();
+    stamped.metadata().stamps.demuxedNs = now - 3'000'000;
+    stamped.metadata().stamps.decodedNs = now - 2'000'000;
+    stamped.metadata().stamps.cachedNs = now - 1'000'000;
+    cache.insertVideoFrame(stamped);
+
+    PlaybackStateSnapshot state;
+    state.playheadMs = 100;
+    state.playing = false;
+    state.selectedFeedIndex = 0;
+
+    OutputTargetAssignment ok;
+    ok.id = QStringLiteral("feed0-ok");
+    ok.sourceBus = OutputBusId::feed(0);
+    ok.kind = OutputTargetKind::QtPreview;
+    ok.enabled = true;
+
+    OutputTargetAssignment failing;
+    failing.id = QStringLiteral("feed0-failing");
+    failing.sourceBus = OutputBusId::feed(0);
+    failing.kind = OutputTargetKind::Ndi;
+    failing.enabled = true;
+
+    CollectingSink okSink(OutputTargetKind::QtPreview);
+    CollectingSink failingSink(OutputTargetKind::Ndi, true);
+    OutputDispatcher dispatcher(FrameRate::fromFraction(25, 1), 1, 4, 4);
+    dispatcher.setEndpoints({{ok, &okSink}, {failing, &failingSink}});
+    dispatcher.setIdentitySkip(false); // the repeat reaches the sink but is no new sample
+
+    dispatcher.dispatchTick(cache, state);
+    dispatcher.dispatchTick(cache, state);
+    QCOMPARE(okSink.frames.size(), 2);
+
+    const QHash<QString, OutputTargetLatency>& latency = dispatcher.targetLatency();
+    QCOMPARE(latency.size(), 1); // a rejected submit is not a delivery
+    const OutputTargetLatency okLatency = latency.value(QStringLiteral("feed0-ok"));
+    QCOMPARE(okLatency.totalNs.count(), qint64(1));
+    QCOMPARE(okLatency.demuxToDecodedNs.max(), qint64(1'000'000));
+    QCOMPARE(okLatency.decodedToCachedNs.max(), qint64(1'000'000));
+    QCOMPARE(okLatency.cachedToDispatchedNs.count(), qint64(1));
+    QVERIFY(okLatency.totalNs.max() >= 3'000'000);
+
+    // Frames without stamps (placeholders, pre-staged cue frames) are not samples.
+    cache.insertVideoFrame(video(0, 140, 45));
+    state.playheadMs = 140;
+    dispatcher.dispatchTick(cache, state);
+    QCOMPARE(okSink.frames.size(), 3);
+    QCOMPARE(dispatcher.targetLatency().value(QStringLiteral("feed0-ok")).totalNs.count(),
+             qint64(1));
+}
+
 void TestOutputDispatcher::statsMergeSinkOutputStatusWithDispatchAttempts() {
     class StatusReportingSink final : public IOutputSink {
     public:
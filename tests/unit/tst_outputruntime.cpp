@@ -1,6 +1,10 @@
 #include <QtTest>
+#include <QUdpSocket>
 
 #include "playback/output/outputruntime.h"
+#include "recorder_engine/pipelinetrace.h"
+
+#include <cstring>
 
 static FrameHandle video(int feed, qint64 pts, uchar y) {
     FrameHandle f = solidYuv420pHandle(4, 4, y, 128, 128);
@@ -70,6 +74,13 @@ private slots:
     void runtimeStatsReportDeadlineMissWhenCatchUpIsCapped();
     void runtimeClearsDeadlineMissLatchAfterRecovery();
     void fenceWaitStallsCanBeIncremented();
+    void latenessPercentilesAndStageTimingsAreReported();
+    void publishedStatsRefreshAtMostEveryInterval();
+    void publishedTargetLatencyAccumulatesAndDropsRemovedTargets();
+    void workerThreadReportsGrantedScheduling();
+    void schedulingOptionsFromEnvironment();
+    void transportStreamSendsOneRecordPerTick();
+    void transportRecordRoundTripsAndRejectsForeignDatagrams();
 };
 
 void TestOutputRuntime::manualTicksRepeatPausedFrameFromCache() {
@@ -351,5 +362,335 @@ void TestOutputRuntime::fenceWaitStallsCanBeIncremented() {
     QCOMPARE(runtime.stats().fenceWaitStalls, qint64(2));
 }
 
+void TestOutputRuntime::latenessPercentilesAndStageTimingsAreReported() {
+    OutputFrameCache cache(1, 4, 4);
+    cache.insertVideoFrame(video(0, 100, 90));
+
+    PlaybackStateSnapshot state;
+    state.playheadMs = 100;
+    state.playing = false;
+    state.selectedFeedIndex = 0;
+
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("feed0-preview");
+    assignment.sourceBus = OutputBusId::feed(0);
+    assignment.kind = OutputTargetKind::QtPreview;
+    assignment.enabled = true;
+
+    ThreadSafeCollectingSink sink(OutputTargetKind::QtPreview);
+    OutputRuntime runtime(FrameRate::fromFraction(25, 1), 1, 4, 4);
+    runtime.setSnapshotProvider([cache, state]() {
+        OutputRuntimeSnapshot snapshot;
+        snapshot.cache = cache;
+        snapshot.state = state;
+        return snapshot;
+    });
+    runtime.setEndpoints({{assignment, &sink}});
+    runtime.setIdentitySkip(false);
+
+    // Tick 0 on time, then ticks 1..8 dispatched together at 600 ms: lateness 0, then
+    // 560, 520, ... 280 ms.
+    runtime.dispatchDueTicksForTest(0);
+    const OutputRuntimeDispatchStats stats = runtime.dispatchDueTicksForTest(600).runtime;
+
+    constexpr qint64 kMs = 1000000;
+    QVERIFY(stats.latenessP50Ns >= 400 * kMs && stats.latenessP50Ns <= 450 * kMs);
+    QCOMPARE(stats.latenessP99Ns, stats.maxLatenessNs);
+    QCOMPARE(stats.latenessP999Ns, 560 * kMs);
+    QVERIFY(stats.lastRenderNs > 0);
+    QVERIFY(stats.renderP99Ns > 0);
+    QVERIFY(stats.lastSinkSubmitNs > 0);
+    QVERIFY(stats.sinkSubmitP99Ns > 0);
+    QVERIFY(stats.snapshotP99Ns >= 0);
+}
+
+void TestOutputRuntime::publishedStatsRefreshAtMostEveryInterval() {
+    OutputFrameCache cache(1, 4, 4);
+    cache.insertVideoFrame(video(0, 100, 90));
+
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("feed0-preview");
+    assignment.sourceBus = OutputBusId::feed(0);
+    assignment.kind = OutputTargetKind::QtPreview;
+    assignment.enabled = true;
+
+    ThreadSafeCollectingSink sink(OutputTargetKind::QtPreview);
+    OutputRuntime runtime(FrameRate::fromFraction(25, 1), 1, 4, 4);
+    runtime.setSnapshotProvider([cache]() {
+        OutputRuntimeSnapshot snapshot;
+        snapshot.cache = cache;
+        snapshot.state.playheadMs = 100;
+        return snapshot;
+    });
+    runtime.setEndpoints({{assignment, &sink}});
+    runtime.setIdentitySkip(false);
+
+    QCOMPARE(runtime.publishedStats().dispatch.ticks, qint64(0));
+
+    // The first pass publishes; one 100 ms later is inside the interval and does not.
+    runtime.dispatchDueTicksForTest(0);
+    QCOMPARE(runtime.publishedStats().dispatch.ticks, qint64(1));
+    QCOMPARE(runtime.dispatchDueTicksForTest(100).ticks, qint64(3));
+    QCOMPARE(runtime.publishedStats().dispatch.ticks, qint64(1));
+
+    // Past the interval the published copy catches up, lateness histogram included.
+    const OutputDispatchStats live = runtime.dispatchDueTicksForTest(300);
+    const OutputRuntimePublishedStats published = runtime.publishedStats();
+    QCOMPARE(published.dispatch.ticks, live.ticks);
+    QCOMPARE(published.latenessNs.count(), live.ticks);
+    QVERIFY(published.dispatch.targets.contains(QStringLiteral("feed0-preview")));
+}
+
+void TestOutputRuntime::publishedTargetLatencyAccumulatesAndDropsRemovedTargets() {
+    const auto stamped = [](qint64 pts, uchar y) {
+        FrameHandle frame = video(0, pts, y);
+        frame.metadata().stamps.demuxedNs = PipelineTrace::nowNs() - 2'000'000;
+        frame.metadata().stamps.decodedNs = PipelineTrace::nowNs() - 1'000'000;
+        return frame;
+    };
+    OutputFrameCache cache(1, 4, 4);
+    cache.insertVideoFrame(stamped(100, 60));
+    PlaybackStateSnapshot state;
+    state.playheadMs = 100;
+    state.playing = false;
+    state.selectedFeedIndex = 0;
+
+    OutputTargetAssignment first;
+    first.id = QStringLiteral("feed0-first");
+    first.sourceBus = OutputBusId::feed(0);
+    first.kind = OutputTargetKind::QtPreview;
+    first.enabled = true;
+    OutputTargetAssignment second = first;
+    second.id = QStringLiteral("feed0-second");
+
+    ThreadSafeCollectingSink firstSink(OutputTargetKind::QtPreview);
+    ThreadSafeCollectingSink secondSink(OutputTargetKind::QtPreview);
+    OutputRuntime runtime(FrameRate::fromFraction(25, 1), 1, 4, 4);
+    runtime.setSnapshotProvider([&cache, &state]() {
+        OutputRuntimeSnapshot snapshot;
+        snapshot.cache = cache;
+        snapshot.state = state;
+        return snapshot;
+    });
+    runtime.setEndpoints({{first, &firstSink}});
+    runtime.setIdentitySkip(false);
+
+    const auto totalCount = [&runtime](const QString& key) {
+        return runtime.publishedStats().targetLatency.value(key).totalNs.count();
+    };
+    runtime.dispatchDueTicksForTest(0);
+    QCOMPARE(totalCount(first.id), qint64(1));
+
+    // A second frame published later adds to the first rather than replacing it.
+    cache.insertVideoFrame(stamped(140, 61));
+    state.playheadMs = 140;
+    runtime.dispatchDueTicksForTest(300);
+    QCOMPARE(totalCount(first.id), qint64(2));
+    QCOMPARE(totalCount(first.id), qint64(2)); // a repeated read merges nothing twice
+
+    runtime.setEndpoints({{second, &secondSink}});
+    QVERIFY(!runtime.publishedStats().targetLatency.contains(first.id));
+    cache.insertVideoFrame(stamped(180, 62));
+    state.playheadMs = 180;
+    runtime.dispatchDueTicksForTest(600);
+    const OutputRuntimePublishedStats published = runtime.publishedStats();
+    QVERIFY(!published.targetLatency.contains(first.id));
+    QCOMPARE(published.targetLatency.value(second.id).totalNs.count(), qint64(1));
+}
+
+void TestOutputRuntime::workerThreadReportsGrantedScheduling() {
+    OutputFrameCache cache(1, 4, 4);
+    cache.insertVideoFrame(video(0, 100, 55));
+
+    PlaybackStateSnapshot state;
+    state.playheadMs = 100;
+    state.playing = false;
+    state.selectedFeedIndex = 0;
+
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("feed0-preview");
+    assignment.sourceBus = OutputBusId::feed(0);
+    assignment.kind = OutputTargetKind::QtPreview;
+    assignment.enabled = true;
+
+    ThreadSafeCollectingSink sink(OutputTargetKind::QtPreview);
+    OutputRuntime runtime(FrameRate::fromFraction(50, 1), 1, 4, 4);
+    runtime.setSnapshotProvider([cache, state]() {
+        OutputRuntimeSnapshot snapshot;
+        snapshot.cache = cache;
+        snapshot.state = state;
+        return snapshot;
+    });
+    runtime.setEndpoints({{assignment, &sink}});
+    runtime.setIdentitySkip(false);
+
+    OutputRuntimeSchedulingOptions options;
+    options.lockMemory = true;
+    options.reserveLastCpu = true;
+    runtime.setSchedulingOptions(options);
+
+    runtime.startRuntime();
+    QTRY_VERIFY_WITH_TIMEOUT(sink.frameCount() >= 5, 1000);
+    const OutputRuntimeDispatchStats stats = runtime.stats().runtime;
+    runtime.stopRuntime();
+
+    QVERIFY(!stats.realtimePriority);
+#if defined(Q_OS_LINUX)
+    QVERIFY(stats.absoluteDeadlineSleep);
+    QVERIFY2(stats.cpuPinned, qPrintable(stats.schedulingError));
+    // RLIMIT_MEMLOCK may refuse the lock; that must be reported, not silently dropped.
+    QVERIFY(stats.memoryLocked || stats.schedulingError.contains(QStringLiteral("mlock")));
+#endif
+    // Ticks are slept to, not polled: on a 20 ms cadence the typical tick is on time.
+    QVERIFY2(stats.latenessP50Ns < 20000000, qPrintable(QString::number(stats.latenessP50Ns)));
+}
+
+void TestOutputRuntime::schedulingOptionsFromEnvironment() {
+    qputenv("OLR_OUTPUT_RT_PRIORITY", "150");
+    qputenv("OLR_OUTPUT_MLOCK", "1");
+    qputenv("OLR_OUTPUT_CPUS", "3, 5,3,x");
+    OutputRuntimeSchedulingOptions options = OutputRuntimeSchedulingOptions::fromEnvironment();
+    QCOMPARE(options.realtimePriority, 99);
+    QVERIFY(options.lockMemory);
+    QCOMPARE(options.cpus, (QList<int>{3, 5}));
+    QVERIFY(!options.reserveLastCpu);
+
+    qputenv("OLR_OUTPUT_CPUS", "last");
+    qunsetenv("OLR_OUTPUT_RT_PRIORITY");
+    qunsetenv("OLR_OUTPUT_MLOCK");
+    options = OutputRuntimeSchedulingOptions::fromEnvironment();
+    QCOMPARE(options.realtimePriority, 0);
+    QVERIFY(!options.lockMemory);
+    QVERIFY(options.cpus.isEmpty());
+    QVERIFY(options.reserveLastCpu);
+    qunsetenv("OLR_OUTPUT_CPUS");
+}
+
+void TestOutputRuntime::transportStreamSendsOneRecordPerTick() {
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    PlaybackStateSnapshot state;
+    state.playheadMs = 1000;
+    state.playing = true;
+    state.speed = 0.5;
+    state.cutArmed = true;
+    state.scheduledCutFrame = 7;
+
+    OutputRuntime runtime(FrameRate::fromFraction(25, 1), 1, 4, 4);
+    runtime.setSnapshotProvider([state]() {
+        OutputRuntimeSnapshot snapshot;
+        snapshot.state = state;
+        return snapshot;
+    });
+    TransportStreamOptions options;
+    options.address = QHostAddress::LocalHost;
+    options.port = receiver.localPort();
+    options.channel = 2;
+    runtime.setTransportStreamOptions(options);
+
+    // No endpoints: the stream follows the output clock, not whether anything is attached.
+    runtime.dispatchDueTicksForTest(0);
+    runtime.dispatchDueTicksForTest(80);
+
+    QVector<TransportStreamRecord> records;
+    QElapsedTimer timer;
+    timer.start();
+    while (records.size() < 3 && timer.elapsed() < 2000) {
+        if (!receiver.hasPendingDatagrams()) {
+            receiver.waitForReadyRead(20);
+            continue;
+        }
+        QByteArray datagram(int(receiver.pendingDatagramSize()), Qt::Uninitialized);
+        receiver.readDatagram(datagram.data(), datagram.size());
+        QCOMPARE(datagram.size(), transportstream::kRecordBytes);
+        TransportStreamRecord record;
+        QVERIFY(transportstream::decode(datagram.constData(), datagram.size(), &record));
+        records.append(record);
+    }
+    QCOMPARE(records.size(), 3);
+    for (int i = 0; i < records.size(); ++i) {
+        QCOMPARE(records[i].sequence, quint64(i));
+        QCOMPARE(records[i].outputFrameIndex, qint64(i));
+        // Half speed at 25 fps: the sampled playhead moves 20 ms per output frame.
+        QCOMPARE(records[i].sampledPlayheadMs, qint64(1000 + 20 * i));
+        QCOMPARE(records[i].speed, 0.5);
+        QVERIFY(records[i].playing);
+        QVERIFY(records[i].cutArmed);
+        QVERIFY(!records[i].cutStaged);
+        QCOMPARE(records[i].scheduledCutFrame, qint64(7));
+        QCOMPARE(records[i].rate.numerator, 25);
+        QCOMPARE(records[i].channel, quint32(2));
+    }
+    QCOMPARE(records[0].programmeTimecode100ns, qint64(10'000'000));
+    QCOMPARE(records[0].programmeTimecode, quint32(0x00000100)); // 00:00:01:00
+
+    // Disabling closes the socket on the next tick.
+    runtime.setTransportStreamOptions({});
+    runtime.dispatchDueTicksForTest(120);
+    QTest::qWait(50);
+    QVERIFY(!receiver.hasPendingDatagrams());
+}
+
+void TestOutputRuntime::transportRecordRoundTripsAndRejectsForeignDatagrams() {
+    TransportStreamRecord record;
+    record.sequence = 42;
+    record.outputFrameIndex = 123456789012LL;
+    record.sampledPlayheadMs = -5;
+    record.programmeTimecode100ns = -1;
+    record.programmeTimecode = 0x10111213;
+    record.speed = -2.0;
+    record.playing = true;
+    record.cutStaged = true;
+    record.rate = FrameRate::fromFraction(30000, 1001);
+    record.channel = 3;
+
+    char datagram[transportstream::kRecordBytes];
+    transportstream::encode(record, datagram);
+    // Little-endian on the wire whatever the host.
+    QCOMPARE(QByteArray(datagram, 4), QByteArray("OLRT"));
+    QCOMPARE(uchar(datagram[8]), uchar(42));
+
+    TransportStreamRecord decoded;
+    QVERIFY(transportstream::decode(datagram, sizeof(datagram), &decoded));
+    QCOMPARE(decoded.sequence, record.sequence);
+    QCOMPARE(decoded.outputFrameIndex, record.outputFrameIndex);
+    QCOMPARE(decoded.sampledPlayheadMs, record.sampledPlayheadMs);
+    QCOMPARE(decoded.programmeTimecode100ns, qint64(-1));
+    QCOMPARE(decoded.programmeTimecode, record.programmeTimecode);
+    QCOMPARE(decoded.speed, -2.0);
+    QVERIFY(decoded.playing && decoded.cutStaged && !decoded.cutArmed);
+    QCOMPARE(decoded.scheduledCutFrame, qint64(-1));
+    QCOMPARE(decoded.rate.denominator, 1001);
+    QCOMPARE(decoded.channel, quint32(3));
+
+    // A version 1 record is the first 72 bytes and always channel 0.
+    char version1[transportstream::kVersion1RecordBytes];
+    std::memcpy(version1, datagram, sizeof(version1));
+    version1[4] = 1;
+    version1[6] = char(transportstream::kVersion1RecordBytes);
+    QVERIFY(transportstream::decode(version1, sizeof(version1), &decoded));
+    QCOMPARE(decoded.sequence, record.sequence);
+    QCOMPARE(decoded.channel, quint32(0));
+
+    QVERIFY(!transportstream::decode(datagram, sizeof(datagram) - 1, &decoded));
+    datagram[0] = 'X';
+    QVERIFY(!transportstream::decode(datagram, sizeof(datagram), &decoded));
+
+    qputenv("OLR_TRANSPORT_STREAM", "239.255.0.115:8117");
+    qputenv("OLR_TRANSPORT_STREAM_TTL", "4");
+    TransportStreamOptions options = TransportStreamOptions::fromEnvironment();
+    QVERIFY(options.isEnabled());
+    QCOMPARE(options.address, QHostAddress(QStringLiteral("239.255.0.115")));
+    QCOMPARE(options.port, quint16(8117));
+    QCOMPARE(options.ttl, 4);
+
+    qputenv("OLR_TRANSPORT_STREAM", "239.255.0.115");
+    QVERIFY(!TransportStreamOptions::fromEnvironment().isEnabled());
+    qunsetenv("OLR_TRANSPORT_STREAM");
+    qunsetenv("OLR_TRANSPORT_STREAM_TTL");
+    QVERIFY(!TransportStreamOptions::fromEnvironment().isEnabled());
+}
+
 QTEST_GUILESS_MAIN(TestOutputRuntime)
 #include "tst_outputruntime.moc"
@@ -44,6 +44,11 @@ void TestOutputTargetAssignment::targetKindNamesAreStable() {
     QCOMPARE(outputTargetKindName(OutputTargetKind::Ndi), QStringLiteral("ndi"));
     QCOMPARE(outputTargetKindName(OutputTargetKind::Omt), QStringLiteral("omt"));
     QCOMPARE(outputTargetKindName(OutputTargetKind::Aja), QStringLiteral("aja"));
+    QCOMPARE(outputTargetKindName(OutputTargetKind::SharedMemory),
+             QStringLiteral("shared-memory"));
+    QCOMPARE(outputTargetKindName(OutputTargetKind::MpegTsStream),
+             QStringLiteral("mpegts-stream"));
+    QCOMPARE(outputTargetKindName(OutputTargetKind::IsoRecorder), QStringLiteral("iso-recorder"));
 }
 
 QTEST_GUILESS_MAIN(TestOutputTargetAssignment)
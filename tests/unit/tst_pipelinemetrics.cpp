@@ -0,0 +1,273 @@
+#include <QtTest>
+#include <QJsonArray>
+
+#include "websocket/pipelinemetrics.h"
+
+class TestPipelineMetrics : public QObject {
+    Q_OBJECT
+private slots:
+    void everySampleHasADeclaredFamily();
+    void perSourceSeriesCarrySourceLabels();
+    void ingestFamiliesFollowTheTransport();
+    void histogramBucketsAreCumulative();
+    void perTargetSeriesAreSorted();
+    void perChannelSeriesCarryChannelLabels();
+    void frameLatencyHistogramsCarryLabels();
+    void frameLatencyJsonListsStages();
+
+private:
+    static PipelineMetrics sampleMetrics();
+    static QStringList lines(const QByteArray& text, const QByteArray& prefix);
+};
+
+PipelineMetrics TestPipelineMetrics::sampleMetrics() {
+    PipelineMetrics metrics;
+
+    PipelineSourceMetrics srt;
+    srt.index = 0;
+    srt.name = QStringLiteral("Cam \"A\"");
+    srt.connected = true;
+    srt.linkHealth = 1;
+    srt.hasIngestStats = true;
+    srt.ingest.kind = IngestStatsKind::Srt;
+    srt.ingest.recvTotal = 1200;
+    srt.ingest.dropTotal = 3;
+    srt.ingest.lastPacketAgeMs = 40;
+    srt.hasEncoderStats = true;
+    srt.encoder.ticks = 600;
+    srt.encoder.lateTicks = 2;
+    srt.encoder.maxTickNs = 21'000'000;
+    metrics.sources.append(srt);
+
+    PipelineSourceMetrics idle;
+    idle.index = 1;
+    idle.name = QStringLiteral("Cam B");
+    metrics.sources.append(idle);
+
+    metrics.recording = true;
+    metrics.muxerQueueDepth = 4;
+    metrics.muxer.packetsWritten = 590;
+    for (const qint64 ns : {50'000LL, 800'000LL, 3'000'000LL, 3'000'000'000LL}) {
+        metrics.muxer.queueDwellNs.record(ns);
+    }
+    CaptureLatency camA;
+    camA.arrivalToDecodedNs.record(2'000'000);
+    camA.totalNs.record(30'000'000);
+    camA.totalNs.record(50'000'000);
+    metrics.muxer.sourceLatency.insert(0, camA);
+
+    metrics.output.dispatch.ticks = 90;
+    OutputTargetDispatchStats pgm;
+    pgm.framesSubmitted = 88;
+    OutputTargetDispatchStats feed;
+    feed.framesSubmitted = 90;
+    feed.sinkFailures = 1;
+    metrics.output.dispatch.targets.insert(QStringLiteral("pgm-ndi"), pgm);
+    metrics.output.dispatch.targets.insert(QStringLiteral("feed0-preview"), feed);
+    OutputTargetLatency pgmLatency;
+    pgmLatency.totalNs.record(70'000'000);
+    metrics.output.targetLatency.insert(QStringLiteral("pgm-ndi"), pgmLatency);
+    return metrics;
+}
+
+QStringList TestPipelineMetrics::lines(const QByteArray& text, const QByteArray& prefix) {
+    QStringList out;
+    for (const QByteArray& line : text.split('\n')) {
+        if (line.startsWith(prefix)) out.append(QString::fromUtf8(line));
+    }
+    return out;
+}
+
+void TestPipelineMetrics::everySampleHasADeclaredFamily() {
+    const QByteArray text = pipelineMetricsText(sampleMetrics());
+    QVERIFY(text.endsWith('\n'));
+
+    QSet<QByteArray> declared;
+    QSet<QByteArray> helped;
+    for (const QByteArray& line : text.split('\n')) {
+        if (line.isEmpty()) continue;
+        if (line.startsWith("# HELP ")) {
+            helped.insert(line.mid(7).split(' ').first());
+            continue;
+        }
+        if (line.startsWith("# TYPE ")) {
+            const QList<QByteArray> parts = line.mid(7).split(' ');
+            QCOMPARE(parts.size(), 2);
+            QVERIFY2(!declared.contains(parts[0]), parts[0].constData());
+            QVERIFY(helped.contains(parts[0]));
+            declared.insert(parts[0]);
+            continue;
+        }
+        QByteArray name = line.left(line.indexOf(line.contains('{') ? '{' : ' '));
+        for (const char* suffix : {"_bucket", "_sum", "_count"}) {
+            if (!declared.contains(name) && name.endsWith(suffix)) name.chop(qstrlen(suffix));
+        }
+        QVERIFY2(declared.contains(name), line.constData());
+        QVERIFY2(name.startsWith("olr_"), line.constData());
+    }
+    QVERIFY(declared.contains("olr_recording"));
+    QVERIFY(declared.contains("olr_playback_active"));
+    QVERIFY(declared.contains("olr_output_ticks_total"));
+}
+
+void TestPipelineMetrics::perSourceSeriesCarrySourceLabels() {
+    const QByteArray text = pipelineMetricsText(sampleMetrics());
+    QVERIFY(text.contains("olr_source_connected{source=\"0\",name=\"Cam \\\"A\\\"\"} 1\n"));
+    QVERIFY(text.contains("olr_source_connected{source=\"1\",name=\"Cam B\"} 0\n"));
+    QVERIFY(text.contains(
+        "olr_source_info{source=\"0\",name=\"Cam \\\"A\\\"\",transport=\"srt\"} 1\n"));
+    QVERIFY(text.contains(
+        "olr_source_info{source=\"1\",name=\"Cam B\",transport=\"unknown\"} 1\n"));
+
+    // Encoder series exist only for sources that are recording.
+    QCOMPARE(lines(text, "olr_encoder_late_ticks_total{").size(), 1);
+    const QByteArray camA = "{source=\"0\",name=\"Cam \\\"A\\\"\"}";
+    QVERIFY(text.contains("olr_encoder_late_ticks_total" + camA + " 2\n"));
+    QVERIFY(text.contains("olr_encoder_tick_max_seconds" + camA + " 0.021\n"));
+}
+
+void TestPipelineMetrics::ingestFamiliesFollowTheTransport() {
+    PipelineMetrics metrics = sampleMetrics();
+    QByteArray text = pipelineMetricsText(metrics);
+    QCOMPARE(lines(text, "olr_ingest_srt_packets_dropped_total{").size(), 1);
+    QCOMPARE(lines(text, "olr_ingest_last_packet_age_seconds{").size(), 1);
+    QVERIFY(text.contains(
+        "olr_ingest_last_packet_age_seconds{source=\"0\",name=\"Cam \\\"A\\\"\"} 0.04\n"));
+
+    // An RTMP source keeps the generic ingest series but no SRT ones; with no SRT source
+    // left the SRT families are omitted entirely rather than declared empty.
+    metrics.sources[0].ingest.kind = IngestStatsKind::Rtmp;
+    text = pipelineMetricsText(metrics);
+    QVERIFY(!text.contains("olr_ingest_srt_"));
+    QCOMPARE(lines(text, "olr_ingest_bytes_received_total{").size(), 1);
+}
+
+void TestPipelineMetrics::histogramBucketsAreCumulative() {
+    const QByteArray text = pipelineMetricsText(sampleMetrics());
+    const QStringList buckets = lines(text, "olr_muxer_queue_dwell_seconds_bucket{");
+    QVERIFY(buckets.size() > 2);
+    QVERIFY(buckets.last().startsWith("olr_muxer_queue_dwell_seconds_bucket{le=\"+Inf\"}"));
+
+    double previous = 0;
+    for (const QString& bucket : buckets) {
+        const double value = bucket.section(' ', -1).toDouble();
+        QVERIFY2(value >= previous, qPrintable(bucket));
+        previous = value;
+    }
+    QCOMPARE(previous, 4.0);
+    QVERIFY(text.contains("olr_muxer_queue_dwell_seconds_count 4\n"));
+    // 3 s is past the top finite edge, so only +Inf includes it.
+    QCOMPARE(buckets.at(buckets.size() - 2).section(' ', -1).toDouble(), 3.0);
+
+    const QStringList sum = lines(text, "olr_muxer_queue_dwell_seconds_sum ");
+    QCOMPARE(sum.size(), 1);
+    QVERIFY(qAbs(sum.first().section(' ', -1).toDouble() - 3.00385) < 1e-9);
+}
+
+void TestPipelineMetrics::perTargetSeriesAreSorted() {
+    const QByteArray text = pipelineMetricsText(sampleMetrics());
+    const QStringList submitted = lines(text, "olr_output_target_frames_submitted_total{");
+    QCOMPARE(submitted,
+             QStringList({"olr_output_target_frames_submitted_total{target=\"feed0-preview\"} 90",
+                          "olr_output_target_frames_submitted_total{target=\"pgm-ndi\"} 88"}));
+    QVERIFY(text.contains("olr_output_target_sink_failures_total{target=\"feed0-preview\"} 1\n"));
+
+    // No targets, no per-target families.
+    PipelineMetrics metrics = sampleMetrics();
+    metrics.output.dispatch.targets.clear();
+    QVERIFY(!pipelineMetricsText(metrics).contains("olr_output_target_"));
+}
+
+void TestPipelineMetrics::perChannelSeriesCarryChannelLabels() {
+    PipelineMetrics metrics = sampleMetrics();
+    QVERIFY(!pipelineMetricsText(metrics).contains("olr_playback_channel_"));
+    QVERIFY(!pipelineMetricsText(metrics).contains("olr_playback_shared_decode_"));
+
+    PipelinePlaybackChannelMetrics primary;
+    primary.playback.workerCpuNs = 2'000'000'000;
+    primary.playback.decodedVideoFrames = 120;
+    PipelinePlaybackChannelMetrics second;
+    second.channel = 1;
+    second.playback.workerCpuNs = 500'000'000;
+    second.playback.sharedDecodeHits = 5;
+    second.outputCpuNs = 250'000'000;
+    metrics.channels = {primary, second};
+    metrics.hasSharedDecode = true;
+    metrics.sharedDecode.hits = 5;
+    metrics.sharedDecode.misses = 120;
+    metrics.sharedDecode.frames = 96;
+
+    const QByteArray text = pipelineMetricsText(metrics);
+    QCOMPARE(lines(text, "olr_playback_channel_cpu_seconds_total{"),
+             QStringList({"olr_playback_channel_cpu_seconds_total{channel=\"0\"} 2",
+                          "olr_playback_channel_cpu_seconds_total{channel=\"1\"} 0.5"}));
+    // Channel 0's output CPU time is unknown: no sample rather than a zero.
+    QCOMPARE(lines(text, "olr_playback_channel_output_cpu_seconds_total{"),
+             QStringList({"olr_playback_channel_output_cpu_seconds_total{channel=\"1\"} 0.25"}));
+    QVERIFY(text.contains("olr_playback_channel_shared_decode_hits_total{channel=\"1\"} 5\n"));
+    QVERIFY(text.contains("olr_playback_shared_decode_hits_total 5\n"));
+    QVERIFY(text.contains("olr_playback_shared_decode_frames 96\n"));
+}
+
+void TestPipelineMetrics::frameLatencyHistogramsCarryLabels() {
+    const QByteArray text = pipelineMetricsText(sampleMetrics());
+
+    // Only the source with written frames has a series; labels come before le.
+    const QStringList glass = lines(text, "olr_glass_to_disk_seconds_bucket{");
+    QVERIFY(!glass.isEmpty());
+    for (const QString& bucket : glass) {
+        QVERIFY2(bucket.startsWith("olr_glass_to_disk_seconds_bucket{source=\"0\","),
+                 qPrintable(bucket));
+    }
+    QVERIFY(glass.last().endsWith(",le=\"+Inf\"} 2"));
+    const QByteArray camA = "{source=\"0\",name=\"Cam \\\"A\\\"\"}";
+    QVERIFY(text.contains("olr_glass_to_disk_seconds_count" + camA + " 2\n"));
+    QVERIFY(text.contains("olr_glass_to_disk_seconds_sum" + camA + " 0.08\n"));
+
+    QVERIFY(text.contains("olr_disk_to_output_seconds_bucket{target=\"pgm-ndi\",le=\"0.1\"} 1\n"));
+    QVERIFY(text.contains("olr_disk_to_output_seconds_count{target=\"pgm-ndi\"} 1\n"));
+
+    // Nothing measured yet, no families.
+    PipelineMetrics metrics = sampleMetrics();
+    metrics.muxer.sourceLatency.clear();
+    metrics.output.targetLatency.clear();
+    const QByteArray empty = pipelineMetricsText(metrics);
+    QVERIFY(!empty.contains("olr_glass_to_disk_seconds"));
+    QVERIFY(!empty.contains("olr_disk_to_output_seconds"));
+}
+
+void TestPipelineMetrics::frameLatencyJsonListsStages() {
+    const QJsonObject report = frameLatencyJson(sampleMetrics());
+
+    const QJsonArray sources = report.value(QStringLiteral("sources")).toArray();
+    QCOMPARE(sources.size(), 1);
+    const QJsonObject camA = sources.first().toObject();
+    QCOMPARE(camA.value(QStringLiteral("source")).toInt(), 0);
+    QCOMPARE(camA.value(QStringLiteral("name")).toString(), QStringLiteral("Cam \"A\""));
+    const QJsonObject stages = camA.value(QStringLiteral("stages")).toObject();
+    QCOMPARE(stages.size(), 6);
+    const QJsonObject total = stages.value(QStringLiteral("total")).toObject();
+    QCOMPARE(total.value(QStringLiteral("count")).toInteger(), qint64(2));
+    QCOMPARE(total.value(QStringLiteral("maxMs")).toDouble(), 50.0);
+    QVERIFY(total.value(QStringLiteral("p50Ms")).toDouble() >= 30.0);
+    QCOMPARE(stages.value(QStringLiteral("dequeuedToEncoded"))
+                 .toObject()
+                 .value(QStringLiteral("count"))
+                 .toInteger(),
+             qint64(0));
+
+    const QJsonArray targets = report.value(QStringLiteral("targets")).toArray();
+    QCOMPARE(targets.size(), 1);
+    const QJsonObject pgm = targets.first().toObject();
+    QCOMPARE(pgm.value(QStringLiteral("target")).toString(), QStringLiteral("pgm-ndi"));
+    QCOMPARE(pgm.value(QStringLiteral("stages"))
+                 .toObject()
+                 .value(QStringLiteral("total"))
+                 .toObject()
+                 .value(QStringLiteral("maxMs"))
+                 .toDouble(),
+             70.0);
+}
+
+QTEST_GUILESS_MAIN(TestPipelineMetrics)
+#include "tst_pipelinemetrics.moc"
@@ -0,0 +1,201 @@
+// Unit tests for PipelineTrace: runtime toggle, Chrome trace-event JSON shape, per-thread
+// rings (names, overwrite, clear) and dumping while other threads keep recording.
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "recorder_engine/pipelinetrace.h"
+
+#include <atomic>
+#include <thread>
+
+namespace {
+
+QJsonArray traceEvents(int* eventCount = nullptr) {
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(PipelineTrace::chromeTraceJson(eventCount),
+                                                      &error);
+    if (error.error != QJsonParseError::NoError) return {};
+    return doc.object().value(QStringLiteral("traceEvents")).toArray();
+}
+
+QList<QJsonObject> eventsNamed(const QJsonArray& events, const QString& name) {
+    QList<QJsonObject> out;
+    for (const QJsonValue& v : events) {
+        if (v.toObject().value(QStringLiteral("name")).toString() == name) {
+            out.append(v.toObject());
+        }
+    }
+    return out;
+}
+
+} // namespace
+
+class TestPipelineTrace : public QObject {
+    Q_OBJECT
+private slots:
+    void init();
+    void cleanup();
+    void disabledRecordsNothing();
+    void recordsChromeTraceEvents();
+    void namesThreadTracks();
+    void ringKeepsNewestEvents();
+    void clearDropsRecordedEvents();
+    void dumpWhileRecordingStaysValid();
+    void writesTraceFile();
+};
+
+void TestPipelineTrace::init() {
+    PipelineTrace::setEnabled(false);
+    PipelineTrace::clear();
+}
+
+void TestPipelineTrace::cleanup() {
+    PipelineTrace::setEnabled(false);
+}
+
+void TestPipelineTrace::disabledRecordsNothing() {
+    {
+        PipelineTraceScope scope("test", "off scope");
+    }
+    PipelineTrace::instant("test", "off instant");
+    PipelineTrace::counter("test", "off counter", 3);
+    int count = -1;
+    traceEvents(&count);
+    QCOMPARE(count, 0);
+
+    // A scope entered while off stays unrecorded even if tracing turns on before it ends.
+    {
+        PipelineTraceScope scope("test", "late scope");
+        PipelineTrace::setEnabled(true);
+    }
+    QVERIFY(eventsNamed(traceEvents(), QStringLiteral("late scope")).isEmpty());
+}
+
+void TestPipelineTrace::recordsChromeTraceEvents() {
+    PipelineTrace::setEnabled(true);
+    {
+        PipelineTraceScope scope("test", "span", "frame", 41);
+        scope.setArg(42);
+    }
+    PipelineTrace::instant("test", "mark", "ptsMs", 1000);
+    PipelineTrace::counter("test", "depth", 7);
+    PipelineTrace::complete("test", "fixed", 1000, 3500);
+
+    int count = 0;
+    const QJsonArray events = traceEvents(&count);
+    QCOMPARE(count, 4);
+
+    const QJsonObject span = eventsNamed(events, QStringLiteral("span")).value(0);
+    QCOMPARE(span.value(QStringLiteral("ph")).toString(), QStringLiteral("X"));
+    QCOMPARE(span.value(QStringLiteral("cat")).toString(), QStringLiteral("test"));
+    QCOMPARE(span.value(QStringLiteral("args")).toObject().value(QStringLiteral("frame")).toInt(),
+             42);
+    QVERIFY(span.value(QStringLiteral("dur")).toDouble() >= 0.0);
+
+    const QJsonObject mark = eventsNamed(events, QStringLiteral("mark")).value(0);
+    QCOMPARE(mark.value(QStringLiteral("ph")).toString(), QStringLiteral("i"));
+    QCOMPARE(mark.value(QStringLiteral("s")).toString(), QStringLiteral("t"));
+
+    const QJsonObject depth = eventsNamed(events, QStringLiteral("depth")).value(0);
+    QCOMPARE(depth.value(QStringLiteral("ph")).toString(), QStringLiteral("C"));
+    QCOMPARE(depth.value(QStringLiteral("args")).toObject().value(QStringLiteral("value")).toInt(),
+             7);
+
+    // Timestamps are microseconds.
+    const QJsonObject fixed = eventsNamed(events, QStringLiteral("fixed")).value(0);
+    QCOMPARE(fixed.value(QStringLiteral("ts")).toDouble(), 1.0);
+    QCOMPARE(fixed.value(QStringLiteral("dur")).toDouble(), 2.5);
+    QVERIFY(!fixed.contains(QStringLiteral("args")));
+}
+
+void TestPipelineTrace::namesThreadTracks() {
+    PipelineTrace::setEnabled(true);
+    std::thread worker([]() {
+        PipelineTrace::setThreadName(QStringLiteral("encoder \"cam\" 1"));
+        PipelineTrace::instant("test", "worker event");
+    });
+    worker.join();
+
+    const QJsonArray events = traceEvents();
+    QVERIFY(!events.isEmpty());
+    const QJsonObject event = eventsNamed(events, QStringLiteral("worker event")).value(0);
+    const int tid = event.value(QStringLiteral("tid")).toInt();
+    QVERIFY(tid > 0);
+
+    bool named = false;
+    for (const QJsonObject& meta : eventsNamed(events, QStringLiteral("thread_name"))) {
+        if (meta.value(QStringLiteral("tid")).toInt() != tid) continue;
+        QCOMPARE(meta.value(QStringLiteral("args")).toObject().value(QStringLiteral("name"))
+                     .toString(),
+                 QStringLiteral("encoder \"cam\" 1"));
+        named = true;
+    }
+    QVERIFY(named);
+}
+
+void TestPipelineTrace::ringKeepsNewestEvents() {
+    PipelineTrace::setEnabled(true);
+    const int total = PipelineTrace::kRingCapacity + 100;
+    for (int i = 0; i < total; ++i) PipelineTrace::instant("test", "tick", "i", i);
+
+    const QList<QJsonObject> ticks = eventsNamed(traceEvents(), QStringLiteral("tick"));
+    QCOMPARE(ticks.size(), PipelineTrace::kRingCapacity);
+    auto argOf = [](const QJsonObject& e) {
+        return e.value(QStringLiteral("args")).toObject().value(QStringLiteral("i")).toInt();
+    };
+    QCOMPARE(argOf(ticks.first()), 100);
+    QCOMPARE(argOf(ticks.last()), total - 1);
+}
+
+void TestPipelineTrace::clearDropsRecordedEvents() {
+    PipelineTrace::setEnabled(true);
+    PipelineTrace::instant("test", "before");
+    PipelineTrace::clear();
+    PipelineTrace::instant("test", "after");
+
+    const QJsonArray events = traceEvents();
+    QVERIFY(eventsNamed(events, QStringLiteral("before")).isEmpty());
+    QCOMPARE(eventsNamed(events, QStringLiteral("after")).size(), 1);
+}
+
+void TestPipelineTrace::dumpWhileRecordingStaysValid() {
+    PipelineTrace::setEnabled(true);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 3; ++t) {
+        writers.emplace_back([&stop]() {
+            qint64 n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                PipelineTraceScope scope("test", "busy", "n", n++);
+            }
+        });
+    }
+    for (int dump = 0; dump < 20; ++dump) {
+        QJsonParseError error;
+        QJsonDocument::fromJson(PipelineTrace::chromeTraceJson(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+    }
+    stop.store(true);
+    for (std::thread& writer : writers) writer.join();
+}
+
+void TestPipelineTrace::writesTraceFile() {
+    PipelineTrace::setEnabled(true);
+    PipelineTrace::instant("test", "to disk");
+    QTemporaryDir dir;
+    const QString path = dir.filePath(QStringLiteral("trace.json"));
+    int count = 0;
+    QVERIFY(PipelineTrace::writeChromeTrace(path, &count));
+    QCOMPARE(count, 1);
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(QJsonDocument::fromJson(file.readAll()).isObject());
+
+    QVERIFY(!PipelineTrace::writeChromeTrace(dir.filePath(QStringLiteral("missing/trace.json"))));
+}
+
+QTEST_GUILESS_MAIN(TestPipelineTrace)
+#include "tst_pipelinetrace.moc"
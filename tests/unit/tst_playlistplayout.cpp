@@ -20,6 +20,7 @@ private slots:
     void leadScalesWithSpeed();
     void inactiveUntilStarted();
     void entryWithoutOutPointArmsNoBoundary();
+    void boundaryCarriesTheNextEntrysClip();
 };
 
 void TestPlaylistPlayout::armsBoundaryOnceWhenWithinTheLead() {
@@ -129,5 +130,16 @@ void TestPlaylistPlayout::entryWithoutOutPointArmsNoBoundary() {
     QVERIFY(!p.evaluate(50000, 1.0, 1500).valid); // even far past, never arms
 }
 
+void TestPlaylistPlayout::boundaryCarriesTheNextEntrysClip() {
+    ReplayEntry other = entry(20000, 24000, 1.0);
+    other.clipPath = QStringLiteral("other.mkv");
+    PlaylistPlayout p;
+    p.start({entry(1000, 5000, 1.0), other}, 0);
+    const auto b = p.evaluate(4000, 1.0, 1500);
+    QVERIFY(b.valid);
+    QCOMPARE(b.targetMs, qint64(20000));
+    QCOMPARE(b.targetClipPath, QStringLiteral("other.mkv"));
+}
+
 QTEST_GUILESS_MAIN(TestPlaylistPlayout)
 #include "tst_playlistplayout.moc"
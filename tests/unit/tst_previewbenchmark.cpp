@@ -0,0 +1,101 @@
+#include <QtTest>
+
+#include "playback/frameprovider.h"
+#include "playback/output/qtpreviewsink.h"
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace {
+constexpr int kFeeds = 16;
+constexpr int kWidth = 1920;
+constexpr int kHeight = 1080;
+constexpr int kDefaultTicks = 25;
+constexpr int kFps = 50;
+
+// CPU time of the calling thread: the previews are built on the delivering
+// thread, so this is the cost the output thread pays per tick.
+qint64 threadCpuNs() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    const auto ticks = [](const FILETIME& t) {
+        return (qint64(t.dwHighDateTime) << 32) | qint64(t.dwLowDateTime);
+    };
+    return (ticks(kernel) + ticks(user)) * 100;
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+int ticksFromEnvironment() {
+    bool ok = false;
+    const int ticks = qEnvironmentVariableIntValue("OLR_PREVIEW_BENCH_TICKS", &ok);
+    return (ok && ticks > 0) ? ticks : kDefaultTicks;
+}
+
+// Delivers `ticks` frames to every one of the kFeeds providers through
+// `convert`; returns the CPU ns spent per previewed feed per frame.
+double cpuNsPerFeedFrame(const std::function<QVideoFrame(const FrameHandle&)>& convert,
+                         int ticks) {
+    std::vector<FrameHandle> feeds;
+    std::vector<std::unique_ptr<FrameProvider>> providers;
+    for (int i = 0; i < kFeeds; ++i) {
+        feeds.push_back(solidYuv420pHandle(kWidth, kHeight, uchar(16 + 8 * i), 128, 128));
+        providers.push_back(std::make_unique<FrameProvider>());
+    }
+    const qint64 start = threadCpuNs();
+    for (int tick = 0; tick < ticks; ++tick) {
+        for (size_t i = 0; i < feeds.size(); ++i) providers[i]->deliverFrame(convert(feeds[i]));
+    }
+    const qint64 spent = threadCpuNs() - start;
+    return double(spent) / (double(ticks) * kFeeds);
+}
+} // namespace
+
+// Preview delivery cost on a 16 x 1080p multiview: the copying conversion
+// (allocate + map + per-line memcpy) against the zero-copy plane wrapper.
+// Prints CPU per previewed feed; OLR_PREVIEW_BENCH_TICKS sets the run length.
+// The numbers are reported, not compared: CPU timings are noisy on a loaded CI
+// machine.
+class TestPreviewBenchmark : public QObject {
+    Q_OBJECT
+private slots:
+    void reportsPreviewCostPerFeed();
+};
+
+void TestPreviewBenchmark::reportsPreviewCostPerFeed() {
+    const int ticks = ticksFromEnvironment();
+    const double copyNs = cpuNsPerFeedFrame(&QtPreviewSink::copyToQVideoFrame, ticks);
+    const double wrapNs = cpuNsPerFeedFrame(&QtPreviewSink::toQVideoFrame, ticks);
+
+    const auto coreShare = [](double ns) { return ns * kFps / 1e9 * 100.0; };
+    qInfo().noquote() << QStringLiteral(
+                             "preview %1 feeds %2x%3, %4 ticks: copy %5 us/feed/frame "
+                             "(%6% core/feed @%7fps), zero-copy %8 us/feed/frame (%9% core/feed)")
+                             .arg(kFeeds)
+                             .arg(kWidth)
+                             .arg(kHeight)
+                             .arg(ticks)
+                             .arg(copyNs / 1000.0, 0, 'f', 1)
+                             .arg(coreShare(copyNs), 0, 'f', 2)
+                             .arg(kFps)
+                             .arg(wrapNs / 1000.0, 0, 'f', 2)
+                             .arg(coreShare(wrapNs), 0, 'f', 3);
+    // Both paths must still produce a full-size preview frame.
+    const FrameHandle probe = solidYuv420pHandle(kWidth, kHeight, 16, 128, 128);
+    QCOMPARE(QtPreviewSink::copyToQVideoFrame(probe).size(), QSize(kWidth, kHeight));
+    QCOMPARE(QtPreviewSink::toQVideoFrame(probe).size(), QSize(kWidth, kHeight));
+}
+
+QTEST_MAIN(TestPreviewBenchmark)
+#include "tst_previewbenchmark.moc"
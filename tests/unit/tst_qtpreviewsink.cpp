@@ -16,6 +16,10 @@ private slots:
     void colorMetadataRoundTripsDecodeToSink();
     void taggedBt601FrameMapsToBt601();
     void defaultTaggingReproducesLegacyHeightHeuristic();
+    void previewFrameSharesHandlePlanes();
+    void writableMapLeavesHandleUntouched();
+    void previewFrameOutlivesHandle();
+    void shortPlaneFallsBackToCopy();
 };
 
 void TestQtPreviewSink::deliverMediaFrameUpdatesProviderLatestImage() {
@@ -134,5 +138,61 @@ void TestQtPreviewSink::defaultTaggingReproducesLegacyHeightHeuristic() {
              QVideoFrameFormat::ColorSpace_BT601);
 }
 
+void TestQtPreviewSink::previewFrameSharesHandlePlanes() {
+    const FrameHandle handle = solidYuv420pHandle(64, 48, 80, 100, 150);
+    const CpuPlanes planes = handle.readToCpu(FramePixelFormat::Yuv420p);
+
+    QVideoFrame qFrame = QtPreviewSink::toQVideoFrame(handle);
+    QVERIFY(qFrame.map(QVideoFrame::ReadOnly));
+    for (int i = 0; i < 3; ++i) {
+        QCOMPARE(static_cast<const void*>(qFrame.bits(i)),
+                 static_cast<const void*>(planes.plane[i].constData()));
+        QCOMPARE(qFrame.bytesPerLine(i), planes.stride[i]);
+    }
+    qFrame.unmap();
+}
+
+void TestQtPreviewSink::writableMapLeavesHandleUntouched() {
+    const FrameHandle handle = solidYuv420pHandle(64, 48, 80, 100, 150);
+
+    QVideoFrame qFrame = QtPreviewSink::toQVideoFrame(handle);
+    QVERIFY(qFrame.map(QVideoFrame::WriteOnly));
+    qFrame.bits(0)[0] = 7;
+    qFrame.unmap();
+
+    QCOMPARE(uchar(handle.readToCpu(FramePixelFormat::Yuv420p).plane[0].at(0)), uchar(80));
+    QVERIFY(qFrame.map(QVideoFrame::ReadOnly));
+    QCOMPARE(qFrame.bits(0)[0], uchar(7));
+    qFrame.unmap();
+}
+
+void TestQtPreviewSink::previewFrameOutlivesHandle() {
+    QVideoFrame qFrame;
+    {
+        const FrameHandle handle = solidYuv420pHandle(64, 48, 80, 100, 150);
+        qFrame = QtPreviewSink::toQVideoFrame(handle);
+    }
+    QVERIFY(qFrame.map(QVideoFrame::ReadOnly));
+    QCOMPARE(qFrame.bits(0)[64 * 48 - 1], uchar(80));
+    QCOMPARE(qFrame.bits(2)[0], uchar(150));
+    qFrame.unmap();
+    QCOMPARE(qFrame.toImage().size(), QSize(64, 48));
+}
+
+void TestQtPreviewSink::shortPlaneFallsBackToCopy() {
+    CpuPlanes planes = solidYuv420pHandle(64, 48, 80, 100, 150).readToCpu();
+    planes.plane[0].truncate(64 * 40); // 8 luma rows missing
+    FrameMetadata meta;
+    const FrameHandle handle = makeCpuFrameHandle(planes, meta);
+
+    QVideoFrame qFrame = QtPreviewSink::toQVideoFrame(handle);
+    QVERIFY(qFrame.isValid());
+    QVERIFY(qFrame.map(QVideoFrame::ReadOnly));
+    QVERIFY(static_cast<const void*>(qFrame.bits(0)) !=
+            static_cast<const void*>(planes.plane[0].constData()));
+    QCOMPARE(qFrame.bits(0)[0], uchar(80));
+    qFrame.unmap();
+}
+
 QTEST_MAIN(TestQtPreviewSink)
 #include "tst_qtpreviewsink.moc"
@@ -2,6 +2,9 @@
 
 #include "playback/output/queuedoutputsink.h"
 
+#include <algorithm>
+#include <vector>
+
 static OutputBusFrame frame(qint64 index) {
     OutputBusFrame out;
     out.bus = OutputBusId::feed(0);
@@ -184,6 +187,47 @@ private:
     QVector<qint64> m_delivered;
 };
 
+// Inner sink that takes a fixed time per frame, so a producer running flat out overflows
+// the queue continuously.
+class PacedRecordingSink final : public IOutputSink {
+public:
+    OutputTargetKind kind() const override { return OutputTargetKind::Ndi; }
+
+    bool start(const OutputTargetAssignment& assignment, FrameRate rate) override {
+        QMutexLocker locker(&m_mutex);
+        m_active = assignment.enabled && assignment.kind == kind() && rate.isValid();
+        return m_active;
+    }
+
+    void stop() override {
+        QMutexLocker locker(&m_mutex);
+        m_active = false;
+    }
+
+    bool isActive() const override {
+        QMutexLocker locker(&m_mutex);
+        return m_active;
+    }
+
+    bool submit(const OutputBusFrame& frame) override {
+        QThread::usleep(50);
+        QMutexLocker locker(&m_mutex);
+        if (!m_active) return false;
+        m_delivered.append(frame.outputFrameIndex);
+        return true;
+    }
+
+    QVector<qint64> delivered() const {
+        QMutexLocker locker(&m_mutex);
+        return m_delivered;
+    }
+
+private:
+    mutable QMutex m_mutex;
+    bool m_active = false;
+    QVector<qint64> m_delivered;
+};
+
 class TestQueuedOutputSink : public QObject {
     Q_OBJECT
 private slots:
@@ -196,6 +240,7 @@ private slots:
     void multipleBackpressureDropsInOneGapAreNotError();
     void restartResetsDeliveryState();
     void rapidStopAfterBurstDrainsWithoutHang();
+    void stressSubmitLatencyUnderContinuousOverflow();
 };
 
 void TestQueuedOutputSink::submitReturnsBeforeSlowInnerSinkCompletes() {
@@ -447,5 +492,57 @@ void TestQueuedOutputSink::rapidStopAfterBurstDrainsWithoutHang() {
     QVERIFY(!sink.isActive());
 }
 
+void TestQueuedOutputSink::stressSubmitLatencyUnderContinuousOverflow() {
+    // The producer submits as fast as it can against a worker that is far slower, so nearly
+    // every submit overflows and drops the oldest frame while the worker is popping. Every
+    // frame must be accounted for exactly once, delivered in order, and submit() must stay
+    // cheap on the producer thread.
+    auto inner = std::make_unique<PacedRecordingSink>();
+    PacedRecordingSink* observed = inner.get();
+    QueuedOutputSink sink(std::move(inner), 3);
+
+    OutputTargetAssignment assignment;
+    assignment.kind = OutputTargetKind::Ndi;
+    assignment.sourceBus = OutputBusId::feed(0);
+    assignment.enabled = true;
+    QVERIFY(sink.start(assignment, FrameRate::fromFraction(60000, 1001)));
+
+    constexpr int kFrames = 20000;
+    const OutputBusFrame prototype = frame(0);
+    std::vector<qint64> latenciesNs;
+    latenciesNs.reserve(kFrames);
+    QElapsedTimer timer;
+    for (int i = 0; i < kFrames; ++i) {
+        OutputBusFrame next = prototype;
+        next.outputFrameIndex = i;
+        timer.start();
+        const bool queued = sink.submit(std::move(next));
+        latenciesNs.push_back(timer.nsecsElapsed());
+        QVERIFY(queued);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(sink.outputStatus().acceptedFrames +
+                                  sink.outputStatus().droppedFrames,
+                              qint64(kFrames), 5000);
+    const OutputSinkStatus status = sink.outputStatus();
+    const QVector<qint64> delivered = observed->delivered();
+    sink.stop();
+
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    const qint64 p50 = latenciesNs[latenciesNs.size() / 2];
+    const qint64 p99 = latenciesNs[latenciesNs.size() * 99 / 100];
+    qInfo("submit latency: p50=%lldns p99=%lldns max=%lldns dropped=%lld", p50, p99,
+          latenciesNs.back(), status.droppedFrames);
+
+    QVERIFY(status.droppedFrames > 0);
+    QCOMPARE(status.failedFrames, qint64(0));
+    QCOMPARE(qint64(delivered.size()), status.acceptedFrames);
+    QVERIFY(std::is_sorted(delivered.begin(), delivered.end()));
+    QVERIFY(std::adjacent_find(delivered.begin(), delivered.end()) == delivered.end());
+    QCOMPARE(delivered.last(), qint64(kFrames - 1));
+    QVERIFY(status.maxQueueDepth <= 3);
+    QVERIFY2(!status.lastDeliveryGap, "every gap here is an overflow drop, never an error");
+}
+
 QTEST_GUILESS_MAIN(TestQueuedOutputSink)
 #include "tst_queuedoutputsink.moc"
@@ -9,6 +9,8 @@ private slots:
     void hardBlockOnlyForH264WithoutHardware();
     void softWarnOnlyWhenConfiguredExceedsSafe();
     void blockReasonIsNonEmptyForH264();
+    void tighterOfCodecAndStorageLimitWins();
+    void warningNamesTheLimitingStage();
 };
 
 void TestRecordGate::hardBlockOnlyForH264WithoutHardware() {
@@ -30,5 +32,28 @@ void TestRecordGate::blockReasonIsNonEmptyForH264() {
     QVERIFY(!recordCodecBlockReason(VideoCodecChoice::H264Hardware).isEmpty());
 }
 
+void TestRecordGate::tighterOfCodecAndStorageLimitWins() {
+    QCOMPARE(exceededFeedLimit(6, 8, -1), FeedLimit::None);    // storage not measured
+    QCOMPARE(exceededFeedLimit(10, 8, -1), FeedLimit::Codec);  // codec-only, as before
+    QCOMPARE(exceededFeedLimit(6, 8, 4), FeedLimit::Storage);  // disk is the limit
+    QCOMPARE(exceededFeedLimit(10, 8, 4), FeedLimit::Storage); // disk is tighter
+    QCOMPARE(exceededFeedLimit(10, 4, 8), FeedLimit::Codec);   // codec is tighter
+    QCOMPARE(exceededFeedLimit(10, 8, 8), FeedLimit::Codec);   // tie -> codec
+    QCOMPARE(exceededFeedLimit(4, 8, 4), FeedLimit::None);     // at the disk limit
+    QCOMPARE(exceededFeedLimit(1, -1, 0), FeedLimit::Storage); // volume took no feed at all
+    QCOMPARE(exceededFeedLimit(0, -1, 0), FeedLimit::None);
+    QVERIFY(feedCountExceedsSafe(6, 8, 4));
+    QVERIFY(!feedCountExceedsSafe(6, 8, -1));
+}
+
+void TestRecordGate::warningNamesTheLimitingStage() {
+    QVERIFY(feedLimitWarning(6, 8, -1).isEmpty());
+    QVERIFY(feedLimitWarning(10, 8, -1).contains(QStringLiteral("selected codec")));
+    const QString disk = feedLimitWarning(6, 8, 4);
+    QVERIFY(disk.contains(QStringLiteral("recording volume")));
+    QVERIFY(disk.contains(QStringLiteral("4")));
+    QVERIFY(!feedLimitWarning(2, -1, 0).isEmpty());
+}
+
 QTEST_GUILESS_MAIN(TestRecordGate)
 #include "tst_recordgate.moc"
@@ -0,0 +1,178 @@
+#include <QtTest>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "playback/output/framehandle.h"
+#include "playback/shareddecodedframecache.h"
+
+namespace {
+
+const QString kClip = QStringLiteral("/rec/session.mkv");
+
+FrameHandle frameAt(int feed, qint64 ptsMs, uchar y = 16) {
+    FrameHandle frame = solidYuv420pHandle(4, 4, y, 128, 128);
+    frame.metadata().key.feedIndex = feed;
+    frame.metadata().key.ptsMs = ptsMs;
+    return frame;
+}
+
+class GpuOnlyFrameData final : public IFrameData {
+public:
+    bool isGpuBacked() const override { return true; }
+    CpuPlanes readToCpu(FramePixelFormat) const override { return {}; }
+    GpuSurface* gpuSurface() const override { return nullptr; }
+    FramePixelFormat nativeFormat() const override { return FramePixelFormat::Nv12; }
+};
+
+class ScopedEnv {
+public:
+    ScopedEnv(const char* name, const QByteArray& value)
+        : m_name(name), m_hadValue(qEnvironmentVariableIsSet(name)), m_previous(qgetenv(name)) {
+        qputenv(m_name, value);
+    }
+
+    ~ScopedEnv() {
+        if (m_hadValue)
+            qputenv(m_name, m_previous);
+        else
+            qunsetenv(m_name);
+    }
+
+private:
+    const char* m_name;
+    bool m_hadValue;
+    QByteArray m_previous;
+};
+
+} // namespace
+
+class TestSharedDecodedFrameCache : public QObject {
+    Q_OBJECT
+private slots:
+    void findReturnsThePublishedFrameByClipFeedAndPts();
+    void evictsLeastRecentlyUsedBeyondCapacity();
+    void ignoresGpuBackedAndPlaceholderFrames();
+    void zeroCapacityDisablesSharing();
+    void capacityFromEnvironment();
+    void concurrentChannelsShareFrames();
+};
+
+void TestSharedDecodedFrameCache::findReturnsThePublishedFrameByClipFeedAndPts() {
+    SharedDecodedFrameCache cache(8);
+    const FrameHandle published = frameAt(1, 400, 77);
+    cache.insert(kClip, published);
+
+    const FrameHandle hit = cache.find(kClip, 1, 400);
+    QVERIFY(!hit.isNull());
+    QCOMPARE(hit.data(), published.data()); // shared, not copied
+    QCOMPARE(hit.metadata().key.ptsMs, qint64(400));
+
+    QVERIFY(cache.find(kClip, 0, 400).isNull());
+    QVERIFY(cache.find(kClip, 1, 440).isNull());
+    QVERIFY(cache.find(QStringLiteral("/rec/other.mkv"), 1, 400).isNull());
+
+    const SharedDecodedFrameCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, qint64(1));
+    QCOMPARE(stats.misses, qint64(3));
+    QCOMPARE(stats.insertions, qint64(1));
+    QCOMPARE(stats.frames, 1);
+}
+
+void TestSharedDecodedFrameCache::evictsLeastRecentlyUsedBeyondCapacity() {
+    SharedDecodedFrameCache cache(2);
+    cache.insert(kClip, frameAt(0, 0));
+    cache.insert(kClip, frameAt(0, 40));
+    QVERIFY(!cache.find(kClip, 0, 0).isNull()); // 0 becomes most recent
+    cache.insert(kClip, frameAt(0, 80));        // evicts 40
+
+    QVERIFY(!cache.find(kClip, 0, 0).isNull());
+    QVERIFY(cache.find(kClip, 0, 40).isNull());
+    QVERIFY(!cache.find(kClip, 0, 80).isNull());
+
+    // Republishing a held frame refreshes it without counting an insertion.
+    cache.insert(kClip, frameAt(0, 0, 99));
+    QCOMPARE(MediaVideoFrameView(cache.find(kClip, 0, 0)).planeY.at(0), char(99));
+
+    const SharedDecodedFrameCache::Stats stats = cache.stats();
+    QCOMPARE(stats.insertions, qint64(3));
+    QCOMPARE(stats.evictions, qint64(1));
+    QCOMPARE(stats.frames, 2);
+
+    cache.clear();
+    QCOMPARE(cache.stats().frames, 0);
+    QVERIFY(cache.find(kClip, 0, 80).isNull());
+}
+
+void TestSharedDecodedFrameCache::ignoresGpuBackedAndPlaceholderFrames() {
+    SharedDecodedFrameCache cache(8);
+    FrameMetadata meta;
+    meta.key.feedIndex = 0;
+    meta.key.ptsMs = 120;
+    cache.insert(kClip, FrameHandle(std::make_shared<GpuOnlyFrameData>(), meta));
+
+    FrameHandle placeholder = frameAt(0, 160);
+    placeholder.metadata().key.isPlaceholder = true;
+    cache.insert(kClip, placeholder);
+    cache.insert(kClip, FrameHandle());
+
+    QCOMPARE(cache.stats().frames, 0);
+    QVERIFY(cache.find(kClip, 0, 120).isNull());
+    QVERIFY(cache.find(kClip, 0, 160).isNull());
+}
+
+void TestSharedDecodedFrameCache::zeroCapacityDisablesSharing() {
+    SharedDecodedFrameCache cache(0);
+    cache.insert(kClip, frameAt(0, 0));
+    QVERIFY(cache.find(kClip, 0, 0).isNull());
+    QCOMPARE(cache.stats().insertions, qint64(0));
+}
+
+void TestSharedDecodedFrameCache::capacityFromEnvironment() {
+    {
+        ScopedEnv env("OLR_SHARED_DECODE_FRAMES", QByteArray());
+        QCOMPARE(SharedDecodedFrameCache::capacityFromEnvironment(),
+                 SharedDecodedFrameCache::kDefaultCapacity);
+    }
+    {
+        ScopedEnv env("OLR_SHARED_DECODE_FRAMES", "0");
+        QCOMPARE(SharedDecodedFrameCache::capacityFromEnvironment(), 0);
+    }
+    {
+        ScopedEnv env("OLR_SHARED_DECODE_FRAMES", "240");
+        QCOMPARE(SharedDecodedFrameCache::capacityFromEnvironment(), 240);
+    }
+    {
+        ScopedEnv env("OLR_SHARED_DECODE_FRAMES", "-3");
+        QCOMPARE(SharedDecodedFrameCache::capacityFromEnvironment(),
+                 SharedDecodedFrameCache::kDefaultCapacity);
+    }
+}
+
+void TestSharedDecodedFrameCache::concurrentChannelsShareFrames() {
+    // Two channels walking the same span: whichever gets to a frame first decodes and
+    // publishes it, the other finds it. Every pts is decoded exactly once.
+    constexpr int kFrames = 2000;
+    SharedDecodedFrameCache cache(4096);
+    std::atomic<int> decoded{0};
+    auto channel = [&] {
+        for (int i = 0; i < kFrames; ++i) {
+            const qint64 pts = qint64(i) * 40;
+            if (!cache.find(kClip, 0, pts).isNull()) continue;
+            decoded++;
+            cache.insert(kClip, frameAt(0, pts));
+        }
+    };
+    std::thread a(channel);
+    std::thread b(channel);
+    a.join();
+    b.join();
+
+    const SharedDecodedFrameCache::Stats stats = cache.stats();
+    QCOMPARE(stats.frames, kFrames);
+    QCOMPARE(stats.insertions, qint64(kFrames));
+    QCOMPARE(stats.hits + stats.misses, qint64(2 * kFrames));
+    QCOMPARE(stats.misses, qint64(decoded.load()));
+}
+
+QTEST_GUILESS_MAIN(TestSharedDecodedFrameCache)
+#include "tst_shareddecodedframecache.moc"
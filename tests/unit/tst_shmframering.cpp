@@ -0,0 +1,299 @@
+#include <QtTest>
+
+#include "playback/output/sharedmemorysink.h"
+#include "playback/output/shmframering.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <cstring>
+
+namespace {
+
+QString segmentName(const char* tag) {
+    return QStringLiteral("olr-tst-%1-%2").arg(QCoreApplication::applicationPid()).arg(
+        QLatin1String(tag));
+}
+
+OutputBusFrame busFrame(qint64 index, uchar y, int width = 16, int height = 8) {
+    OutputBusFrame frame;
+    frame.bus = OutputBusId::pgm();
+    frame.outputFrameIndex = index;
+    frame.sampledPlayheadMs = index * 20;
+    frame.programmeTimecode100ns = index * 200000;
+    frame.video = solidYuv420pHandle(width, height, y, 90, 240);
+    frame.video.metadata().key.feedIndex = 1;
+    frame.video.metadata().key.ptsMs = 1000 + index * 20;
+    frame.video.metadata().outputFrameIndex = index;
+    frame.audio.feedIndex = 1;
+    frame.audio.startSample = index * 960;
+    QByteArray pcm(960 * 2 * int(sizeof(qint16)), '\0');
+    auto* samples = reinterpret_cast<qint16*>(pcm.data());
+    for (int i = 0; i < 960 * 2; ++i) samples[i] = qint16(index * 10 + i % 7);
+    frame.audio.pcm = pcm;
+    return frame;
+}
+
+ShmFrameRingWriter::Geometry geometry(int slotCount) {
+    ShmFrameRingWriter::Geometry g;
+    g.slotCount = slotCount;
+    g.rate = FrameRate::fromFraction(50, 1);
+    g.payloadBytes = shmring::payloadBytesFor(16, 8, g.rate);
+    g.bus = OutputBusId::pgm();
+    return g;
+}
+
+} // namespace
+
+class TestShmFrameRing : public QObject {
+    Q_OBJECT
+private slots:
+    void roundTripCarriesPlanesAudioIdentityAndTimecode();
+    void readerStartsAtNewestThenReadsInOrder();
+    void laggingReaderSkipsOverwrittenFramesAsDropped();
+    void overwrittenViewIsNotIntact();
+    void oversizedFrameIsRejected();
+    void waitWakesOnPublish();
+    void waitTimesOutWithoutPublish();
+    void readerSeesWriterClose();
+    void readerRejectsMissingSegment();
+    void segmentNamesAreSanitised();
+    void sinkPublishesBusFramesToReaders();
+    void sinkDefaultsFollowAssignment();
+};
+
+void TestShmFrameRing::roundTripCarriesPlanesAudioIdentityAndTimecode() {
+    const QString name = segmentName("rt");
+    ShmFrameRingWriter writer;
+    QString error;
+    QVERIFY2(writer.open(name, geometry(4), &error), qPrintable(error));
+    const OutputBusFrame frame = busFrame(7, 77);
+    QVERIFY(writer.publish(frame));
+
+    ShmFrameRingReader reader;
+    QVERIFY2(reader.open(name, &error), qPrintable(error));
+    QCOMPARE(reader.rate().numerator, 50);
+    QCOMPARE(reader.slotCount(), 4);
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.sequence, quint64(1));
+    QCOMPARE(view.identity, outputFrameIdentityFor(frame));
+    QCOMPARE(view.programmeTimecode100ns, qint64(7 * 200000));
+    QCOMPARE(view.width, 16);
+    QCOMPARE(view.height, 8);
+    QCOMPARE(view.stride[0], 16);
+    QCOMPARE(view.stride[1], 8);
+    QCOMPARE(int(view.plane[0][0]), 77);
+    QCOMPARE(int(view.plane[0][16 * 8 - 1]), 77);
+    QCOMPARE(int(view.plane[1][0]), 90);
+    QCOMPARE(int(view.plane[2][8 * 4 - 1]), 240);
+    QCOMPARE(view.sampleRate, 48000);
+    QCOMPARE(view.channels, 2);
+    QCOMPARE(view.startSample, qint64(7 * 960));
+    QCOMPARE(view.sampleFrames, 960);
+    QVERIFY(std::memcmp(view.pcm, frame.audio.pcm.constData(), size_t(frame.audio.pcm.size())) ==
+            0);
+    QVERIFY(view.publishedAtNs > 0);
+    QVERIFY(reader.isIntact(view));
+    QVERIFY(!reader.readNext(&view));
+    QCOMPARE(reader.dropped(), quint64(0));
+}
+
+void TestShmFrameRing::readerStartsAtNewestThenReadsInOrder() {
+    const QString name = segmentName("order");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    QVERIFY(writer.publish(busFrame(0, 10)));
+    QVERIFY(writer.publish(busFrame(1, 11)));
+
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(1));
+    QVERIFY(writer.publish(busFrame(2, 12)));
+    QVERIFY(writer.publish(busFrame(3, 13)));
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(2));
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(3));
+    QCOMPARE(reader.dropped(), quint64(0));
+}
+
+void TestShmFrameRing::laggingReaderSkipsOverwrittenFramesAsDropped() {
+    const QString name = segmentName("lag");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    QVERIFY(writer.publish(busFrame(0, 10)));
+
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+    for (int i = 1; i <= 10; ++i) QVERIFY(writer.publish(busFrame(i, uchar(10 + i))));
+
+    // Frames 2..11 were published; only the 3 newest (4 slots - 1 being rewritten) are safe.
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.sequence, quint64(9));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(8));
+    QCOMPARE(reader.dropped(), quint64(7));
+    QVERIFY(reader.readNext(&view));
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(10));
+    QVERIFY(!reader.readNext(&view));
+}
+
+void TestShmFrameRing::overwrittenViewIsNotIntact() {
+    const QString name = segmentName("torn");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(3), nullptr));
+    QVERIFY(writer.publish(busFrame(0, 10)));
+
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+    QVERIFY(reader.isIntact(view));
+    // A consumer still holding the view when the writer laps the ring must notice.
+    for (int i = 1; i <= 3; ++i) QVERIFY(writer.publish(busFrame(i, uchar(10 + i))));
+    QVERIFY(!reader.isIntact(view));
+}
+
+void TestShmFrameRing::oversizedFrameIsRejected() {
+    const QString name = segmentName("big");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    QVERIFY(!writer.publish(busFrame(0, 10, 640, 360)));
+    QCOMPARE(writer.published(), quint64(0));
+    QVERIFY(writer.publish(busFrame(0, 10)));
+    QCOMPARE(writer.published(), quint64(1));
+}
+
+void TestShmFrameRing::waitWakesOnPublish() {
+    const QString name = segmentName("wake");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+
+    QThread* publisher = QThread::create([&writer] {
+        QThread::msleep(50);
+        writer.publish(busFrame(0, 10));
+    });
+    QElapsedTimer timer;
+    timer.start();
+    publisher->start();
+    const bool woke = reader.waitForFrame(5000);
+    const qint64 elapsed = timer.elapsed();
+    publisher->wait();
+    delete publisher;
+    QVERIFY(woke);
+    QVERIFY2(elapsed < 2000, qPrintable(QStringLiteral("woke after %1 ms").arg(elapsed)));
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+}
+
+void TestShmFrameRing::waitTimesOutWithoutPublish() {
+    const QString name = segmentName("idle");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!reader.waitForFrame(30));
+    QVERIFY(timer.elapsed() >= 25);
+}
+
+void TestShmFrameRing::readerSeesWriterClose() {
+    const QString name = segmentName("close");
+    ShmFrameRingWriter writer;
+    QVERIFY(writer.open(name, geometry(4), nullptr));
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(name, nullptr));
+    QVERIFY(reader.writerOpen());
+    writer.close();
+    QVERIFY(!reader.writerOpen());
+    QVERIFY(!reader.waitForFrame(1000));
+    // The name is gone; a new reader cannot attach to the closed ring.
+    ShmFrameRingReader late;
+    QVERIFY(!late.open(name, nullptr));
+}
+
+void TestShmFrameRing::readerRejectsMissingSegment() {
+    ShmFrameRingReader reader;
+    QString error;
+    QVERIFY(!reader.open(segmentName("missing"), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!reader.isOpen());
+}
+
+void TestShmFrameRing::segmentNamesAreSanitised() {
+    QCOMPARE(shmring::nativeSegmentName(QStringLiteral("olr-pgm")), QStringLiteral("/olr-pgm"));
+    QCOMPARE(shmring::nativeSegmentName(QStringLiteral("/olr pgm/1")),
+             QStringLiteral("/olr-pgm-1"));
+    QCOMPARE(shmring::nativeSegmentName(QStringLiteral("  ")), QString());
+    QCOMPARE(shmring::nativeSegmentName(QString(64, QLatin1Char('a'))).size(), 31);
+}
+
+void TestShmFrameRing::sinkPublishesBusFramesToReaders() {
+    OutputTargetAssignment assignment;
+    assignment.id = QStringLiteral("pgm-shm");
+    assignment.kind = OutputTargetKind::SharedMemory;
+    assignment.enabled = true;
+    assignment.settings.insert(QStringLiteral("segmentName"), segmentName("sink"));
+    assignment.settings.insert(QStringLiteral("slots"), 3);
+
+    SharedMemoryOutputSink sink;
+    QVERIFY(sink.start(assignment, FrameRate::fromFraction(50, 1)));
+    QVERIFY(sink.isActive());
+    QVERIFY(sink.submit(busFrame(0, 10)));
+
+    ShmFrameRingReader reader;
+    QVERIFY(reader.open(segmentName("sink"), nullptr));
+    QCOMPARE(reader.slotCount(), 3);
+    ShmFrameView view;
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.identity.outputFrameIndex, qint64(0));
+
+    // A larger frame recreates the ring; the old mapping reports the writer gone.
+    QVERIFY(sink.submit(busFrame(1, 11, 64, 32)));
+    QVERIFY(!reader.writerOpen());
+    QVERIFY(reader.open(segmentName("sink"), nullptr));
+    QVERIFY(reader.readNext(&view));
+    QCOMPARE(view.width, 64);
+
+    const OutputSinkStatus status = sink.outputStatus();
+    QCOMPARE(status.acceptedFrames, qint64(2));
+    QCOMPARE(status.failedFrames, qint64(0));
+    QCOMPARE(status.lastDeliveredFrameIndex, qint64(1));
+    QCOMPARE(status.state, QStringLiteral("active"));
+
+    sink.stop();
+    QVERIFY(!sink.isActive());
+    QVERIFY(!reader.writerOpen());
+    QVERIFY(!sink.submit(busFrame(2, 12)));
+}
+
+void TestShmFrameRing::sinkDefaultsFollowAssignment() {
+    OutputTargetAssignment assignment;
+    assignment.sourceBus = OutputBusId::pgm();
+    QCOMPARE(SharedMemoryOutputSink::segmentNameFor(assignment), QStringLiteral("olr-pgm"));
+    assignment.sourceBus = OutputBusId::feed(2);
+    QCOMPARE(SharedMemoryOutputSink::segmentNameFor(assignment), QStringLiteral("olr-feed3"));
+    assignment.id = QStringLiteral("gfx");
+    QCOMPARE(SharedMemoryOutputSink::segmentNameFor(assignment), QStringLiteral("olr-gfx"));
+    QCOMPARE(SharedMemoryOutputSink::slotCountFor(assignment),
+             SharedMemoryOutputSink::kDefaultSlots);
+    assignment.settings.insert(QStringLiteral("slots"), 1);
+    QCOMPARE(SharedMemoryOutputSink::slotCountFor(assignment), 2);
+
+    SharedMemoryOutputSink sink;
+    assignment.kind = OutputTargetKind::Ndi;
+    assignment.enabled = true;
+    QVERIFY(!sink.start(assignment, FrameRate::fromFraction(50, 1)));
+    QCOMPARE(sink.outputStatus().state, QStringLiteral("invalid"));
+}
+
+QTEST_GUILESS_MAIN(TestShmFrameRing)
+#include "tst_shmframering.moc"
@@ -0,0 +1,78 @@
+// Unit tests for the storage stage of the benchmark ramp: load arithmetic, availability,
+// and one short real step against a temporary directory.
+#include <QtTest>
+#include <QDir>
+#include <QTemporaryDir>
+
+#include "recorder_engine/benchmark/benchmarkplan.h"
+#include "recorder_engine/benchmark/storagerunner.h"
+
+#include <atomic>
+
+class TestStorageRunner : public QObject {
+    Q_OBJECT
+private slots:
+    void loadArithmetic();
+    void unavailableWithoutWritableDirectory();
+    void lightStepSustainsAndCleansUp();
+    void cancelledStepWritesNothingMore();
+};
+
+void TestStorageRunner::loadArithmetic() {
+    BenchmarkConfig cfg;
+    cfg.bitrate = 8'000'000;
+    cfg.fps = 25;
+    // 1 MB/s video + 192 kB/s PCM + 25 metadata packets of 64 bytes.
+    QCOMPARE(StorageRunner::bytesPerFeedPerSecond(cfg), qint64(1'000'000 + 192'000 + 1'600));
+    // 4096 queued packets at 3 packets per feed per frame.
+    QCOMPARE(StorageRunner::queueAbsorbMs(1, 30), qint64(4096 * 1000 / 90));
+    QCOMPARE(StorageRunner::queueAbsorbMs(32, 30), qint64(4096 * 1000 / 2880));
+    QVERIFY(StorageRunner::queueAbsorbMs(0, 0) > 0); // degenerate input does not divide by 0
+}
+
+void TestStorageRunner::unavailableWithoutWritableDirectory() {
+    QVERIFY(!StorageRunner(QString()).available());
+    QTemporaryDir dir;
+    QVERIFY(!StorageRunner(dir.filePath(QStringLiteral("missing"))).available());
+    QVERIFY(StorageRunner(dir.path()).available());
+}
+
+void TestStorageRunner::lightStepSustainsAndCleansUp() {
+    QTemporaryDir dir;
+    StorageRunner runner(dir.path());
+    BenchmarkConfig cfg;
+    cfg.bitrate = 2'000'000; // 250 kB/s: any CI disk keeps up
+    cfg.fps = 30;
+    cfg.durationMsPerStep = 500;
+    std::atomic<bool> cancel{false};
+    const RampStepResult r = runner.runStep(1, cfg, cancel);
+    QCOMPARE(r.concurrency, 1);
+    QCOMPARE(r.framesRequired, int64_t(15));
+    QVERIFY(!r.startupFailed);
+    QVERIFY2(rampStepHasHeadroom(r), qPrintable(QStringLiteral("%1 of %2 frames, budget %3")
+                                                    .arg(r.framesProcessed)
+                                                    .arg(r.framesRequired)
+                                                    .arg(r.budgetMet)));
+    const StorageStepStats stats = runner.stepStats(1);
+    QVERIFY(stats.writeMBps > 0.0);
+    QVERIFY(stats.writeMaxMs >= stats.writeP99Ms);
+    // The scratch file is gone once the step returns.
+    QVERIFY(QDir(dir.path()).entryList(QDir::Files | QDir::Hidden).isEmpty());
+}
+
+void TestStorageRunner::cancelledStepWritesNothingMore() {
+    QTemporaryDir dir;
+    StorageRunner runner(dir.path());
+    BenchmarkConfig cfg;
+    cfg.durationMsPerStep = 10'000;
+    std::atomic<bool> cancel{true};
+    QElapsedTimer t;
+    t.start();
+    const RampStepResult r = runner.runStep(4, cfg, cancel);
+    QVERIFY(t.elapsed() < 2000);
+    QCOMPARE(r.framesProcessed, 0);
+    QVERIFY(!rampStepSustained(r));
+}
+
+QTEST_GUILESS_MAIN(TestStorageRunner)
+#include "tst_storagerunner.moc"
@@ -0,0 +1,120 @@
+#include <QtTest>
+
+#include "recorder_engine/ingest/syntheticingestsession.h"
+
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+class TestSyntheticIngest : public QObject {
+    Q_OBJECT
+private slots:
+    void urlParsing();
+    void pacesFramesAndContiguousAudio();
+    void shouldStopEndsRun();
+};
+
+void TestSyntheticIngest::urlParsing() {
+    QVERIFY(SyntheticIngestSession::supportsUrl(QUrl(QStringLiteral("synthetic://cam1"))));
+    QVERIFY(SyntheticIngestSession::supportsUrl(QUrl(QStringLiteral("SYNTHETIC://cam1"))));
+    QVERIFY(!SyntheticIngestSession::supportsUrl(QUrl(QStringLiteral("ndi://cam1"))));
+    QCOMPARE(SyntheticIngestSession::fpsFromUrl(QUrl(QStringLiteral("synthetic://a?fps=50"))), 50);
+    QCOMPARE(SyntheticIngestSession::fpsFromUrl(QUrl(QStringLiteral("synthetic://a"))),
+             SyntheticIngestSession::kDefaultFps);
+    QCOMPARE(SyntheticIngestSession::fpsFromUrl(QUrl(QStringLiteral("synthetic://a?fps=x"))),
+             SyntheticIngestSession::kDefaultFps);
+    QCOMPARE(SyntheticIngestSession::fpsFromUrl(QUrl(QStringLiteral("synthetic://a?fps=1000"))),
+             240);
+
+    SyntheticIngestSession session(0, 64, 48, nullptr);
+    QVERIFY(!session.open(QUrl(QStringLiteral("srt://127.0.0.1:9000")), IngestCallbacks{}));
+}
+
+void TestSyntheticIngest::pacesFramesAndContiguousAudio() {
+    QElapsedTimer clock;
+    clock.start();
+    std::mutex mutex;
+    std::vector<int64_t> videoPts;
+    int64_t nextSample = -1;
+    bool audioContiguous = true;
+    int64_t audioSamples = 0;
+    bool frameSizeOk = true;
+    bool connected = false;
+
+    IngestCallbacks callbacks;
+    callbacks.recordingClockMs = [&clock]() { return int64_t(clock.elapsed()) + 1000; };
+    callbacks.setConnected = [&connected](bool on) { connected = on; };
+    callbacks.onVideoFrame = [&](DecodedVideoFrame decoded) {
+        std::lock_guard<std::mutex> lk(mutex);
+        frameSizeOk = frameSizeOk && decoded.frame->width == 64 && decoded.frame->height == 48 &&
+                      decoded.frame->format == AV_PIX_FMT_YUV420P;
+        videoPts.push_back(decoded.sourcePtsMs);
+        av_frame_free(&decoded.frame);
+    };
+    callbacks.onAudioChunk = [&](DecodedAudioChunk chunk) {
+        std::lock_guard<std::mutex> lk(mutex);
+        const int64_t samples = chunk.pcmS16Stereo.size() / kDecodedAudioBytesPerSample;
+        if (nextSample >= 0 && chunk.startSample != nextSample) audioContiguous = false;
+        nextSample = chunk.startSample + samples;
+        audioSamples += samples;
+    };
+
+    SyntheticIngestSession session(1, 64, 48, nullptr);
+    QVERIFY(session.open(QUrl(QStringLiteral("synthetic://cam?fps=50")), callbacks));
+    QVERIFY(connected);
+    QElapsedTimer wall;
+    wall.start();
+    std::thread stopper([&session]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        session.requestStop();
+    });
+    session.run();
+    stopper.join();
+    const qint64 ranMs = wall.elapsed();
+
+    std::lock_guard<std::mutex> lk(mutex);
+    QVERIFY(frameSizeOk);
+    // ~25 frames in 500 ms at 50 fps; generous bounds for a loaded CI host.
+    const qint64 expected = ranMs * 50 / 1000;
+    QVERIFY2(qint64(videoPts.size()) + session.framesDropped() >= expected - 2,
+             qPrintable(QStringLiteral("%1 frames + %2 drops in %3 ms")
+                            .arg(videoPts.size())
+                            .arg(session.framesDropped())
+                            .arg(ranMs)));
+    QVERIFY(qint64(videoPts.size()) <= expected + 2);
+    QCOMPARE(session.framesDelivered(), qint64(videoPts.size()));
+    for (size_t i = 1; i < videoPts.size(); ++i) QVERIFY(videoPts[i] >= videoPts[i - 1]);
+    QVERIFY(videoPts.front() >= 1000);
+
+    QVERIFY(audioContiguous);
+    QVERIFY(nextSample > 0);
+    // Audio tracks elapsed wall time to within 40 ms.
+    QVERIFY(qAbs(audioSamples - ranMs * 48) <= 48 * 40);
+}
+
+void TestSyntheticIngest::shouldStopEndsRun() {
+    std::atomic<bool> running{true};
+    IngestCallbacks callbacks;
+    callbacks.recordingClockMs = []() { return int64_t(0); };
+    std::atomic<int> frames{0};
+    callbacks.onVideoFrame = [&](DecodedVideoFrame decoded) {
+        av_frame_free(&decoded.frame);
+        if (++frames == 3) running = false;
+    };
+
+    SyntheticIngestSession session(0, 32, 32, &running);
+    QVERIFY(session.open(QUrl(QStringLiteral("synthetic://cam?fps=100&audio=0")), callbacks));
+    session.run(); // returns once captureRunning drops
+    QCOMPARE(frames.load(), 3);
+}
+
+QTEST_GUILESS_MAIN(TestSyntheticIngest)
+#include "tst_syntheticingest.moc"
@@ -0,0 +1,309 @@
+#include <QtTest>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include "recorder_engine/threadplacement.h"
+
+class ScopedEnv {
+public:
+    ScopedEnv(const char* name, const QByteArray& value)
+        : m_name(name), m_hadValue(qEnvironmentVariableIsSet(name)), m_previous(qgetenv(name)) {
+        qputenv(m_name, value);
+    }
+
+    ~ScopedEnv() {
+        if (m_hadValue)
+            qputenv(m_name, m_previous);
+        else
+            qunsetenv(m_name);
+    }
+
+private:
+    const char* m_name = nullptr;
+    bool m_hadValue = false;
+    QByteArray m_previous;
+};
+
+static bool writeFile(const QString& path, const QByteArray& contents) {
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) return false;
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    return file.write(contents) == contents.size();
+}
+
+// Two sockets, one NUMA node each, four cores per socket with two SMT threads per core,
+// numbered the way Linux does: first threads 0-7, their siblings 8-15.
+//   node0 = 0-3,8-11   node1 = 4-7,12-15
+static bool writeTwoNodeTopology(const QString& root) {
+    bool ok = writeFile(root + "/node/node0/cpulist", "0-3,8-11\n") &&
+              writeFile(root + "/node/node1/cpulist", "4-7,12-15\n");
+    for (int cpu = 0; cpu < 16; ++cpu) {
+        const QString base = QStringLiteral("%1/cpu/cpu%2").arg(root).arg(cpu);
+        ok = ok && writeFile(base + "/topology/core_id", QByteArray::number(cpu % 4)) &&
+             writeFile(base + "/topology/physical_package_id", QByteArray::number(cpu % 8 / 4));
+        if (cpu > 0) ok = ok && writeFile(base + "/online", "1\n");
+    }
+    return ok;
+}
+
+class TestThreadPlacement : public QObject {
+    Q_OBJECT
+private slots:
+    void cleanup();
+    void parsesAndFormatsCpuLists();
+    void readsTopologyFromSysfs();
+    void autoReservesOutputAndMuxCoresAndSplitsSourcesByNode();
+    void autoLeavesSmallMachinesFloating();
+    void autoGivesEachPlaybackChannelItsOwnOutputCore();
+    void explicitSetsOverrideAutoAndManualPinsOnlyThem();
+    void policyReadsEnvironment();
+    void offDescribesAsEmpty();
+    void placesCurrentThreadAndScopedPlacementRestores();
+    void threadCpuTimeCountsOnlyTheCallingThread();
+};
+
+void TestThreadPlacement::cleanup() {
+    ThreadPlacement::configure(ThreadPlacementPlan());
+}
+
+void TestThreadPlacement::parsesAndFormatsCpuLists() {
+    QCOMPARE(ThreadPlacement::parseCpuList("0-3,8, 10-11\n"), QList<int>({0, 1, 2, 3, 8, 10, 11}));
+    QCOMPARE(ThreadPlacement::parseCpuList("5,1,5"), QList<int>({1, 5}));
+    QVERIFY(ThreadPlacement::parseCpuList("").isEmpty());
+    // Malformed parts are dropped; the rest still counts.
+    QCOMPARE(ThreadPlacement::parseCpuList("x,3-1,2-,4"), QList<int>({4}));
+
+    QCOMPARE(ThreadPlacement::formatCpuList({11, 0, 1, 2, 3, 8, 10}), QString("0-3,8,10-11"));
+    QCOMPARE(ThreadPlacement::formatCpuList({}), QString());
+    QCOMPARE(ThreadPlacement::parseCpuList(ThreadPlacement::formatCpuList({7, 6, 5, 15})),
+             QList<int>({5, 6, 7, 15}));
+}
+
+void TestThreadPlacement::readsTopologyFromSysfs() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    QVERIFY(writeFile(dir.path() + "/cpu/cpu15/online", "0\n"));
+
+    const CpuTopology all = CpuTopology::fromSysfs(dir.path(), {});
+    QCOMPARE(all.cpus.size(), 15); // cpu15 is offline
+    QCOMPARE(all.nodes(), QList<int>({0, 1}));
+    QCOMPARE(all.cpusOfNode(1), QList<int>({4, 5, 6, 7, 12, 13, 14}));
+    QCOMPARE(all.physicalCoreCount(), 8);
+    const QList<QList<int>> cores = all.coresOfNode(0);
+    QCOMPARE(cores.size(), 4);
+    QCOMPARE(cores.first(), QList<int>({0, 8}));
+    QCOMPARE(cores.last(), QList<int>({3, 11}));
+
+    // The process affinity mask limits what placement may use.
+    const CpuTopology allowed = CpuTopology::fromSysfs(dir.path(), {0, 1, 8, 9});
+    QCOMPARE(allowed.nodes(), QList<int>({0}));
+    QCOMPARE(allowed.physicalCoreCount(), 2);
+}
+
+void TestThreadPlacement::autoReservesOutputAndMuxCoresAndSplitsSourcesByNode() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    ThreadPlacementPolicy policy;
+    policy.mode = ThreadPlacementPolicy::Mode::Auto;
+    const ThreadPlacementPlan plan =
+        ThreadPlacementPlan::build(CpuTopology::fromSysfs(dir.path(), {}), policy);
+
+    QVERIFY(plan.isActive());
+    QCOMPARE(plan.cpusFor(ThreadRole::Output), QList<int>({3, 11}));
+    QCOMPARE(plan.cpusFor(ThreadRole::Mux), QList<int>({2, 10}));
+    QCOMPARE(plan.cpusFor(ThreadRole::Playback), QList<int>({0, 1, 8, 9}));
+
+    // Capture and encode of one source share a node; sources alternate between nodes and
+    // never land on the output or mux cores.
+    const QList<int> node0 = {0, 1, 8, 9};
+    const QList<int> node1 = {4, 5, 6, 7, 12, 13, 14, 15};
+    QCOMPARE(plan.cpusFor(ThreadRole::Capture, 0), node0);
+    QCOMPARE(plan.cpusFor(ThreadRole::Encode, 0), node0);
+    QCOMPARE(plan.cpusFor(ThreadRole::Capture, 1), node1);
+    QCOMPARE(plan.cpusFor(ThreadRole::Encode, 1), node1);
+    QCOMPARE(plan.cpusFor(ThreadRole::Encode, 2), node0);
+
+    QCOMPARE(plan.describe(),
+             QString("output 3,11; mux 2,10; playback 0-1,8-9; sources 0-1,8-9 | 4-7,12-15"));
+}
+
+void TestThreadPlacement::autoLeavesSmallMachinesFloating() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    ThreadPlacementPolicy policy;
+    policy.mode = ThreadPlacementPolicy::Mode::Auto;
+
+    // Two cores: pinning would only take CPUs away from the encoders.
+    const ThreadPlacementPlan tiny =
+        ThreadPlacementPlan::build(CpuTopology::fromSysfs(dir.path(), {0, 1, 8, 9}), policy);
+    QVERIFY(!tiny.isActive());
+    QVERIFY(tiny.describe().isEmpty());
+
+    // Four cores: the output core is reserved but the muxer still floats.
+    const ThreadPlacementPlan small =
+        ThreadPlacementPlan::build(CpuTopology::fromSysfs(dir.path(), {0, 1, 2, 3}), policy);
+    QCOMPARE(small.cpusFor(ThreadRole::Output), QList<int>({3}));
+    QVERIFY(small.cpusFor(ThreadRole::Mux).isEmpty());
+    QCOMPARE(small.cpusFor(ThreadRole::Encode, 5), QList<int>({0, 1, 2}));
+}
+
+void TestThreadPlacement::autoGivesEachPlaybackChannelItsOwnOutputCore() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    const CpuTopology topology = CpuTopology::fromSysfs(dir.path(), {});
+    ThreadPlacementPolicy policy;
+    policy.mode = ThreadPlacementPolicy::Mode::Auto;
+    policy.outputChannels = 4;
+    const ThreadPlacementPlan plan = ThreadPlacementPlan::build(topology, policy);
+
+    // Node 0 has four cores: output, mux, one further channel, and playback keeps the last.
+    QCOMPARE(plan.cpusFor(ThreadRole::Output, 0), QList<int>({3, 11}));
+    QCOMPARE(plan.cpusFor(ThreadRole::Output, 1), QList<int>({1, 9}));
+    QVERIFY(plan.cpusFor(ThreadRole::Output, 2).isEmpty()); // floats, never shares
+    QCOMPARE(plan.cpusFor(ThreadRole::Playback), QList<int>({0, 8}));
+    QCOMPARE(plan.cpusFor(ThreadRole::Encode, 0), QList<int>({0, 8}));
+    QCOMPARE(plan.describe(),
+             QString("output 3,11 | 1,9; mux 2,10; playback 0,8; sources 0,8 | 4-7,12-15"));
+
+    // An explicit output set is channel 0's alone.
+    policy.cpus.insert(ThreadRole::Output, {15});
+    const ThreadPlacementPlan pinned = ThreadPlacementPlan::build(topology, policy);
+    QCOMPARE(pinned.cpusFor(ThreadRole::Output), QList<int>({15}));
+    QCOMPARE(pinned.cpusFor(ThreadRole::Output, 1), QList<int>({1, 9}));
+}
+
+void TestThreadPlacement::explicitSetsOverrideAutoAndManualPinsOnlyThem() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    const CpuTopology topology = CpuTopology::fromSysfs(dir.path(), {});
+
+    ThreadPlacementPolicy policy;
+    policy.mode = ThreadPlacementPolicy::Mode::Auto;
+    policy.cpus.insert(ThreadRole::Output, {15});
+    const ThreadPlacementPlan autoPlan = ThreadPlacementPlan::build(topology, policy);
+    QCOMPARE(autoPlan.cpusFor(ThreadRole::Output), QList<int>({15}));
+    QCOMPARE(autoPlan.cpusFor(ThreadRole::Mux), QList<int>({2, 10}));
+
+    policy.mode = ThreadPlacementPolicy::Mode::Manual;
+    const ThreadPlacementPlan manual = ThreadPlacementPlan::build(topology, policy);
+    QCOMPARE(manual.cpusFor(ThreadRole::Output), QList<int>({15}));
+    QVERIFY(manual.cpusFor(ThreadRole::Mux).isEmpty());
+    QVERIFY(manual.cpusFor(ThreadRole::Encode, 0).isEmpty());
+    QCOMPARE(manual.describe(), QString("output 15"));
+}
+
+void TestThreadPlacement::policyReadsEnvironment() {
+    {
+        ScopedEnv mode("OLR_THREAD_PLACEMENT", "");
+        ScopedEnv encode("OLR_CPUS_ENCODE", "");
+        ScopedEnv output("OLR_CPUS_OUTPUT", "");
+        const ThreadPlacementPolicy policy = ThreadPlacementPolicy::fromEnvironment();
+        QCOMPARE(policy.mode, ThreadPlacementPolicy::Mode::Off);
+        QVERIFY(policy.cpus.isEmpty());
+    }
+    {
+        ScopedEnv mode("OLR_THREAD_PLACEMENT", "Auto");
+        ScopedEnv output("OLR_CPUS_OUTPUT", "7");
+        const ThreadPlacementPolicy policy = ThreadPlacementPolicy::fromEnvironment();
+        QCOMPARE(policy.mode, ThreadPlacementPolicy::Mode::Auto);
+        QCOMPARE(policy.cpus.value(ThreadRole::Output), QList<int>({7}));
+    }
+    {
+        // Role sets without a mode pin just those roles.
+        ScopedEnv mode("OLR_THREAD_PLACEMENT", "");
+        ScopedEnv encode("OLR_CPUS_ENCODE", "0-5");
+        const ThreadPlacementPolicy policy = ThreadPlacementPolicy::fromEnvironment();
+        QCOMPARE(policy.mode, ThreadPlacementPolicy::Mode::Manual);
+        QCOMPARE(policy.cpus.value(ThreadRole::Encode), QList<int>({0, 1, 2, 3, 4, 5}));
+    }
+    {
+        ScopedEnv mode("OLR_THREAD_PLACEMENT", "off");
+        ScopedEnv encode("OLR_CPUS_ENCODE", "0-5");
+        QVERIFY(!ThreadPlacementPlan::build(CpuTopology::detect(),
+                                            ThreadPlacementPolicy::fromEnvironment())
+                     .isActive());
+    }
+}
+
+void TestThreadPlacement::offDescribesAsEmpty() {
+    QTemporaryDir dir;
+    QVERIFY(writeTwoNodeTopology(dir.path()));
+    const ThreadPlacementPlan plan =
+        ThreadPlacementPlan::build(CpuTopology::fromSysfs(dir.path(), {}), {});
+    QVERIFY(!plan.isActive());
+    QVERIFY(plan.describe().isEmpty());
+    QVERIFY(plan.cpusFor(ThreadRole::Output).isEmpty());
+    // A floating role is not a failure.
+    QVERIFY(ThreadPlacement::placeCurrentThread(ThreadRole::Playback));
+}
+
+void TestThreadPlacement::placesCurrentThreadAndScopedPlacementRestores() {
+#if defined(Q_OS_LINUX)
+    const QList<int> original = ThreadPlacement::currentThreadCpus();
+    QVERIFY(!original.isEmpty());
+    const int cpu = original.first();
+
+    ThreadPlacementPlan plan;
+    plan.mux = {cpu};
+    ThreadPlacement::configure(plan);
+
+    QList<int> pinned;
+    bool placed = false;
+    QThread* thread = QThread::create([&] {
+        placed = ThreadPlacement::placeCurrentThread(ThreadRole::Mux);
+        pinned = ThreadPlacement::currentThreadCpus();
+    });
+    thread->start();
+    QVERIFY(thread->wait(5000));
+    delete thread;
+    QVERIFY(placed);
+    QCOMPARE(pinned, QList<int>({cpu}));
+
+    {
+        ScopedThreadPlacement placement(ThreadRole::Mux);
+        QCOMPARE(ThreadPlacement::currentThreadCpus(), QList<int>({cpu}));
+    }
+    QCOMPARE(ThreadPlacement::currentThreadCpus(), original);
+#else
+    QSKIP("thread affinity is only applied on Linux");
+#endif
+}
+
+void TestThreadPlacement::threadCpuTimeCountsOnlyTheCallingThread() {
+    if (ThreadPlacement::currentThreadCpuNs() < 0) QSKIP("thread CPU time is not reported here");
+
+    qint64 busyNs = -1;
+    qint64 idleNs = -1;
+    QThread* busy = QThread::create([&] {
+        const qint64 start = ThreadPlacement::currentThreadCpuNs();
+        QElapsedTimer timer;
+        timer.start();
+        volatile quint64 sink = 0;
+        while (timer.elapsed() < 50)
+            sink = sink + 1;
+        busyNs = ThreadPlacement::currentThreadCpuNs() - start;
+    });
+    QThread* idle = QThread::create([&] {
+        const qint64 start = ThreadPlacement::currentThreadCpuNs();
+        QThread::msleep(50);
+        idleNs = ThreadPlacement::currentThreadCpuNs() - start;
+    });
+    busy->start();
+    idle->start();
+    QVERIFY(busy->wait(5000));
+    QVERIFY(idle->wait(5000));
+    delete busy;
+    delete idle;
+
+    // A spinning thread accrues CPU time; a sleeping one next to it does not.
+    QVERIFY(busyNs > 10 * 1000000LL);
+    QVERIFY(idleNs >= 0);
+    QVERIFY(idleNs < 10 * 1000000LL);
+}
+
+QTEST_GUILESS_MAIN(TestThreadPlacement)
+#include "tst_threadplacement.moc"
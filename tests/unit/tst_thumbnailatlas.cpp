@@ -0,0 +1,157 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "playback/thumbnailatlas.h"
+#include "playback/thumbnailindexer.h"
+
+namespace {
+// A solid-colour thumbnail whose red channel encodes `tag`.
+QByteArray solidThumb(int tag) {
+    QByteArray rgb(ThumbnailAtlas::kThumbBytes, char(0));
+    for (int i = 0; i < ThumbnailAtlas::kThumbBytes; i += 3) {
+        rgb[i] = char(tag);
+        rgb[i + 1] = char(0x40);
+        rgb[i + 2] = char(0x80);
+    }
+    return rgb;
+}
+
+bool appendTag(ThumbnailAtlas& atlas, int view, qint64 ptsMs, int tag) {
+    const QByteArray rgb = solidThumb(tag);
+    return atlas.append(view, ptsMs, reinterpret_cast<const uchar*>(rgb.constData()));
+}
+
+int tagOf(const QImage& image) { return qRed(image.pixel(0, 0)); }
+} // namespace
+
+class TestThumbnailAtlas : public QObject {
+    Q_OBJECT
+private slots:
+    void atlasPathSitsNextToVideo();
+    void imageIsNearestAtOrBeforePerView();
+    void outOfOrderAppendIsDropped();
+    void growsPastInitialCapacity();
+    void reopenResumesCommittedRecords();
+    void foreignFileIsRecreated();
+    void closedAtlasRejectsAppendsAndReads();
+    void dueEveryIntervalPerView();
+    void lowresKeepsThumbnailWidthCovered();
+};
+
+void TestThumbnailAtlas::atlasPathSitsNextToVideo() {
+    QCOMPARE(ThumbnailAtlas::atlasPathFor(QStringLiteral("/rec/game.mkv")),
+             QStringLiteral("/rec/game.mkv.thumbs"));
+}
+
+void TestThumbnailAtlas::imageIsNearestAtOrBeforePerView() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ThumbnailAtlas atlas;
+    QVERIFY(atlas.open(dir.filePath(QStringLiteral("a.thumbs"))));
+    QVERIFY(appendTag(atlas, 0, 0, 10));
+    QVERIFY(appendTag(atlas, 1, 0, 20));
+    QVERIFY(appendTag(atlas, 0, 2000, 11));
+    QCOMPARE(atlas.count(), 3);
+    QCOMPARE(atlas.viewCount(), 2);
+
+    const QImage img = atlas.image(0, 1999);
+    QCOMPARE(img.size(), QSize(ThumbnailAtlas::kThumbWidth, ThumbnailAtlas::kThumbHeight));
+    QCOMPARE(tagOf(img), 10);
+    QCOMPARE(tagOf(atlas.image(0, 2000)), 11);
+    QCOMPARE(tagOf(atlas.image(0, 99999)), 11);
+    QCOMPARE(tagOf(atlas.image(1, 99999)), 20);
+    QVERIFY(atlas.image(0, -1).isNull());
+    QVERIFY(atlas.image(2, 0).isNull()); // view never indexed
+    QCOMPARE(atlas.newestPtsMs(0).value(), qint64(2000));
+}
+
+void TestThumbnailAtlas::outOfOrderAppendIsDropped() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ThumbnailAtlas atlas;
+    QVERIFY(atlas.open(dir.filePath(QStringLiteral("a.thumbs"))));
+    QVERIFY(appendTag(atlas, 0, 4000, 1));
+    QVERIFY(!appendTag(atlas, 0, 4000, 2));
+    QVERIFY(!appendTag(atlas, 0, 2000, 3));
+    QVERIFY(!appendTag(atlas, -1, 6000, 4));
+    QCOMPARE(atlas.count(), 1);
+    QCOMPARE(tagOf(atlas.image(0, 4000)), 1);
+}
+
+void TestThumbnailAtlas::growsPastInitialCapacity() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    ThumbnailAtlas atlas;
+    QVERIFY(atlas.open(dir.filePath(QStringLiteral("a.thumbs"))));
+    constexpr int kRecords = 300; // past the first growth step
+    for (int i = 0; i < kRecords; ++i) QVERIFY(appendTag(atlas, 0, i * 1000, i % 256));
+    QCOMPARE(atlas.count(), kRecords);
+    QCOMPARE(tagOf(atlas.image(0, 5000)), 5);
+    QCOMPARE(tagOf(atlas.image(0, (kRecords - 1) * 1000)), (kRecords - 1) % 256);
+}
+
+void TestThumbnailAtlas::reopenResumesCommittedRecords() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("a.thumbs"));
+    {
+        ThumbnailAtlas atlas;
+        QVERIFY(atlas.open(path));
+        QVERIFY(appendTag(atlas, 0, 0, 7));
+        QVERIFY(appendTag(atlas, 2, 500, 9));
+    }
+    // close() trims the pre-grown tail to the committed records.
+    QVERIFY(QFileInfo(path).size() < qint64(4) * ThumbnailAtlas::kThumbBytes);
+
+    ThumbnailAtlas atlas;
+    QVERIFY(atlas.open(path));
+    QCOMPARE(atlas.count(), 2);
+    QCOMPARE(atlas.viewCount(), 3);
+    QCOMPARE(tagOf(atlas.image(2, 500)), 9);
+    QCOMPARE(atlas.newestPtsMs(0).value(), qint64(0));
+    QVERIFY(appendTag(atlas, 0, 2000, 8)); // resumes appending
+    QCOMPARE(tagOf(atlas.image(0, 2000)), 8);
+}
+
+void TestThumbnailAtlas::foreignFileIsRecreated() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("a.thumbs"));
+    {
+        QFile junk(path);
+        QVERIFY(junk.open(QIODevice::WriteOnly));
+        junk.write(QByteArray(4096, 'z'));
+    }
+    ThumbnailAtlas atlas;
+    QVERIFY(atlas.open(path));
+    QCOMPARE(atlas.count(), 0);
+    QVERIFY(appendTag(atlas, 0, 0, 1));
+    QCOMPARE(tagOf(atlas.image(0, 0)), 1);
+}
+
+void TestThumbnailAtlas::closedAtlasRejectsAppendsAndReads() {
+    ThumbnailAtlas atlas;
+    QVERIFY(!atlas.isOpen());
+    QVERIFY(!appendTag(atlas, 0, 0, 1));
+    QVERIFY(atlas.image(0, 0).isNull());
+    QVERIFY(!atlas.open(QStringLiteral("/nonexistent/olr/a.thumbs")));
+}
+
+void TestThumbnailAtlas::dueEveryIntervalPerView() {
+    QVERIFY(ThumbnailIndexer::isDue(std::nullopt, 0, 2000));
+    QVERIFY(!ThumbnailIndexer::isDue(qint64(0), 1999, 2000));
+    QVERIFY(ThumbnailIndexer::isDue(qint64(0), 2000, 2000));
+    QVERIFY(!ThumbnailIndexer::isDue(qint64(4000), 1000, 2000)); // re-read after a resume seek
+}
+
+void TestThumbnailAtlas::lowresKeepsThumbnailWidthCovered() {
+    QCOMPARE(ThumbnailIndexer::lowresFor(1920, 3), 3); // 240 px wide
+    QCOMPARE(ThumbnailIndexer::lowresFor(1280, 3), 3); // 160 px wide
+    QCOMPARE(ThumbnailIndexer::lowresFor(720, 3), 2);  // 180 px wide
+    QCOMPARE(ThumbnailIndexer::lowresFor(3840, 3), 3); // capped by the decoder
+    QCOMPARE(ThumbnailIndexer::lowresFor(1920, 0), 0); // no lowres support
+    QCOMPARE(ThumbnailIndexer::lowresFor(100, 3), 0);
+}
+
+QTEST_MAIN(TestThumbnailAtlas)
+#include "tst_thumbnailatlas.moc"
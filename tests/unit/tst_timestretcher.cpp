@@ -0,0 +1,201 @@
+#include <QtTest>
+
+#include "playback/timestretcher.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+constexpr int kSampleRate = 48000;
+constexpr int kChunkFrames = 1024; // a typical decoded AAC frame
+constexpr double kPi = 3.14159265358979323846;
+
+std::vector<int16_t> stereoSine(double hz, int frames, double amplitude = 10000.0) {
+    std::vector<int16_t> pcm(size_t(frames) * 2);
+    for (int i = 0; i < frames; ++i) {
+        const auto v = int16_t(amplitude * std::sin(2.0 * kPi * hz * i / kSampleRate));
+        pcm[size_t(i) * 2] = v;
+        pcm[size_t(i) * 2 + 1] = v;
+    }
+    return pcm;
+}
+
+// Feeds `pcm` in decoder-sized chunks, as PlaybackWorker releases it.
+QByteArray stretch(TimeStretcher& stretcher, const std::vector<int16_t>& pcm) {
+    QByteArray out;
+    const int frames = int(pcm.size() / 2);
+    for (int at = 0; at < frames; at += kChunkFrames)
+        stretcher.process(pcm.data() + size_t(at) * 2, qMin(kChunkFrames, frames - at), out);
+    return out;
+}
+
+// Left-channel zero-crossing frequency and RMS over [from, to) frames.
+void measure(const QByteArray& pcm, int from, int to, double& hz, double& rms) {
+    const auto* s = reinterpret_cast<const int16_t*>(pcm.constData());
+    int crossings = 0;
+    double energy = 0.0;
+    for (int i = from; i < to; ++i) {
+        if (i > from && (s[2 * (i - 1)] < 0) != (s[2 * i] < 0)) crossings++;
+        energy += double(s[2 * i]) * s[2 * i];
+    }
+    hz = crossings / 2.0 / (double(to - from) / kSampleRate);
+    rms = std::sqrt(energy / (to - from));
+}
+} // namespace
+
+class TestTimeStretcher : public QObject {
+    Q_OBJECT
+private slots:
+    void outputLengthFollowsRate_data();
+    void outputLengthFollowsRate();
+    void pitchAndLevelArePreserved_data();
+    void pitchAndLevelArePreserved();
+    void rateChangeMidStreamHasNoDropout();
+    void rateIsClamped();
+    void resetRestartsTheStream();
+    void sixteenFeedsRunWellBelowRealTime();
+};
+
+void TestTimeStretcher::outputLengthFollowsRate_data() {
+    QTest::addColumn<double>("rate");
+    QTest::newRow("0.25x") << 0.25;
+    QTest::newRow("0.5x") << 0.5;
+    QTest::newRow("1x") << 1.0;
+    QTest::newRow("1.5x") << 1.5;
+    QTest::newRow("2x") << 2.0;
+}
+
+void TestTimeStretcher::outputLengthFollowsRate() {
+    QFETCH(double, rate);
+    TimeStretcher stretcher(kSampleRate, 2);
+    stretcher.setRate(rate);
+    const int inFrames = 2 * kSampleRate;
+    const QByteArray out = stretch(stretcher, stereoSine(440.0, inFrames));
+
+    const int outFrames = int(out.size() / (2 * sizeof(int16_t)));
+    QCOMPARE(qint64(outFrames), stretcher.outputFrames());
+    QCOMPARE(stretcher.inputFrames(), qint64(inFrames));
+    QCOMPARE(outFrames % stretcher.hopFrames(), 0);
+    // Only the final segment plus search radius (< 30 ms of input) may still be pending.
+    const double expected = inFrames / rate;
+    QVERIFY2(outFrames <= expected && outFrames >= expected - 0.03 * kSampleRate / rate,
+             qPrintable(QStringLiteral("%1 frames for %2 expected").arg(outFrames).arg(expected)));
+}
+
+void TestTimeStretcher::pitchAndLevelArePreserved_data() {
+    QTest::addColumn<double>("rate");
+    QTest::addColumn<double>("hz");
+    QTest::newRow("0.5x 440 Hz") << 0.5 << 440.0;
+    QTest::newRow("0.5x 150 Hz") << 0.5 << 150.0;
+    QTest::newRow("2x 440 Hz") << 2.0 << 440.0;
+    QTest::newRow("0.25x 1 kHz") << 0.25 << 1000.0;
+}
+
+void TestTimeStretcher::pitchAndLevelArePreserved() {
+    QFETCH(double, rate);
+    QFETCH(double, hz);
+    TimeStretcher stretcher(kSampleRate, 2);
+    stretcher.setRate(rate);
+    const QByteArray out = stretch(stretcher, stereoSine(hz, 2 * kSampleRate));
+    const int frames = int(out.size() / (2 * sizeof(int16_t)));
+
+    // Skip the fade-in hop; a misaligned splice would show up as extra zero crossings
+    // (pitch drift) and as comb cancellation (level loss).
+    double measuredHz = 0.0;
+    double rms = 0.0;
+    measure(out, kSampleRate / 20, frames, measuredHz, rms);
+    QVERIFY2(qAbs(measuredHz - hz) < hz * 0.01, qPrintable(QString::number(measuredHz)));
+    const double inputRms = 10000.0 / std::sqrt(2.0);
+    QVERIFY2(qAbs(rms - inputRms) < inputRms * 0.02, qPrintable(QString::number(rms)));
+}
+
+void TestTimeStretcher::rateChangeMidStreamHasNoDropout() {
+    TimeStretcher stretcher(kSampleRate, 2);
+    stretcher.setRate(0.5);
+    const std::vector<int16_t> sine = stereoSine(440.0, 2 * kSampleRate);
+    QByteArray out;
+    const int frames = int(sine.size() / 2);
+    for (int at = 0; at < frames; at += kChunkFrames) {
+        if (at >= frames / 2) stretcher.setRate(2.0);
+        stretcher.process(sine.data() + size_t(at) * 2, qMin(kChunkFrames, frames - at), out);
+    }
+    QCOMPARE(stretcher.rate(), 2.0);
+
+    // Every 10 ms hop after the fade-in keeps the sine's full peak.
+    const auto* s = reinterpret_cast<const int16_t*>(out.constData());
+    const int hop = stretcher.hopFrames();
+    const int hops = int(out.size() / (2 * sizeof(int16_t))) / hop;
+    for (int h = 1; h < hops; ++h) {
+        int peak = 0;
+        for (int i = h * hop; i < (h + 1) * hop; ++i) peak = qMax(peak, qAbs(int(s[2 * i])));
+        QVERIFY2(peak > 9500, qPrintable(QStringLiteral("hop %1 peak %2").arg(h).arg(peak)));
+    }
+}
+
+void TestTimeStretcher::rateIsClamped() {
+    TimeStretcher stretcher;
+    stretcher.setRate(0.01);
+    QCOMPARE(stretcher.rate(), TimeStretcher::kMinRate);
+    stretcher.setRate(16.0);
+    QCOMPARE(stretcher.rate(), TimeStretcher::kMaxRate);
+}
+
+void TestTimeStretcher::resetRestartsTheStream() {
+    TimeStretcher stretcher(kSampleRate, 2);
+    stretcher.setRate(0.5);
+    stretch(stretcher, stereoSine(440.0, kSampleRate / 2));
+    QVERIFY(stretcher.outputFrames() > 0);
+
+    stretcher.reset();
+    QCOMPARE(stretcher.inputFrames(), qint64(0));
+    QCOMPARE(stretcher.outputFrames(), qint64(0));
+    QCOMPARE(stretcher.rate(), 0.5);
+
+    // The first hop after a reset fades in from silence: no leftover tail from before.
+    const std::vector<int16_t> silence(size_t(kSampleRate / 10) * 2, 0);
+    const QByteArray out = stretch(stretcher, silence);
+    QVERIFY(!out.isEmpty());
+    QCOMPARE(out, QByteArray(out.size(), '\0'));
+}
+
+void TestTimeStretcher::sixteenFeedsRunWellBelowRealTime() {
+    // One stretcher per feed at 0.5x, fed 10 ms of broadband (noise) audio per block as
+    // the worst case for the match search. Reports the share of one core needed to keep
+    // 16 feeds in real time.
+    constexpr int kFeeds = 16;
+    constexpr int kBlocks = 500; // 5 s of input per feed
+    const int blockFrames = kSampleRate / 100;
+    std::vector<int16_t> noise(size_t(blockFrames) * 2);
+    quint32 seed = 1;
+    for (int16_t& sample : noise) {
+        seed = seed * 1664525u + 1013904223u;
+        sample = int16_t(int(seed >> 17) - 16384);
+    }
+    std::vector<TimeStretcher> feeds(kFeeds, TimeStretcher(kSampleRate, 2));
+    for (TimeStretcher& feed : feeds) feed.setRate(0.5);
+
+    QByteArray out;
+    out.reserve(blockFrames * 8 * int(sizeof(int16_t)));
+    qint64 outputFrames = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int block = 0; block < kBlocks; ++block) {
+        for (TimeStretcher& feed : feeds) {
+            out.clear();
+            outputFrames += feed.process(noise.data(), blockFrames, out);
+        }
+    }
+    const qint64 spentNs = timer.nsecsElapsed();
+    const double audioNs = double(outputFrames) / kSampleRate * 1e9;
+    const double share = double(spentNs) / audioNs * kFeeds;
+    qInfo().noquote() << QStringLiteral("time-stretch: %1 feeds need %2% of one core")
+                             .arg(kFeeds)
+                             .arg(share * 100.0, 0, 'f', 1);
+    // Wall-clock share is reported above, not budgeted: optimized builds measure a few
+    // percent, and only "cannot keep up at all" is a failure on a loaded host.
+    QVERIFY(outputFrames > 0);
+    QVERIFY2(share < 1.0, qPrintable(QString::number(share)));
+}
+
+QTEST_GUILESS_MAIN(TestTimeStretcher)
+#include "tst_timestretcher.moc"
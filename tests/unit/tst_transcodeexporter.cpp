@@ -0,0 +1,444 @@
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "playback/export/transcodeexporter.h"
+#include "recorder_engine/codec/nativevideoencoder.h"
+
+#include <functional>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+}
+
+namespace {
+constexpr int kFps = 50;
+constexpr int kFrameMs = 1000 / kFps;
+constexpr int kAudioBytesPerFrame = 48000 / kFps * 2 * 2;
+
+using Painter = std::function<void(AVFrame* frame, int view, int index)>;
+
+// Flat picture whose luma identifies the view and frame: consecutive frames differ by 7.
+int lumaFor(int view, int index) {
+    return 16 + (index * 7 + view * 90) % 200;
+}
+
+void paintFlat(AVFrame* frame, int view, int index) {
+    memset(frame->data[0], lumaFor(view, index), size_t(frame->linesize[0]) * frame->height);
+    memset(frame->data[1], 128, size_t(frame->linesize[1]) * ((frame->height + 1) / 2));
+    memset(frame->data[2], 128, size_t(frame->linesize[2]) * ((frame->height + 1) / 2));
+}
+
+// Camera-like detail (a moving gradient under noise), so the codecs do real work.
+void paintDetailed(AVFrame* frame, int view, int index) {
+    quint32 seed = quint32(index * 7919 + view * 104729 + 1);
+    for (int y = 0; y < frame->height; ++y) {
+        uint8_t* line = frame->data[0] + qsizetype(y) * frame->linesize[0];
+        for (int x = 0; x < frame->width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            line[x] = uint8_t(16 + ((x + y + index * 4) % 160) + int(seed >> 28) * 4);
+        }
+    }
+    for (int p = 1; p < 3; ++p) {
+        for (int y = 0; y < (frame->height + 1) / 2; ++y) {
+            uint8_t* line = frame->data[p] + qsizetype(y) * frame->linesize[p];
+            for (int x = 0; x < (frame->width + 1) / 2; ++x)
+                line[x] = uint8_t(96 + ((x * (p + 1) + y + index) % 64));
+        }
+    }
+}
+
+// Writes a recording with the Muxer's video/audio layout (N intra MPEG-2 video tracks, then
+// N PCM tracks). `distinctFrames` pictures per view are encoded and their packets repeated,
+// which keeps long benchmark fixtures cheap: any all-intra packet order is valid.
+bool writeRecording(const QString& path, int views, qint64 durationMs, int width, int height,
+                    int distinctFrames, const Painter& paint) {
+    AVFormatContext* ctx = nullptr;
+    const QByteArray encodedPath = path.toUtf8();
+    if (avformat_alloc_output_context2(&ctx, nullptr, "matroska", encodedPath.constData()) < 0)
+        return false;
+    const auto freeContext = qScopeGuard([&ctx] {
+        if (ctx->pb) avio_closep(&ctx->pb);
+        avformat_free_context(ctx);
+    });
+
+    const AVCodec* encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+    if (!encoder) return false;
+    QList<QList<QByteArray>> pictures(views);
+    for (int v = 0; v < views; ++v) {
+        AVCodecContext* enc = avcodec_alloc_context3(encoder);
+        const auto freeEncoder = qScopeGuard([&enc] { avcodec_free_context(&enc); });
+        enc->width = width;
+        enc->height = height;
+        enc->pix_fmt = AV_PIX_FMT_YUV420P;
+        enc->time_base = AVRational{1, kFps};
+        enc->framerate = AVRational{kFps, 1};
+        enc->gop_size = 1;
+        enc->max_b_frames = 0;
+        enc->bit_rate = 30'000'000;
+        if (avcodec_open2(enc, encoder, nullptr) < 0) return false;
+        AVStream* st = avformat_new_stream(ctx, nullptr);
+        avcodec_parameters_from_context(st->codecpar, enc);
+        st->time_base = AVRational{1, 1000};
+        st->avg_frame_rate = st->r_frame_rate = AVRational{kFps, 1};
+        const QByteArray title = "Track " + QByteArray::number(v + 1);
+        av_dict_set(&st->metadata, "title", title.constData(), 0);
+
+        AVFrame* frame = av_frame_alloc();
+        AVPacket* pkt = av_packet_alloc();
+        const auto freeCoding = qScopeGuard([&frame, &pkt] {
+            av_frame_free(&frame);
+            av_packet_free(&pkt);
+        });
+        frame->format = AV_PIX_FMT_YUV420P;
+        frame->width = width;
+        frame->height = height;
+        if (av_frame_get_buffer(frame, 0) < 0) return false;
+        for (int i = 0; i < distinctFrames; ++i) {
+            if (av_frame_make_writable(frame) < 0) return false;
+            paint(frame, v, i);
+            frame->pts = i;
+            if (avcodec_send_frame(enc, frame) < 0) return false;
+            while (avcodec_receive_packet(enc, pkt) == 0) {
+                pictures[v] << QByteArray(reinterpret_cast<const char*>(pkt->data), pkt->size);
+                av_packet_unref(pkt);
+            }
+        }
+        avcodec_send_frame(enc, nullptr);
+        while (avcodec_receive_packet(enc, pkt) == 0) {
+            pictures[v] << QByteArray(reinterpret_cast<const char*>(pkt->data), pkt->size);
+            av_packet_unref(pkt);
+        }
+        if (pictures[v].size() != distinctFrames) return false;
+    }
+    for (int v = 0; v < views; ++v) {
+        AVStream* st = avformat_new_stream(ctx, nullptr);
+        st->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
+        st->codecpar->codec_id = AV_CODEC_ID_PCM_S16LE;
+        st->codecpar->sample_rate = 48000;
+        st->codecpar->format = AV_SAMPLE_FMT_S16;
+        av_channel_layout_default(&st->codecpar->ch_layout, 2);
+        st->time_base = AVRational{1, 1000};
+    }
+
+    if (avio_open(&ctx->pb, encodedPath.constData(), AVIO_FLAG_WRITE) < 0) return false;
+    AVDictionary* options = nullptr;
+    av_dict_set(&options, "cluster_time_limit", "100", 0);
+    const int headerRet = avformat_write_header(ctx, &options);
+    av_dict_free(&options);
+    if (headerRet < 0) return false;
+
+    AVPacket* pkt = av_packet_alloc();
+    const auto freePacket = qScopeGuard([&pkt] { av_packet_free(&pkt); });
+    const auto write = [&](int stream, qint64 ptsMs, const QByteArray& payload) {
+        if (av_new_packet(pkt, int(payload.size())) < 0) return false;
+        memcpy(pkt->data, payload.constData(), size_t(payload.size()));
+        pkt->stream_index = stream;
+        pkt->pts = pkt->dts = av_rescale_q(ptsMs, AVRational{1, 1000},
+                                           ctx->streams[stream]->time_base);
+        pkt->duration = av_rescale_q(kFrameMs, AVRational{1, 1000},
+                                     ctx->streams[stream]->time_base);
+        pkt->flags |= AV_PKT_FLAG_KEY;
+        return av_write_frame(ctx, pkt) >= 0;
+    };
+    int index = 0;
+    for (qint64 pts = 0; pts < durationMs; pts += kFrameMs, ++index) {
+        for (int v = 0; v < views; ++v) {
+            if (!write(v, pts, pictures[v].at(index % distinctFrames))) return false;
+            if (!write(views + v, pts, QByteArray(kAudioBytesPerFrame, char(v)))) return false;
+        }
+    }
+    return av_write_trailer(ctx) >= 0;
+}
+
+struct DecodedExport {
+    QList<qint64> videoPtsMs;
+    QList<double> lumaLeft;  // mean luma of the left tile's centre
+    QList<double> lumaRight; // mean luma of the right tile's centre
+    int videoTracks = 0;
+    int audioTracks = 0;
+    int audioPackets = 0;
+};
+
+double meanLuma(const AVFrame* frame, int x0, int x1) {
+    double sum = 0.0;
+    int count = 0;
+    for (int y = frame->height / 4; y < frame->height * 3 / 4; ++y) {
+        const uint8_t* line = frame->data[0] + qsizetype(y) * frame->linesize[0];
+        for (int x = x0; x < x1; ++x, ++count) sum += line[x];
+    }
+    return count > 0 ? sum / count : 0.0;
+}
+
+bool decodeExport(const QString& path, DecodedExport& decoded) {
+    AVFormatContext* ctx = nullptr;
+    const QByteArray encodedPath = path.toUtf8();
+    if (avformat_open_input(&ctx, encodedPath.constData(), nullptr, nullptr) < 0) return false;
+    const auto closeInput = qScopeGuard([&ctx] { avformat_close_input(&ctx); });
+    if (avformat_find_stream_info(ctx, nullptr) < 0) return false;
+    int videoStream = -1;
+    for (unsigned int i = 0; i < ctx->nb_streams; ++i) {
+        const AVMediaType type = ctx->streams[i]->codecpar->codec_type;
+        if (type == AVMEDIA_TYPE_VIDEO) {
+            decoded.videoTracks++;
+            if (videoStream < 0) videoStream = int(i);
+        }
+        if (type == AVMEDIA_TYPE_AUDIO) decoded.audioTracks++;
+    }
+    if (videoStream < 0) return false;
+    const AVStream* stream = ctx->streams[videoStream];
+    const AVCodec* decoder = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext* dec = decoder ? avcodec_alloc_context3(decoder) : nullptr;
+    const auto freeDecoder = qScopeGuard([&dec] { avcodec_free_context(&dec); });
+    if (!dec || avcodec_parameters_to_context(dec, stream->codecpar) < 0) return false;
+    dec->pkt_timebase = stream->time_base;
+    if (avcodec_open2(dec, decoder, nullptr) < 0) return false;
+
+    AVPacket* pkt = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    const auto freeCoding = qScopeGuard([&frame, &pkt] {
+        av_frame_free(&frame);
+        av_packet_free(&pkt);
+    });
+    const auto receive = [&] {
+        while (avcodec_receive_frame(dec, frame) == 0) {
+            decoded.videoPtsMs << av_rescale_q(frame->best_effort_timestamp, stream->time_base,
+                                               AVRational{1, 1000});
+            decoded.lumaLeft << meanLuma(frame, frame->width / 8, frame->width * 3 / 8);
+            decoded.lumaRight << meanLuma(frame, frame->width * 5 / 8, frame->width * 7 / 8);
+            av_frame_unref(frame);
+        }
+    };
+    while (av_read_frame(ctx, pkt) >= 0) {
+        if (pkt->stream_index == videoStream) {
+            avcodec_send_packet(dec, pkt);
+            receive();
+        } else if (ctx->streams[pkt->stream_index]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            decoded.audioPackets++;
+        }
+        av_packet_unref(pkt);
+    }
+    avcodec_send_packet(dec, nullptr);
+    receive();
+    return true;
+}
+} // namespace
+
+class TestTranscodeExporter : public QObject {
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void segmentsCoverTheRange();
+    void suffixSelectsTheMuxer();
+    void singleViewKeepsFrameOrderAcrossSegments();
+    void compositeTilesTheViews();
+    void rejectsInvalidRequests();
+    void rangeTranscodeScalesAcrossWorkers();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_recording; // 2 views, 640x360 flat frames, 3 s
+};
+
+void TestTranscodeExporter::initTestCase() {
+    QVERIFY(m_dir.isValid());
+    m_recording = m_dir.filePath(QStringLiteral("recording.mkv"));
+    QVERIFY(writeRecording(m_recording, 2, 3000, 640, 360, 3000 / kFrameMs, paintFlat));
+}
+
+void TestTranscodeExporter::segmentsCoverTheRange() {
+    QList<TranscodeSegment> segments = TranscodeExporter::planSegments(0, 10000, 2000, 2);
+    QCOMPARE(segments.size(), 5);
+    for (int i = 0; i < segments.size(); ++i) {
+        QCOMPARE(segments.at(i).index, i);
+        QCOMPARE(segments.at(i).startMs, qint64(i) * 2000);
+        QCOMPARE(segments.at(i).endMs, qint64(i + 1) * 2000);
+    }
+
+    // Short ranges are cut finer so that every worker gets a segment...
+    segments = TranscodeExporter::planSegments(1000, 2000, 2000, 4);
+    QCOMPARE(segments.size(), 4);
+    QCOMPARE(segments.first().startMs, qint64(1000));
+    QCOMPARE(segments.last().endMs, qint64(2000));
+    for (int i = 1; i < segments.size(); ++i)
+        QCOMPARE(segments.at(i).startMs, segments.at(i - 1).endMs);
+
+    // ...but never below the minimum segment length; the last one takes the remainder.
+    segments = TranscodeExporter::planSegments(0, 300, 2000, 8);
+    QCOMPARE(segments.size(), 2);
+    QCOMPARE(segments.at(0).endMs, TranscodeExporter::kMinSegmentMs);
+    QCOMPARE(segments.at(1).endMs, qint64(300));
+
+    QVERIFY(TranscodeExporter::planSegments(500, 500, 2000, 4).isEmpty());
+}
+
+void TestTranscodeExporter::suffixSelectsTheMuxer() {
+    QCOMPARE(QByteArray(TranscodeExporter::muxerForPath(QStringLiteral("a/clip.MP4"))),
+             QByteArray("mp4"));
+    QCOMPARE(QByteArray(TranscodeExporter::muxerForPath(QStringLiteral("clip.mov"))),
+             QByteArray("mov"));
+    QCOMPARE(QByteArray(TranscodeExporter::muxerForPath(QStringLiteral("clip.mkv"))),
+             QByteArray("matroska"));
+    QVERIFY(!TranscodeExporter::muxerForPath(QStringLiteral("clip.ts")));
+}
+
+void TestTranscodeExporter::singleViewKeepsFrameOrderAcrossSegments() {
+    TranscodeExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 500;
+    request.entry.outMs = 2500;
+    request.outputPath = m_dir.filePath(QStringLiteral("view1.mkv"));
+    request.views = {1};
+    request.codec = VideoCodecChoice::Mpeg2Software;
+    request.workers = 4;
+    request.segmentMs = 300;
+    TranscodeExporter exporter(request);
+    QSignalSpy progress(&exporter, &TranscodeExporter::progress);
+    const TranscodeExportResult result = exporter.exportNow();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.segments, 7);
+    QCOMPARE(result.workers, 4);
+    QCOMPARE(result.framesEncoded, qint64(100));
+    QCOMPARE(result.firstPtsMs, qint64(500));
+    QCOMPARE(result.lastPtsMs, qint64(2480));
+    QCOMPARE(progress.size(), 7);
+    QCOMPARE(progress.last().at(0).toDouble(), 1.0);
+
+    DecodedExport decoded;
+    QVERIFY(decodeExport(request.outputPath, decoded));
+    QCOMPARE(decoded.videoTracks, 1);
+    QCOMPARE(decoded.audioTracks, 1);
+    QCOMPARE(decoded.audioPackets, 100);
+    QCOMPARE(decoded.videoPtsMs.size(), 100);
+    for (int i = 0; i < decoded.videoPtsMs.size(); ++i) {
+        // Rebased to 0, no gap or repeat at the segment joins, and each picture is the
+        // source frame at that time.
+        QCOMPARE(decoded.videoPtsMs.at(i), qint64(i) * kFrameMs);
+        const int expected = lumaFor(1, 500 / kFrameMs + i);
+        QVERIFY2(qAbs(decoded.lumaLeft.at(i) - expected) < 3.0,
+                 qPrintable(QStringLiteral("frame %1: luma %2, expected %3")
+                                .arg(i)
+                                .arg(decoded.lumaLeft.at(i))
+                                .arg(expected)));
+    }
+}
+
+void TestTranscodeExporter::compositeTilesTheViews() {
+    TranscodeExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 0;
+    request.entry.outMs = 1000;
+    request.outputPath = m_dir.filePath(QStringLiteral("pgm.mkv"));
+    request.views = {0, 1};
+    request.codec = VideoCodecChoice::Mpeg2Software;
+    request.includeAudio = false;
+    request.workers = 2;
+    const TranscodeExportResult result = TranscodeExporter(request).exportNow();
+    QVERIFY2(result.ok, qPrintable(result.error));
+    QCOMPARE(result.framesEncoded, qint64(50));
+
+    DecodedExport decoded;
+    QVERIFY(decodeExport(request.outputPath, decoded));
+    QCOMPARE(decoded.audioTracks, 0);
+    QCOMPARE(decoded.videoPtsMs.size(), 50);
+    for (int i = 0; i < decoded.videoPtsMs.size(); ++i) {
+        // Two views make a 2x1 grid: view 0 on the left, view 1 on the right.
+        QVERIFY2(qAbs(decoded.lumaLeft.at(i) - lumaFor(0, i)) < 3.0,
+                 qPrintable(QString::number(i)));
+        QVERIFY2(qAbs(decoded.lumaRight.at(i) - lumaFor(1, i)) < 3.0,
+                 qPrintable(QString::number(i)));
+    }
+}
+
+void TestTranscodeExporter::rejectsInvalidRequests() {
+    TranscodeExportRequest request;
+    request.entry.clipPath = m_recording;
+    request.entry.inMs = 0;
+    request.entry.outMs = 1000;
+    request.codec = VideoCodecChoice::Mpeg2Software;
+
+    request.outputPath = m_dir.filePath(QStringLiteral("clip.ts"));
+    QVERIFY(TranscodeExporter(request).exportNow().error.contains(QStringLiteral("container")));
+
+    request.outputPath = m_dir.filePath(QStringLiteral("bad.mkv"));
+    request.entry.outMs = 0;
+    QCOMPARE(TranscodeExporter(request).exportNow().error, QStringLiteral("invalid clip range"));
+    request.entry.outMs = 1000;
+
+    request.views = {5};
+    QCOMPARE(TranscodeExporter(request).exportNow().error, QStringLiteral("no recorded view 5"));
+    request.views.clear();
+
+    if (!queryNativeVideoEncodeCapabilities().h264) {
+        // Deliverables never fall back to a software H.264 encoder.
+        request.codec = VideoCodecChoice::H264Hardware;
+        QVERIFY(TranscodeExporter(request).exportNow().error.contains(QStringLiteral("hardware")));
+    }
+    QVERIFY(!QFile::exists(request.outputPath));
+}
+
+void TestTranscodeExporter::rangeTranscodeScalesAcrossWorkers() {
+    // A 1080p50 range transcoded at increasing worker counts. The default range keeps CI
+    // short; OLR_TRANSCODE_BENCH_SECONDS=120 runs the 2-minute deliverable case.
+    bool ok = false;
+    const int envSeconds = qEnvironmentVariableIntValue("OLR_TRANSCODE_BENCH_SECONDS", &ok);
+    const int seconds = ok && envSeconds > 0 ? envSeconds : 4;
+    const QString recording = m_dir.filePath(QStringLiteral("bench.mkv"));
+    QVERIFY(writeRecording(recording, 1, qint64(seconds) * 1000, 1920, 1080, kFps / 2,
+                           paintDetailed));
+
+    QList<VideoCodecChoice> codecs{VideoCodecChoice::Mpeg2Software};
+    if (queryNativeVideoEncodeCapabilities().h264) codecs << VideoCodecChoice::H264Hardware;
+    const int cores = QThread::idealThreadCount();
+    QList<int> workerCounts{1};
+    for (const int workers : {2, 4, cores}) {
+        if (workers <= cores && !workerCounts.contains(workers)) workerCounts << workers;
+    }
+
+    for (const VideoCodecChoice codec : codecs) {
+        qint64 serialMs = 0;
+        qint64 fourWorkerMs = 0;
+        for (const int workers : workerCounts) {
+            TranscodeExportRequest request;
+            request.entry.clipPath = recording;
+            request.entry.inMs = 0;
+            request.entry.outMs = qint64(seconds) * 1000;
+            request.outputPath = m_dir.filePath(QStringLiteral("bench-%1.mkv").arg(workers));
+            request.codec = codec;
+            request.workers = workers;
+            const TranscodeExportResult result = TranscodeExporter(request).exportNow();
+            QVERIFY2(result.ok, qPrintable(result.error));
+            QCOMPARE(result.framesEncoded, qint64(seconds) * kFps);
+            const qint64 spentMs = qMax<qint64>(1, result.elapsedMs);
+            if (workers == 1) serialMs = spentMs;
+            if (workers == 4) fourWorkerMs = spentMs;
+            qInfo().noquote() << QStringLiteral("transcode %1: %2 s 1080p50, %3 workers, "
+                                                "%4 segments: %5 ms (%6 fps, %7x)")
+                                     .arg(videoCodecToString(codec))
+                                     .arg(seconds)
+                                     .arg(workers)
+                                     .arg(result.segments)
+                                     .arg(spentMs)
+                                     .arg(double(result.framesEncoded) * 1000.0 / spentMs, 0, 'f',
+                                          0)
+                                     .arg(double(serialMs) / spentMs, 0, 'f', 2);
+            QFile::remove(request.outputPath);
+        }
+#ifdef NDEBUG
+        // Segments share nothing but the writer; four workers on four cores must clearly
+        // beat one. Loose, for loaded CI hosts.
+        if (codec == VideoCodecChoice::Mpeg2Software && fourWorkerMs > 0) {
+            QVERIFY2(fourWorkerMs * 13 < serialMs * 10,
+                     qPrintable(QStringLiteral("1 worker %1 ms, 4 workers %2 ms")
+                                    .arg(serialMs)
+                                    .arg(fourWorkerMs)));
+        }
+#else
+        Q_UNUSED(fourWorkerMs);
+#endif
+    }
+}
+
+QTEST_GUILESS_MAIN(TestTranscodeExporter)
+#include "tst_transcodeexporter.moc"
@@ -248,6 +248,7 @@ Frame {
                 id: row
 
                 required property int index
+                required property string clipPath
                 required property string label
                 required property var inMs
                 required property var outMs
@@ -340,6 +341,27 @@ Frame {
                                 }
                             }
 
+                            // In-point thumbnail from the background filmstrip index,
+                            // which only covers the current recording.
+                            Image {
+                                objectName: "rundownThumb" + row.index
+                                visible: root.hasUi && root.ui.thumbnailRevision !== undefined
+                                         && Number(row.inMs) >= 0
+                                         && root.ui.thumbnailsCoverClip(row.clipPath)
+                                Layout.fillHeight: true
+                                Layout.preferredWidth: visible ? height * 16 / 9 : 0
+                                asynchronous: true
+                                fillMode: Image.PreserveAspectCrop
+                                sourceSize.width: 160
+                                sourceSize.height: 90
+                                source: visible
+                                        ? "image://thumbs/"
+                                          + Math.max(0, root.ui.playbackSelectedIndex || 0) + "/"
+                                          + Math.round(Number(row.inMs))
+                                          + "?r=" + root.ui.thumbnailRevision
+                                        : ""
+                            }
+
                             ColumnLayout {
                                 Layout.fillWidth: true
                                 Layout.fillHeight: true
@@ -434,6 +456,23 @@ Frame {
                                     ToolTip.visible: hovered
                                     ToolTip.text: "Recall entry"
                                 }
+                                ToolButton {
+                                    text: "E"
+                                    enabled: root.hasUi && !root.ui.exportActive
+                                    onClicked: root.ui.exportPlaylistEntry(row.index)
+                                    ToolTip.visible: hovered
+                                    ToolTip.text: root.hasUi && root.ui.exportActive
+                                                  ? "Exporting " + Math.round(root.ui.exportProgress * 100) + "%"
+                                                  : "Export entry"
+                                }
+                                ToolButton {
+                                    text: "T"
+                                    visible: root.hasUi && root.ui.h264EncodeAvailable
+                                    enabled: root.hasUi && !root.ui.exportActive
+                                    onClicked: root.ui.transcodePlaylistEntry(row.index)
+                                    ToolTip.visible: hovered
+                                    ToolTip.text: "Export entry as H.264"
+                                }
                                 ToolButton {
                                     text: "X"
                                     enabled: root.hasUi
@@ -90,6 +90,41 @@ Item {
         border.color: Theme.line
         clip: true
 
+        // Filmstrip under everything else: one background-indexed thumbnail
+        // per cell, sampled at the cell's midpoint on the scrub range.
+        Row {
+            id: filmstrip
+
+            objectName: "filmstrip"
+            readonly property bool available: root.hasUi && root.ui.thumbnailRevision !== undefined
+            readonly property real cellWidth: Math.max(1, track.height * 16 / 9)
+            readonly property int view: root.hasUi && root.ui.playbackSelectedIndex !== undefined
+                                        ? Math.max(0, root.ui.playbackSelectedIndex)
+                                        : 0
+
+            anchors.fill: parent
+            visible: filmstrip.available && root.durMax > 0
+            opacity: 0.45
+
+            Repeater {
+                model: filmstrip.visible ? Math.ceil(track.width / filmstrip.cellWidth) : 0
+
+                delegate: Image {
+                    required property int index
+
+                    width: filmstrip.cellWidth
+                    height: track.height
+                    asynchronous: true
+                    fillMode: Image.PreserveAspectCrop
+                    sourceSize.width: 160
+                    sourceSize.height: 90
+                    source: "image://thumbs/" + filmstrip.view + "/"
+                            + Math.round(root.xToMs((index + 0.5) * filmstrip.cellWidth))
+                            + "?r=" + root.ui.thumbnailRevision
+                }
+            }
+        }
+
         Repeater {
             model: root.hasUi && root.ui.playlistModel !== undefined && root.ui.playlistModel !== null
                    ? root.ui.playlistModel
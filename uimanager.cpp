@@ -2,10 +2,20 @@
 #include "playback/audioplayer.h"
 #include "recorder_engine/benchmark/benchmarkcache.h"
 #include "recorder_engine/benchmark/recordgate.h"
+#include "recorder_engine/pipelinetrace.h"
+#include "recorder_engine/threadplacement.h"
 #include "playback/output/broadcastoutputsettings.h"
 #include "playback/output/broadcastoutputstatus.h"
+#include "playback/demuxbankpool.h"
+#include "playback/export/clipexporter.h"
+#include "playback/export/transcodeexporter.h"
+#include "playback/thumbnailatlas.h"
+#include "playback/thumbnailimageprovider.h"
+#include "playback/thumbnailindexer.h"
 #include "project/projectimportclient.h"
 #include "recorder_engine/timing/timecode.h"
+#include "websocket/controlprotocol.h"
+#include "websocket/pipelinemetrics.h"
 #include "telemetry/telemetryclient.h"
 #include <QDateTime>
 #include <QJsonArray>
@@ -16,6 +26,7 @@
 #include <algorithm>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QGuiApplication>
 #include <QDebug>
 #if defined(Q_OS_IOS)
@@ -106,6 +117,8 @@ quint64 outputStatusFingerprint(const OutputDispatchStats& stats) {
         mix(quint64(target.lastQueuedFrameIndex));
         mix(quint64(target.lastDeliveredFrameIndex));
         mix(quint64(target.lastSubmitDurationNs));
+        mix(quint64(target.encodeLatencyNs));
+        mix(quint64(target.maxEncodeLatencyNs));
         mix(target.queuePressure ? 1 : 0);
         mix(target.lastSubmitDroppedFrame ? 1 : 0);
         mix(target.lastDeliveryGap ? 1 : 0);
@@ -200,10 +213,20 @@ QString interCamPhaseLine(const IngestStats& s) {
              QString::number(s.interCamBoundMs));
 }
 
+// Glass-to-disk line for the source health tooltip, only once this recording has written
+// a stamped frame of the source: "to disk   p50 182 ms  p99 240 ms".
+QString glassToDiskLine(const IngestStats& s) {
+    if (s.glassToDiskFrames <= 0) return QString();
+    return QStringLiteral("\nto disk   p50 %1 ms  p99 %2 ms")
+        .arg(QString::number(qlonglong(s.glassToDiskP50Ms)),
+             QString::number(qlonglong(s.glassToDiskP99Ms)));
+}
+
 } // namespace
 
 UIManager::UIManager(ReplayManager* engine, QObject* parent)
     : QObject(parent), m_replayManager(engine) {
+    m_thumbnailSlot = std::make_shared<ThumbnailAtlasSlot>();
     m_playlistModel = new PlaylistEntriesModel(this);
     refreshPlaylistModel();
     m_jogTimer.start();
@@ -380,6 +403,15 @@ UIManager::UIManager(ReplayManager* engine, QObject* parent)
     m_transport->seek(0);
     m_transport->setFrameRate(m_currentSettings.fpsNum, m_currentSettings.fpsDen);
     connect(m_transport, &PlaybackTransport::posChanged, this, [this]() { updateXTouchDisplay(); });
+    const int channelCount = PlaybackChannel::countFromEnvironment();
+    if (channelCount > 1) {
+        const int sharedFrames = SharedDecodedFrameCache::capacityFromEnvironment();
+        if (sharedFrames > 0)
+            m_sharedFrames = std::make_shared<SharedDecodedFrameCache>(sharedFrames);
+        for (int i = 1; i < channelCount; ++i)
+            m_playbackChannels.append(new PlaybackChannel(i, this));
+        qInfo() << "Playback channels:" << channelCount << "shared decoded frames:" << sharedFrames;
+    }
 
     // Audio output for single-view playback
     m_audioPlayer = new AudioPlayer(this);
@@ -666,11 +698,17 @@ UIManager::~UIManager() {
     // requestInterruption, wait()), so calling it before delete is safe.
     // Manually deleting the parented worker and nulling the pointer avoids a
     // double-delete: QObject removes destroyed children from its child list.
+    if (m_exporter) {
+        m_exporter->requestInterruption();
+        m_exporter->wait();
+    }
     if (m_playbackWorker) {
         m_playbackWorker->stop();
         delete m_playbackWorker;
         m_playbackWorker = nullptr;
     }
+    stopPlaybackChannels();
+    stopThumbnailIndexer();
     if (m_telemetryClient) {
         m_telemetryClient->stop();
     }
@@ -1295,12 +1333,13 @@ QString UIManager::sourceStatsTooltip(int sourceIndex) const {
     const IngestStats& s = m_sourceStats[sourceIndex].last;
     const QLocale loc;
     // Shared timing block, shown for every backend: the recovered source-clock line
-    // plus the Phase-4 inter-camera phase + confidence line.
+    // plus the Phase-4 inter-camera phase + confidence line (and glass-to-disk latency
+    // while recording).
     const QString clockLine =
         QStringLiteral("\nclock     %1%2 ppm  (%3)")
             .arg(s.clockPpm >= 0.0 ? QStringLiteral("+") : QString(),
                  QString::number(s.clockPpm, 'f', 1), clockQualityLabel(s.clockQuality));
-    const QString timing = clockLine + interCamPhaseLine(s);
+    const QString timing = clockLine + interCamPhaseLine(s) + glassToDiskLine(s);
     if (s.kind == IngestStatsKind::Rtmp) {
         return QStringLiteral("RTMP link\nreceived   %1 bytes\nkeyframe   %2 ms ago\ndecode err %3")
                    .arg(loc.toString(qulonglong(s.bytesTotal)),
@@ -1443,6 +1482,8 @@ void UIManager::setSaveLocation(const QString& path) {
     if (m_currentSettings.saveLocation != normalized) {
         m_currentSettings.saveLocation = normalized;
         m_replayManager->setOutputDirectory(normalized);
+        // The storage stage measured one volume; its limit says nothing about another.
+        updateStorageSafeFeeds();
         emit saveLocationChanged();
     }
 }
@@ -1792,14 +1833,13 @@ void UIManager::startRecording() {
         emit recordingFailed(reason);
         return;
     }
-    // Soft warning: configured feeds exceed the benchmarked safe count for the codec.
+    // Soft warning: configured feeds exceed the benchmarked safe count for the codec
+    // or for the recording volume, whichever is tighter.
     const int configuredFeeds = static_cast<int>(m_replayManager->getSourceUrls().size());
-    if (feedCountExceedsSafe(configuredFeeds, m_benchmarkSafeFeedsForChosen)) {
-        emit recordingWarning(
-            QStringLiteral("Recording %1 feeds; this device benchmarked %2 as the safe limit "
-                           "for the selected codec — frames may drop.")
-                .arg(configuredFeeds)
-                .arg(m_benchmarkSafeFeedsForChosen));
+    if (feedCountExceedsSafe(configuredFeeds, m_benchmarkSafeFeedsForChosen,
+                             m_benchmarkStorageSafeFeeds)) {
+        emit recordingWarning(feedLimitWarning(configuredFeeds, m_benchmarkSafeFeedsForChosen,
+                                               m_benchmarkStorageSafeFeeds));
         // proceed — operator's call.
     }
     // Distinguish the cheap "no sources" cause up front so the surfaced
@@ -1846,20 +1886,27 @@ void UIManager::startRecording() {
         m_playbackWorker->stop();
         delete m_playbackWorker;
     }
+    stopPlaybackChannels();
+    if (m_sharedFrames) m_sharedFrames->clear(); // a new recording may reuse the path
 
     m_playbackWorker = new PlaybackWorker(m_providers, m_transport, m_audioPlayer, this);
     m_playbackWorker->setBusPreviewProviders(m_multiviewPreviewProvider, m_pgmPreviewProvider);
     m_playbackWorker->setSelectedOutputFeed(m_playbackSelectedIndex);
-    m_playbackWorker->setExternalOutputTargets(m_currentSettings.broadcastOutputs);
+    m_playbackWorker->setSharedFrameCache(m_sharedFrames);
+    pushOutputTargets();
 
     // 2. Point it to the file being recorded
     // QString filePath = m_replayManager->getOutputDirectory() + "/" +
     // m_replayManager->getBaseFileName() + ".mkv";
     m_playbackWorker->openFile(m_replayManager->getVideoPath());
+    pushPrewarmClips();
+    pushStagedCues();
 
     m_playbackWorker->start();
     m_transport->seek(0);
     m_transport->setPlaying(true);
+    startPlaybackChannels();
+    restartThumbnailIndexer(m_replayManager->getVideoPath(), /*freshRecording*/ true);
 
     emit recordingStatusChanged();
     emit recordingStarted();
@@ -1872,16 +1919,68 @@ void UIManager::restartPlaybackWorker() {
         delete m_playbackWorker;
         m_playbackWorker = nullptr;
     }
+    stopPlaybackChannels();
 
     m_playbackWorker = new PlaybackWorker(m_providers, m_transport, m_audioPlayer, this);
     m_playbackWorker->setBusPreviewProviders(m_multiviewPreviewProvider, m_pgmPreviewProvider);
     m_playbackWorker->setSelectedOutputFeed(m_playbackSelectedIndex);
-    m_playbackWorker->setExternalOutputTargets(m_currentSettings.broadcastOutputs);
+    m_playbackWorker->setSharedFrameCache(m_sharedFrames);
+    pushOutputTargets();
     m_playbackWorker->openFile(m_replayManager->getVideoPath());
+    pushPrewarmClips();
+    pushStagedCues();
     m_playbackWorker->start();
     m_transport->seek(0);
     m_transport->setPlaying(true);
+    startPlaybackChannels();
     setFollowLive(true);
+    restartThumbnailIndexer(m_replayManager->getVideoPath(), /*freshRecording*/ false);
+}
+
+void UIManager::restartThumbnailIndexer(const QString& videoPath, bool freshRecording) {
+    stopThumbnailIndexer();
+    const qint64 intervalMs = ThumbnailIndexer::intervalFromEnvironment();
+    if (intervalMs <= 0 || videoPath.isEmpty()) return;
+    m_thumbnailClipPath = videoPath;
+
+    // Only one writer per atlas file: keep the open atlas when the same
+    // recording is reopened (provider refresh), reopen it otherwise.
+    const QString atlasPath = ThumbnailAtlas::atlasPathFor(videoPath);
+    std::shared_ptr<ThumbnailAtlas> atlas = m_thumbnailSlot->get();
+    if (freshRecording || !atlas || !atlas->isOpen() || atlas->path() != atlasPath) {
+        m_thumbnailSlot->set(nullptr);
+        if (atlas) atlas->close();
+        if (freshRecording) QFile::remove(atlasPath);
+        atlas = std::make_shared<ThumbnailAtlas>();
+        if (!atlas->open(atlasPath)) {
+            qWarning() << "UIManager: cannot open thumbnail atlas" << atlasPath;
+            return;
+        }
+        m_thumbnailSlot->set(atlas);
+    }
+
+    m_thumbnailIndexer = new ThumbnailIndexer(atlas, videoPath, intervalMs, this);
+    connect(m_thumbnailIndexer, &ThumbnailIndexer::thumbnailsAdded, this, [this]() {
+        m_thumbnailRevision++;
+        emit thumbnailsChanged();
+    });
+    m_thumbnailIndexer->start(QThread::LowestPriority);
+    m_thumbnailRevision++;
+    emit thumbnailsChanged();
+}
+
+bool UIManager::thumbnailsCoverClip(const QString& clipPath) const {
+    if (clipPath.isEmpty()) return true;
+    return !m_thumbnailClipPath.isEmpty() &&
+           DemuxBankPool::keyFor(clipPath) == DemuxBankPool::keyFor(m_thumbnailClipPath);
+}
+
+void UIManager::stopThumbnailIndexer() {
+    if (m_thumbnailIndexer) {
+        m_thumbnailIndexer->stop();
+        delete m_thumbnailIndexer;
+        m_thumbnailIndexer = nullptr;
+    }
 }
 
 void UIManager::stopRecording() {
@@ -1897,6 +1996,11 @@ void UIManager::stopRecording() {
     if (m_playbackWorker) {
         m_playbackWorker->stop();
     }
+    stopPlaybackChannels();
+    // The filmstrip keeps going until it has covered the finished file.
+    if (m_thumbnailIndexer) {
+        m_thumbnailIndexer->finishAtEof();
+    }
 
     // Workers are torn down above; any queued connectionChanged is dropped
     // with them, so clear the state ourselves to avoid a stale "connected".
@@ -1969,15 +2073,16 @@ void UIManager::recallEntry(int index) {
     // A manual recall is an operator override: exit any running rundown so its
     // monitor stops arming boundaries, then arm this single cue.
     stopPlaylistPlayout();
-    // Tier3 v1 is single-clip: arm the in-point ms on the currently-open clip.
-    // A recalled entry whose clipPath differs from the open clip is out of scope
-    // for v1 (armNextCut is ms-only); recall still arms the ms.
+    // Arm the in-point on the entry's clip; an entry from another clip pre-rolls
+    // from the worker's demux bank pool and switches playback to that clip.
     // armNextCut returns false when the armed cut is unavailable (e.g. H.264
-    // recordings: the pre-roll bank is hardware-only-guarded and stays empty).
-    // Fall back to a plain seek so Recall still navigates to the cue.
-    if (!m_playbackWorker || !m_playbackWorker->armNextCut(entry->inMs)) {
+    // recordings without a HW decoder: the pre-roll bank never software-decodes
+    // H.264). Fall back to a plain seek so Recall still navigates to the cue.
+    if (!m_playbackWorker || !m_playbackWorker->armNextCut(entry->inMs, -1, entry->clipPath)) {
         seekPlayback(entry->inMs);
     }
+    m_lastRecalledIndex = index;
+    pushStagedCues();
 }
 
 int UIManager::playlistCount() const {
@@ -2000,6 +2105,63 @@ void UIManager::refreshPlaylistModel() {
     if (m_playlistModel) {
         m_playlistModel->setEntries(m_playlist.entries());
     }
+    pushPrewarmClips();
+    pushStagedCues();
+}
+
+// Each channel's worker drives only the output assignments carrying its channel.
+void UIManager::pushOutputTargets() {
+    const QList<OutputTargetAssignment>& outputs = m_currentSettings.broadcastOutputs;
+    if (m_playbackWorker)
+        m_playbackWorker->setExternalOutputTargets(BroadcastOutputSettings::forChannel(outputs, 0));
+    for (PlaybackChannel* channel : m_playbackChannels)
+        channel->setOutputTargets(BroadcastOutputSettings::forChannel(outputs, channel->index()));
+}
+
+// The other channels open the same recording as channel 0, paused at its start;
+// their operators cue them over the control socket.
+void UIManager::startPlaybackChannels() {
+    const QString videoPath = m_replayManager->getVideoPath();
+    for (PlaybackChannel* channel : m_playbackChannels) {
+        channel->start(videoPath, int(m_providers.size()), m_transport->frameRate(),
+                       BroadcastOutputSettings::forChannel(m_currentSettings.broadcastOutputs,
+                                                           channel->index()),
+                       m_sharedFrames);
+    }
+}
+
+void UIManager::stopPlaybackChannels() {
+    for (PlaybackChannel* channel : m_playbackChannels)
+        channel->stop();
+}
+
+PlaybackChannel* UIManager::playbackChannel(int index) const {
+    return (index >= 1 && index <= m_playbackChannels.size()) ? m_playbackChannels[index - 1]
+                                                              : nullptr;
+}
+
+// Keep every clip the cue list references opened in the worker's demux bank pool
+// so a cross-clip recall / playout boundary pre-rolls as fast as a same-clip one.
+void UIManager::pushPrewarmClips() {
+    if (!m_playbackWorker) return;
+    QStringList clips;
+    for (const ReplayEntry& entry : m_playlist.entries())
+        if (!clips.contains(entry.clipPath)) clips.append(entry.clipPath);
+    m_playbackWorker->setPrewarmClips(clips);
+}
+
+// Offer the worker's pre-roll cue slots the next few cues so the matching cut
+// fires from an already-staged window: during a rundown the upcoming boundaries
+// (the next one first), otherwise the entries after the last recall.
+void UIManager::pushStagedCues() {
+    if (!m_playbackWorker) return;
+    const QVector<ReplayEntry> entries = m_playlist.entries();
+    int from = m_lastRecalledIndex + 1;
+    if (m_playout.active()) from = m_playout.currentIndex() + 1;
+    QVector<PrerollCue> cues;
+    for (int i = qMax(0, from); i < entries.size() && cues.size() < kStagedCueCount; ++i)
+        cues.append(PrerollCue{entries[i].clipPath, entries[i].inMs});
+    m_playbackWorker->setStagedCues(cues);
 }
 
 void UIManager::markPlaylistChanged(bool dirty) {
@@ -2177,6 +2339,106 @@ bool UIManager::loadPlaylistFromUrl(const QUrl& url) {
     return loadPlaylist(url.isLocalFile() ? url.toLocalFile() : url.toString());
 }
 
+bool UIManager::exportPlaylistEntry(int index, const QString& fileName,
+                                    const QVariantList& views) {
+    if (m_exporter) return failExport(QStringLiteral("An export is already running"));
+    const std::optional<ReplayEntry> entry = m_playlist.recall(index);
+    if (!entry.has_value()) return failExport(QStringLiteral("Rundown row is out of range"));
+    ClipExportRequest request;
+    request.entry = entry.value();
+    request.outputPath = exportPathFor(request.entry, fileName, QStringLiteral("mkv"));
+    if (request.outputPath.isEmpty())
+        return failExport(QStringLiteral("Export name must be a file name"));
+    for (const QVariant& view : views) request.views << view.toInt();
+    if (!ClipExporter::containerForPath(request.outputPath).has_value())
+        return failExport(QStringLiteral("Export to .mkv, .mov or .ts"));
+    QDir().mkpath(QFileInfo(request.outputPath).absolutePath());
+
+    auto* exporter = new ClipExporter(request, this);
+    // The worker's index of the clip it is playing saves the exporter a container seek.
+    if (m_playbackWorker) {
+        if (const auto frameIndex = m_playbackWorker->frameIndexFor(entry->clipPath))
+            exporter->setFrameIndex(frameIndex.value());
+    }
+    connect(exporter, &ClipExporter::progress, this, [this](double fraction) {
+        m_exportProgress = fraction;
+        emit exportProgressChanged(fraction);
+    });
+    connect(exporter, &ClipExporter::exportFinished, this, &UIManager::onExportFinished);
+    startExport(exporter, request.outputPath);
+    return true;
+}
+
+bool UIManager::transcodePlaylistEntry(int index, const QString& fileName,
+                                       const QVariantList& views) {
+    if (m_exporter) return failExport(QStringLiteral("An export is already running"));
+    if (!m_h264EncodeAvailable)
+        return failExport(QStringLiteral("Hardware H.264 encoding is unavailable"));
+    const std::optional<ReplayEntry> entry = m_playlist.recall(index);
+    if (!entry.has_value()) return failExport(QStringLiteral("Rundown row is out of range"));
+    TranscodeExportRequest request;
+    request.entry = entry.value();
+    request.outputPath = exportPathFor(request.entry, fileName, QStringLiteral("mp4"));
+    if (request.outputPath.isEmpty())
+        return failExport(QStringLiteral("Export name must be a file name"));
+    for (const QVariant& view : views) request.views << view.toInt();
+    if (!TranscodeExporter::muxerForPath(request.outputPath))
+        return failExport(QStringLiteral("Transcode to .mp4, .mov or .mkv"));
+    QDir().mkpath(QFileInfo(request.outputPath).absolutePath());
+
+    auto* exporter = new TranscodeExporter(request, this);
+    connect(exporter, &TranscodeExporter::progress, this, [this](double fraction) {
+        m_exportProgress = fraction;
+        emit exportProgressChanged(fraction);
+    });
+    connect(exporter, &TranscodeExporter::exportFinished, this, &UIManager::onExportFinished);
+    startExport(exporter, request.outputPath);
+    return true;
+}
+
+QString UIManager::exportPathFor(const ReplayEntry& entry, const QString& fileName,
+                                 const QString& defaultSuffix) const {
+    QString name = fileName.trimmed();
+    if (name.isEmpty()) {
+        name = QStringLiteral("%1_%2.%3").arg(QFileInfo(entry.clipPath).completeBaseName(),
+                                              QString::number(entry.inMs), defaultSuffix);
+    } else if (!ControlProtocol::isBareFileName(name)) {
+        return QString();
+    }
+    return recordingDirectory() + QStringLiteral("/exports/") + name;
+}
+
+void UIManager::cancelExport() {
+    if (m_exporter) m_exporter->requestInterruption();
+}
+
+bool UIManager::failExport(const QString& reason) {
+    m_exportError = reason;
+    emit exportStateChanged();
+    return false;
+}
+
+void UIManager::startExport(QThread* exporter, const QString& outputPath) {
+    m_exporter = exporter;
+    m_exportPath = outputPath;
+    m_exportProgress = 0.0;
+    m_exportError.clear();
+    emit exportStateChanged();
+    emit exportProgressChanged(0.0);
+    m_exporter->start(QThread::LowPriority);
+}
+
+void UIManager::onExportFinished(bool ok, const QString& error) {
+    if (!m_exporter) return;
+    // exportFinished is the last thing run() emits, so this wait is brief.
+    m_exporter->wait();
+    m_exporter->deleteLater();
+    m_exporter = nullptr;
+    m_exportError = ok ? QString() : error;
+    emit exportStateChanged();
+    emit exportFinished(ok, m_exportPath, error);
+}
+
 // EVS rundown auto-playout. Starts the playlist at fromIndex and lets it play
 // itself: the monitor (onPlayoutTick) arms each entry's out -> next-in boundary as a
 // frame-perfect armed cut and advances on each fire, applying each entry's speed.
@@ -2186,9 +2448,10 @@ bool UIManager::playPlaylist(int fromIndex) {
     const QVector<ReplayEntry> entries = m_playlist.entries();
     if (entries.isEmpty() || fromIndex < 0 || fromIndex >= entries.size())
         return failPlaylistOperation(QStringLiteral("Rundown row is out of range"));
-    // Fail fast when the frame-perfect armed cut is unavailable (e.g. H.264: no
-    // pre-roll bank). Without it the boundary cut never fires and the rundown would
-    // silently dead-end on the first entry, so refuse rather than mislead.
+    // Fail fast when the frame-perfect armed cut is unavailable (e.g. H.264 without
+    // a HW decoder: no pre-roll bank). Without it the boundary cut never fires and
+    // the rundown would silently dead-end on the first entry, so refuse rather
+    // than mislead.
     const bool needsArmedCuts = fromIndex + 1 < entries.size();
     if (needsArmedCuts && !m_playbackWorker->armedCutAvailable())
         return failPlaylistOperation(
@@ -2209,11 +2472,21 @@ bool UIManager::playPlaylist(int fromIndex) {
     // Start the first entry directly (NOT via seekPlayback, which exits playout).
     setFollowLive(false);
     m_transport->setSpeed(first.speed);
-    m_transport->seek(first.inMs);
-    m_playbackWorker->seekTo(first.inMs);
-    m_transport->setPlaying(true);
     m_playoutCutBaseline = m_playbackWorker->cutsFired();
+    const bool otherClip = !first.clipPath.isEmpty() &&
+                           DemuxBankPool::keyFor(first.clipPath) !=
+                               DemuxBankPool::keyFor(m_playbackWorker->currentClipPath());
+    if (otherClip && m_playbackWorker->armNextCut(first.inMs, -1, first.clipPath)) {
+        // The first entry lives on another clip: switch to it with an ASAP armed
+        // cut, which the monitor must not mistake for the first boundary.
+        ++m_playoutCutBaseline;
+    } else {
+        m_transport->seek(first.inMs);
+        m_playbackWorker->seekTo(first.inMs);
+    }
+    m_transport->setPlaying(true);
     if (!m_playoutMonitor.isActive()) m_playoutMonitor.start();
+    pushStagedCues();
     if (!m_playlistOperationError.isEmpty()) {
         m_playlistOperationError.clear();
         emit playlistOperationErrorChanged();
@@ -2227,6 +2500,7 @@ void UIManager::stopPlaylistPlayout() {
     m_playoutMonitor.stop();
     m_playout.stop();
     if (wasActive) {
+        pushStagedCues();
         emit playlistEntryChanged();
     }
 }
@@ -2243,12 +2517,14 @@ void UIManager::onPlayoutTick() {
     // (not just one) so the index never desyncs from the fired-cut count even if two
     // cuts were observed in one interval.
     const int cuts = m_playbackWorker->cutsFired();
+    const bool advanced = m_playoutCutBaseline < cuts;
     while (m_playoutCutBaseline < cuts) {
         ++m_playoutCutBaseline;
         const auto cur = m_playout.onBoundaryFired();
         if (cur.has_value()) m_transport->setSpeed(cur->speed);
         emit playlistEntryChanged();
     }
+    if (advanced) pushStagedCues();
     // On the final entry there is no further boundary — let normal playback continue
     // forward (the recording keeps growing). Fully stop playout so the monitor idles
     // and playlistPlayoutActive() reports false (it is no longer steering anything).
@@ -2261,7 +2537,8 @@ void UIManager::onPlayoutTick() {
     // stop rather than silently dead-end — evaluate() has consumed its one-shot arm.
     const auto b =
         m_playout.evaluate(m_transport->currentPos(), m_transport->speed(), kPlayoutArmLeadMs);
-    if (b.valid && !m_playbackWorker->armNextCut(b.targetMs, b.fireAtMs)) stopPlaylistPlayout();
+    if (b.valid && !m_playbackWorker->armNextCut(b.targetMs, b.fireAtMs, b.targetClipPath))
+        stopPlaylistPlayout();
 }
 
 void UIManager::updateUrl(int index, const QString& url) {
@@ -2604,9 +2881,7 @@ void UIManager::setNdiOutputSenderName(const QString& busKind, int feedIndex,
 
 void UIManager::applyBroadcastOutputs(const QList<OutputTargetAssignment>& outputs) {
     m_currentSettings.broadcastOutputs = outputs;
-    if (m_playbackWorker) {
-        m_playbackWorker->setExternalOutputTargets(m_currentSettings.broadcastOutputs);
-    }
+    pushOutputTargets();
     m_broadcastOutputsVersion++;
     emit broadcastOutputsChanged();
     m_settingsManager->save(m_configPath, m_currentSettings);
@@ -2640,7 +2915,8 @@ void UIManager::loadSettings() {
                                        QString::number(m_currentSettings.videoHeight) +
                                        QStringLiteral("@") + QString::number(m_currentSettings.fps);
             if (loadBenchmarkResult(benchmarkCachePath(), cached) &&
-                benchmarkResultMatches(cached, benchmarkDeviceLabel(), resolution)) {
+                benchmarkResultMatches(cached, benchmarkDeviceLabel(), resolution,
+                                       ThreadPlacement::plan().describe())) {
                 m_benchmarkResult = resultToVariantMap(cached);
                 // updateSafeFeedsForChosen() picks h264 vs mpeg2 from the
                 // current codec — use the helper so I2's logic is centralised.
@@ -2705,8 +2981,7 @@ void UIManager::loadSettings() {
             qBound(0, m_currentSettings.audioOutputLatencyMs, 500);
         if (m_audioPlayer)
             m_audioPlayer->setOutputLatencyOffsetMs(m_currentSettings.audioOutputLatencyMs);
-        if (m_playbackWorker)
-            m_playbackWorker->setExternalOutputTargets(m_currentSettings.broadcastOutputs);
+        pushOutputTargets();
         emit audioOutputLatencyChanged();
         m_broadcastOutputsVersion++;
         emit broadcastOutputsChanged();
@@ -2840,6 +3115,7 @@ void UIManager::refreshProviders() {
         delete m_playbackWorker;
         m_playbackWorker = nullptr;
     }
+    stopPlaybackChannels();
 
     // Cleanup old providers
     qDeleteAll(m_providers);
@@ -3156,6 +3432,7 @@ void UIManager::shuttleStep(int delta) {
 // ---------- Codec benchmark ----------
 
 void UIManager::updateSafeFeedsForChosen() {
+    updateStorageSafeFeeds();
     if (m_benchmarkResult.isEmpty()) {
         m_benchmarkSafeFeedsForChosen = -1;
         return;
@@ -3169,6 +3446,13 @@ void UIManager::updateSafeFeedsForChosen() {
     }
 }
 
+void UIManager::updateStorageSafeFeeds() {
+    const QVariant v = m_benchmarkResult.value(QStringLiteral("storageSafeFeeds"));
+    const QString dir = m_benchmarkResult.value(QStringLiteral("storageDirectory")).toString();
+    m_benchmarkStorageSafeFeeds =
+        v.isValid() && !dir.isEmpty() && dir == recordingDirectory() ? v.toInt() : -1;
+}
+
 QVariantMap UIManager::resultToVariantMap(const CodecBenchmarkResult& r) {
     QVariantMap m;
     m[QStringLiteral("h264Available")] = r.h264Available;
@@ -3178,15 +3462,102 @@ QVariantMap UIManager::resultToVariantMap(const CodecBenchmarkResult& r) {
     m[QStringLiteral("deviceLabel")] = r.deviceLabel;
     m[QStringLiteral("resolution")] = r.resolution;
     m[QStringLiteral("timestamp")] = r.timestamp;
+    m[QStringLiteral("storageSafeFeeds")] = r.storageSafeFeeds;
+    m[QStringLiteral("storageWriteMBps")] = r.storageWriteMBps;
+    m[QStringLiteral("storageWriteP99Ms")] = r.storageWriteP99Ms;
+    m[QStringLiteral("storageDirectory")] = r.storageDirectory;
+    m[QStringLiteral("threadPlacement")] = r.threadPlacement;
     return m;
 }
 
+// The volume the storage stage has to measure: the save location, or the Muxer's
+// default when none is configured (see Muxer::getVideoPath).
+QString UIManager::recordingDirectory() const {
+    const QString configured = m_currentSettings.saveLocation.trimmed();
+    if (!configured.isEmpty()) return configured;
+    return QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation) +
+           QStringLiteral("/videos");
+}
+
 QString UIManager::benchmarkCachePath() const {
     const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir().mkpath(dir);
     return dir + QStringLiteral("/codec-benchmark.json");
 }
 
+void UIManager::setPipelineTraceEnabled(bool enabled) {
+    if (enabled && !PipelineTrace::enabled()) PipelineTrace::clear();
+    PipelineTrace::setEnabled(enabled);
+}
+
+bool UIManager::dumpPipelineTrace(const QString& fileName) {
+    QString name = fileName.trimmed();
+    if (name.isEmpty()) {
+        const QString stamp =
+            QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss"));
+        name = QStringLiteral("trace-%1.json").arg(stamp);
+    } else if (!ControlProtocol::isBareFileName(name)) {
+        qWarning() << "UIManager: refusing pipeline trace name" << fileName;
+        return false;
+    }
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+                        QStringLiteral("/traces");
+    QDir().mkpath(dir);
+    const QString target = dir + QLatin1Char('/') + name;
+    int events = 0;
+    if (!PipelineTrace::writeChromeTrace(target, &events)) {
+        qWarning() << "UIManager: failed to write pipeline trace" << target;
+        return false;
+    }
+    emit pipelineTraceDumped(target, events);
+    return true;
+}
+
+PipelineMetrics UIManager::pipelineMetrics() const {
+    PipelineMetrics metrics;
+    const QList<EncoderTickStats> encoders =
+        m_replayManager ? m_replayManager->encoderTickStats() : QList<EncoderTickStats>();
+    const QStringList names = streamNames();
+    for (int i = 0; i < names.size(); ++i) {
+        PipelineSourceMetrics source;
+        source.index = i;
+        source.name = names[i];
+        source.connected = isSourceConnected(i);
+        source.linkHealth = sourceLinkHealth(i);
+        source.hasIngestStats = sourceHasStats(i);
+        if (source.hasIngestStats) source.ingest = m_sourceStats[size_t(i)].last;
+        source.hasEncoderStats = i < encoders.size();
+        if (source.hasEncoderStats) source.encoder = encoders[i];
+        metrics.sources.append(source);
+    }
+    if (m_replayManager) {
+        metrics.recording = m_replayManager->isRecording();
+        metrics.muxer = m_replayManager->muxerWriteStats();
+        metrics.muxerQueueDepth = m_replayManager->muxerQueueDepth();
+        metrics.muxerWriteFailed = m_replayManager->muxerWriteFailed();
+    }
+    if (m_playbackWorker) {
+        metrics.playbackActive = true;
+        metrics.playback = m_playbackWorker->counters();
+        metrics.output = m_playbackWorker->publishedOutputStats();
+        metrics.channels.append({0, metrics.playback, metrics.output.dispatchCpuNs});
+    }
+    for (const PlaybackChannel* channel : m_playbackChannels) {
+        if (!channel->isRunning()) continue;
+        metrics.channels.append({channel->index(), channel->counters(),
+                                 channel->publishedOutputStats().dispatchCpuNs});
+    }
+    if (m_sharedFrames) {
+        metrics.hasSharedDecode = true;
+        metrics.sharedDecode = m_sharedFrames->stats();
+    }
+    return metrics;
+}
+
+void UIManager::reportFrameLatency() {
+    emit frameLatencyReported(frameLatencyJson(pipelineMetrics()));
+}
+
 void UIManager::runBenchmark() {
     if (m_benchmarkRunning) return;
     m_benchmarkRunning = true;
@@ -3197,6 +3568,8 @@ void UIManager::runBenchmark() {
     cfg.width = m_currentSettings.videoWidth;
     cfg.height = m_currentSettings.videoHeight;
     cfg.fps = m_currentSettings.fps;
+    cfg.outputDirectory = recordingDirectory();
+    QDir().mkpath(cfg.outputDirectory); // the Muxer creates it on record too
 
     const QString cachePath = benchmarkCachePath();
 
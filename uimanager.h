@@ -10,6 +10,8 @@
 #include <QVariantList>
 #include <QVariantMap>
 #include <QMap>
+#include <QJsonObject>
+#include <memory>
 #include <vector>
 #include "settingsmanager.h"
 #include "project/projectsettingsimporter.h"
@@ -21,6 +23,7 @@
 #include "recorder_engine/ingest/ingestsession.h"
 #include "playback/frameprovider.h"
 #include "playback/playbackworker.h"
+#include "playback/playbackchannel.h"
 #include "playback/playbacktransport.h"
 #include "playback/audioplayer.h"
 #include "playback/seekcoalescer.h"
@@ -35,6 +38,9 @@
 class QScreen;
 class ProjectImportClient;
 class TelemetryClient;
+class ThumbnailAtlasSlot;
+class ThumbnailIndexer;
+struct PipelineMetrics;
 
 class UIManager : public QObject {
     Q_OBJECT
@@ -89,6 +95,10 @@ class UIManager : public QObject {
     Q_PROPERTY(bool playlistDirty READ playlistDirty NOTIFY playlistPersistenceChanged)
     Q_PROPERTY(QString playlistOperationError READ playlistOperationError NOTIFY
                    playlistOperationErrorChanged)
+    // Rundown-entry export (exportPlaylistEntry): one at a time, on its own thread.
+    Q_PROPERTY(bool exportActive READ exportActive NOTIFY exportStateChanged)
+    Q_PROPERTY(double exportProgress READ exportProgress NOTIFY exportProgressChanged)
+    Q_PROPERTY(QString exportError READ exportError NOTIFY exportStateChanged)
     Q_PROPERTY(StreamDeckManager* streamDeck READ streamDeck CONSTANT)
     Q_PROPERTY(int streamDeckLearnAction READ streamDeckLearnAction NOTIFY streamDeckLearnActionChanged)
     Q_PROPERTY(int streamDeckBindingsVersion READ streamDeckBindingsVersion NOTIFY streamDeckBindingsChanged)
@@ -112,6 +122,9 @@ class UIManager : public QObject {
     // Bumped when any source's trim changes (config load / programmatic set) so
     // QML re-reads sourceTrimOffset() bindings.
     Q_PROPERTY(int sourceTrimVersion READ sourceTrimVersion NOTIFY sourceTrimChanged)
+    // Bumped as the background filmstrip index grows; QML appends it to
+    // image://thumbs/ URLs so not-yet-indexed cells are re-requested.
+    Q_PROPERTY(int thumbnailRevision READ thumbnailRevision NOTIFY thumbnailsChanged)
     Q_PROPERTY(QString importSettingsUrl READ importSettingsUrl WRITE setImportSettingsUrl NOTIFY importSettingsUrlChanged)
     Q_PROPERTY(QString importPreviewError READ importPreviewError NOTIFY importPreviewChanged)
     Q_PROPERTY(QVariantMap importPreview READ importPreview NOTIFY importPreviewChanged)
@@ -164,6 +177,9 @@ public:
     // (":FF"). The single source of truth for every on-screen/deck timecode so the
     // C++ and QML never drift. QML calls this instead of computing its own.
     Q_INVOKABLE QString recordTimecode(qint64 ms) const;
+    // True when image://thumbs/ serves frames of clipPath (empty = the current
+    // recording): the filmstrip only indexes the recording being played.
+    Q_INVOKABLE bool thumbnailsCoverClip(const QString& clipPath) const;
     qint64 recordingStartEpochMs() const;
     bool timeOfDayMode() const;
     int liveBufferMs() const;
@@ -176,12 +192,20 @@ public:
     int midiBindingsVersion() const;
     int midiLastValuesVersion() const;
     PlaybackTransport* transport() const { return m_transport; }
+    // Playback channels including channel 0 (transport() and the UI's worker);
+    // OLR_PLAYBACK_CHANNELS adds the others.
+    int playbackChannelCount() const { return 1 + int(m_playbackChannels.size()); }
+    // Channels from 1 up; nullptr for 0 and out-of-range indexes.
+    PlaybackChannel* playbackChannel(int index) const;
     PlaylistEntriesModel* playlistModel() const { return m_playlistModel; }
     int currentPlaylistEntryIndex() const;
     int nextPlaylistEntryIndex() const;
     QString playlistFilePath() const { return m_playlistFilePath; }
     bool playlistDirty() const { return m_playlistDirty; }
     QString playlistOperationError() const { return m_playlistOperationError; }
+    bool exportActive() const { return m_exporter != nullptr; }
+    double exportProgress() const { return m_exportProgress; }
+    QString exportError() const { return m_exportError; }
     StreamDeckManager* streamDeck() const { return m_streamDeckManager; }
     int streamDeckLearnAction() const { return m_streamDeckLearnAction; }
     int streamDeckBindingsVersion() const { return m_streamDeckBindingsVersion; }
@@ -195,6 +219,9 @@ public:
     int sourceStatsVersion() const { return m_sourceStatsVersion; }
     int playbackViewStateVersion() const { return m_playbackViewStateVersion; }
     int sourceTrimVersion() const { return m_sourceTrimVersion; }
+    int thumbnailRevision() const { return m_thumbnailRevision; }
+    // Backs the "thumbs" QML image provider (registered in main.cpp).
+    std::shared_ptr<ThumbnailAtlasSlot> thumbnailSlot() const { return m_thumbnailSlot; }
     QString importSettingsUrl() const;
     QString importPreviewError() const { return m_importPreviewError; }
     QVariantMap importPreview() const { return m_importPreview; }
@@ -218,6 +245,16 @@ public:
     void setMultiviewCount(int count);
     Q_INVOKABLE void runBenchmark();
     Q_INVOKABLE void cancelBenchmark();
+    // Pipeline tracing (see PipelineTrace). Enabling starts a fresh trace; dumping writes
+    // Chrome trace JSON to AppData/traces/fileName (a bare file name, see
+    // ControlProtocol::isBareFileName), or to a timestamped file there when empty.
+    void setPipelineTraceEnabled(bool enabled);
+    bool dumpPipelineTrace(const QString& fileName);
+    // One sample of every engine counter for the metrics endpoint; never waits on a
+    // pipeline hot-path lock.
+    PipelineMetrics pipelineMetrics() const;
+    // Emits frameLatencyReported with frameLatencyJson() of a fresh sample.
+    void reportFrameLatency();
     void setTimeOfDayMode(bool enabled);
     void setImportSettingsUrl(const QString &url);
 
@@ -337,6 +374,17 @@ public:
     Q_INVOKABLE bool loadPlaylist(const QString& filePath);
     Q_INVOKABLE bool savePlaylistToUrl(const QUrl& url);
     Q_INVOKABLE bool loadPlaylistFromUrl(const QUrl& url);
+    // Stream-copies rundown entry `index` (ClipExporter) to <recording dir>/exports/
+    // fileName: a bare .mkv/.mov/.ts name, or "<clip>_<inMs>.mkv" when empty. `views`
+    // are the recorded views to keep (empty = all). Returns false with exportError set
+    // when the export cannot start; exportFinished reports the outcome.
+    Q_INVOKABLE bool exportPlaylistEntry(int index, const QString& fileName = QString(),
+                                         const QVariantList& views = QVariantList());
+    // Same, re-encoded to hardware H.264 (TranscodeExporter) as a .mp4/.mov/.mkv
+    // deliverable ("<clip>_<inMs>.mp4" by default); several views become a PGM grid.
+    Q_INVOKABLE bool transcodePlaylistEntry(int index, const QString& fileName = QString(),
+                                            const QVariantList& views = QVariantList());
+    Q_INVOKABLE void cancelExport();
     // EVS rundown auto-playout: play the playlist from `fromIndex`, auto-advancing
     // across each entry boundary with a frame-perfect armed cut (fire-at-out-point),
     // honoring each entry's speed. After the final entry, normal playback continues
@@ -369,6 +417,8 @@ signals:
     void recordingStarted();
     void recordingStopped();
     void recordingFailed(const QString& reason);
+    void pipelineTraceDumped(const QString& path, int events);
+    void frameLatencyReported(const QJsonObject& report);
     void recordingWarning(const QString& message);
     void recordedDurationMsChanged();
     void scrubPositionChanged();
@@ -395,6 +445,7 @@ signals:
     void sourceConnectionChanged();
     void sourceStatsChanged();
     void sourceTrimChanged();
+    void thumbnailsChanged();
     void metadataFieldsChanged();
     void sourceMetadataChanged();
     void importSettingsUrlChanged();
@@ -403,6 +454,9 @@ signals:
     void playlistPersistenceChanged();
     void playlistOperationErrorChanged();
     void playlistOperationFailed(const QString& reason);
+    void exportStateChanged();
+    void exportProgressChanged(double fraction);
+    void exportFinished(bool ok, const QString& path, const QString& error);
     void importPreviewChanged();
     void telemetryConfigChanged();
     void telemetryChanged();
@@ -436,10 +490,14 @@ public slots:
 
 private:
     QString benchmarkCachePath() const;
+    QString recordingDirectory() const;
     static QVariantMap resultToVariantMap(const CodecBenchmarkResult& r);
     // Recomputes m_benchmarkSafeFeedsForChosen from m_benchmarkResult and the
     // current m_currentSettings.videoCodec. Returns -1 when no result is loaded.
     void updateSafeFeedsForChosen();
+    // Recomputes m_benchmarkStorageSafeFeeds; -1 unless the loaded result measured
+    // the current save location.
+    void updateStorageSafeFeeds();
     void syncActiveStreams();
     int activeViewCount() const;
     QStringList activeStreamUrls() const;
@@ -460,17 +518,35 @@ private:
     void pushStreamDeckMaps();
     void pushDeckTimecode();
     void shuttleStep(int delta);
+    // freshRecording discards a stale atlas left by an earlier recording
+    // written to the same path.
+    void restartThumbnailIndexer(const QString& videoPath, bool freshRecording);
+    void stopThumbnailIndexer();
 
     ReplayManager* m_replayManager;
     AppSettings m_currentSettings;
     SettingsManager* m_settingsManager;
     QString m_configPath;
     PlaybackWorker* m_playbackWorker = nullptr;
+    // Channels 1.. (channel 0 is m_transport / m_playbackWorker), started and stopped
+    // with the primary worker; every worker of the session shares m_sharedFrames.
+    QList<PlaybackChannel*> m_playbackChannels;
+    std::shared_ptr<SharedDecodedFrameCache> m_sharedFrames;
+    // Background filmstrip for the current recording (scrub bar / rundown rows).
+    ThumbnailIndexer* m_thumbnailIndexer = nullptr;
+    std::shared_ptr<ThumbnailAtlasSlot> m_thumbnailSlot;
+    QString m_thumbnailClipPath; // recording the slot's atlas belongs to
+    int m_thumbnailRevision = 0;
     ReplayPlaylist m_playlist; // Tier3 cue list (markIn/markOut/recall)
     PlaylistEntriesModel* m_playlistModel = nullptr;
     QString m_playlistFilePath;
     bool m_playlistDirty = false;
     QString m_playlistOperationError;
+    // Running ClipExporter or TranscodeExporter; deleted once it reports exportFinished.
+    QThread* m_exporter = nullptr;
+    QString m_exportPath;
+    double m_exportProgress = 0.0;
+    QString m_exportError;
     // EVS rundown auto-playout state. m_playout decides which boundary to arm and
     // when; m_playoutMonitor polls the playhead (onPlayoutTick) to arm boundaries
     // and advance on each cut fire; m_playoutCutBaseline tracks the worker's fired-
@@ -478,9 +554,24 @@ private:
     PlaylistPlayout m_playout;
     QTimer m_playoutMonitor;
     int m_playoutCutBaseline = 0;
+    // Last cue recalled by hand; the entries after it are the likely next
+    // recalls, so they are the ones kept staged when no rundown is running.
+    int m_lastRecalledIndex = -1;
     void refreshPlaylistModel();
+    void pushPrewarmClips();
+    void pushOutputTargets();
+    void startPlaybackChannels();
+    void stopPlaybackChannels();
+    void pushStagedCues();
     void markPlaylistChanged(bool dirty);
     bool failPlaylistOperation(const QString& reason);
+    bool failExport(const QString& reason);
+    // <recording dir>/exports/<fileName>, or a name built from the entry and
+    // defaultSuffix; empty when fileName is not a bare file name.
+    QString exportPathFor(const ReplayEntry& entry, const QString& fileName,
+                          const QString& defaultSuffix) const;
+    void startExport(QThread* exporter, const QString& outputPath);
+    void onExportFinished(bool ok, const QString& error);
     void stopPlaylistPlayoutForEdit();
     qint64 currentPlayheadMs() const;
     void onPlayoutTick();
@@ -502,12 +593,14 @@ private:
     // on the output thread, so the poll interval does not affect boundary accuracy.
     static constexpr qint64 kPlayoutArmLeadMs = 1500;
     static constexpr int kPlayoutMonitorMs = 16;
+    static constexpr int kStagedCueCount = 4; // upcoming cues offered to the pre-roll slots
     bool m_followLive = false;
     bool m_h264EncodeAvailable = false;
     bool m_benchmarkRunning = false;
     QVariantMap m_benchmarkResult;
     std::atomic<bool> m_benchmarkCancel{false};
     int m_benchmarkSafeFeedsForChosen = -1;
+    int m_benchmarkStorageSafeFeeds = -1;
     int m_liveBufferMs = 1000;
     MidiManager* m_midiManager = nullptr;
     StreamDeckManager* m_streamDeckManager = nullptr;
@@ -15,6 +15,14 @@ struct RecordingState {
     qint64 startEpochMs = 0;
 };
 
+// A playback channel other than channel 0 (PlaybackChannel), driven with args.channel.
+struct PlaybackChannelState {
+    int channel = 0;
+    qint64 positionMs = 0;
+    bool playing = false;
+    double speed = 1.0;
+};
+
 struct TransportState {
     qint64 positionMs = 0;
     qint64 scrubPositionMs = 0;
@@ -25,6 +33,7 @@ struct TransportState {
     int fps = 30;
     bool followLive = false;
     int liveBufferMs = 1000;
+    QVector<PlaybackChannelState> channels; // channels from 1 up; empty with one channel
 };
 
 struct SourceState {
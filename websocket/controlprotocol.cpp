@@ -1,5 +1,7 @@
 #include "controlprotocol.h"
 
+#include <QCborMap>
+#include <QCborValue>
 #include <QJsonDocument>
 #include <QJsonParseError>
 #include <QJsonArray>
@@ -52,24 +54,48 @@ ControlProtocol::CommandValidation invalid(const QString& message) {
 } // namespace
 
 ControlProtocol::ParseResult ControlProtocol::parseTextMessage(const QByteArray& payload) {
-    ParseResult result;
-
     QJsonParseError parseError;
     const QJsonDocument doc = QJsonDocument::fromJson(payload, &parseError);
     if (parseError.error != QJsonParseError::NoError) {
+        ParseResult result;
         result.code = QStringLiteral("bad_json");
         result.messageText = QStringLiteral("Invalid JSON: %1").arg(parseError.errorString());
         return result;
     }
     if (!doc.isObject()) {
+        ParseResult result;
         result.code = QStringLiteral("bad_message");
         result.messageText = QStringLiteral("Message must be a JSON object");
         return result;
     }
+    return parseObject(doc.object());
+}
 
-    const QJsonObject obj = doc.object();
+ControlProtocol::ParseResult ControlProtocol::parseBinaryMessage(const QByteArray& payload) {
+    QCborParserError parseError;
+    const QCborValue value = QCborValue::fromCbor(payload, &parseError);
+    if (parseError.error != QCborError::NoError || !value.isMap()) {
+        ParseResult result;
+        result.code = QStringLiteral("unsupported_message");
+        result.messageText = QStringLiteral("Binary messages must be a CBOR map");
+        return result;
+    }
+    return parseObject(value.toMap().toJsonObject());
+}
+
+ControlProtocol::ParseResult ControlProtocol::parseObject(const QJsonObject& obj) {
+    ParseResult result;
     result.id = obj.value(QStringLiteral("id")).toString();
     const QString type = obj.value(QStringLiteral("type")).toString();
+    if (type == QStringLiteral("subscribe")) {
+        result.ok = true;
+        result.message.type = type;
+        result.message.id = result.id;
+        for (const QString& key : {QStringLiteral("topics"), QStringLiteral("encoding")}) {
+            if (obj.contains(key)) result.message.args.insert(key, obj.value(key));
+        }
+        return result;
+    }
     if (type != QStringLiteral("command")) {
         result.code = QStringLiteral("unsupported_message");
         result.messageText = QStringLiteral("Unsupported message type");
@@ -92,6 +118,47 @@ ControlProtocol::ParseResult ControlProtocol::parseTextMessage(const QByteArray&
     return result;
 }
 
+QStringList ControlProtocol::subscriptionTopics() {
+    return {QStringLiteral("recording"), QStringLiteral("transport"),   QStringLiteral("sources"),
+            QStringLiteral("views"),     QStringLiteral("settings"),    QStringLiteral("midi"),
+            QStringLiteral("streamDeck"), QStringLiteral("screens"),    QStringLiteral("import"),
+            QStringLiteral("telemetry"), QStringLiteral("diagnostics"), QStringLiteral("export"),
+            QStringLiteral("*")};
+}
+
+ControlProtocol::Subscription
+ControlProtocol::validateSubscription(const ControlCommandMessage& message) {
+    Subscription subscription;
+    subscription.code = QStringLiteral("invalid_args");
+
+    const QJsonValue topics = message.args.value(QStringLiteral("topics"));
+    if (!topics.isArray()) {
+        subscription.message = QStringLiteral("subscribe requires array topics");
+        return subscription;
+    }
+    const QStringList known = subscriptionTopics();
+    for (const QJsonValue& topic : topics.toArray()) {
+        if (!topic.isString() || !known.contains(topic.toString())) {
+            subscription.message = QStringLiteral("subscribe topics must be one of: %1")
+                                       .arg(known.join(QStringLiteral(", ")));
+            return subscription;
+        }
+        subscription.topics.insert(topic.toString());
+    }
+
+    const QString encoding =
+        message.args.value(QStringLiteral("encoding")).toString(QStringLiteral("json"));
+    if (encoding != QStringLiteral("json") && encoding != QStringLiteral("cbor")) {
+        subscription.message = QStringLiteral("subscribe encoding must be json or cbor");
+        return subscription;
+    }
+    subscription.cbor = encoding == QStringLiteral("cbor");
+
+    subscription.ok = true;
+    subscription.code.clear();
+    return subscription;
+}
+
 QJsonObject ControlProtocol::ack(const QString& id) {
     QJsonObject obj;
     obj.insert(QStringLiteral("type"), QStringLiteral("ack"));
@@ -123,11 +190,28 @@ QByteArray ControlProtocol::compact(const QJsonObject& object) {
     return QJsonDocument(object).toJson(QJsonDocument::Compact);
 }
 
+bool ControlProtocol::isBareFileName(const QString& name) {
+    if (name.trimmed().isEmpty() || name.contains(QStringLiteral(".."))) return false;
+    for (const QChar c : name) {
+        if (c == u'/' || c == u'\\' || c == u':' || c.unicode() < 0x20) return false;
+    }
+    return true;
+}
+
 ControlProtocol::CommandValidation
 ControlProtocol::validateCommand(const ControlCommandMessage& command) {
     const QJsonObject args = command.args;
     const QString name = command.name;
 
+    // Transport commands and feed selection address a playback channel (0 by default).
+    if ((name.startsWith(QStringLiteral("transport.")) ||
+         name == QStringLiteral("view.selectFeed")) &&
+        args.contains(QStringLiteral("channel")) &&
+        (!hasInteger(args, QStringLiteral("channel")) ||
+         args.value(QStringLiteral("channel")).toDouble() < 0)) {
+        return invalid(QStringLiteral("%1 args.channel must be a non-negative integer").arg(name));
+    }
+
     if (name == QStringLiteral("transport.playPause") || name == QStringLiteral("transport.play") ||
         name == QStringLiteral("transport.pause") || name == QStringLiteral("transport.goLive") ||
         name == QStringLiteral("transport.cancelFollowLive") ||
@@ -137,7 +221,8 @@ ControlProtocol::validateCommand(const ControlCommandMessage& command) {
         name == QStringLiteral("sources.add") || name == QStringLiteral("settings.save") ||
         name == QStringLiteral("import.read") || name == QStringLiteral("import.applyPreview") ||
         name == QStringLiteral("midi.refreshPorts") ||
-        name == QStringLiteral("streamDeck.resetDefaults")) {
+        name == QStringLiteral("streamDeck.resetDefaults") ||
+        name == QStringLiteral("diagnostics.latency") || name == QStringLiteral("export.cancel")) {
         return valid(args);
     }
     if (name == QStringLiteral("transport.seek")) {
@@ -323,6 +408,53 @@ ControlProtocol::validateCommand(const ControlCommandMessage& command) {
         }
         return valid(normalized);
     }
+    if (name == QStringLiteral("diagnostics.trace")) {
+        return hasBool(args, QStringLiteral("enabled"))
+                   ? valid(args)
+                   : invalid(QStringLiteral("diagnostics.trace requires boolean args.enabled"));
+    }
+    if (name == QStringLiteral("diagnostics.dumpTrace")) {
+        // Traces are always written under the app data directory; a client only
+        // names the file.
+        if (args.contains(QStringLiteral("path"))) {
+            return invalid(QStringLiteral("diagnostics.dumpTrace takes args.name, not a path"));
+        }
+        if (args.contains(QStringLiteral("name")) &&
+            (!hasString(args, QStringLiteral("name")) ||
+             !ControlProtocol::isBareFileName(args.value(QStringLiteral("name")).toString()))) {
+            return invalid(QStringLiteral("diagnostics.dumpTrace args.name must be a file name"));
+        }
+        return valid(args);
+    }
+    if (name == QStringLiteral("export.clip")) {
+        if (!hasInteger(args, QStringLiteral("index")) ||
+            args.value(QStringLiteral("index")).toDouble() < 0) {
+            return invalid(QStringLiteral("export.clip requires non-negative integer args.index"));
+        }
+        // Exports land in the recording directory's exports/ folder; a client only
+        // names the file.
+        if (args.contains(QStringLiteral("name")) &&
+            (!hasString(args, QStringLiteral("name")) ||
+             !ControlProtocol::isBareFileName(args.value(QStringLiteral("name")).toString()))) {
+            return invalid(QStringLiteral("export.clip args.name must be a file name"));
+        }
+        if (args.contains(QStringLiteral("mode")) &&
+            args.value(QStringLiteral("mode")) != QStringLiteral("copy") &&
+            args.value(QStringLiteral("mode")) != QStringLiteral("transcode")) {
+            return invalid(QStringLiteral("export.clip args.mode must be copy or transcode"));
+        }
+        if (args.contains(QStringLiteral("views"))) {
+            const QJsonValue views = args.value(QStringLiteral("views"));
+            bool allViews = views.isArray();
+            for (const QJsonValue& view : views.toArray())
+                allViews = allViews && view.toInt(-1) >= 0; // toInt(-1): not an integer
+            if (!allViews) {
+                return invalid(
+                    QStringLiteral("export.clip args.views must be non-negative integers"));
+            }
+        }
+        return valid(args);
+    }
     if (name == QStringLiteral("action.jog") || name == QStringLiteral("action.shuttle")) {
         return hasInteger(args, QStringLiteral("delta"))
                    ? valid(args)
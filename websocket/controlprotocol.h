@@ -3,7 +3,9 @@
 
 #include <QByteArray>
 #include <QJsonObject>
+#include <QSet>
 #include <QString>
+#include <QStringList>
 
 struct ControlCommandMessage {
     QString type;
@@ -28,12 +30,32 @@ public:
         QJsonObject normalizedArgs;
     };
 
+    struct Subscription {
+        bool ok = false;
+        QString code;
+        QString message;
+        QSet<QString> topics; // "*" subscribes to every topic
+        bool cbor = false;    // server messages as binary CBOR frames instead of JSON text
+    };
+
+    // Accepts "command" and "subscribe" messages. A subscribe message's topics and encoding
+    // land in message.args.
     static ParseResult parseTextMessage(const QByteArray& payload);
+    // The same messages as a CBOR map in a binary frame.
+    static ParseResult parseBinaryMessage(const QByteArray& payload);
     static CommandValidation validateCommand(const ControlCommandMessage& command);
+    static Subscription validateSubscription(const ControlCommandMessage& message);
+    static QStringList subscriptionTopics();
     static QJsonObject ack(const QString& id);
     static QJsonObject ackError(const QString& id, const QString& code, const QString& message);
     static QJsonObject error(const QString& code, const QString& message);
     static QByteArray compact(const QJsonObject& object);
+    // A plain file name: non-empty, no path separators, no drive and no "..".
+    // Client-supplied names for files the app writes must pass this.
+    static bool isBareFileName(const QString& name);
+
+private:
+    static ParseResult parseObject(const QJsonObject& object);
 };
 
 #endif
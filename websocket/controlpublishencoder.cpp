@@ -0,0 +1,86 @@
+#include "controlpublishencoder.h"
+
+#include "controlprotocol.h"
+#include "controlstate.h"
+
+#include <QCborValue>
+
+QVector<ControlPublishFrame> ControlPublishEncoder::encode(
+    const QVector<ControlPublishItem>& items, bool cbor) {
+    QVector<ControlPublishFrame> frames;
+    for (const ControlPublishItem& item : items) {
+        switch (item.kind) {
+        case ControlPublishItem::Kind::Sections:
+            if (!item.legacyPath.isEmpty()) {
+                frames.append(frame(ControlPublishFrame::Audience::Legacy, QString(),
+                                    ControlState::patchMessage(item.legacyPath, item.legacyValue),
+                                    false));
+            }
+            encodeSections(item.sections, cbor, frames);
+            break;
+        case ControlPublishItem::Kind::Event:
+            frames.append(
+                frame(ControlPublishFrame::Audience::All, item.topic, item.message, cbor));
+            break;
+        case ControlPublishItem::Kind::Timecode:
+            frames.append(frame(ControlPublishFrame::Audience::All, QStringLiteral("transport"),
+                                item.message, cbor));
+            break;
+        case ControlPublishItem::Kind::Sync: {
+            // Everyone already synced gets whatever changed since their last merge; the new
+            // client starts from the same base, so its first merge lines up with theirs.
+            encodeSections(item.sections, cbor, frames);
+            const bool all = item.topics.contains(QStringLiteral("*"));
+            QJsonObject state;
+            for (auto it = m_published.begin(); it != m_published.end(); ++it) {
+                if (all || item.topics.contains(it.key())) state.insert(it.key(), it.value());
+            }
+            QJsonObject snapshot;
+            snapshot.insert(QStringLiteral("type"), QStringLiteral("state.snapshot"));
+            snapshot.insert(QStringLiteral("state"), state);
+            ControlPublishFrame sync =
+                frame(ControlPublishFrame::Audience::Client, QString(), snapshot, item.cbor);
+            sync.client = item.client;
+            sync.completesSync = true;
+            frames.append(sync);
+            if (all || item.topics.contains(QStringLiteral("transport"))) {
+                ControlPublishFrame timecode = frame(ControlPublishFrame::Audience::Client,
+                                                     QString(), item.message, item.cbor);
+                timecode.client = item.client;
+                frames.append(timecode);
+            }
+            break;
+        }
+        case ControlPublishItem::Kind::Reply: {
+            ControlPublishFrame reply =
+                frame(ControlPublishFrame::Audience::Client, QString(), item.message, item.cbor);
+            reply.client = item.client;
+            frames.append(reply);
+            break;
+        }
+        }
+    }
+    return frames;
+}
+
+void ControlPublishEncoder::encodeSections(const QJsonObject& sections, bool cbor,
+                                           QVector<ControlPublishFrame>& frames) {
+    for (auto it = sections.begin(); it != sections.end(); ++it) {
+        const QJsonValue patch = ControlState::mergePatch(m_published.value(it.key()), it.value());
+        if (patch.isUndefined()) continue;
+        m_published.insert(it.key(), it.value());
+        frames.append(frame(ControlPublishFrame::Audience::Subscribers, it.key(),
+                            ControlState::mergeMessage(it.key(), patch), cbor));
+    }
+}
+
+ControlPublishFrame ControlPublishEncoder::frame(ControlPublishFrame::Audience audience,
+                                                 const QString& topic, const QJsonObject& message,
+                                                 bool cbor) {
+    ControlPublishFrame out;
+    out.audience = audience;
+    out.topic = topic;
+    out.text = QString::fromUtf8(ControlProtocol::compact(message));
+    if (cbor) out.cbor = QCborValue::fromJsonValue(message).toCbor();
+    return out;
+}
@@ -0,0 +1,68 @@
+#ifndef CONTROLPUBLISHENCODER_H
+#define CONTROLPUBLISHENCODER_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+// One thing the control server publishes in an event-loop turn. The server reads state
+// from the adapter on the GUI thread and queues these in publish order; the encoder turns
+// a batch of them into ready-to-send frames on its own thread.
+struct ControlPublishItem {
+    enum class Kind {
+        Sections, // state changed: legacy state.patch plus per-section merges for subscribers
+        Event,    // event message on a topic
+        Timecode, // timecode message (transport topic)
+        Sync,     // a client (re)subscribed: catch the base up and send it a snapshot
+        Reply,    // ack or error for one client, behind the state its command changed
+    };
+
+    Kind kind = Kind::Sections;
+    QString legacyPath;       // Sections: state.patch path for unsubscribed clients, or empty
+    QJsonObject legacyValue;  // Sections: state.patch value
+    QJsonObject sections;     // Sections: section -> current value; Sync: the whole state
+    QJsonObject message;      // Event, Timecode, Reply; Sync: the timecode message
+    QString topic;            // Event
+    quintptr client = 0;      // Sync, Reply
+    QSet<QString> topics;     // Sync
+    bool cbor = false;        // Sync, Reply
+};
+
+struct ControlPublishFrame {
+    enum class Audience {
+        Legacy,      // clients that never subscribed
+        Subscribers, // synced subscribers of `topic`
+        All,         // both of the above
+        Client,      // only `client`
+    };
+
+    Audience audience = Audience::All;
+    QString topic;
+    quintptr client = 0;
+    bool completesSync = false; // Client: the snapshot that starts the client's merges
+    QString text;               // JSON text frame
+    QByteArray cbor;            // binary frame; empty unless a recipient asked for CBOR
+};
+
+// Keeps the section values subscribers were last sent and diffs each change against them,
+// so every subscriber gets the same merge patch. Serialises each message once per encoding
+// whatever the number of clients. Not thread-safe: one thread owns it.
+class ControlPublishEncoder {
+public:
+    QVector<ControlPublishFrame> encode(const QVector<ControlPublishItem>& items, bool cbor);
+
+    // The base the next merges are computed against.
+    QJsonObject publishedState() const { return m_published; }
+
+private:
+    void encodeSections(const QJsonObject& sections, bool cbor,
+                        QVector<ControlPublishFrame>& frames);
+    static ControlPublishFrame frame(ControlPublishFrame::Audience audience, const QString& topic,
+                                     const QJsonObject& message, bool cbor);
+
+    QJsonObject m_published;
+};
+
+#endif // CONTROLPUBLISHENCODER_H
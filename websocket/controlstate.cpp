@@ -33,6 +33,13 @@ QJsonObject sourceObject(const SourceState& source) {
 } // namespace
 
 QJsonObject ControlState::snapshotMessage(const ControlApiAdapter& adapter) {
+    QJsonObject msg;
+    msg.insert(QStringLiteral("type"), QStringLiteral("state.snapshot"));
+    msg.insert(QStringLiteral("state"), stateObject(adapter));
+    return msg;
+}
+
+QJsonObject ControlState::stateObject(const ControlApiAdapter& adapter) {
     QJsonObject state;
     state.insert(QStringLiteral("recording"), recordingObject(adapter));
     state.insert(QStringLiteral("transport"), transportObject(adapter));
@@ -91,11 +98,7 @@ QJsonObject ControlState::snapshotMessage(const ControlApiAdapter& adapter) {
     state.insert(QStringLiteral("import"), importObj);
 
     state.insert(QStringLiteral("telemetry"), telemetryObject(adapter));
-
-    QJsonObject msg;
-    msg.insert(QStringLiteral("type"), QStringLiteral("state.snapshot"));
-    msg.insert(QStringLiteral("state"), state);
-    return msg;
+    return state;
 }
 
 QJsonObject ControlState::patchMessage(const QString& path, const QJsonObject& value) {
@@ -106,6 +109,42 @@ QJsonObject ControlState::patchMessage(const QString& path, const QJsonObject& v
     return msg;
 }
 
+QJsonObject ControlState::mergeMessage(const QString& section, const QJsonValue& patch) {
+    QJsonObject msg;
+    msg.insert(QStringLiteral("type"), QStringLiteral("state.merge"));
+    msg.insert(QStringLiteral("path"), section);
+    msg.insert(QStringLiteral("patch"), patch);
+    return msg;
+}
+
+QJsonValue ControlState::mergePatch(const QJsonValue& from, const QJsonValue& to) {
+    if (from == to) return QJsonValue(QJsonValue::Undefined);
+    if (!from.isObject() || !to.isObject()) return to;
+
+    const QJsonObject before = from.toObject();
+    const QJsonObject after = to.toObject();
+    QJsonObject patch;
+    for (auto it = before.begin(); it != before.end(); ++it) {
+        if (!after.contains(it.key())) patch.insert(it.key(), QJsonValue::Null);
+    }
+    for (auto it = after.begin(); it != after.end(); ++it) {
+        const QJsonValue member = mergePatch(before.value(it.key()), it.value());
+        if (!member.isUndefined()) patch.insert(it.key(), member);
+    }
+    return patch;
+}
+
+QStringList ControlState::sectionNames() {
+    return {QStringLiteral("recording"), QStringLiteral("transport"), QStringLiteral("sources"),
+            QStringLiteral("views"),     QStringLiteral("settings"),  QStringLiteral("midi"),
+            QStringLiteral("streamDeck"), QStringLiteral("screens"),  QStringLiteral("import"),
+            QStringLiteral("telemetry")};
+}
+
+QString ControlState::eventTopic(const QString& eventName) {
+    return eventName.section(QLatin1Char('.'), 0, 0);
+}
+
 QJsonObject ControlState::timecodeMessage(const ControlApiAdapter& adapter) {
     const TransportState transport = adapter.transportState();
     QJsonObject msg;
@@ -140,6 +179,16 @@ QJsonObject ControlState::transportObject(const ControlApiAdapter& adapter) {
     obj.insert(QStringLiteral("fps"), transport.fps);
     obj.insert(QStringLiteral("followLive"), transport.followLive);
     obj.insert(QStringLiteral("liveBufferMs"), transport.liveBufferMs);
+    if (!transport.channels.isEmpty()) {
+        QJsonArray channels;
+        for (const PlaybackChannelState& channel : transport.channels) {
+            channels.append(QJsonObject{{QStringLiteral("channel"), channel.channel},
+                                        {QStringLiteral("positionMs"), channel.positionMs},
+                                        {QStringLiteral("playing"), channel.playing},
+                                        {QStringLiteral("speed"), channel.speed}});
+        }
+        obj.insert(QStringLiteral("channels"), channels);
+    }
     return obj;
 }
 
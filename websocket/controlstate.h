@@ -2,14 +2,27 @@
 #define CONTROLSTATE_H
 
 #include <QJsonObject>
+#include <QJsonValue>
 #include <QString>
+#include <QStringList>
 
 class ControlApiAdapter;
 
 class ControlState {
 public:
     static QJsonObject snapshotMessage(const ControlApiAdapter& adapter);
+    // The snapshot's state object: one member per section (see sectionNames()).
+    static QJsonObject stateObject(const ControlApiAdapter& adapter);
     static QJsonObject patchMessage(const QString& path, const QJsonObject& value);
+    // Subscribed clients get state.merge messages: an RFC 7386 JSON merge patch against the
+    // section's previous value (a member set to null was removed).
+    static QJsonObject mergeMessage(const QString& section, const QJsonValue& patch);
+    // The merge patch turning `from` into `to`; undefined when they are equal. Objects are
+    // diffed member by member, anything else is replaced whole.
+    static QJsonValue mergePatch(const QJsonValue& from, const QJsonValue& to);
+    static QStringList sectionNames();
+    // Events are published on the topic before the first dot ("recording.started").
+    static QString eventTopic(const QString& eventName);
     static QJsonObject timecodeMessage(const ControlApiAdapter& adapter);
 
     static QJsonObject recordingObject(const ControlApiAdapter& adapter);
@@ -0,0 +1,38 @@
+#include "controltransportpublisher.h"
+
+#include "controlwebsocketserver.h"
+#include "playback/playbacktransport.h"
+
+ControlTransportPublisher::ControlTransportPublisher(ControlWebSocketServer* server,
+                                                     QObject* parent)
+    : QObject(parent), m_server(server) {
+    m_channelPositionTimer.setSingleShot(true);
+    m_channelPositionTimer.setInterval(kPositionPatchMs);
+    connect(&m_channelPositionTimer, &QTimer::timeout, this, [this]() {
+        m_server->publishPatch(QStringLiteral("transport"));
+    });
+}
+
+void ControlTransportPublisher::watch(PlaybackTransport* transport, int channel) {
+    if (!transport) return;
+    if (channel == 0) {
+        const auto publishTransport = [this]() {
+            m_server->publishPatch(QStringLiteral("transport"));
+            m_server->publishTimecodeNow();
+        };
+        connect(transport, &PlaybackTransport::playingChanged, this, publishTransport);
+        connect(transport, &PlaybackTransport::speedChanged, this, publishTransport);
+        connect(transport, &PlaybackTransport::fpsChanged, this, publishTransport);
+        connect(transport, &PlaybackTransport::posChanged, m_server,
+                &ControlWebSocketServer::scheduleTimecode);
+        return;
+    }
+    const auto publishChannels = [this]() {
+        m_server->publishPatch(QStringLiteral("transport"));
+    };
+    connect(transport, &PlaybackTransport::playingChanged, this, publishChannels);
+    connect(transport, &PlaybackTransport::speedChanged, this, publishChannels);
+    connect(transport, &PlaybackTransport::posChanged, this, [this]() {
+        if (!m_channelPositionTimer.isActive()) m_channelPositionTimer.start();
+    });
+}
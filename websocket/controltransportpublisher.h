@@ -0,0 +1,30 @@
+#ifndef CONTROLTRANSPORTPUBLISHER_H
+#define CONTROLTRANSPORTPUBLISHER_H
+
+#include <QObject>
+#include <QTimer>
+
+class ControlWebSocketServer;
+class PlaybackTransport;
+
+// Turns playback transport signals into control-socket publishes. Channel 0 is the UI's
+// transport: play/speed/rate changes publish the transport section and a timecode at once,
+// and position changes a throttled timecode. Channels from 1 up appear only in the
+// section's `channels` list, so every change to them republishes the section, position
+// changes at most every kPositionPatchMs.
+class ControlTransportPublisher : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kPositionPatchMs = 100;
+
+    explicit ControlTransportPublisher(ControlWebSocketServer* server, QObject* parent = nullptr);
+
+    void watch(PlaybackTransport* transport, int channel);
+
+private:
+    ControlWebSocketServer* m_server;
+    QTimer m_channelPositionTimer;
+};
+
+#endif // CONTROLTRANSPORTPUBLISHER_H
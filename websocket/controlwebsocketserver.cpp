@@ -4,10 +4,13 @@
 #include "controlprotocol.h"
 #include "controlstate.h"
 
+#include <QCborValue>
 #include <QJsonObject>
 #include <QWebSocket>
 #include <QWebSocketServer>
 
+#include <utility>
+
 ControlWebSocketServer::ControlWebSocketServer(ControlApiAdapter* adapter, QObject* parent)
     : QObject(parent), m_adapter(adapter),
       m_server(new QWebSocketServer(QStringLiteral("OpenLiveReplay Control API"),
@@ -17,22 +20,37 @@ ControlWebSocketServer::ControlWebSocketServer(ControlApiAdapter* adapter, QObje
 
     m_timecodeTimer.setSingleShot(true);
     connect(&m_timecodeTimer, &QTimer::timeout, this, &ControlWebSocketServer::publishTimecodeNow);
+
+    // Zero interval: fires once the current event-loop turn has run its other events.
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &ControlWebSocketServer::flush);
+
+    m_encoder = std::make_shared<ControlPublishEncoder>();
+    m_encoderContext = new QObject;
+    m_encoderContext->moveToThread(&m_encoderThread);
+    m_encoderThread.setObjectName(QStringLiteral("ControlPublishEncoder"));
+    m_encoderThread.start();
 }
 
 ControlWebSocketServer::~ControlWebSocketServer() {
     m_timecodeTimer.stop();
+    m_flushTimer.stop();
+    m_encoderThread.quit();
+    m_encoderThread.wait();
+    delete m_encoderContext;
 
     if (m_server) {
         m_server->close();
     }
 
-    const QSet<QWebSocket*> sockets = m_sockets;
+    const QList<QWebSocket*> sockets = m_clients.keys();
     for (QWebSocket* socket : sockets) {
         if (!socket) continue;
         socket->close();
         socket->deleteLater();
     }
-    m_sockets.clear();
+    m_clients.clear();
 }
 
 bool ControlWebSocketServer::listen(const QHostAddress& address, quint16 port) {
@@ -58,28 +76,28 @@ QString ControlWebSocketServer::lastError() const {
     return m_lastError;
 }
 
-void ControlWebSocketServer::publishPatch(const QString& path, const QJsonObject& value) {
+void ControlWebSocketServer::publishPatch(const QString& path) {
     if (!m_adapter) return;
-
-    QJsonObject messageValue = value;
-
-    if (path == QStringLiteral("recording")) {
-        messageValue = ControlState::recordingObject(*m_adapter);
-    } else if (path == QStringLiteral("transport")) {
-        messageValue = ControlState::transportObject(*m_adapter);
-    } else if (path == QStringLiteral("settings")) {
-        messageValue = ControlState::settingsObject(*m_adapter);
-    } else if (path == QStringLiteral("telemetry")) {
-        messageValue = ControlState::telemetryObject(*m_adapter);
-    } else {
+    if (path != QStringLiteral("snapshot") && path != QStringLiteral("recording") &&
+        path != QStringLiteral("transport") && path != QStringLiteral("settings") &&
+        path != QStringLiteral("telemetry")) {
         return;
     }
 
-    broadcastJson(ControlState::patchMessage(path, messageValue));
+    m_dirtyPaths.insert(path);
+    m_flushTimer.start();
 }
 
 void ControlWebSocketServer::publishPatchObject(const QString& path, const QJsonObject& value) {
-    broadcastJson(ControlState::patchMessage(path, value));
+    ControlPublishItem item;
+    item.legacyPath = path;
+    item.legacyValue = value;
+    if (path == QStringLiteral("snapshot")) {
+        item.sections = value;
+    } else if (ControlState::sectionNames().contains(path)) {
+        item.sections.insert(path, value);
+    }
+    queue(item);
 }
 
 void ControlWebSocketServer::publishEvent(const QString& name, const QJsonObject& data) {
@@ -88,14 +106,19 @@ void ControlWebSocketServer::publishEvent(const QString& name, const QJsonObject
     obj.insert(QStringLiteral("name"), name);
     obj.insert(QStringLiteral("data"), data);
 
-    broadcastJson(obj);
+    ControlPublishItem item;
+    item.kind = ControlPublishItem::Kind::Event;
+    item.topic = ControlState::eventTopic(name);
+    item.message = obj;
+    queue(item);
 }
 
 void ControlWebSocketServer::publishTimecodeNow() {
     if (!m_adapter) return;
 
     m_timecodeTimer.stop();
-    broadcastJson(ControlState::timecodeMessage(*m_adapter));
+    m_timecodeDirty = true;
+    m_flushTimer.start();
 }
 
 void ControlWebSocketServer::scheduleTimecode() {
@@ -111,7 +134,7 @@ void ControlWebSocketServer::handleNewConnection() {
     }
 
     socket->setProperty("controlClientId", QString::number(reinterpret_cast<quintptr>(socket)));
-    m_sockets.insert(socket);
+    m_clients.insert(socket, Client{});
 
     connect(socket, &QWebSocket::textMessageReceived, this,
             &ControlWebSocketServer::handleTextMessage);
@@ -129,21 +152,35 @@ void ControlWebSocketServer::handleTextMessage(const QString& message) {
     if (!socket || !m_adapter) {
         return;
     }
+    handleMessage(socket, ControlProtocol::parseTextMessage(message.toUtf8()));
+}
+
+void ControlWebSocketServer::handleBinaryMessage(const QByteArray& message) {
+    auto socket = qobject_cast<QWebSocket*>(sender());
+    if (!socket || !m_adapter) return;
+    handleMessage(socket, ControlProtocol::parseBinaryMessage(message));
+}
 
-    const auto parsed = ControlProtocol::parseTextMessage(message.toUtf8());
+void ControlWebSocketServer::handleMessage(QWebSocket* socket,
+                                           const ControlProtocol::ParseResult& parsed) {
     if (!parsed.ok) {
         if (!parsed.id.isEmpty()) {
-            sendJson(ControlProtocol::ackError(parsed.id, parsed.code, parsed.messageText), socket);
+            reply(ControlProtocol::ackError(parsed.id, parsed.code, parsed.messageText), socket);
         } else {
-            sendJson(ControlProtocol::error(parsed.code, parsed.messageText), socket);
+            reply(ControlProtocol::error(parsed.code, parsed.messageText), socket);
         }
         return;
     }
 
+    if (parsed.message.type == QStringLiteral("subscribe")) {
+        subscribe(socket, parsed.message);
+        return;
+    }
+
     const auto validated = ControlProtocol::validateCommand(parsed.message);
     if (!validated.ok) {
-        sendJson(ControlProtocol::ackError(parsed.message.id, validated.code, validated.message),
-                 socket);
+        reply(ControlProtocol::ackError(parsed.message.id, validated.code, validated.message),
+              socket);
         return;
     }
 
@@ -151,18 +188,37 @@ void ControlWebSocketServer::handleTextMessage(const QString& message) {
     commandArgs.insert(QStringLiteral("_clientId"), socket->property("controlClientId").toString());
 
     const auto result = m_adapter->executeCommand(parsed.message.name, commandArgs);
-    sendJson(result.ok ? ControlProtocol::ack(parsed.message.id)
-                       : ControlProtocol::ackError(parsed.message.id, result.code, result.message),
-             socket);
+    reply(result.ok ? ControlProtocol::ack(parsed.message.id)
+                    : ControlProtocol::ackError(parsed.message.id, result.code, result.message),
+          socket);
 }
 
-void ControlWebSocketServer::handleBinaryMessage(const QByteArray&) {
-    auto socket = qobject_cast<QWebSocket*>(sender());
-    if (!socket) return;
+void ControlWebSocketServer::subscribe(QWebSocket* socket, const ControlCommandMessage& message) {
+    const ControlProtocol::Subscription subscription =
+        ControlProtocol::validateSubscription(message);
+    if (!subscription.ok) {
+        reply(ControlProtocol::ackError(message.id, subscription.code, subscription.message),
+              socket);
+        return;
+    }
 
-    sendJson(ControlProtocol::error(QStringLiteral("unsupported_message"),
-                                    QStringLiteral("Only text messages are supported")),
-             socket);
+    Client& client = m_clients[socket];
+    client.subscribed = true;
+    client.synced = false;
+    client.topics = subscription.topics;
+    client.cbor = subscription.cbor;
+    reply(ControlProtocol::ack(message.id), socket);
+
+    // The snapshot goes through the encoder behind anything already queued, so the client
+    // never sees a merge computed against an older base than its snapshot.
+    ControlPublishItem sync;
+    sync.kind = ControlPublishItem::Kind::Sync;
+    sync.sections = ControlState::stateObject(*m_adapter);
+    sync.message = ControlState::timecodeMessage(*m_adapter);
+    sync.client = reinterpret_cast<quintptr>(socket);
+    sync.topics = subscription.topics;
+    sync.cbor = subscription.cbor;
+    queue(sync);
 }
 
 void ControlWebSocketServer::handleSocketDisconnected() {
@@ -177,18 +233,130 @@ void ControlWebSocketServer::handleSocketDisconnected() {
         m_adapter->executeCommand(QStringLiteral("transport.holdSpeed"), releaseArgs);
     }
 
-    m_sockets.remove(socket);
+    m_clients.remove(socket);
     socket->deleteLater();
 }
 
 void ControlWebSocketServer::sendJson(const QJsonObject& message, QWebSocket* socket) {
     if (!socket) return;
+    if (m_clients.value(socket).cbor) {
+        socket->sendBinaryMessage(QCborValue::fromJsonValue(message).toCbor());
+        return;
+    }
     socket->sendTextMessage(QString::fromUtf8(ControlProtocol::compact(message)));
 }
 
-void ControlWebSocketServer::broadcastJson(const QJsonObject& message) {
-    const QByteArray payload = ControlProtocol::compact(message);
-    for (QWebSocket* socket : m_sockets) {
-        socket->sendTextMessage(QString::fromUtf8(payload));
+// Replies go through the publish queue rather than straight to the socket: whatever the
+// command marked dirty is materialised ahead of its ack.
+void ControlWebSocketServer::reply(const QJsonObject& message, QWebSocket* socket) {
+    if (!socket) return;
+    ControlPublishItem item;
+    item.kind = ControlPublishItem::Kind::Reply;
+    item.message = message;
+    item.client = reinterpret_cast<quintptr>(socket);
+    item.cbor = m_clients.value(socket).cbor;
+    queue(item);
+}
+
+void ControlWebSocketServer::queue(const ControlPublishItem& item) {
+    // Keep publish order: patches marked earlier in the turn go out before this item.
+    materializeDirty();
+    m_pending.append(item);
+    m_flushTimer.start();
+}
+
+void ControlWebSocketServer::materializeDirty() {
+    if (!m_adapter) return;
+
+    if (m_dirtyPaths.contains(QStringLiteral("snapshot"))) {
+        // The full state covers every other path marked this turn.
+        ControlPublishItem item;
+        item.legacyPath = QStringLiteral("snapshot");
+        item.legacyValue = ControlState::stateObject(*m_adapter);
+        item.sections = item.legacyValue;
+        m_pending.append(item);
+    } else {
+        for (const QString& path : {QStringLiteral("recording"), QStringLiteral("transport"),
+                                    QStringLiteral("settings"), QStringLiteral("telemetry")}) {
+            if (!m_dirtyPaths.contains(path)) continue;
+            ControlPublishItem item;
+            item.legacyPath = path;
+            if (path == QStringLiteral("recording")) {
+                item.legacyValue = ControlState::recordingObject(*m_adapter);
+            } else if (path == QStringLiteral("transport")) {
+                item.legacyValue = ControlState::transportObject(*m_adapter);
+            } else if (path == QStringLiteral("settings")) {
+                item.legacyValue = ControlState::settingsObject(*m_adapter);
+            } else {
+                item.legacyValue = ControlState::telemetryObject(*m_adapter);
+            }
+            item.sections.insert(path, item.legacyValue);
+            m_pending.append(item);
+        }
+    }
+    m_dirtyPaths.clear();
+
+    if (m_timecodeDirty) {
+        ControlPublishItem item;
+        item.kind = ControlPublishItem::Kind::Timecode;
+        item.message = ControlState::timecodeMessage(*m_adapter);
+        m_pending.append(item);
+        m_timecodeDirty = false;
+    }
+}
+
+void ControlWebSocketServer::flush() {
+    materializeDirty();
+    if (m_pending.isEmpty()) return;
+
+    const QVector<ControlPublishItem> items = std::exchange(m_pending, {});
+    bool cbor = false;
+    for (const Client& client : std::as_const(m_clients)) cbor = cbor || client.cbor;
+
+    QMetaObject::invokeMethod(
+        m_encoderContext,
+        [this, encoder = m_encoder, items, cbor]() {
+            QVector<ControlPublishFrame> frames = encoder->encode(items, cbor);
+            // Queued back to the server's thread; dropped if the server is gone by then.
+            QMetaObject::invokeMethod(
+                this, [this, frames = std::move(frames)]() { deliver(frames); },
+                Qt::QueuedConnection);
+        },
+        Qt::QueuedConnection);
+}
+
+void ControlWebSocketServer::deliver(const QVector<ControlPublishFrame>& frames) {
+    for (const ControlPublishFrame& frame : frames) {
+        if (frame.audience == ControlPublishFrame::Audience::Client) {
+            QWebSocket* socket = reinterpret_cast<QWebSocket*>(frame.client);
+            const auto it = m_clients.find(socket);
+            if (it == m_clients.end()) continue; // disconnected meanwhile
+            if (frame.completesSync) it->synced = true;
+            sendFrame(frame, socket, *it);
+            continue;
+        }
+
+        for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+            const Client& client = it.value();
+            bool wanted = false;
+            if (!client.subscribed) {
+                wanted = frame.audience != ControlPublishFrame::Audience::Subscribers;
+            } else if (client.synced &&
+                       frame.audience != ControlPublishFrame::Audience::Legacy) {
+                wanted = client.topics.contains(QStringLiteral("*")) ||
+                         client.topics.contains(frame.topic);
+            }
+            if (wanted) sendFrame(frame, it.key(), client);
+        }
+    }
+}
+
+void ControlWebSocketServer::sendFrame(const ControlPublishFrame& frame, QWebSocket* socket,
+                                       const Client& client) {
+    // A client that switched to CBOR after the frame was encoded gets it as text once.
+    if (client.cbor && !frame.cbor.isEmpty()) {
+        socket->sendBinaryMessage(frame.cbor);
+    } else {
+        socket->sendTextMessage(frame.text);
     }
 }
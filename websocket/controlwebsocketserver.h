@@ -1,17 +1,32 @@
 #ifndef CONTROLWEBSOCKETSERVER_H
 #define CONTROLWEBSOCKETSERVER_H
 
+#include "controlprotocol.h"
+#include "controlpublishencoder.h"
+
+#include <QHash>
 #include <QHostAddress>
 #include <QJsonObject>
 #include <QSet>
 #include <QString>
+#include <QThread>
 #include <QTimer>
+#include <QVector>
+
+#include <memory>
 
 class QWebSocket;
 class QWebSocketServer;
 
 class ControlApiAdapter;
 
+// Publishes are coalesced per event-loop turn: every publishPatch() of a path in one turn
+// becomes one message, built from the adapter when the turn's batch is flushed. Acks and
+// errors are queued behind it, so a command's state.patch reaches its client first. Clients
+// that never subscribe get every state.patch, event and timecode as before; a client that
+// sends a subscribe message gets a snapshot of its topics, then state.merge deltas and only
+// its topics' events, as JSON text or CBOR binary frames. Diffing and serialisation run on
+// an encoder thread; adapter reads and socket writes stay on the server's thread.
 class ControlWebSocketServer : public QObject {
     Q_OBJECT
 
@@ -24,7 +39,7 @@ public:
     QString lastError() const;
 
 public slots:
-    void publishPatch(const QString& path, const QJsonObject& value = {});
+    void publishPatch(const QString& path);
     void publishPatchObject(const QString& path, const QJsonObject& value);
     void publishEvent(const QString& name, const QJsonObject& data = {});
     void publishTimecodeNow();
@@ -37,14 +52,36 @@ private slots:
     void handleSocketDisconnected();
 
 private:
+    struct Client {
+        bool subscribed = false;
+        bool synced = false; // its subscription snapshot has been sent
+        QSet<QString> topics;
+        bool cbor = false;
+    };
+
+    void handleMessage(QWebSocket* socket, const ControlProtocol::ParseResult& parsed);
+    void subscribe(QWebSocket* socket, const ControlCommandMessage& message);
     void sendJson(const QJsonObject& message, QWebSocket* socket);
-    void broadcastJson(const QJsonObject& message);
+    void reply(const QJsonObject& message, QWebSocket* socket);
+    void queue(const ControlPublishItem& item);
+    void materializeDirty();
+    void flush();
+    void deliver(const QVector<ControlPublishFrame>& frames);
+    void sendFrame(const ControlPublishFrame& frame, QWebSocket* socket, const Client& client);
 
     ControlApiAdapter* m_adapter;
     QWebSocketServer* m_server;
-    QSet<QWebSocket*> m_sockets;
+    QHash<QWebSocket*, Client> m_clients;
     QTimer m_timecodeTimer;
     QString m_lastError;
+
+    QSet<QString> m_dirtyPaths;
+    bool m_timecodeDirty = false;
+    QVector<ControlPublishItem> m_pending;
+    QTimer m_flushTimer;
+    QThread m_encoderThread;
+    QObject* m_encoderContext = nullptr; // lives on m_encoderThread
+    std::shared_ptr<ControlPublishEncoder> m_encoder; // used only on m_encoderThread
 };
 
 #endif
@@ -0,0 +1,109 @@
+#include "metricshttpserver.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+namespace {
+
+const QByteArray kPrometheusContentType = "text/plain; version=0.0.4; charset=utf-8";
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(QObject* parent)
+    : QObject(parent), m_server(new QTcpServer(this)) {
+    connect(m_server, &QTcpServer::newConnection, this, &MetricsHttpServer::handleNewConnection);
+}
+
+MetricsHttpServer::~MetricsHttpServer() {
+    m_server->close();
+    const QList<QTcpSocket*> sockets = m_pending.keys();
+    for (QTcpSocket* socket : sockets) {
+        socket->abort();
+        socket->deleteLater();
+    }
+    m_pending.clear();
+}
+
+bool MetricsHttpServer::listen(const QHostAddress& address, quint16 port) {
+    if (!m_server->listen(address, port)) {
+        m_lastError = m_server->errorString();
+        return false;
+    }
+    m_lastError.clear();
+    return true;
+}
+
+quint16 MetricsHttpServer::serverPort() const {
+    return m_server->serverPort();
+}
+
+QString MetricsHttpServer::lastError() const {
+    return m_lastError;
+}
+
+void MetricsHttpServer::setRequestTimeoutMs(int timeoutMs) {
+    m_requestTimeoutMs = timeoutMs;
+}
+
+void MetricsHttpServer::setMetricsText(const QByteArray& text) {
+    m_body = text;
+}
+
+void MetricsHttpServer::handleNewConnection() {
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_pending.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this,
+                [this, socket]() { handleReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_pending.remove(socket);
+            socket->deleteLater();
+        });
+        // A client that connects and never finishes its request head would otherwise hold
+        // the socket and its partial buffer for as long as it stays connected.
+        QTimer::singleShot(m_requestTimeoutMs, socket, [this, socket]() {
+            if (m_pending.contains(socket)) respond(socket, "408 Request Timeout", QByteArray());
+        });
+    }
+}
+
+void MetricsHttpServer::handleReadyRead(QTcpSocket* socket) {
+    auto it = m_pending.find(socket);
+    if (it == m_pending.end()) return; // already answered
+    it.value() += socket->readAll();
+    const QByteArray& request = it.value();
+    const qsizetype headEnd = request.indexOf("\r\n\r\n");
+    if (headEnd < 0) {
+        if (request.size() > kMaxRequestBytes) {
+            respond(socket, "431 Request Header Fields Too Large", QByteArray());
+        }
+        return;
+    }
+
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    if (requestLine.size() != 3 || !requestLine[2].startsWith("HTTP/1.")) {
+        respond(socket, "400 Bad Request", QByteArray());
+        return;
+    }
+    const QByteArray& method = requestLine[0];
+    const QByteArray path = requestLine[1].left(requestLine[1].indexOf('?'));
+    if (path != "/metrics") {
+        respond(socket, "404 Not Found", "Metrics are served at /metrics\n");
+    } else if (method != "GET") {
+        respond(socket, "405 Method Not Allowed", QByteArray());
+    } else {
+        respond(socket, "200 OK", m_body, kPrometheusContentType);
+    }
+}
+
+void MetricsHttpServer::respond(QTcpSocket* socket, const QByteArray& status,
+                                const QByteArray& body, const QByteArray& contentType) {
+    m_pending.remove(socket);
+    QByteArray response = "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    socket->write(response);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,52 @@
+#ifndef METRICSHTTPSERVER_H
+#define METRICSHTTPSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+
+// Minimal HTTP/1.1 endpoint for a Prometheus-style scraper, served next to the control
+// WebSocket. GET /metrics answers with the last body handed to setMetricsText(); other
+// paths get 404 and other methods 405. Every response closes the connection, and one whose
+// request head is not complete within the request timeout gets 408. The body is replaced
+// wholesale by whoever samples the pipeline, so a scrape never touches it.
+class MetricsHttpServer : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kMaxRequestBytes = 8192;
+    static constexpr int kDefaultRequestTimeoutMs = 5000;
+
+    explicit MetricsHttpServer(QObject* parent = nullptr);
+    ~MetricsHttpServer() override;
+
+    bool listen(const QHostAddress& address = QHostAddress::Any, quint16 port = 8116);
+    quint16 serverPort() const;
+    QString lastError() const;
+    // Applies to connections accepted afterwards.
+    void setRequestTimeoutMs(int timeoutMs);
+
+public slots:
+    void setMetricsText(const QByteArray& text);
+
+private slots:
+    void handleNewConnection();
+
+private:
+    void handleReadyRead(QTcpSocket* socket);
+    void respond(QTcpSocket* socket, const QByteArray& status, const QByteArray& body,
+                 const QByteArray& contentType = "text/plain; charset=utf-8");
+
+    QTcpServer* m_server;
+    QHash<QTcpSocket*, QByteArray> m_pending; // partial request heads
+    QByteArray m_body;
+    int m_requestTimeoutMs = kDefaultRequestTimeoutMs;
+    QString m_lastError;
+};
+
+#endif
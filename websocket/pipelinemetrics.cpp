@@ -0,0 +1,479 @@
+#include "pipelinemetrics.h"
+
+#include <QJsonArray>
+#include <QStringList>
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// Bucket edges for every exported latency histogram, in seconds: a 60 fps tick is ~16.7 ms,
+// the muxer queue absorbs a few seconds.
+constexpr double kBucketEdgesSeconds[] = {0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                          0.02,   0.04,   0.1,   0.25,   1.0,   2.5};
+
+QByteArray escapeLabel(const QString& value) {
+    QByteArray out;
+    const QByteArray utf8 = value.toUtf8();
+    out.reserve(utf8.size());
+    for (const char c : utf8) {
+        if (c == '\\') {
+            out += "\\\\";
+        } else if (c == '"') {
+            out += "\\\"";
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+QByteArray formatValue(double value) {
+    return QByteArray::number(value, 'g', 15);
+}
+
+double seconds(qint64 ns) {
+    return double(ns) / 1e9;
+}
+
+double secondsFromMs(qint64 ms) {
+    return double(ms) / 1e3;
+}
+
+class Exposition {
+public:
+    using Labels = QList<QPair<QByteArray, QString>>;
+
+    void family(const char* name, const char* type, const char* help) {
+        m_out += "# HELP ";
+        m_out += name;
+        m_out += ' ';
+        m_out += help;
+        m_out += "\n# TYPE ";
+        m_out += name;
+        m_out += ' ';
+        m_out += type;
+        m_out += '\n';
+    }
+
+    void sample(const QByteArray& name, const Labels& labels, double value) {
+        m_out += name;
+        if (!labels.isEmpty()) {
+            m_out += '{';
+            for (int i = 0; i < labels.size(); ++i) {
+                if (i > 0) m_out += ',';
+                m_out += labels[i].first;
+                m_out += "=\"";
+                m_out += escapeLabel(labels[i].second);
+                m_out += '"';
+            }
+            m_out += '}';
+        }
+        m_out += ' ';
+        m_out += formatValue(value);
+        m_out += '\n';
+    }
+
+    void scalar(const char* name, const char* type, const char* help, double value) {
+        family(name, type, help);
+        sample(name, {}, value);
+    }
+
+    void histogram(const char* name, const char* help, const LatencyHistogram& histogram) {
+        family(name, "histogram", help);
+        histogramSeries(name, {}, histogram);
+    }
+
+    // The bucket, sum and count samples of one labelled series; the caller declares the
+    // family once before its series.
+    void histogramSeries(const QByteArray& name, const Labels& labels,
+                         const LatencyHistogram& histogram) {
+        const auto withLe = [&labels](const QString& le) {
+            Labels bucketLabels = labels;
+            bucketLabels.append({"le", le});
+            return bucketLabels;
+        };
+        for (const double edge : kBucketEdgesSeconds) {
+            sample(name + "_bucket", withLe(QString::number(edge)),
+                   double(histogram.countAtOrBelow(qint64(edge * 1e9))));
+        }
+        sample(name + "_bucket", withLe(QStringLiteral("+Inf")), double(histogram.count()));
+        sample(name + "_sum", labels, seconds(histogram.sum()));
+        sample(name + "_count", labels, double(histogram.count()));
+    }
+
+    QByteArray take() { return std::move(m_out); }
+
+private:
+    QByteArray m_out;
+};
+
+Exposition::Labels sourceLabels(const PipelineSourceMetrics& source) {
+    return {{"source", QString::number(source.index)}, {"name", source.name}};
+}
+
+// One family with a sample per source that passes `include`.
+void perSource(Exposition& out, const PipelineMetrics& metrics, const char* name,
+               const char* type, const char* help,
+               const std::function<bool(const PipelineSourceMetrics&)>& include,
+               const std::function<double(const PipelineSourceMetrics&)>& value) {
+    const bool any = std::any_of(metrics.sources.begin(), metrics.sources.end(), include);
+    if (!any) return;
+    out.family(name, type, help);
+    for (const PipelineSourceMetrics& source : metrics.sources) {
+        if (include(source)) out.sample(name, sourceLabels(source), value(source));
+    }
+}
+
+void perTarget(Exposition& out, const PipelineMetrics& metrics, const char* name,
+               const char* type, const char* help,
+               const std::function<double(const OutputTargetDispatchStats&)>& value) {
+    const QHash<QString, OutputTargetDispatchStats>& targets = metrics.output.dispatch.targets;
+    if (targets.isEmpty()) return;
+    QStringList keys = targets.keys();
+    keys.sort();
+    out.family(name, type, help);
+    for (const QString& key : keys) out.sample(name, {{"target", key}}, value(targets[key]));
+}
+
+// One family with a sample per playback channel; negative values (unknown) are left out.
+void perChannel(Exposition& out, const PipelineMetrics& metrics, const char* name,
+                const char* type, const char* help,
+                const std::function<double(const PipelinePlaybackChannelMetrics&)>& value) {
+    if (metrics.channels.isEmpty()) return;
+    out.family(name, type, help);
+    for (const PipelinePlaybackChannelMetrics& channel : metrics.channels) {
+        const double v = value(channel);
+        if (v >= 0) out.sample(name, {{"channel", QString::number(channel.channel)}}, v);
+    }
+}
+
+QString transportLabel(IngestStatsKind kind) {
+    switch (kind) {
+    case IngestStatsKind::Srt:
+        return QStringLiteral("srt");
+    case IngestStatsKind::Rtmp:
+        return QStringLiteral("rtmp");
+    case IngestStatsKind::Ndi:
+        return QStringLiteral("ndi");
+    case IngestStatsKind::Unknown:
+        break;
+    }
+    return QStringLiteral("unknown");
+}
+
+void writeSources(Exposition& out, const PipelineMetrics& m) {
+    const auto all = [](const PipelineSourceMetrics&) { return true; };
+    const auto ingest = [](const PipelineSourceMetrics& s) { return s.hasIngestStats; };
+    const auto srt = [](const PipelineSourceMetrics& s) {
+        return s.hasIngestStats && s.ingest.kind == IngestStatsKind::Srt;
+    };
+    const auto encoder = [](const PipelineSourceMetrics& s) { return s.hasEncoderStats; };
+
+    if (!m.sources.isEmpty()) {
+        out.family("olr_source_info", "gauge", "Configured source and its ingest transport.");
+        for (const PipelineSourceMetrics& s : m.sources) {
+            Exposition::Labels labels = sourceLabels(s);
+            labels.append({"transport", s.hasIngestStats ? transportLabel(s.ingest.kind)
+                                                         : QStringLiteral("unknown")});
+            out.sample("olr_source_info", labels, 1);
+        }
+    }
+    perSource(out, m, "olr_source_connected", "gauge", "1 while the source is connected.", all,
+              [](const PipelineSourceMetrics& s) { return s.connected ? 1.0 : 0.0; });
+    perSource(out, m, "olr_source_link_health", "gauge",
+              "Link health: 0 n/a, 1 green, 2 amber, 3 red.", all,
+              [](const PipelineSourceMetrics& s) { return double(s.linkHealth); });
+
+    perSource(out, m, "olr_ingest_srt_packets_received_total", "counter",
+              "SRT packets received since connect.", srt,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.recvTotal); });
+    perSource(out, m, "olr_ingest_srt_packets_retransmitted_total", "counter",
+              "SRT packets received as retransmissions since connect.", srt,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.retransTotal); });
+    perSource(out, m, "olr_ingest_srt_packets_lost_total", "counter",
+              "SRT packet losses detected since connect.", srt,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.lossTotal); });
+    perSource(out, m, "olr_ingest_srt_packets_dropped_total", "counter",
+              "SRT packets dropped as too late (unrecovered) since connect.", srt,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.dropTotal); });
+    perSource(out, m, "olr_ingest_bytes_received_total", "counter",
+              "Media bytes received since connect (RTMP, NDI).", ingest,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.bytesTotal); });
+    perSource(out, m, "olr_ingest_last_packet_age_seconds", "gauge",
+              "Time since the last media packet, at sample time.", ingest,
+              [](const PipelineSourceMetrics& s) {
+                  return secondsFromMs(s.ingest.lastPacketAgeMs);
+              });
+    perSource(out, m, "olr_ingest_keyframe_age_seconds", "gauge",
+              "Time since the last video keyframe, at sample time.", ingest,
+              [](const PipelineSourceMetrics& s) { return secondsFromMs(s.ingest.keyframeAgeMs); });
+    perSource(out, m, "olr_ingest_decode_failures_total", "counter",
+              "Frames the native decoder rejected since connect.", ingest,
+              [](const PipelineSourceMetrics& s) { return double(s.ingest.decodeFailures); });
+    perSource(out, m, "olr_ingest_clock_drift_ppm", "gauge",
+              "Recovered source clock rate against the session clock.", ingest,
+              [](const PipelineSourceMetrics& s) { return s.ingest.clockPpm; });
+    perSource(out, m, "olr_ingest_clock_locked", "gauge",
+              "1 while the recovered source clock is locked.", ingest,
+              [](const PipelineSourceMetrics& s) { return s.ingest.clockLocked ? 1.0 : 0.0; });
+    perSource(out, m, "olr_ingest_intercam_phase_seconds", "gauge",
+              "Measured phase to the reference source (late is positive).", ingest,
+              [](const PipelineSourceMetrics& s) {
+                  return secondsFromMs(s.ingest.interCamPhaseMs);
+              });
+
+    perSource(out, m, "olr_encoder_ticks_total", "counter",
+              "Master-pulse ticks encoded this recording.", encoder,
+              [](const PipelineSourceMetrics& s) { return double(s.encoder.ticks); });
+    perSource(out, m, "olr_encoder_late_ticks_total", "counter",
+              "Ticks whose pull, encode and mux took longer than a frame period.", encoder,
+              [](const PipelineSourceMetrics& s) { return double(s.encoder.lateTicks); });
+    perSource(out, m, "olr_encoder_tick_seconds", "gauge", "Duration of the last encode tick.",
+              encoder,
+              [](const PipelineSourceMetrics& s) { return seconds(s.encoder.lastTickNs); });
+    perSource(out, m, "olr_encoder_tick_max_seconds", "gauge",
+              "Longest encode tick this recording.", encoder,
+              [](const PipelineSourceMetrics& s) { return seconds(s.encoder.maxTickNs); });
+    perSource(out, m, "olr_encoder_lag_seconds", "gauge",
+              "How far the last finished tick trailed its slot on the session clock.", encoder,
+              [](const PipelineSourceMetrics& s) { return secondsFromMs(s.encoder.lastLagMs); });
+    perSource(out, m, "olr_encoder_lag_max_seconds", "gauge",
+              "Largest encode lag this recording.", encoder,
+              [](const PipelineSourceMetrics& s) { return secondsFromMs(s.encoder.maxLagMs); });
+}
+
+void writeRecording(Exposition& out, const PipelineMetrics& m) {
+    const MuxerWriteStats& mux = m.muxer;
+    out.scalar("olr_recording", "gauge", "1 while a recording session is running.",
+               m.recording ? 1 : 0);
+    out.scalar("olr_muxer_write_failed", "gauge",
+               "1 once the muxer hit a sustained write failure this session.",
+               m.muxerWriteFailed ? 1 : 0);
+    out.scalar("olr_muxer_queue_depth", "gauge", "Packets waiting for the muxer writer thread.",
+               double(m.muxerQueueDepth));
+    out.scalar("olr_muxer_queue_depth_max", "gauge", "Deepest muxer queue this session.",
+               double(mux.maxQueueDepth));
+    out.scalar("olr_muxer_packets_queued_total", "counter", "Packets handed to the muxer.",
+               double(mux.packetsQueued));
+    out.scalar("olr_muxer_packets_written_total", "counter", "Packets written to the file.",
+               double(mux.packetsWritten));
+    out.scalar("olr_muxer_bytes_written_total", "counter", "Packet bytes written to the file.",
+               double(mux.bytesWritten));
+    out.scalar("olr_muxer_write_errors_total", "counter", "Failed packet writes and flushes.",
+               double(mux.writeErrors));
+    out.scalar("olr_muxer_producer_stalls_total", "counter",
+               "Enqueues that blocked on a full muxer queue.", double(mux.producerStalls));
+    out.scalar("olr_muxer_producer_stall_seconds_total", "counter",
+               "Time producers spent blocked on a full muxer queue.",
+               seconds(mux.producerStallNs));
+    out.histogram("olr_muxer_queue_dwell_seconds", "Time a packet waited in the muxer queue.",
+                  mux.queueDwellNs);
+    out.histogram("olr_muxer_write_seconds", "Time spent writing one packet, flushes included.",
+                  mux.writeNs);
+
+    // Per source, in source order; a source appears once one of its frames reached the file.
+    bool declared = false;
+    for (const PipelineSourceMetrics& source : m.sources) {
+        const LatencyHistogram total = mux.sourceLatency.value(source.index).totalNs;
+        if (total.count() == 0) continue;
+        if (!declared) {
+            out.family("olr_glass_to_disk_seconds", "histogram",
+                       "Time from a frame's arrival to its packet being written to the file.");
+            declared = true;
+        }
+        out.histogramSeries("olr_glass_to_disk_seconds", sourceLabels(source), total);
+    }
+}
+
+void writePlayback(Exposition& out, const PipelineMetrics& m) {
+    const PlaybackWorker::PlaybackCounters& p = m.playback;
+    out.scalar("olr_playback_active", "gauge", "1 while a playback worker is running.",
+               m.playbackActive ? 1 : 0);
+    out.scalar("olr_playback_repositions_total", "counter", "Coarse seeks of the primary bank.",
+               double(p.reposition));
+    out.scalar("olr_playback_frames_dropped_total", "counter",
+               "Decoded frames dropped before delivery.", double(p.framesDropped));
+    out.scalar("olr_playback_decoded_video_frames_total", "counter",
+               "Video frames decoded into the primary bank.", double(p.decodedVideoFrames));
+    out.scalar("olr_playback_audio_pushes_total", "counter", "Audio buffers pushed to output.",
+               double(p.audioPushes));
+    out.scalar("olr_playback_read_stalls_total", "counter",
+               "File reads that blocked the playback worker.", double(p.readStalls));
+    out.scalar("olr_playback_read_stall_max_seconds", "gauge", "Longest blocking file read.",
+               secondsFromMs(p.maxReadStallMs));
+    out.scalar("olr_playback_live_ring_packets_total", "counter",
+               "Packets served from the in-RAM live ring.", double(p.liveRingPackets));
+    out.scalar("olr_playback_live_ring_fallbacks_total", "counter",
+               "Readers that left the live ring (evicted or withdrawn) for disk.",
+               double(p.liveRingFallbacks));
+    out.scalar("olr_playback_cue_slot_hits_total", "counter",
+               "Armed cuts served from a pre-staged cue slot.", double(p.cueSlotHits));
+    out.scalar("olr_playback_bank_pool_misses_total", "counter",
+               "Cross-clip cuts and cue slots whose bank was not pooled yet.",
+               double(p.bankPoolMisses));
+
+    const auto cpuSeconds = [](qint64 ns) { return ns < 0 ? -1.0 : seconds(ns); };
+    perChannel(out, m, "olr_playback_channel_cpu_seconds_total", "counter",
+               "CPU time of the channel's playback worker thread.",
+               [&](const PipelinePlaybackChannelMetrics& c) {
+                   return cpuSeconds(c.playback.workerCpuNs);
+               });
+    perChannel(out, m, "olr_playback_channel_output_cpu_seconds_total", "counter",
+               "CPU time of the channel's output dispatch thread.",
+               [&](const PipelinePlaybackChannelMetrics& c) { return cpuSeconds(c.outputCpuNs); });
+    perChannel(out, m, "olr_playback_channel_decoded_video_frames_total", "counter",
+               "Video frames the channel decoded itself.",
+               [](const PipelinePlaybackChannelMetrics& c) {
+                   return double(c.playback.decodedVideoFrames);
+               });
+    perChannel(out, m, "olr_playback_channel_shared_decode_hits_total", "counter",
+               "Video frames the channel took from the shared decoded-frame cache.",
+               [](const PipelinePlaybackChannelMetrics& c) {
+                   return double(c.playback.sharedDecodeHits);
+               });
+
+    if (!m.hasSharedDecode) return;
+    const SharedDecodedFrameCache::Stats& shared = m.sharedDecode;
+    out.scalar("olr_playback_shared_decode_hits_total", "counter",
+               "Packets a channel did not decode because another channel had.",
+               double(shared.hits));
+    out.scalar("olr_playback_shared_decode_misses_total", "counter",
+               "Shared decoded-frame lookups that found nothing.", double(shared.misses));
+    out.scalar("olr_playback_shared_decode_evictions_total", "counter",
+               "Frames dropped from the shared decoded-frame cache.", double(shared.evictions));
+    out.scalar("olr_playback_shared_decode_frames", "gauge",
+               "Frames held in the shared decoded-frame cache.", double(shared.frames));
+}
+
+void writeOutput(Exposition& out, const PipelineMetrics& m) {
+    const OutputDispatchStats& d = m.output.dispatch;
+    const OutputRuntimeDispatchStats& r = d.runtime;
+    out.scalar("olr_output_ticks_total", "counter", "Output dispatch ticks.", double(d.ticks));
+    out.scalar("olr_output_frames_submitted_total", "counter", "Frames accepted by sinks.",
+               double(d.framesSubmitted));
+    out.scalar("olr_output_sink_failures_total", "counter", "Sink submits that failed.",
+               double(d.sinkFailures));
+    out.scalar("olr_output_placeholder_frames_total", "counter",
+               "Bus frames rendered as placeholders (nothing decoded yet).",
+               double(d.placeholderFrames));
+    out.scalar("olr_output_held_frames_total", "counter",
+               "Bus frames that repeated the last good frame.", double(d.heldFrames));
+    out.scalar("olr_output_deadline_misses_total", "counter",
+               "Dispatch passes that hit the catch-up cap.", double(r.deadlineMisses));
+    out.scalar("olr_output_capped_ticks_total", "counter",
+               "Ticks skipped by the catch-up cap.", double(r.cappedCatchUpTicks));
+    out.scalar("olr_output_clock_divergence_max_seconds", "gauge",
+               "Largest gap between the playhead and the output clock while playing.",
+               secondsFromMs(d.maxClockDivergenceMs));
+    out.scalar("olr_output_tick_lateness_max_seconds", "gauge", "Latest tick since start.",
+               seconds(r.maxLatenessNs));
+    out.scalar("olr_output_render_p99_seconds", "gauge", "p99 time rendering buses per tick.",
+               seconds(r.renderP99Ns));
+    out.scalar("olr_output_sink_submit_p99_seconds", "gauge",
+               "p99 time inside sink submits per tick.", seconds(r.sinkSubmitP99Ns));
+    out.scalar("olr_output_realtime_priority", "gauge",
+               "1 when the dispatch thread obtained realtime scheduling.",
+               r.realtimePriority ? 1 : 0);
+    out.histogram("olr_output_tick_lateness_seconds",
+                  "How late each dispatch tick ran after its deadline.", m.output.latenessNs);
+
+    perTarget(out, m, "olr_output_target_frames_submitted_total", "counter",
+              "Frames the target's sink accepted.",
+              [](const OutputTargetDispatchStats& t) { return double(t.framesSubmitted); });
+    perTarget(out, m, "olr_output_target_sink_failures_total", "counter",
+              "Submits the target's sink rejected.",
+              [](const OutputTargetDispatchStats& t) { return double(t.sinkFailures); });
+    perTarget(out, m, "olr_output_target_dropped_frames_total", "counter",
+              "Frames the target's sink dropped after accepting them.",
+              [](const OutputTargetDispatchStats& t) { return double(t.sinkDroppedFrames); });
+    perTarget(out, m, "olr_output_target_delivery_gaps_total", "counter",
+              "Gaps in the frame indexes the target delivered.",
+              [](const OutputTargetDispatchStats& t) { return double(t.deliveryGaps); });
+    perTarget(out, m, "olr_output_target_queue_depth", "gauge", "Frames queued in the sink.",
+              [](const OutputTargetDispatchStats& t) { return double(t.currentQueueDepth); });
+    perTarget(out, m, "olr_output_target_queue_depth_max", "gauge", "Deepest sink queue.",
+              [](const OutputTargetDispatchStats& t) { return double(t.maxQueueDepth); });
+    perTarget(out, m, "olr_output_target_queue_pressure", "gauge",
+              "1 while the sink reports queue pressure.",
+              [](const OutputTargetDispatchStats& t) { return t.queuePressure ? 1.0 : 0.0; });
+    perTarget(out, m, "olr_output_target_encode_latency_seconds", "gauge",
+              "Last sink encode latency.",
+              [](const OutputTargetDispatchStats& t) { return seconds(t.encodeLatencyNs); });
+    perTarget(out, m, "olr_output_target_encode_latency_max_seconds", "gauge",
+              "Largest sink encode latency.",
+              [](const OutputTargetDispatchStats& t) { return seconds(t.maxEncodeLatencyNs); });
+
+    const QHash<QString, OutputTargetLatency>& latency = m.output.targetLatency;
+    if (!latency.isEmpty()) {
+        QStringList keys = latency.keys();
+        keys.sort();
+        out.family("olr_disk_to_output_seconds", "histogram",
+                   "Time from a frame's packet leaving the demuxer to the target's sink "
+                   "accepting it.");
+        for (const QString& key : keys) {
+            out.histogramSeries("olr_disk_to_output_seconds", {{"target", key}},
+                                latency[key].totalNs);
+        }
+    }
+}
+
+QJsonObject stageJson(const LatencyHistogram& histogram) {
+    const auto ms = [](qint64 ns) { return double(ns) / 1e6; };
+    return QJsonObject{{QStringLiteral("count"), histogram.count()},
+                       {QStringLiteral("p50Ms"), ms(histogram.percentile(0.50))},
+                       {QStringLiteral("p99Ms"), ms(histogram.percentile(0.99))},
+                       {QStringLiteral("maxMs"), ms(histogram.max())}};
+}
+
+} // namespace
+
+QByteArray pipelineMetricsText(const PipelineMetrics& metrics) {
+    Exposition out;
+    writeSources(out, metrics);
+    writeRecording(out, metrics);
+    writePlayback(out, metrics);
+    writeOutput(out, metrics);
+    return out.take();
+}
+
+QJsonObject frameLatencyJson(const PipelineMetrics& metrics) {
+    QJsonArray sources;
+    for (const PipelineSourceMetrics& source : metrics.sources) {
+        const CaptureLatency latency = metrics.muxer.sourceLatency.value(source.index);
+        if (latency.totalNs.count() == 0) continue;
+        QJsonObject stages;
+        stages.insert(QStringLiteral("arrivalToDecoded"), stageJson(latency.arrivalToDecodedNs));
+        stages.insert(QStringLiteral("decodedToDequeued"), stageJson(latency.decodedToDequeuedNs));
+        stages.insert(QStringLiteral("dequeuedToEncoded"), stageJson(latency.dequeuedToEncodedNs));
+        stages.insert(QStringLiteral("encodedToQueued"), stageJson(latency.encodedToQueuedNs));
+        stages.insert(QStringLiteral("queuedToWritten"), stageJson(latency.queuedToWrittenNs));
+        stages.insert(QStringLiteral("total"), stageJson(latency.totalNs));
+        sources.append(QJsonObject{{QStringLiteral("source"), source.index},
+                                   {QStringLiteral("name"), source.name},
+                                   {QStringLiteral("stages"), stages}});
+    }
+
+    QJsonArray targets;
+    const QHash<QString, OutputTargetLatency>& targetLatency = metrics.output.targetLatency;
+    QStringList keys = targetLatency.keys();
+    keys.sort();
+    for (const QString& key : keys) {
+        const OutputTargetLatency& latency = targetLatency[key];
+        QJsonObject stages;
+        stages.insert(QStringLiteral("demuxToDecoded"), stageJson(latency.demuxToDecodedNs));
+        stages.insert(QStringLiteral("decodedToCached"), stageJson(latency.decodedToCachedNs));
+        stages.insert(QStringLiteral("cachedToDispatched"),
+                      stageJson(latency.cachedToDispatchedNs));
+        stages.insert(QStringLiteral("dispatchedToSubmitted"),
+                      stageJson(latency.dispatchedToSubmittedNs));
+        stages.insert(QStringLiteral("total"), stageJson(latency.totalNs));
+        targets.append(
+            QJsonObject{{QStringLiteral("target"), key}, {QStringLiteral("stages"), stages}});
+    }
+
+    return QJsonObject{{QStringLiteral("sources"), sources}, {QStringLiteral("targets"), targets}};
+}
@@ -0,0 +1,63 @@
+#ifndef PIPELINEMETRICS_H
+#define PIPELINEMETRICS_H
+
+#include "playback/output/outputruntime.h"
+#include "playback/playbackworker.h"
+#include "playback/shareddecodedframecache.h"
+#include "recorder_engine/ingest/ingestsession.h"
+#include "recorder_engine/muxer.h"
+#include "recorder_engine/streamworker.h"
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+
+struct PipelineSourceMetrics {
+    int index = 0;
+    QString name;
+    bool connected = false;
+    int linkHealth = 0; // SourceHealth
+    bool hasIngestStats = false;
+    IngestStats ingest;
+    bool hasEncoderStats = false; // while recording
+    EncoderTickStats encoder;
+};
+
+// One playback channel's share of the work; channel 0 is UIManager's own worker.
+struct PipelinePlaybackChannelMetrics {
+    int channel = 0;
+    PlaybackWorker::PlaybackCounters playback;
+    qint64 outputCpuNs = -1; // CPU time of the channel's output dispatch thread
+};
+
+// One sample of every pipeline counter the metrics endpoint exports. UIManager fills it
+// on the GUI thread from accessors that never wait on a hot-path lock (relaxed atomics,
+// the ingest stats already relayed to the UI, the output runtime's published stats).
+struct PipelineMetrics {
+    QList<PipelineSourceMetrics> sources;
+    bool recording = false;
+    MuxerWriteStats muxer;
+    qint64 muxerQueueDepth = 0;
+    bool muxerWriteFailed = false;
+    bool playbackActive = false;
+    PlaybackWorker::PlaybackCounters playback;
+    OutputRuntimePublishedStats output;
+    QList<PipelinePlaybackChannelMetrics> channels; // every running channel, 0 first
+    bool hasSharedDecode = false;                   // the channels share decoded frames
+    SharedDecodedFrameCache::Stats sharedDecode;
+};
+
+// Renders the sample in the Prometheus text exposition format (0.0.4). Every family is
+// prefixed olr_; per-source series carry source="<index>" and name labels, per-target
+// series a target label (the assignment id), per-channel series a channel label; CPU
+// times a platform cannot report are left out. Histograms export fixed bucket edges from
+// LatencyHistogram, in seconds.
+QByteArray pipelineMetricsText(const PipelineMetrics& metrics);
+
+// Per-stage latency of the frames the sample has seen: sources (glass to disk, from the
+// muxer) and output targets (disk to output). Each stage is {count, p50Ms, p99Ms, maxMs}.
+// Sources with no written frame yet are left out. Payload of the diagnostics.latency event.
+QJsonObject frameLatencyJson(const PipelineMetrics& metrics);
+
+#endif // PIPELINEMETRICS_H
@@ -1,5 +1,6 @@
 #include "uimanagercontroladapter.h"
 
+#include "playback/playbackchannel.h"
 #include "playback/playbacktransport.h"
 #include "streamdeck/streamdeckmanager.h"
 #include "uimanager.h"
@@ -32,6 +33,11 @@ TransportState UIManagerControlAdapter::transportState() const {
     state.fps = transport ? transport->fps() : m_uiManager->recordFps();
     state.followLive = m_uiManager->followLive();
     state.liveBufferMs = m_uiManager->liveBufferMs();
+    for (int i = 1; i < m_uiManager->playbackChannelCount(); ++i) {
+        const PlaybackTransport* channelTransport = m_uiManager->playbackChannel(i)->transport();
+        state.channels.append({i, channelTransport->currentPos(), channelTransport->isPlaying(),
+                               channelTransport->speed()});
+    }
     return state;
 }
 
@@ -136,6 +142,17 @@ CommandResult UIManagerControlAdapter::executeCommand(const QString& name,
                                       QStringLiteral("UIManager is unavailable"));
     }
 
+    const int channel = args.value(QStringLiteral("channel")).toInt(0);
+    if (channel != 0 && (name.startsWith(QStringLiteral("transport.")) ||
+                         name == QStringLiteral("view.selectFeed"))) {
+        PlaybackChannel* playbackChannel = m_uiManager->playbackChannel(channel);
+        if (!playbackChannel) {
+            return CommandResult::failure(QStringLiteral("invalid_args"),
+                                          QStringLiteral("No playback channel %1").arg(channel));
+        }
+        return executeChannelCommand(playbackChannel, name, args);
+    }
+
     PlaybackTransport* transport = m_uiManager->transport();
 
     if (name == QStringLiteral("transport.playPause")) {
@@ -294,6 +311,28 @@ CommandResult UIManagerControlAdapter::executeCommand(const QString& name,
         m_uiManager->jogExternal(args.value(QStringLiteral("delta")).toInt());
     } else if (name == QStringLiteral("action.shuttle")) {
         m_uiManager->shuttleExternal(args.value(QStringLiteral("delta")).toInt());
+    } else if (name == QStringLiteral("diagnostics.trace")) {
+        m_uiManager->setPipelineTraceEnabled(args.value(QStringLiteral("enabled")).toBool());
+    } else if (name == QStringLiteral("diagnostics.dumpTrace")) {
+        if (!m_uiManager->dumpPipelineTrace(args.value(QStringLiteral("name")).toString())) {
+            return CommandResult::failure(QStringLiteral("failed"),
+                                          QStringLiteral("Could not write trace file"));
+        }
+    } else if (name == QStringLiteral("diagnostics.latency")) {
+        m_uiManager->reportFrameLatency();
+    } else if (name == QStringLiteral("export.clip")) {
+        const int index = args.value(QStringLiteral("index")).toInt();
+        const QString fileName = args.value(QStringLiteral("name")).toString();
+        const QVariantList views = args.value(QStringLiteral("views")).toArray().toVariantList();
+        const bool started =
+            args.value(QStringLiteral("mode")) == QStringLiteral("transcode")
+                ? m_uiManager->transcodePlaylistEntry(index, fileName, views)
+                : m_uiManager->exportPlaylistEntry(index, fileName, views);
+        if (!started) {
+            return CommandResult::failure(QStringLiteral("failed"), m_uiManager->exportError());
+        }
+    } else if (name == QStringLiteral("export.cancel")) {
+        m_uiManager->cancelExport();
     } else {
         return CommandResult::failure(QStringLiteral("unknown_command"),
                                       QStringLiteral("Unknown command"));
@@ -301,3 +340,35 @@ CommandResult UIManagerControlAdapter::executeCommand(const QString& name,
 
     return CommandResult::success();
 }
+
+CommandResult UIManagerControlAdapter::executeChannelCommand(PlaybackChannel* channel,
+                                                             const QString& name,
+                                                             const QJsonObject& args) {
+    PlaybackTransport* transport = channel->transport();
+    const qint64 liveEdgeMs = m_uiManager->recordedDurationMs();
+
+    if (name == QStringLiteral("transport.playPause")) {
+        transport->setPlaying(!transport->isPlaying());
+    } else if (name == QStringLiteral("transport.play")) {
+        transport->setPlaying(true);
+    } else if (name == QStringLiteral("transport.pause")) {
+        transport->setPlaying(false);
+    } else if (name == QStringLiteral("transport.setSpeed")) {
+        transport->setSpeed(args.value(QStringLiteral("speed")).toDouble());
+        if (args.contains(QStringLiteral("playing"))) {
+            transport->setPlaying(args.value(QStringLiteral("playing")).toBool());
+        }
+    } else if (name == QStringLiteral("transport.stepFrame")) {
+        channel->step(args.value(QStringLiteral("frames")).toInt(), liveEdgeMs);
+    } else if (name == QStringLiteral("transport.seek")) {
+        channel->seek(args.value(QStringLiteral("positionMs")).toVariant().toLongLong(),
+                      liveEdgeMs);
+    } else if (name == QStringLiteral("view.selectFeed")) {
+        channel->setSelectedOutputFeed(args.value(QStringLiteral("index")).toInt());
+    } else {
+        // Follow-live and hold-speed belong to the UI's channel.
+        return CommandResult::failure(QStringLiteral("not_allowed"),
+                                      QStringLiteral("%1 applies to channel 0 only").arg(name));
+    }
+    return CommandResult::success();
+}
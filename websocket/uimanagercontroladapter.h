@@ -5,6 +5,7 @@
 
 #include <QObject>
 
+class PlaybackChannel;
 class UIManager;
 
 class UIManagerControlAdapter : public QObject, public ControlApiAdapter {
@@ -25,6 +26,10 @@ public:
     CommandResult executeCommand(const QString& name, const QJsonObject& args) override;
 
 private:
+    // transport.* and view.selectFeed with args.channel >= 1.
+    CommandResult executeChannelCommand(PlaybackChannel* channel, const QString& name,
+                                        const QJsonObject& args);
+
     UIManager* m_uiManager = nullptr;
     QString m_holdSpeedClientId;
     bool m_holdSpeedWasPlaying = false;